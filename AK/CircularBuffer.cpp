@@ -353,10 +353,21 @@ Optional<SearchableCircularBuffer::Match> SearchableCircularBuffer::find_copy_in
         if (maybe_starting_offset.has_value()) {
             Optional<size_t> previous_buffer_offset;
             auto current_buffer_offset = maybe_starting_offset.value();
+            size_t remaining_chain_length = MAXIMUM_HASH_CHAIN_LENGTH;
 
-            while (true) {
+            while (remaining_chain_length-- > 0) {
                 auto current_search_offset = (capacity() + m_reading_head - current_buffer_offset) % capacity();
 
+                // Once the buffer wraps around, older locations may have been overwritten by data that we haven't read yet.
+                // Those are out of reach, and so is everything that comes after them in the chain.
+                if (current_search_offset == 0 || current_search_offset > search_limit()) {
+                    if (!previous_buffer_offset.has_value())
+                        m_hash_location_map.remove(needle_hash);
+                    else
+                        m_location_chain_map.remove(*previous_buffer_offset);
+                    break;
+                }
+
                 // Validate the hash. In case it is invalid, we can discard the rest of the chain, as the data (and everything older) got updated.
                 Array<u8, HASH_CHUNK_SIZE> hash_chunk_at_offset;
                 auto hash_chunk_at_offset_span = MUST(read_with_seekback(hash_chunk_at_offset, current_search_offset + used_space()));
@@ -405,8 +416,9 @@ Optional<SearchableCircularBuffer::Match> SearchableCircularBuffer::find_copy_in
     }
 
     // Try a plain memory search for smaller values.
-    // Note: This overlaps with the hash search for chunks of size HASH_CHUNK_SIZE for the purpose of validation.
-    if (minimum_length <= HASH_CHUNK_SIZE) {
+    // Note: Anything of at least HASH_CHUNK_SIZE bytes would have been found by the hash search already, so there is no need
+    //       to walk through the entire buffer if the caller isn't interested in anything shorter.
+    if (minimum_length < HASH_CHUNK_SIZE) {
         size_t haystack_offset_from_start = 0;
         Vector<ReadonlyBytes, 2> haystack;
         haystack.append(next_search_span(search_limit()));
@@ -548,11 +560,11 @@ ErrorOr<void> SearchableCircularBuffer::hash_last_bytes(size_t count)
 
         // If the span is smaller than a hash chunk, we need to manually craft some consecutive data to do the hashing.
         if (recalculation_span.size() < HASH_CHUNK_SIZE) {
-            auto auxiliary_span = next_seekback_span(remaining_recalculations);
+            // The data that we are hashing wraps around, and continues at the start of the buffer up until the read head.
+            auto auxiliary_span = m_buffer.span().trim(m_reading_head);
 
             // Ensure that our math is correct and that both spans are "adjacent".
             VERIFY(recalculation_span.data() + recalculation_span.size() == m_buffer.data() + m_buffer.size());
-            VERIFY(auxiliary_span.data() == m_buffer.data());
 
             while (recalculation_span.size() > 0 && recalculation_span.size() + auxiliary_span.size() >= HASH_CHUNK_SIZE) {
                 Array<u8, HASH_CHUNK_SIZE> temporary_hash_chunk;
@@ -560,7 +572,7 @@ ErrorOr<void> SearchableCircularBuffer::hash_last_bytes(size_t count)
                 auto copied_from_recalculation_span = recalculation_span.copy_to(temporary_hash_chunk);
                 VERIFY(copied_from_recalculation_span == recalculation_span.size());
 
-                auto copied_from_auxiliary_span = auxiliary_span.copy_to(temporary_hash_chunk.span().slice(copied_from_recalculation_span));
+                auto copied_from_auxiliary_span = auxiliary_span.copy_trimmed_to(temporary_hash_chunk.span().slice(copied_from_recalculation_span));
                 VERIFY(copied_from_recalculation_span + copied_from_auxiliary_span == HASH_CHUNK_SIZE);
 
                 TRY(insert_location_hash(temporary_hash_chunk, recalculation_span.data() - m_buffer.data()));
@@ -88,6 +88,10 @@ public:
     // equal or greater than this allows us to completely skip a slow memory search.
     static constexpr size_t HASH_CHUNK_SIZE = 3;
 
+    // The number of earlier locations with the same hash that are checked before settling on the best match found so far.
+    // Old and frequently repeated data can build up very long chains, so this puts a bound on the time a single search takes.
+    static constexpr size_t MAXIMUM_HASH_CHAIN_LENGTH = 256;
+
 private:
     // Note: This function has a similar purpose as next_seekback_span, but they differ in their reference point.
     //       Seekback operations start counting their distance at the write head, while search operations start counting their distance at the read head.
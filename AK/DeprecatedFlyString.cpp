@@ -7,10 +7,12 @@
 #include <AK/ByteString.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashTable.h>
+#include <AK/Noncopyable.h>
 #include <AK/Optional.h>
 #include <AK/Singleton.h>
 #include <AK/StringUtils.h>
 #include <AK/StringView.h>
+#include <pthread.h>
 
 namespace AK {
 
@@ -29,9 +31,43 @@ static HashTable<StringImpl const*, DeprecatedFlyStringImplTraits>& fly_impls()
     return *s_table;
 }
 
+// The table is shared by all threads, e.g. when JavaScript is parsed off the main thread.
+// NOTE: This is a plain pthread mutex, as AK can't depend on LibThreading. It's statically initialized, so it can be used
+//       no matter which static constructors have run yet.
+static pthread_mutex_t s_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+class FlyImplsLocker {
+    AK_MAKE_NONCOPYABLE(FlyImplsLocker);
+    AK_MAKE_NONMOVABLE(FlyImplsLocker);
+
+public:
+    FlyImplsLocker()
+    {
+        pthread_mutex_lock(&s_table_mutex);
+    }
+
+    ~FlyImplsLocker()
+    {
+        pthread_mutex_unlock(&s_table_mutex);
+    }
+};
+
+// NOTE: A string in the table may be on its way to being destroyed by another thread, in which case it can't be
+//       referenced anymore, and is replaced with a new copy instead.
+static RefPtr<StringImpl const> try_ref_existing_impl(HashTable<StringImpl const*, DeprecatedFlyStringImplTraits>::Iterator it)
+{
+    if (it == fly_impls().end() || !(*it)->try_ref())
+        return nullptr;
+    VERIFY((*it)->is_fly());
+    return adopt_ref(**it);
+}
+
 void DeprecatedFlyString::did_destroy_impl(Badge<StringImpl>, StringImpl& impl)
 {
-    fly_impls().remove(&impl);
+    FlyImplsLocker locker;
+    auto it = fly_impls().find(&impl);
+    if (it != fly_impls().end() && *it == &impl)
+        fly_impls().remove(it);
 }
 
 DeprecatedFlyString::DeprecatedFlyString(ByteString const& string)
@@ -40,15 +76,13 @@ DeprecatedFlyString::DeprecatedFlyString(ByteString const& string)
     if (string.impl()->is_fly())
         return;
 
-    auto it = fly_impls().find(string.impl());
-    if (it == fly_impls().end()) {
-        fly_impls().set(string.impl());
-        string.impl()->set_fly({}, true);
-        m_impl = string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = **it;
+    FlyImplsLocker locker;
+    if (auto existing_impl = try_ref_existing_impl(fly_impls().find(string.impl()))) {
+        m_impl = existing_impl.release_nonnull();
+        return;
     }
+    fly_impls().set(string.impl());
+    string.impl()->set_fly({}, true);
 }
 
 DeprecatedFlyString::DeprecatedFlyString(StringView string)
@@ -56,18 +90,19 @@ DeprecatedFlyString::DeprecatedFlyString(StringView string)
 {
     if (string.is_null())
         return;
+
+    FlyImplsLocker locker;
     auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
         return string == *candidate;
     });
-    if (it == fly_impls().end()) {
-        auto new_string = string.to_byte_string();
-        fly_impls().set(new_string.impl());
-        new_string.impl()->set_fly({}, true);
-        m_impl = new_string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = **it;
+    if (auto existing_impl = try_ref_existing_impl(it)) {
+        m_impl = existing_impl.release_nonnull();
+        return;
     }
+    auto new_string = string.to_byte_string();
+    fly_impls().set(new_string.impl());
+    new_string.impl()->set_fly({}, true);
+    m_impl = new_string.impl();
 }
 
 bool DeprecatedFlyString::equals_ignoring_ascii_case(StringView other) const
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
+#include <AK/Checked.h>
+#include <AK/Noncopyable.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
 #include <AK/Span.h>
@@ -22,8 +25,14 @@ enum ShouldChomp {
 
 size_t allocation_size_for_stringimpl(size_t length);
 
-class StringImpl : public RefCounted<StringImpl> {
+class StringImpl {
+    AK_MAKE_NONCOPYABLE(StringImpl);
+    AK_MAKE_NONMOVABLE(StringImpl);
+
 public:
+    using RefCountType = unsigned int;
+    using AllowOwnPtr = FalseType;
+
     static NonnullRefPtr<StringImpl const> create_uninitialized(size_t length, char*& buffer);
     static RefPtr<StringImpl const> create(char const* cstring, ShouldChomp = NoChomp);
     static RefPtr<StringImpl const> create(char const* cstring, size_t length, ShouldChomp = NoChomp);
@@ -43,6 +52,64 @@ public:
 
     ~StringImpl();
 
+    // NOTE: Every thread that interns the same string gets the same fly StringImpl (and the empty string is shared by
+    //       everyone), so the reference count of fly strings has to be updated atomically. All other strings are only
+    //       ever used by one thread at a time, and don't pay for atomic operations.
+    ALWAYS_INLINE void ref() const
+    {
+        if (m_fly) {
+            auto old_ref_count = atomic_fetch_add(&m_ref_count, 1u, AK::MemoryOrder::memory_order_relaxed);
+            VERIFY(old_ref_count > 0);
+            VERIFY(!Checked<RefCountType>::addition_would_overflow(old_ref_count, 1));
+            return;
+        }
+        VERIFY(m_ref_count > 0);
+        VERIFY(!Checked<RefCountType>::addition_would_overflow(m_ref_count, 1));
+        ++m_ref_count;
+    }
+
+    [[nodiscard]] bool try_ref() const
+    {
+        if (!m_fly) {
+            if (m_ref_count == 0)
+                return false;
+            ref();
+            return true;
+        }
+        auto expected = atomic_load(&m_ref_count, AK::MemoryOrder::memory_order_relaxed);
+        for (;;) {
+            if (expected == 0)
+                return false;
+            VERIFY(!Checked<RefCountType>::addition_would_overflow(expected, 1));
+            if (atomic_compare_exchange_strong(&m_ref_count, expected, expected + 1, AK::MemoryOrder::memory_order_acquire))
+                return true;
+        }
+    }
+
+    ALWAYS_INLINE bool unref() const
+    {
+        RefCountType new_ref_count;
+        if (m_fly) {
+            new_ref_count = atomic_fetch_sub(&m_ref_count, 1u, AK::MemoryOrder::memory_order_acq_rel) - 1;
+            VERIFY(new_ref_count != NumericLimits<RefCountType>::max());
+        } else {
+            VERIFY(m_ref_count);
+            new_ref_count = --m_ref_count;
+        }
+        if (new_ref_count == 0) {
+            delete this;
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] RefCountType ref_count() const
+    {
+        if (m_fly)
+            return atomic_load(&m_ref_count, AK::MemoryOrder::memory_order_relaxed);
+        return m_ref_count;
+    }
+
     size_t length() const { return m_length; }
     // Includes NUL-terminator.
     char const* characters() const { return &m_inline_buffer[0]; }
@@ -97,6 +164,7 @@ private:
 
     void compute_hash() const;
 
+    mutable RefCountType m_ref_count { 1 };
     size_t m_length { 0 };
     mutable unsigned m_hash { 0 };
     mutable bool m_has_hash { false };
@@ -97,6 +97,7 @@ set(JOB_DEBUG ON)
 set(JPEG_DEBUG ON)
 set(JPEG2000_DEBUG ON)
 set(JS_BYTECODE_DEBUG ON)
+set(JS_JIT_DEBUG ON)
 set(JS_MODULE_DEBUG ON)
 set(KEYBOARD_DEBUG ON)
 set(KEYBOARD_SHORTCUTS_DEBUG ON)
@@ -215,6 +216,7 @@ set(WAITQUEUE_DEBUG ON)
 set(WASI_DEBUG ON)
 set(WASI_FINE_GRAINED_DEBUG ON)
 set(WASM_BINPARSER_DEBUG ON)
+set(WASM_JIT_DEBUG ON)
 set(WASM_TRACE_DEBUG ON)
 set(WASM_VALIDATOR_DEBUG ON)
 set(WEBDRIVER_DEBUG ON)
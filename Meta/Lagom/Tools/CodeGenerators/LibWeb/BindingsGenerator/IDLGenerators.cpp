@@ -4143,6 +4143,12 @@ void @namespace_class@::initialize(JS::Realm& realm)
 )~~~");
     }
 
+    if (interface.extended_attributes.contains("WithInitializer"sv)) {
+        generator.append(R"~~~(
+    @name@::initialize(*this, realm);
+)~~~");
+    }
+
     generator.append(R"~~~(
 }
 )~~~");
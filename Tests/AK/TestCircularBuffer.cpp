@@ -427,6 +427,56 @@ TEST_CASE(find_copy_in_seekback)
     }
 }
 
+TEST_CASE(find_copy_in_seekback_across_wraparound)
+{
+    auto buffer = MUST(SearchableCircularBuffer::create_empty(8));
+
+    // Fill up the buffer, and have the read head wrap around while there is still unread data in front of it.
+    EXPECT_EQ(buffer.write("ABCDEF"sv.bytes()), 6ul);
+    MUST(buffer.discard(6));
+    EXPECT_EQ(buffer.write("GHIJ"sv.bytes()), 4ul);
+    MUST(buffer.discard(2));
+
+    // This hashes "GHI", which is split between the end and the start of the buffer.
+    MUST(buffer.discard(1));
+
+    // This hashes "HIJ" (which is split as well), and overwrites the locations that "ABC" and "BCD" were hashed at.
+    EXPECT_EQ(buffer.write("GHI"sv.bytes()), 3ul);
+    MUST(buffer.discard(1));
+
+    {
+        auto match = buffer.find_copy_in_seekback(3, 3);
+        EXPECT(match.has_value());
+        EXPECT_EQ(match.value().distance, 4ul);
+        EXPECT_EQ(match.value().length, 3ul);
+    }
+
+    // The unread data now overlaps with old locations, which must not be considered anymore.
+    MUST(buffer.discard(3));
+    EXPECT_EQ(buffer.write("ABCDE"sv.bytes()), 5ul);
+
+    {
+        auto match = buffer.find_copy_in_seekback(3, 3);
+        EXPECT(!match.has_value());
+    }
+}
+
+TEST_CASE(find_copy_in_seekback_with_long_hash_chain)
+{
+    auto buffer = MUST(SearchableCircularBuffer::create_empty(16 * KiB));
+
+    // Every copy of "ABC" ends up in the same hash chain, which grows a lot longer than the part of it that is searched.
+    for (size_t i = 0; i < SearchableCircularBuffer::MAXIMUM_HASH_CHAIN_LENGTH * 4; i++)
+        EXPECT_EQ(buffer.write("ABC"sv.bytes()), 3ul);
+    MUST(buffer.discard(SearchableCircularBuffer::MAXIMUM_HASH_CHAIN_LENGTH * 4 * 3 - 6));
+
+    // The most recent locations are at the front of the chain, so the best match is still found.
+    auto match = buffer.find_copy_in_seekback(3, 3);
+    EXPECT(match.has_value());
+    EXPECT_EQ(match.value().distance, 3ul);
+    EXPECT_EQ(match.value().length, 3ul);
+}
+
 BENCHMARK_CASE(looping_copy_from_seekback)
 {
     auto circular_buffer = MUST(CircularBuffer::create_empty(16 * MiB));
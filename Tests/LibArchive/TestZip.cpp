@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Atomic.h>
+#include <AK/MemMem.h>
+#include <AK/MemoryStream.h>
+#include <AK/Random.h>
+#include <LibArchive/Zip.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibThreading/ThreadPool.h>
+
+static ByteString test_file_path(StringView file_name)
+{
+    // This makes sure that the tests will run both on target and in Lagom.
+#ifdef AK_OS_SERENITY
+    return ByteString::formatted("/usr/Tests/LibArchive/zip-test-files/{}", file_name);
+#else
+    return ByteString::formatted("zip-test-files/{}", file_name);
+#endif
+}
+
+static ByteBuffer read_test_file(StringView file_name)
+{
+    auto file = MUST(Core::File::open(test_file_path(file_name), Core::File::OpenMode::Read));
+    return MUST(file->read_until_eof());
+}
+
+static ByteBuffer decompress_member(Archive::ZipMemberReader const& reader)
+{
+    AllocatingMemoryStream output;
+    MUST(reader.decompress_into(output));
+    auto buffer = MUST(ByteBuffer::create_uninitialized(output.used_buffer_size()));
+    MUST(output.read_until_filled(buffer));
+    return buffer;
+}
+
+static void check_lorem_archive(Archive::Zip const& zip, Archive::ZipCompressionMethod compression_method)
+{
+    auto expected = read_test_file("lorem.txt"sv);
+
+    auto readers = TRY_OR_FAIL(zip.member_readers());
+    EXPECT_EQ(readers.size(), 2u);
+
+    EXPECT_EQ(readers[0].member().name, "docs/"sv);
+    EXPECT(readers[0].member().is_directory);
+    EXPECT_EQ(readers[0].member().uncompressed_size, 0u);
+
+    auto const& member = readers[1].member();
+    EXPECT_EQ(member.name, "docs/lorem.txt"sv);
+    EXPECT(!member.is_directory);
+    EXPECT_EQ(member.compression_method, compression_method);
+    EXPECT_EQ(member.uncompressed_size, expected.size());
+    EXPECT_EQ(member.crc32, 0xe0e7eb97u);
+
+    auto decompressed = decompress_member(readers[1]);
+    EXPECT_EQ(decompressed.span(), expected.span());
+}
+
+TEST_CASE(zip_read_stored_archive)
+{
+    auto archive = read_test_file("stored.zip"sv);
+    auto zip = Archive::Zip::try_create(archive);
+    EXPECT(zip.has_value());
+    check_lorem_archive(*zip, Archive::ZipCompressionMethod::Store);
+}
+
+TEST_CASE(zip_read_deflated_archive)
+{
+    auto zip = Archive::Zip::try_create(TRY_OR_FAIL(Core::MappedFile::map(test_file_path("deflated.zip"sv))));
+    EXPECT(zip.has_value());
+    check_lorem_archive(*zip, Archive::ZipCompressionMethod::Deflate);
+}
+
+TEST_CASE(zip_read_members_in_parallel)
+{
+    // The readers don't share any state, so several of them can decompress at the same time.
+    auto zip = Archive::Zip::try_create(TRY_OR_FAIL(Core::MappedFile::map(test_file_path("deflated.zip"sv))));
+    EXPECT(zip.has_value());
+    auto readers = TRY_OR_FAIL(zip->member_readers());
+    auto expected = read_test_file("lorem.txt"sv);
+
+    Atomic<size_t> matching_members = 0;
+    {
+        Threading::ThreadPool<size_t> thread_pool([&](size_t) {
+            auto decompressed = decompress_member(readers[1]);
+            if (decompressed.span() == expected.span())
+                matching_members++;
+        },
+            4);
+        for (size_t i = 0; i < 16; ++i)
+            thread_pool.submit(i);
+        thread_pool.wait_for_all();
+    }
+    EXPECT_EQ(matching_members.load(), 16u);
+}
+
+TEST_CASE(zip_read_corrupted_member)
+{
+    auto archive = read_test_file("stored.zip"sv);
+    auto zip = Archive::Zip::try_create(archive);
+    EXPECT(zip.has_value());
+    auto readers = TRY_OR_FAIL(zip->member_readers());
+
+    // The archive itself is still fine, but the member's data no longer matches its CRC32.
+    auto const& compressed_data = readers[1].member().compressed_data;
+    archive[compressed_data.data() - archive.data()] ^= 1;
+
+    AllocatingMemoryStream output;
+    auto result = readers[1].decompress_into(output);
+    EXPECT(result.is_error());
+}
+
+TEST_CASE(zip64_read_archive)
+{
+    // Created by Info-ZIP's `zip -fz`, which gives every member a Zip64 extended information extra field,
+    // and ends the archive with a Zip64 end of central directory record.
+    auto archive = read_test_file("zip64.zip"sv);
+    auto expected = read_test_file("lorem.txt"sv);
+
+    auto zip = Archive::Zip::try_create(archive);
+    EXPECT(zip.has_value());
+
+    auto readers = TRY_OR_FAIL(zip->member_readers());
+    EXPECT_EQ(readers.size(), 1u);
+    EXPECT_EQ(readers[0].member().name, "lorem.txt"sv);
+    EXPECT_EQ(readers[0].member().compression_method, Archive::ZipCompressionMethod::Deflate);
+    EXPECT_EQ(readers[0].member().uncompressed_size, expected.size());
+    EXPECT_EQ(readers[0].member().compressed_data.size(), 1042u);
+    auto decompressed = decompress_member(readers[0]);
+    EXPECT_EQ(decompressed.span(), expected.span());
+}
+
+TEST_CASE(zip64_read_written_archive)
+{
+    // This many members don't fit into the regular end of central directory record anymore.
+    static constexpr size_t member_count = 0x10000;
+
+    auto stream = make<AllocatingMemoryStream>();
+    auto& output = *stream;
+    Archive::ZipOutputStream zip_stream(move(stream));
+    for (size_t i = 0; i < member_count; ++i)
+        TRY_OR_FAIL(zip_stream.add_directory(ByteString::formatted("{}/", i)));
+    TRY_OR_FAIL(zip_stream.finish());
+
+    auto archive = MUST(ByteBuffer::create_uninitialized(output.used_buffer_size()));
+    MUST(output.read_until_filled(archive));
+
+    auto zip = Archive::Zip::try_create(archive);
+    EXPECT(zip.has_value());
+
+    auto statistics = TRY_OR_FAIL(zip->calculate_statistics());
+    EXPECT_EQ(statistics.directory_count(), member_count);
+    EXPECT_EQ(statistics.file_count(), 0u);
+}
+
+TEST_CASE(zip64_reject_truncated_extra_field)
+{
+    auto archive = read_test_file("zip64.zip"sv);
+    EXPECT(Archive::Zip::try_create(archive).has_value());
+
+    // The central directory record's uncompressed size is only in its Zip64 extended information extra field,
+    // so an archive in which that field is too small to hold it can't be read.
+    auto central_directory_offset = *AK::memmem_optional(archive.data(), archive.size(), Archive::CentralDirectoryRecord::signature.data(), Archive::CentralDirectoryRecord::signature.size());
+    Archive::CentralDirectoryRecord central_directory_record {};
+    EXPECT(central_directory_record.read(archive.bytes().slice(central_directory_offset)));
+    EXPECT_EQ(central_directory_record.uncompressed_size, 0xFFFFFFFFu);
+
+    auto extra_data_offset = central_directory_record.extra_data - archive.data();
+    u16 tag;
+    memcpy(&tag, archive.data() + extra_data_offset, sizeof(tag));
+    EXPECT_EQ(tag, Archive::zip64_extended_information_extra_field_tag);
+    archive[extra_data_offset + 2] = 0;
+    archive[extra_data_offset + 3] = 0;
+
+    EXPECT(!Archive::Zip::try_create(archive).has_value());
+}
+
+template<typename Callback>
+static ByteBuffer write_archive(Callback add_members, size_t thread_count = 0)
+{
+    auto stream = make<AllocatingMemoryStream>();
+    auto& output = *stream;
+    auto zip_stream = thread_count > 0
+        ? MUST(Archive::ZipOutputStream::create_parallel(move(stream), thread_count))
+        : make<Archive::ZipOutputStream>(move(stream));
+    add_members(*zip_stream);
+    MUST(zip_stream->finish());
+
+    auto archive = MUST(ByteBuffer::create_uninitialized(output.used_buffer_size()));
+    MUST(output.read_until_filled(archive));
+    return archive;
+}
+
+static void add_member(Archive::ZipOutputStream& zip_stream, StringView name, ReadonlyBytes data)
+{
+    FixedMemoryStream stream { data };
+    TRY_OR_FAIL(zip_stream.queue_member_from_stream(name, stream));
+}
+
+static ByteBuffer text_data(size_t size)
+{
+    auto lorem = read_test_file("lorem.txt"sv);
+    auto data = MUST(ByteBuffer::create_uninitialized(size));
+    for (size_t i = 0; i < size; i += lorem.size())
+        data.overwrite(i, lorem.data(), min(lorem.size(), size - i));
+    return data;
+}
+
+static ByteBuffer random_data(size_t size)
+{
+    auto data = MUST(ByteBuffer::create_uninitialized(size));
+    fill_with_random(data);
+    return data;
+}
+
+static Vector<Archive::ZipMemberReader> read_archive(ReadonlyBytes archive)
+{
+    auto zip = Archive::Zip::try_create(archive);
+    VERIFY(zip.has_value());
+    return MUST(zip->member_readers());
+}
+
+static Archive::LocalFileHeader local_file_header_at(ReadonlyBytes archive, size_t offset)
+{
+    Archive::LocalFileHeader local_file_header {};
+    VERIFY(local_file_header.read(archive.slice(offset)));
+    return local_file_header;
+}
+
+TEST_CASE(zip_write_stores_or_deflates_members)
+{
+    auto text = text_data(100 * KiB);
+    auto random = random_data(100 * KiB);
+    auto archive = write_archive([&](auto& zip_stream) {
+        add_member(zip_stream, "text"sv, text);
+        add_member(zip_stream, "random"sv, random);
+        add_member(zip_stream, "empty"sv, {});
+    });
+
+    auto readers = read_archive(archive);
+    EXPECT_EQ(readers.size(), 3u);
+
+    EXPECT_EQ(readers[0].member().compression_method, Archive::ZipCompressionMethod::Deflate);
+    EXPECT(readers[0].member().compressed_data.size() < text.size());
+    auto decompressed_text = decompress_member(readers[0]);
+    EXPECT_EQ(decompressed_text.span(), text.span());
+
+    EXPECT_EQ(readers[1].member().compression_method, Archive::ZipCompressionMethod::Store);
+    EXPECT_EQ(readers[1].member().compressed_data.size(), random.size());
+    auto decompressed_random = decompress_member(readers[1]);
+    EXPECT_EQ(decompressed_random.span(), random.span());
+
+    EXPECT_EQ(readers[2].member().compression_method, Archive::ZipCompressionMethod::Store);
+    EXPECT_EQ(readers[2].member().uncompressed_size, 0u);
+
+    // Members that fit into a single chunk have their sizes in the local file header, and no data descriptor.
+    auto local_file_header = local_file_header_at(archive, 0);
+    EXPECT(!local_file_header.general_purpose_flags.data_descriptor);
+    EXPECT_EQ(local_file_header.compressed_size, readers[0].member().compressed_data.size());
+    EXPECT_EQ(local_file_header.uncompressed_size, text.size());
+}
+
+TEST_CASE(zip_write_chunked_members)
+{
+    auto text = text_data(Archive::ZipOutputStream::member_chunk_size * 5 / 2);
+    auto random = random_data(Archive::ZipOutputStream::member_chunk_size * 2);
+    auto archive = write_archive([&](auto& zip_stream) {
+        add_member(zip_stream, "text"sv, text);
+        add_member(zip_stream, "random"sv, random);
+    });
+
+    auto readers = read_archive(archive);
+    EXPECT_EQ(readers.size(), 2u);
+
+    EXPECT_EQ(readers[0].member().compression_method, Archive::ZipCompressionMethod::Deflate);
+    EXPECT_EQ(readers[0].member().uncompressed_size, text.size());
+    auto decompressed_text = decompress_member(readers[0]);
+    EXPECT_EQ(decompressed_text.span(), text.span());
+
+    // Once the first chunk didn't compress, the rest of the member is stored as well.
+    EXPECT_EQ(readers[1].member().compression_method, Archive::ZipCompressionMethod::Store);
+    EXPECT_EQ(readers[1].member().compressed_data.size(), random.size());
+    auto decompressed_random = decompress_member(readers[1]);
+    EXPECT_EQ(decompressed_random.span(), random.span());
+
+    // The CRC32 and sizes of chunked members follow their data in a Zip64 data descriptor.
+    auto local_file_header = local_file_header_at(archive, 0);
+    EXPECT(local_file_header.general_purpose_flags.data_descriptor);
+    EXPECT_EQ(local_file_header.crc32, 0u);
+    EXPECT_EQ(local_file_header.compressed_size, 0u);
+    EXPECT_EQ(local_file_header.uncompressed_size, 0u);
+
+    auto const& compressed_data = readers[0].member().compressed_data;
+    auto data_descriptor = archive.bytes().slice(compressed_data.data() + compressed_data.size() - archive.data(), Archive::Zip64DataDescriptor::size());
+    EXPECT_EQ(data_descriptor.slice(0, Archive::Zip64DataDescriptor::signature.size()), Archive::Zip64DataDescriptor::signature.span());
+
+    u32 crc32;
+    u64 compressed_size;
+    u64 uncompressed_size;
+    memcpy(&crc32, data_descriptor.offset(4), sizeof(crc32));
+    memcpy(&compressed_size, data_descriptor.offset(8), sizeof(compressed_size));
+    memcpy(&uncompressed_size, data_descriptor.offset(16), sizeof(uncompressed_size));
+    EXPECT_EQ(crc32, readers[0].member().crc32);
+    EXPECT_EQ(compressed_size, compressed_data.size());
+    EXPECT_EQ(uncompressed_size, text.size());
+}
+
+static bool has_zip64_end_of_central_directory(ReadonlyBytes archive)
+{
+    auto const& signature = Archive::Zip64EndOfCentralDirectory::signature;
+    return AK::memmem_optional(archive.data(), archive.size(), signature.data(), signature.size()).has_value();
+}
+
+TEST_CASE(zip_write_zip64_end_of_central_directory)
+{
+    auto write_directories = [](size_t count) {
+        return write_archive([&](auto& zip_stream) {
+            for (size_t i = 0; i < count; ++i)
+                TRY_OR_FAIL(zip_stream.add_directory(ByteString::formatted("{}/", i)));
+        });
+    };
+
+    // 0xFFFF is what readers are told to look for the Zip64 record with, so it's used from that member count on.
+    auto archive = write_directories(0xFFFE);
+    EXPECT(!has_zip64_end_of_central_directory(archive));
+    EXPECT_EQ(TRY_OR_FAIL(Archive::Zip::try_create(archive)->calculate_statistics()).member_count(), 0xFFFEu);
+
+    archive = write_directories(0xFFFF);
+    EXPECT(has_zip64_end_of_central_directory(archive));
+    EXPECT_EQ(TRY_OR_FAIL(Archive::Zip::try_create(archive)->calculate_statistics()).member_count(), 0xFFFFu);
+}
+
+TEST_CASE(zip_write_parallel_output_matches_serial_output)
+{
+    auto text = text_data(Archive::ZipOutputStream::member_chunk_size * 3 + 12345);
+    auto random = random_data(Archive::ZipOutputStream::member_chunk_size + 1);
+    auto add_members = [&](Archive::ZipOutputStream& zip_stream) {
+        TRY_OR_FAIL(zip_stream.add_directory("directory/"sv));
+        add_member(zip_stream, "directory/text"sv, text);
+        add_member(zip_stream, "directory/random"sv, random);
+        add_member(zip_stream, "small"sv, text.bytes().slice(0, 1000));
+        add_member(zip_stream, "empty"sv, {});
+    };
+
+    auto serial_archive = write_archive(add_members);
+    EXPECT_EQ(read_archive(serial_archive).size(), 5u);
+
+    for (size_t thread_count : { 1, 2, 4 }) {
+        auto parallel_archive = write_archive(add_members, thread_count);
+        EXPECT_EQ(parallel_archive.span(), serial_archive.span());
+    }
+}
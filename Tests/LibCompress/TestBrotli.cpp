@@ -6,10 +6,12 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Array.h>
 #include <AK/BitStream.h>
 #include <AK/MaybeOwned.h>
 #include <AK/MemoryStream.h>
 #include <LibCompress/Brotli.h>
+#include <LibCompress/Deflate.h>
 #include <LibCore/File.h>
 
 TEST_CASE(dictionary_use_after_uncompressed_block)
@@ -177,3 +179,157 @@ TEST_CASE(brotli_decompress_zero_one_bin)
     EXPECT(bytes_read == 32 * MiB);
     EXPECT(brotli_stream.is_eof());
 }
+
+static ByteBuffer read_test_file(StringView const file_name)
+{
+#ifdef AK_OS_SERENITY
+    ByteString path = ByteString::formatted("/usr/Tests/LibCompress/brotli-test-files/{}", file_name);
+#else
+    ByteString path = ByteString::formatted("brotli-test-files/{}", file_name);
+#endif
+
+    auto file = MUST(Core::File::open(path, Core::File::OpenMode::Read));
+    return MUST(file->read_until_eof());
+}
+
+static ByteBuffer decompress_brotli(ReadonlyBytes compressed)
+{
+    auto stream = make<FixedMemoryStream>(compressed);
+    auto decompressor = Compress::BrotliDecompressionStream { MaybeOwned<Stream>(*stream) };
+    return MUST(decompressor.read_until_eof());
+}
+
+static void run_roundtrip_test(StringView const file_name)
+{
+    auto uncompressed = read_test_file(file_name);
+    for (u8 quality = 0; quality <= Compress::BrotliCompressor::max_quality; ++quality) {
+        auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(uncompressed, { .quality = quality }));
+        EXPECT(compressed.size() < uncompressed.size());
+        EXPECT_EQ(decompress_brotli(compressed), uncompressed);
+    }
+}
+
+TEST_CASE(brotli_compress_lorem)
+{
+    run_roundtrip_test("lorem.txt"sv);
+}
+
+TEST_CASE(brotli_compress_transform)
+{
+    run_roundtrip_test("transform.txt"sv);
+}
+
+TEST_CASE(brotli_compress_happy3rd_html)
+{
+    run_roundtrip_test("happy3rd.html"sv);
+}
+
+TEST_CASE(brotli_compress_katica_regular_10_font)
+{
+    run_roundtrip_test("KaticaRegular10.font"sv);
+}
+
+TEST_CASE(brotli_compress_empty_input)
+{
+    // An empty stream is only WBITS followed by an empty last meta-block.
+    auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all({}));
+    EXPECT_EQ(compressed.size(), 1ul);
+    EXPECT(decompress_brotli(compressed).is_empty());
+}
+
+TEST_CASE(brotli_compress_small_window)
+{
+    // The input is much larger than the window, so the history has to be discarded and old matches can't be used.
+    auto uncompressed = MUST(ByteBuffer::create_uninitialized(1 * MiB));
+    for (size_t i = 0; i < uncompressed.size(); ++i)
+        uncompressed[i] = "The quick brown fox jumps over the lazy dog. "[(i * i / 4096) % 45];
+
+    for (u8 window_bits : Array<u8, 3> { 10, 16, 24 }) {
+        auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(uncompressed, { .window_bits = window_bits }));
+        EXPECT(compressed.size() < uncompressed.size());
+        EXPECT_EQ(decompress_brotli(compressed), uncompressed);
+    }
+}
+
+TEST_CASE(brotli_compress_incompressible_data)
+{
+    // Meta-blocks that don't shrink are stored as they are, with only a few bytes of overhead.
+    auto uncompressed = MUST(ByteBuffer::create_uninitialized(600 * KiB));
+    u32 random_state = 1;
+    for (auto& byte : uncompressed.bytes()) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+        byte = static_cast<u8>(random_state);
+    }
+
+    auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(uncompressed));
+    EXPECT(compressed.size() < uncompressed.size() + 16);
+    EXPECT_EQ(decompress_brotli(compressed), uncompressed);
+}
+
+TEST_CASE(brotli_compress_static_dictionary)
+{
+    // Common words (and some of their transformations) are found in the static dictionary, even without any history.
+    auto const uncompressed = "Welcome to the Documentation of the International Association"sv.bytes();
+
+    auto without_dictionary = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(uncompressed, { .quality = 1 }));
+    auto with_dictionary = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(uncompressed, { .quality = 2 }));
+    EXPECT(with_dictionary.size() < without_dictionary.size());
+    auto decompressed = decompress_brotli(with_dictionary);
+    EXPECT_EQ(decompressed.bytes(), uncompressed);
+}
+
+TEST_CASE(brotli_compress_streaming)
+{
+    auto uncompressed = read_test_file("happy3rd.html"sv);
+
+    auto stream = make<AllocatingMemoryStream>();
+    auto compressor = TRY_OR_FAIL(Compress::BrotliCompressor::create(MaybeOwned<Stream>(*stream)));
+    for (size_t offset = 0; offset < uncompressed.size(); offset += 1000)
+        TRY_OR_FAIL(compressor->write_until_depleted(uncompressed.bytes().slice(offset, min(1000ul, uncompressed.size() - offset))));
+    TRY_OR_FAIL(compressor->flush());
+
+    EXPECT(compressor->flush().is_error());
+    EXPECT(compressor->write_some("more"sv.bytes()).is_error());
+
+    auto compressed = TRY_OR_FAIL(stream->read_until_eof());
+    EXPECT_EQ(compressed, TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(uncompressed)));
+    EXPECT_EQ(decompress_brotli(compressed), uncompressed);
+}
+
+TEST_CASE(brotli_compress_better_than_deflate)
+{
+    for (auto file_name : Array { "happy3rd.html"sv, "KaticaRegular10.font"sv }) {
+        auto uncompressed = read_test_file(file_name);
+        auto brotli = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(uncompressed));
+        auto deflate = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(uncompressed, Compress::DeflateCompressor::CompressionLevel::GOOD));
+        EXPECT(brotli.size() < deflate.size());
+    }
+}
+
+BENCHMARK_CASE(brotli_compress_html_throughput)
+{
+    auto uncompressed = read_test_file("happy3rd.html"sv);
+    for (size_t i = 0; i < 16; ++i)
+        (void)MUST(Compress::BrotliCompressor::compress_all(uncompressed));
+}
+
+BENCHMARK_CASE(deflate_compress_html_throughput)
+{
+    auto uncompressed = read_test_file("happy3rd.html"sv);
+    for (size_t i = 0; i < 16; ++i)
+        (void)MUST(Compress::DeflateCompressor::compress_all(uncompressed, Compress::DeflateCompressor::CompressionLevel::GOOD));
+}
+
+BENCHMARK_CASE(brotli_compress_font_throughput)
+{
+    auto uncompressed = read_test_file("KaticaRegular10.font"sv);
+    (void)MUST(Compress::BrotliCompressor::compress_all(uncompressed));
+}
+
+BENCHMARK_CASE(deflate_compress_font_throughput)
+{
+    auto uncompressed = read_test_file("KaticaRegular10.font"sv);
+    (void)MUST(Compress::DeflateCompressor::compress_all(uncompressed, Compress::DeflateCompressor::CompressionLevel::GOOD));
+}
@@ -11,6 +11,7 @@
 #include <AK/MemoryStream.h>
 #include <AK/Random.h>
 #include <LibCompress/Deflate.h>
+#include <LibCompress/ParallelDeflate.h>
 #include <LibCore/File.h>
 #include <cstring>
 
@@ -113,6 +114,16 @@ TEST_CASE(deflate_decompress_multiple_blocks)
     EXPECT(decompressed.value().bytes() == (ReadonlyBytes { uncompressed, sizeof(uncompressed) - 1 }));
 }
 
+TEST_CASE(deflate_decompress_short_symbol_at_end_of_stream)
+{
+    // Six 9-bit literals and the 7-bit end of block code exactly fill the last byte
+    Array<u8, 8> const compressed { 0x3b, 0x71, 0xe2, 0xc4, 0x89, 0x13, 0x27, 0x00 };
+    Array<u8, 6> const uncompressed { 0xc8, 0xc8, 0xc8, 0xc8, 0xc8, 0xc8 };
+
+    auto const decompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(decompressed.bytes() == uncompressed.span());
+}
+
 TEST_CASE(deflate_decompress_zeroes)
 {
     Array<u8, 20> const compressed {
@@ -156,6 +167,56 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(deflate_round_trip_all_levels)
+{
+    // Each level parses its input differently, so give them a mix of short matches, long runs and literals spanning a few blocks
+    auto size = Compress::DeflateCompressor::block_size * 2 + 1000;
+    auto original = ByteBuffer::create_zeroed(size).release_value();
+    fill_with_random(original.bytes().trim(size / 2));
+    for (auto& byte : original.bytes().trim(size / 4))
+        byte %= 8;
+    original.bytes().slice(size - 3000).overwrite(0, original.data() + 100, 2000);
+
+    Optional<size_t> fast_size;
+    for (auto level : { Compress::DeflateCompressor::CompressionLevel::FAST, Compress::DeflateCompressor::CompressionLevel::GOOD, Compress::DeflateCompressor::CompressionLevel::GREAT, Compress::DeflateCompressor::CompressionLevel::BEST }) {
+        auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, level));
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT(uncompressed == original);
+
+        if (!fast_size.has_value())
+            fast_size = compressed.size();
+        else
+            EXPECT(compressed.size() <= fast_size.value());
+    }
+}
+
+TEST_CASE(deflate_back_references_across_blocks)
+{
+    auto original = ByteBuffer::create_uninitialized(40000).release_value();
+    fill_with_random(original.bytes().trim(20000));
+    original.bytes().slice(20000).overwrite(0, original.data(), 20000);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::GREAT));
+    // The part of the repetition that ends up in the second block must refer back into the first one
+    EXPECT(compressed.size() < 22000);
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+TEST_CASE(deflate_round_trip_parallel)
+{
+    auto chunk_size = Compress::ParallelDeflateCompressor::chunk_size;
+    for (size_t size : { (size_t)0, (size_t)1000, chunk_size, 3 * chunk_size + 1234 }) {
+        auto original = ByteBuffer::create_uninitialized(size).release_value();
+        fill_with_random(original);
+        for (auto& byte : original.bytes())
+            byte %= 16; // keep it compressible enough for back references to happen
+
+        auto compressed = TRY_OR_FAIL(Compress::ParallelDeflateCompressor::compress_all(original, 3, Compress::DeflateCompressor::CompressionLevel::FAST));
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT(uncompressed == original);
+    }
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
@@ -7,6 +7,7 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/Array.h>
+#include <AK/MemoryStream.h>
 #include <AK/Random.h>
 #include <LibCompress/Gzip.h>
 
@@ -94,6 +95,31 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(gzip_round_trip_parallel)
+{
+    auto original = ByteBuffer::create_uninitialized(512 * KiB + 17).release_value();
+    fill_with_random(original);
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, 4));
+    auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+TEST_CASE(gzip_parallel_finishes_on_destruction)
+{
+    auto original = ByteBuffer::create_uninitialized(300 * KiB).release_value();
+    fill_with_random(original);
+
+    AllocatingMemoryStream compressed_stream;
+    {
+        auto compressor = TRY_OR_FAIL(Compress::GzipCompressor::create_parallel(MaybeOwned<Stream>(compressed_stream), 2));
+        TRY_OR_FAIL(compressor->write_until_depleted(original));
+    }
+
+    auto compressed = TRY_OR_FAIL(compressed_stream.read_until_eof());
+    auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
 TEST_CASE(gzip_truncated_uncompressed_block)
 {
     Array<u8, 38> const compressed {
@@ -2057,3 +2057,60 @@ TEST_CASE(xz_utils_unsupported_filter_flags_3)
     auto buffer_or_error = decompressor->read_until_eof(PAGE_SIZE);
     EXPECT(buffer_or_error.is_error());
 }
+
+static ByteBuffer decompress_xz(ReadonlyBytes compressed)
+{
+    auto stream = MUST(try_make<FixedMemoryStream>(compressed));
+    auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
+    return MUST(decompressor->read_until_eof(PAGE_SIZE));
+}
+
+TEST_CASE(xz_compress_decompress_roundtrip)
+{
+    auto const uncompressed = "Well hello friends, this is a simple text file :)"sv.bytes();
+
+    auto compressed = TRY_OR_FAIL(Compress::XzCompressor::compress_all(uncompressed));
+    auto decompressed = decompress_xz(compressed);
+    EXPECT_EQ(decompressed.bytes(), uncompressed);
+}
+
+TEST_CASE(xz_compress_empty_input)
+{
+    // An empty stream consists of only the stream header, an empty index and the stream footer.
+    auto compressed = TRY_OR_FAIL(Compress::XzCompressor::compress_all({}));
+    EXPECT_EQ(compressed.size(), 32ul);
+    EXPECT(decompress_xz(compressed).is_empty());
+}
+
+TEST_CASE(xz_compress_multiple_blocks_in_parallel)
+{
+    // Mix compressible text with random data, so that both LZMA and uncompressed LZMA2 chunks are produced.
+    auto uncompressed = MUST(ByteBuffer::create_uninitialized(300 * KiB));
+    u32 random_state = 1;
+    for (size_t i = 0; i < uncompressed.size(); ++i) {
+        if ((i / (32 * KiB)) % 3 == 2) {
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 17;
+            random_state ^= random_state << 5;
+            uncompressed[i] = static_cast<u8>(random_state);
+        } else {
+            uncompressed[i] = "The quick brown fox jumps over the lazy dog. "[(i * i / 4096) % 45];
+        }
+    }
+
+    // The small dictionary makes sure that the dictionary wraps around many times within every block.
+    Compress::XzCompressorOptions options {
+        .dictionary_size = 4 * KiB,
+        .block_size = 100 * KiB,
+        .thread_count = 1,
+    };
+    auto single_threaded = TRY_OR_FAIL(Compress::XzCompressor::compress_all(uncompressed, options));
+    EXPECT(single_threaded.size() < uncompressed.size());
+    auto decompressed = decompress_xz(single_threaded);
+    EXPECT_EQ(decompressed.bytes(), uncompressed.bytes());
+
+    // Blocks are compressed independently, so the number of threads doesn't change the result.
+    options.thread_count = 4;
+    auto multi_threaded = TRY_OR_FAIL(Compress::XzCompressor::compress_all(uncompressed, options));
+    EXPECT_EQ(multi_threaded.bytes(), single_threaded.bytes());
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/MemoryStream.h>
+#include <AK/Random.h>
+#include <LibCompress/Deflate.h>
+#include <LibCompress/Zstd.h>
+#include <LibCore/File.h>
+
+static ByteBuffer read_test_file(StringView directory, StringView file_name)
+{
+    // This makes sure that the tests will run both on target and in Lagom.
+#ifdef AK_OS_SERENITY
+    ByteString path = ByteString::formatted("/usr/Tests/LibCompress/{}/{}", directory, file_name);
+#else
+    ByteString path = ByteString::formatted("{}/{}", directory, file_name);
+#endif
+
+    auto file = MUST(Core::File::open(path, Core::File::OpenMode::Read));
+    return MUST(file->read_until_eof());
+}
+
+static void run_roundtrip_test(ReadonlyBytes input, Compress::ZstdCompressorOptions const& options = {})
+{
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(input, options));
+    EXPECT(Compress::ZstdDecompressor::is_likely_compressed(compressed));
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed, options.dictionary));
+    EXPECT_EQ(decompressed.span(), input);
+}
+
+TEST_CASE(zstd_decompress_raw_block)
+{
+    // Compressed with the reference implementation, with a content size and a checksum.
+    Array<u8, 27> const compressed {
+        0x28, 0xb5, 0x2f, 0xfd, 0x24, 0x0e, 0x71, 0x00, 0x00, 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x2c, 0x20,
+        0x57, 0x6f, 0x72, 0x6c, 0x64, 0x21, 0x0a, 0xf1, 0xf9, 0x8e, 0xb6
+    };
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed));
+    EXPECT_EQ(decompressed.span(), "Hello, World!\n"sv.bytes());
+}
+
+TEST_CASE(zstd_decompress_multiple_frames)
+{
+    // Two frames with content, a skippable frame and an empty frame in between.
+    Array<u8, 56> const compressed {
+        0x28, 0xb5, 0x2f, 0xfd, 0x20, 0x07, 0x39, 0x00, 0x00, 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x2c, 0x20,
+        0x5e, 0x2a, 0x4d, 0x18, 0x03, 0x00, 0x00, 0x00, 0x61, 0x62, 0x63, 0x28, 0xb5, 0x2f, 0xfd, 0x00,
+        0x00, 0x01, 0x00, 0x00, 0x28, 0xb5, 0x2f, 0xfd, 0x24, 0x07, 0x39, 0x00, 0x00, 0x57, 0x6f, 0x72,
+        0x6c, 0x64, 0x21, 0x0a, 0x37, 0xa2, 0xb0, 0x20
+    };
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed));
+    EXPECT_EQ(decompressed.span(), "Hello, World!\n"sv.bytes());
+}
+
+TEST_CASE(zstd_decompress_long_run)
+{
+    // 300000 times 'x', which is split into three blocks that all refer back to the very first byte.
+    Array<u8, 30> const compressed {
+        0x28, 0xb5, 0x2f, 0xfd, 0xa0, 0xe0, 0x93, 0x04, 0x00, 0x54, 0x00, 0x00, 0x10, 0x78, 0x78, 0x01,
+        0x00, 0xfb, 0xff, 0x39, 0xc0, 0x02, 0x02, 0x00, 0x10, 0x78, 0x03, 0x9f, 0x04, 0x78
+    };
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed));
+    EXPECT_EQ(decompressed.size(), 300000u);
+    for (auto byte : decompressed.bytes())
+        EXPECT_EQ(byte, 'x');
+}
+
+TEST_CASE(zstd_decompress_reference_file)
+{
+    // Compressed with the highest level of the reference implementation, which uses FSE compressed Huffman
+    // weights, four literal streams and tables that are repeated from earlier blocks.
+    auto compressed = read_test_file("zstd-test-files"sv, "KaticaRegular10.font.zst"sv);
+    auto expected = read_test_file("brotli-test-files"sv, "KaticaRegular10.font"sv);
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed));
+    EXPECT_EQ(decompressed.span(), expected.span());
+}
+
+TEST_CASE(zstd_decompress_streaming)
+{
+    auto compressed = read_test_file("zstd-test-files"sv, "KaticaRegular10.font.zst"sv);
+    auto expected = read_test_file("brotli-test-files"sv, "KaticaRegular10.font"sv);
+
+    auto decompressor = TRY_OR_FAIL(Compress::ZstdDecompressor::create(MUST(try_make<FixedMemoryStream>(compressed.bytes()))));
+    ByteBuffer decompressed;
+    Array<u8, 1000> buffer;
+    while (!decompressor->is_eof())
+        decompressed.append(TRY_OR_FAIL(decompressor->read_some(buffer)));
+    EXPECT_EQ(decompressed.span(), expected.span());
+}
+
+TEST_CASE(zstd_decompress_with_dictionary)
+{
+    auto dictionary = TRY_OR_FAIL(Compress::ZstdDictionary::create(read_test_file("zstd-test-files"sv, "dictionary"sv)));
+    EXPECT_EQ(dictionary->id(), 1558892338u);
+
+    auto compressed = read_test_file("zstd-test-files"sv, "dictionary-sample.txt.zst"sv);
+    auto expected = read_test_file("zstd-test-files"sv, "dictionary-sample.txt"sv);
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed, dictionary));
+    EXPECT_EQ(decompressed.span(), expected.span());
+
+    // The frame names the dictionary that it needs.
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+    auto other_dictionary = TRY_OR_FAIL(Compress::ZstdDictionary::create("raw content"sv.bytes()));
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed, other_dictionary).is_error());
+}
+
+TEST_CASE(zstd_decompress_corrupted_input)
+{
+    Array<u8, 27> compressed {
+        0x28, 0xb5, 0x2f, 0xfd, 0x24, 0x0e, 0x71, 0x00, 0x00, 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x2c, 0x20,
+        0x57, 0x6f, 0x72, 0x6c, 0x64, 0x21, 0x0a, 0xf1, 0xf9, 0x8e, 0xb6
+    };
+
+    // Truncated frames.
+    for (size_t size = 1; size < compressed.size(); size++)
+        EXPECT(Compress::ZstdDecompressor::decompress_all(ReadonlyBytes { compressed.data(), size }).is_error());
+
+    // Checksum mismatch.
+    compressed[compressed.size() - 1] ^= 1;
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+    compressed[compressed.size() - 1] ^= 1;
+
+    // Content size mismatch.
+    compressed[5]++;
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+    compressed[5]--;
+
+    // Invalid magic number.
+    compressed[0] = 0;
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+}
+
+TEST_CASE(zstd_compress_roundtrip)
+{
+    for (auto file_name : Array { "lorem.txt"sv, "happy3rd.html"sv, "KaticaRegular10.font"sv, "transform.txt"sv })
+        run_roundtrip_test(read_test_file("brotli-test-files"sv, file_name));
+}
+
+TEST_CASE(zstd_compress_empty_input)
+{
+    run_roundtrip_test({});
+
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all({}, { .include_checksum = false }));
+    EXPECT_EQ(compressed.size(), 9u);
+}
+
+TEST_CASE(zstd_compress_single_byte_run)
+{
+    auto input = MUST(ByteBuffer::create_uninitialized(300000));
+    input.bytes().fill('x');
+    run_roundtrip_test(input);
+
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(input));
+    EXPECT(compressed.size() < 32);
+}
+
+TEST_CASE(zstd_compress_incompressible_data)
+{
+    auto input = MUST(ByteBuffer::create_uninitialized(300000));
+    fill_with_random(input);
+    run_roundtrip_test(input);
+
+    // Blocks that don't get smaller are stored as they are.
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(input));
+    EXPECT(compressed.size() < input.size() + 32);
+}
+
+TEST_CASE(zstd_compress_small_window)
+{
+    auto input = read_test_file("brotli-test-files"sv, "KaticaRegular10.font"sv);
+    for (u8 window_log : Array<u8, 3> { Compress::ZstdCompressor::min_window_log, 13, 17 })
+        run_roundtrip_test(input, { .window_log = window_log });
+
+    EXPECT(Compress::ZstdCompressor::compress_all(input, { .window_log = 9 }).is_error());
+    EXPECT(Compress::ZstdCompressor::compress_all(input, { .window_log = 28 }).is_error());
+}
+
+TEST_CASE(zstd_compress_with_dictionary)
+{
+    auto dictionary = TRY_OR_FAIL(Compress::ZstdDictionary::create(read_test_file("zstd-test-files"sv, "dictionary"sv)));
+    auto input = read_test_file("zstd-test-files"sv, "dictionary-sample.txt"sv);
+    run_roundtrip_test(input, { .dictionary = dictionary });
+
+    auto compressed_with_dictionary = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(input, { .dictionary = dictionary }));
+    auto compressed_without_dictionary = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(input));
+    EXPECT(compressed_with_dictionary.size() < compressed_without_dictionary.size());
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed_with_dictionary).is_error());
+
+    // Raw content dictionaries don't have an ID, so the decompressor has to be given the same one.
+    auto raw_dictionary = TRY_OR_FAIL(Compress::ZstdDictionary::create(input.bytes().slice(0, 1000)));
+    EXPECT_EQ(raw_dictionary->id(), 0u);
+    run_roundtrip_test(input, { .dictionary = raw_dictionary });
+}
+
+TEST_CASE(zstd_compress_streaming)
+{
+    auto input = read_test_file("brotli-test-files"sv, "KaticaRegular10.font"sv);
+
+    auto output_stream = MUST(try_make<AllocatingMemoryStream>());
+    auto compressor = TRY_OR_FAIL(Compress::ZstdCompressor::create(MaybeOwned<Stream>(*output_stream)));
+    for (size_t offset = 0; offset < input.size(); offset += 1000)
+        TRY_OR_FAIL(compressor->write_until_depleted(input.bytes().slice(offset, min<size_t>(1000, input.size() - offset))));
+    TRY_OR_FAIL(compressor->flush());
+
+    // Flushing finishes the frame, nothing can be added after that.
+    EXPECT(compressor->flush().is_error());
+    EXPECT(compressor->write_some("x"sv.bytes()).is_error());
+
+    auto compressed = TRY_OR_FAIL(output_stream->read_until_eof());
+    EXPECT_EQ(compressed, TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(input)));
+}
+
+BENCHMARK_CASE(zstd_decompress_font)
+{
+    auto input = read_test_file("brotli-test-files"sv, "KaticaRegular10.font"sv);
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(input));
+    for (size_t i = 0; i < 10; i++)
+        EXPECT_EQ(TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed)).size(), input.size());
+}
+
+BENCHMARK_CASE(deflate_decompress_font)
+{
+    auto input = read_test_file("brotli-test-files"sv, "KaticaRegular10.font"sv);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(input));
+    for (size_t i = 0; i < 10; i++)
+        EXPECT_EQ(TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed)).size(), input.size());
+}
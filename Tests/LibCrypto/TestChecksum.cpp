@@ -4,11 +4,42 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Checksum/CRC64.h>
+#include <LibCrypto/Checksum/XXHash64.h>
 #include <LibCrypto/Checksum/cksum.h>
 #include <LibTest/TestCase.h>
 
+// Inputs that are long enough to go through the vectorized implementations (if there are any on this CPU)
+static ByteBuffer all_ones_input()
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(1 * MiB));
+    buffer.bytes().fill(0xff);
+    return buffer;
+}
+
+static ByteBuffer patterned_input()
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(100003));
+    for (size_t i = 0; i < buffer.size(); ++i)
+        buffer[i] = static_cast<u8>(i * 7 + (i >> 8));
+    return buffer;
+}
+
+template<typename Checksum>
+static typename Checksum::ChecksumType checksum_in_pieces(ReadonlyBytes input)
+{
+    Checksum checksum;
+    for (size_t piece_size = 1; !input.is_empty(); piece_size = piece_size * 3 + 1) {
+        auto piece = input.trim(piece_size);
+        checksum.update(piece);
+        input = input.slice(piece.size());
+    }
+    return checksum.digest();
+}
+
 TEST_CASE(test_adler32)
 {
     auto do_test = [](ReadonlyBytes input, u32 expected_result) {
@@ -23,6 +54,17 @@ TEST_CASE(test_adler32)
     do_test("abcdefghijklmnopqrstuvwxyz"sv.bytes(), 0x90860b20);
 }
 
+TEST_CASE(test_adler32_large_inputs)
+{
+    auto all_ones = all_ones_input();
+    EXPECT_EQ(Crypto::Checksum::Adler32(all_ones).digest(), 0x8e88ef11u);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::Adler32>(all_ones), 0x8e88ef11u);
+
+    auto patterned = patterned_input();
+    EXPECT_EQ(Crypto::Checksum::Adler32(patterned).digest(), 0xaaa69db6u);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::Adler32>(patterned), 0xaaa69db6u);
+}
+
 TEST_CASE(test_cksum)
 {
     auto do_test = [](ReadonlyBytes input, u32 expected_result) {
@@ -63,3 +105,92 @@ TEST_CASE(test_crc32)
     do_test("The quick brown fox jumps over the lazy dog"sv.bytes(), 0x414FA339);
     do_test("various CRC algorithms input data"sv.bytes(), 0x9BD366AE);
 }
+
+TEST_CASE(test_crc32_large_inputs)
+{
+    auto all_ones = all_ones_input();
+    EXPECT_EQ(Crypto::Checksum::CRC32(all_ones).digest(), 0x956bac74u);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::CRC32>(all_ones), 0x956bac74u);
+
+    auto patterned = patterned_input();
+    EXPECT_EQ(Crypto::Checksum::CRC32(patterned).digest(), 0x0b697026u);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::CRC32>(patterned), 0x0b697026u);
+}
+
+TEST_CASE(test_crc64)
+{
+    auto do_test = [](ReadonlyBytes input, u64 expected_result) {
+        auto digest = Crypto::Checksum::CRC64(input).digest();
+        EXPECT_EQ(digest, expected_result);
+    };
+
+    do_test(""sv.bytes(), 0x0);
+    do_test("123456789"sv.bytes(), 0x995DC9BBDF1939FA);
+    do_test("The quick brown fox jumps over the lazy dog"sv.bytes(), 0x5B5EB8C2E54AA1C4);
+}
+
+TEST_CASE(test_crc64_large_inputs)
+{
+    auto all_ones = all_ones_input();
+    EXPECT_EQ(Crypto::Checksum::CRC64(all_ones).digest(), 0x36c5d72509643840u);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::CRC64>(all_ones), 0x36c5d72509643840u);
+
+    auto patterned = patterned_input();
+    EXPECT_EQ(Crypto::Checksum::CRC64(patterned).digest(), 0xaa668b33fe85d471u);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::CRC64>(patterned), 0xaa668b33fe85d471u);
+}
+
+TEST_CASE(test_xxhash64)
+{
+    auto do_test = [](ReadonlyBytes input, u64 expected_result) {
+        auto digest = Crypto::Checksum::XXHash64(input).digest();
+        EXPECT_EQ(digest, expected_result);
+    };
+
+    do_test(""sv.bytes(), 0xEF46DB3751D8E999);
+    do_test("abc"sv.bytes(), 0x44BC2CF5AD770999);
+    do_test("The quick brown fox jumps over the lazy dog"sv.bytes(), 0x0B242D361FDA71BC);
+
+    Crypto::Checksum::XXHash64 seeded { 1 };
+    seeded.update("abc"sv.bytes());
+    EXPECT_EQ(seeded.digest(), 0xBEA9CA8199328908u);
+}
+
+TEST_CASE(test_xxhash64_large_inputs)
+{
+    auto all_ones = all_ones_input();
+    EXPECT_EQ(Crypto::Checksum::XXHash64(all_ones).digest(), 0x93E8573813BAC8B4u);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::XXHash64>(all_ones), 0x93E8573813BAC8B4u);
+
+    auto patterned = patterned_input();
+    EXPECT_EQ(Crypto::Checksum::XXHash64(patterned).digest(), 0x310E79DF239CCBADu);
+    EXPECT_EQ(checksum_in_pieces<Crypto::Checksum::XXHash64>(patterned), 0x310E79DF239CCBADu);
+}
+
+template<typename Checksum>
+static void checksum_throughput()
+{
+    auto input = MUST(ByteBuffer::create_zeroed(16 * MiB));
+    for (size_t i = 0; i < 16; ++i)
+        (void)Checksum(input).digest();
+}
+
+BENCHMARK_CASE(adler32_throughput)
+{
+    checksum_throughput<Crypto::Checksum::Adler32>();
+}
+
+BENCHMARK_CASE(crc32_throughput)
+{
+    checksum_throughput<Crypto::Checksum::CRC32>();
+}
+
+BENCHMARK_CASE(crc64_throughput)
+{
+    checksum_throughput<Crypto::Checksum::CRC64>();
+}
+
+BENCHMARK_CASE(xxhash64_throughput)
+{
+    checksum_throughput<Crypto::Checksum::XXHash64>();
+}
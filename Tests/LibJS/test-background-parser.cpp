@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibJS/AST.h>
+#include <LibJS/BackgroundParser.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibJS/SourceTextModule.h>
+#include <LibTest/TestCase.h>
+
+static JS::BackgroundParser::ParseResult parse_in_background(JS::VM& vm, StringView source_text, bool as_module = false)
+{
+    Core::EventLoop event_loop;
+    Optional<JS::BackgroundParser::ParseResult> parse_result;
+
+    auto on_complete = [&](JS::BackgroundParser::ParseResult result) {
+        parse_result = move(result);
+        event_loop.quit(0);
+    };
+    if (as_module)
+        JS::BackgroundParser::parse_module(vm, source_text, "test.mjs"sv, move(on_complete));
+    else
+        JS::BackgroundParser::parse_script(vm, source_text, "test.js"sv, 1, move(on_complete));
+
+    event_loop.exec();
+    return parse_result.release_value();
+}
+
+TEST_CASE(script_parsed_in_background_can_be_run)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    auto result = parse_in_background(*vm, "function add(a, b) { return a + b; } add(40, 2);"sv);
+    EXPECT(!result.is_error());
+
+    auto script = JS::Script::create(realm, "test.js"sv, result.release_value());
+    auto value = MUST(vm->bytecode_interpreter().run(*script));
+    EXPECT_EQ(value, JS::Value(42));
+}
+
+TEST_CASE(module_parsed_in_background)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto result = parse_in_background(*vm, "import { x } from './other.mjs'; export const y = x * 2;"sv, true);
+    EXPECT(!result.is_error());
+
+    auto module = JS::SourceTextModule::create(*root_execution_context->realm, "test.mjs"sv, result.release_value());
+    EXPECT_EQ(module->requested_modules().size(), 1u);
+}
+
+TEST_CASE(syntax_errors_are_reported_back)
+{
+    auto vm = MUST(JS::VM::create());
+    auto result = parse_in_background(*vm, "let = ;"sv);
+    EXPECT(result.is_error());
+    EXPECT(!result.error().is_empty());
+}
+
+// Only the top-level code is compiled in the background, the functions are compiled when they're first called.
+TEST_CASE(bytecode_is_generated_in_background)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    auto result = parse_in_background(*vm, "const strings = ['a', 'b']; const big = 12345678901234567890n; `${strings.join('')}${big}${1.5}`"sv);
+    EXPECT(!result.is_error());
+    auto program = result.release_value();
+    auto unlinked_executable = program->take_unlinked_executable();
+    EXPECT(unlinked_executable);
+    program->set_unlinked_executable(unlinked_executable.release_nonnull());
+
+    auto script = JS::Script::create(realm, "test.js"sv, move(program));
+    auto value = MUST(vm->bytecode_interpreter().run(*script));
+    EXPECT_EQ(value.to_string_without_side_effects(), "ab123456789012345678901.5"sv);
+
+    // The executable was linked from what was generated in the background, so there's nothing left to link.
+    EXPECT(!script->parse_node().take_unlinked_executable());
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibFileSystem/TempFile.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// The top-level code uses both a global variable cache and a property lookup cache, and the functions
+// cover regexes, exception handlers, closures and classes, all of which have to survive the trip through the cache.
+static constexpr auto source = R"(
+function sum_of_squares(n) { let total = 0; for (let i = 0; i < n; ++i) total += i * i; return total; }
+function describe(o) {
+    try {
+        return o.name.length + ":" + /a+b/.exec(o.name)[0];
+    } catch (e) {
+        return "error";
+    }
+}
+function make_counter(start) { let count = start; return () => ++count; }
+class Point { constructor(x) { this.x = x; } twice() { return this.x * 2; } }
+const counter = make_counter(40);
+counter();
+[sum_of_squares(10), describe({ name: "xaab" }), describe({}), counter(), new Point(21).twice(), 12345678901234567890n, [1, 2, 3].length].join("|")
+)"sv;
+
+static constexpr auto expected_result = "285|4:aab|error|42|42|12345678901234567890|3"sv;
+
+// Layout of a cache file: magic, format fingerprint, SHA-256 of the source code, node count and the lazy parsing flag,
+// followed by records of a node index, a CRC32 and the size of the payload, then the payload itself.
+static constexpr size_t header_size = 4 + 4 + 32 + 4 + 1;
+static constexpr size_t record_header_size = 4 + 4 + 4;
+
+// Offsets into the payload of a record.
+static constexpr size_t number_of_registers_offset = 0;
+static constexpr size_t number_of_property_lookup_caches_offset = 9;
+static constexpr size_t number_of_global_variable_caches_offset = 17;
+
+// NOTE: Every run gets a VM of its own, so nothing is shared with the previous run except the cache file.
+static ByteString run()
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto script = JS::Script::parse(source, *root_execution_context->realm);
+    VERIFY(!script.is_error());
+    auto result = vm->bytecode_interpreter().run(*script.value());
+    VERIFY(!result.is_error());
+    if (auto* cache = script.value()->parse_node().bytecode_cache())
+        cache->flush();
+    return result.value().to_string_without_side_effects().to_byte_string();
+}
+
+class CacheDirectory {
+public:
+    CacheDirectory()
+        : m_directory(MUST(FileSystem::TempFile::create_temp_directory()))
+    {
+        JS::Bytecode::BytecodeCache::set_directory(m_directory->path().to_byte_string());
+    }
+
+    ~CacheDirectory()
+    {
+        JS::Bytecode::BytecodeCache::set_directory({});
+    }
+
+    ByteString file_path() const
+    {
+        Core::DirIterator iterator { m_directory->path().to_byte_string(), Core::DirIterator::SkipParentAndBaseDir };
+        VERIFY(iterator.has_next());
+        auto path = iterator.next_full_path();
+        VERIFY(!iterator.has_next());
+        return path;
+    }
+
+    ByteBuffer read() const
+    {
+        auto file = MUST(Core::File::open(file_path(), Core::File::OpenMode::Read));
+        return MUST(file->read_until_eof());
+    }
+
+    void write(ReadonlyBytes contents) const
+    {
+        auto file = MUST(Core::File::open(file_path(), Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+        MUST(file->write_until_depleted(contents));
+    }
+
+private:
+    NonnullOwnPtr<FileSystem::TempFile> m_directory;
+};
+
+static u32 read_u32(ReadonlyBytes bytes, size_t offset)
+{
+    u32 value;
+    memcpy(&value, bytes.offset(offset), sizeof(value));
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+static void write_u32(Bytes bytes, size_t offset, u32 value)
+{
+    value = AK::convert_between_host_and_little_endian(value);
+    memcpy(bytes.offset(offset), &value, sizeof(value));
+}
+
+static void write_u64(Bytes bytes, size_t offset, u64 value)
+{
+    value = AK::convert_between_host_and_little_endian(value);
+    memcpy(bytes.offset(offset), &value, sizeof(value));
+}
+
+// The first record holds the top-level code, since that's compiled before any of the functions.
+static Bytes first_payload(ByteBuffer& contents)
+{
+    auto size = read_u32(contents, header_size + 8);
+    return contents.bytes().slice(header_size + record_header_size, size);
+}
+
+static void update_first_checksum(ByteBuffer& contents)
+{
+    write_u32(contents, header_size + 4, Crypto::Checksum::CRC32 { first_payload(contents) }.digest());
+}
+
+static size_t count_records(ReadonlyBytes contents)
+{
+    size_t count = 0;
+    for (size_t offset = header_size; offset < contents.size(); offset += record_header_size + read_u32(contents, offset + 8))
+        ++count;
+    return count;
+}
+
+// Fills the cache directory with a file holding a record for the program and each of the functions it called.
+static ByteBuffer populate_cache(CacheDirectory const& directory)
+{
+    EXPECT_EQ(run(), expected_result);
+    auto contents = directory.read();
+    // The top-level code, sum_of_squares, describe, make_counter, the arrow function it returns, and both functions of Point.
+    EXPECT_EQ(count_records(contents), 7u);
+    return contents;
+}
+
+TEST_CASE(round_trip)
+{
+    CacheDirectory directory;
+    auto contents = populate_cache(directory);
+
+    // Everything comes from the cache now, so nothing new gets written.
+    EXPECT_EQ(run(), expected_result);
+    EXPECT(directory.read() == contents);
+    EXPECT_EQ(run(), expected_result);
+    EXPECT(directory.read() == contents);
+}
+
+TEST_CASE(file_from_a_different_format_is_replaced)
+{
+    CacheDirectory directory;
+    auto contents = populate_cache(directory);
+
+    auto stale = contents;
+    write_u32(stale, 4, read_u32(stale, 4) ^ 1);
+    directory.write(stale);
+
+    EXPECT_EQ(run(), expected_result);
+    EXPECT(directory.read() == contents);
+}
+
+TEST_CASE(record_with_bad_checksum_is_ignored)
+{
+    CacheDirectory directory;
+    auto contents = populate_cache(directory);
+
+    auto corrupt = contents;
+    first_payload(corrupt)[0] ^= 1;
+    directory.write(corrupt);
+
+    // The damaged record and everything after it is cut off, and the records compiled again take their place.
+    EXPECT_EQ(run(), expected_result);
+    EXPECT(directory.read() == contents);
+}
+
+TEST_CASE(truncated_file_is_ignored)
+{
+    CacheDirectory directory;
+    auto contents = populate_cache(directory);
+
+    for (size_t size = 0; size < contents.size(); size += 97) {
+        directory.write(contents.bytes().trim(size));
+        EXPECT_EQ(run(), expected_result);
+        EXPECT(directory.read() == contents);
+    }
+}
+
+// These records all have a valid checksum, so they only get rejected by checking their contents.
+static void expect_record_is_rejected(CacheDirectory const& directory, ByteBuffer const& contents, Function<void(ByteBuffer&)> corrupt)
+{
+    auto corrupted = contents;
+    corrupt(corrupted);
+    update_first_checksum(corrupted);
+    directory.write(corrupted);
+
+    // A rejected record is compiled again, and the result is appended to the file, where it replaces the rejected one.
+    EXPECT_EQ(run(), expected_result);
+    auto rewritten = directory.read();
+    EXPECT(rewritten.size() > corrupted.size());
+    EXPECT_EQ(run(), expected_result);
+    EXPECT(directory.read() == rewritten);
+}
+
+TEST_CASE(record_with_invalid_contents_is_rejected)
+{
+    CacheDirectory directory;
+    auto contents = populate_cache(directory);
+
+    expect_record_is_rejected(directory, contents, [](auto& corrupted) {
+        write_u64(first_payload(corrupted), number_of_registers_offset, 1);
+    });
+    expect_record_is_rejected(directory, contents, [](auto& corrupted) {
+        write_u64(first_payload(corrupted), number_of_property_lookup_caches_offset, 0);
+    });
+    expect_record_is_rejected(directory, contents, [](auto& corrupted) {
+        write_u64(first_payload(corrupted), number_of_global_variable_caches_offset, 0);
+    });
+}
+
+TEST_CASE(truncated_record_is_rejected)
+{
+    CacheDirectory directory;
+    auto contents = populate_cache(directory);
+    auto payload_size = first_payload(contents).size();
+
+    for (size_t size = 0; size < payload_size; size += 13) {
+        // Only the first record is kept, with its size cut down.
+        auto truncated = MUST(ByteBuffer::copy(contents.bytes().trim(header_size + record_header_size + size)));
+        write_u32(truncated, header_size + 8, size);
+        update_first_checksum(truncated);
+        directory.write(truncated);
+
+        EXPECT_EQ(run(), expected_result);
+        EXPECT(directory.read().size() > truncated.size());
+    }
+}
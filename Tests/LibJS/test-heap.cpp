@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Heap/Heap.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+class TestVM {
+public:
+    TestVM()
+        : m_vm(MUST(JS::VM::create()))
+        , m_root_execution_context(JS::create_simple_execution_context<JS::GlobalObject>(*m_vm))
+    {
+    }
+
+    JS::Heap& heap() { return m_vm->heap(); }
+
+    ByteString run(StringView source)
+    {
+        auto script = JS::Script::parse(source, *m_root_execution_context->realm);
+        VERIFY(!script.is_error());
+        auto result = m_vm->bytecode_interpreter().run(*script.value());
+        if (result.is_error())
+            return ByteString::formatted("threw {}", result.error().value()->to_string_without_side_effects());
+        return result.value().to_string_without_side_effects().to_byte_string();
+    }
+
+private:
+    NonnullRefPtr<JS::VM> m_vm;
+    OwnPtr<JS::ExecutionContext> m_root_execution_context;
+};
+
+// Builds a graph of objects, arrays, maps, strings and closures that is large enough to be marked in parallel,
+// and checks that every part of it is still intact after each collection.
+TEST_CASE(large_heap_is_marked_in_parallel)
+{
+    TestVM vm;
+    vm.heap().set_parallel_marking_thread_count(4);
+
+    EXPECT_EQ(vm.run(R"(
+var nodes = [];
+for (let i = 0; i < 200000; ++i) {
+    const node = { index: i, name: "node" + i, children: [], next: null };
+    node.get_index = () => node.index;
+    if (i > 0) {
+        nodes[i - 1].next = node;
+        nodes[Math.floor(i / 2)].children.push(node);
+    }
+    nodes.push(node);
+}
+var lookup = new Map(nodes.map(node => [node.name, node]));
+nodes = null;
+
+function check() {
+    let count = 0;
+    let sum = 0;
+    for (let node = lookup.get("node0"); node; node = node.next) {
+        if (node.get_index() !== node.index || lookup.get(node.name) !== node)
+            return "broken at " + node.index;
+        for (const child of node.children)
+            sum += child.index;
+        ++count;
+    }
+    return count + ":" + sum;
+}
+check()
+)"sv),
+        "200000:19999900000"sv);
+
+    for (size_t i = 0; i < 3; ++i) {
+        vm.heap().collect_garbage();
+        EXPECT_EQ(vm.run("check()"sv), "200000:19999900000"sv);
+    }
+}
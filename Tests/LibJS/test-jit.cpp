@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TemporaryChange.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// Each function gets called with every pair of inputs a few times over, so that it's well past
+// the hotness threshold and we exercise both the inline int32 fast paths and the slow cases they bail out to.
+static constexpr auto source = R"(
+function add(a, b) { return a + b; }
+function sub(a, b) { return a - b; }
+function compare(a, b) { return (a < b) + "" + (a <= b) + (a > b) + (a >= b); }
+function compare_and_branch(a, b) {
+    let result = 0;
+    if (a < b) result += 1;
+    if (a <= b) result += 2;
+    if (a > b) result += 4;
+    if (a >= b) result += 8;
+    if (a === b) result += 16;
+    if (a == b) result += 32;
+    return result;
+}
+function truthiness(a, b) { if (a) return b ?? "nullish"; return b === undefined ? "undefined" : "other"; }
+function count_up(a, b) { let sum = 0; for (let i = a; i < b; ++i) sum += i; return sum; }
+function count_down(a, b) { let n = 0; while (a-- > b) n++; return n + ":" + a; }
+function increment(a, b) { let x = a; x++; ++x; x--; return x - b; }
+function property(a, b) { return a.length + b.length; }
+function call_property(a, b) { return property(a, b) + 1; }
+
+const inputs = [0, 1, -1, 7, 2147483647, -2147483648, 0.5, -0, NaN, Infinity, "3", "", "a", null, undefined, true, false, 1n, { valueOf() { return 5; } }, [2]];
+
+function attempt(f, a, b) {
+    try {
+        return String(f(a, b));
+    } catch (e) {
+        return "threw " + e.constructor.name;
+    }
+}
+
+const functions = [add, sub, compare, compare_and_branch, truthiness, count_up, count_down, increment, property, call_property];
+const results = [];
+for (let round = 0; round < 3; ++round) {
+    for (const f of functions) {
+        for (const a of inputs) {
+            for (const b of inputs) {
+                if (f === count_up || f === count_down) {
+                    if (typeof a !== "number" || typeof b !== "number" || !(a > -100 && a < 100 && b > -100 && b < 100))
+                        continue;
+                }
+                results.push(f.name + "(" + String(a) + ", " + String(b) + ") = " + attempt(f, a, b));
+            }
+        }
+    }
+}
+results.join("\n");
+)"sv;
+
+static constexpr Array compiled_functions { "add"sv, "sub"sv, "compare"sv, "compare_and_branch"sv, "truthiness"sv, "count_up"sv, "count_down"sv, "increment"sv, "property"sv, "call_property"sv };
+
+class TestVM {
+public:
+    TestVM()
+        : m_vm(MUST(JS::VM::create()))
+        , m_root_execution_context(JS::create_simple_execution_context<JS::GlobalObject>(*m_vm))
+    {
+    }
+
+    ByteString run(StringView source)
+    {
+        auto script = JS::Script::parse(source, *m_root_execution_context->realm);
+        VERIFY(!script.is_error());
+        auto result = m_vm->bytecode_interpreter().run(*script.value());
+        VERIFY(!result.is_error());
+        return result.value().to_string_without_side_effects().to_byte_string();
+    }
+
+    static bool is_compiled(StringView function_name)
+    {
+        bool is_compiled = false;
+        JS::Bytecode::Executable::for_each_live_executable([&](auto& executable) {
+            if (executable.name == function_name && executable.native_executable())
+                is_compiled = true;
+        });
+        return is_compiled;
+    }
+
+private:
+    NonnullRefPtr<JS::VM> m_vm;
+    OwnPtr<JS::ExecutionContext> m_root_execution_context;
+};
+
+TEST_CASE(jit_matches_the_interpreter)
+{
+    ByteString expected;
+    {
+        TestVM vm;
+        expected = vm.run(source);
+        for (auto name : compiled_functions)
+            EXPECT(!vm.is_compiled(name));
+    }
+
+    TemporaryChange jit_enabled { JS::JIT::g_jit_enabled, true };
+    TestVM vm;
+    auto actual = vm.run(source);
+
+    auto expected_lines = expected.split('\n');
+    auto actual_lines = actual.split('\n');
+    EXPECT_EQ(actual_lines.size(), expected_lines.size());
+    for (size_t i = 0; i < min(actual_lines.size(), expected_lines.size()); ++i) {
+        if (actual_lines[i] != expected_lines[i]) {
+            warnln("JIT: {}", actual_lines[i]);
+            warnln("Interpreter: {}", expected_lines[i]);
+            FAIL("JIT result differs from the interpreter");
+            break;
+        }
+    }
+
+#ifdef JIT_ARCH_SUPPORTED
+    for (auto name : compiled_functions) {
+        if (!vm.is_compiled(name))
+            FAIL(ByteString::formatted("{} was not compiled", name));
+    }
+    // Exception handlers are left to the interpreter.
+    EXPECT(!vm.is_compiled("attempt"sv));
+#endif
+}
+
+TEST_CASE(jit_bails_out_on_int32_overflow)
+{
+    TemporaryChange jit_enabled { JS::JIT::g_jit_enabled, true };
+    TestVM vm;
+
+    EXPECT_EQ(vm.run(R"(
+function sum_to(n) { let sum = 0; for (let i = 0; i < n; ++i) sum += i; return sum; }
+sum_to(100000)
+)"sv),
+        "4999950000"sv);
+#ifdef JIT_ARCH_SUPPORTED
+    EXPECT(vm.is_compiled("sum_to"sv));
+#endif
+
+    EXPECT_EQ(vm.run(R"(
+function wrap(x) { let y = x; y++; ++y; return y; }
+let last;
+for (let i = 0; i < 20; ++i) last = wrap(2147483647 - i);
+[wrap(2147483646), wrap(-2147483648), wrap(1.5), wrap("1"), last].join()
+)"sv),
+        "2147483648,-2147483646,3.5,3,2147483630"sv);
+#ifdef JIT_ARCH_SUPPORTED
+    EXPECT(vm.is_compiled("wrap"sv));
+#endif
+}
+
+TEST_CASE(jit_propagates_exceptions)
+{
+    TemporaryChange jit_enabled { JS::JIT::g_jit_enabled, true };
+    TestVM vm;
+
+    EXPECT_EQ(vm.run(R"(
+function inner(o) { return o.x.y + 1; }
+function outer(o) { return inner(o) * 2; }
+let total = 0;
+for (let i = 0; i < 20; ++i) total += outer({ x: { y: i } });
+let error;
+try { outer({}); } catch (e) { error = e; }
+let bigint_error;
+try { for (let i = 0; i < 20; ++i) inner({ x: { y: i < 19 ? i : 1n } }); } catch (e) { bigint_error = e; }
+[total, error.constructor.name, bigint_error.constructor.name, outer({ x: { y: 4 } })].join()
+)"sv),
+        "420,TypeError,TypeError,10"sv);
+#ifdef JIT_ARCH_SUPPORTED
+    EXPECT(vm.is_compiled("inner"sv));
+    EXPECT(vm.is_compiled("outer"sv));
+#endif
+}
+
+TEST_CASE(jit_leaves_generators_and_exception_handlers_to_the_interpreter)
+{
+    TemporaryChange jit_enabled { JS::JIT::g_jit_enabled, true };
+    TestVM vm;
+
+    EXPECT_EQ(vm.run(R"(
+function* numbers(n) { for (let i = 0; i < n; ++i) yield i; }
+function guarded(f) { try { return f(); } catch (e) { return -1; } finally { } }
+let sum = 0;
+for (let i = 0; i < 20; ++i) {
+    for (const n of numbers(i)) sum += n;
+    sum += guarded(() => { if (i % 2) throw i; return i; });
+}
+sum
+)"sv),
+        "1220"sv);
+#ifdef JIT_ARCH_SUPPORTED
+    EXPECT(!vm.is_compiled("numbers"sv));
+    EXPECT(!vm.is_compiled("guarded"sv));
+#endif
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TemporaryChange.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+class TestVM {
+public:
+    TestVM()
+        : m_vm(MUST(JS::VM::create()))
+        , m_root_execution_context(JS::create_simple_execution_context<JS::GlobalObject>(*m_vm))
+    {
+    }
+
+    ByteString run(StringView source)
+    {
+        auto script = JS::Script::parse(source, *m_root_execution_context->realm);
+        VERIFY(!script.is_error());
+        auto result = m_vm->bytecode_interpreter().run(*script.value());
+        if (result.is_error())
+            return ByteString::formatted("threw {}", result.error().value()->to_string_without_side_effects());
+        return result.value().to_string_without_side_effects().to_byte_string();
+    }
+
+    bool has_lazy_body(StringView function_name)
+    {
+        auto value = MUST(m_root_execution_context->realm->global_object().get(JS::PropertyKey { DeprecatedFlyString { function_name } }));
+        VERIFY(value.is_function() && is<JS::ECMAScriptFunctionObject>(value.as_function()));
+        auto const& code = static_cast<JS::ECMAScriptFunctionObject const&>(value.as_function()).ecmascript_code();
+        return code.is_function_body() && static_cast<JS::FunctionBody const&>(code).is_lazy();
+    }
+
+private:
+    NonnullRefPtr<JS::VM> m_vm;
+    OwnPtr<JS::ExecutionContext> m_root_execution_context;
+};
+
+static bool parses(StringView source)
+{
+    return !JS::Script::parse_program(source).is_error();
+}
+
+TEST_CASE(functions_are_parsed_on_first_call)
+{
+    TemporaryChange lazy { JS::g_parse_function_bodies_lazily, true };
+    TestVM vm;
+    EXPECT_EQ(vm.run("function called() { return 1; } function not_called() { return 2; } called()"sv), "1"sv);
+    EXPECT(!vm.has_lazy_body("called"sv));
+    EXPECT(vm.has_lazy_body("not_called"sv));
+}
+
+// Early errors have to be reported when the script is parsed, no matter whether the function they are in ever runs.
+TEST_CASE(early_errors_in_pre_parsed_functions)
+{
+    TemporaryChange lazy { JS::g_parse_function_bodies_lazily, true };
+
+    static constexpr Array invalid_sources {
+        "function f() { let a; let a; }"sv,
+        "function f() { let a; var a; }"sv,
+        "function f() { 1 = 2; }"sv,
+        "function f() { break; }"sv,
+        "function f() { a: a: ; }"sv,
+        "function f() { continue outer; }"sv,
+        "function f() { return new.target + super.x; }"sv,
+        "function f() { 'use strict'; with (o) {} }"sv,
+        "function f(a, a) { 'use strict'; }"sv,
+        "function f(a = 1) { 'use strict'; }"sv,
+        "function* f() { var yield; }"sv,
+        "async function f() { var await; }"sv,
+        "function f() { return /(/; }"sv,
+        "function f() { return `${`; }"sv,
+        "function f() { return g => { let b; let b; }; }"sv,
+        "function f() { return () => () => { for (const x of []) { var x; } }; }"sv,
+        "function f() { return (a, a) => a; }"sv,
+        "function f() { function g() { 'use strict'; var eval; } }"sv,
+        "function f() { class C { m() { let c; let c; } } }"sv,
+        "function f() { class C extends D { constructor() { super(); } m() { super(); } } }"sv,
+        "function f() { return { m() { let c; let c; } }; }"sv,
+    };
+    for (auto source : invalid_sources) {
+        EXPECT(!parses(source));
+        if (parses(source))
+            warnln("Expected a syntax error in: {}", source);
+    }
+
+    // Things that look like errors, but aren't.
+    static constexpr Array valid_sources {
+        "function f() { let a; { let a; } }"sv,
+        "function f() { a: { break a; } }"sv,
+        "function f() { return new.target; }"sv,
+        "function f() { with (o) {} }"sv,
+        "function f(a, a) {}"sv,
+        "function f() { var yield, await; }"sv,
+        "function f() { return `${'}'}` + /}/.source + /[/]/.source; }"sv,
+        "function f() { return { m() { return super.x; } }; }"sv,
+    };
+    for (auto source : valid_sources) {
+        EXPECT(parses(source));
+        if (!parses(source))
+            warnln("Unexpected syntax error in: {}", source);
+    }
+}
+
+// Code that is easy to get wrong when skipping over function bodies, run with and without pre-parsing.
+TEST_CASE(pre_parsed_functions_behave_like_fully_parsed_ones)
+{
+    static constexpr auto source = R"(
+function tokens(a, b, c) {
+    const x = a / b / c;
+    const y = [a] / 2 /
+        1;
+    if (a) /}/.test("}") ? x : y;
+    const t = `${a}}${`{${b}`}${"}"}`;
+    const r = /[/}]+/g.exec("a/}b")[0];
+    return [x, y, t, r].join(" ");
+}
+
+function nested(n) {
+    const add = a => b => c => a + b + c + n;
+    class Counter {
+        #count = n;
+        static make() { return new Counter(); }
+        get count() { return this.#count; }
+        increment() { return () => ++this.#count; }
+    }
+    const counter = Counter.make();
+    counter.increment()();
+    function* generate() { yield add(1)(2)(3); yield counter.count; }
+    return [...generate()].join(",");
+}
+
+function captures() {
+    let captured = 1;
+    function inner() { return captured += 10; }
+    inner();
+    return captured + inner();
+}
+
+function uses_arguments() { return arguments.length + eval("arguments[1]"); }
+
+[tokens(8, 2, 2), nested(5), captures(), uses_arguments(1, 2, 3)].join("|")
+)"sv;
+
+    static constexpr auto expected_result = "2 4 8}{2} /}|11,6|32|5"sv;
+
+    for (auto lazily : { false, true }) {
+        TemporaryChange lazy { JS::g_parse_function_bodies_lazily, lazily };
+        TestVM vm;
+        EXPECT_EQ(vm.run(source), expected_result);
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TemporaryChange.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+// Each function below contains exactly one property access, so its executable has exactly one property lookup cache.
+static constexpr auto functions = R"(
+function get_x(o) { return o.x; }
+function set_x(o, value) { o.x = value; }
+function make(shape, x) {
+    const o = {};
+    for (let i = 0; i < shape; ++i)
+        o["p" + i] = i;
+    o.x = x;
+    return o;
+}
+)"sv;
+
+class TestVM {
+public:
+    TestVM()
+        : m_vm(MUST(JS::VM::create()))
+        , m_root_execution_context(JS::create_simple_execution_context<JS::GlobalObject>(*m_vm))
+    {
+        EXPECT_EQ(run(functions), JS::js_undefined());
+    }
+
+    JS::Value run(StringView source)
+    {
+        auto script = JS::Script::parse(source, *m_root_execution_context->realm);
+        VERIFY(!script.is_error());
+        auto result = m_vm->bytecode_interpreter().run(*script.value());
+        VERIFY(!result.is_error());
+        return result.value();
+    }
+
+    // NOTE: Functions are only compiled to bytecode once they are first called.
+    JS::Bytecode::PropertyLookupCache const& cache_for(StringView function_name)
+    {
+        JS::Bytecode::PropertyLookupCache const* cache = nullptr;
+        JS::Bytecode::Executable::for_each_live_executable([&](auto& executable) {
+            if (executable.name != function_name)
+                return;
+            VERIFY(executable.property_lookup_caches.size() == 1);
+            cache = &executable.property_lookup_caches.first();
+        });
+        VERIFY(cache);
+        return *cache;
+    }
+
+private:
+    NonnullRefPtr<JS::VM> m_vm;
+    OwnPtr<JS::ExecutionContext> m_root_execution_context;
+};
+
+TEST_CASE(get_by_id_cache_stays_polymorphic_up_to_the_limit)
+{
+    TestVM vm;
+    EXPECT_EQ(vm.run("get_x(make(0, 1))"sv), JS::Value(1));
+    auto const& cache = vm.cache_for("get_x"sv);
+    EXPECT_EQ(cache.number_of_entries, 1);
+    EXPECT(!cache.is_megamorphic);
+
+    // Seeing the same shape again must not take up another entry.
+    EXPECT_EQ(vm.run("get_x(make(0, 2))"sv), JS::Value(2));
+    EXPECT_EQ(cache.number_of_entries, 1);
+
+    EXPECT_EQ(vm.run("let sum = 0; for (let i = 0; i < 4; ++i) sum += get_x(make(i, i * 10)); sum"sv), JS::Value(60));
+    EXPECT_EQ(cache.number_of_entries, JS::Bytecode::PropertyLookupCache::max_number_of_shapes_to_remember);
+    EXPECT(!cache.is_megamorphic);
+
+    // Every shape is cached now, so all of these must come from the right entry.
+    EXPECT_EQ(vm.run("let sum2 = 0; for (let j = 0; j < 100; ++j) sum2 += get_x(make(j % 4, j % 4)); sum2"sv), JS::Value(150));
+    EXPECT(!cache.is_megamorphic);
+}
+
+TEST_CASE(get_by_id_cache_goes_megamorphic)
+{
+    TestVM vm;
+    EXPECT_EQ(vm.run("let sum = 0; for (let i = 0; i < 5; ++i) sum += get_x(make(i, i)); sum"sv), JS::Value(10));
+    auto const& cache = vm.cache_for("get_x"sv);
+    EXPECT(cache.is_megamorphic);
+    EXPECT_EQ(cache.number_of_entries, JS::Bytecode::PropertyLookupCache::max_number_of_shapes_to_remember);
+
+    // Both the inline entries and the megamorphic cache must keep handing out the right offsets.
+    EXPECT_EQ(vm.run("let sum2 = 0; for (let j = 0; j < 200; ++j) sum2 += get_x(make(j % 20, j % 20)); sum2"sv), JS::Value(1900));
+
+    // Properties on the prototype chain, including after the prototype is changed under the megamorphic cache.
+    EXPECT_EQ(vm.run("const proto = { x: 7 }; const child = Object.create(proto); get_x(child) + get_x(child)"sv), JS::Value(14));
+    EXPECT_EQ(vm.run("proto.x = 8; get_x(child)"sv), JS::Value(8));
+    EXPECT_EQ(vm.run("Object.setPrototypeOf(child, { x: 9 }); get_x(child)"sv), JS::Value(9));
+    EXPECT_EQ(vm.run("child.x = 10; get_x(child)"sv), JS::Value(10));
+}
+
+TEST_CASE(put_by_id_cache_goes_megamorphic)
+{
+    TestVM vm;
+    EXPECT_EQ(vm.run("const objects = []; for (let i = 0; i < 4; ++i) objects.push(make(i, 0)); for (const o of objects) set_x(o, 1); objects.length"sv), JS::Value(4));
+    auto const& cache = vm.cache_for("set_x"sv);
+    EXPECT_EQ(cache.number_of_entries, JS::Bytecode::PropertyLookupCache::max_number_of_shapes_to_remember);
+    EXPECT(!cache.is_megamorphic);
+
+    EXPECT_EQ(vm.run("for (let i = 4; i < 20; ++i) objects.push(make(i, 0)); for (let j = 0; j < 3; ++j) for (const o of objects) set_x(o, j + o.p0 + 1); objects.length"sv), JS::Value(20));
+    EXPECT(cache.is_megamorphic);
+
+    // Objects without any p0 property end up with NaN, everything else with 3.
+    EXPECT_EQ(vm.run("objects.filter(o => o.x === 3).length"sv), JS::Value(19));
+    EXPECT_EQ(vm.run("Number.isNaN(objects[0].x)"sv), JS::Value(true));
+
+    // A frozen object must not be written to through a cached offset.
+    EXPECT_EQ(vm.run("const frozen = Object.freeze(make(3, 5)); set_x(frozen, 6); frozen.x"sv), JS::Value(5));
+}
+
+TEST_CASE(property_lookup_cache_statistics_are_opt_in)
+{
+    {
+        TestVM vm;
+        EXPECT_EQ(vm.run("let sum = 0; for (let i = 0; i < 10; ++i) sum += get_x(make(0, i)); sum"sv), JS::Value(45));
+        auto const& cache = vm.cache_for("get_x"sv);
+        EXPECT_EQ(cache.hit_count, 0u);
+        EXPECT_EQ(cache.miss_count, 0u);
+    }
+
+    TemporaryChange collect_statistics { JS::Bytecode::g_collect_property_lookup_cache_statistics, true };
+    TestVM vm;
+    EXPECT_EQ(vm.run("let sum = 0; for (let i = 0; i < 10; ++i) sum += get_x(make(0, i)); sum"sv), JS::Value(45));
+    auto const& cache = vm.cache_for("get_x"sv);
+    EXPECT_EQ(cache.hit_count, 9u);
+    EXPECT_EQ(cache.miss_count, 1u);
+}
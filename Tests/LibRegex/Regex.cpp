@@ -1078,6 +1078,142 @@ TEST_CASE(optimizer_alternation)
     }
 }
 
+TEST_CASE(lazy_dfa)
+{
+    {
+        // Only bytecode without backreferences and lookarounds can be run by the DFA.
+        EXPECT(Regex<ECMA262>("a(b|c)*d"sv).parser_result.optimization_data.can_use_lazy_dfa);
+        EXPECT(!Regex<ECMA262>("(a)\\1"sv).parser_result.optimization_data.can_use_lazy_dfa);
+        EXPECT(!Regex<ECMA262>("a(?=b)"sv).parser_result.optimization_data.can_use_lazy_dfa);
+    }
+    {
+        // The DFA has to find the same (leftmost, first alternative) match as the VM.
+        Array tests {
+            Tuple { "a|ab"sv, "xab"sv, "a"sv },
+            Tuple { "ab|a"sv, "xab"sv, "ab"sv },
+            Tuple { "a*?b"sv, "caab"sv, "aab"sv },
+            Tuple { "(?:ab)+c|a"sv, "ababa"sv, "a"sv },
+            Tuple { "x$|y"sv, "xy"sv, "y"sv },
+            Tuple { "^b"sv, "a\nb"sv, ""sv },
+        };
+
+        for (auto& test : tests) {
+            Regex<ECMA262> re(test.get<0>(), ECMAScriptFlags::Global);
+            auto result = re.match(test.get<1>());
+            EXPECT_EQ(result.success, !test.get<2>().is_empty());
+            if (result.success)
+                EXPECT_EQ(result.matches.first().view.to_byte_string(), test.get<2>());
+        }
+    }
+    {
+        // ^ has to be checked after every line terminator in multiline mode, even if the previous position didn't match.
+        Regex<ECMA262> re("^c"sv, ECMAScriptFlags::Multiline);
+        auto result = re.match("ac\ncb\nc"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.size(), 2u);
+        EXPECT_EQ(result.matches[0].global_offset, 3u);
+        EXPECT_EQ(result.matches[1].global_offset, 6u);
+    }
+    {
+        // This would take exponential time to fail in the VM.
+        Regex<ECMA262> re("(?:a|aa)*b"sv);
+        auto result = re.match(ByteString::repeated('a', 1000));
+        EXPECT_EQ(result.success, false);
+    }
+}
+
+TEST_CASE(candidate_scanner)
+{
+    {
+        // Patterns that can match the empty string can start anywhere.
+        EXPECT(!Regex<ECMA262>("a*"sv).parser_result.optimization_data.candidate_scanner.has_value());
+        EXPECT(!Regex<ECMA262>("[^a]b"sv).parser_result.optimization_data.candidate_scanner.has_value());
+        EXPECT(Regex<ECMA262>("a|[b-d]x"sv).parser_result.optimization_data.candidate_scanner.has_value());
+
+        Regex<ECMA262> re("(foo)bar|baz"sv);
+        EXPECT(re.parser_result.optimization_data.candidate_scanner.has_value());
+        EXPECT(re.parser_result.optimization_data.candidate_scanner->literal_prefix().is_empty());
+
+        Regex<ECMA262> re2("(?:foo)bar+"sv);
+        EXPECT_EQ(re2.parser_result.optimization_data.candidate_scanner->literal_prefix().size(), 6u);
+    }
+    {
+        // Candidates have to be found on both sides of a SIMD block boundary, and at the very end of the input.
+        auto haystack = ByteString::formatted("{}HELLO{}hello{}x", ByteString::repeated('.', 13), ByteString::repeated('.', 17), ByteString::repeated('-', 30));
+        Array tests {
+            Tuple { "hello"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, 35u },
+            Tuple { "hello"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Insensitive, 13u },
+            Tuple { "[h-j]ell"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, 35u },
+            Tuple { "[xyz]"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, 70u },
+            Tuple { "\\s|x"sv, ECMAScriptOptions { ECMAScriptFlags::Global }, 70u },
+        };
+
+        for (auto& test : tests) {
+            Regex<ECMA262> re(test.get<0>(), test.get<1>());
+            auto result = re.match(haystack);
+            EXPECT_EQ(result.success, true);
+            EXPECT_EQ(result.matches.first().global_offset, test.get<2>());
+
+            Vector<u16> utf16_haystack;
+            for (auto byte : haystack.bytes())
+                utf16_haystack.append(byte);
+            Regex<ECMA262> re2(test.get<0>(), test.get<1>());
+            result = re2.match(Utf16View { utf16_haystack });
+            EXPECT_EQ(result.success, true);
+            EXPECT_EQ(result.matches.first().global_offset, test.get<2>());
+        }
+    }
+    {
+        // The pattern's case sensitivity can be overridden for a single match.
+        Regex<ECMA262> re("hello"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(re.match("say HELLO"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Insensitive).success, true);
+    }
+}
+
+TEST_CASE(pattern_cache)
+{
+    auto& cache = regex::PatternCache<ECMA262>::the();
+    cache.clear();
+
+    {
+        // The same pattern with the same options is only compiled once, but every Regex keeps its own match state.
+        Regex<ECMA262> re("a(b)"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(cache.size(), 1u);
+        Regex<ECMA262> re2("a(b)"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(cache.size(), 1u);
+        EXPECT_EQ(re2.parser_result.capture_groups_count, 1u);
+
+        EXPECT_EQ(re.match("abab"sv).matches.size(), 2u);
+        EXPECT_EQ(re.match("abab"sv).success, false);
+        EXPECT_EQ(re2.match("abab"sv).matches.size(), 2u);
+
+        Regex<ECMA262> re3("a(b)"sv, ECMAScriptFlags::Insensitive);
+        EXPECT_EQ(cache.size(), 2u);
+        EXPECT_EQ(re3.match("AB"sv).success, true);
+    }
+    {
+        // Patterns with errors are not cached.
+        Regex<ECMA262> re("a("sv);
+        EXPECT_NE(re.parser_result.error, regex::Error::NoError);
+        EXPECT(!cache.contains("a("sv, {}));
+    }
+    {
+        // The least recently used pattern is evicted first.
+        cache.clear();
+        Regex<ECMA262> first("first"sv);
+        for (size_t i = 0; i < regex::PatternCache<ECMA262>::capacity - 2; ++i)
+            Regex<ECMA262> re(ByteString::formatted("pattern{}", i));
+        Regex<ECMA262> second("second"sv);
+        Regex<ECMA262> first_again("first"sv);
+        Regex<ECMA262> third("third"sv);
+        EXPECT_EQ(cache.size(), regex::PatternCache<ECMA262>::capacity);
+        EXPECT(cache.contains("first"sv, {}));
+        EXPECT(cache.contains("second"sv, {}));
+        EXPECT(!cache.contains("pattern0"sv, {}));
+    }
+    cache.clear();
+}
+
 TEST_CASE(posix_basic_dollar_is_end_anchor)
 {
     // Ensure that a dollar sign at the end only matches the end of the line.
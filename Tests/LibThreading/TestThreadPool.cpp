@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/OrderedJobQueue.h>
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+TEST_CASE(thread_pool_wait_for_all)
+{
+    Atomic<size_t> jobs_run = 0;
+    Threading::ThreadPool<size_t> pool([&](size_t delay) {
+        usleep(delay);
+        jobs_run++;
+    },
+        4);
+
+    for (size_t i = 0; i < 100; ++i)
+        pool.submit(i % 7 * 100);
+    pool.wait_for_all();
+    EXPECT_EQ(jobs_run.load(), 100u);
+
+    // The pool can be reused once it has run out of work.
+    pool.submit(0);
+    pool.wait_for_all();
+    EXPECT_EQ(jobs_run.load(), 101u);
+}
+
+TEST_CASE(thread_pool_runs_queued_work_before_exiting)
+{
+    Atomic<size_t> jobs_run = 0;
+    {
+        Threading::ThreadPool<size_t> pool([&](size_t) { jobs_run++; }, 2);
+        for (size_t i = 0; i < 50; ++i)
+            pool.submit(i);
+    }
+    EXPECT_EQ(jobs_run.load(), 50u);
+}
+
+struct Job {
+    size_t index { 0 };
+    size_t result { 0 };
+};
+
+static void run_ordered_jobs(size_t thread_count)
+{
+    Vector<size_t> finished;
+    Threading::OrderedJobQueue<Job> queue(
+        thread_count,
+        [](Job& job) -> ErrorOr<void> {
+            // Make the later jobs finish first, so that they have to wait for the earlier ones.
+            usleep((10 - job.index % 10) * 100);
+            job.result = job.index * 2;
+            return {};
+        },
+        [&](Job& job) -> ErrorOr<void> {
+            EXPECT_EQ(job.result, job.index * 2);
+            finished.append(job.index);
+            return {};
+        });
+
+    for (size_t i = 0; i < 100; ++i)
+        TRY_OR_FAIL(queue.submit(make<Job>(i)));
+    TRY_OR_FAIL(queue.finish_all());
+
+    EXPECT_EQ(finished.size(), 100u);
+    for (size_t i = 0; i < finished.size(); ++i)
+        EXPECT_EQ(finished[i], i);
+}
+
+TEST_CASE(ordered_job_queue_finishes_in_order)
+{
+    run_ordered_jobs(0);
+    run_ordered_jobs(1);
+    run_ordered_jobs(4);
+}
+
+TEST_CASE(ordered_job_queue_bounds_jobs_in_flight)
+{
+    Atomic<size_t> jobs_started = 0;
+    size_t jobs_finished = 0;
+    Threading::OrderedJobQueue<Job> queue(
+        2,
+        [&](Job&) -> ErrorOr<void> {
+            jobs_started++;
+            return {};
+        },
+        [&](Job&) -> ErrorOr<void> {
+            jobs_finished++;
+            return {};
+        });
+
+    for (size_t i = 0; i < 20; ++i) {
+        TRY_OR_FAIL(queue.submit(make<Job>(i)));
+        // At most two jobs per thread are allowed to be in flight.
+        EXPECT(i + 1 - jobs_finished <= 4);
+    }
+    TRY_OR_FAIL(queue.finish_all());
+    EXPECT_EQ(jobs_started.load(), 20u);
+    EXPECT_EQ(jobs_finished, 20u);
+}
+
+TEST_CASE(ordered_job_queue_returns_errors_in_order)
+{
+    size_t jobs_finished = 0;
+    Threading::OrderedJobQueue<Job> queue(
+        3,
+        [](Job& job) -> ErrorOr<void> {
+            if (job.index == 5)
+                return Error::from_string_literal("Job failed");
+            return {};
+        },
+        [&](Job&) -> ErrorOr<void> {
+            jobs_finished++;
+            return {};
+        });
+
+    ErrorOr<void> result;
+    for (size_t i = 0; i < 20 && !result.is_error(); ++i)
+        result = queue.submit(make<Job>(i));
+    if (!result.is_error())
+        result = queue.finish_all();
+
+    EXPECT(result.is_error());
+    EXPECT_EQ(jobs_finished, 5u);
+}
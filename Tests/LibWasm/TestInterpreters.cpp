@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <AK/StackInfo.h>
+#include <AK/TemporaryChange.h>
+#include <LibTest/TestCase.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/AbstractMachine/RegisterFunction.h>
+#include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/JIT/Compiler.h>
+
+enum class Engine {
+    // The plain stack machine, forced by installing a debugger hook.
+    Stack,
+    // Register functions, which are what functions run as by default.
+    Register,
+    // Register functions, compiled to native code once they are hot.
+    JIT,
+};
+
+static constexpr Array engines { Engine::Stack, Engine::Register };
+
+class TestModule {
+    AK_MAKE_NONCOPYABLE(TestModule);
+    AK_MAKE_NONMOVABLE(TestModule);
+
+public:
+    static NonnullOwnPtr<TestModule> create(ReadonlyBytes bytes)
+    {
+        FixedMemoryStream stream { bytes };
+        auto test_module = adopt_own(*new TestModule(MUST(Wasm::Module::parse(stream))));
+        MUST(test_module->m_machine.validate(test_module->m_module));
+        test_module->m_instance = MUST(test_module->m_machine.instantiate(test_module->m_module, {}));
+        return test_module;
+    }
+
+    Wasm::Result invoke(Engine engine, StringView name, Vector<Wasm::Value> arguments)
+    {
+        auto address = function_address(name);
+        if (engine == Engine::Stack) {
+            Wasm::DebuggerBytecodeInterpreter interpreter { m_stack_info };
+            interpreter.pre_interpret_hook = [](auto&, auto&, auto&) { return true; };
+            return m_machine.invoke(interpreter, address, move(arguments));
+        }
+
+        TemporaryChange jit_enabled { Wasm::JIT::g_jit_enabled, engine == Engine::JIT };
+        Wasm::BytecodeInterpreter interpreter { m_stack_info };
+        return m_machine.invoke(interpreter, address, move(arguments));
+    }
+
+    // The integer result of a call, or nothing if it trapped.
+    Optional<i64> invoke_integer(Engine engine, StringView name, Vector<Wasm::Value> arguments)
+    {
+        auto result = invoke(engine, name, move(arguments));
+        if (result.is_trap())
+            return {};
+        VERIFY(!result.is_completion());
+        VERIFY(result.values().size() == 1);
+        return result.values().first().value().visit(
+            [](i32 value) -> i64 { return value; },
+            [](i64 value) -> i64 { return value; },
+            [](auto const&) -> i64 { VERIFY_NOT_REACHED(); });
+    }
+
+    i32 invoke_i32(Engine engine, StringView name, Vector<Wasm::Value> arguments)
+    {
+        auto result = invoke(engine, name, move(arguments));
+        VERIFY(!result.is_trap() && !result.is_completion());
+        VERIFY(result.values().size() == 1);
+        return result.values().first().to<i32>().value();
+    }
+
+    bool is_translated(StringView name)
+    {
+        auto* function = m_machine.store().get(function_address(name));
+        VERIFY(function);
+        return function->get<Wasm::WasmFunction>().register_function(m_machine.store()) != nullptr;
+    }
+
+    bool is_compiled(StringView name)
+    {
+        auto* function = m_machine.store().get(function_address(name));
+        VERIFY(function);
+        auto const* register_function = function->get<Wasm::WasmFunction>().register_function(m_machine.store());
+        return register_function && register_function->native_function();
+    }
+
+private:
+    explicit TestModule(Wasm::Module module)
+        : m_module(move(module))
+    {
+    }
+
+    Wasm::FunctionAddress function_address(StringView name) const
+    {
+        for (auto& entry : m_instance->exports()) {
+            if (entry.name() == name)
+                return entry.value().get<Wasm::FunctionAddress>();
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    StackInfo m_stack_info;
+    Wasm::AbstractMachine m_machine;
+    Wasm::Module m_module;
+    OwnPtr<Wasm::ModuleInstance> m_instance;
+};
+
+static Wasm::Value i32_value(i32 value)
+{
+    return Wasm::Value { value };
+}
+
+// (module
+//   (memory 1)
+//   (func (export "fill") (param i32 i32 i32) local.get 0 local.get 1 local.get 2 memory.fill)
+//   (func (export "load") (param i32) (result i32) local.get 0 i32.load8_u))
+static constexpr Array<u8, 72> memory_fill_module {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60, 0x03, 0x7f, 0x7f, 0x7f,
+    0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01,
+    0x07, 0x0f, 0x02, 0x04, 0x66, 0x69, 0x6c, 0x6c, 0x00, 0x00, 0x04, 0x6c, 0x6f, 0x61, 0x64, 0x00,
+    0x01, 0x0a, 0x15, 0x02, 0x0b, 0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xfc, 0x0b, 0x00, 0x0b,
+    0x07, 0x00, 0x20, 0x00, 0x2d, 0x00, 0x00, 0x0b
+};
+
+TEST_CASE(memory_fill_fills_the_whole_range)
+{
+    for (auto engine : engines) {
+        auto module = TestModule::create(memory_fill_module.span());
+        auto result = module->invoke(engine, "fill"sv, { i32_value(10), i32_value(0xab), i32_value(5) });
+        EXPECT(!result.is_trap());
+
+        EXPECT_EQ(module->invoke_i32(engine, "load"sv, { i32_value(9) }), 0);
+        for (i32 address = 10; address < 15; ++address)
+            EXPECT_EQ(module->invoke_i32(engine, "load"sv, { i32_value(address) }), 0xab);
+        EXPECT_EQ(module->invoke_i32(engine, "load"sv, { i32_value(15) }), 0);
+
+        // Filling past the end of the memory traps without writing anything.
+        result = module->invoke(engine, "fill"sv, { i32_value(65530), i32_value(0xcd), i32_value(10) });
+        EXPECT(result.is_trap());
+        EXPECT_EQ(module->invoke_i32(engine, "load"sv, { i32_value(65530) }), 0);
+    }
+}
+
+// (module
+//   (memory 1)
+//   (func (export "fib") (param $n i32) (result i32) (local $a i32) (local $b i32) (local $t i32)
+//     i32.const 1 local.set $b
+//     block loop
+//       local.get $n i32.eqz br_if 1
+//       local.get $a local.get $b i32.add local.set $t
+//       local.get $b local.set $a local.get $t local.set $b
+//       local.get $n i32.const 1 i32.sub local.set $n
+//       br 0
+//     end end
+//     local.get $a)
+//   (func (export "factorial") (param i32) (result i32)
+//     local.get 0 i32.const 2 i32.lt_s
+//     if (result i32) i32.const 1 else local.get 0 local.get 0 i32.const 1 i32.sub call 1 i32.mul end)
+//   (func (export "switch") (param i32) (result i32)
+//     block block block block local.get 0 br_table 0 1 2 3 end
+//     i32.const 100 return end i32.const 200 return end i32.const 300 return end i32.const 400)
+//   (func (export "div") (param i32 i32) (result i32) local.get 0 local.get 1 i32.div_s)
+//   (func (export "max") (param i32 i32) (result i32) local.get 0 local.get 1 local.get 0 local.get 1 i32.gt_s select)
+//   (func (export "mix64") (param i64 i64) (result i64) local.get 0 local.get 1 i64.mul local.get 0 i64.const 7 i64.rotl i64.xor)
+//   (func (export "odd_sum") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     block loop
+//       local.get $i local.get $n i32.ge_s br_if 1
+//       block local.get $i i32.const 1 i32.and i32.eqz br_if 0 local.get $sum local.get $i i32.add local.set $sum end
+//       local.get $i i32.const 1 i32.add local.set $i
+//       br 0
+//     end end
+//     local.get $sum)
+//   (func (export "trap_if") (param i32) (result i32) local.get 0 if unreachable end i32.const 5)
+//   (func (export "store_load") (param i32 i32) (result i32) local.get 0 local.get 1 i32.store local.get 0 i32.load)
+//   (func (export "clamp") (param i32) (result i32) (local i32)
+//     block (result i32) local.get 0 local.tee 1 local.get 1 i32.const 10 i32.gt_s br_if 0 drop i32.const -1 end))
+static constexpr Array<u8, 379> control_flow_module {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x12, 0x03, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7e, 0x7e, 0x01, 0x7e, 0x03, 0x0b, 0x0a, 0x00,
+    0x00, 0x00, 0x01, 0x01, 0x02, 0x00, 0x00, 0x01, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x59,
+    0x0a, 0x03, 0x66, 0x69, 0x62, 0x00, 0x00, 0x09, 0x66, 0x61, 0x63, 0x74, 0x6f, 0x72, 0x69, 0x61,
+    0x6c, 0x00, 0x01, 0x06, 0x73, 0x77, 0x69, 0x74, 0x63, 0x68, 0x00, 0x02, 0x03, 0x64, 0x69, 0x76,
+    0x00, 0x03, 0x03, 0x6d, 0x61, 0x78, 0x00, 0x04, 0x05, 0x6d, 0x69, 0x78, 0x36, 0x34, 0x00, 0x05,
+    0x07, 0x6f, 0x64, 0x64, 0x5f, 0x73, 0x75, 0x6d, 0x00, 0x06, 0x07, 0x74, 0x72, 0x61, 0x70, 0x5f,
+    0x69, 0x66, 0x00, 0x07, 0x0a, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x5f, 0x6c, 0x6f, 0x61, 0x64, 0x00,
+    0x08, 0x05, 0x63, 0x6c, 0x61, 0x6d, 0x70, 0x00, 0x09, 0x0a, 0xef, 0x01, 0x0a, 0x2d, 0x01, 0x03,
+    0x7f, 0x41, 0x01, 0x21, 0x02, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x45, 0x0d, 0x01, 0x20, 0x01,
+    0x20, 0x02, 0x6a, 0x21, 0x03, 0x20, 0x02, 0x21, 0x01, 0x20, 0x03, 0x21, 0x02, 0x20, 0x00, 0x41,
+    0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x0b, 0x17, 0x00, 0x20, 0x00, 0x41,
+    0x02, 0x48, 0x04, 0x7f, 0x41, 0x01, 0x05, 0x20, 0x00, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x01,
+    0x6c, 0x0b, 0x0b, 0x25, 0x00, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x0e,
+    0x03, 0x00, 0x01, 0x02, 0x03, 0x0b, 0x41, 0xe4, 0x00, 0x0f, 0x0b, 0x41, 0xc8, 0x01, 0x0f, 0x0b,
+    0x41, 0xac, 0x02, 0x0f, 0x0b, 0x41, 0x90, 0x03, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6d,
+    0x0b, 0x0c, 0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x00, 0x20, 0x01, 0x4a, 0x1b, 0x0b, 0x0d, 0x00,
+    0x20, 0x00, 0x20, 0x01, 0x7e, 0x20, 0x00, 0x42, 0x07, 0x89, 0x85, 0x0b, 0x2e, 0x01, 0x02, 0x7f,
+    0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4e, 0x0d, 0x01, 0x02, 0x40, 0x20, 0x01, 0x41,
+    0x01, 0x71, 0x45, 0x0d, 0x00, 0x20, 0x02, 0x20, 0x01, 0x6a, 0x21, 0x02, 0x0b, 0x20, 0x01, 0x41,
+    0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x0a, 0x00, 0x20, 0x00, 0x04,
+    0x40, 0x00, 0x0b, 0x41, 0x05, 0x0b, 0x0e, 0x00, 0x20, 0x00, 0x20, 0x01, 0x36, 0x02, 0x00, 0x20,
+    0x00, 0x28, 0x02, 0x00, 0x0b, 0x15, 0x01, 0x01, 0x7f, 0x02, 0x7f, 0x20, 0x00, 0x22, 0x01, 0x20,
+    0x01, 0x41, 0x0a, 0x4a, 0x0d, 0x00, 0x1a, 0x41, 0x7f, 0x0b, 0x0b
+};
+
+static constexpr Array control_flow_functions {
+    "fib"sv, "factorial"sv, "switch"sv, "div"sv, "max"sv, "mix64"sv, "odd_sum"sv, "trap_if"sv, "store_load"sv, "clamp"sv
+};
+
+TEST_CASE(register_functions_are_translated)
+{
+    auto module = TestModule::create(control_flow_module.span());
+    for (auto name : control_flow_functions)
+        EXPECT(module->is_translated(name));
+}
+
+TEST_CASE(register_functions_match_the_stack_interpreter)
+{
+    static constexpr Array<i32, 12> inputs { 0, 1, 2, 3, 5, 10, 11, 12, -1, -7, NumericLimits<i32>::min(), NumericLimits<i32>::max() };
+
+    auto module = TestModule::create(control_flow_module.span());
+    auto compare = [&](StringView name, Vector<Wasm::Value> arguments) {
+        auto expected = module->invoke_integer(Engine::Stack, name, arguments);
+        auto actual = module->invoke_integer(Engine::Register, name, move(arguments));
+        EXPECT_EQ(actual, expected);
+    };
+
+    for (auto input : inputs) {
+        // Keep the loops and the recursion short, fib() counts down to zero.
+        auto small_input = clamp(input, -5, 40);
+        compare("fib"sv, { i32_value(max(small_input, 0)) });
+        compare("factorial"sv, { i32_value(small_input) });
+        compare("odd_sum"sv, { i32_value(small_input) });
+        compare("switch"sv, { i32_value(input) });
+        compare("trap_if"sv, { i32_value(input) });
+        compare("clamp"sv, { i32_value(input) });
+
+        for (auto other_input : inputs) {
+            compare("div"sv, { i32_value(input), i32_value(other_input) });
+            compare("max"sv, { i32_value(input), i32_value(other_input) });
+            compare("store_load"sv, { i32_value(input), i32_value(other_input) });
+            compare("mix64"sv, { Wasm::Value { static_cast<i64>(input) << 20 }, Wasm::Value { static_cast<i64>(other_input) } });
+        }
+    }
+}
+
+TEST_CASE(register_functions_compute_known_results)
+{
+    auto module = TestModule::create(control_flow_module.span());
+    for (auto engine : engines) {
+        EXPECT_EQ(module->invoke_integer(engine, "fib"sv, { i32_value(10) }), 55);
+        EXPECT_EQ(module->invoke_integer(engine, "factorial"sv, { i32_value(10) }), 3628800);
+        EXPECT_EQ(module->invoke_integer(engine, "odd_sum"sv, { i32_value(10) }), 25);
+
+        EXPECT_EQ(module->invoke_integer(engine, "switch"sv, { i32_value(0) }), 100);
+        EXPECT_EQ(module->invoke_integer(engine, "switch"sv, { i32_value(2) }), 300);
+        EXPECT_EQ(module->invoke_integer(engine, "switch"sv, { i32_value(3) }), 400);
+        EXPECT_EQ(module->invoke_integer(engine, "switch"sv, { i32_value(-1) }), 400);
+
+        EXPECT_EQ(module->invoke_integer(engine, "div"sv, { i32_value(-7), i32_value(2) }), -3);
+        EXPECT_EQ(module->invoke_integer(engine, "div"sv, { i32_value(1), i32_value(0) }), Optional<i64> {});
+        EXPECT_EQ(module->invoke_integer(engine, "div"sv, { i32_value(NumericLimits<i32>::min()), i32_value(-1) }), Optional<i64> {});
+
+        EXPECT_EQ(module->invoke_integer(engine, "max"sv, { i32_value(-3), i32_value(2) }), 2);
+        EXPECT_EQ(module->invoke_integer(engine, "clamp"sv, { i32_value(11) }), 11);
+        EXPECT_EQ(module->invoke_integer(engine, "clamp"sv, { i32_value(10) }), -1);
+        EXPECT_EQ(module->invoke_integer(engine, "trap_if"sv, { i32_value(0) }), 5);
+        EXPECT_EQ(module->invoke_integer(engine, "trap_if"sv, { i32_value(1) }), Optional<i64> {});
+
+        EXPECT_EQ(module->invoke_integer(engine, "store_load"sv, { i32_value(65532), i32_value(42) }), 42);
+        EXPECT_EQ(module->invoke_integer(engine, "store_load"sv, { i32_value(65533), i32_value(42) }), Optional<i64> {});
+    }
+}
+
+TEST_CASE(jit_matches_the_stack_interpreter)
+{
+    static constexpr Array<i32, 8> inputs { 0, 1, 3, 10, 11, -1, NumericLimits<i32>::min(), NumericLimits<i32>::max() };
+
+    auto stack_module = TestModule::create(control_flow_module.span());
+    auto jit_module = TestModule::create(control_flow_module.span());
+    auto compare = [&](StringView name, Vector<Wasm::Value> arguments) {
+        auto expected = stack_module->invoke_integer(Engine::Stack, name, arguments);
+        auto actual = jit_module->invoke_integer(Engine::JIT, name, move(arguments));
+        EXPECT_EQ(actual, expected);
+    };
+
+    // Warm everything up, including the paths that trap, so that the comparisons below run native code.
+    for (u32 i = 0; i < Wasm::JIT::Compiler::hotness_threshold; ++i) {
+        for (auto name : control_flow_functions) {
+            auto is_binary = name.is_one_of("div"sv, "max"sv, "store_load"sv, "mix64"sv);
+            auto argument = name == "mix64"sv ? Wasm::Value { static_cast<i64>(i) } : i32_value(i);
+            (void)jit_module->invoke(Engine::JIT, name, is_binary ? Vector { argument, argument } : Vector { argument });
+        }
+    }
+
+#ifdef JIT_ARCH_SUPPORTED
+    for (auto name : control_flow_functions)
+        EXPECT(jit_module->is_compiled(name));
+#endif
+
+    for (auto input : inputs) {
+        auto small_input = clamp(input, -5, 40);
+        compare("fib"sv, { i32_value(max(small_input, 0)) });
+        compare("factorial"sv, { i32_value(small_input) });
+        compare("odd_sum"sv, { i32_value(small_input) });
+        compare("switch"sv, { i32_value(input) });
+        compare("trap_if"sv, { i32_value(input) });
+        compare("clamp"sv, { i32_value(input) });
+
+        for (auto other_input : inputs) {
+            compare("div"sv, { i32_value(input), i32_value(other_input) });
+            compare("max"sv, { i32_value(input), i32_value(other_input) });
+            compare("store_load"sv, { i32_value(input), i32_value(other_input) });
+            compare("mix64"sv, { Wasm::Value { static_cast<i64>(input) << 20 }, Wasm::Value { static_cast<i64>(other_input) } });
+        }
+    }
+}
+
+TEST_CASE(jit_is_only_used_once_hot)
+{
+    auto module = TestModule::create(control_flow_module.span());
+
+    // Functions without loops wait for the threshold.
+    for (u32 i = 1; i < Wasm::JIT::Compiler::hotness_threshold; ++i) {
+        EXPECT_EQ(module->invoke_integer(Engine::JIT, "max"sv, { i32_value(i), i32_value(2) }), max<i32>(i, 2));
+        EXPECT(!module->is_compiled("max"sv));
+    }
+
+    // Functions with a loop are compiled right away.
+    EXPECT_EQ(module->invoke_integer(Engine::JIT, "fib"sv, { i32_value(10) }), 55);
+#ifdef JIT_ARCH_SUPPORTED
+    EXPECT(module->is_compiled("fib"sv));
+    EXPECT_EQ(module->invoke_integer(Engine::JIT, "max"sv, { i32_value(-1), i32_value(2) }), 2);
+    EXPECT(module->is_compiled("max"sv));
+#endif
+
+    // Without the JIT, nothing gets compiled no matter how often it runs.
+    auto other_module = TestModule::create(control_flow_module.span());
+    for (u32 i = 0; i < Wasm::JIT::Compiler::hotness_threshold * 2; ++i)
+        EXPECT_EQ(other_module->invoke_integer(Engine::Register, "fib"sv, { i32_value(10) }), 55);
+    EXPECT(!other_module->is_compiled("fib"sv));
+}
+
+// (module
+//   (func $switch (export "switch") (param i32) (result i32)
+//     block block block block block block block block block
+//     local.get 0 br_table 0 1 2 3 4 5 6 7 8
+//     end i32.const 1 return end i32.const 11 return ... end i32.const 71 return
+//     end i32.const -1)
+//   (func (export "switch_sum") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     block loop
+//       local.get $i local.get $n i32.ge_s br_if 1
+//       local.get $sum local.get $i i32.const 11 i32.rem_u call $switch i32.add local.set $sum
+//       local.get $i i32.const 1 i32.add local.set $i
+//       br 0
+//     end end
+//     local.get $sum))
+static constexpr Array<u8, 160> branch_table_module {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x17, 0x02, 0x06, 0x73, 0x77, 0x69, 0x74, 0x63, 0x68, 0x00,
+    0x00, 0x0a, 0x73, 0x77, 0x69, 0x74, 0x63, 0x68, 0x5f, 0x73, 0x75, 0x6d, 0x00, 0x01, 0x0a, 0x70,
+    0x02, 0x45, 0x00, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02,
+    0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x0e, 0x08, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x0b, 0x41, 0x01, 0x0f, 0x0b, 0x41, 0x0b, 0x0f, 0x0b, 0x41, 0x15, 0x0f, 0x0b, 0x41,
+    0x1f, 0x0f, 0x0b, 0x41, 0x29, 0x0f, 0x0b, 0x41, 0x33, 0x0f, 0x0b, 0x41, 0x3d, 0x0f, 0x0b, 0x41,
+    0xc7, 0x00, 0x0f, 0x0b, 0x41, 0x7f, 0x0b, 0x28, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20,
+    0x01, 0x20, 0x00, 0x4e, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01, 0x41, 0x0b, 0x70, 0x10, 0x00, 0x6a,
+    0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b
+};
+
+TEST_CASE(jit_branch_table)
+{
+    for (auto engine : { Engine::Stack, Engine::Register, Engine::JIT }) {
+        auto module = TestModule::create(branch_table_module.span());
+
+        // The loop gets "switch" past the hotness threshold, so the JIT runs its jump table from then on.
+        EXPECT_EQ(module->invoke_integer(engine, "switch_sum"sv, { i32_value(22) }), 570);
+
+        for (i32 i = 0; i < 8; ++i)
+            EXPECT_EQ(module->invoke_integer(engine, "switch"sv, { i32_value(i) }), i * 10 + 1);
+        for (auto input : { 8, 9, 1000, -1, NumericLimits<i32>::min() })
+            EXPECT_EQ(module->invoke_integer(engine, "switch"sv, { i32_value(input) }), -1);
+
+#ifdef JIT_ARCH_SUPPORTED
+        if (engine == Engine::JIT)
+            EXPECT(module->is_compiled("switch"sv));
+#endif
+    }
+}
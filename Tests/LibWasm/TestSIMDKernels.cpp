@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <AK/StackInfo.h>
+#include <LibTest/TestCase.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/Types.h>
+
+// Compiled from the following module; every kernel has a scalar and a v128 version that must agree.
+//
+// (module
+//   (memory 1)
+//   (func (export "fill") (param $n i32) (local $i i32)
+//     ;; i32 data[i] = i * 7 at 0, f32 x[i] = i & 7 at 16384, f32 y[i] = (i >> 3) & 7 at 32768
+//     ...)
+//   (func (export "sum_scalar") (param $n i32) (result i32) (local $i i32) (local $sum i32)
+//     ;; for (i = 0; i < n * 4; i += 4) sum += i32.load(i)
+//     ...)
+//   (func (export "sum_vector") (param $n i32) (result i32) (local $i i32) (local $sum v128)
+//     ;; for (i = 0; i < n * 4; i += 16) sum = i32x4.add(sum, v128.load(i)), then add up the lanes
+//     ...)
+//   (func (export "dot_scalar") (param $n i32) (result f32) (local $i i32) (local $sum f32)
+//     ;; for (i = 0; i < n * 4; i += 4) sum += f32.load offset=16384 (i) * f32.load offset=32768 (i)
+//     ...)
+//   (func (export "dot_vector") (param $n i32) (result f32) (local $i i32) (local $sum v128)
+//     ;; for (i = 0; i < n * 4; i += 16) sum = f32x4.add(sum, f32x4.mul(v128.load offset=16384 (i), v128.load offset=32768 (i)))
+//     ...))
+static constexpr u8 kernels_module[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0f, 0x03, 0x60, 0x01, 0x7f, 0x00, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7d, 0x03, 0x06, 0x05, 0x00, 0x01, 0x01, 0x02,
+    0x02, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x3c, 0x05, 0x04, 0x66, 0x69, 0x6c, 0x6c, 0x00, 0x00,
+    0x0a, 0x73, 0x75, 0x6d, 0x5f, 0x73, 0x63, 0x61, 0x6c, 0x61, 0x72, 0x00, 0x01, 0x0a, 0x73, 0x75,
+    0x6d, 0x5f, 0x76, 0x65, 0x63, 0x74, 0x6f, 0x72, 0x00, 0x02, 0x0a, 0x64, 0x6f, 0x74, 0x5f, 0x73,
+    0x63, 0x61, 0x6c, 0x61, 0x72, 0x00, 0x03, 0x0a, 0x64, 0x6f, 0x74, 0x5f, 0x76, 0x65, 0x63, 0x74,
+    0x6f, 0x72, 0x00, 0x04, 0x0a, 0xd7, 0x02, 0x05, 0x4e, 0x01, 0x01, 0x7f, 0x41, 0x00, 0x21, 0x01,
+    0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20, 0x01, 0x41, 0x02, 0x74,
+    0x20, 0x01, 0x41, 0x07, 0x6c, 0x36, 0x02, 0x00, 0x20, 0x01, 0x41, 0x02, 0x74, 0x20, 0x01, 0x41,
+    0x07, 0x71, 0xb3, 0x38, 0x02, 0x80, 0x80, 0x01, 0x20, 0x01, 0x41, 0x02, 0x74, 0x20, 0x01, 0x41,
+    0x03, 0x76, 0x41, 0x07, 0x71, 0xb3, 0x38, 0x02, 0x80, 0x80, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a,
+    0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x0b, 0x2f, 0x02, 0x01, 0x7f, 0x01, 0x7f, 0x41, 0x00, 0x21,
+    0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x41, 0x02, 0x74, 0x4f, 0x0d, 0x01, 0x20,
+    0x02, 0x20, 0x01, 0x28, 0x02, 0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x04, 0x6a, 0x21, 0x01,
+    0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x47, 0x02, 0x01, 0x7f, 0x01, 0x7b, 0x41, 0x00, 0x21,
+    0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x41, 0x02, 0x74, 0x4f, 0x0d, 0x01, 0x20,
+    0x02, 0x20, 0x01, 0xfd, 0x00, 0x04, 0x00, 0xfd, 0xae, 0x01, 0x21, 0x02, 0x20, 0x01, 0x41, 0x10,
+    0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0xfd, 0x1b, 0x00, 0x20, 0x02, 0xfd, 0x1b,
+    0x01, 0x6a, 0x20, 0x02, 0xfd, 0x1b, 0x02, 0x6a, 0x20, 0x02, 0xfd, 0x1b, 0x03, 0x6a, 0x0b, 0x39,
+    0x02, 0x01, 0x7f, 0x01, 0x7d, 0x41, 0x00, 0x21, 0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20,
+    0x00, 0x41, 0x02, 0x74, 0x4f, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01, 0x2a, 0x02, 0x80, 0x80, 0x01,
+    0x20, 0x01, 0x2a, 0x02, 0x80, 0x80, 0x02, 0x94, 0x92, 0x21, 0x02, 0x20, 0x01, 0x41, 0x04, 0x6a,
+    0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x54, 0x02, 0x01, 0x7f, 0x01, 0x7b, 0x41,
+    0x00, 0x21, 0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x41, 0x02, 0x74, 0x4f, 0x0d,
+    0x01, 0x20, 0x02, 0x20, 0x01, 0xfd, 0x00, 0x04, 0x80, 0x80, 0x01, 0x20, 0x01, 0xfd, 0x00, 0x04,
+    0x80, 0x80, 0x02, 0xfd, 0xe6, 0x01, 0xfd, 0xe4, 0x01, 0x21, 0x02, 0x20, 0x01, 0x41, 0x10, 0x6a,
+    0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0xfd, 0x1f, 0x00, 0x20, 0x02, 0xfd, 0x1f, 0x01,
+    0x92, 0x20, 0x02, 0xfd, 0x1f, 0x02, 0x92, 0x20, 0x02, 0xfd, 0x1f, 0x03, 0x92, 0x0b,
+};
+
+static constexpr i32 element_count = 4096;
+
+class KernelRunner {
+public:
+    KernelRunner()
+        : m_module(parse_module())
+    {
+        MUST(m_machine.validate(m_module));
+        m_instance = MUST(m_machine.instantiate(m_module, {}));
+        invoke("fill"sv);
+    }
+
+    Wasm::Value invoke(StringView name)
+    {
+        Optional<Wasm::FunctionAddress> address;
+        for (auto& entry : m_instance->exports()) {
+            if (entry.name() == name)
+                address = entry.value().get<Wasm::FunctionAddress>();
+        }
+        VERIFY(address.has_value());
+
+        Wasm::BytecodeInterpreter interpreter { m_stack_info };
+        auto result = m_machine.invoke(interpreter, *address, { Wasm::Value { element_count } }).assert_wasm_result();
+        VERIFY(!result.is_trap());
+        return result.values().is_empty() ? Wasm::Value {} : result.values().first();
+    }
+
+private:
+    static Wasm::Module parse_module()
+    {
+        FixedMemoryStream stream { ReadonlyBytes { kernels_module, sizeof(kernels_module) } };
+        return MUST(Wasm::Module::parse(stream));
+    }
+
+    StackInfo m_stack_info;
+    Wasm::AbstractMachine m_machine;
+    Wasm::Module m_module;
+    OwnPtr<Wasm::ModuleInstance> m_instance;
+};
+
+static i32 expected_sum()
+{
+    u32 sum = 0;
+    for (i32 i = 0; i < element_count; ++i)
+        sum += static_cast<u32>(i) * 7;
+    return static_cast<i32>(sum);
+}
+
+static float expected_dot()
+{
+    // Every partial sum is a small integer, so the result is exact regardless of summation order.
+    float sum = 0;
+    for (i32 i = 0; i < element_count; ++i)
+        sum += static_cast<float>(i & 7) * static_cast<float>((i >> 3) & 7);
+    return sum;
+}
+
+TEST_CASE(vector_kernels_match_scalar_kernels)
+{
+    KernelRunner runner;
+    EXPECT_EQ(runner.invoke("sum_scalar"sv).to<i32>(), expected_sum());
+    EXPECT_EQ(runner.invoke("sum_vector"sv).to<i32>(), expected_sum());
+    EXPECT_EQ(runner.invoke("dot_scalar"sv).to<float>(), expected_dot());
+    EXPECT_EQ(runner.invoke("dot_vector"sv).to<float>(), expected_dot());
+}
+
+static void run_kernel(StringView name)
+{
+    KernelRunner runner;
+    for (size_t i = 0; i < 1000; ++i)
+        (void)runner.invoke(name);
+}
+
+BENCHMARK_CASE(i32_sum_scalar)
+{
+    run_kernel("sum_scalar"sv);
+}
+
+BENCHMARK_CASE(i32_sum_vector)
+{
+    run_kernel("sum_vector"sv);
+}
+
+BENCHMARK_CASE(f32_dot_scalar)
+{
+    run_kernel("dot_scalar"sv);
+}
+
+BENCHMARK_CASE(f32_dot_vector)
+{
+    run_kernel("dot_vector"sv);
+}
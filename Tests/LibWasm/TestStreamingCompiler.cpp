@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/MemoryStream.h>
+#include <LibTest/TestCase.h>
+#include <LibWasm/AbstractMachine/ParallelValidator.h>
+#include <LibWasm/AbstractMachine/StreamingCompiler.h>
+
+// (module
+//   (memory 1)
+//   (func (export "inc") (param i32) (result i32) local.get 0 i32.const 1 i32.add)
+//   (func (export "add2") (param i32) (result i32) local.get 0 call 0 call 0))
+static constexpr Array<u8, 62> valid_module {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x03, 0x03, 0x02, 0x00, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x0e, 0x02, 0x03, 0x69, 0x6e,
+    0x63, 0x00, 0x00, 0x04, 0x61, 0x64, 0x64, 0x32, 0x00, 0x01, 0x0a, 0x12, 0x02, 0x07, 0x00, 0x20,
+    0x00, 0x41, 0x01, 0x6a, 0x0b, 0x08, 0x00, 0x20, 0x00, 0x10, 0x00, 0x10, 0x00, 0x0b
+};
+
+// The same module, except that "add2" is now `local.get 0 i64.const 1`, which leaves an i64 on the stack.
+static constexpr Array<u8, 60> invalid_module {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x03, 0x03, 0x02, 0x00, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x0e, 0x02, 0x03, 0x69, 0x6e,
+    0x63, 0x00, 0x00, 0x04, 0x61, 0x64, 0x64, 0x32, 0x00, 0x01, 0x0a, 0x10, 0x02, 0x07, 0x00, 0x20,
+    0x00, 0x41, 0x01, 0x6a, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x42, 0x01, 0x0b
+};
+
+static ErrorOr<Wasm::Module, Wasm::CompileError> compile_in_chunks(ReadonlyBytes bytes, size_t chunk_size)
+{
+    Wasm::StreamingCompiler compiler;
+    for (size_t offset = 0; offset < bytes.size(); offset += chunk_size)
+        TRY(compiler.append(bytes.slice(offset, min(chunk_size, bytes.size() - offset))));
+    return compiler.finish();
+}
+
+TEST_CASE(compile_valid_module_in_chunks)
+{
+    for (size_t chunk_size : { 1, 3, 7, 64 }) {
+        auto module = compile_in_chunks(valid_module.span(), chunk_size);
+        EXPECT(!module.is_error());
+        if (module.is_error())
+            continue;
+
+        EXPECT_EQ(module.value().validation_status(), Wasm::Module::ValidationStatus::Valid);
+        module.value().for_each_section_of_type<Wasm::CodeSection>([](auto& section) {
+            EXPECT_EQ(section.functions().size(), 2u);
+        });
+    }
+}
+
+TEST_CASE(reject_invalid_function_body)
+{
+    for (size_t chunk_size : { 1, 5, 64 }) {
+        auto module = compile_in_chunks(invalid_module.span(), chunk_size);
+        EXPECT(module.is_error());
+        if (module.is_error())
+            EXPECT(module.error().has<Wasm::ValidationError>());
+    }
+}
+
+TEST_CASE(reject_truncated_module)
+{
+    for (size_t length : { 4, 9, 20, 50, 61 }) {
+        Wasm::StreamingCompiler compiler;
+        EXPECT(!compiler.append(valid_module.span().trim(length)).is_error());
+        auto module = compiler.finish();
+        EXPECT(module.is_error());
+        if (module.is_error())
+            EXPECT(module.error().has<Wasm::ParseError>());
+    }
+}
+
+static void append_leb128(ByteBuffer& buffer, size_t value)
+{
+    do {
+        u8 byte = value & 0x7f;
+        value >>= 7;
+        if (value != 0)
+            byte |= 0x80;
+        buffer.append(byte);
+    } while (value != 0);
+}
+
+static void append_section(ByteBuffer& module, u8 id, ByteBuffer const& contents)
+{
+    module.append(id);
+    append_leb128(module, contents.size());
+    module.append(contents);
+}
+
+// A module with function_count functions of type [] -> [], each of which is a long run of nops. The function at
+// invalid_function_index (if any) also contains `i32.const 0 i64.eqz drop`, which passes an i32 to an i64 operator.
+static ByteBuffer make_module_with_large_code_section(size_t function_count, size_t nops_per_function, Optional<size_t> invalid_function_index)
+{
+    auto module = MUST(ByteBuffer::copy(Array<u8, 8> { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 }.span()));
+
+    append_section(module, 1, MUST(ByteBuffer::copy(Array<u8, 4> { 0x01, 0x60, 0x00, 0x00 }.span())));
+
+    ByteBuffer functions;
+    append_leb128(functions, function_count);
+    for (size_t i = 0; i < function_count; ++i)
+        functions.append(0x00);
+    append_section(module, 3, functions);
+
+    ByteBuffer code;
+    append_leb128(code, function_count);
+    for (size_t i = 0; i < function_count; ++i) {
+        ByteBuffer body;
+        body.append(0x00);
+        for (size_t j = 0; j < nops_per_function; ++j)
+            body.append(0x01);
+        if (i == invalid_function_index)
+            body.append(Array<u8, 4> { 0x41, 0x00, 0x50, 0x1a }.data(), 4);
+        body.append(0x0b);
+
+        append_leb128(code, body.size());
+        code.append(body);
+    }
+    append_section(module, 10, code);
+
+    return module;
+}
+
+static constexpr size_t large_module_function_count = 300;
+static constexpr size_t large_module_nops_per_function = 1000;
+static_assert(large_module_function_count * large_module_nops_per_function > Wasm::ParallelFunctionValidator::minimum_parallel_code_size);
+
+TEST_CASE(compile_large_module_in_chunks)
+{
+    auto valid = make_module_with_large_code_section(large_module_function_count, large_module_nops_per_function, {});
+    auto invalid = make_module_with_large_code_section(large_module_function_count, large_module_nops_per_function, large_module_function_count - 10);
+
+    for (size_t chunk_size : { 4096, 65536 }) {
+        auto module = compile_in_chunks(valid, chunk_size);
+        EXPECT(!module.is_error());
+
+        module = compile_in_chunks(invalid, chunk_size);
+        EXPECT(module.is_error());
+        if (module.is_error())
+            EXPECT(module.error().has<Wasm::ValidationError>());
+    }
+}
+
+static ErrorOr<void, Wasm::ValidationError> validate_in_parallel(ByteBuffer const& bytes, size_t thread_count)
+{
+    FixedMemoryStream stream { bytes.bytes() };
+    auto module = MUST(Wasm::Module::parse(stream));
+
+    Wasm::Validator validator;
+    TRY(validator.populate_context(module));
+
+    // Validating the functions in the order they appear, so that a later invalid one has to wait for all the
+    // valid ones before it to be taken out of the queue.
+    Wasm::ParallelFunctionValidator parallel_validator { validator, thread_count };
+    module.for_each_section_of_type<Wasm::CodeSection>([&](Wasm::CodeSection const& section) {
+        for (size_t i = 0; i < section.functions().size(); ++i)
+            parallel_validator.enqueue(i, section.functions()[i]);
+    });
+    return parallel_validator.finish();
+}
+
+TEST_CASE(validate_large_module_in_parallel)
+{
+    auto valid = make_module_with_large_code_section(large_module_function_count, large_module_nops_per_function, {});
+    auto invalid = make_module_with_large_code_section(large_module_function_count, large_module_nops_per_function, large_module_function_count - 10);
+    auto invalid_early = make_module_with_large_code_section(large_module_function_count, large_module_nops_per_function, 3);
+
+    for (size_t thread_count : { 1, 2, 4 }) {
+        EXPECT(!validate_in_parallel(valid, thread_count).is_error());
+        EXPECT(validate_in_parallel(invalid, thread_count).is_error());
+        EXPECT(validate_in_parallel(invalid_early, thread_count).is_error());
+    }
+}
@@ -5,8 +5,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BitStream.h>
+#include <AK/MemoryStream.h>
 #include <LibArchive/Zip.h>
 #include <LibCompress/Deflate.h>
+#include <LibCompress/Zstd.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
 namespace Archive {
@@ -28,6 +31,54 @@ bool Zip::find_end_of_central_directory_offset(ReadonlyBytes buffer, size_t& off
     return false;
 }
 
+struct MemberLocation {
+    u64 uncompressed_size;
+    u64 compressed_size;
+    u64 local_file_header_offset;
+};
+
+// Takes the values that didn't fit into the 32-bit fields of the central directory record from its Zip64 extended information extra field.
+static Optional<MemberLocation> read_member_location(CentralDirectoryRecord const& central_directory_record)
+{
+    MemberLocation location {
+        .uncompressed_size = central_directory_record.uncompressed_size,
+        .compressed_size = central_directory_record.compressed_size,
+        .local_file_header_offset = central_directory_record.local_file_header_offset,
+    };
+
+    // Only the values whose regular fields are set to 0xFFFFFFFF are stored in the extra field, in the order of those fields.
+    Vector<u64*, 3> zip64_values;
+    if (central_directory_record.uncompressed_size == 0xFFFFFFFF)
+        zip64_values.append(&location.uncompressed_size);
+    if (central_directory_record.compressed_size == 0xFFFFFFFF)
+        zip64_values.append(&location.compressed_size);
+    if (central_directory_record.local_file_header_offset == 0xFFFFFFFF)
+        zip64_values.append(&location.local_file_header_offset);
+    if (zip64_values.is_empty())
+        return location;
+
+    ReadonlyBytes extra_data { central_directory_record.extra_data, central_directory_record.extra_data_length };
+    while (extra_data.size() >= 2 * sizeof(u16)) {
+        u16 tag;
+        u16 size;
+        memcpy(&tag, extra_data.data(), sizeof(tag));
+        memcpy(&size, extra_data.data() + sizeof(tag), sizeof(size));
+        extra_data = extra_data.slice(2 * sizeof(u16));
+        if (size > extra_data.size())
+            return {};
+
+        if (tag == zip64_extended_information_extra_field_tag) {
+            if (size < zip64_values.size() * sizeof(u64))
+                return {};
+            for (size_t i = 0; i < zip64_values.size(); ++i)
+                memcpy(zip64_values[i], extra_data.data() + i * sizeof(u64), sizeof(u64));
+            return location;
+        }
+        extra_data = extra_data.slice(size);
+    }
+    return {};
+}
+
 Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
 {
     size_t end_of_central_directory_offset;
@@ -41,8 +92,32 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
     if (end_of_central_directory.disk_number != 0 || end_of_central_directory.central_directory_start_disk != 0 || end_of_central_directory.disk_records_count != end_of_central_directory.total_records_count)
         return {}; // TODO: support multi-volume zip archives
 
-    size_t member_offset = end_of_central_directory.central_directory_offset;
-    for (size_t i = 0; i < end_of_central_directory.total_records_count; i++) {
+    u64 member_count = end_of_central_directory.total_records_count;
+    u64 central_directory_offset = end_of_central_directory.central_directory_offset;
+
+    // Archives with too many members or that are too large have a Zip64 end of central directory record with the actual values,
+    // which is found through the locator right in front of the regular end of central directory record.
+    if (end_of_central_directory_offset >= Zip64EndOfCentralDirectoryLocator::size()) {
+        Zip64EndOfCentralDirectoryLocator zip64_end_of_central_directory_locator {};
+        if (zip64_end_of_central_directory_locator.read(buffer.slice(end_of_central_directory_offset - Zip64EndOfCentralDirectoryLocator::size()))) {
+            if (zip64_end_of_central_directory_locator.central_directory_start_disk != 0 || zip64_end_of_central_directory_locator.total_disks > 1)
+                return {}; // TODO: support multi-volume zip archives
+            if (zip64_end_of_central_directory_locator.end_of_central_directory_offset > buffer.size())
+                return {};
+
+            Zip64EndOfCentralDirectory zip64_end_of_central_directory {};
+            if (!zip64_end_of_central_directory.read(buffer.slice(zip64_end_of_central_directory_locator.end_of_central_directory_offset)))
+                return {};
+            if (zip64_end_of_central_directory.disk_number != 0 || zip64_end_of_central_directory.central_directory_start_disk != 0 || zip64_end_of_central_directory.disk_records_count != zip64_end_of_central_directory.total_records_count)
+                return {}; // TODO: support multi-volume zip archives
+
+            member_count = zip64_end_of_central_directory.total_records_count;
+            central_directory_offset = zip64_end_of_central_directory.central_directory_offset;
+        }
+    }
+
+    u64 member_offset = central_directory_offset;
+    for (u64 i = 0; i < member_count; i++) {
         CentralDirectoryRecord central_directory_record {};
         if (member_offset > buffer.size())
             return {};
@@ -50,47 +125,58 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
             return {};
         if (central_directory_record.general_purpose_flags.encrypted)
             return {}; // TODO: support encrypted zip members
-        if (central_directory_record.general_purpose_flags.data_descriptor)
-            return {}; // TODO: support zip data descriptors
-        if (central_directory_record.compression_method != ZipCompressionMethod::Store && central_directory_record.compression_method != ZipCompressionMethod::Deflate)
+        if (central_directory_record.compression_method != ZipCompressionMethod::Store && central_directory_record.compression_method != ZipCompressionMethod::Deflate && central_directory_record.compression_method != ZipCompressionMethod::Zstd)
             return {}; // TODO: support obsolete zip compression methods
-        if (central_directory_record.compression_method == ZipCompressionMethod::Store && central_directory_record.uncompressed_size != central_directory_record.compressed_size)
-            return {};
         if (central_directory_record.start_disk != 0)
             return {}; // TODO: support multi-volume zip archives
         if (memchr(central_directory_record.name, 0, central_directory_record.name_length) != nullptr)
             return {};
+        auto location = read_member_location(central_directory_record);
+        if (!location.has_value())
+            return {};
+        if (central_directory_record.compression_method == ZipCompressionMethod::Store && location->uncompressed_size != location->compressed_size)
+            return {};
         LocalFileHeader local_file_header {};
-        if (central_directory_record.local_file_header_offset > buffer.size())
+        if (location->local_file_header_offset > buffer.size())
             return {};
-        if (!local_file_header.read(buffer.slice(central_directory_record.local_file_header_offset)))
+        if (!local_file_header.read(buffer.slice(location->local_file_header_offset)))
             return {};
-        if (buffer.size() - (local_file_header.compressed_data - buffer.data()) < central_directory_record.compressed_size)
+        if (buffer.size() - (local_file_header.compressed_data - buffer.data()) < location->compressed_size)
             return {};
         member_offset += central_directory_record.size();
     }
 
     return Zip {
-        end_of_central_directory.total_records_count,
-        end_of_central_directory.central_directory_offset,
+        member_count,
+        central_directory_offset,
         buffer,
     };
 }
 
+Optional<Zip> Zip::try_create(NonnullOwnPtr<Core::MappedFile> mapped_file)
+{
+    auto zip = try_create(mapped_file->bytes());
+    if (!zip.has_value())
+        return {};
+    zip->m_mapped_file = make_ref_counted<Core::SharedMappedFile>(move(mapped_file));
+    return zip;
+}
+
 ErrorOr<bool> Zip::for_each_member(Function<ErrorOr<IterationDecision>(ZipMember const&)> callback) const
 {
     size_t member_offset = m_members_start_offset;
-    for (size_t i = 0; i < m_member_count; i++) {
+    for (u64 i = 0; i < m_member_count; i++) {
         CentralDirectoryRecord central_directory_record {};
         VERIFY(central_directory_record.read(m_input_data.slice(member_offset)));
+        auto location = read_member_location(central_directory_record).release_value();
         LocalFileHeader local_file_header {};
-        VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
+        VERIFY(local_file_header.read(m_input_data.slice(location.local_file_header_offset)));
 
         ZipMember member;
         member.name = TRY(String::from_utf8({ central_directory_record.name, central_directory_record.name_length }));
-        member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
+        member.compressed_data = { local_file_header.compressed_data, location.compressed_size };
         member.compression_method = central_directory_record.compression_method;
-        member.uncompressed_size = central_directory_record.uncompressed_size;
+        member.uncompressed_size = location.uncompressed_size;
         member.crc32 = central_directory_record.crc32;
         member.modification_time = central_directory_record.modification_time;
         member.modification_date = central_directory_record.modification_date;
@@ -104,6 +190,17 @@ ErrorOr<bool> Zip::for_each_member(Function<ErrorOr<IterationDecision>(ZipMember
     return true;
 }
 
+ErrorOr<Vector<ZipMemberReader>> Zip::member_readers() const
+{
+    Vector<ZipMemberReader> readers;
+    TRY(readers.try_ensure_capacity(m_member_count));
+    TRY(for_each_member([&](ZipMember const& member) -> ErrorOr<IterationDecision> {
+        readers.unchecked_append(ZipMemberReader { m_mapped_file, member });
+        return IterationDecision::Continue;
+    }));
+    return readers;
+}
+
 ErrorOr<Statistics> Zip::calculate_statistics() const
 {
     size_t file_count = 0;
@@ -122,78 +219,230 @@ ErrorOr<Statistics> Zip::calculate_statistics() const
     return Statistics(file_count, directory_count, uncompressed_bytes);
 }
 
+ErrorOr<void> ZipMemberReader::decompress_into(Stream& output) const
+{
+    Crypto::Checksum::CRC32 checksum;
+    u64 uncompressed_size = 0;
+    auto write_uncompressed_data = [&](ReadonlyBytes data) -> ErrorOr<void> {
+        uncompressed_size += data.size();
+        if (uncompressed_size > m_member.uncompressed_size)
+            return Error::from_string_literal("Zip member is larger than its recorded size");
+        checksum.update(data);
+        return output.write_until_depleted(data);
+    };
+
+    switch (m_member.compression_method) {
+    case ZipCompressionMethod::Store:
+        TRY(write_uncompressed_data(m_member.compressed_data));
+        break;
+    case ZipCompressionMethod::Deflate:
+    case ZipCompressionMethod::Zstd: {
+        FixedMemoryStream compressed_stream { m_member.compressed_data };
+        OwnPtr<Stream> decompressor;
+        if (m_member.compression_method == ZipCompressionMethod::Deflate) {
+            auto bit_stream = TRY(try_make<LittleEndianInputBitStream>(MaybeOwned<Stream>(compressed_stream)));
+            decompressor = TRY(Compress::DeflateDecompressor::construct(move(bit_stream)));
+        } else {
+            decompressor = TRY(Compress::ZstdDecompressor::create(MaybeOwned<Stream>(compressed_stream)));
+        }
+
+        // Members are decompressed in chunks, so that reading many of them at once doesn't need all of them in memory.
+        auto buffer = TRY(ByteBuffer::create_uninitialized(64 * KiB));
+        while (!decompressor->is_eof())
+            TRY(write_uncompressed_data(TRY(decompressor->read_some(buffer))));
+        break;
+    }
+    default:
+        return Error::from_string_literal("Unsupported zip compression method");
+    }
+
+    if (uncompressed_size != m_member.uncompressed_size)
+        return Error::from_string_literal("Zip member is smaller than its recorded size");
+    if (checksum.digest() != m_member.crc32)
+        return Error::from_string_literal("CRC32 mismatch");
+    return {};
+}
+
 ZipOutputStream::ZipOutputStream(NonnullOwnPtr<Stream> stream)
+    : ZipOutputStream(move(stream), 0)
+{
+}
+
+ZipOutputStream::ZipOutputStream(NonnullOwnPtr<Stream> stream, size_t thread_count)
     : m_stream(move(stream))
+    , m_chunks(
+          thread_count,
+          [](Chunk& chunk) { return compress_chunk(chunk); },
+          [this](Chunk& chunk) { return write_chunk(chunk); })
 {
 }
 
+ErrorOr<NonnullOwnPtr<ZipOutputStream>> ZipOutputStream::create_parallel(NonnullOwnPtr<Stream> stream, size_t thread_count)
+{
+    VERIFY(thread_count > 0);
+    return adopt_nonnull_own_or_enomem(new (nothrow) ZipOutputStream(move(stream), thread_count));
+}
+
+ZipOutputStream::~ZipOutputStream() = default;
+
 static u16 minimum_version_needed(ZipCompressionMethod method)
 {
-    // Deflate was added in PKZip 2.0
-    return method == ZipCompressionMethod::Deflate ? 20 : 10;
+    switch (method) {
+    case ZipCompressionMethod::Deflate:
+        // Deflate was added in PKZip 2.0
+        return 20;
+    case ZipCompressionMethod::Zstd:
+        // Zstandard was added in version 6.3.7 of the specification
+        return 63;
+    default:
+        return 10;
+    }
 }
 
-ErrorOr<void> ZipOutputStream::add_member(ZipMember const& member)
+// Zip64 extensions were added in PKZip 4.5
+static constexpr u16 zip64_minimum_version = 45;
+
+// Only the values whose regular (32-bit) fields are set to 0xFFFFFFFF are stored in here, in the order of those fields.
+static ErrorOr<ByteBuffer> zip64_extended_information_extra_field(ReadonlySpan<u64> values)
 {
-    VERIFY(!m_finished);
-    VERIFY(member.name.bytes_as_string_view().length() <= UINT16_MAX);
-    VERIFY(member.compressed_data.size() <= UINT32_MAX);
-    TRY(m_members.try_append(member));
-
-    LocalFileHeader local_file_header {
-        .minimum_version = minimum_version_needed(member.compression_method),
-        .general_purpose_flags = { .flags = 0 },
-        .compression_method = static_cast<u16>(member.compression_method),
-        .modification_time = member.modification_time,
-        .modification_date = member.modification_date,
-        .crc32 = member.crc32,
-        .compressed_size = static_cast<u32>(member.compressed_data.size()),
-        .uncompressed_size = member.uncompressed_size,
-        .name_length = static_cast<u16>(member.name.bytes_as_string_view().length()),
-        .extra_data_length = 0,
-        .name = reinterpret_cast<u8 const*>(member.name.bytes_as_string_view().characters_without_null_termination()),
-        .extra_data = nullptr,
-        .compressed_data = member.compressed_data.data(),
+    ByteBuffer extra_field;
+    auto append_value = [&extra_field](auto value) {
+        return extra_field.try_append(&value, sizeof(value));
     };
-    return local_file_header.write(*m_stream);
+
+    TRY(append_value(zip64_extended_information_extra_field_tag));
+    TRY(append_value(static_cast<u16>(values.size() * sizeof(u64))));
+    for (auto value : values)
+        TRY(append_value(value));
+    return extra_field;
 }
 
-ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_stream(StringView path, Stream& stream, Optional<Core::DateTime> const& modification_time)
+static ErrorOr<ByteBuffer> deflate_chunk(ReadonlyBytes input, ReadonlyBytes dictionary, bool is_last)
 {
-    auto buffer = TRY(stream.read_until_eof());
+    AllocatingMemoryStream output_stream;
+    auto compressor = TRY(Compress::DeflateCompressor::construct(MaybeOwned<Stream>(output_stream)));
+    compressor->set_dictionary(dictionary);
+
+    TRY(compressor->write_until_depleted(input));
+    if (is_last)
+        TRY(compressor->final_flush());
+    else
+        TRY(compressor->final_sync_flush());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    TRY(output_stream.read_until_filled(buffer));
+    return buffer;
+}
 
-    Archive::ZipMember member {};
-    member.name = TRY(String::from_utf8(path));
+ErrorOr<ZipOutputStream::Member*> ZipOutputStream::create_member(StringView name, Optional<Core::DateTime> const& modification_time)
+{
+    VERIFY(!m_finished);
+    VERIFY(name.length() <= UINT16_MAX);
+
+    auto member = TRY(try_make<Member>());
+    member->name = TRY(String::from_utf8(name));
 
     if (modification_time.has_value()) {
-        member.modification_date = to_packed_dos_date(modification_time->year(), modification_time->month(), modification_time->day());
-        member.modification_time = to_packed_dos_time(modification_time->hour(), modification_time->minute(), modification_time->second());
+        member->modification_date = to_packed_dos_date(modification_time->year(), modification_time->month(), modification_time->day());
+        member->modification_time = to_packed_dos_time(modification_time->hour(), modification_time->minute(), modification_time->second());
     }
 
-    auto deflate_buffer = Compress::DeflateCompressor::compress_all(buffer);
-    auto compression_ratio = 1.f;
-    auto compressed_size = buffer.size();
-
-    if (!deflate_buffer.is_error() && deflate_buffer.value().size() < buffer.size()) {
-        member.compressed_data = deflate_buffer.value().bytes();
-        member.compression_method = Archive::ZipCompressionMethod::Deflate;
+    TRY(m_members.try_append(move(member)));
+    return m_members.last().ptr();
+}
 
-        compression_ratio = static_cast<float>(deflate_buffer.value().size()) / static_cast<float>(buffer.size());
-        compressed_size = member.compressed_data.size();
-    } else {
-        member.compressed_data = buffer.bytes();
-        member.compression_method = Archive::ZipCompressionMethod::Store;
-    }
+ZipOutputStream::MemberInformation ZipOutputStream::information_for(Member const& member)
+{
+    if (member.compression_method == ZipCompressionMethod::Store || member.uncompressed_size == 0)
+        return { 1.f, static_cast<size_t>(member.compressed_size) };
+    return { static_cast<float>(member.compressed_size) / static_cast<float>(member.uncompressed_size), static_cast<size_t>(member.compressed_size) };
+}
 
-    member.uncompressed_size = buffer.size();
+ErrorOr<void> ZipOutputStream::add_member(ZipMember const& zip_member)
+{
+    VERIFY(zip_member.compressed_data.size() <= UINT32_MAX);
+    VERIFY(zip_member.uncompressed_size <= UINT32_MAX);
+
+    auto* member = TRY(create_member(zip_member.name.bytes_as_string_view(), {}));
+    member->modification_time = zip_member.modification_time;
+    member->modification_date = zip_member.modification_date;
+    member->is_directory = zip_member.is_directory;
+    member->compression_method = zip_member.compression_method;
+    member->crc32 = zip_member.crc32;
+    member->uncompressed_size = zip_member.uncompressed_size;
+
+    // The data is already compressed, so it only has to wait for the members in front of it to be written.
+    auto chunk = TRY(try_make<Chunk>());
+    chunk->member = member;
+    chunk->is_first = true;
+    chunk->is_last = true;
+    chunk->is_compressed = true;
+    if (zip_member.compression_method == ZipCompressionMethod::Store)
+        chunk->input = TRY(ByteBuffer::copy(zip_member.compressed_data));
+    else
+        chunk->output = TRY(ByteBuffer::copy(zip_member.compressed_data));
+
+    return m_chunks.submit(move(chunk));
+}
 
-    Crypto::Checksum::CRC32 checksum { buffer.bytes() };
-    member.crc32 = checksum.digest();
-    member.is_directory = false;
+ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_stream(StringView path, Stream& stream, Optional<Core::DateTime> const& modification_time)
+{
+    TRY(queue_member_from_stream(path, stream, modification_time));
+    TRY(m_chunks.finish_all());
+    return information_for(*m_members.last());
+}
 
-    TRY(add_member(member));
+ErrorOr<void> ZipOutputStream::queue_member_from_stream(StringView path, Stream& stream, Optional<Core::DateTime> const& modification_time)
+{
+    auto* member = TRY(create_member(path, modification_time));
+
+    auto read_chunk_input = [&stream]() -> ErrorOr<ByteBuffer> {
+        auto buffer = TRY(ByteBuffer::create_uninitialized(member_chunk_size));
+        size_t size = 0;
+        while (size < buffer.size() && !stream.is_eof()) {
+            auto bytes = TRY(stream.read_some(buffer.bytes().slice(size)));
+            if (bytes.is_empty())
+                break;
+            size += bytes.size();
+        }
+        buffer.resize(size);
+        return buffer;
+    };
 
-    return MemberInformation { compression_ratio, compressed_size };
+    Crypto::Checksum::CRC32 checksum;
+    ByteBuffer previous_input_tail;
+    auto input = TRY(read_chunk_input());
+    for (bool is_first = true;; is_first = false) {
+        // Reading one chunk ahead tells us whether this is the last one, which decides how the member is written.
+        ByteBuffer next_input;
+        if (input.size() == member_chunk_size)
+            next_input = TRY(read_chunk_input());
+        bool is_last = next_input.is_empty();
+
+        checksum.update(input);
+        member->uncompressed_size += input.size();
+        if (is_first && !is_last)
+            member->has_data_descriptor = true;
+        if (is_last)
+            member->crc32 = checksum.digest();
+
+        auto chunk = TRY(try_make<Chunk>());
+        chunk->member = member;
+        chunk->dictionary = move(previous_input_tail);
+        chunk->is_first = is_first;
+        chunk->is_last = is_last;
+
+        // The next chunk can refer back to (at most) the last deflate block of this one.
+        if (!is_last)
+            previous_input_tail = TRY(ByteBuffer::copy(input.bytes().slice(input.size() - min(input.size(), Compress::DeflateCompressor::block_size))));
+
+        chunk->input = move(input);
+        TRY(m_chunks.submit(move(chunk)));
+
+        if (is_last)
+            return {};
+        input = move(next_input);
+    }
 }
 
 ErrorOr<void> ZipOutputStream::add_directory(StringView name, Optional<Core::DateTime> const& modification_time)
@@ -214,48 +463,167 @@ ErrorOr<void> ZipOutputStream::add_directory(StringView name, Optional<Core::Dat
     return add_member(member);
 }
 
+ErrorOr<void> ZipOutputStream::write_chunk(Chunk const& chunk)
+{
+    auto& member = *chunk.member;
+    if (chunk.compression_method.has_value())
+        member.compression_method = chunk.compression_method;
+    auto data = member.compression_method == ZipCompressionMethod::Store ? chunk.input.bytes() : chunk.output.bytes();
+
+    if (chunk.is_first) {
+        member.local_file_header_offset = m_output_offset;
+
+        // A member that is written in several chunks gets its CRC32 and sizes in the data descriptor instead. Since we can't
+        // know yet whether those sizes will fit into 32 bits, the local file header always has the (empty) Zip64 fields for them.
+        ByteBuffer extra_field;
+        if (member.has_data_descriptor)
+            extra_field = TRY(zip64_extended_information_extra_field(Array<u64, 2> { 0, 0 }));
+
+        LocalFileHeader local_file_header {
+            .minimum_version = member.has_data_descriptor ? zip64_minimum_version : minimum_version_needed(*member.compression_method),
+            .general_purpose_flags = { .flags = 0 },
+            .compression_method = static_cast<u16>(*member.compression_method),
+            .modification_time = member.modification_time,
+            .modification_date = member.modification_date,
+            .crc32 = member.has_data_descriptor ? 0 : member.crc32,
+            .compressed_size = member.has_data_descriptor ? 0 : static_cast<u32>(data.size()),
+            .uncompressed_size = member.has_data_descriptor ? 0 : static_cast<u32>(member.uncompressed_size),
+            .name_length = static_cast<u16>(member.name.bytes_as_string_view().length()),
+            .extra_data_length = static_cast<u16>(extra_field.size()),
+            .name = reinterpret_cast<u8 const*>(member.name.bytes_as_string_view().characters_without_null_termination()),
+            .extra_data = extra_field.data(),
+            .compressed_data = data.data(),
+        };
+        local_file_header.general_purpose_flags.data_descriptor = member.has_data_descriptor;
+        TRY(local_file_header.write(*m_stream));
+        m_output_offset += local_file_header.size();
+    }
+
+    if (!chunk.is_first || member.has_data_descriptor) {
+        TRY(m_stream->write_until_depleted(data));
+        m_output_offset += data.size();
+    }
+    member.compressed_size += data.size();
+
+    if (!chunk.is_last)
+        return {};
+
+    if (member.has_data_descriptor) {
+        Zip64DataDescriptor data_descriptor {
+            .crc32 = member.crc32,
+            .compressed_size = member.compressed_size,
+            .uncompressed_size = member.uncompressed_size,
+        };
+        TRY(data_descriptor.write(*m_stream));
+        m_output_offset += Zip64DataDescriptor::size();
+    }
+
+    if (!member.is_directory && on_member_written)
+        on_member_written(member.name, information_for(member));
+    return {};
+}
+
+ErrorOr<void> ZipOutputStream::compress_chunk(Chunk& chunk)
+{
+    if (chunk.is_compressed)
+        return {};
+
+    // Once the first chunk has shown that a member doesn't compress, the rest of it is stored without even trying.
+    if (!chunk.is_first && chunk.member->is_stored)
+        return {};
+
+    chunk.output = TRY(deflate_chunk(chunk.input, chunk.dictionary, chunk.is_last));
+    if (chunk.is_first) {
+        chunk.compression_method = chunk.output.size() < chunk.input.size() ? ZipCompressionMethod::Deflate : ZipCompressionMethod::Store;
+        if (chunk.compression_method == ZipCompressionMethod::Store)
+            chunk.member->is_stored = true;
+    }
+    return {};
+}
+
 ErrorOr<void> ZipOutputStream::finish()
 {
     VERIFY(!m_finished);
     m_finished = true;
 
-    auto file_header_offset = 0u;
-    auto central_directory_size = 0u;
-    for (ZipMember const& member : m_members) {
-        auto zip_version = minimum_version_needed(member.compression_method);
+    TRY(m_chunks.finish_all());
+
+    auto central_directory_offset = m_output_offset;
+    u64 central_directory_size = 0;
+    for (auto const& member : m_members) {
+        Vector<u64, 3> zip64_values;
+        auto fit_into_32_bits = [&zip64_values](u64 value) -> u32 {
+            if (value < 0xFFFFFFFF)
+                return static_cast<u32>(value);
+            zip64_values.append(value);
+            return 0xFFFFFFFF;
+        };
+        auto uncompressed_size = fit_into_32_bits(member->uncompressed_size);
+        auto compressed_size = fit_into_32_bits(member->compressed_size);
+        auto local_file_header_offset = fit_into_32_bits(member->local_file_header_offset);
+
+        ByteBuffer extra_field;
+        if (!zip64_values.is_empty())
+            extra_field = TRY(zip64_extended_information_extra_field(zip64_values));
+
+        auto zip_version = member->has_data_descriptor || !zip64_values.is_empty() ? zip64_minimum_version : minimum_version_needed(*member->compression_method);
         CentralDirectoryRecord central_directory_record {
             .made_by_version = zip_version,
             .minimum_version = zip_version,
             .general_purpose_flags = { .flags = 0 },
-            .compression_method = member.compression_method,
-            .modification_time = member.modification_time,
-            .modification_date = member.modification_date,
-            .crc32 = member.crc32,
-            .compressed_size = static_cast<u32>(member.compressed_data.size()),
-            .uncompressed_size = member.uncompressed_size,
-            .name_length = static_cast<u16>(member.name.bytes_as_string_view().length()),
-            .extra_data_length = 0,
+            .compression_method = *member->compression_method,
+            .modification_time = member->modification_time,
+            .modification_date = member->modification_date,
+            .crc32 = member->crc32,
+            .compressed_size = compressed_size,
+            .uncompressed_size = uncompressed_size,
+            .name_length = static_cast<u16>(member->name.bytes_as_string_view().length()),
+            .extra_data_length = static_cast<u16>(extra_field.size()),
             .comment_length = 0,
             .start_disk = 0,
             .internal_attributes = 0,
-            .external_attributes = member.is_directory ? zip_directory_external_attribute : 0,
-            .local_file_header_offset = file_header_offset, // FIXME: we assume the wrapped output stream was never written to before us
-            .name = reinterpret_cast<u8 const*>(member.name.bytes_as_string_view().characters_without_null_termination()),
-            .extra_data = nullptr,
+            .external_attributes = member->is_directory ? zip_directory_external_attribute : 0,
+            .local_file_header_offset = local_file_header_offset,
+            .name = reinterpret_cast<u8 const*>(member->name.bytes_as_string_view().characters_without_null_termination()),
+            .extra_data = extra_field.data(),
             .comment = nullptr,
         };
-        file_header_offset += sizeof(LocalFileHeader::signature) + (sizeof(LocalFileHeader) - (sizeof(u8*) * 3)) + member.name.bytes_as_string_view().length() + member.compressed_data.size();
+        central_directory_record.general_purpose_flags.data_descriptor = member->has_data_descriptor;
         TRY(central_directory_record.write(*m_stream));
         central_directory_size += central_directory_record.size();
     }
 
+    u64 member_count = m_members.size();
+    if (member_count >= 0xFFFF || central_directory_size >= 0xFFFFFFFF || central_directory_offset >= 0xFFFFFFFF) {
+        Zip64EndOfCentralDirectory zip64_end_of_central_directory {
+            .record_size = sizeof(Zip64EndOfCentralDirectory) - sizeof(u64),
+            .made_by_version = zip64_minimum_version,
+            .minimum_version = zip64_minimum_version,
+            .disk_number = 0,
+            .central_directory_start_disk = 0,
+            .disk_records_count = member_count,
+            .total_records_count = member_count,
+            .central_directory_size = central_directory_size,
+            .central_directory_offset = central_directory_offset,
+        };
+        TRY(zip64_end_of_central_directory.write(*m_stream));
+
+        Zip64EndOfCentralDirectoryLocator zip64_end_of_central_directory_locator {
+            .central_directory_start_disk = 0,
+            .end_of_central_directory_offset = central_directory_offset + central_directory_size,
+            .total_disks = 1,
+        };
+        TRY(zip64_end_of_central_directory_locator.write(*m_stream));
+    }
+
+    // Any of these that don't fit are set to their maximum value, which tells readers to look at the Zip64 record instead.
     EndOfCentralDirectory end_of_central_directory {
         .disk_number = 0,
         .central_directory_start_disk = 0,
-        .disk_records_count = static_cast<u16>(m_members.size()),
-        .total_records_count = static_cast<u16>(m_members.size()),
-        .central_directory_size = central_directory_size,
-        .central_directory_offset = file_header_offset,
+        .disk_records_count = static_cast<u16>(min<u64>(member_count, 0xFFFF)),
+        .total_records_count = static_cast<u16>(min<u64>(member_count, 0xFFFF)),
+        .central_directory_size = static_cast<u32>(min<u64>(central_directory_size, 0xFFFFFFFF)),
+        .central_directory_offset = static_cast<u32>(min<u64>(central_directory_offset, 0xFFFFFFFF)),
         .comment_length = 0,
         .comment = nullptr,
     };
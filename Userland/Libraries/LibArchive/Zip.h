@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/DOSPackedTime.h>
 #include <AK/Function.h>
 #include <AK/IterationDecision.h>
@@ -17,6 +18,8 @@
 #include <AK/Vector.h>
 #include <LibArchive/Statistics.h>
 #include <LibCore/DateTime.h>
+#include <LibCore/MappedFile.h>
+#include <LibThreading/OrderedJobQueue.h>
 #include <string.h>
 
 namespace Archive {
@@ -79,6 +82,76 @@ struct [[gnu::packed]] EndOfCentralDirectory {
     }
 };
 
+struct [[gnu::packed]] Zip64EndOfCentralDirectory {
+    static constexpr Array<u8, signature_length> signature = { 0x50, 0x4b, 0x06, 0x06 }; // 'PK\x06\x06'
+
+    u64 record_size; // The size of the remaining record, i.e. without the signature and this field.
+    u16 made_by_version;
+    u16 minimum_version;
+    u32 disk_number;
+    u32 central_directory_start_disk;
+    u64 disk_records_count;
+    u64 total_records_count;
+    u64 central_directory_size;
+    u64 central_directory_offset;
+
+    bool read(ReadonlyBytes buffer)
+    {
+        // NOTE: The record may be followed by an extensible data sector, which we don't need.
+        return read_helper<sizeof(Zip64EndOfCentralDirectory)>(buffer, this);
+    }
+
+    ErrorOr<void> write(Stream& stream) const
+    {
+        auto write_value = [&stream](auto value) {
+            return stream.write_until_depleted({ &value, sizeof(value) });
+        };
+
+        TRY(stream.write_until_depleted(signature));
+        TRY(write_value(record_size));
+        TRY(write_value(made_by_version));
+        TRY(write_value(minimum_version));
+        TRY(write_value(disk_number));
+        TRY(write_value(central_directory_start_disk));
+        TRY(write_value(disk_records_count));
+        TRY(write_value(total_records_count));
+        TRY(write_value(central_directory_size));
+        TRY(write_value(central_directory_offset));
+        return {};
+    }
+};
+
+struct [[gnu::packed]] Zip64EndOfCentralDirectoryLocator {
+    static constexpr Array<u8, signature_length> signature = { 0x50, 0x4b, 0x06, 0x07 }; // 'PK\x06\x07'
+
+    u32 central_directory_start_disk;
+    u64 end_of_central_directory_offset;
+    u32 total_disks;
+
+    bool read(ReadonlyBytes buffer)
+    {
+        return read_helper<sizeof(Zip64EndOfCentralDirectoryLocator)>(buffer, this);
+    }
+
+    [[nodiscard]] static constexpr size_t size()
+    {
+        return signature.size() + sizeof(Zip64EndOfCentralDirectoryLocator);
+    }
+
+    ErrorOr<void> write(Stream& stream) const
+    {
+        auto write_value = [&stream](auto value) {
+            return stream.write_until_depleted({ &value, sizeof(value) });
+        };
+
+        TRY(stream.write_until_depleted(signature));
+        TRY(write_value(central_directory_start_disk));
+        TRY(write_value(end_of_central_directory_offset));
+        TRY(write_value(total_disks));
+        return {};
+    }
+};
+
 enum class ZipCompressionMethod : u16 {
     Store = 0,
     Shrink = 1,
@@ -88,7 +161,8 @@ enum class ZipCompressionMethod : u16 {
     Reduce4 = 5,
     Implode = 6,
     Reserved = 7,
-    Deflate = 8
+    Deflate = 8,
+    Zstd = 93
 };
 
 union ZipGeneralPurposeFlags {
@@ -206,7 +280,9 @@ struct [[gnu::packed]] LocalFileHeader {
         constexpr auto fields_size = sizeof(LocalFileHeader) - (sizeof(u8*) * 3);
         if (!read_helper<fields_size>(buffer, this))
             return false;
-        if (buffer.size() < signature.size() + fields_size + name_length + extra_data_length + compressed_size)
+        // Members whose sizes don't fit into 32 bits have them in the Zip64 extended information extra field instead.
+        auto data_size = compressed_size == 0xFFFFFFFF ? 0 : compressed_size;
+        if (buffer.size() < signature.size() + fields_size + name_length + extra_data_length + data_size)
             return false;
         name = buffer.data() + signature.size() + fields_size;
         extra_data = name + name_length;
@@ -239,62 +315,185 @@ struct [[gnu::packed]] LocalFileHeader {
             TRY(stream.write_until_depleted({ compressed_data, compressed_size }));
         return {};
     }
+
+    [[nodiscard]] size_t size() const
+    {
+        return signature.size() + (sizeof(LocalFileHeader) - (sizeof(u8*) * 3)) + name_length + extra_data_length + compressed_size;
+    }
 };
 
+// Follows the data of members whose CRC32 and sizes weren't known yet when their local file header was written.
+// This is the Zip64 variant of it, which is used when the local file header has a Zip64 extended information extra field.
+struct [[gnu::packed]] Zip64DataDescriptor {
+    static constexpr Array<u8, signature_length> signature = { 0x50, 0x4b, 0x07, 0x08 }; // 'PK\x07\x08'
+
+    u32 crc32;
+    u64 compressed_size;
+    u64 uncompressed_size;
+
+    ErrorOr<void> write(Stream& stream) const
+    {
+        auto write_value = [&stream](auto value) {
+            return stream.write_until_depleted({ &value, sizeof(value) });
+        };
+
+        TRY(stream.write_until_depleted(signature));
+        TRY(write_value(crc32));
+        TRY(write_value(compressed_size));
+        TRY(write_value(uncompressed_size));
+        return {};
+    }
+
+    [[nodiscard]] static constexpr size_t size()
+    {
+        return signature.size() + sizeof(Zip64DataDescriptor);
+    }
+};
+
+static constexpr u16 zip64_extended_information_extra_field_tag = 0x0001;
+
 struct ZipMember {
     String name;
     ReadonlyBytes compressed_data; // TODO: maybe the decompression/compression should be handled by LibArchive instead of the user?
     ZipCompressionMethod compression_method;
-    u32 uncompressed_size;
+    u64 uncompressed_size;
     u32 crc32;
     bool is_directory;
     DOSPackedTime modification_time;
     DOSPackedDate modification_date;
 };
 
+// Decompresses a single member straight out of the archive data. Readers don't share any mutable state, so the
+// members of an archive can be decompressed on different threads at the same time.
+// NOTE: Creating, copying and destroying readers is not thread-safe, as they keep a reference to the mapped archive.
+class ZipMemberReader {
+public:
+    ZipMember const& member() const { return m_member; }
+
+    // Writes the uncompressed member to the stream, and fails if its size or CRC32 don't match the central directory.
+    ErrorOr<void> decompress_into(Stream&) const;
+
+private:
+    friend class Zip;
+
+    ZipMemberReader(RefPtr<Core::SharedMappedFile> file, ZipMember member)
+        : m_file(move(file))
+        , m_member(move(member))
+    {
+    }
+
+    RefPtr<Core::SharedMappedFile> m_file;
+    ZipMember m_member;
+};
+
 class Zip {
 public:
     static Optional<Zip> try_create(ReadonlyBytes buffer);
+    static Optional<Zip> try_create(NonnullOwnPtr<Core::MappedFile>);
     ErrorOr<bool> for_each_member(Function<ErrorOr<IterationDecision>(ZipMember const&)>) const;
     ErrorOr<Statistics> calculate_statistics() const;
 
+    // Returns a reader for every member, in the order of the central directory.
+    ErrorOr<Vector<ZipMemberReader>> member_readers() const;
+
 private:
     static bool find_end_of_central_directory_offset(ReadonlyBytes, size_t& offset);
 
-    Zip(u16 member_count, size_t members_start_offset, ReadonlyBytes input_data)
+    Zip(u64 member_count, size_t members_start_offset, ReadonlyBytes input_data)
         : m_member_count { member_count }
         , m_members_start_offset { members_start_offset }
         , m_input_data { input_data }
     {
     }
-    u16 m_member_count { 0 };
+    u64 m_member_count { 0 };
     size_t m_members_start_offset { 0 };
     ReadonlyBytes m_input_data;
+    RefPtr<Core::SharedMappedFile> m_mapped_file;
 };
 
+// Members are compressed in chunks, which (when created with create_parallel()) are spread across worker threads.
+// The output is still written strictly in order, while only keeping a few chunks per thread in memory.
 class ZipOutputStream {
+    AK_MAKE_NONCOPYABLE(ZipOutputStream);
+    AK_MAKE_NONMOVABLE(ZipOutputStream);
+
 public:
     struct MemberInformation {
         float compression_ratio;
         size_t compressed_size;
     };
 
+    // Larger members are split into several chunks. As their CRC32 and sizes aren't known before the first chunk
+    // is written, they are followed by a data descriptor, and always have room for Zip64 sizes.
+    static constexpr size_t member_chunk_size = 1 * MiB;
+
+    // NOTE: The offsets in the archive are counted from the first byte that is written to the stream,
+    //       so nothing may have been written to it before (i.e. the archive can't have a prefix).
     ZipOutputStream(NonnullOwnPtr<Stream>);
+    static ErrorOr<NonnullOwnPtr<ZipOutputStream>> create_parallel(NonnullOwnPtr<Stream>, size_t thread_count);
+    ~ZipOutputStream();
 
     ErrorOr<void> add_member(ZipMember const&);
     ErrorOr<MemberInformation> add_member_from_stream(StringView, Stream&, Optional<Core::DateTime> const& = {});
 
+    // Reads all of the stream and queues it up for compression, without waiting for the member to be written.
+    // Every member is stored with whichever of deflate and store makes its first chunk smaller.
+    ErrorOr<void> queue_member_from_stream(StringView, Stream&, Optional<Core::DateTime> const& = {});
+
     // NOTE: This does not add any of the files within the directory,
     //       it just adds an entry for it.
     ErrorOr<void> add_directory(StringView, Optional<Core::DateTime> const& = {});
 
     ErrorOr<void> finish();
 
+    // Called (in order) for every member that isn't a directory, once it has been written.
+    Function<void(StringView name, MemberInformation const&)> on_member_written;
+
 private:
+    struct Member {
+        String name;
+        DOSPackedTime modification_time {};
+        DOSPackedDate modification_date {};
+        bool is_directory { false };
+        bool has_data_descriptor { false };
+
+        // Decided by the worker that compresses the first chunk, unless the member was added already compressed.
+        Optional<ZipCompressionMethod> compression_method;
+        // Set by that worker as soon as it has decided to store the member, which lets the workers for the other chunks skip compressing them.
+        Atomic<bool> is_stored { false };
+
+        u32 crc32 { 0 };
+        u64 uncompressed_size { 0 };
+        u64 compressed_size { 0 };
+        u64 local_file_header_offset { 0 };
+    };
+
+    struct Chunk {
+        Member* member { nullptr };
+        ByteBuffer input;
+        ByteBuffer dictionary;
+        bool is_first { false };
+        bool is_last { false };
+        bool is_compressed { false }; // Whether the input was added already compressed, in which case it's in `output`.
+
+        Optional<ZipCompressionMethod> compression_method; // Only set for the first chunk.
+        ByteBuffer output;
+    };
+
+    ZipOutputStream(NonnullOwnPtr<Stream>, size_t thread_count);
+
+    ErrorOr<Member*> create_member(StringView name, Optional<Core::DateTime> const&);
+    static MemberInformation information_for(Member const&);
+
+    static ErrorOr<void> compress_chunk(Chunk&);
+    ErrorOr<void> write_chunk(Chunk const&);
+
     NonnullOwnPtr<Stream> m_stream;
-    Vector<ZipMember> m_members;
+    u64 m_output_offset { 0 };
+    Vector<NonnullOwnPtr<Member>> m_members;
+
+    Threading::OrderedJobQueue<Chunk> m_chunks;
 
     bool m_finished { false };
 };
-
 }
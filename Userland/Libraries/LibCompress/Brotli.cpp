@@ -5,9 +5,14 @@
  */
 
 #include <AK/BinarySearch.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/IntegralMath.h>
+#include <AK/Math.h>
+#include <AK/MemoryStream.h>
 #include <AK/QuickSort.h>
 #include <LibCompress/Brotli.h>
 #include <LibCompress/BrotliDictionary.h>
+#include <LibCompress/DeflateTables.h>
 
 namespace Compress {
 
@@ -489,63 +494,63 @@ ErrorOr<void> BrotliDecompressionStream::block_read_new_state(Block& block)
     return {};
 }
 
+static constexpr u8 context_id_lut0[256] {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 0, 0, 4, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    8, 12, 16, 12, 12, 20, 12, 16, 24, 28, 12, 12, 32, 12, 36, 12,
+    44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 32, 32, 24, 40, 28, 12,
+    12, 48, 52, 52, 52, 48, 52, 52, 52, 48, 52, 52, 52, 52, 52, 48,
+    52, 52, 52, 52, 52, 48, 52, 52, 52, 52, 52, 24, 12, 28, 12, 12,
+    12, 56, 60, 60, 60, 56, 60, 60, 60, 56, 60, 60, 60, 60, 60, 56,
+    60, 60, 60, 60, 60, 56, 60, 60, 60, 60, 60, 24, 12, 28, 12, 0,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3
+};
+static constexpr u8 context_id_lut1[256] {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
+    1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,
+    1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
+};
+static constexpr u8 context_id_lut2[256] {
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7
+};
+
 size_t BrotliDecompressionStream::literal_code_index_from_context()
 {
-    size_t const context_id_lut0[256] {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 0, 0, 4, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        8, 12, 16, 12, 12, 20, 12, 16, 24, 28, 12, 12, 32, 12, 36, 12,
-        44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 32, 32, 24, 40, 28, 12,
-        12, 48, 52, 52, 52, 48, 52, 52, 52, 48, 52, 52, 52, 52, 52, 48,
-        52, 52, 52, 52, 52, 48, 52, 52, 52, 52, 52, 24, 12, 28, 12, 12,
-        12, 56, 60, 60, 60, 56, 60, 60, 60, 56, 60, 60, 60, 60, 60, 56,
-        60, 60, 60, 60, 60, 56, 60, 60, 60, 60, 60, 24, 12, 28, 12, 0,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3
-    };
-    size_t const context_id_lut1[256] {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
-        1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,
-        1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
-    };
-    size_t const context_id_lut2[256] {
-        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7
-    };
-
     size_t context_mode = m_literal_context_modes[m_literal_block.type];
     size_t context_id;
     switch (context_mode) {
@@ -569,6 +574,15 @@ size_t BrotliDecompressionStream::literal_code_index_from_context()
     return literal_code_index;
 }
 
+static constexpr size_t insert_length_code_base[11] { 0, 0, 0, 0, 8, 8, 0, 16, 8, 16, 16 };
+static constexpr size_t copy_length_code_base[11] { 0, 8, 0, 8, 0, 8, 16, 0, 16, 8, 16 };
+static constexpr bool implicit_zero_distance[11] { true, true, false, false, false, false, false, false, false, false, false };
+
+static constexpr size_t insert_length_base[24] { 0, 1, 2, 3, 4, 5, 6, 8, 10, 14, 18, 26, 34, 50, 66, 98, 130, 194, 322, 578, 1090, 2114, 6210, 22594 };
+static constexpr size_t insert_length_extra[24] { 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 12, 14, 24 };
+static constexpr size_t copy_length_base[24] { 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 18, 22, 30, 38, 54, 70, 102, 134, 198, 326, 582, 1094, 2118 };
+static constexpr size_t copy_length_extra[24] { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 24 };
+
 ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
 {
     size_t bytes_read = 0;
@@ -753,10 +767,6 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
 
             size_t insert_and_copy_symbol = TRY(m_insert_and_copy_codes[m_insert_and_copy_block.type].read_symbol(m_input_stream));
 
-            size_t const insert_length_code_base[11] { 0, 0, 0, 0, 8, 8, 0, 16, 8, 16, 16 };
-            size_t const copy_length_code_base[11] { 0, 8, 0, 8, 0, 8, 16, 0, 16, 8, 16 };
-            bool const implicit_zero_distance[11] { true, true, false, false, false, false, false, false, false, false, false };
-
             size_t insert_and_copy_index = insert_and_copy_symbol >> 6;
             size_t insert_length_code_offset = (insert_and_copy_symbol >> 3) & 0b111;
             size_t copy_length_code_offset = insert_and_copy_symbol & 0b111;
@@ -766,11 +776,6 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
 
             m_implicit_zero_distance = implicit_zero_distance[insert_and_copy_index];
 
-            size_t const insert_length_base[24] { 0, 1, 2, 3, 4, 5, 6, 8, 10, 14, 18, 26, 34, 50, 66, 98, 130, 194, 322, 578, 1090, 2114, 6210, 22594 };
-            size_t const insert_length_extra[24] { 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 12, 14, 24 };
-            size_t const copy_length_base[24] { 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 18, 22, 30, 38, 54, 70, 102, 134, 198, 326, 582, 1094, 2118 };
-            size_t const copy_length_extra[24] { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 24 };
-
             m_insert_length = insert_length_base[insert_length_code] + TRY(m_input_stream.read_bits(insert_length_extra[insert_length_code]));
             m_copy_length = copy_length_base[copy_length_code] + TRY(m_input_stream.read_bits(copy_length_extra[copy_length_code]));
 
@@ -943,4 +948,970 @@ bool BrotliDecompressionStream::is_eof() const
     return m_read_final_block && m_current_state == State::Idle;
 }
 
+namespace {
+
+struct QualitySettings {
+    u8 hash_bucket_bits;       // There are (1 << hash_bucket_bits) hash buckets...
+    u8 hash_bucket_sweep_bits; // ...that remember the (1 << hash_bucket_sweep_bits) most recent positions with their hash.
+    bool use_lazy_matching;
+    bool use_static_dictionary;
+    u8 max_literal_trees; // The literals are coded with a single prefix code if this is 1, and depending on their context otherwise.
+};
+
+// A prefix code for writing symbols, along with everything needed to store it in the stream.
+struct PrefixCode {
+    Vector<u16> symbols; // The symbols that are actually used, in ascending order.
+    Vector<u8> lengths;  // Indexed by symbol, this is zero for unused symbols and for the only symbol of a code.
+    Vector<u16> codes;   // Indexed by symbol, these are reversed so that they can be written least significant bit first.
+};
+
+struct CodeLengthSymbol {
+    u8 symbol;
+    u8 extra;
+};
+
+}
+
+static constexpr QualitySettings quality_settings[BrotliCompressor::max_quality + 1] {
+    { 14, 0, false, false, 1 },
+    { 15, 1, false, false, 1 },
+    { 15, 2, false, true, 1 },
+    { 15, 3, false, true, 1 },
+    { 16, 3, true, true, 1 },
+    { 16, 4, true, true, 4 },
+    { 16, 4, true, true, 8 },
+    { 16, 5, true, true, 8 },
+    { 16, 5, true, true, 16 },
+    { 16, 6, true, true, 16 },
+    { 16, 7, true, true, 16 },
+    { 16, 8, true, true, 16 },
+};
+
+static constexpr size_t minimum_match_length = 4;
+static constexpr size_t minimum_recent_distance_match_length = 3;
+static constexpr size_t maximum_length_for_dictionary_lookup = 8;
+
+// Matches are scored by the number of bytes they cover and a rough estimate of how expensive their distance is.
+// A match has to beat a literal-only run by at least minimum_match_score, and a deferred match has to beat the
+// current one by lazy_matching_score_margin (these are the values the reference encoder uses for its hashers).
+static constexpr i64 minimum_match_score = 100;
+static constexpr i64 lazy_matching_score_margin = 175;
+static constexpr i64 recent_distance_penalties[4] { 0, 39, 43, 43 };
+
+static constexpr size_t command_alphabet_size = 704;
+static constexpr size_t distance_alphabet_size = 16 + 48; // With NPOSTFIX and NDIRECT both set to zero.
+static constexpr size_t literal_context_count = 64;
+
+// The distance codes 0 to 15 reference the recent distances, as an index into them and a delta that is applied on top.
+static constexpr struct {
+    u8 index;
+    i8 delta;
+} recent_distance_codes[16] {
+    { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 0 }, { 0, -1 }, { 0, 1 }, { 0, -2 }, { 0, 2 },
+    { 0, -3 }, { 0, 3 }, { 1, -1 }, { 1, 1 }, { 1, -2 }, { 1, 2 }, { 1, -3 }, { 1, 3 }
+};
+
+static i64 backward_reference_score(size_t length, size_t distance)
+{
+    return 135 * static_cast<i64>(length) - 30 * static_cast<i64>(AK::log2(distance));
+}
+
+static i64 recent_distance_score(size_t length, size_t distance_index)
+{
+    return 135 * static_cast<i64>(length) + 15 - recent_distance_penalties[distance_index];
+}
+
+static u32 hash_bytes(u8 const* bytes, size_t hash_bits)
+{
+    u32 value;
+    __builtin_memcpy(&value, bytes, sizeof(value));
+    return (value * 0x1e35a7bd) >> (32 - hash_bits);
+}
+
+static size_t common_prefix_length(u8 const* a, u8 const* b, size_t max_length)
+{
+    size_t length = 0;
+    while (length + sizeof(u64) <= max_length) {
+        u64 a_word;
+        u64 b_word;
+        __builtin_memcpy(&a_word, a + length, sizeof(u64));
+        __builtin_memcpy(&b_word, b + length, sizeof(u64));
+        if (auto difference = a_word ^ b_word; difference != 0)
+            return length + count_trailing_zeroes(difference) / 8;
+        length += sizeof(u64);
+    }
+    while (length < max_length && a[length] == b[length])
+        length++;
+    return length;
+}
+
+template<size_t Size>
+static size_t length_code(size_t const (&bases)[Size], size_t length)
+{
+    size_t code = Size - 1;
+    while (bases[code] > length)
+        code--;
+    return code;
+}
+
+static void encode_distance(size_t distance, u16& symbol, u32& extra, u8& extra_bits)
+{
+    // This is the inverse of the distance calculation in the decompressor for NPOSTFIX = 0 and NDIRECT = 0.
+    auto value = distance + 3;
+    auto bits = AK::log2(value) - 1;
+    auto prefix = (value >> bits) & 1;
+    symbol = 16 + 2 * (bits - 1) + prefix;
+    extra = value - ((2 + prefix) << bits);
+    extra_bits = bits;
+}
+
+static double population_cost(Array<u32, 256> const& histogram)
+{
+    // This is the entropy of the histogram, plus a rough estimate of the cost of storing its prefix code.
+    u64 total = 0;
+    size_t used_symbols = 0;
+    double bits = 0;
+    for (auto count : histogram) {
+        if (count == 0)
+            continue;
+        total += count;
+        used_symbols++;
+        bits -= count * AK::log2(static_cast<double>(count));
+    }
+    if (used_symbols <= 1)
+        return 12;
+    return bits + total * AK::log2(static_cast<double>(total)) + 5 * used_symbols + 20;
+}
+
+static Array<u32, 256> merged_histogram(Array<u32, 256> const& a, Array<u32, 256> const& b)
+{
+    Array<u32, 256> result;
+    for (size_t i = 0; i < 256; i++)
+        result[i] = a[i] + b[i];
+    return result;
+}
+
+// Merges the literal histograms of all contexts into at most max_clusters clusters, by repeatedly merging the pair
+// of clusters that costs the fewest additional bits. Returns the context map, and replaces the histograms with
+// those of the clusters.
+static Vector<u8> cluster_literal_histograms(Vector<Array<u32, 256>>& histograms, size_t max_clusters)
+{
+    auto const count = histograms.size();
+    Vector<double> costs;
+    Vector<bool> is_alive;
+    Vector<size_t> cluster_of;
+    for (size_t i = 0; i < count; i++) {
+        bool is_used = any_of(histograms[i], [](auto value) { return value != 0; });
+        costs.append(population_cost(histograms[i]));
+        is_alive.append(is_used);
+        cluster_of.append(i);
+    }
+
+    Vector<double> merge_costs;
+    merge_costs.resize(count * count);
+    auto update_merge_cost = [&](size_t a, size_t b) {
+        auto cost = population_cost(merged_histogram(histograms[a], histograms[b])) - costs[a] - costs[b];
+        merge_costs[a * count + b] = cost;
+        merge_costs[b * count + a] = cost;
+    };
+    for (size_t a = 0; a < count; a++) {
+        for (size_t b = a + 1; b < count; b++) {
+            if (is_alive[a] && is_alive[b])
+                update_merge_cost(a, b);
+        }
+    }
+
+    size_t alive_count = 0;
+    for (auto alive : is_alive)
+        alive_count += alive ? 1 : 0;
+    while (alive_count > 1) {
+        Optional<size_t> best_a;
+        size_t best_b = 0;
+        for (size_t a = 0; a < count; a++) {
+            for (size_t b = a + 1; b < count && is_alive[a]; b++) {
+                if (is_alive[b] && (!best_a.has_value() || merge_costs[a * count + b] < merge_costs[best_a.value() * count + best_b])) {
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+
+        auto a = best_a.value();
+        if (alive_count <= max_clusters && merge_costs[a * count + best_b] >= 0)
+            break;
+
+        histograms[a] = merged_histogram(histograms[a], histograms[best_b]);
+        costs[a] = population_cost(histograms[a]);
+        is_alive[best_b] = false;
+        alive_count--;
+        for (auto& cluster : cluster_of) {
+            if (cluster == best_b)
+                cluster = a;
+        }
+        for (size_t other = 0; other < count; other++) {
+            if (other != a && is_alive[other])
+                update_merge_cost(a, other);
+        }
+    }
+
+    // Number the clusters in the order of their first use, and let unused contexts continue the run of the previous one.
+    Vector<u8> context_map;
+    Vector<Array<u32, 256>> cluster_histograms;
+    Vector<Optional<u8>> cluster_ids;
+    cluster_ids.resize(count);
+    for (size_t context = 0; context < count; context++) {
+        auto cluster = cluster_of[context];
+        if (!is_alive[cluster]) {
+            context_map.append(context_map.is_empty() ? 0 : context_map.last());
+            continue;
+        }
+        if (!cluster_ids[cluster].has_value()) {
+            cluster_ids[cluster] = cluster_histograms.size();
+            cluster_histograms.append(histograms[cluster]);
+        }
+        context_map.append(cluster_ids[cluster].value());
+    }
+
+    if (cluster_histograms.is_empty())
+        cluster_histograms.append({});
+    histograms = move(cluster_histograms);
+    return context_map;
+}
+
+// Computes the lengths of a Huffman code that doesn't exceed max_length bits, by giving all symbols a minimum weight
+// that is doubled until the tree is shallow enough.
+static void compute_code_lengths(Span<u8> lengths, Span<u16> symbols, ReadonlySpan<u32> frequencies, size_t max_length)
+{
+    struct Node {
+        u64 weight;
+        i32 left;  // -1 for leaves...
+        i32 right; // ...where this is the symbol instead.
+    };
+
+    lengths.fill(0);
+    if (symbols.size() <= 1)
+        return;
+
+    Vector<Node> nodes;
+    Vector<u16> depths;
+    for (u64 minimum_weight = 1;; minimum_weight *= 2) {
+        auto weight = [&](u16 symbol) { return max<u64>(frequencies[symbol], minimum_weight); };
+        quick_sort(symbols, [&](u16 a, u16 b) { return weight(a) < weight(b) || (weight(a) == weight(b) && a < b); });
+
+        nodes.clear_with_capacity();
+        for (auto symbol : symbols)
+            nodes.append({ weight(symbol), -1, symbol });
+
+        // Both the leaves and the inner nodes are created in order of their weight, so the two lightest nodes are
+        // always at the front of one of these two queues.
+        size_t next_leaf = 0;
+        size_t next_inner_node = symbols.size();
+        auto take_lightest_node = [&]() -> size_t {
+            if (next_leaf < symbols.size() && (next_inner_node >= nodes.size() || nodes[next_leaf].weight <= nodes[next_inner_node].weight))
+                return next_leaf++;
+            return next_inner_node++;
+        };
+        while (nodes.size() < 2 * symbols.size() - 1) {
+            auto left = take_lightest_node();
+            auto right = take_lightest_node();
+            nodes.append({ nodes[left].weight + nodes[right].weight, static_cast<i32>(left), static_cast<i32>(right) });
+        }
+
+        depths.resize(nodes.size());
+        depths.last() = 0;
+        for (size_t i = nodes.size() - 1; i >= symbols.size(); i--) {
+            depths[nodes[i].left] = depths[i] + 1;
+            depths[nodes[i].right] = depths[i] + 1;
+        }
+
+        bool fits = true;
+        for (size_t i = 0; i < symbols.size(); i++)
+            fits &= depths[i] <= max_length;
+        if (!fits)
+            continue;
+
+        for (size_t i = 0; i < symbols.size(); i++)
+            lengths[nodes[i].right] = depths[i];
+        quick_sort(symbols);
+        return;
+    }
+}
+
+static ErrorOr<PrefixCode> build_prefix_code(ReadonlySpan<u32> frequencies, size_t max_length = 15)
+{
+    PrefixCode code;
+    for (size_t symbol = 0; symbol < frequencies.size(); symbol++) {
+        if (frequencies[symbol] != 0)
+            TRY(code.symbols.try_append(symbol));
+    }
+    // A code has to contain at least one symbol, even if it's never used.
+    if (code.symbols.is_empty())
+        TRY(code.symbols.try_append(0));
+
+    TRY(code.lengths.try_resize(frequencies.size()));
+    TRY(code.codes.try_resize(frequencies.size()));
+    compute_code_lengths(code.lengths, code.symbols, frequencies, max_length);
+
+    // Assign the canonical codes (RFC 7932 section 3.2).
+    Array<u16, 16> length_counts {};
+    for (auto length : code.lengths)
+        length_counts[length]++;
+    length_counts[0] = 0;
+
+    Array<u16, 16> next_codes {};
+    u16 next_code = 0;
+    for (size_t length = 1; length < 16; length++) {
+        next_code = (next_code + length_counts[length - 1]) << 1;
+        next_codes[length] = next_code;
+    }
+
+    for (size_t symbol = 0; symbol < frequencies.size(); symbol++) {
+        if (auto length = code.lengths[symbol]; length != 0)
+            code.codes[symbol] = fast_reverse16(next_codes[length]++, length);
+    }
+
+    return code;
+}
+
+static ErrorOr<void> write_symbol(LittleEndianOutputBitStream& stream, PrefixCode const& code, size_t symbol)
+{
+    return stream.write_bits(code.codes[symbol], code.lengths[symbol]);
+}
+
+static ErrorOr<void> write_variable_length(LittleEndianOutputBitStream& stream, size_t value)
+{
+    // The inverse of BrotliDecompressionStream::read_variable_length(), for values from 1 to 256.
+    VERIFY(value >= 1 && value <= 256);
+    if (value == 1)
+        return stream.write_bits(0u, 1u);
+
+    auto bits = AK::log2(value - 1);
+    TRY(stream.write_bits(1u, 1u));
+    TRY(stream.write_bits(bits, 3u));
+    TRY(stream.write_bits((value - 1) - (1u << bits), bits));
+    return {};
+}
+
+static void encode_code_length_repetitions(Vector<CodeLengthSymbol>& encoded, u8 previous_length, u8 length, size_t repetitions)
+{
+    // Repetitions of the previous non-zero length are coded with runs of the symbol 16 (RFC 7932 section 3.5),
+    // where every further 16 multiplies the count so far by 4 and adds its extra bits.
+    if (length != previous_length) {
+        encoded.append({ length, 0 });
+        repetitions--;
+    }
+    if (repetitions == 7) {
+        encoded.append({ length, 0 });
+        repetitions--;
+    }
+    if (repetitions < 3) {
+        for (size_t i = 0; i < repetitions; i++)
+            encoded.append({ length, 0 });
+        return;
+    }
+
+    repetitions -= 3;
+    auto first = encoded.size();
+    while (true) {
+        encoded.append({ 16, static_cast<u8>(repetitions & 3) });
+        repetitions >>= 2;
+        if (repetitions == 0)
+            break;
+        repetitions--;
+    }
+    encoded.span().slice(first).reverse();
+}
+
+static void encode_zero_code_length_repetitions(Vector<CodeLengthSymbol>& encoded, size_t repetitions)
+{
+    // Zeros work like the other lengths, but with the symbol 17 which multiplies by 8 instead.
+    if (repetitions == 11) {
+        encoded.append({ 0, 0 });
+        repetitions--;
+    }
+    if (repetitions < 3) {
+        for (size_t i = 0; i < repetitions; i++)
+            encoded.append({ 0, 0 });
+        return;
+    }
+
+    repetitions -= 3;
+    auto first = encoded.size();
+    while (true) {
+        encoded.append({ 17, static_cast<u8>(repetitions & 7) });
+        repetitions >>= 3;
+        if (repetitions == 0)
+            break;
+        repetitions--;
+    }
+    encoded.span().slice(first).reverse();
+}
+
+static ErrorOr<void> write_prefix_code(LittleEndianOutputBitStream& stream, PrefixCode const& code)
+{
+    auto const alphabet_size = code.lengths.size();
+
+    if (code.symbols.size() <= 4) {
+        // Simple prefix code (RFC 7932 section 3.4), which lists the symbols ordered by their code length.
+        size_t symbol_bits = 0;
+        while ((1u << symbol_bits) < alphabet_size)
+            symbol_bits++;
+
+        auto symbols = code.symbols;
+        quick_sort(symbols, [&](u16 a, u16 b) { return code.lengths[a] < code.lengths[b] || (code.lengths[a] == code.lengths[b] && a < b); });
+
+        TRY(stream.write_bits(1u, 2u));
+        TRY(stream.write_bits(symbols.size() - 1, 2u));
+        for (auto symbol : symbols)
+            TRY(stream.write_bits(symbol, symbol_bits));
+        if (symbols.size() == 4)
+            TRY(stream.write_bits(code.lengths[symbols[0]] == 1 ? 1u : 0u, 1u));
+        return {};
+    }
+
+    // Complex prefix code (RFC 7932 section 3.5), where the code lengths are coded with a prefix code themselves.
+    auto length_count = alphabet_size;
+    while (code.lengths[length_count - 1] == 0)
+        length_count--;
+
+    Vector<CodeLengthSymbol> encoded_lengths;
+    u8 previous_length = 8;
+    for (size_t i = 0; i < length_count;) {
+        auto length = code.lengths[i];
+        size_t repetitions = 1;
+        while (i + repetitions < length_count && code.lengths[i + repetitions] == length)
+            repetitions++;
+        i += repetitions;
+
+        if (length == 0) {
+            encode_zero_code_length_repetitions(encoded_lengths, repetitions);
+        } else {
+            encode_code_length_repetitions(encoded_lengths, previous_length, length, repetitions);
+            previous_length = length;
+        }
+    }
+
+    Array<u32, 18> length_frequencies {};
+    for (auto encoded_length : encoded_lengths)
+        length_frequencies[encoded_length.symbol]++;
+    auto length_code = TRY(build_prefix_code(length_frequencies, 5));
+
+    // A code length code with a single symbol uses no bits at all, but its length still has to be non-zero.
+    Array<u8, 18> length_code_lengths {};
+    for (size_t i = 0; i < 18; i++)
+        length_code_lengths[i] = length_code.lengths[i];
+    if (length_code.symbols.size() == 1)
+        length_code_lengths[length_code.symbols.first()] = 1;
+
+    static constexpr u8 length_code_order[18] { 1, 2, 3, 4, 0, 5, 17, 6, 16, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    static constexpr struct {
+        u8 code;
+        u8 bits;
+    } length_code_length_codes[6] { { 0b00, 2 }, { 0b0111, 4 }, { 0b011, 3 }, { 0b10, 2 }, { 0b01, 2 }, { 0b1111, 4 } };
+
+    size_t skipped_lengths = 0;
+    if (length_code_lengths[length_code_order[0]] == 0 && length_code_lengths[length_code_order[1]] == 0) {
+        skipped_lengths = 2;
+        if (length_code_lengths[length_code_order[2]] == 0)
+            skipped_lengths = 3;
+    }
+
+    // The decompressor stops reading lengths once the code is complete, which only happens with at least two symbols.
+    size_t written_lengths = 18;
+    if (length_code.symbols.size() > 1) {
+        while (length_code_lengths[length_code_order[written_lengths - 1]] == 0)
+            written_lengths--;
+    }
+
+    TRY(stream.write_bits(skipped_lengths, 2u));
+    for (size_t i = skipped_lengths; i < written_lengths; i++) {
+        auto const& length_code_length = length_code_length_codes[length_code_lengths[length_code_order[i]]];
+        TRY(stream.write_bits(length_code_length.code, length_code_length.bits));
+    }
+
+    for (auto encoded_length : encoded_lengths) {
+        TRY(write_symbol(stream, length_code, encoded_length.symbol));
+        if (encoded_length.symbol == 16)
+            TRY(stream.write_bits(encoded_length.extra, 2u));
+        else if (encoded_length.symbol == 17)
+            TRY(stream.write_bits(encoded_length.extra, 3u));
+    }
+
+    return {};
+}
+
+static ErrorOr<void> write_context_map(LittleEndianOutputBitStream& stream, ReadonlySpan<u8> context_map, size_t tree_count)
+{
+    // The context map is stored after a move-to-front transform, which turns repeated values into runs of zeros,
+    // and these are then coded with the run length symbols (RFC 7932 section 7.3).
+    Vector<u8> values;
+    TRY(values.try_ensure_capacity(context_map.size()));
+    Array<u8, 256> move_to_front;
+    for (size_t i = 0; i < move_to_front.size(); i++)
+        move_to_front[i] = i;
+    for (auto value : context_map) {
+        size_t index = find_index(move_to_front.begin(), move_to_front.end(), value);
+        values.unchecked_append(index);
+        for (; index > 0; index--)
+            move_to_front[index] = move_to_front[index - 1];
+        move_to_front[0] = value;
+    }
+
+    size_t longest_zero_run = 0;
+    for (size_t i = 0; i < values.size();) {
+        size_t run = 0;
+        while (i + run < values.size() && values[i + run] == 0)
+            run++;
+        longest_zero_run = max(longest_zero_run, run);
+        i += max<size_t>(run, 1);
+    }
+    size_t max_run_length_prefix = longest_zero_run >= 2 ? min<size_t>(AK::log2(longest_zero_run), 16) : 0;
+
+    Vector<CodeLengthSymbol> symbols;
+    for (size_t i = 0; i < values.size();) {
+        if (values[i] != 0) {
+            TRY(symbols.try_append({ static_cast<u8>(values[i] + max_run_length_prefix), 0 }));
+            i++;
+            continue;
+        }
+
+        size_t run = 0;
+        while (i + run < values.size() && values[i + run] == 0)
+            run++;
+        i += run;
+        while (run > 0) {
+            auto prefix = min(AK::log2(run), max_run_length_prefix);
+            auto covered = min<size_t>(run, (2u << prefix) - 1);
+            TRY(symbols.try_append({ static_cast<u8>(prefix), static_cast<u8>(covered - (1u << prefix)) }));
+            run -= covered;
+        }
+    }
+
+    Vector<u32> frequencies;
+    TRY(frequencies.try_resize(tree_count + max_run_length_prefix));
+    for (auto symbol : symbols)
+        frequencies[symbol.symbol]++;
+    auto code = TRY(build_prefix_code(frequencies));
+
+    TRY(stream.write_bits(max_run_length_prefix > 0 ? 1u : 0u, 1u));
+    if (max_run_length_prefix > 0)
+        TRY(stream.write_bits(max_run_length_prefix - 1, 4u));
+    TRY(write_prefix_code(stream, code));
+    for (auto symbol : symbols) {
+        TRY(write_symbol(stream, code, symbol.symbol));
+        if (symbol.symbol > 0 && symbol.symbol <= max_run_length_prefix)
+            TRY(stream.write_bits(symbol.extra, symbol.symbol));
+    }
+
+    // IMTF
+    TRY(stream.write_bits(1u, 1u));
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<BrotliCompressor>> BrotliCompressor::create(MaybeOwned<Stream> stream, BrotliCompressorOptions const& options)
+{
+    if (options.quality > max_quality)
+        return Error::from_string_literal("Brotli quality is out of range");
+    if (options.window_bits < min_window_bits || options.window_bits > max_window_bits)
+        return Error::from_string_literal("Brotli window size is out of range");
+
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) BrotliCompressor(move(stream), options)));
+
+    auto const& settings = quality_settings[options.quality];
+    TRY(compressor->m_hash_buckets.try_resize(1u << (settings.hash_bucket_bits + settings.hash_bucket_sweep_bits)));
+    TRY(compressor->m_hash_bucket_sizes.try_resize(1u << settings.hash_bucket_bits));
+
+    // WBITS (RFC 7932 section 9.1)
+    auto& output_stream = compressor->m_output_stream;
+    if (options.window_bits == 16) {
+        TRY(output_stream.write_bits(0u, 1u));
+    } else if (options.window_bits > 17) {
+        TRY(output_stream.write_bits(1u, 1u));
+        TRY(output_stream.write_bits(options.window_bits - 17u, 3u));
+    } else {
+        TRY(output_stream.write_bits(1u, 1u));
+        TRY(output_stream.write_bits(0u, 3u));
+        TRY(output_stream.write_bits(options.window_bits == 17 ? 0u : options.window_bits - 8u, 3u));
+    }
+
+    return compressor;
+}
+
+BrotliCompressor::BrotliCompressor(MaybeOwned<Stream> stream, BrotliCompressorOptions const& options)
+    : m_output_stream(move(stream))
+    , m_options(options)
+{
+}
+
+BrotliCompressor::~BrotliCompressor() = default;
+
+ErrorOr<Bytes> BrotliCompressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> BrotliCompressor::write_some(ReadonlyBytes bytes)
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Wrote to a Brotli stream that has already been flushed");
+
+    auto pending_size = m_buffer.size() - m_pending_start;
+    auto processed_bytes = min(bytes.size(), meta_block_size - pending_size);
+    TRY(m_buffer.try_append(bytes.trim(processed_bytes)));
+
+    if (pending_size + processed_bytes == meta_block_size)
+        TRY(compress_meta_block(meta_block_size));
+
+    return processed_bytes;
+}
+
+ErrorOr<void> BrotliCompressor::flush()
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Flushed a Brotli stream twice");
+    m_has_flushed_data = true;
+
+    if (auto pending_size = m_buffer.size() - m_pending_start; pending_size > 0)
+        TRY(compress_meta_block(pending_size));
+
+    // ISLAST and ISLASTEMPTY
+    TRY(m_output_stream.write_bits(0b11u, 2u));
+    TRY(m_output_stream.align_to_byte_boundary());
+    TRY(m_output_stream.flush_buffer_to_stream());
+    return {};
+}
+
+bool BrotliCompressor::is_eof() const
+{
+    return true;
+}
+
+bool BrotliCompressor::is_open() const
+{
+    return m_output_stream.is_open();
+}
+
+void BrotliCompressor::close()
+{
+}
+
+void BrotliCompressor::insert_hashes_until(size_t index)
+{
+    auto const& settings = quality_settings[m_options.quality];
+    auto const bucket_mask = (1u << settings.hash_bucket_sweep_bits) - 1;
+
+    // Hashing a position needs the bytes that start there.
+    auto end = min(index, m_buffer.size() - min(m_buffer.size(), minimum_match_length - 1));
+    for (; m_next_index_to_hash < end; m_next_index_to_hash++) {
+        auto hash = hash_bytes(&m_buffer[m_next_index_to_hash], settings.hash_bucket_bits);
+        auto& bucket_size = m_hash_bucket_sizes[hash];
+        m_hash_buckets[(hash << settings.hash_bucket_sweep_bits) | (bucket_size & bucket_mask)] = static_cast<u32>(m_buffer_position + m_next_index_to_hash);
+        bucket_size++;
+    }
+}
+
+Optional<BrotliCompressor::Match> BrotliCompressor::find_match(size_t index, size_t max_length)
+{
+    auto const& settings = quality_settings[m_options.quality];
+    auto const* data = m_buffer.data();
+
+    insert_hashes_until(index);
+
+    auto position = m_buffer_position + index;
+    size_t max_distance = min(position, max_backward_distance());
+
+    Optional<Match> best_match;
+    auto consider = [&](Match const& match) {
+        if (match.score > (best_match.has_value() ? best_match->score : minimum_match_score))
+            best_match = match;
+    };
+
+    // The recent distances are the cheapest ones to code, so they even allow for shorter matches.
+    for (size_t i = 0; i < m_distances.size(); i++) {
+        auto distance = m_distances[i];
+        if (distance > max_distance)
+            continue;
+        auto length = common_prefix_length(data + index - distance, data + index, max_length);
+        if (length >= minimum_recent_distance_match_length)
+            consider({ length, length, distance, false, recent_distance_score(length, i) });
+    }
+
+    // Positions are stored in their bucket in a round-robin fashion, so the most recent (and closest) one is looked at first.
+    auto hash = hash_bytes(data + index, settings.hash_bucket_bits);
+    auto const bucket_mask = (1u << settings.hash_bucket_sweep_bits) - 1;
+    auto const* bucket = &m_hash_buckets[hash << settings.hash_bucket_sweep_bits];
+    auto bucket_size = m_hash_bucket_sizes[hash];
+    for (u32 i = 1; i <= min(bucket_size, bucket_mask + 1); i++) {
+        size_t distance = static_cast<u32>(position) - bucket[(bucket_size - i) & bucket_mask];
+        if (distance == 0 || distance > max_distance)
+            break;
+
+        // A candidate can only be better if it also matches the byte right after the current best match.
+        auto const* candidate = data + index - distance;
+        if (best_match.has_value() && best_match->length < max_length && candidate[best_match->length] != data[index + best_match->length])
+            continue;
+
+        auto length = common_prefix_length(candidate, data + index, max_length);
+        if (length >= minimum_match_length)
+            consider({ length, length, distance, false, backward_reference_score(length, distance) });
+    }
+
+    // References beyond the window (or the start of the input) point into the static dictionary. Looking up words
+    // is comparatively slow, so this is skipped if the history already had a long enough match.
+    if (settings.use_static_dictionary && (!best_match.has_value() || best_match->length < maximum_length_for_dictionary_lookup)) {
+        if (auto word = BrotliDictionary::find_longest_match({ data + index, max_length }); word.has_value()) {
+            auto distance = max_distance + 1 + word->index;
+            consider({ word->length, word->word_length, distance, true, backward_reference_score(word->length, distance) });
+        }
+    }
+
+    return best_match;
+}
+
+void BrotliCompressor::emit_command(size_t insert_length, Optional<Match> const& match)
+{
+    Command command {};
+    command.insert_length = insert_length;
+    auto insert_code = length_code(insert_length_base, insert_length);
+    command.insert_extra = insert_length - insert_length_base[insert_code];
+    command.insert_extra_bits = insert_length_extra[insert_code];
+
+    // The last command of a meta-block may only insert literals, the decompressor stops before its copy.
+    auto copy_length = match.has_value() ? match->copy_length : minimum_match_length;
+    auto copy_code = length_code(copy_length_base, copy_length);
+    command.copy_extra = copy_length - copy_length_base[copy_code];
+    command.copy_extra_bits = copy_length_extra[copy_code];
+
+    bool uses_last_distance = !match.has_value();
+    if (match.has_value()) {
+        command.length = match->length;
+        command.has_distance = true;
+
+        // Dictionary references neither use nor update the recent distances.
+        Optional<size_t> recent_distance_code;
+        if (!match->is_dictionary_word) {
+            for (size_t code = 0; code < array_size(recent_distance_codes); code++) {
+                auto [index, delta] = recent_distance_codes[code];
+                if (static_cast<i64>(m_distances[index]) + delta == static_cast<i64>(match->distance)) {
+                    recent_distance_code = code;
+                    break;
+                }
+            }
+        }
+
+        if (recent_distance_code.has_value()) {
+            command.distance_symbol = recent_distance_code.value();
+            uses_last_distance = command.distance_symbol == 0;
+        } else {
+            encode_distance(match->distance, command.distance_symbol, command.distance_extra, command.distance_extra_bits);
+        }
+
+        if (!match->is_dictionary_word && command.distance_symbol != 0) {
+            m_distances[3] = m_distances[2];
+            m_distances[2] = m_distances[1];
+            m_distances[1] = m_distances[0];
+            m_distances[0] = match->distance;
+        }
+    }
+
+    if (uses_last_distance && insert_code < 8 && copy_code < 16) {
+        command.symbol = (copy_code < 8 ? 0 : 64) | ((insert_code & 7) << 3) | (copy_code & 7);
+        command.has_distance = false;
+    } else {
+        size_t cell = 2;
+        while (insert_length_code_base[cell] != (insert_code & ~7u) || copy_length_code_base[cell] != (copy_code & ~7u))
+            cell++;
+        command.symbol = (cell << 6) | ((insert_code & 7) << 3) | (copy_code & 7);
+    }
+
+    m_commands.append(command);
+}
+
+ErrorOr<void> BrotliCompressor::compress_meta_block(size_t length)
+{
+    auto const& settings = quality_settings[m_options.quality];
+    auto const start = m_pending_start;
+    auto const end = start + length;
+    auto const distances_before_meta_block = m_distances;
+
+    m_commands.clear_with_capacity();
+    size_t insert_start = start;
+    for (size_t index = start; index + minimum_match_length <= end;) {
+        auto match = find_match(index, end - index);
+        if (!match.has_value()) {
+            index++;
+            continue;
+        }
+
+        // Emit a literal instead if the next position has a clearly better match, and check again from there.
+        if (settings.use_lazy_matching) {
+            while (index + 1 + minimum_match_length <= end) {
+                auto next_match = find_match(index + 1, end - index - 1);
+                if (!next_match.has_value() || next_match->score < match->score + lazy_matching_score_margin)
+                    break;
+                match = next_match;
+                index++;
+            }
+        }
+
+        emit_command(index - insert_start, match);
+        index += match->length;
+        insert_start = index;
+    }
+    if (insert_start < end)
+        emit_command(end - insert_start, {});
+
+    // ISLAST, MNIBBLES and MLEN - 1
+    size_t nibbles = 4;
+    while (nibbles < 6 && ((length - 1) >> (4 * nibbles)) != 0)
+        nibbles++;
+    TRY(m_output_stream.write_bits(0u, 1u));
+    TRY(m_output_stream.write_bits(nibbles - 4, 2u));
+    TRY(m_output_stream.write_bits(length - 1, 4 * nibbles));
+
+    // The rest of the meta-block is compressed separately first, to find out whether storing it uncompressed is smaller.
+    AllocatingMemoryStream compressed_data;
+    LittleEndianOutputBitStream compressed_stream { MaybeOwned<Stream>(compressed_data) };
+    TRY(write_compressed_meta_block_contents(compressed_stream, start));
+    TRY(compressed_stream.flush_buffer_to_stream());
+    auto trailing_bits = compressed_stream.bit_offset();
+    auto compressed_bits = compressed_data.used_buffer_size() * 8 + trailing_bits;
+
+    // ISUNCOMPRESSED
+    if (compressed_bits >= length * 8) {
+        // The decompressor won't see any of the distances that the commands would have used.
+        m_distances = distances_before_meta_block;
+
+        TRY(m_output_stream.write_bits(1u, 1u));
+        TRY(m_output_stream.align_to_byte_boundary());
+        TRY(m_output_stream.write_until_depleted(m_buffer.bytes().slice(start, length)));
+    } else {
+        TRY(m_output_stream.write_bits(0u, 1u));
+
+        TRY(compressed_stream.align_to_byte_boundary());
+        TRY(compressed_stream.flush_buffer_to_stream());
+        auto compressed_bytes = TRY(compressed_data.read_until_eof());
+        auto whole_bytes = compressed_bytes.size() - (trailing_bits > 0 ? 1 : 0);
+        size_t offset = 0;
+        for (; offset + sizeof(u64) <= whole_bytes; offset += sizeof(u64)) {
+            u64 value;
+            __builtin_memcpy(&value, compressed_bytes.data() + offset, sizeof(value));
+            TRY(m_output_stream.write_bits(value, 64u));
+        }
+        for (; offset < whole_bytes; offset++)
+            TRY(m_output_stream.write_bits(compressed_bytes[offset], 8u));
+        if (trailing_bits > 0)
+            TRY(m_output_stream.write_bits(compressed_bytes[compressed_bytes.size() - 1], trailing_bits));
+    }
+
+    m_pending_start = end;
+
+    // Drop the history that can't be referenced anymore, but only every so often to not move the buffer around all the time.
+    size_t const history_size = 1u << m_options.window_bits;
+    if (m_pending_start > history_size + max(history_size, meta_block_size)) {
+        auto discarded_size = m_pending_start - history_size;
+        auto remaining_size = m_buffer.size() - discarded_size;
+        memmove(m_buffer.data(), m_buffer.data() + discarded_size, remaining_size);
+        m_buffer.resize(remaining_size);
+
+        m_buffer_position += discarded_size;
+        m_pending_start -= discarded_size;
+        m_next_index_to_hash -= discarded_size;
+    }
+
+    return {};
+}
+
+ErrorOr<void> BrotliCompressor::write_compressed_meta_block_contents(LittleEndianOutputBitStream& stream, size_t start)
+{
+    auto const& settings = quality_settings[m_options.quality];
+    auto const* data = m_buffer.data();
+
+    // This is context mode 2 (UTF8), and the decompressor treats bytes before the start of the input as zero.
+    auto literal_context = [&](size_t index) -> size_t {
+        u8 previous_byte = index >= 1 ? data[index - 1] : 0;
+        u8 byte_before_previous = index >= 2 ? data[index - 2] : 0;
+        return context_id_lut0[previous_byte] | context_id_lut1[byte_before_previous];
+    };
+
+    Vector<Array<u32, 256>> literal_histograms;
+    TRY(literal_histograms.try_resize(settings.max_literal_trees > 1 ? literal_context_count : 1));
+    Array<u32, command_alphabet_size> command_histogram {};
+    Array<u32, distance_alphabet_size> distance_histogram {};
+
+    size_t index = start;
+    for (auto const& command : m_commands) {
+        command_histogram[command.symbol]++;
+        for (size_t i = 0; i < command.insert_length; i++, index++)
+            literal_histograms[literal_histograms.size() > 1 ? literal_context(index) : 0][data[index]]++;
+        if (command.has_distance)
+            distance_histogram[command.distance_symbol]++;
+        index += command.length;
+    }
+
+    Vector<u8> context_map;
+    if (literal_histograms.size() > 1)
+        context_map = cluster_literal_histograms(literal_histograms, settings.max_literal_trees);
+
+    Vector<PrefixCode> literal_codes;
+    for (auto const& histogram : literal_histograms)
+        TRY(literal_codes.try_append(TRY(build_prefix_code(histogram))));
+    auto command_code = TRY(build_prefix_code(command_histogram));
+    auto distance_code = TRY(build_prefix_code(distance_histogram));
+
+    // NBLTYPESL, NBLTYPESI and NBLTYPESD, there is only a single block of each category.
+    TRY(write_variable_length(stream, 1));
+    TRY(write_variable_length(stream, 1));
+    TRY(write_variable_length(stream, 1));
+
+    // NPOSTFIX and NDIRECT
+    TRY(stream.write_bits(0u, 2u));
+    TRY(stream.write_bits(0u, 4u));
+
+    // CMODE of the only literal block type, and NTREESL
+    TRY(stream.write_bits(2u, 2u));
+    TRY(write_variable_length(stream, literal_codes.size()));
+    if (literal_codes.size() > 1)
+        TRY(write_context_map(stream, context_map, literal_codes.size()));
+
+    // NTREESD
+    TRY(write_variable_length(stream, 1));
+
+    for (auto const& code : literal_codes)
+        TRY(write_prefix_code(stream, code));
+    TRY(write_prefix_code(stream, command_code));
+    TRY(write_prefix_code(stream, distance_code));
+
+    index = start;
+    for (auto const& command : m_commands) {
+        TRY(write_symbol(stream, command_code, command.symbol));
+        TRY(stream.write_bits(command.insert_extra, command.insert_extra_bits));
+        TRY(stream.write_bits(command.copy_extra, command.copy_extra_bits));
+
+        for (size_t i = 0; i < command.insert_length; i++, index++)
+            TRY(write_symbol(stream, literal_codes[literal_codes.size() > 1 ? context_map[literal_context(index)] : 0], data[index]));
+
+        if (command.has_distance) {
+            TRY(write_symbol(stream, distance_code, command.distance_symbol));
+            TRY(stream.write_bits(command.distance_extra, command.distance_extra_bits));
+        }
+        index += command.length;
+    }
+
+    return {};
+}
+
+ErrorOr<ByteBuffer> BrotliCompressor::compress_all(ReadonlyBytes bytes, BrotliCompressorOptions const& options)
+{
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto compressor = TRY(BrotliCompressor::create(MaybeOwned<Stream>(*output_stream), options));
+
+    TRY(compressor->write_until_depleted(bytes));
+    TRY(compressor->flush());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer));
+    return buffer;
+}
+
 }
@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/BitStream.h>
+#include <AK/ByteBuffer.h>
 #include <AK/CircularQueue.h>
 #include <AK/FixedArray.h>
+#include <AK/MaybeOwned.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/Vector.h>
 
 namespace Compress {
@@ -162,4 +166,93 @@ private:
     Vector<CanonicalCode> m_distance_codes;
 };
 
+struct BrotliCompressorOptions {
+    // Ranges from 0 to 11. Higher qualities search longer for matches and model the literals more closely, at the cost of speed.
+    // The static dictionary is used from quality 2 onwards, and literals are coded depending on their context from quality 5 onwards.
+    u8 quality { 6 };
+
+    // Back references can reach (1 << window_bits) - 16 bytes back, this has to be in the range from 10 to 24.
+    u8 window_bits { 22 };
+};
+
+// Compresses its input into a Brotli stream (RFC 7932). The input is split into meta-blocks, which get a set of
+// prefix codes of their own, and every meta-block that doesn't shrink is stored uncompressed instead.
+class BrotliCompressor final : public Stream {
+    AK_MAKE_NONCOPYABLE(BrotliCompressor);
+    AK_MAKE_NONMOVABLE(BrotliCompressor);
+
+public:
+    static constexpr u8 max_quality = 11;
+    static constexpr u8 min_window_bits = 10;
+    static constexpr u8 max_window_bits = 24;
+
+    static ErrorOr<NonnullOwnPtr<BrotliCompressor>> create(MaybeOwned<Stream>, BrotliCompressorOptions const& = {});
+    ~BrotliCompressor();
+
+    /// Finishes the stream by compressing the remaining input and writing out the final meta-block.
+    /// This has to be called once all of the input has been written.
+    ErrorOr<void> flush();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes, BrotliCompressorOptions const& = {});
+
+private:
+    static constexpr size_t meta_block_size = 256 * KiB;
+
+    struct Match {
+        size_t length { 0 };      // The number of bytes that are produced by the copy.
+        size_t copy_length { 0 }; // This differs from the length for dictionary words, which get transformed.
+        size_t distance { 0 };
+        bool is_dictionary_word { false };
+        i64 score { 0 };
+    };
+
+    struct Command {
+        u32 insert_length;
+        u32 length; // The number of bytes that are produced by the copy, which may differ from the encoded copy length.
+        u16 symbol;
+        u16 distance_symbol; // Only written if the command doesn't use the implicit last distance and isn't the final one.
+        u32 insert_extra;
+        u32 copy_extra;
+        u32 distance_extra;
+        u8 insert_extra_bits;
+        u8 copy_extra_bits;
+        u8 distance_extra_bits;
+        bool has_distance;
+    };
+
+    BrotliCompressor(MaybeOwned<Stream>, BrotliCompressorOptions const&);
+
+    size_t max_backward_distance() const { return (1u << m_options.window_bits) - 16; }
+
+    void insert_hashes_until(size_t index);
+    Optional<Match> find_match(size_t index, size_t max_length);
+    void emit_command(size_t insert_length, Optional<Match> const&);
+
+    ErrorOr<void> compress_meta_block(size_t length);
+    ErrorOr<void> write_compressed_meta_block_contents(LittleEndianOutputBitStream&, size_t start);
+
+    LittleEndianOutputBitStream m_output_stream;
+    BrotliCompressorOptions m_options;
+    bool m_has_flushed_data { false };
+
+    // Holds (at most a few windows of) history followed by the input that hasn't been compressed yet.
+    ByteBuffer m_buffer;
+    u64 m_buffer_position { 0 }; // The position of the first byte in the buffer, relative to the start of the input.
+    size_t m_pending_start { 0 };
+
+    // Every hash bucket holds the most recent positions (relative to the start of the input) that had the same hash.
+    Vector<u32> m_hash_buckets;
+    Vector<u32> m_hash_bucket_sizes;
+    size_t m_next_index_to_hash { 0 };
+
+    Array<size_t, 4> m_distances { 4, 11, 15, 16 };
+    Vector<Command> m_commands;
+};
+
 }
@@ -4,7 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/CharacterTypes.h>
+#include <AK/NumericLimits.h>
 #include <AK/Types.h>
+#include <AK/Vector.h>
 #include <LibCompress/BrotliDictionary.h>
 
 // Include the 119.9 KiB of dictionary data from a binary file
@@ -206,13 +210,189 @@ constexpr static BrotliDictionary::Transformation transformations[121] {
     { " "sv, FermentFirst, 0, "='"sv },       // 120          " "     FermentFirst           "='"
 };
 
+static constexpr size_t minimum_word_length = 4;
+static constexpr size_t maximum_word_length = 24;
+static constexpr size_t word_hash_bits = 15;
+
+static ReadonlyBytes base_word(size_t length, size_t word_index)
+{
+    return { brotli_dictionary_data + offset_by_length[length] + (word_index * length), length };
+}
+
+// The largest number of bytes that an OmitLast transformation removes from the end of a word.
+static constexpr size_t maximum_omitted_length = 9;
+
+static u32 lowercase_prefix(ReadonlyBytes bytes)
+{
+    u32 value = 0;
+    for (size_t i = 0; i < minimum_word_length; i++)
+        value = (value << 8) | to_ascii_lowercase(bytes[i]);
+    return value;
+}
+
+static u32 word_hash(u32 prefix)
+{
+    // Words are hashed by their first four bytes, ignoring ASCII case so that fermented words can be found as well.
+    return (prefix * 0x1e35a7bd) >> (32 - word_hash_bits);
+}
+
+namespace {
+
+// Chains all dictionary words by their hash, for the compressor to find them in its input.
+struct WordIndex {
+    static constexpr u16 no_entry = NumericLimits<u16>::max();
+
+    struct Entry {
+        u32 prefix;
+        u8 length;
+        u16 word_index;
+        u16 next;
+    };
+
+    WordIndex()
+    {
+        buckets.fill(no_entry);
+        for (size_t length = minimum_word_length; length <= maximum_word_length; length++) {
+            for (size_t word_index = 0; word_index < (1u << bits_by_length[length]); word_index++) {
+                auto prefix = lowercase_prefix(base_word(length, word_index));
+                auto& bucket = buckets[word_hash(prefix)];
+                entries.append({ prefix, static_cast<u8>(length), static_cast<u16>(word_index), bucket });
+                bucket = entries.size() - 1;
+            }
+        }
+
+        for (size_t transformation_id = 0; transformation_id < array_size(transformations); transformation_id++) {
+            auto const& transformation = transformations[transformation_id];
+            if (!transformation.prefix.is_empty())
+                continue;
+
+            auto group = find_if(transformation_groups.begin(), transformation_groups.end(), [&](auto const& group) {
+                return group.operation == transformation.operation && group.operation_data == transformation.operation_data;
+            });
+            if (group == transformation_groups.end()) {
+                transformation_groups.append({ transformation.operation, transformation.operation_data, {} });
+                group = --transformation_groups.end();
+            }
+            group->transformation_ids.append(transformation_id);
+        }
+    }
+
+    // The transformations without a prefix, grouped by their operation, so that the suffixes only have to be
+    // checked if the transformed word itself matches.
+    struct TransformationGroup {
+        BrotliDictionary::TransformationOperation operation;
+        u8 operation_data;
+        Vector<u8> transformation_ids;
+    };
+
+    Array<u16, 1 << word_hash_bits> buckets;
+    Vector<Entry> entries;
+    Vector<TransformationGroup> transformation_groups;
+};
+
+}
+
+static WordIndex const& word_index()
+{
+    static WordIndex const index;
+    return index;
+}
+
+static bool matches_fermented_first(ReadonlyBytes data, ReadonlyBytes word)
+{
+    // Only ASCII letters are considered here, fermenting any other first byte either doesn't change it or changes the bytes after it.
+    if (word.size() > data.size() || !is_ascii_lower_alpha(word[0]))
+        return false;
+    return data[0] == (word[0] ^ 32) && data.slice(1, word.size() - 1) == word.slice(1);
+}
+
+static bool matches_fermented_all(ReadonlyBytes data, ReadonlyBytes word)
+{
+    if (word.size() > data.size())
+        return false;
+    for (size_t i = 0; i < word.size(); i++) {
+        if (word[i] >= 192)
+            return false;
+        if (data[i] != (is_ascii_lower_alpha(word[i]) ? word[i] ^ 32 : word[i]))
+            return false;
+    }
+    return true;
+}
+
+Optional<BrotliDictionary::Match> BrotliDictionary::find_longest_match(ReadonlyBytes data)
+{
+    if (data.size() < minimum_word_length)
+        return {};
+
+    auto const& index = word_index();
+    auto prefix = lowercase_prefix(data);
+    Optional<Match> best_match;
+
+    for (auto entry_index = index.buckets[word_hash(prefix)]; entry_index != WordIndex::no_entry; entry_index = index.entries[entry_index].next) {
+        auto const& entry = index.entries[entry_index];
+        if (entry.prefix != prefix)
+            continue;
+
+        auto word = base_word(entry.length, entry.word_index);
+
+        size_t identity_length = 0;
+        while (identity_length < min(word.size(), data.size()) && data[identity_length] == word[identity_length])
+            identity_length++;
+        bool ferment_first_matches = matches_fermented_first(data, word);
+        bool ferment_all_matches = matches_fermented_all(data, word);
+
+        // Most words in a bucket only share the hash (or their first few bytes) with the data, and no transformation can match them.
+        if (!ferment_first_matches && !ferment_all_matches && identity_length + maximum_omitted_length < word.size())
+            continue;
+
+        for (auto const& group : index.transformation_groups) {
+            size_t length = 0;
+            switch (group.operation) {
+            case TransformationOperation::Identity:
+                if (identity_length != word.size())
+                    continue;
+                length = word.size();
+                break;
+            case TransformationOperation::FermentFirst:
+                if (!ferment_first_matches)
+                    continue;
+                length = word.size();
+                break;
+            case TransformationOperation::FermentAll:
+                if (!ferment_all_matches)
+                    continue;
+                length = word.size();
+                break;
+            case TransformationOperation::OmitFirst:
+                continue;
+            case TransformationOperation::OmitLast:
+                if (group.operation_data >= word.size() || identity_length < word.size() - group.operation_data)
+                    continue;
+                length = word.size() - group.operation_data;
+                break;
+            }
+
+            for (auto transformation_id : group.transformation_ids) {
+                auto suffix = transformations[transformation_id].suffix.bytes();
+                if (!data.slice(length).starts_with(suffix))
+                    continue;
+                if (best_match.has_value() && best_match->length >= length + suffix.size())
+                    continue;
+                best_match = Match { length + suffix.size(), word.size(), (transformation_id << bits_by_length[word.size()]) | entry.word_index };
+            }
+        }
+    }
+
+    return best_match;
+}
+
 ErrorOr<ByteBuffer> BrotliDictionary::lookup_word(size_t index, size_t length)
 {
-    if (length < 4 || length > 24)
+    if (length < minimum_word_length || length > maximum_word_length)
         return Error::from_string_literal("invalid dictionary lookup length");
 
     size_t word_index = index % (1 << bits_by_length[length]);
-    ReadonlyBytes base_word { brotli_dictionary_data + offset_by_length[length] + (word_index * length), length };
+    auto word = base_word(length, word_index);
     size_t transform_id = index >> bits_by_length[length];
 
     if (transform_id >= 121)
@@ -225,23 +405,23 @@ ErrorOr<ByteBuffer> BrotliDictionary::lookup_word(size_t index, size_t length)
 
     switch (transformation.operation) {
     case TransformationOperation::Identity:
-        bb.append(base_word);
+        bb.append(word);
         break;
     case TransformationOperation::FermentFirst:
-        bb.append(base_word);
+        bb.append(word);
         ferment_first(bb.bytes().slice(prefix_length));
         break;
     case TransformationOperation::FermentAll:
-        bb.append(base_word);
+        bb.append(word);
         ferment_all(bb.bytes().slice(prefix_length));
         break;
     case TransformationOperation::OmitFirst:
-        if (transformation.operation_data < base_word.size())
-            bb.append(base_word.slice(transformation.operation_data));
+        if (transformation.operation_data < word.size())
+            bb.append(word.slice(transformation.operation_data));
         break;
     case TransformationOperation::OmitLast:
-        if (transformation.operation_data < base_word.size())
-            bb.append(base_word.slice(0, base_word.size() - transformation.operation_data));
+        if (transformation.operation_data < word.size())
+            bb.append(word.slice(0, word.size() - transformation.operation_data));
         break;
     }
 
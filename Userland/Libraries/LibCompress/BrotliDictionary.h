@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
 
 namespace Compress {
 
@@ -26,6 +27,17 @@ public:
         StringView suffix;
     };
 
+    struct Match {
+        size_t length { 0 };      // The number of input bytes that are covered by the transformed word.
+        size_t word_length { 0 }; // The length of the untransformed word, which is what a copy command has to specify.
+        size_t index { 0 };       // The word index including the transformation, as expected by lookup_word().
+    };
+
+    // Finds the longest transformed word that the data starts with. Only transformations without a prefix whose
+    // operation is Identity, FermentFirst, FermentAll or OmitLast are considered, since these are the ones that
+    // can be looked up by the start of the word.
+    static Optional<Match> find_longest_match(ReadonlyBytes data);
+
     static ErrorOr<ByteBuffer> lookup_word(size_t index, size_t length);
 };
 
@@ -9,7 +9,10 @@
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
 #include <AK/BinarySearch.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/MemoryStream.h>
+#include <AK/NumericLimits.h>
+#include <AK/TemporaryChange.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
@@ -22,29 +25,15 @@ static constexpr u8 deflate_special_code_length_long_zeros = 18;
 
 CanonicalCode const& CanonicalCode::fixed_literal_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths));
-    initialized = true;
-
+    // This is shared by all compressors, including the ones that are running on ParallelDeflateCompressor's worker threads.
+    static CanonicalCode const code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths));
     return code;
 }
 
 CanonicalCode const& CanonicalCode::fixed_distance_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths));
-    initialized = true;
-
+    // This is shared by all compressors, including the ones that are running on ParallelDeflateCompressor's worker threads.
+    static CanonicalCode const code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths));
     return code;
 }
 
@@ -143,7 +132,25 @@ ErrorOr<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 
 ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
 {
-    auto prefix = TRY(stream.peek_bits<size_t>(m_max_prefixed_code_length));
+    auto prefix_or_error = stream.peek_bits<size_t>(m_max_prefixed_code_length);
+    if (prefix_or_error.is_error()) [[unlikely]] {
+        // The last symbol of a stream may be shorter than the prefix, with nothing (not even padding) left after it.
+        for (auto available_bits = m_max_prefixed_code_length - 1; available_bits > 0; --available_bits) {
+            auto partial_prefix_or_error = stream.peek_bits<size_t>(available_bits);
+            if (partial_prefix_or_error.is_error())
+                continue;
+
+            // Every entry is repeated for all values of the bits that come after its code, so the missing bits don't matter.
+            auto [symbol_value, code_length] = m_prefix_table[partial_prefix_or_error.value()];
+            if (code_length == 0 || code_length > available_bits)
+                break;
+
+            stream.discard_previously_peeked_bits(code_length);
+            return symbol_value;
+        }
+        return prefix_or_error.release_error();
+    }
+    auto prefix = prefix_or_error.release_value();
 
     if (auto [symbol_value, code_length] = m_prefix_table[prefix]; code_length != 0) {
         stream.discard_previously_peeked_bits(code_length);
@@ -466,6 +473,8 @@ ErrorOr<NonnullOwnPtr<DeflateCompressor>> DeflateCompressor::construct(MaybeOwne
 {
     auto bit_stream = TRY(try_make<LittleEndianOutputBitStream>(move(stream)));
     auto deflate_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateCompressor(move(bit_stream), compression_level)));
+    if (deflate_compressor->m_compression_constants.parsing_strategy == ParsingStrategy::Optimal)
+        TRY(deflate_compressor->m_optimal_parse_nodes.try_resize(block_size + 1));
     return deflate_compressor;
 }
 
@@ -527,23 +536,39 @@ u16 DeflateCompressor::hash_sequence(u8 const* bytes)
     return ((bytes[0] | bytes[1] << 8 | bytes[2] << 16 | bytes[3] << 24) * knuth_constant) >> (32 - hash_bits);
 }
 
+// Returns the length of the common prefix of a and b (which is at most maximum_length long), comparing a whole word at a time
+static ALWAYS_INLINE size_t common_prefix_length(u8 const* a, u8 const* b, size_t maximum_length)
+{
+    size_t length = 0;
+    while (length + sizeof(u64) <= maximum_length) {
+        u64 a_word;
+        u64 b_word;
+        __builtin_memcpy(&a_word, a + length, sizeof(u64));
+        __builtin_memcpy(&b_word, b + length, sizeof(u64));
+        // the lowest set bit of the difference belongs to the first byte that differs
+        auto difference = AK::convert_between_host_and_little_endian(a_word ^ b_word);
+        if (difference != 0)
+            return length + count_trailing_zeroes(difference) / 8;
+        length += sizeof(u64);
+    }
+    while (length < maximum_length && a[length] == b[length])
+        length++;
+    return length;
+}
+
 size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate, size_t previous_match_length, size_t maximum_match_length)
 {
     VERIFY(previous_match_length < maximum_match_length);
 
-    // We firstly check that the match is at least (prev_match_length + 1) long, we check backwards as there's a higher chance the end mismatches
-    for (ssize_t i = previous_match_length; i >= 0; i--) {
-        if (m_rolling_window[start + i] != m_rolling_window[candidate + i])
-            return 0;
-    }
+    // We firstly check the byte right after the previous match, as that's the one that most likely mismatches
+    if (m_rolling_window[start + previous_match_length] != m_rolling_window[candidate + previous_match_length])
+        return 0;
 
     // Find the actual length
-    auto match_length = previous_match_length + 1;
-    while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
-        match_length++;
-    }
+    auto match_length = common_prefix_length(&m_rolling_window[start], &m_rolling_window[candidate], maximum_match_length);
+    if (match_length <= previous_match_length)
+        return 0;
 
-    VERIFY(match_length > previous_match_length);
     VERIFY(match_length <= maximum_match_length);
     return match_length;
 }
@@ -567,7 +592,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_back_reference_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -577,8 +602,8 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             match_position = candidate;
             previous_match_length = match_length;
 
-            if (match_length == maximum_match_length)
-                return match_length; // bail if we got the maximum possible length
+            if (match_length == maximum_match_length || match_length >= m_compression_constants.great_match_length)
+                return match_length; // bail if we got the maximum possible length, or one that's long enough
         }
 
         candidate = m_hash_prev[candidate % window_size];
@@ -665,48 +690,112 @@ void DeflateCompressor::generate_huffman_lengths(Array<u8, Size>& lengths, Array
     }
 }
 
-void DeflateCompressor::lz77_compress_block()
+void DeflateCompressor::reset_hash_table()
 {
     for (auto& slot : m_hash_head) { // initialize chained hash table
         slot = empty_slot;
     }
 
-    auto insert_hash = [&](auto pos, auto hash) {
-        auto window_pos = pos % window_size;
-        m_hash_prev[window_pos] = m_hash_head[hash];
-        m_hash_head[hash] = window_pos;
-    };
+    // index the history preceding the block first, so that back references can reach into it
+    auto block_end = block_size + m_pending_block_size;
+    for (size_t position = block_size - m_history_size; position < block_size && position + min_match_length <= block_end; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+}
 
-    auto emit_literal = [&](auto literal) {
-        VERIFY(m_pending_symbol_size <= block_size + 1);
-        auto index = m_pending_symbol_size++;
-        m_symbol_buffer[index].distance = 0;
-        m_symbol_buffer[index].literal = literal;
-        m_symbol_frequencies[literal]++;
-    };
+ALWAYS_INLINE void DeflateCompressor::insert_hash(size_t position, u16 hash)
+{
+    auto window_position = position % window_size;
+    m_hash_prev[window_position] = m_hash_head[hash];
+    m_hash_head[hash] = window_position;
+}
 
-    auto emit_back_reference = [&](auto distance, auto length) {
-        VERIFY(m_pending_symbol_size <= block_size + 1);
-        auto index = m_pending_symbol_size++;
-        m_symbol_buffer[index].distance = distance;
-        m_symbol_buffer[index].length = length;
-        m_symbol_frequencies[length_to_symbol[length]]++;
-        m_distance_frequencies[distance_to_base(distance)]++;
-    };
+ALWAYS_INLINE void DeflateCompressor::emit_literal(u16 literal)
+{
+    VERIFY(m_pending_symbol_size <= block_size + 1);
+    auto index = m_pending_symbol_size++;
+    m_symbol_buffer[index].distance = 0;
+    m_symbol_buffer[index].literal = literal;
+    m_symbol_frequencies[literal]++;
+}
 
-    size_t previous_match_length = 0;
-    size_t previous_match_position = 0;
+ALWAYS_INLINE void DeflateCompressor::emit_back_reference(u16 distance, u16 length)
+{
+    VERIFY(m_pending_symbol_size <= block_size + 1);
+    auto index = m_pending_symbol_size++;
+    m_symbol_buffer[index].distance = distance;
+    m_symbol_buffer[index].length = length;
+    m_symbol_frequencies[length_to_symbol[length]]++;
+    m_distance_frequencies[distance_to_base(distance)]++;
+}
 
+void DeflateCompressor::lz77_compress_block()
+{
     VERIFY(m_compression_constants.great_match_length <= max_match_length);
 
+    reset_hash_table();
+
+    switch (m_compression_constants.parsing_strategy) {
+    case ParsingStrategy::Greedy:
+        greedy_compress_block();
+        break;
+    case ParsingStrategy::Lazy:
+        lazy_compress_block();
+        break;
+    case ParsingStrategy::Optimal:
+        optimal_compress_block();
+        break;
+    }
+}
+
+void DeflateCompressor::greedy_compress_block()
+{
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
+
+    size_t current_position;
+    for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
+        auto hash = hash_sequence(&m_rolling_window[current_position]);
+        size_t match_position;
+        auto match_length = find_back_match(current_position, hash, 0, min(max_match_length, block_end - current_position), match_position);
+
+        insert_hash(current_position, hash);
+
+        if (match_length == 0) {
+            emit_literal(m_rolling_window[current_position]);
+            continue;
+        }
+
+        emit_back_reference(current_position - match_position, match_length);
+
+        // only index the bytes that are included in this match if it's a short one, as that's where most of the time would go otherwise
+        if (match_length <= m_compression_constants.max_lazy_length) {
+            for (size_t j = current_position + 1; j < min(current_position + match_length, block_end - min_match_length + 1); j++) {
+                insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            }
+        }
+        current_position += match_length - 1;
+    }
+
+    // output remaining literals
+    while (current_position < block_end) {
+        emit_literal(m_rolling_window[current_position++]);
+    }
+}
+
+void DeflateCompressor::lazy_compress_block()
+{
+    // our block starts at block_size and is m_pending_block_size in length
+    auto block_end = block_size + m_pending_block_size;
+
+    size_t previous_match_length = 0;
+    size_t previous_match_position = 0;
+
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
         size_t match_position;
         auto match_length = find_back_match(current_position, hash, previous_match_length,
-            min(m_compression_constants.great_match_length, block_end - current_position), match_position);
+            min(max_match_length, block_end - current_position), match_position);
 
         insert_hash(current_position, hash);
 
@@ -750,6 +839,112 @@ void DeflateCompressor::lz77_compress_block()
     }
 }
 
+void DeflateCompressor::optimal_compress_block()
+{
+    // Estimate how many bits every symbol is going to take, based on how often they occur in a (cheaper) lazy parse of the block.
+    // Every symbol is counted once more, so that the ones that the lazy parse didn't use don't look free.
+    {
+        TemporaryChange lazy_constants { m_compression_constants, compression_constants[to_underlying(CompressionLevel::GOOD)] };
+        lazy_compress_block();
+    }
+
+    Array<u16, max_huffman_literals> symbol_frequencies;
+    for (size_t i = 0; i < max_huffman_literals; i++)
+        symbol_frequencies[i] = m_symbol_frequencies[i] + 1;
+    Array<u16, max_huffman_distances> distance_frequencies;
+    for (size_t i = 0; i < max_huffman_distances; i++)
+        distance_frequencies[i] = m_distance_frequencies[i] + 1;
+
+    Array<u8, max_huffman_literals> symbol_costs {};
+    Array<u8, max_huffman_distances> distance_costs {};
+    generate_huffman_lengths(symbol_costs, symbol_frequencies, 15);
+    generate_huffman_lengths(distance_costs, distance_frequencies, 15);
+
+    auto length_cost = [&](size_t length) -> u32 {
+        auto symbol = length_to_symbol[length];
+        return symbol_costs[symbol] + packed_length_symbols[symbol - 257].extra_bits;
+    };
+    auto distance_cost = [&](size_t distance) -> u32 {
+        auto base = distance_to_base(distance);
+        return distance_costs[base] + packed_distances[base].extra_bits;
+    };
+
+    // Start over, this time with the real parse.
+    m_pending_symbol_size = 0;
+    m_symbol_frequencies.fill(0);
+    m_distance_frequencies.fill(0);
+    reset_hash_table();
+
+    auto block_end = block_size + m_pending_block_size;
+    auto& nodes = m_optimal_parse_nodes;
+    VERIFY(nodes.size() >= m_pending_block_size + 1);
+    nodes[0] = { 0, 0, 0 };
+    for (size_t i = 1; i <= m_pending_block_size; i++)
+        nodes[i] = { NumericLimits<u32>::max(), 0, 0 };
+
+    auto relax = [&](size_t index, u32 cost, u16 length, u16 distance) {
+        if (cost < nodes[index].cost)
+            nodes[index] = { cost, length, distance };
+    };
+
+    // Find the cheapest way to reach every position of the block, going forwards.
+    for (size_t current_position = block_size; current_position < block_end; current_position++) {
+        auto index = current_position - block_size;
+        auto cost = nodes[index].cost;
+        relax(index + 1, cost + symbol_costs[m_rolling_window[current_position]], 1, 0);
+
+        if (current_position + min_match_length > block_end)
+            continue;
+
+        auto hash = hash_sequence(&m_rolling_window[current_position]);
+        auto maximum_match_length = min(max_match_length, block_end - current_position);
+
+        // Unlike the other parsers, we care about every match that's longer than the ones before it, not just the longest one,
+        // as a shorter but closer match can be cheaper.
+        size_t longest_match_length = min_match_length - 1;
+        auto candidate = m_hash_head[hash];
+        for (auto chain_length = m_compression_constants.max_chain; chain_length > 0 && candidate != empty_slot; chain_length--) {
+            VERIFY(candidate < current_position);
+            auto distance = current_position - candidate;
+            if (distance > max_back_reference_distance)
+                break; // outside the window
+
+            auto match_length = compare_match_candidate(current_position, candidate, longest_match_length, maximum_match_length);
+            if (match_length != 0) {
+                auto match_distance_cost = cost + distance_cost(distance);
+                for (auto length = longest_match_length + 1; length <= match_length; length++)
+                    relax(index + length, match_distance_cost + length_cost(length), length, distance);
+                longest_match_length = match_length;
+
+                if (match_length == maximum_match_length || match_length >= m_compression_constants.great_match_length)
+                    break;
+            }
+
+            candidate = m_hash_prev[candidate % window_size];
+        }
+
+        insert_hash(current_position, hash);
+
+        // Searching for matches inside of a long match takes a lot of time, but rarely finds anything better, so skip over it.
+        if (longest_match_length >= m_compression_constants.great_match_length) {
+            for (size_t j = current_position + 1; j < min(current_position + longest_match_length, block_end - min_match_length + 1); j++)
+                insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            current_position += longest_match_length - 1;
+        }
+    }
+
+    // Walk back from the end of the block to find the symbols along the cheapest path, which we emit in reverse order.
+    for (auto index = m_pending_block_size; index > 0; index -= nodes[index].length) {
+        auto const& node = nodes[index];
+        if (node.distance == 0)
+            emit_literal(m_rolling_window[block_size + index - 1]);
+        else
+            emit_back_reference(node.distance, node.length);
+    }
+    for (size_t i = 0; i < m_pending_symbol_size / 2; i++)
+        swap(m_symbol_buffer[i], m_symbol_buffer[m_pending_symbol_size - i - 1]);
+}
+
 size_t DeflateCompressor::huffman_block_length(Array<u8, max_huffman_literals> const& literal_bit_lengths, Array<u8, max_huffman_distances> const& distance_bit_lengths)
 {
     size_t length = 0;
@@ -1013,16 +1208,38 @@ ErrorOr<void> DeflateCompressor::flush()
         TRY(m_output_stream->align_to_byte_boundary());
 
     // reset all block specific members
+    keep_pending_block_as_history();
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
 
     return {};
 }
 
+void DeflateCompressor::keep_pending_block_as_history()
+{
+    if (!m_compression_constants.index_previous_block) {
+        // Indexing the previous block costs a lot of time, so at these levels only the first block gets to reach back (into its dictionary)
+        m_history_size = 0;
+        return;
+    }
+
+    // Move the most recent (up to block_size) bytes of input so that they end right where the next pending block starts
+    auto history_size = min(m_history_size + m_pending_block_size, block_size);
+    memmove(m_rolling_window + block_size - history_size, m_rolling_window + block_size + m_pending_block_size - history_size, history_size);
+    m_history_size = history_size;
+}
+
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(m_pending_block_size == 0 && m_history_size == 0);
+
+    dictionary = dictionary.slice(dictionary.size() - min(dictionary.size(), block_size));
+    dictionary.copy_to({ m_rolling_window + block_size - dictionary.size(), dictionary.size() });
+    m_history_size = dictionary.size();
+}
+
 ErrorOr<void> DeflateCompressor::final_flush()
 {
     VERIFY(!m_finished);
@@ -1032,6 +1249,23 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+ErrorOr<void> DeflateCompressor::final_sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+
+    // an empty, non-final uncompressed block gets us to a byte boundary (this is what zlib calls a sync flush)
+    TRY(m_output_stream->write_bits(0b000u, 3));
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+
+    m_finished = true;
+    TRY(m_output_stream->flush_buffer_to_stream());
+    return {};
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
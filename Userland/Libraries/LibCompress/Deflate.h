@@ -138,22 +138,32 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
+    enum class ParsingStrategy {
+        Greedy,  // Take the longest match at every position, and don't index the inside of long matches
+        Lazy,    // Check whether the next position has a longer match before committing to one
+        Optimal, // Pick the cheapest sequence of literals and matches for the block, based on the bit costs of its symbols
+    };
+
     struct CompressionConstants {
         size_t good_match_length;  // Once we find a match of at least this length (a good enough match) we reduce max_chain to lower processing time
         size_t max_lazy_length;    // If the match is at least this long we dont defer matching to the next byte (which takes time) as its good enough
+                                   // (the greedy parser only indexes the positions inside of matches that are at most this long)
         size_t great_match_length; // Once we find a match of at least this length (a great match) we can just stop searching for longer ones
         size_t max_chain;          // We only check the actual length of the max_chain closest matches
+        ParsingStrategy parsing_strategy;
+        bool index_previous_block; // Let back references reach into the previous block (smaller output, but about 25% slower)
     };
 
     // These constants were shamelessly "borrowed" from zlib
     static constexpr CompressionConstants compression_constants[] = {
-        { 0, 0, 0, 0 },
-        { 4, 4, 8, 4 },
-        { 8, 16, 128, 128 },
-        { 32, 258, 258, 4096 },
-        { max_match_length, max_match_length, max_match_length, 1 << hash_bits } // disable all limits
+        { 0, 0, 0, 0, ParsingStrategy::Greedy, false },
+        { 4, 4, 8, 4, ParsingStrategy::Greedy, false },
+        { 8, 16, 128, 128, ParsingStrategy::Lazy, false },
+        { 32, 258, 258, 4096, ParsingStrategy::Lazy, true },
+        { max_match_length, max_match_length, 128, 256, ParsingStrategy::Optimal, true }
     };
 
     enum class CompressionLevel : int {
@@ -161,7 +171,7 @@ public:
         FAST,
         GOOD,
         GREAT,
-        BEST // WARNING: this one can take an unreasonable amount of time!
+        BEST // WARNING: this one is a lot slower than the others!
     };
 
     static ErrorOr<NonnullOwnPtr<DeflateCompressor>> construct(MaybeOwned<Stream>, CompressionLevel = CompressionLevel::GOOD);
@@ -174,18 +184,34 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Ends the stream on a byte boundary without marking any block as the final one, so that another deflate
+    // stream can be appended to the output (this is how ParallelDeflateCompressor stitches its chunks together).
+    ErrorOr<void> final_sync_flush();
+
+    // Primes the window with (up to block_size bytes of) the data that comes right before the input, so that
+    // back references can point into it. This must be called before anything is written.
+    void set_dictionary(ReadonlyBytes);
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
     DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionLevel = CompressionLevel::GOOD);
 
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
+    void keep_pending_block_as_history();
 
     // LZ77 Compression
     static u16 hash_sequence(u8 const* bytes);
     size_t compare_match_candidate(size_t start, size_t candidate, size_t prev_match_length, size_t max_match_length);
     size_t find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t max_match_length, size_t& match_position);
+    void reset_hash_table();
+    void insert_hash(size_t position, u16 hash);
+    void emit_literal(u16 literal);
+    void emit_back_reference(u16 distance, u16 length);
     void lz77_compress_block();
+    void greedy_compress_block();
+    void lazy_compress_block();
+    void optimal_compress_block();
 
     // Huffman Coding
     struct code_length_symbol {
@@ -213,6 +239,7 @@ private:
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    size_t m_history_size { 0 }; // the number of bytes right before the pending block that back references may point into
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
@@ -228,6 +255,14 @@ private:
     // LZ77 Chained hash table
     u16 m_hash_head[1 << hash_bits];
     u16 m_hash_prev[window_size];
+
+    // Only used by the optimal parser: the cheapest known way to reach every position of the pending block
+    struct OptimalParseNode {
+        u32 cost;     // in bits
+        u16 length;   // of the literal (1) or back reference that reaches this position
+        u16 distance; // of that back reference, or 0 for a literal
+    };
+    Vector<OptimalParseNode> m_optimal_parse_nodes;
 };
 
 }
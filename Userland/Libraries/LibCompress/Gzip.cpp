@@ -194,12 +194,20 @@ GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream)
 {
 }
 
+GzipCompressor::~GzipCompressor()
+{
+    if (m_parallel_compressor) {
+        // Note: We need a better API for specifying things like this.
+        finish().release_value_but_fixme_should_propagate_errors();
+    }
+}
+
 ErrorOr<Bytes> GzipCompressor::read_some(Bytes)
 {
     return Error::from_errno(EBADF);
 }
 
-ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
+ErrorOr<void> GzipCompressor::write_header(Stream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -209,7 +217,28 @@ ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    TRY(m_output_stream->write_until_depleted({ &header, sizeof(header) }));
+    TRY(stream.write_until_depleted({ &header, sizeof(header) }));
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<GzipCompressor>> GzipCompressor::create_parallel(MaybeOwned<Stream> stream, size_t thread_count)
+{
+    auto compressor = TRY(try_make<GzipCompressor>(move(stream)));
+    TRY(write_header(*compressor->m_output_stream));
+    compressor->m_parallel_compressor = TRY(ParallelDeflateCompressor::construct(MaybeOwned(*compressor->m_output_stream), thread_count));
+    return compressor;
+}
+
+ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
+{
+    if (m_parallel_compressor) {
+        TRY(m_parallel_compressor->write_until_depleted(bytes));
+        m_checksum.update(bytes);
+        m_input_size += bytes.size();
+        return bytes.size();
+    }
+
+    TRY(write_header(*m_output_stream));
     auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
     TRY(compressed_stream->write_until_depleted(bytes));
     TRY(compressed_stream->final_flush());
@@ -220,6 +249,19 @@ ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
     return bytes.size();
 }
 
+ErrorOr<void> GzipCompressor::finish()
+{
+    // Outside of parallel mode, every write already is a complete member.
+    if (!m_parallel_compressor)
+        return {};
+
+    auto parallel_compressor = m_parallel_compressor.release_nonnull();
+    TRY(parallel_compressor->final_flush());
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(m_checksum.digest()));
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(m_input_size));
+    return {};
+}
+
 bool GzipCompressor::is_eof() const
 {
     return true;
@@ -246,4 +288,17 @@ ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
     return buffer;
 }
 
+ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, size_t thread_count)
+{
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto gzip_stream = TRY(GzipCompressor::create_parallel(MaybeOwned<Stream>(*output_stream), thread_count));
+
+    TRY(gzip_stream->write_until_depleted(bytes));
+    TRY(gzip_stream->finish());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer.bytes()));
+    return buffer;
+}
+
 }
@@ -11,6 +11,7 @@
 #include <AK/OwnPtr.h>
 #include <AK/Stream.h>
 #include <LibCompress/Deflate.h>
+#include <LibCompress/ParallelDeflate.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
 namespace Compress {
@@ -85,16 +86,31 @@ class GzipCompressor final : public Stream {
 public:
     GzipCompressor(MaybeOwned<Stream>);
 
+    // Compresses everything that's written to it into a single member, using `thread_count` threads.
+    // finish() should be called once all of the input has been written, otherwise the destructor has to do it.
+    static ErrorOr<NonnullOwnPtr<GzipCompressor>> create_parallel(MaybeOwned<Stream>, size_t thread_count);
+    ~GzipCompressor();
+
     virtual ErrorOr<Bytes> read_some(Bytes) override;
     virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
     virtual bool is_eof() const override;
     virtual bool is_open() const override;
     virtual void close() override;
 
+    ErrorOr<void> finish();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes);
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, size_t thread_count);
 
 private:
+    static ErrorOr<void> write_header(Stream&);
+
     MaybeOwned<Stream> m_output_stream;
+
+    // Only used in parallel mode, where all writes go into the same member.
+    OwnPtr<ParallelDeflateCompressor> m_parallel_compressor;
+    Crypto::Checksum::CRC32 m_checksum;
+    size_t m_input_size { 0 };
 };
 
 }
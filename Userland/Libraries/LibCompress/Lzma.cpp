@@ -992,7 +992,7 @@ ErrorOr<void> LzmaCompressor::encode_match_type(MatchType match_type)
 ErrorOr<void> LzmaCompressor::encode_once()
 {
     // Check if any of our existing match distances are currently usable.
-    Vector<size_t> const existing_distances {
+    Array<size_t, 4> const existing_distances {
         m_rep0 + normalized_to_real_match_distance_offset,
         m_rep1 + normalized_to_real_match_distance_offset,
         m_rep2 + normalized_to_real_match_distance_offset,
@@ -1007,7 +1007,9 @@ ErrorOr<void> LzmaCompressor::encode_once()
     }
 
     // If we weren't able to find any viable existing offsets, we now have to search the rest of the dictionary for possible new offsets.
-    auto new_distance_result = m_dictionary->find_copy_in_seekback(m_dictionary->used_space(), normalized_to_real_match_length_offset);
+    // New matches of the shortest length rarely save anything over literals (since they carry a whole new distance),
+    // and finding them would need a plain memory search through the entire dictionary, so only look for what the hash table can find.
+    auto new_distance_result = m_dictionary->find_copy_in_seekback(m_dictionary->used_space(), max(normalized_to_real_match_length_offset, SearchableCircularBuffer::HASH_CHUNK_SIZE));
 
     if (new_distance_result.has_value()) {
         auto selected_match = new_distance_result.release_value();
@@ -1214,15 +1216,26 @@ void LzmaDecompressor::close()
 
 ErrorOr<NonnullOwnPtr<LzmaCompressor>> LzmaCompressor::create_container(MaybeOwned<Stream> stream, LzmaCompressorOptions const& options)
 {
-    auto dictionary = TRY(try_make<SearchableCircularBuffer>(TRY(SearchableCircularBuffer::create_empty(options.dictionary_size + largest_real_match_length))));
+    auto header = TRY(LzmaHeader::from_compressor_options(options));
+    TRY(stream->write_value(header));
+
+    return create_raw_stream(move(stream), options);
+}
+
+ErrorOr<NonnullOwnPtr<LzmaCompressor>> LzmaCompressor::create_raw_stream(MaybeOwned<Stream> stream, LzmaCompressorOptions const& options, Optional<MaybeOwned<SearchableCircularBuffer>> dictionary)
+{
+    if (!dictionary.has_value()) {
+        auto new_dictionary = TRY(SearchableCircularBuffer::create_empty(options.dictionary_size + largest_real_match_length));
+        dictionary = TRY(try_make<SearchableCircularBuffer>(move(new_dictionary)));
+    }
+
+    // The input buffer is part of the dictionary, so we need space for at least one full match on top of anything that we can refer back to.
+    VERIFY((*dictionary)->capacity() >= largest_real_match_length);
 
     // "The LZMA Decoder uses (1 << (lc + lp)) tables with CProb values, where each table contains 0x300 CProb values."
     auto literal_probabilities = TRY(FixedArray<Probability>::create(literal_probability_table_size * (1 << (options.literal_context_bits + options.literal_position_bits))));
 
-    auto header = TRY(LzmaHeader::from_compressor_options(options));
-    TRY(stream->write_value(header));
-
-    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) LzmaCompressor(move(stream), options, move(dictionary), move(literal_probabilities))));
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) LzmaCompressor(move(stream), options, dictionary.release_value(), move(literal_probabilities))));
 
     return compressor;
 }
@@ -1266,6 +1279,29 @@ ErrorOr<size_t> LzmaCompressor::write_some(ReadonlyBytes bytes)
     return processed_bytes;
 }
 
+ErrorOr<void> LzmaCompressor::append_output_stream(MaybeOwned<Stream> stream, Optional<u64> uncompressed_size)
+{
+    if (!m_has_flushed_data)
+        return Error::from_string_literal("Appended a new LZMA output stream without flushing the previous one");
+
+    if (m_options.uncompressed_size.has_value() != uncompressed_size.has_value())
+        return Error::from_string_literal("Appending LZMA streams with mismatching uncompressed size status");
+
+    m_stream = move(stream);
+
+    if (uncompressed_size.has_value())
+        *m_options.uncompressed_size += *uncompressed_size;
+
+    // The range decoder gets initialized again for every appended input stream, so start from scratch as well.
+    m_range_encoder_range = 0xFFFFFFFF;
+    m_range_encoder_code = 0;
+    m_range_encoder_cached_byte = 0x00;
+    m_range_encoder_ff_chain_length = 0;
+    m_has_flushed_data = false;
+
+    return {};
+}
+
 ErrorOr<void> LzmaCompressor::flush()
 {
     if (m_has_flushed_data)
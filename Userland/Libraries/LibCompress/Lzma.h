@@ -217,6 +217,13 @@ public:
     /// Creates a compressor for a standalone LZMA container (.lzma file extension, occasionally known as an LZMA 'archive').
     static ErrorOr<NonnullOwnPtr<LzmaCompressor>> create_container(MaybeOwned<Stream>, LzmaCompressorOptions const&);
 
+    /// Creates a compressor for a raw stream of LZMA-compressed data (to be embedded in other file formats).
+    static ErrorOr<NonnullOwnPtr<LzmaCompressor>> create_raw_stream(MaybeOwned<Stream>, LzmaCompressorOptions const&, Optional<MaybeOwned<SearchableCircularBuffer>> dictionary = {});
+
+    /// Continues compressing into a new output stream after the previous one has been flushed, keeping the current state.
+    /// This is the counterpart to `LzmaDecompressor::append_input_stream`.
+    ErrorOr<void> append_output_stream(MaybeOwned<Stream>, Optional<u64> uncompressed_size);
+
     /// Finishes the archive by writing out the remaining data from the range coder.
     ErrorOr<void> flush();
 
@@ -186,4 +186,159 @@ void Lzma2Decompressor::close()
 {
 }
 
+ErrorOr<NonnullOwnPtr<Lzma2Compressor>> Lzma2Compressor::create_raw_stream(MaybeOwned<Stream> stream, LzmaCompressorOptions const& options)
+{
+    // The smallest dictionary that XZ (and the decoders based on it) allows for is 4 KiB.
+    if (options.dictionary_size < 4 * KiB)
+        return Error::from_string_literal("LZMA2 dictionary size is too small");
+
+    // LZMA2 limits the number of literal context and position bits to keep the size of the probability tables in check.
+    if (options.literal_context_bits + options.literal_position_bits > 4)
+        return Error::from_string_literal("LZMA2 does not allow for more than 4 literal context and position bits");
+
+    // Validate the model properties early, so that this doesn't fail somewhere in the middle of the stream.
+    TRY(LzmaHeader::encode_model_properties({ options.literal_context_bits, options.literal_position_bits, options.position_bits }));
+
+    // The decompressor can only refer back as far as its dictionary size, which includes any data that is still waiting to be compressed on our side.
+    auto dictionary = TRY(SearchableCircularBuffer::create_empty(options.dictionary_size));
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Lzma2Compressor(move(stream), options, move(dictionary))));
+    TRY(compressor->m_pending_input.try_ensure_capacity(chunk_size));
+    return compressor;
+}
+
+Lzma2Compressor::Lzma2Compressor(MaybeOwned<Stream> stream, LzmaCompressorOptions options, SearchableCircularBuffer dictionary)
+    : m_stream(move(stream))
+    , m_options(move(options))
+    , m_dictionary(move(dictionary))
+{
+}
+
+Lzma2Compressor::~Lzma2Compressor()
+{
+    if (!m_has_flushed_data) {
+        // Note: We need a better API for specifying things like this.
+        flush().release_value_but_fixme_should_propagate_errors();
+    }
+}
+
+ErrorOr<Bytes> Lzma2Compressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> Lzma2Compressor::write_some(ReadonlyBytes bytes)
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Wrote to an LZMA2 stream that has already been flushed");
+
+    auto processed_bytes = min(bytes.size(), chunk_size - m_pending_input.size());
+    TRY(m_pending_input.try_append(bytes.trim(processed_bytes)));
+
+    if (m_pending_input.size() == chunk_size)
+        TRY(compress_pending_chunk());
+
+    return processed_bytes;
+}
+
+ErrorOr<void> Lzma2Compressor::flush()
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Flushed an LZMA2 stream twice");
+
+    if (!m_pending_input.is_empty())
+        TRY(compress_pending_chunk());
+
+    // "0 denotes the end of the file"
+    TRY(m_stream->write_value<u8>(0));
+
+    m_current_lzma_stream = nullptr;
+    m_has_flushed_data = true;
+    return {};
+}
+
+ErrorOr<void> Lzma2Compressor::compress_pending_chunk()
+{
+    auto const uncompressed_size = m_pending_input.size();
+    VERIFY(uncompressed_size > 0 && uncompressed_size <= chunk_size);
+
+    // Continuing with the state from the previous chunk is only possible if that one was an LZMA chunk as well.
+    u8 reset_indicator = 0;
+    if (m_current_lzma_stream) {
+        TRY(m_current_lzma_stream->append_output_stream(MaybeOwned<Stream> { m_compressed_chunk }, uncompressed_size));
+    } else {
+        auto options = m_options;
+        options.uncompressed_size = uncompressed_size;
+        m_current_lzma_stream = TRY(LzmaCompressor::create_raw_stream(MaybeOwned<Stream> { m_compressed_chunk }, options, MaybeOwned<SearchableCircularBuffer> { m_dictionary }));
+        reset_indicator = m_needs_dictionary_reset ? 3 : m_needs_properties ? 2 : 1;
+    }
+
+    // This flushes automatically once the announced size has been reached.
+    TRY(m_current_lzma_stream->write_until_depleted(m_pending_input));
+
+    auto const compressed_size = m_compressed_chunk.used_buffer_size();
+
+    if (compressed_size >= uncompressed_size) {
+        // The data went through the dictionary while compressing it, so it can still be referred to by later chunks.
+        // However, the state of the LZMA stream can't be used anymore, since the decompressor never sees that data.
+        TRY(m_compressed_chunk.discard(compressed_size));
+
+        // "1 denotes a dictionary reset followed by an uncompressed chunk
+        //  2 denotes an uncompressed chunk without a dictionary reset"
+        TRY(m_stream->write_value<u8>(m_needs_dictionary_reset ? 1 : 2));
+        TRY(m_stream->write_value<BigEndian<u16>>(uncompressed_size - 1));
+        TRY(m_stream->write_until_depleted(m_pending_input));
+        m_pending_input.clear();
+
+        // A dictionary reset through an uncompressed chunk still requires new properties for the next LZMA chunk.
+        if (m_needs_dictionary_reset)
+            m_needs_properties = true;
+        m_needs_dictionary_reset = false;
+        m_current_lzma_stream = nullptr;
+        return {};
+    }
+
+    // "0x80-0xff denotes an LZMA chunk, where the lowest 5 bits are used as bit 16-20
+    //  of the uncompressed size minus one, and bit 5-6 indicates what should be reset."
+    TRY(m_stream->write_value<u8>(0x80 | (reset_indicator << 5) | ((uncompressed_size - 1) >> 16)));
+
+    // "LZMA chunks consist of:
+    //   - A 16-bit big-endian value encoding the low 16-bits of the uncompressed size minus one
+    //   - A 16-bit big-endian value encoding the compressed size minus one
+    //   - A properties/lclppb byte if bit 6 in the control byte is set"
+    TRY(m_stream->write_value<BigEndian<u16>>((uncompressed_size - 1) & 0xFFFF));
+    TRY(m_stream->write_value<BigEndian<u16>>(compressed_size - 1));
+    if (reset_indicator >= 2)
+        TRY(m_stream->write_value<u8>(MUST(LzmaHeader::encode_model_properties({ m_options.literal_context_bits, m_options.literal_position_bits, m_options.position_bits }))));
+
+    while (!m_compressed_chunk.is_eof()) {
+        Array<u8, 4096> buffer;
+        auto data = TRY(m_compressed_chunk.read_some(buffer));
+        TRY(m_stream->write_until_depleted(data));
+    }
+
+    m_pending_input.clear();
+
+    m_needs_dictionary_reset = false;
+    m_needs_properties = false;
+    return {};
+}
+
+bool Lzma2Compressor::is_eof() const
+{
+    return true;
+}
+
+bool Lzma2Compressor::is_open() const
+{
+    return !m_has_flushed_data;
+}
+
+void Lzma2Compressor::close()
+{
+    if (!m_has_flushed_data) {
+        // Note: We need a better API for specifying things like this.
+        flush().release_value_but_fixme_should_propagate_errors();
+    }
+}
+
 }
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/CircularBuffer.h>
 #include <AK/MaybeOwned.h>
+#include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
 #include <AK/Stream.h>
 #include <LibCompress/Lzma.h>
 
@@ -43,4 +46,48 @@ private:
     Optional<LzmaDecompressorOptions> m_last_lzma_options;
 };
 
+class Lzma2Compressor : public Stream {
+public:
+    // Every chunk covers this much uncompressed data, which keeps the compressed size of a chunk within
+    // the 64 KiB limit of LZMA2 unless the data is incompressible (in which case it's stored uncompressed).
+    // This is a multiple of 16, so that state resets always happen at the same position as in other implementations.
+    static constexpr size_t chunk_size = 64 * KiB;
+
+    /// Creates a compressor that does not write the leading byte indicating the dictionary size.
+    /// The options' uncompressed size is ignored, as every chunk carries its own size.
+    static ErrorOr<NonnullOwnPtr<Lzma2Compressor>> create_raw_stream(MaybeOwned<Stream>, LzmaCompressorOptions const&);
+
+    /// Finishes the stream by compressing the remaining input and writing the end marker.
+    ErrorOr<void> flush();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    virtual ~Lzma2Compressor();
+
+private:
+    Lzma2Compressor(MaybeOwned<Stream>, LzmaCompressorOptions, SearchableCircularBuffer dictionary);
+
+    ErrorOr<void> compress_pending_chunk();
+
+    MaybeOwned<Stream> m_stream;
+    LzmaCompressorOptions m_options;
+    bool m_has_flushed_data { false };
+
+    ByteBuffer m_pending_input;
+
+    // The dictionary is shared between all chunks, and has to outlive the compressor that refers to it.
+    SearchableCircularBuffer m_dictionary;
+    bool m_needs_dictionary_reset { true };
+    bool m_needs_properties { true };
+
+    // This is only kept around while consecutive chunks can continue with the same state.
+    // Its output is collected here first, since the header of a chunk depends on the compressed size.
+    AllocatingMemoryStream m_compressed_chunk;
+    OwnPtr<LzmaCompressor> m_current_lzma_stream;
+};
+
 }
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <LibCompress/ParallelDeflate.h>
+
+namespace Compress {
+
+ErrorOr<NonnullOwnPtr<ParallelDeflateCompressor>> ParallelDeflateCompressor::construct(MaybeOwned<Stream> stream, size_t thread_count, DeflateCompressor::CompressionLevel compression_level)
+{
+    VERIFY(thread_count > 0);
+
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ParallelDeflateCompressor(move(stream), thread_count, compression_level)));
+    TRY(compressor->m_pending_input.try_ensure_capacity(chunk_size));
+    return compressor;
+}
+
+ParallelDeflateCompressor::ParallelDeflateCompressor(MaybeOwned<Stream> stream, size_t thread_count, DeflateCompressor::CompressionLevel compression_level)
+    : m_output_stream(move(stream))
+    , m_compression_level(compression_level)
+    , m_chunks(
+          thread_count,
+          [this](Chunk& chunk) { return compress_chunk(chunk, m_compression_level); },
+          [this](Chunk& chunk) { return m_output_stream->write_until_depleted(chunk.output); })
+{
+}
+
+ParallelDeflateCompressor::~ParallelDeflateCompressor() = default;
+
+ErrorOr<Bytes> ParallelDeflateCompressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> ParallelDeflateCompressor::write_some(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+
+    size_t total_written = 0;
+    while (!bytes.is_empty()) {
+        auto n_written = min(bytes.size(), chunk_size - m_pending_input.size());
+        TRY(m_pending_input.try_append(bytes.trim(n_written)));
+
+        if (m_pending_input.size() == chunk_size)
+            TRY(submit_pending_chunk(false));
+
+        bytes = bytes.slice(n_written);
+        total_written += n_written;
+    }
+    return total_written;
+}
+
+bool ParallelDeflateCompressor::is_eof() const
+{
+    return true;
+}
+
+bool ParallelDeflateCompressor::is_open() const
+{
+    return m_output_stream->is_open();
+}
+
+void ParallelDeflateCompressor::close()
+{
+}
+
+ErrorOr<void> ParallelDeflateCompressor::final_flush()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+
+    TRY(submit_pending_chunk(true));
+    return m_chunks.finish_all();
+}
+
+ErrorOr<void> ParallelDeflateCompressor::submit_pending_chunk(bool is_last)
+{
+    auto chunk = TRY(try_make<Chunk>());
+    chunk->input = move(m_pending_input);
+    chunk->dictionary = move(m_previous_input_tail);
+    chunk->is_last = is_last;
+
+    if (!is_last) {
+        // The next chunk can refer back to (at most) the last block of this one.
+        auto input = chunk->input.bytes();
+        m_previous_input_tail = TRY(ByteBuffer::copy(input.slice(input.size() - min(input.size(), DeflateCompressor::block_size))));
+        TRY(m_pending_input.try_ensure_capacity(chunk_size));
+    }
+
+    return m_chunks.submit(move(chunk));
+}
+
+ErrorOr<void> ParallelDeflateCompressor::compress_chunk(Chunk& chunk, DeflateCompressor::CompressionLevel compression_level)
+{
+    AllocatingMemoryStream output_stream;
+    auto compressor = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), compression_level));
+    compressor->set_dictionary(chunk.dictionary);
+
+    TRY(compressor->write_until_depleted(chunk.input));
+    if (chunk.is_last)
+        TRY(compressor->final_flush());
+    else
+        TRY(compressor->final_sync_flush());
+
+    chunk.output = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    TRY(output_stream.read_until_filled(chunk.output));
+    return {};
+}
+
+ErrorOr<ByteBuffer> ParallelDeflateCompressor::compress_all(ReadonlyBytes bytes, size_t thread_count, DeflateCompressor::CompressionLevel compression_level)
+{
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto compressor = TRY(ParallelDeflateCompressor::construct(MaybeOwned<Stream>(*output_stream), thread_count, compression_level));
+
+    TRY(compressor->write_until_depleted(bytes));
+    TRY(compressor->final_flush());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer));
+    return buffer;
+}
+
+}
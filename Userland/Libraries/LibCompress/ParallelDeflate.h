@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/MaybeOwned.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Stream.h>
+#include <LibCompress/Deflate.h>
+#include <LibThreading/OrderedJobQueue.h>
+
+namespace Compress {
+
+// Compresses its input into a single deflate stream on several threads, in the same way as pigz:
+// the input is split into chunks that are compressed independently (each primed with the tail of the
+// chunk before it, so little is lost at chunk boundaries), and whose outputs are then concatenated in order.
+class ParallelDeflateCompressor final : public Stream {
+    AK_MAKE_NONCOPYABLE(ParallelDeflateCompressor);
+    AK_MAKE_NONMOVABLE(ParallelDeflateCompressor);
+
+public:
+    static constexpr size_t chunk_size = 128 * KiB;
+
+    static ErrorOr<NonnullOwnPtr<ParallelDeflateCompressor>> construct(MaybeOwned<Stream>, size_t thread_count, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::GOOD);
+    ~ParallelDeflateCompressor();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    // Compresses the remaining input, and waits for all of it to have been written to the output stream.
+    ErrorOr<void> final_flush();
+
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes, size_t thread_count, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::GOOD);
+
+private:
+    struct Chunk {
+        ByteBuffer input;
+        ByteBuffer dictionary;
+        bool is_last { false };
+
+        ByteBuffer output;
+    };
+
+    ParallelDeflateCompressor(MaybeOwned<Stream>, size_t thread_count, DeflateCompressor::CompressionLevel);
+
+    static ErrorOr<void> compress_chunk(Chunk&, DeflateCompressor::CompressionLevel);
+
+    ErrorOr<void> submit_pending_chunk(bool is_last);
+
+    MaybeOwned<Stream> m_output_stream;
+    DeflateCompressor::CompressionLevel m_compression_level;
+    bool m_finished { false };
+
+    ByteBuffer m_pending_input;
+    ByteBuffer m_previous_input_tail;
+
+    Threading::OrderedJobQueue<Chunk> m_chunks;
+};
+
+}
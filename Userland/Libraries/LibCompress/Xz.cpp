@@ -9,6 +9,7 @@
 #include <LibCompress/Lzma2.h>
 #include <LibCompress/Xz.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Checksum/CRC64.h>
 
 namespace Compress {
 
@@ -44,6 +45,19 @@ ErrorOr<XzMultibyteInteger> XzMultibyteInteger::read_from_stream(Stream& stream)
     return XzMultibyteInteger { result };
 }
 
+ErrorOr<void> XzMultibyteInteger::write_to_stream(Stream& stream) const
+{
+    // This is the inverse of the decoding above: Seven bits go into every byte, and all but the last byte have the highest bit set.
+    auto value = m_value;
+    while (value >= 0x80) {
+        TRY(stream.write_value<u8>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    TRY(stream.write_value<u8>(value));
+
+    return {};
+}
+
 ErrorOr<void> XzStreamHeader::validate() const
 {
     // 2.1.1.1. Header Magic Bytes:
@@ -161,6 +175,14 @@ u32 XzFilterLzma2Properties::dictionary_size() const
     return dictionary_size;
 }
 
+XzFilterLzma2Properties XzFilterLzma2Properties::from_dictionary_size(u32 dictionary_size)
+{
+    XzFilterLzma2Properties properties { .encoded_dictionary_size = 0, .reserved = 0 };
+    while (properties.encoded_dictionary_size < 40 && properties.dictionary_size() < dictionary_size)
+        properties.encoded_dictionary_size++;
+    return properties;
+}
+
 u32 XzFilterDeltaProperties::distance() const
 {
     // "The Properties byte indicates the delta distance, which can be
@@ -812,4 +834,226 @@ void XzDecompressor::close()
 {
 }
 
+ErrorOr<NonnullOwnPtr<XzCompressor>> XzCompressor::create(MaybeOwned<Stream> stream, XzCompressorOptions const& options)
+{
+    VERIFY(options.thread_count > 0);
+    VERIFY(options.block_size > 0);
+
+    // 5.3.1. LZMA2: "The smallest dictionary size is 4 KiB and the biggest is 4 GiB."
+    if (options.dictionary_size < 4 * KiB)
+        return Error::from_string_literal("XZ dictionary size is too small");
+
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) XzCompressor(move(stream), options)));
+    TRY(compressor->m_pending_input.try_ensure_capacity(options.block_size));
+
+    // 2.1.1. Stream Header
+    XzStreamHeader header {
+        .magic = { 0xFD, '7', 'z', 'X', 'Z', 0x00 },
+        .flags = stream_flags,
+        .flags_crc32 = Crypto::Checksum::CRC32({ &stream_flags, sizeof(stream_flags) }).digest(),
+    };
+    TRY(compressor->m_output_stream->write_value(header));
+
+    return compressor;
+}
+
+XzCompressor::XzCompressor(MaybeOwned<Stream> stream, XzCompressorOptions const& options)
+    : m_output_stream(move(stream))
+    , m_options(options)
+    , m_blocks(
+          options.thread_count,
+          [this](Block& block) { return compress_block(block, m_options.dictionary_size); },
+          [this](Block& block) { return write_block(block); })
+{
+}
+
+XzCompressor::~XzCompressor() = default;
+
+ErrorOr<Bytes> XzCompressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> XzCompressor::write_some(ReadonlyBytes bytes)
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Wrote to an XZ stream that has already been flushed");
+
+    auto processed_bytes = min(bytes.size(), m_options.block_size - m_pending_input.size());
+    TRY(m_pending_input.try_append(bytes.trim(processed_bytes)));
+
+    if (m_pending_input.size() == m_options.block_size)
+        TRY(submit_pending_block());
+
+    return processed_bytes;
+}
+
+ErrorOr<void> XzCompressor::flush()
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Flushed an XZ stream twice");
+    m_has_flushed_data = true;
+
+    // An empty stream doesn't contain any blocks at all.
+    if (!m_pending_input.is_empty())
+        TRY(submit_pending_block());
+
+    TRY(m_blocks.finish_all());
+    return write_index_and_footer();
+}
+
+bool XzCompressor::is_eof() const
+{
+    return true;
+}
+
+bool XzCompressor::is_open() const
+{
+    return m_output_stream->is_open();
+}
+
+void XzCompressor::close()
+{
+}
+
+ErrorOr<void> XzCompressor::submit_pending_block()
+{
+    auto block = TRY(try_make<Block>());
+    block->input = move(m_pending_input);
+    TRY(m_pending_input.try_ensure_capacity(m_options.block_size));
+
+    return m_blocks.submit(move(block));
+}
+
+ErrorOr<void> XzCompressor::write_block(Block const& block)
+{
+    TRY(m_output_stream->write_until_depleted(block.output));
+    TRY(m_written_blocks.try_append({ .uncompressed_size = block.input.size(), .unpadded_size = block.unpadded_size }));
+    return {};
+}
+
+ErrorOr<void> XzCompressor::write_index_and_footer()
+{
+    // 4. Index: The CRC32 and the stream footer both depend on the encoded index, so collect it first.
+    AllocatingMemoryStream index_stream;
+
+    // 4.1. Index Indicator: "The first byte of the Index is always 0x00."
+    TRY(index_stream.write_value<u8>(0x00));
+
+    // 4.2. Number of Records
+    TRY(index_stream.write_value<XzMultibyteInteger>(m_written_blocks.size()));
+
+    // 4.3. List of Records
+    for (auto const& block : m_written_blocks) {
+        TRY(index_stream.write_value<XzMultibyteInteger>(block.unpadded_size));
+        TRY(index_stream.write_value<XzMultibyteInteger>(block.uncompressed_size));
+    }
+
+    // 4.4. Index Padding
+    while (index_stream.used_buffer_size() % 4 != 0)
+        TRY(index_stream.write_value<u8>(0x00));
+
+    auto index = TRY(ByteBuffer::create_uninitialized(index_stream.used_buffer_size()));
+    TRY(index_stream.read_until_filled(index));
+    TRY(m_output_stream->write_until_depleted(index));
+
+    // 4.5. CRC32
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(Crypto::Checksum::CRC32(index).digest()));
+
+    // 2.1.2. Stream Footer
+    XzStreamFooter footer {};
+    // 2.1.2.2. Backward Size: "real_backward_size = (stored_backward_size + 1) * 4;"
+    footer.encoded_backward_size = (index.size() + sizeof(u32)) / 4 - 1;
+    footer.flags = stream_flags;
+    footer.magic[0] = 'Y';
+    footer.magic[1] = 'Z';
+
+    Crypto::Checksum::CRC32 footer_crc32;
+    footer_crc32.update({ &footer.encoded_backward_size, sizeof(footer.encoded_backward_size) });
+    footer_crc32.update({ &footer.flags, sizeof(footer.flags) });
+    footer.size_and_flags_crc32 = footer_crc32.digest();
+
+    TRY(m_output_stream->write_value(footer));
+    return {};
+}
+
+ErrorOr<void> XzCompressor::compress_block(Block& block, u32 dictionary_size)
+{
+    // Nothing can refer back beyond the start of the block, so there's no use in a dictionary that's larger than the block itself.
+    u32 const used_dictionary_size = clamp(block.input.size(), 4 * KiB, dictionary_size);
+    auto const filter_properties = XzFilterLzma2Properties::from_dictionary_size(used_dictionary_size);
+
+    AllocatingMemoryStream compressed_stream;
+    {
+        auto compressor = TRY(Lzma2Compressor::create_raw_stream(MaybeOwned<Stream> { compressed_stream }, { .dictionary_size = used_dictionary_size }));
+        TRY(compressor->write_until_depleted(block.input));
+        TRY(compressor->flush());
+    }
+    auto const compressed_size = compressed_stream.used_buffer_size();
+
+    // 3.1. Block Header: The header starts with its own size, so the remaining fields have to be collected first.
+    AllocatingMemoryStream header_fields;
+
+    // 3.1.2. Block Flags
+    TRY(header_fields.write_value(XzBlockFlags {
+        .encoded_number_of_filters = 0,
+        .reserved = 0,
+        .compressed_size_present = true,
+        .uncompressed_size_present = true,
+    }));
+
+    // 3.1.3. Compressed Size and 3.1.4. Uncompressed Size:
+    // Storing both of them allows decompressors to find every block (and decompress them in parallel) without having to look at the index.
+    TRY(header_fields.write_value<XzMultibyteInteger>(compressed_size));
+    TRY(header_fields.write_value<XzMultibyteInteger>(block.input.size()));
+
+    // 3.1.5. List of Filter Flags, with LZMA2 (5.3.1.) as the only filter.
+    TRY(header_fields.write_value<XzMultibyteInteger>(0x21));
+    TRY(header_fields.write_value<XzMultibyteInteger>(sizeof(filter_properties)));
+    TRY(header_fields.write_until_depleted({ &filter_properties, sizeof(filter_properties) }));
+
+    // 3.1.1. Block Header Size: "real_header_size = (encoded_header_size + 1) * 4;"
+    constexpr size_t size_of_block_header_size = 1;
+    constexpr size_t size_of_crc32 = 4;
+    auto const header_fields_size = header_fields.used_buffer_size();
+    auto const header_size = align_up_to(size_of_block_header_size + header_fields_size + size_of_crc32, 4);
+    auto const padded_compressed_size = align_up_to(compressed_size, 4);
+
+    // Both the 3.1.6. Header Padding and the 3.3. Block Padding consist of null bytes, so just start out with those.
+    LittleEndian<u64> const check = Crypto::Checksum::CRC64(block.input).digest();
+    auto output = TRY(ByteBuffer::create_zeroed(header_size + padded_compressed_size + sizeof(check)));
+
+    auto header = output.bytes().trim(header_size);
+    header[0] = header_size / 4 - 1;
+    TRY(header_fields.read_until_filled(header.slice(size_of_block_header_size, header_fields_size)));
+
+    // 3.1.7. CRC32: "The CRC32 is calculated over everything in the Block Header field except the CRC32 field itself."
+    LittleEndian<u32> const header_crc32 = Crypto::Checksum::CRC32(header.trim(header_size - size_of_crc32)).digest();
+    ReadonlyBytes { &header_crc32, sizeof(header_crc32) }.copy_to(header.slice(header_size - size_of_crc32));
+
+    // 3.2. Compressed Data
+    TRY(compressed_stream.read_until_filled(output.bytes().slice(header_size, compressed_size)));
+
+    // 3.4. Check: "The Check, when used, is calculated from the original uncompressed data."
+    ReadonlyBytes { &check, sizeof(check) }.copy_to(output.bytes().slice(header_size + padded_compressed_size));
+
+    // 4.3.1. Unpadded Size: "Unpadded Size is the size of the Block Header, Compressed Data, and Check fields."
+    block.unpadded_size = header_size + compressed_size + sizeof(check);
+    block.output = move(output);
+    return {};
+}
+
+ErrorOr<ByteBuffer> XzCompressor::compress_all(ReadonlyBytes bytes, XzCompressorOptions const& options)
+{
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto compressor = TRY(XzCompressor::create(MaybeOwned<Stream>(*output_stream), options));
+
+    TRY(compressor->write_until_depleted(bytes));
+    TRY(compressor->flush());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer));
+    return buffer;
+}
+
 }
@@ -16,6 +16,7 @@
 #include <AK/OwnPtr.h>
 #include <AK/Stream.h>
 #include <AK/Vector.h>
+#include <LibThreading/OrderedJobQueue.h>
 
 namespace Compress {
 
@@ -35,6 +36,7 @@ public:
     constexpr operator u64() const { return m_value; }
 
     static ErrorOr<XzMultibyteInteger> read_from_stream(Stream& stream);
+    ErrorOr<void> write_to_stream(Stream& stream) const;
 
 private:
     u64 m_value { 0 };
@@ -96,6 +98,9 @@ struct [[gnu::packed]] XzFilterLzma2Properties {
 
     ErrorOr<void> validate() const;
     u32 dictionary_size() const;
+
+    // Picks the smallest encodable dictionary size that is at least as large as the given one.
+    static XzFilterLzma2Properties from_dictionary_size(u32);
 };
 static_assert(sizeof(XzFilterLzma2Properties) == 1);
 
@@ -187,6 +192,72 @@ private:
     Vector<BlockMetadata> m_processed_blocks;
 };
 
+struct XzCompressorOptions {
+    // Note: This is smaller than the LZMA default, since every thread needs a dictionary (and its hash chains) of its own.
+    u32 dictionary_size { 2 * MiB };
+
+    // Blocks are compressed independently of each other, which allows for compressing them in parallel,
+    // but nothing can be referenced across a block boundary. Every block should span at least a couple of dictionaries.
+    size_t block_size { 6 * MiB };
+
+    size_t thread_count { 1 };
+};
+
+// Compresses its input into a single XZ stream, which uses LZMA2 as its only filter and CRC64 as its check.
+// The input is split into blocks that are compressed on `thread_count` threads, and written out in order.
+class XzCompressor final : public Stream {
+    AK_MAKE_NONCOPYABLE(XzCompressor);
+    AK_MAKE_NONMOVABLE(XzCompressor);
+
+public:
+    static ErrorOr<NonnullOwnPtr<XzCompressor>> create(MaybeOwned<Stream>, XzCompressorOptions const& = {});
+    ~XzCompressor();
+
+    /// Finishes the stream by compressing the remaining input and writing out the index and the stream footer.
+    /// This has to be called once all of the input has been written.
+    ErrorOr<void> flush();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes, XzCompressorOptions const& = {});
+
+private:
+    static constexpr XzStreamFlags stream_flags { .reserved = 0, .check_type = XzStreamCheckType::CRC64, .reserved_bits = 0 };
+
+    struct Block {
+        ByteBuffer input;
+
+        ByteBuffer output;
+        u64 unpadded_size { 0 };
+    };
+
+    struct BlockMetadata {
+        u64 uncompressed_size {};
+        u64 unpadded_size {};
+    };
+
+    XzCompressor(MaybeOwned<Stream>, XzCompressorOptions const&);
+
+    static ErrorOr<void> compress_block(Block&, u32 dictionary_size);
+
+    ErrorOr<void> submit_pending_block();
+    ErrorOr<void> write_block(Block const&);
+    ErrorOr<void> write_index_and_footer();
+
+    MaybeOwned<Stream> m_output_stream;
+    XzCompressorOptions m_options;
+    bool m_has_flushed_data { false };
+
+    ByteBuffer m_pending_input;
+    Vector<BlockMetadata> m_written_blocks;
+
+    Threading::OrderedJobQueue<Block> m_blocks;
+};
+
 }
 
 template<>
@@ -0,0 +1,1892 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Endian.h>
+#include <AK/IntegralMath.h>
+#include <AK/Math.h>
+#include <AK/MemoryStream.h>
+#include <AK/QuickSort.h>
+#include <LibCompress/Zstd.h>
+
+namespace Compress {
+
+// RFC 8878 section 3.1.1.2
+static constexpr size_t maximum_block_size = 128 * KiB;
+
+// RFC 8878 section 3.1.1.3.2.1.1
+static constexpr u8 literal_length_max_symbol = 35;
+static constexpr u8 match_length_max_symbol = 52;
+static constexpr u8 offset_max_symbol = 31;
+static constexpr u8 literal_length_max_accuracy_log = 9;
+static constexpr u8 match_length_max_accuracy_log = 9;
+static constexpr u8 offset_max_accuracy_log = 8;
+
+static constexpr struct {
+    u32 baseline;
+    u8 extra_bits;
+} literal_length_codes[literal_length_max_symbol + 1] {
+    { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 }, { 7, 0 },
+    { 8, 0 }, { 9, 0 }, { 10, 0 }, { 11, 0 }, { 12, 0 }, { 13, 0 }, { 14, 0 }, { 15, 0 },
+    { 16, 1 }, { 18, 1 }, { 20, 1 }, { 22, 1 }, { 24, 2 }, { 28, 2 }, { 32, 3 }, { 40, 3 },
+    { 48, 4 }, { 64, 6 }, { 128, 7 }, { 256, 8 }, { 512, 9 }, { 1024, 10 }, { 2048, 11 }, { 4096, 12 },
+    { 8192, 13 }, { 16384, 14 }, { 32768, 15 }, { 65536, 16 }
+};
+
+static constexpr struct {
+    u32 baseline;
+    u8 extra_bits;
+} match_length_codes[match_length_max_symbol + 1] {
+    { 3, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 }, { 7, 0 }, { 8, 0 }, { 9, 0 }, { 10, 0 },
+    { 11, 0 }, { 12, 0 }, { 13, 0 }, { 14, 0 }, { 15, 0 }, { 16, 0 }, { 17, 0 }, { 18, 0 },
+    { 19, 0 }, { 20, 0 }, { 21, 0 }, { 22, 0 }, { 23, 0 }, { 24, 0 }, { 25, 0 }, { 26, 0 },
+    { 27, 0 }, { 28, 0 }, { 29, 0 }, { 30, 0 }, { 31, 0 }, { 32, 0 }, { 33, 0 }, { 34, 0 },
+    { 35, 1 }, { 37, 1 }, { 39, 1 }, { 41, 1 }, { 43, 2 }, { 47, 2 }, { 51, 3 }, { 59, 3 },
+    { 67, 4 }, { 83, 4 }, { 99, 5 }, { 131, 7 }, { 259, 8 }, { 515, 9 }, { 1027, 10 }, { 2051, 11 },
+    { 4099, 12 }, { 8195, 13 }, { 16387, 14 }, { 32771, 15 }, { 65539, 16 }
+};
+
+// RFC 8878 section 3.1.1.3.2.2
+static constexpr u8 literal_length_default_accuracy_log = 6;
+static constexpr i16 literal_length_default_distribution[] {
+    4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+    -1, -1, -1, -1
+};
+
+static constexpr u8 match_length_default_accuracy_log = 6;
+static constexpr i16 match_length_default_distribution[] {
+    1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+    -1, -1, -1, -1, -1
+};
+
+static constexpr u8 offset_default_accuracy_log = 5;
+static constexpr i16 offset_default_distribution[] {
+    1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+// RFC 8878 section 4.2.1
+static constexpr u8 huffman_max_bit_count = 11;
+static constexpr u8 huffman_weights_max_accuracy_log = 6;
+static constexpr size_t huffman_max_weight_count = 255;
+
+// The literals and the decompressed data are followed by this many bytes of slack, so that short copies can
+// always move whole chunks of 16 bytes.
+static constexpr size_t wild_copy_slack = 32;
+
+// Copies in chunks of 16 bytes, so it reads and writes up to 15 bytes beyond the given length. The source has to
+// be at least 16 bytes before the destination if they overlap.
+static ALWAYS_INLINE void wild_copy(u8* destination, u8 const* source, size_t length)
+{
+    u8* const end = destination + length;
+    do {
+        __builtin_memcpy(destination, source, 16);
+        destination += 16;
+        source += 16;
+    } while (destination < end);
+}
+
+static constexpr u64 low_bits_mask(size_t count)
+{
+    return count >= 64 ? ~0ull : (1ull << count) - 1;
+}
+
+// The FSE table descriptions are read from the lowest bit of the first byte onwards (RFC 8878 section 4.1.1).
+class ForwardBitReader {
+public:
+    explicit ForwardBitReader(ReadonlyBytes data)
+        : m_data(data)
+    {
+    }
+
+    u32 peek_bits(size_t count) const
+    {
+        auto byte_index = m_position / 8;
+        u64 word = 0;
+        if (byte_index < m_data.size())
+            __builtin_memcpy(&word, m_data.data() + byte_index, min(sizeof(word), m_data.size() - byte_index));
+        return (word >> (m_position % 8)) & low_bits_mask(count);
+    }
+
+    void skip_bits(size_t count) { m_position += count; }
+
+    u32 read_bits(size_t count)
+    {
+        auto value = peek_bits(count);
+        skip_bits(count);
+        return value;
+    }
+
+    size_t consumed_bytes() const { return ceil_div(m_position, static_cast<size_t>(8)); }
+
+private:
+    ReadonlyBytes m_data;
+    size_t m_position { 0 };
+};
+
+// All the entropy coded streams are written forwards but read backwards, starting right below the highest
+// bit that is set in their last byte (RFC 8878 section 4.1). Bits before the start of the stream read as zero.
+class ReverseBitReader {
+public:
+    static ErrorOr<ReverseBitReader> create(ReadonlyBytes data)
+    {
+        if (data.is_empty() || data[data.size() - 1] == 0)
+            return Error::from_string_literal("Zstandard bitstream is missing its end marker");
+        return ReverseBitReader { data, static_cast<i64>((data.size() - 1) * 8 + AK::log2(data[data.size() - 1])) };
+    }
+
+    ALWAYS_INLINE u64 peek_bits(size_t count) const
+    {
+        if (count == 0)
+            return 0;
+
+        auto position = m_position - static_cast<i64>(count);
+        if (position >= 0)
+            return (load_word(position / 8) >> (position % 8)) & low_bits_mask(count);
+
+        auto available_bits = position + static_cast<i64>(count);
+        if (available_bits <= 0)
+            return 0;
+        return (load_word(0) & low_bits_mask(available_bits)) << (count - available_bits);
+    }
+
+    ALWAYS_INLINE void skip_bits(size_t count) { m_position -= count; }
+
+    ALWAYS_INLINE u64 read_bits(size_t count)
+    {
+        auto value = peek_bits(count);
+        skip_bits(count);
+        return value;
+    }
+
+    bool is_overflowed() const { return m_position < 0; }
+    bool is_fully_consumed() const { return m_position == 0; }
+
+private:
+    ReverseBitReader(ReadonlyBytes data, i64 position)
+        : m_data(data)
+        , m_position(position)
+    {
+    }
+
+    ALWAYS_INLINE u64 load_word(size_t byte_index) const
+    {
+        u64 word = 0;
+        if (byte_index + sizeof(word) <= m_data.size())
+            __builtin_memcpy(&word, m_data.data() + byte_index, sizeof(word));
+        else
+            __builtin_memcpy(&word, m_data.data() + byte_index, m_data.size() - byte_index);
+        return word;
+    }
+
+    ReadonlyBytes m_data;
+    i64 m_position { 0 };
+};
+
+// RFC 8878 section 4.1.1
+static void spread_fse_symbols(Span<u8> table_symbols, ReadonlySpan<i16> probabilities, size_t& high_threshold)
+{
+    size_t const table_size = table_symbols.size();
+    high_threshold = table_size - 1;
+    for (size_t symbol = 0; symbol < probabilities.size(); symbol++) {
+        if (probabilities[symbol] == -1)
+            table_symbols[high_threshold--] = symbol;
+    }
+
+    size_t const step = (table_size >> 1) + (table_size >> 3) + 3;
+    size_t const mask = table_size - 1;
+    size_t position = 0;
+    for (size_t symbol = 0; symbol < probabilities.size(); symbol++) {
+        for (i16 i = 0; i < probabilities[symbol]; i++) {
+            table_symbols[position] = symbol;
+            do {
+                position = (position + step) & mask;
+            } while (position > high_threshold);
+        }
+    }
+}
+
+static ErrorOr<ZstdFseTable> build_fse_table(ReadonlySpan<i16> probabilities, u8 accuracy_log)
+{
+    size_t const table_size = 1u << accuracy_log;
+
+    size_t total = 0;
+    for (auto probability : probabilities)
+        total += probability == -1 ? 1 : probability;
+    if (total != table_size)
+        return Error::from_string_literal("Zstandard FSE probabilities don't add up to the table size");
+
+    Vector<u8> table_symbols;
+    TRY(table_symbols.try_resize(table_size));
+    size_t high_threshold = 0;
+    spread_fse_symbols(table_symbols, probabilities, high_threshold);
+
+    Vector<u16> next_states;
+    TRY(next_states.try_resize(probabilities.size()));
+    for (size_t symbol = 0; symbol < probabilities.size(); symbol++)
+        next_states[symbol] = probabilities[symbol] == -1 ? 1 : probabilities[symbol];
+
+    ZstdFseTable table;
+    table.accuracy_log = accuracy_log;
+    TRY(table.entries.try_resize(table_size));
+    for (size_t state = 0; state < table_size; state++) {
+        auto symbol = table_symbols[state];
+        auto next_state = next_states[symbol]++;
+        u8 bit_count = accuracy_log - AK::log2(next_state);
+        table.entries[state] = { symbol, bit_count, static_cast<u16>((next_state << bit_count) - table_size) };
+    }
+    return table;
+}
+
+// RFC 8878 section 4.1.1
+static ErrorOr<ZstdFseTable> read_fse_table(ReadonlyBytes& data, u8 max_symbol, u8 max_accuracy_log)
+{
+    ForwardBitReader reader { data };
+
+    u8 accuracy_log = reader.read_bits(4) + 5;
+    if (accuracy_log > max_accuracy_log)
+        return Error::from_string_literal("Zstandard FSE accuracy log is too large");
+
+    Vector<i16, 256> probabilities;
+    i32 remaining = (1 << accuracy_log) + 1;
+    i32 threshold = 1 << accuracy_log;
+    size_t bit_count = accuracy_log + 1;
+    while (remaining > 1) {
+        if (probabilities.size() > max_symbol)
+            return Error::from_string_literal("Zstandard FSE table describes too many symbols");
+
+        // The values that are smaller than what the remaining probability allows for are written with one bit less.
+        i32 max_value = 2 * threshold - 1 - remaining;
+        i32 value = reader.peek_bits(bit_count);
+        if ((value & (threshold - 1)) < max_value) {
+            value &= threshold - 1;
+            reader.skip_bits(bit_count - 1);
+        } else {
+            value &= 2 * threshold - 1;
+            if (value >= threshold)
+                value -= max_value;
+            reader.skip_bits(bit_count);
+        }
+
+        i16 probability = value - 1;
+        remaining -= probability < 0 ? -probability : probability;
+        TRY(probabilities.try_append(probability));
+
+        if (probability == 0) {
+            for (;;) {
+                auto repeat_count = reader.read_bits(2);
+                for (size_t i = 0; i < repeat_count; i++)
+                    TRY(probabilities.try_append(0));
+                if (repeat_count != 3)
+                    break;
+            }
+            if (probabilities.size() > max_symbol + 1u)
+                return Error::from_string_literal("Zstandard FSE table describes too many symbols");
+        }
+
+        while (remaining < threshold) {
+            bit_count--;
+            threshold >>= 1;
+        }
+    }
+
+    if (remaining != 1)
+        return Error::from_string_literal("Zstandard FSE probabilities don't add up to the table size");
+    if (reader.consumed_bytes() > data.size())
+        return Error::from_string_literal("Zstandard FSE table description is truncated");
+    data = data.slice(reader.consumed_bytes());
+
+    return build_fse_table(probabilities, accuracy_log);
+}
+
+static ErrorOr<Vector<u8>> decode_fse_compressed_huffman_weights(ReadonlyBytes data)
+{
+    auto table = TRY(read_fse_table(data, huffman_max_bit_count + 1, huffman_weights_max_accuracy_log));
+    auto reader = TRY(ReverseBitReader::create(data));
+
+    // Two interleaved states share the same table, and decoding stops once the bitstream has run out.
+    Array<u16, 2> states {
+        static_cast<u16>(reader.read_bits(table.accuracy_log)),
+        static_cast<u16>(reader.read_bits(table.accuracy_log)),
+    };
+    Vector<u8> weights;
+    for (size_t current = 0;; current ^= 1) {
+        if (weights.size() >= huffman_max_weight_count)
+            return Error::from_string_literal("Zstandard Huffman table has too many weights");
+
+        auto const& entry = table.entries[states[current]];
+        TRY(weights.try_append(entry.symbol));
+        states[current] = entry.baseline + reader.read_bits(entry.bit_count);
+        if (reader.is_overflowed()) {
+            TRY(weights.try_append(table.entries[states[current ^ 1]].symbol));
+            break;
+        }
+    }
+    return weights;
+}
+
+// RFC 8878 section 4.2.1
+static ErrorOr<ZstdHuffmanTable> read_huffman_table(ReadonlyBytes& data)
+{
+    if (data.is_empty())
+        return Error::from_string_literal("Zstandard Huffman table description is truncated");
+
+    u8 header = data[0];
+    Vector<u8> weights;
+    if (header < 128) {
+        if (data.size() < 1u + header)
+            return Error::from_string_literal("Zstandard Huffman table description is truncated");
+        weights = TRY(decode_fse_compressed_huffman_weights(data.slice(1, header)));
+        data = data.slice(1 + header);
+    } else {
+        size_t weight_count = header - 127;
+        size_t byte_count = ceil_div(weight_count, static_cast<size_t>(2));
+        if (data.size() < 1 + byte_count)
+            return Error::from_string_literal("Zstandard Huffman table description is truncated");
+        for (size_t i = 0; i < weight_count; i++) {
+            u8 byte = data[1 + i / 2];
+            TRY(weights.try_append(i % 2 == 0 ? byte >> 4 : byte & 0xf));
+        }
+        data = data.slice(1 + byte_count);
+    }
+
+    // The weight of the last symbol isn't stored, it is whatever completes the code.
+    u32 weight_sum = 0;
+    for (auto weight : weights) {
+        if (weight > huffman_max_bit_count)
+            return Error::from_string_literal("Zstandard Huffman weight is too large");
+        if (weight > 0)
+            weight_sum += 1u << (weight - 1);
+    }
+    if (weight_sum == 0)
+        return Error::from_string_literal("Zstandard Huffman table is empty");
+
+    u8 max_bit_count = AK::log2(weight_sum) + 1;
+    if (max_bit_count > huffman_max_bit_count)
+        return Error::from_string_literal("Zstandard Huffman table is too deep");
+    u32 remaining = (1u << max_bit_count) - weight_sum;
+    if (!is_power_of_two(remaining))
+        return Error::from_string_literal("Zstandard Huffman weights don't form a complete code");
+    TRY(weights.try_append(AK::log2(remaining) + 1));
+
+    // Symbols are sorted by weight first and by their value second, and take up 2^(weight - 1) entries each.
+    ZstdHuffmanTable table;
+    table.max_bit_count = max_bit_count;
+    TRY(table.entries.try_resize(1u << max_bit_count));
+    size_t position = 0;
+    for (u8 weight = 1; weight <= max_bit_count; weight++) {
+        for (size_t symbol = 0; symbol < weights.size(); symbol++) {
+            if (weights[symbol] != weight)
+                continue;
+            size_t entry_count = 1u << (weight - 1);
+            for (size_t i = 0; i < entry_count; i++)
+                table.entries[position++] = { static_cast<u8>(symbol), static_cast<u8>(max_bit_count + 1 - weight) };
+        }
+    }
+    return table;
+}
+
+static ErrorOr<void> decode_huffman_stream(ZstdHuffmanTable const& table, ReadonlyBytes stream, Bytes output)
+{
+    auto reader = TRY(ReverseBitReader::create(stream));
+    for (auto& byte : output) {
+        auto const& entry = table.entries[reader.peek_bits(table.max_bit_count)];
+        byte = entry.symbol;
+        reader.skip_bits(entry.bit_count);
+    }
+    if (!reader.is_fully_consumed())
+        return Error::from_string_literal("Zstandard Huffman stream doesn't match its length");
+    return {};
+}
+
+static ZstdFseTable const& predefined_literal_lengths_table()
+{
+    static auto const table = MUST(build_fse_table(literal_length_default_distribution, literal_length_default_accuracy_log));
+    return table;
+}
+
+static ZstdFseTable const& predefined_match_lengths_table()
+{
+    static auto const table = MUST(build_fse_table(match_length_default_distribution, match_length_default_accuracy_log));
+    return table;
+}
+
+static ZstdFseTable const& predefined_offsets_table()
+{
+    static auto const table = MUST(build_fse_table(offset_default_distribution, offset_default_accuracy_log));
+    return table;
+}
+
+ErrorOr<NonnullRefPtr<ZstdDictionary>> ZstdDictionary::create(ReadonlyBytes bytes)
+{
+    auto dictionary = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) ZstdDictionary));
+
+    auto read_u32 = [](ReadonlyBytes data, size_t offset) {
+        return static_cast<u32>(data[offset]) | (data[offset + 1] << 8) | (data[offset + 2] << 16) | (static_cast<u32>(data[offset + 3]) << 24);
+    };
+
+    if (bytes.size() < 8 || read_u32(bytes, 0) != zstd_dictionary_magic) {
+        dictionary->m_content = TRY(ByteBuffer::copy(bytes));
+        return dictionary;
+    }
+
+    // RFC 8878 section 5
+    dictionary->m_id = read_u32(bytes, 4);
+    auto data = bytes.slice(8);
+
+    auto& tables = dictionary->m_entropy_tables;
+    tables.literals = TRY(read_huffman_table(data));
+    tables.offsets = TRY(read_fse_table(data, offset_max_symbol, offset_max_accuracy_log));
+    tables.match_lengths = TRY(read_fse_table(data, match_length_max_symbol, match_length_max_accuracy_log));
+    tables.literal_lengths = TRY(read_fse_table(data, literal_length_max_symbol, literal_length_max_accuracy_log));
+
+    if (data.size() < 12)
+        return Error::from_string_literal("Zstandard dictionary is truncated");
+    auto content = data.slice(12);
+    for (size_t i = 0; i < 3; i++) {
+        auto offset = read_u32(data, 4 * i);
+        if (offset == 0 || offset > content.size())
+            return Error::from_string_literal("Zstandard dictionary has an invalid repeat offset");
+        dictionary->m_repeat_offsets[i] = offset;
+    }
+
+    dictionary->m_content = TRY(ByteBuffer::copy(content));
+    return dictionary;
+}
+
+ErrorOr<NonnullOwnPtr<ZstdDecompressor>> ZstdDecompressor::create(MaybeOwned<Stream> stream, RefPtr<ZstdDictionary const> dictionary)
+{
+    return adopt_nonnull_own_or_enomem(new (nothrow) ZstdDecompressor(move(stream), move(dictionary)));
+}
+
+ZstdDecompressor::ZstdDecompressor(MaybeOwned<Stream> stream, RefPtr<ZstdDictionary const> dictionary)
+    : m_stream(move(stream))
+    , m_dictionary(move(dictionary))
+{
+}
+
+ZstdDecompressor::~ZstdDecompressor() = default;
+
+ErrorOr<Bytes> ZstdDecompressor::read_some(Bytes bytes)
+{
+    while (m_read_position == m_window.size()) {
+        if (m_is_eof)
+            return bytes.trim(0);
+
+        if (!m_is_in_frame) {
+            if (!TRY(read_frame_header()))
+                m_is_eof = true;
+            continue;
+        }
+
+        TRY(decode_block());
+    }
+
+    auto size = min(bytes.size(), m_window.size() - m_read_position);
+    m_window.bytes().slice(m_read_position, size).copy_to(bytes);
+    m_read_position += size;
+    return bytes.trim(size);
+}
+
+ErrorOr<size_t> ZstdDecompressor::write_some(ReadonlyBytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+bool ZstdDecompressor::is_eof() const
+{
+    return m_is_eof && m_read_position == m_window.size();
+}
+
+bool ZstdDecompressor::is_open() const
+{
+    return m_stream->is_open();
+}
+
+void ZstdDecompressor::close()
+{
+}
+
+ErrorOr<ByteBuffer> ZstdDecompressor::decompress_all(ReadonlyBytes bytes, RefPtr<ZstdDictionary const> dictionary)
+{
+    auto input_stream = TRY(try_make<FixedMemoryStream>(bytes));
+    auto decompressor = TRY(ZstdDecompressor::create(move(input_stream), move(dictionary)));
+    return decompressor->read_until_eof();
+}
+
+bool ZstdDecompressor::is_likely_compressed(ReadonlyBytes bytes)
+{
+    return bytes.size() >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd;
+}
+
+// RFC 8878 section 3.1.1.1
+ErrorOr<bool> ZstdDecompressor::read_frame_header()
+{
+    u32 magic;
+    for (;;) {
+        // The input may consist of any number of frames.
+        if (m_stream->is_eof())
+            return false;
+
+        magic = TRY(m_stream->read_value<LittleEndian<u32>>());
+        if ((magic & 0xfffffff0) != zstd_skippable_frame_magic)
+            break;
+
+        // RFC 8878 section 3.1.2
+        auto frame_size = TRY(m_stream->read_value<LittleEndian<u32>>());
+        TRY(m_stream->discard(frame_size));
+    }
+    if (magic != zstd_frame_magic)
+        return Error::from_string_literal("Invalid Zstandard frame magic");
+
+    u8 descriptor = TRY(m_stream->read_value<u8>());
+    u8 content_size_flag = descriptor >> 6;
+    bool is_single_segment = (descriptor >> 5) & 1;
+    if ((descriptor >> 3) & 1)
+        return Error::from_string_literal("Zstandard frame header has the reserved bit set");
+    m_has_content_checksum = (descriptor >> 2) & 1;
+    u8 dictionary_id_flag = descriptor & 0b11;
+
+    if (!is_single_segment) {
+        u8 window_descriptor = TRY(m_stream->read_value<u8>());
+        u64 base = 1ull << (10 + (window_descriptor >> 3));
+        m_window_size = base + (base / 8) * (window_descriptor & 0b111);
+    }
+
+    auto read_little_endian = [&](size_t size) -> ErrorOr<u64> {
+        u8 buffer[8] {};
+        TRY(m_stream->read_until_filled({ buffer, size }));
+        u64 value = 0;
+        for (size_t i = 0; i < size; i++)
+            value |= static_cast<u64>(buffer[i]) << (8 * i);
+        return value;
+    };
+
+    constexpr Array<u8, 4> dictionary_id_sizes { 0, 1, 2, 4 };
+    u32 dictionary_id = TRY(read_little_endian(dictionary_id_sizes[dictionary_id_flag]));
+
+    m_frame_content_size.clear();
+    switch (content_size_flag) {
+    case 0:
+        if (is_single_segment)
+            m_frame_content_size = TRY(read_little_endian(1));
+        break;
+    case 1:
+        m_frame_content_size = TRY(read_little_endian(2)) + 256;
+        break;
+    case 2:
+        m_frame_content_size = TRY(read_little_endian(4));
+        break;
+    case 3:
+        m_frame_content_size = TRY(read_little_endian(8));
+        break;
+    }
+
+    if (is_single_segment)
+        m_window_size = m_frame_content_size.value();
+    if (m_window_size > max_window_size)
+        return Error::from_string_literal("Zstandard frame window size is too large");
+    m_block_maximum_size = min<u64>(m_window_size, maximum_block_size);
+
+    if (dictionary_id != 0 && (!m_dictionary || m_dictionary->id() != dictionary_id))
+        return Error::from_string_literal("Zstandard frame requires a dictionary that wasn't provided");
+
+    // Frames are independent of each other, except for the dictionary that every one of them starts out with.
+    m_window.clear();
+    if (m_dictionary) {
+        TRY(m_window.try_append(m_dictionary->content()));
+        m_entropy_tables = m_dictionary->entropy_tables();
+        m_repeat_offsets = m_dictionary->repeat_offsets();
+    } else {
+        m_entropy_tables = {};
+        m_repeat_offsets = { 1, 4, 8 };
+    }
+    m_read_position = m_window.size();
+
+    m_checksum = {};
+    m_frame_output_size = 0;
+    m_is_in_frame = true;
+    return true;
+}
+
+ErrorOr<void> ZstdDecompressor::read_frame_footer()
+{
+    m_is_in_frame = false;
+
+    if (m_frame_content_size.has_value() && m_frame_content_size.value() != m_frame_output_size)
+        return Error::from_string_literal("Zstandard frame content size doesn't match the decompressed data");
+
+    // RFC 8878 section 3.1.1
+    if (m_has_content_checksum) {
+        u32 checksum = TRY(m_stream->read_value<LittleEndian<u32>>());
+        if (checksum != static_cast<u32>(m_checksum.digest()))
+            return Error::from_string_literal("Zstandard frame checksum doesn't match the decompressed data");
+    }
+
+    return {};
+}
+
+// RFC 8878 section 3.1.1.2
+ErrorOr<void> ZstdDecompressor::decode_block()
+{
+    u8 header_bytes[3];
+    TRY(m_stream->read_until_filled({ header_bytes, sizeof(header_bytes) }));
+    u32 header = header_bytes[0] | (header_bytes[1] << 8) | (header_bytes[2] << 16);
+    bool is_last_block = header & 1;
+    u8 block_type = (header >> 1) & 0b11;
+    size_t block_size = header >> 3;
+
+    if (block_size > m_block_maximum_size)
+        return Error::from_string_literal("Zstandard block is too large");
+
+    // Drop the history that can't be referenced anymore (and that has been read already), but only every so often.
+    auto retained_size = max<u64>(m_window_size, m_dictionary ? m_dictionary->content().size() : 0);
+    if (m_read_position > retained_size + max<u64>(retained_size, maximum_block_size)) {
+        auto discarded_size = m_read_position - retained_size;
+        auto remaining_size = m_window.size() - discarded_size;
+        memmove(m_window.data(), m_window.data() + discarded_size, remaining_size);
+        m_window.resize(remaining_size);
+        m_read_position -= discarded_size;
+    }
+
+    auto const output_start = m_window.size();
+    size_t output_size = 0;
+    switch (block_type) {
+    case 0:
+        TRY(m_window.try_resize(output_start + block_size));
+        TRY(m_stream->read_until_filled(m_window.bytes().slice(output_start)));
+        output_size = block_size;
+        break;
+    case 1: {
+        u8 byte = TRY(m_stream->read_value<u8>());
+        TRY(m_window.try_resize(output_start + block_size));
+        m_window.bytes().slice(output_start).fill(byte);
+        output_size = block_size;
+        break;
+    }
+    case 2: {
+        TRY(m_block.try_resize(block_size + wild_copy_slack));
+        auto block = m_block.bytes().trim(block_size);
+        TRY(m_stream->read_until_filled(block));
+        TRY(m_window.try_resize(output_start + m_block_maximum_size + wild_copy_slack));
+        TRY(decode_compressed_block(block, m_window.bytes().slice(output_start), output_size));
+        m_window.resize(output_start + output_size);
+        break;
+    }
+    default:
+        return Error::from_string_literal("Zstandard block uses the reserved block type");
+    }
+
+    auto output = m_window.bytes().slice(output_start, output_size);
+    if (m_has_content_checksum)
+        m_checksum.update(output);
+    m_frame_output_size += output_size;
+
+    if (is_last_block) {
+        TRY(read_frame_footer());
+    }
+
+    return {};
+}
+
+// RFC 8878 section 3.1.1.3
+ErrorOr<void> ZstdDecompressor::decode_compressed_block(ReadonlyBytes block, Bytes output, size_t& output_size)
+{
+    TRY(decode_literals(block));
+    TRY(decode_and_execute_sequences(block, output, output_size));
+    return {};
+}
+
+// RFC 8878 section 3.1.1.3.1
+ErrorOr<void> ZstdDecompressor::decode_literals(ReadonlyBytes& data)
+{
+    if (data.is_empty())
+        return Error::from_string_literal("Zstandard literals section is truncated");
+
+    u8 literals_type = data[0] & 0b11;
+    u8 size_format = (data[0] >> 2) & 0b11;
+
+    auto read_header = [&](size_t header_size) -> ErrorOr<u64> {
+        if (data.size() < header_size)
+            return Error::from_string_literal("Zstandard literals section is truncated");
+        u64 value = 0;
+        for (size_t i = 0; i < header_size; i++)
+            value |= static_cast<u64>(data[i]) << (8 * i);
+        data = data.slice(header_size);
+        return value;
+    };
+
+    if (literals_type == 0 || literals_type == 1) {
+        size_t regenerated_size = 0;
+        switch (size_format) {
+        case 0:
+        case 2:
+            regenerated_size = TRY(read_header(1)) >> 3;
+            break;
+        case 1:
+            regenerated_size = TRY(read_header(2)) >> 4;
+            break;
+        case 3:
+            regenerated_size = TRY(read_header(3)) >> 4;
+            break;
+        }
+        if (regenerated_size > m_block_maximum_size)
+            return Error::from_string_literal("Zstandard literals section is too large");
+
+        if (literals_type == 0) {
+            if (data.size() < regenerated_size)
+                return Error::from_string_literal("Zstandard literals section is truncated");
+            m_literals = data.trim(regenerated_size);
+            data = data.slice(regenerated_size);
+        } else {
+            if (data.is_empty())
+                return Error::from_string_literal("Zstandard literals section is truncated");
+            TRY(m_literals_buffer.try_resize(regenerated_size + wild_copy_slack));
+            m_literals = m_literals_buffer.bytes().trim(regenerated_size);
+            m_literals_buffer.bytes().fill(data[0]);
+            data = data.slice(1);
+        }
+        return {};
+    }
+
+    bool has_four_streams = size_format != 0;
+    size_t header_size = size_format <= 1 ? 3 : size_format + 2;
+    size_t size_bits = size_format <= 1 ? 10 : 4 * size_format + 6;
+    auto header = TRY(read_header(header_size));
+    size_t regenerated_size = (header >> 4) & low_bits_mask(size_bits);
+    size_t compressed_size = (header >> (4 + size_bits)) & low_bits_mask(size_bits);
+    if (regenerated_size > m_block_maximum_size)
+        return Error::from_string_literal("Zstandard literals section is too large");
+    if (data.size() < compressed_size)
+        return Error::from_string_literal("Zstandard literals section is truncated");
+
+    auto compressed_data = data.trim(compressed_size);
+    data = data.slice(compressed_size);
+
+    if (literals_type == 2)
+        m_entropy_tables.literals = TRY(read_huffman_table(compressed_data));
+    else if (!m_entropy_tables.literals.has_value())
+        return Error::from_string_literal("Zstandard treeless literals section without a previous Huffman table");
+    auto const& table = m_entropy_tables.literals.value();
+
+    TRY(m_literals_buffer.try_resize(regenerated_size + wild_copy_slack));
+    auto output = m_literals_buffer.bytes().trim(regenerated_size);
+    m_literals = output;
+    if (!has_four_streams) {
+        TRY(decode_huffman_stream(table, compressed_data, output));
+        return {};
+    }
+
+    // The first three streams regenerate a quarter of the literals (rounded up) each, and the last one the rest.
+    if (compressed_data.size() < 6)
+        return Error::from_string_literal("Zstandard literals jump table is truncated");
+    Array<size_t, 4> stream_sizes;
+    size_t streams_size = 0;
+    for (size_t i = 0; i < 3; i++) {
+        stream_sizes[i] = compressed_data[2 * i] | (compressed_data[2 * i + 1] << 8);
+        streams_size += stream_sizes[i];
+    }
+    compressed_data = compressed_data.slice(6);
+    if (streams_size > compressed_data.size())
+        return Error::from_string_literal("Zstandard literals jump table is corrupted");
+    stream_sizes[3] = compressed_data.size() - streams_size;
+
+    size_t segment_size = ceil_div(regenerated_size, static_cast<size_t>(4));
+    if (3 * segment_size > regenerated_size)
+        return Error::from_string_literal("Zstandard literals section is too small for four streams");
+
+    for (size_t i = 0; i < 4; i++) {
+        auto stream_output = i < 3 ? output.trim(segment_size) : output;
+        TRY(decode_huffman_stream(table, compressed_data.trim(stream_sizes[i]), stream_output));
+        compressed_data = compressed_data.slice(stream_sizes[i]);
+        output = output.slice(stream_output.size());
+    }
+    return {};
+}
+
+ErrorOr<void> ZstdDecompressor::read_sequence_table(ReadonlyBytes& data, u8 mode, Optional<ZstdFseTable>& table, ZstdFseTable const& predefined_table, u8 max_symbol, u8 max_accuracy_log)
+{
+    // RFC 8878 section 3.1.1.3.2.1.1
+    switch (mode) {
+    case 0:
+        table = predefined_table;
+        break;
+    case 1: {
+        if (data.is_empty())
+            return Error::from_string_literal("Zstandard sequences section is truncated");
+        if (data[0] > max_symbol)
+            return Error::from_string_literal("Zstandard RLE sequence symbol is out of range");
+        ZstdFseTable rle_table;
+        TRY(rle_table.entries.try_append({ data[0], 0, 0 }));
+        table = move(rle_table);
+        data = data.slice(1);
+        break;
+    }
+    case 2:
+        table = TRY(read_fse_table(data, max_symbol, max_accuracy_log));
+        break;
+    case 3:
+        if (!table.has_value())
+            return Error::from_string_literal("Zstandard sequences repeat a table that doesn't exist");
+        break;
+    }
+    return {};
+}
+
+// RFC 8878 section 3.1.1.3.2
+ErrorOr<void> ZstdDecompressor::decode_and_execute_sequences(ReadonlyBytes data, Bytes output, size_t& output_size)
+{
+    if (data.is_empty())
+        return Error::from_string_literal("Zstandard sequences section is truncated");
+
+    size_t sequence_count = data[0];
+    if (sequence_count >= 128) {
+        if (data.size() < 2 || (sequence_count == 255 && data.size() < 3))
+            return Error::from_string_literal("Zstandard sequences section is truncated");
+        if (sequence_count < 255) {
+            sequence_count = ((sequence_count - 128) << 8) + data[1];
+            data = data.slice(2);
+        } else {
+            sequence_count = data[1] + (data[2] << 8) + 0x7f00;
+            data = data.slice(3);
+        }
+    } else {
+        data = data.slice(1);
+    }
+
+    // The literals and the output have some slack space after them (see wild_copy()).
+    u8 const* const history_start = m_window.data();
+    u8* out = output.data();
+    u8 const* const out_end = output.data() + output.size() - wild_copy_slack;
+    auto literals = m_literals;
+
+    if (sequence_count > 0) {
+        if (data.is_empty())
+            return Error::from_string_literal("Zstandard sequences section is truncated");
+        u8 modes = data[0];
+        if ((modes & 0b11) != 0)
+            return Error::from_string_literal("Zstandard sequences section has reserved bits set");
+        data = data.slice(1);
+
+        TRY(read_sequence_table(data, modes >> 6, m_entropy_tables.literal_lengths, predefined_literal_lengths_table(), literal_length_max_symbol, literal_length_max_accuracy_log));
+        TRY(read_sequence_table(data, (modes >> 4) & 0b11, m_entropy_tables.offsets, predefined_offsets_table(), offset_max_symbol, offset_max_accuracy_log));
+        TRY(read_sequence_table(data, (modes >> 2) & 0b11, m_entropy_tables.match_lengths, predefined_match_lengths_table(), match_length_max_symbol, match_length_max_accuracy_log));
+
+        auto const& literal_lengths_table = m_entropy_tables.literal_lengths.value();
+        auto const& offsets_table = m_entropy_tables.offsets.value();
+        auto const& match_lengths_table = m_entropy_tables.match_lengths.value();
+
+        auto reader = TRY(ReverseBitReader::create(data));
+        size_t literal_length_state = reader.read_bits(literal_lengths_table.accuracy_log);
+        size_t offset_state = reader.read_bits(offsets_table.accuracy_log);
+        size_t match_length_state = reader.read_bits(match_lengths_table.accuracy_log);
+
+        for (size_t i = 0; i < sequence_count; i++) {
+            auto const& literal_length_entry = literal_lengths_table.entries[literal_length_state];
+            auto const& offset_entry = offsets_table.entries[offset_state];
+            auto const& match_length_entry = match_lengths_table.entries[match_length_state];
+
+            u32 offset_value = (1u << offset_entry.symbol) + reader.read_bits(offset_entry.symbol);
+            auto const& match_length_code = match_length_codes[match_length_entry.symbol];
+            size_t match_length = match_length_code.baseline + reader.read_bits(match_length_code.extra_bits);
+            auto const& literal_length_code = literal_length_codes[literal_length_entry.symbol];
+            size_t literal_length = literal_length_code.baseline + reader.read_bits(literal_length_code.extra_bits);
+
+            // RFC 8878 section 3.1.1.5
+            u32 offset;
+            if (offset_value > 3) {
+                offset = offset_value - 3;
+                m_repeat_offsets = { offset, m_repeat_offsets[0], m_repeat_offsets[1] };
+            } else {
+                auto index = offset_value - (literal_length == 0 ? 0 : 1);
+                if (index == 0) {
+                    offset = m_repeat_offsets[0];
+                } else if (index == 1) {
+                    offset = m_repeat_offsets[1];
+                    m_repeat_offsets = { offset, m_repeat_offsets[0], m_repeat_offsets[2] };
+                } else if (index == 2) {
+                    offset = m_repeat_offsets[2];
+                    m_repeat_offsets = { offset, m_repeat_offsets[0], m_repeat_offsets[1] };
+                } else {
+                    offset = m_repeat_offsets[0] - 1;
+                    if (offset == 0)
+                        return Error::from_string_literal("Zstandard sequence uses a zero offset");
+                    m_repeat_offsets = { offset, m_repeat_offsets[0], m_repeat_offsets[1] };
+                }
+            }
+
+            if (i + 1 < sequence_count) {
+                literal_length_state = literal_length_entry.baseline + reader.read_bits(literal_length_entry.bit_count);
+                match_length_state = match_length_entry.baseline + reader.read_bits(match_length_entry.bit_count);
+                offset_state = offset_entry.baseline + reader.read_bits(offset_entry.bit_count);
+            }
+
+            // RFC 8878 section 3.1.1.4
+            if (literal_length > literals.size())
+                return Error::from_string_literal("Zstandard sequence uses more literals than there are");
+            if (static_cast<size_t>(out_end - out) < literal_length + match_length)
+                return Error::from_string_literal("Zstandard block decompresses to more than the maximum block size");
+
+            wild_copy(out, literals.data(), literal_length);
+            literals = literals.slice(literal_length);
+            out += literal_length;
+
+            if (offset > static_cast<size_t>(out - history_start))
+                return Error::from_string_literal("Zstandard sequence offset reaches before the start of the window");
+            u8 const* match = out - offset;
+            if (offset >= 16) {
+                wild_copy(out, match, match_length);
+            } else {
+                for (size_t j = 0; j < match_length; j++)
+                    out[j] = match[j];
+            }
+            out += match_length;
+        }
+
+        if (!reader.is_fully_consumed())
+            return Error::from_string_literal("Zstandard sequences bitstream doesn't match the number of sequences");
+    } else if (!data.is_empty()) {
+        return Error::from_string_literal("Zstandard sequences section has trailing data");
+    }
+
+    if (static_cast<size_t>(out_end - out) < literals.size())
+        return Error::from_string_literal("Zstandard block decompresses to more than the maximum block size");
+    __builtin_memcpy(out, literals.data(), literals.size());
+    out += literals.size();
+
+    output_size = out - output.data();
+    return {};
+}
+
+// A forward bitstream that gets read backwards by ReverseBitReader.
+class BitstreamWriter {
+public:
+    explicit BitstreamWriter(ByteBuffer& output)
+        : m_output(output)
+    {
+    }
+
+    // The value must not have any bits set above the given count, which can be at most 32.
+    ErrorOr<void> write_bits(u64 value, size_t count)
+    {
+        m_bit_buffer |= value << m_bit_count;
+        m_bit_count += count;
+        if (m_bit_count >= 32) {
+            u32 word = m_bit_buffer;
+            TRY(m_output.try_append(&word, sizeof(word)));
+            m_bit_buffer >>= 32;
+            m_bit_count -= 32;
+        }
+        return {};
+    }
+
+    // Writes the end marker and pads the last byte.
+    ErrorOr<void> finish()
+    {
+        TRY(write_bits(1, 1));
+        while (m_bit_count > 0) {
+            TRY(m_output.try_append(static_cast<u8>(m_bit_buffer)));
+            m_bit_buffer >>= 8;
+            m_bit_count -= min<size_t>(m_bit_count, 8);
+        }
+        return {};
+    }
+
+private:
+    ByteBuffer& m_output;
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
+};
+
+// Encodes symbols in the reverse order of how they are decoded by a ZstdFseTable built from the same probabilities.
+class FseEncoder {
+public:
+    static ErrorOr<FseEncoder> create(ReadonlySpan<i16> probabilities, u8 accuracy_log)
+    {
+        FseEncoder encoder;
+        encoder.m_accuracy_log = accuracy_log;
+        size_t const table_size = 1u << accuracy_log;
+
+        Vector<u8> table_symbols;
+        TRY(table_symbols.try_resize(table_size));
+        size_t high_threshold = 0;
+        spread_fse_symbols(table_symbols, probabilities, high_threshold);
+
+        // The states of each symbol are grouped together, in the order in which the decoding table assigns them.
+        Vector<u32> cumulative_counts;
+        TRY(cumulative_counts.try_resize(probabilities.size() + 1));
+        for (size_t symbol = 0; symbol < probabilities.size(); symbol++)
+            cumulative_counts[symbol + 1] = cumulative_counts[symbol] + (probabilities[symbol] == -1 ? 1 : probabilities[symbol]);
+
+        TRY(encoder.m_states.try_resize(table_size));
+        for (size_t state = 0; state < table_size; state++)
+            encoder.m_states[cumulative_counts[table_symbols[state]]++] = table_size + state;
+
+        TRY(encoder.m_symbols.try_resize(probabilities.size()));
+        i32 total = 0;
+        for (size_t symbol = 0; symbol < probabilities.size(); symbol++) {
+            auto& transform = encoder.m_symbols[symbol];
+            auto probability = probabilities[symbol];
+            if (probability == 0) {
+                transform.bit_count_delta = ((accuracy_log + 1) << 16) - table_size;
+            } else if (probability == -1 || probability == 1) {
+                transform.bit_count_delta = (accuracy_log << 16) - table_size;
+                transform.state_delta = total - 1;
+                total++;
+            } else {
+                u32 max_bits_out = accuracy_log - AK::log2(static_cast<u32>(probability - 1));
+                transform.bit_count_delta = (max_bits_out << 16) - (probability << max_bits_out);
+                transform.state_delta = total - probability;
+                total += probability;
+            }
+        }
+
+        return encoder;
+    }
+
+    u8 accuracy_log() const { return m_accuracy_log; }
+
+    u32 initial_state(u8 symbol) const
+    {
+        auto const& transform = m_symbols[symbol];
+        u32 bits_out = (transform.bit_count_delta + (1 << 15)) >> 16;
+        u32 value = (bits_out << 16) - transform.bit_count_delta;
+        return m_states[(value >> bits_out) + transform.state_delta];
+    }
+
+    ErrorOr<void> encode_symbol(BitstreamWriter& writer, u32& state, u8 symbol) const
+    {
+        auto const& transform = m_symbols[symbol];
+        u32 bits_out = (state + transform.bit_count_delta) >> 16;
+        TRY(writer.write_bits(state & low_bits_mask(bits_out), bits_out));
+        state = m_states[(state >> bits_out) + transform.state_delta];
+        return {};
+    }
+
+    ErrorOr<void> flush_state(BitstreamWriter& writer, u32 state) const
+    {
+        return writer.write_bits(state & low_bits_mask(m_accuracy_log), m_accuracy_log);
+    }
+
+private:
+    struct SymbolTransform {
+        u32 bit_count_delta { 0 };
+        i32 state_delta { 0 };
+    };
+
+    u8 m_accuracy_log { 0 };
+    Vector<u16> m_states;
+    Vector<SymbolTransform> m_symbols;
+};
+
+// Picks a table size that is large enough for all symbols, but not larger than the number of encoded values warrants.
+static u8 fse_accuracy_log_for(size_t value_count, size_t max_symbol, u8 max_accuracy_log)
+{
+    u8 accuracy_log = max_accuracy_log;
+    if (value_count > 1) {
+        auto source_bits = AK::log2(value_count - 1);
+        if (source_bits >= 2 && source_bits - 2 < accuracy_log)
+            accuracy_log = source_bits - 2;
+    }
+    u8 minimum_bits = min(AK::log2(value_count) + 1, AK::log2(max(max_symbol, static_cast<size_t>(1))) + 2);
+    return clamp<u8>(max(accuracy_log, minimum_bits), 5, max_accuracy_log);
+}
+
+static ErrorOr<Vector<i16>> normalize_fse_counts(ReadonlySpan<u32> counts, size_t total, u8 accuracy_log)
+{
+    i32 const table_size = 1 << accuracy_log;
+
+    Vector<i16> probabilities;
+    TRY(probabilities.try_resize(counts.size()));
+    i32 sum = 0;
+    size_t largest_symbol = 0;
+    for (size_t symbol = 0; symbol < counts.size(); symbol++) {
+        if (counts[symbol] == 0)
+            continue;
+        probabilities[symbol] = max<i16>(1, static_cast<u64>(counts[symbol]) * table_size / total);
+        sum += probabilities[symbol];
+        if (counts[symbol] > counts[largest_symbol])
+            largest_symbol = symbol;
+    }
+
+    // Rounding down leaves some of the table for the most common symbol, while rounding up the rare symbols
+    // might take too much of it, which is taken back from whatever has the highest probability at the time.
+    if (sum < table_size)
+        probabilities[largest_symbol] += table_size - sum;
+    while (sum > table_size) {
+        size_t symbol = 0;
+        for (size_t i = 1; i < probabilities.size(); i++) {
+            if (probabilities[i] > probabilities[symbol])
+                symbol = i;
+        }
+        probabilities[symbol]--;
+        sum--;
+    }
+    return probabilities;
+}
+
+// The inverse of read_fse_table().
+static ErrorOr<void> write_fse_table(ByteBuffer& output, ReadonlySpan<i16> probabilities, u8 accuracy_log)
+{
+    u64 bit_buffer = accuracy_log - 5;
+    size_t bit_count = 4;
+    auto write_bits = [&](u32 value, size_t count) -> ErrorOr<void> {
+        bit_buffer |= static_cast<u64>(value) << bit_count;
+        bit_count += count;
+        while (bit_count >= 8) {
+            TRY(output.try_append(static_cast<u8>(bit_buffer)));
+            bit_buffer >>= 8;
+            bit_count -= 8;
+        }
+        return {};
+    };
+
+    size_t last_symbol = probabilities.size() - 1;
+    while (probabilities[last_symbol] == 0)
+        last_symbol--;
+
+    i32 remaining = (1 << accuracy_log) + 1;
+    i32 threshold = 1 << accuracy_log;
+    size_t value_bits = accuracy_log + 1;
+    bool previous_was_zero = false;
+    for (size_t symbol = 0; symbol <= last_symbol && remaining > 1;) {
+        if (previous_was_zero) {
+            size_t zero_count = 0;
+            while (probabilities[symbol + zero_count] == 0)
+                zero_count++;
+            symbol += zero_count;
+            for (; zero_count >= 3; zero_count -= 3)
+                TRY(write_bits(3, 2));
+            TRY(write_bits(zero_count, 2));
+        }
+
+        i32 value = probabilities[symbol++];
+        i32 max_value = 2 * threshold - 1 - remaining;
+        remaining -= value < 0 ? -value : value;
+        value++;
+        if (value >= threshold)
+            value += max_value;
+        TRY(write_bits(value, value < max_value ? value_bits - 1 : value_bits));
+        previous_was_zero = value == 1;
+
+        while (remaining < threshold) {
+            value_bits--;
+            threshold >>= 1;
+        }
+    }
+
+    if (bit_count > 0)
+        TRY(output.try_append(static_cast<u8>(bit_buffer)));
+    return {};
+}
+
+// Approximates the number of bits that coding the symbols with the given probabilities takes.
+static Optional<double> fse_cost(ReadonlySpan<u32> counts, ReadonlySpan<i16> probabilities, u8 accuracy_log)
+{
+    double cost = 0;
+    for (size_t symbol = 0; symbol < counts.size(); symbol++) {
+        if (counts[symbol] == 0)
+            continue;
+        if (symbol >= probabilities.size() || probabilities[symbol] == 0)
+            return {};
+        double probability = probabilities[symbol] == -1 ? 1 : probabilities[symbol];
+        cost += counts[symbol] * (accuracy_log - AK::log2(probability));
+    }
+    return cost;
+}
+
+// Builds a complete prefix code with no code longer than max_length, by flattening the frequencies until it fits.
+static void compute_code_lengths(Span<u8> lengths, ReadonlySpan<u32> frequencies, size_t max_length)
+{
+    struct Node {
+        u64 weight;
+        i32 left;  // -1 for leaves...
+        i32 right; // ...where this is the symbol instead.
+    };
+
+    Vector<u16, 256> symbols;
+    for (size_t symbol = 0; symbol < frequencies.size(); symbol++) {
+        if (frequencies[symbol] != 0)
+            symbols.append(symbol);
+    }
+
+    lengths.fill(0);
+    if (symbols.size() <= 1)
+        return;
+
+    Vector<Node> nodes;
+    Vector<u16> depths;
+    for (u64 minimum_weight = 1;; minimum_weight *= 2) {
+        auto weight = [&](u16 symbol) { return max<u64>(frequencies[symbol], minimum_weight); };
+        quick_sort(symbols, [&](u16 a, u16 b) { return weight(a) < weight(b) || (weight(a) == weight(b) && a < b); });
+
+        nodes.clear_with_capacity();
+        for (auto symbol : symbols)
+            nodes.append({ weight(symbol), -1, symbol });
+
+        // Both the leaves and the inner nodes are created in order of their weight, so the two lightest nodes are
+        // always at the front of one of these two queues.
+        size_t next_leaf = 0;
+        size_t next_inner_node = symbols.size();
+        auto take_lightest_node = [&]() -> size_t {
+            if (next_leaf < symbols.size() && (next_inner_node >= nodes.size() || nodes[next_leaf].weight <= nodes[next_inner_node].weight))
+                return next_leaf++;
+            return next_inner_node++;
+        };
+        while (nodes.size() < 2 * symbols.size() - 1) {
+            auto left = take_lightest_node();
+            auto right = take_lightest_node();
+            nodes.append({ nodes[left].weight + nodes[right].weight, static_cast<i32>(left), static_cast<i32>(right) });
+        }
+
+        depths.resize(nodes.size());
+        depths.last() = 0;
+        for (size_t i = nodes.size() - 1; i >= symbols.size(); i--) {
+            depths[nodes[i].left] = depths[i] + 1;
+            depths[nodes[i].right] = depths[i] + 1;
+        }
+
+        bool fits = true;
+        for (size_t i = 0; i < symbols.size(); i++)
+            fits &= depths[i] <= max_length;
+        if (!fits)
+            continue;
+
+        for (size_t i = 0; i < symbols.size(); i++)
+            lengths[nodes[i].right] = depths[i];
+        return;
+    }
+}
+
+// Compresses the Huffman weights with FSE (RFC 8878 section 4.2.1.2), or returns an empty buffer if that isn't possible.
+static ErrorOr<ByteBuffer> compress_huffman_weights(ReadonlySpan<u8> weights)
+{
+    ByteBuffer compressed;
+    if (weights.size() < 2)
+        return compressed;
+
+    Array<u32, huffman_max_bit_count + 1> counts {};
+    size_t max_weight = 0;
+    for (auto weight : weights) {
+        counts[weight]++;
+        max_weight = max<size_t>(max_weight, weight);
+    }
+    if (counts[max_weight] == weights.size())
+        return compressed;
+
+    auto accuracy_log = fse_accuracy_log_for(weights.size(), max_weight, huffman_weights_max_accuracy_log);
+    auto probabilities = TRY(normalize_fse_counts(ReadonlySpan<u32> { counts.data(), max_weight + 1 }, weights.size(), accuracy_log));
+    auto encoder = TRY(FseEncoder::create(probabilities, accuracy_log));
+    TRY(write_fse_table(compressed, probabilities, accuracy_log));
+
+    // Two states take turns, with the first one decoding the first weight.
+    BitstreamWriter writer { compressed };
+    Array<u32, 2> states;
+    size_t index = weights.size() - 1;
+    states[index % 2] = encoder.initial_state(weights[index]);
+    index--;
+    states[index % 2] = encoder.initial_state(weights[index]);
+    while (index > 0) {
+        index--;
+        TRY(encoder.encode_symbol(writer, states[index % 2], weights[index]));
+    }
+    TRY(encoder.flush_state(writer, states[1]));
+    TRY(encoder.flush_state(writer, states[0]));
+    TRY(writer.finish());
+
+    // The decoder stops once it runs out of bits, which isn't necessarily right after the last weight if the
+    // final states don't need any bits to be read. So make sure that it actually ends up where it should.
+    auto decoded_weights = decode_fse_compressed_huffman_weights(compressed);
+    if (decoded_weights.is_error() || decoded_weights.value().span() != weights)
+        compressed.clear();
+    return compressed;
+}
+
+// Writes the weights of all symbols but the last one (RFC 8878 section 4.2.1.1), in whichever form is smaller.
+// Returns false if the weights can't be described at all.
+static ErrorOr<bool> write_huffman_weights(ByteBuffer& output, ReadonlySpan<u8> weights)
+{
+    auto compressed = TRY(compress_huffman_weights(weights));
+    if (!compressed.is_empty() && compressed.size() < 128 && (weights.size() > 128 || compressed.size() < ceil_div(weights.size(), static_cast<size_t>(2)))) {
+        TRY(output.try_append(static_cast<u8>(compressed.size())));
+        TRY(output.try_append(compressed));
+        return true;
+    }
+
+    if (weights.size() > 128)
+        return false;
+    TRY(output.try_append(static_cast<u8>(127 + weights.size())));
+    for (size_t i = 0; i < weights.size(); i += 2)
+        TRY(output.try_append(static_cast<u8>((weights[i] << 4) | (i + 1 < weights.size() ? weights[i + 1] : 0))));
+    return true;
+}
+
+static u8 literal_length_code(u32 literal_length)
+{
+    if (literal_length < 16)
+        return literal_length;
+    if (literal_length >= 64)
+        return AK::log2(literal_length) + 19;
+    u8 code = 24;
+    while (literal_length_codes[code].baseline > literal_length)
+        code--;
+    return code;
+}
+
+static u8 match_length_code(u32 match_length)
+{
+    u32 base = match_length - 3;
+    if (base < 32)
+        return base;
+    if (base >= 128)
+        return AK::log2(base) + 36;
+    u8 code = 42;
+    while (match_length_codes[code].baseline > match_length)
+        code--;
+    return code;
+}
+
+static u32 hash_bytes(u8 const* bytes, size_t hash_bits)
+{
+    u32 value;
+    __builtin_memcpy(&value, bytes, sizeof(value));
+    return (value * 0x9e3779b1) >> (32 - hash_bits);
+}
+
+static size_t common_prefix_length(u8 const* a, u8 const* b, size_t max_length)
+{
+    size_t length = 0;
+    while (length + sizeof(u64) <= max_length) {
+        u64 a_word;
+        u64 b_word;
+        __builtin_memcpy(&a_word, a + length, sizeof(u64));
+        __builtin_memcpy(&b_word, b + length, sizeof(u64));
+        if (auto difference = a_word ^ b_word; difference != 0)
+            return length + count_trailing_zeroes(difference) / 8;
+        length += sizeof(u64);
+    }
+    while (length < max_length && a[length] == b[length])
+        length++;
+    return length;
+}
+
+ErrorOr<NonnullOwnPtr<ZstdCompressor>> ZstdCompressor::create(MaybeOwned<Stream> stream, ZstdCompressorOptions const& options)
+{
+    if (options.window_log < min_window_log || options.window_log > max_window_log)
+        return Error::from_string_literal("Zstandard window size is out of range");
+
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ZstdCompressor(move(stream), options)));
+    TRY(compressor->m_hash_table.try_resize(1u << hash_log));
+
+    // The dictionary content is history that the first matches can already refer to.
+    if (auto const& dictionary = options.dictionary) {
+        auto content = dictionary->content();
+        TRY(compressor->m_buffer.try_append(content));
+        compressor->m_pending_start = content.size();
+        for (size_t i = 0; i + sizeof(u32) <= content.size(); i++)
+            compressor->m_hash_table[hash_bytes(content.data() + i, hash_log)] = i + 1;
+        compressor->m_repeat_offsets = dictionary->repeat_offsets();
+    }
+
+    TRY(compressor->write_frame_header());
+    return compressor;
+}
+
+ZstdCompressor::ZstdCompressor(MaybeOwned<Stream> stream, ZstdCompressorOptions const& options)
+    : m_output_stream(move(stream))
+    , m_options(options)
+    , m_block_size(min<size_t>(maximum_block_size, 1u << options.window_log))
+{
+}
+
+ZstdCompressor::~ZstdCompressor() = default;
+
+ErrorOr<Bytes> ZstdCompressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> ZstdCompressor::write_some(ReadonlyBytes bytes)
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Wrote to a Zstandard stream that has already been flushed");
+
+    // A full block is only compressed once more input arrives, since the last block has to be marked as such.
+    auto pending_size = m_buffer.size() - m_pending_start;
+    if (pending_size == m_block_size && !bytes.is_empty()) {
+        TRY(compress_block(m_block_size, false));
+        pending_size = 0;
+    }
+
+    auto processed_bytes = min(bytes.size(), m_block_size - pending_size);
+    auto processed_data = bytes.trim(processed_bytes);
+    TRY(m_buffer.try_append(processed_data));
+    if (m_options.include_checksum)
+        m_checksum.update(processed_data);
+
+    return processed_bytes;
+}
+
+ErrorOr<void> ZstdCompressor::flush()
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Flushed a Zstandard stream twice");
+    m_has_flushed_data = true;
+
+    TRY(compress_block(m_buffer.size() - m_pending_start, true));
+
+    if (m_options.include_checksum)
+        TRY(m_output_stream->write_value<LittleEndian<u32>>(static_cast<u32>(m_checksum.digest())));
+    return {};
+}
+
+bool ZstdCompressor::is_eof() const
+{
+    return true;
+}
+
+bool ZstdCompressor::is_open() const
+{
+    return m_output_stream->is_open();
+}
+
+void ZstdCompressor::close()
+{
+}
+
+// RFC 8878 section 3.1.1.1
+ErrorOr<void> ZstdCompressor::write_frame_header()
+{
+    u32 dictionary_id = m_options.dictionary ? m_options.dictionary->id() : 0;
+
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(zstd_frame_magic));
+    u8 descriptor = (m_options.include_checksum ? 1 << 2 : 0) | (dictionary_id != 0 ? 0b11 : 0);
+    TRY(m_output_stream->write_value<u8>(descriptor));
+    TRY(m_output_stream->write_value<u8>((m_options.window_log - 10) << 3));
+    if (dictionary_id != 0)
+        TRY(m_output_stream->write_value<LittleEndian<u32>>(dictionary_id));
+    return {};
+}
+
+// RFC 8878 section 3.1.1.2
+ErrorOr<void> ZstdCompressor::compress_block(size_t length, bool is_last_block)
+{
+    auto const start = m_pending_start;
+    auto const end = start + length;
+    auto const block = m_buffer.bytes().slice(start, length);
+
+    auto write_block = [&](u8 block_type, size_t block_size, ReadonlyBytes content) -> ErrorOr<void> {
+        u32 header = (is_last_block ? 1 : 0) | (block_type << 1) | (block_size << 3);
+        u8 header_bytes[3] { static_cast<u8>(header), static_cast<u8>(header >> 8), static_cast<u8>(header >> 16) };
+        TRY(m_output_stream->write_until_depleted({ header_bytes, sizeof(header_bytes) }));
+        TRY(m_output_stream->write_until_depleted(content));
+        return {};
+    };
+
+    bool is_single_byte_run = length > 1;
+    for (size_t i = 1; i < length && is_single_byte_run; i++)
+        is_single_byte_run = block[i] == block[0];
+
+    if (length == 0) {
+        TRY(write_block(0, 0, {}));
+    } else if (is_single_byte_run) {
+        TRY(write_block(1, length, block.trim(1)));
+    } else {
+        auto const repeat_offsets_before_block = m_repeat_offsets;
+
+        m_literals.clear_with_capacity();
+        m_sequences.clear_with_capacity();
+        find_sequences(start, end);
+
+        ByteBuffer compressed_block;
+        TRY(write_literals_section(compressed_block));
+        TRY(write_sequences_section(compressed_block));
+
+        if (compressed_block.size() >= length) {
+            // The decompressor won't see any of the offsets that the sequences would have used.
+            m_repeat_offsets = repeat_offsets_before_block;
+            TRY(write_block(0, length, block));
+        } else {
+            TRY(write_block(2, compressed_block.size(), compressed_block));
+        }
+    }
+
+    m_pending_start = end;
+
+    // Drop the history that can't be referenced anymore, but only every so often to not move the buffer around all the time.
+    size_t const history_size = 1u << m_options.window_log;
+    if (m_pending_start > history_size + max(history_size, m_block_size)) {
+        auto discarded_size = m_pending_start - history_size;
+        auto remaining_size = m_buffer.size() - discarded_size;
+        memmove(m_buffer.data(), m_buffer.data() + discarded_size, remaining_size);
+        m_buffer.resize(remaining_size);
+
+        m_buffer_position += discarded_size;
+        m_pending_start -= discarded_size;
+    }
+
+    return {};
+}
+
+void ZstdCompressor::find_sequences(size_t start, size_t end)
+{
+    static constexpr size_t minimum_match_length = 4;
+    // Matches are only searched for where a whole word can be read, the last few bytes always end up as literals.
+    static constexpr size_t search_margin = sizeof(u64);
+    // Every 2^search_acceleration_shift bytes without a match make the search skip one more position at a time.
+    static constexpr size_t search_acceleration_shift = 8;
+
+    auto const* data = m_buffer.data();
+    size_t const window_size = 1u << m_options.window_log;
+
+    size_t literals_start = start;
+    auto emit_sequence = [&](size_t match_index, size_t match_length, u32 offset) {
+        u32 literal_length = match_index - literals_start;
+        m_literals.append(data + literals_start, literal_length);
+
+        // This mirrors the offset history updates of the decompressor (RFC 8878 section 3.1.1.5).
+        auto& repeat_offsets = m_repeat_offsets;
+        u32 offset_value;
+        if (literal_length > 0 && offset == repeat_offsets[0]) {
+            offset_value = 1;
+        } else if (literal_length > 0 && offset == repeat_offsets[1]) {
+            offset_value = 2;
+            repeat_offsets = { offset, repeat_offsets[0], repeat_offsets[2] };
+        } else if (literal_length > 0 && offset == repeat_offsets[2]) {
+            offset_value = 3;
+            repeat_offsets = { offset, repeat_offsets[0], repeat_offsets[1] };
+        } else if (literal_length == 0 && offset == repeat_offsets[1]) {
+            offset_value = 1;
+            repeat_offsets = { offset, repeat_offsets[0], repeat_offsets[2] };
+        } else if (literal_length == 0 && offset == repeat_offsets[2]) {
+            offset_value = 2;
+            repeat_offsets = { offset, repeat_offsets[0], repeat_offsets[1] };
+        } else if (literal_length == 0 && offset == repeat_offsets[0] - 1) {
+            offset_value = 3;
+            repeat_offsets = { offset, repeat_offsets[0], repeat_offsets[1] };
+        } else {
+            offset_value = offset + 3;
+            repeat_offsets = { offset, repeat_offsets[0], repeat_offsets[1] };
+        }
+
+        m_sequences.append({ literal_length, static_cast<u32>(match_length), offset_value });
+        literals_start = match_index + match_length;
+    };
+
+    auto max_offset_at = [&](size_t index) {
+        return min<u64>(window_size, m_buffer_position + index);
+    };
+
+    auto insert_hash = [&](size_t index) {
+        m_hash_table[hash_bytes(data + index, hash_log)] = static_cast<u32>(m_buffer_position + index + 1);
+    };
+
+    size_t index = start;
+    while (index + search_margin <= end) {
+        auto hash = hash_bytes(data + index, hash_log);
+        auto candidate = m_hash_table[hash];
+        m_hash_table[hash] = static_cast<u32>(m_buffer_position + index + 1);
+
+        // Like the reference encoder, check whether the most recent offset continues right after this position first.
+        auto repeat_offset = m_repeat_offsets[0];
+        if (repeat_offset <= max_offset_at(index + 1) && repeat_offset <= index + 1
+            && __builtin_memcmp(data + index + 1, data + index + 1 - repeat_offset, minimum_match_length) == 0) {
+            auto match_index = index + 1;
+            auto length = minimum_match_length + common_prefix_length(data + match_index + minimum_match_length, data + match_index + minimum_match_length - repeat_offset, end - match_index - minimum_match_length);
+            emit_sequence(match_index, length, repeat_offset);
+            index = match_index + length;
+        } else {
+            u32 offset = static_cast<u32>(m_buffer_position + index + 1) - candidate;
+            if (candidate == 0 || offset == 0 || offset > max_offset_at(index) || offset > index
+                || __builtin_memcmp(data + index, data + index - offset, minimum_match_length) != 0) {
+                index += 1 + ((index - literals_start) >> search_acceleration_shift);
+                continue;
+            }
+
+            auto match_index = index;
+            auto length = minimum_match_length + common_prefix_length(data + index + minimum_match_length, data + index + minimum_match_length - offset, end - index - minimum_match_length);
+            while (match_index > literals_start && match_index > offset && data[match_index - 1] == data[match_index - 1 - offset]) {
+                match_index--;
+                length++;
+            }
+            emit_sequence(match_index, length, offset);
+            index = match_index + length;
+        }
+
+        // Remember some positions from inside the match as well.
+        if (index + search_margin <= end) {
+            insert_hash(index - 2);
+            insert_hash(index - 1);
+        }
+    }
+
+    m_literals.append(data + literals_start, end - literals_start);
+}
+
+// RFC 8878 section 3.1.1.3.1
+ErrorOr<void> ZstdCompressor::write_literals_section(ByteBuffer& output)
+{
+    static constexpr size_t minimum_size_for_huffman_coding = 64;
+
+    auto const literals = m_literals.span();
+    auto write_header = [&](u64 value, size_t size) -> ErrorOr<void> {
+        for (size_t i = 0; i < size; i++)
+            TRY(output.try_append(static_cast<u8>(value >> (8 * i))));
+        return {};
+    };
+
+    // Raw and RLE literals share the same header format.
+    auto write_simple_literals = [&](u8 literals_type) -> ErrorOr<void> {
+        auto size = literals.size();
+        if (size < 32)
+            TRY(write_header(literals_type | (size << 3), 1));
+        else if (size < 4096)
+            TRY(write_header(literals_type | (0b01 << 2) | (size << 4), 2));
+        else
+            TRY(write_header(literals_type | (0b11 << 2) | (size << 4), 3));
+
+        if (literals_type == 0)
+            TRY(output.try_append(literals));
+        else
+            TRY(output.try_append(literals[0]));
+        return {};
+    };
+
+    bool is_single_byte_run = literals.size() > 1;
+    for (size_t i = 1; i < literals.size() && is_single_byte_run; i++)
+        is_single_byte_run = literals[i] == literals[0];
+    if (is_single_byte_run)
+        return write_simple_literals(1);
+    if (literals.size() < minimum_size_for_huffman_coding)
+        return write_simple_literals(0);
+
+    Array<u32, 256> frequencies {};
+    for (auto literal : literals)
+        frequencies[literal]++;
+
+    Array<u8, 256> lengths {};
+    compute_code_lengths(lengths, frequencies, huffman_max_bit_count);
+
+    size_t last_symbol = 255;
+    while (lengths[last_symbol] == 0)
+        last_symbol--;
+    u8 max_bit_count = 0;
+    for (auto length : lengths)
+        max_bit_count = max(max_bit_count, length);
+
+    // RFC 8878 section 4.2.1
+    Array<u8, 256> weights {};
+    for (size_t symbol = 0; symbol <= last_symbol; symbol++)
+        weights[symbol] = lengths[symbol] == 0 ? 0 : max_bit_count + 1 - lengths[symbol];
+
+    ByteBuffer compressed;
+    if (!TRY(write_huffman_weights(compressed, ReadonlySpan<u8> { weights.data(), last_symbol })))
+        return write_simple_literals(0);
+
+    // Codes are assigned in the same order in which the decoder fills its table.
+    Array<u16, 256> codes {};
+    u32 position = 0;
+    for (u8 weight = 1; weight <= max_bit_count; weight++) {
+        for (size_t symbol = 0; symbol <= last_symbol; symbol++) {
+            if (weights[symbol] != weight)
+                continue;
+            codes[symbol] = position >> (weight - 1);
+            position += 1u << (weight - 1);
+        }
+    }
+
+    // The first literal has to be read first, so it is written last.
+    auto write_stream = [&](ReadonlyBytes stream) -> ErrorOr<void> {
+        BitstreamWriter writer { compressed };
+        for (size_t i = stream.size(); i > 0; i--)
+            TRY(writer.write_bits(codes[stream[i - 1]], lengths[stream[i - 1]]));
+        TRY(writer.finish());
+        return {};
+    };
+
+    bool has_four_streams = literals.size() >= 256;
+    if (!has_four_streams) {
+        TRY(write_stream(literals));
+    } else {
+        auto jump_table_offset = compressed.size();
+        TRY(compressed.try_append("\0\0\0\0\0\0", 6));
+
+        size_t segment_size = ceil_div(literals.size(), static_cast<size_t>(4));
+        auto remaining_literals = literals;
+        for (size_t i = 0; i < 4; i++) {
+            auto stream_start = compressed.size();
+            auto stream = i < 3 ? remaining_literals.trim(segment_size) : remaining_literals;
+            TRY(write_stream(stream));
+            remaining_literals = remaining_literals.slice(stream.size());
+
+            if (i < 3) {
+                auto stream_size = compressed.size() - stream_start;
+                if (stream_size > NumericLimits<u16>::max())
+                    return write_simple_literals(0);
+                compressed[jump_table_offset + 2 * i] = stream_size;
+                compressed[jump_table_offset + 2 * i + 1] = stream_size >> 8;
+            }
+        }
+    }
+
+    auto size = max(literals.size(), compressed.size());
+    u8 size_format;
+    size_t size_bits;
+    if (!has_four_streams) {
+        size_format = 0;
+        size_bits = 10;
+    } else if (size < (1u << 10)) {
+        size_format = 1;
+        size_bits = 10;
+    } else if (size < (1u << 14)) {
+        size_format = 2;
+        size_bits = 14;
+    } else {
+        size_format = 3;
+        size_bits = 18;
+    }
+    size_t header_size = size_format <= 1 ? 3 : size_format + 2;
+
+    if (compressed.size() + header_size >= literals.size() + 3)
+        return write_simple_literals(0);
+
+    TRY(write_header(0b10 | (size_format << 2) | (literals.size() << 4) | (static_cast<u64>(compressed.size()) << (4 + size_bits)), header_size));
+    TRY(output.try_append(compressed));
+    return {};
+}
+
+// RFC 8878 section 3.1.1.3.2
+ErrorOr<void> ZstdCompressor::write_sequences_section(ByteBuffer& output)
+{
+    auto const sequence_count = m_sequences.size();
+    if (sequence_count < 128) {
+        TRY(output.try_append(static_cast<u8>(sequence_count)));
+    } else if (sequence_count < 0x7f00) {
+        TRY(output.try_append(static_cast<u8>((sequence_count >> 8) + 128)));
+        TRY(output.try_append(static_cast<u8>(sequence_count)));
+    } else {
+        TRY(output.try_append(static_cast<u8>(255)));
+        TRY(output.try_append(static_cast<u8>(sequence_count - 0x7f00)));
+        TRY(output.try_append(static_cast<u8>((sequence_count - 0x7f00) >> 8)));
+    }
+    if (sequence_count == 0)
+        return {};
+
+    Vector<u8> literal_length_symbols;
+    Vector<u8> offset_symbols;
+    Vector<u8> match_length_symbols;
+    TRY(literal_length_symbols.try_ensure_capacity(sequence_count));
+    TRY(offset_symbols.try_ensure_capacity(sequence_count));
+    TRY(match_length_symbols.try_ensure_capacity(sequence_count));
+    for (auto const& sequence : m_sequences) {
+        literal_length_symbols.unchecked_append(literal_length_code(sequence.literal_length));
+        offset_symbols.unchecked_append(AK::log2(sequence.offset_value));
+        match_length_symbols.unchecked_append(match_length_code(sequence.match_length));
+    }
+
+    // Each symbol type uses whichever of the predefined table, a single repeated symbol or its own table is cheapest.
+    struct SymbolEncoding {
+        u8 mode { 0 };
+        Optional<FseEncoder> encoder;
+    };
+    auto choose_encoding = [&](ReadonlySpan<u8> symbols, ReadonlySpan<i16> default_distribution, u8 default_accuracy_log, u8 max_accuracy_log) -> ErrorOr<SymbolEncoding> {
+        Array<u32, match_length_max_symbol + 1> counts {};
+        size_t max_symbol = 0;
+        for (auto symbol : symbols) {
+            counts[symbol]++;
+            max_symbol = max<size_t>(max_symbol, symbol);
+        }
+        auto used_counts = ReadonlySpan<u32> { counts.data(), max_symbol + 1 };
+
+        if (counts[max_symbol] == symbols.size()) {
+            TRY(output.try_append(static_cast<u8>(max_symbol)));
+            return SymbolEncoding { 1, {} };
+        }
+
+        auto accuracy_log = fse_accuracy_log_for(symbols.size(), max_symbol, max_accuracy_log);
+        auto probabilities = TRY(normalize_fse_counts(used_counts, symbols.size(), accuracy_log));
+        ByteBuffer table_description;
+        TRY(write_fse_table(table_description, probabilities, accuracy_log));
+        auto custom_cost = fse_cost(used_counts, probabilities, accuracy_log).value() + table_description.size() * 8;
+
+        auto default_cost = fse_cost(used_counts, default_distribution, default_accuracy_log);
+        if (default_cost.has_value() && default_cost.value() <= custom_cost)
+            return SymbolEncoding { 0, TRY(FseEncoder::create(default_distribution, default_accuracy_log)) };
+
+        TRY(output.try_append(table_description));
+        return SymbolEncoding { 2, TRY(FseEncoder::create(probabilities, accuracy_log)) };
+    };
+
+    auto modes_offset = output.size();
+    TRY(output.try_append(static_cast<u8>(0)));
+    auto literal_lengths = TRY(choose_encoding(literal_length_symbols, literal_length_default_distribution, literal_length_default_accuracy_log, literal_length_max_accuracy_log));
+    auto offsets = TRY(choose_encoding(offset_symbols, offset_default_distribution, offset_default_accuracy_log, offset_max_accuracy_log));
+    auto match_lengths = TRY(choose_encoding(match_length_symbols, match_length_default_distribution, match_length_default_accuracy_log, match_length_max_accuracy_log));
+    output[modes_offset] = (literal_lengths.mode << 6) | (offsets.mode << 4) | (match_lengths.mode << 2);
+
+    // The sequences are written back to front, so that the decoder reads the first one first. The initial states
+    // come from the last sequence, and for every other sequence the symbols are encoded before the extra bits.
+    BitstreamWriter writer { output };
+    u32 literal_length_state = 0;
+    u32 offset_state = 0;
+    u32 match_length_state = 0;
+
+    auto write_extra_bits = [&](size_t i) -> ErrorOr<void> {
+        auto const& sequence = m_sequences[i];
+        auto const& literal_length_code = literal_length_codes[literal_length_symbols[i]];
+        TRY(writer.write_bits(sequence.literal_length - literal_length_code.baseline, literal_length_code.extra_bits));
+        auto const& match_length_code = match_length_codes[match_length_symbols[i]];
+        TRY(writer.write_bits(sequence.match_length - match_length_code.baseline, match_length_code.extra_bits));
+        TRY(writer.write_bits(sequence.offset_value - (1u << offset_symbols[i]), offset_symbols[i]));
+        return {};
+    };
+
+    auto last = sequence_count - 1;
+    if (match_lengths.encoder.has_value())
+        match_length_state = match_lengths.encoder->initial_state(match_length_symbols[last]);
+    if (offsets.encoder.has_value())
+        offset_state = offsets.encoder->initial_state(offset_symbols[last]);
+    if (literal_lengths.encoder.has_value())
+        literal_length_state = literal_lengths.encoder->initial_state(literal_length_symbols[last]);
+    TRY(write_extra_bits(last));
+
+    for (size_t i = last; i > 0; i--) {
+        if (offsets.encoder.has_value())
+            TRY(offsets.encoder->encode_symbol(writer, offset_state, offset_symbols[i - 1]));
+        if (match_lengths.encoder.has_value())
+            TRY(match_lengths.encoder->encode_symbol(writer, match_length_state, match_length_symbols[i - 1]));
+        if (literal_lengths.encoder.has_value())
+            TRY(literal_lengths.encoder->encode_symbol(writer, literal_length_state, literal_length_symbols[i - 1]));
+        TRY(write_extra_bits(i - 1));
+    }
+
+    if (match_lengths.encoder.has_value())
+        TRY(match_lengths.encoder->flush_state(writer, match_length_state));
+    if (offsets.encoder.has_value())
+        TRY(offsets.encoder->flush_state(writer, offset_state));
+    if (literal_lengths.encoder.has_value())
+        TRY(literal_lengths.encoder->flush_state(writer, literal_length_state));
+    TRY(writer.finish());
+    return {};
+}
+
+ErrorOr<ByteBuffer> ZstdCompressor::compress_all(ReadonlyBytes bytes, ZstdCompressorOptions const& options)
+{
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto compressor = TRY(ZstdCompressor::create(MaybeOwned<Stream>(*output_stream), options));
+
+    TRY(compressor->write_until_depleted(bytes));
+    TRY(compressor->flush());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer));
+    return buffer;
+}
+
+}
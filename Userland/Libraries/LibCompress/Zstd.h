@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/MaybeOwned.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/Stream.h>
+#include <AK/Vector.h>
+#include <LibCrypto/Checksum/XXHash64.h>
+
+namespace Compress {
+
+// RFC 8878 section 3.1.1
+constexpr u32 zstd_frame_magic = 0xFD2FB528;
+constexpr u32 zstd_skippable_frame_magic = 0x184D2A50; // The lowest four bits can have any value.
+constexpr u32 zstd_dictionary_magic = 0xEC30A437;
+
+// A decoding table for one of the FSE coded symbol types (RFC 8878 section 4.1.1).
+struct ZstdFseTable {
+    struct Entry {
+        u8 symbol;
+        u8 bit_count;
+        u16 baseline;
+    };
+
+    u8 accuracy_log { 0 };
+    Vector<Entry> entries;
+};
+
+// A decoding table for the Huffman coded literals (RFC 8878 section 4.2.1), indexed by the next max_bit_count bits of the stream.
+struct ZstdHuffmanTable {
+    struct Entry {
+        u8 symbol;
+        u8 bit_count;
+    };
+
+    u8 max_bit_count { 0 };
+    Vector<Entry> entries;
+};
+
+// The tables of the previous block, which later blocks can refer to instead of describing their own.
+struct ZstdEntropyTables {
+    Optional<ZstdHuffmanTable> literals;
+    Optional<ZstdFseTable> literal_lengths;
+    Optional<ZstdFseTable> offsets;
+    Optional<ZstdFseTable> match_lengths;
+};
+
+// A dictionary primes both the history and the entropy tables of every frame (RFC 8878 section 5).
+// Anything that doesn't start with the dictionary magic number is used as raw content.
+class ZstdDictionary : public RefCounted<ZstdDictionary> {
+public:
+    static ErrorOr<NonnullRefPtr<ZstdDictionary>> create(ReadonlyBytes);
+
+    u32 id() const { return m_id; }
+    ReadonlyBytes content() const { return m_content; }
+    ZstdEntropyTables const& entropy_tables() const { return m_entropy_tables; }
+    Array<u32, 3> const& repeat_offsets() const { return m_repeat_offsets; }
+
+private:
+    ZstdDictionary() = default;
+
+    u32 m_id { 0 };
+    ByteBuffer m_content;
+    ZstdEntropyTables m_entropy_tables;
+    Array<u32, 3> m_repeat_offsets { 1, 4, 8 };
+};
+
+class ZstdDecompressor final : public Stream {
+    AK_MAKE_NONCOPYABLE(ZstdDecompressor);
+    AK_MAKE_NONMOVABLE(ZstdDecompressor);
+
+public:
+    // Frames that need more than this much memory for their window are rejected, just like the reference decoder does by default.
+    static constexpr u64 max_window_size = 1ull << 27;
+
+    static ErrorOr<NonnullOwnPtr<ZstdDecompressor>> create(MaybeOwned<Stream>, RefPtr<ZstdDictionary const> = {});
+    ~ZstdDecompressor();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    static ErrorOr<ByteBuffer> decompress_all(ReadonlyBytes, RefPtr<ZstdDictionary const> = {});
+    static bool is_likely_compressed(ReadonlyBytes);
+
+private:
+    ZstdDecompressor(MaybeOwned<Stream>, RefPtr<ZstdDictionary const>);
+
+    // Returns false once the input has run out between two frames.
+    ErrorOr<bool> read_frame_header();
+    ErrorOr<void> read_frame_footer();
+    ErrorOr<void> decode_block();
+    ErrorOr<void> decode_compressed_block(ReadonlyBytes, Bytes output, size_t& output_size);
+    ErrorOr<void> decode_literals(ReadonlyBytes&);
+    ErrorOr<void> decode_and_execute_sequences(ReadonlyBytes, Bytes output, size_t& output_size);
+    ErrorOr<void> read_sequence_table(ReadonlyBytes&, u8 mode, Optional<ZstdFseTable>& table, ZstdFseTable const& predefined_table, u8 max_symbol, u8 max_accuracy_log);
+
+    MaybeOwned<Stream> m_stream;
+    RefPtr<ZstdDictionary const> m_dictionary;
+    bool m_is_in_frame { false };
+    bool m_is_eof { false };
+
+    // The state of the current frame.
+    u64 m_window_size { 0 };
+    u64 m_block_maximum_size { 0 };
+    Optional<u64> m_frame_content_size;
+    u64 m_frame_output_size { 0 };
+    bool m_has_content_checksum { false };
+    Crypto::Checksum::XXHash64 m_checksum;
+
+    // Holds (at least) a window of history, followed by the decompressed data that hasn't been read yet.
+    ByteBuffer m_window;
+    size_t m_read_position { 0 };
+
+    ByteBuffer m_block;
+    ByteBuffer m_literals_buffer;
+    ReadonlyBytes m_literals;
+    ZstdEntropyTables m_entropy_tables;
+    Array<u32, 3> m_repeat_offsets;
+};
+
+struct ZstdCompressorOptions {
+    // Back references can reach (1 << window_log) bytes back, this has to be in the range from 10 to 27.
+    u8 window_log { 21 };
+
+    // Appends the lowest 32 bits of the XXH64 hash of the uncompressed data to the frame.
+    bool include_checksum { true };
+
+    // The dictionary that the decompressor will have to use as well. Its content is used as history for the
+    // first back references, and its ID (if any) is stored in the frame header.
+    RefPtr<ZstdDictionary const> dictionary;
+};
+
+// Compresses its input into a single Zstandard frame, using a fast greedy match finder similar to the
+// reference encoder's lowest levels. Literals are Huffman coded, and the sequences use FSE tables that are
+// either predefined or fitted to the block.
+class ZstdCompressor final : public Stream {
+    AK_MAKE_NONCOPYABLE(ZstdCompressor);
+    AK_MAKE_NONMOVABLE(ZstdCompressor);
+
+public:
+    static constexpr u8 min_window_log = 10;
+    static constexpr u8 max_window_log = 27;
+
+    static ErrorOr<NonnullOwnPtr<ZstdCompressor>> create(MaybeOwned<Stream>, ZstdCompressorOptions const& = {});
+    ~ZstdCompressor();
+
+    /// Finishes the frame by compressing the remaining input, and writing out the last block and the checksum.
+    /// This has to be called once all of the input has been written.
+    ErrorOr<void> flush();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes, ZstdCompressorOptions const& = {});
+
+private:
+    static constexpr size_t hash_log = 16;
+
+    struct Sequence {
+        u32 literal_length;
+        u32 match_length;
+        u32 offset_value; // Either a repeat offset code (1 to 3), or the offset plus 3.
+    };
+
+    ZstdCompressor(MaybeOwned<Stream>, ZstdCompressorOptions const&);
+
+    ErrorOr<void> write_frame_header();
+    ErrorOr<void> compress_block(size_t length, bool is_last_block);
+    void find_sequences(size_t start, size_t end);
+    ErrorOr<void> write_literals_section(ByteBuffer&);
+    ErrorOr<void> write_sequences_section(ByteBuffer&);
+
+    MaybeOwned<Stream> m_output_stream;
+    ZstdCompressorOptions m_options;
+    bool m_has_flushed_data { false };
+    size_t m_block_size { 0 };
+    Crypto::Checksum::XXHash64 m_checksum;
+
+    // Holds the dictionary content and (at most a few windows of) history, followed by the input that hasn't been compressed yet.
+    ByteBuffer m_buffer;
+    u64 m_buffer_position { 0 }; // The position of the first byte in the buffer, relative to the start of the dictionary content.
+    size_t m_pending_start { 0 };
+
+    Vector<u32> m_hash_table; // Positions relative to the start of the dictionary content, plus one (so that zero is empty).
+    Array<u32, 3> m_repeat_offsets { 1, 4, 8 };
+
+    Vector<u8> m_literals;
+    Vector<Sequence> m_sequences;
+};
+
+}
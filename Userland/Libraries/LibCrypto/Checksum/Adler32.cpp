@@ -4,14 +4,107 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
+#if AK_IS_ARCH_X86_64()
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+#if AK_IS_ARCH_X86_64()
+
+static constexpr u32 adler32_modulus = 65521;
+
+// The largest number of bytes that can be summed up before the 32-bit sums have to be reduced (zlib's NMAX),
+// rounded down to a multiple of the block size.
+static constexpr size_t vectorized_block_size = 32;
+static constexpr size_t max_blocks_without_overflow = 5552 / vectorized_block_size;
+
+static ALWAYS_INLINE u32 horizontal_sum(__m128i sum)
+{
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<u32>(_mm_cvtsi128_si32(sum));
+}
+
+[[gnu::target("avx2")]] static ALWAYS_INLINE u32 horizontal_sum(__m256i sum)
+{
+    return horizontal_sum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+}
+
+// These sum up whole blocks of 32 bytes: the first sum is just the sum of all bytes, and the second one gets
+// every byte weighted by its distance to the end of the block, plus 32 times the first sum before each block.
+// Both sums are reduced at the end. Only the blocks are handled here; the caller is responsible for any remaining bytes.
+[[gnu::target("avx2")]] static void update_with_avx2(u32& state_a, u32& state_b, ReadonlyBytes& data)
+{
+    auto const weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm256_set1_epi16(1);
+    auto const zero = _mm256_setzero_si256();
+
+    while (data.size() >= vectorized_block_size) {
+        auto block_count = min(data.size() / vectorized_block_size, max_blocks_without_overflow);
+
+        auto sum_a = _mm256_setzero_si256();
+        auto sum_b = _mm256_setzero_si256();
+        auto previous_sums_a = _mm256_setzero_si256();
+        for (size_t i = 0; i < block_count; ++i) {
+            auto bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data.data() + i * vectorized_block_size));
+            previous_sums_a = _mm256_add_epi32(previous_sums_a, sum_a);
+            sum_a = _mm256_add_epi32(sum_a, _mm256_sad_epu8(bytes, zero));
+            sum_b = _mm256_add_epi32(sum_b, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+        }
+        sum_b = _mm256_add_epi32(sum_b, _mm256_slli_epi32(previous_sums_a, 5));
+
+        state_b = (state_b + state_a * block_count * vectorized_block_size + horizontal_sum(sum_b)) % adler32_modulus;
+        state_a = (state_a + horizontal_sum(sum_a)) % adler32_modulus;
+        data = data.slice(block_count * vectorized_block_size);
+    }
+}
+
+[[gnu::target("ssse3")]] static void update_with_ssse3(u32& state_a, u32& state_b, ReadonlyBytes& data)
+{
+    auto const first_half_weights = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    auto const second_half_weights = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm_set1_epi16(1);
+    auto const zero = _mm_setzero_si128();
+
+    while (data.size() >= vectorized_block_size) {
+        auto block_count = min(data.size() / vectorized_block_size, max_blocks_without_overflow);
+
+        auto sum_a = _mm_setzero_si128();
+        auto sum_b = _mm_setzero_si128();
+        auto previous_sums_a = _mm_setzero_si128();
+        for (size_t i = 0; i < block_count; ++i) {
+            auto first_half = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data.data() + i * vectorized_block_size));
+            auto second_half = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data.data() + i * vectorized_block_size + 16));
+            previous_sums_a = _mm_add_epi32(previous_sums_a, sum_a);
+            sum_a = _mm_add_epi32(sum_a, _mm_add_epi32(_mm_sad_epu8(first_half, zero), _mm_sad_epu8(second_half, zero)));
+            sum_b = _mm_add_epi32(sum_b, _mm_madd_epi16(_mm_maddubs_epi16(first_half, first_half_weights), ones));
+            sum_b = _mm_add_epi32(sum_b, _mm_madd_epi16(_mm_maddubs_epi16(second_half, second_half_weights), ones));
+        }
+        sum_b = _mm_add_epi32(sum_b, _mm_slli_epi32(previous_sums_a, 5));
+
+        state_b = (state_b + state_a * block_count * vectorized_block_size + horizontal_sum(sum_b)) % adler32_modulus;
+        state_a = (state_a + horizontal_sum(sum_a)) % adler32_modulus;
+        data = data.slice(block_count * vectorized_block_size);
+    }
+}
+
+#endif
+
 void Adler32::update(ReadonlyBytes data)
 {
+#if AK_IS_ARCH_X86_64()
+    if (__builtin_cpu_supports("avx2"))
+        update_with_avx2(m_state_a, m_state_b, data);
+    else if (__builtin_cpu_supports("ssse3"))
+        update_with_ssse3(m_state_a, m_state_b, data);
+#endif
+
     // See https://github.com/SerenityOS/serenity/pull/24408#discussion_r1609051678
     constexpr size_t iterations_without_overflow = 380368439;
 
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Endian.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Checksum/CRC64.h>
+
+namespace Crypto::Checksum {
+
+static constexpr u64 ecma_182_polynomial = 0xC96C5795D7870F42;
+
+// Just like CRC32, this uses the slicing-by-8 algorithm.
+static constexpr auto generate_table()
+{
+    Array<Array<u64, 256>, 8> data {};
+
+    for (u64 i = 0; i < 256; ++i) {
+        auto value = i;
+
+        for (size_t j = 0; j < 8; ++j)
+            value = (value >> 1) ^ ((value & 1) * ecma_182_polynomial);
+
+        data[0][i] = value;
+    }
+
+    for (u32 i = 0; i < 256; ++i) {
+        for (size_t j = 1; j < 8; ++j)
+            data[j][i] = (data[j - 1][i] >> 8) ^ data[0][data[j - 1][i] & 0xff];
+    }
+
+    return data;
+}
+
+static constexpr auto table = generate_table();
+
+static constexpr u64 single_byte_crc(u64 crc, u8 byte)
+{
+    return (crc >> 8) ^ table[0][(crc & 0xff) ^ byte];
+}
+
+void CRC64::update(ReadonlyBytes data)
+{
+    auto state = m_state;
+
+    while (data.size() >= 8) {
+        u64 segment;
+        __builtin_memcpy(&segment, data.data(), sizeof(segment));
+        segment = AK::convert_between_host_and_little_endian(segment) ^ state;
+
+        state = table[7][segment & 0xff]
+            ^ table[6][(segment >> 8) & 0xff]
+            ^ table[5][(segment >> 16) & 0xff]
+            ^ table[4][(segment >> 24) & 0xff]
+            ^ table[3][(segment >> 32) & 0xff]
+            ^ table[2][(segment >> 40) & 0xff]
+            ^ table[1][(segment >> 48) & 0xff]
+            ^ table[0][segment >> 56];
+
+        data = data.slice(8);
+    }
+
+    for (auto byte : data)
+        state = single_byte_crc(state, byte);
+
+    m_state = state;
+}
+
+u64 CRC64::digest()
+{
+    return ~m_state;
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Checksum/ChecksumFunction.h>
+
+namespace Crypto::Checksum {
+
+// The CRC-64 variant from ECMA-182 in its reflected form, as used by XZ.
+class CRC64 : public ChecksumFunction<u64> {
+public:
+    CRC64() = default;
+    CRC64(ReadonlyBytes data)
+    {
+        update(data);
+    }
+
+    virtual void update(ReadonlyBytes data) override;
+    virtual u64 digest() override;
+
+private:
+    u64 m_state { ~0ull };
+};
+
+}
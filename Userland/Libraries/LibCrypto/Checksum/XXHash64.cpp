@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Checksum/XXHash64.h>
+
+namespace Crypto::Checksum {
+
+static constexpr u64 prime_1 = 0x9E3779B185EBCA87;
+static constexpr u64 prime_2 = 0xC2B2AE3D27D4EB4F;
+static constexpr u64 prime_3 = 0x165667B19E3779F9;
+static constexpr u64 prime_4 = 0x85EBCA77C2B2AE63;
+static constexpr u64 prime_5 = 0x27D4EB2F165667C5;
+
+static constexpr size_t stripe_size = 32;
+
+static ALWAYS_INLINE u64 rotate_left(u64 value, u8 bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static ALWAYS_INLINE u64 read_u64(u8 const* data)
+{
+    u64 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+static ALWAYS_INLINE u32 read_u32(u8 const* data)
+{
+    u32 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+static ALWAYS_INLINE u64 round(u64 accumulator, u64 input)
+{
+    accumulator += input * prime_2;
+    accumulator = rotate_left(accumulator, 31);
+    return accumulator * prime_1;
+}
+
+static ALWAYS_INLINE u64 merge_round(u64 hash, u64 accumulator)
+{
+    hash ^= round(0, accumulator);
+    return hash * prime_1 + prime_4;
+}
+
+static ALWAYS_INLINE void consume_stripe(Array<u64, 4>& accumulators, u8 const* stripe)
+{
+    for (size_t i = 0; i < accumulators.size(); ++i)
+        accumulators[i] = round(accumulators[i], read_u64(stripe + i * sizeof(u64)));
+}
+
+XXHash64::XXHash64(u64 seed)
+    : m_seed(seed)
+    , m_accumulators({ seed + prime_1 + prime_2, seed + prime_2, seed, seed - prime_1 })
+{
+}
+
+void XXHash64::update(ReadonlyBytes data)
+{
+    m_total_size += data.size();
+
+    if (m_buffer_size > 0) {
+        auto bytes_to_copy = min(data.size(), stripe_size - m_buffer_size);
+        __builtin_memcpy(m_buffer.data() + m_buffer_size, data.data(), bytes_to_copy);
+        m_buffer_size += bytes_to_copy;
+        data = data.slice(bytes_to_copy);
+
+        if (m_buffer_size < stripe_size)
+            return;
+
+        consume_stripe(m_accumulators, m_buffer.data());
+        m_buffer_size = 0;
+    }
+
+    auto accumulators = m_accumulators;
+    while (data.size() >= stripe_size) {
+        consume_stripe(accumulators, data.data());
+        data = data.slice(stripe_size);
+    }
+    m_accumulators = accumulators;
+
+    __builtin_memcpy(m_buffer.data(), data.data(), data.size());
+    m_buffer_size = data.size();
+}
+
+u64 XXHash64::digest()
+{
+    u64 hash;
+    if (m_total_size >= stripe_size) {
+        hash = rotate_left(m_accumulators[0], 1) + rotate_left(m_accumulators[1], 7) + rotate_left(m_accumulators[2], 12) + rotate_left(m_accumulators[3], 18);
+        for (auto accumulator : m_accumulators)
+            hash = merge_round(hash, accumulator);
+    } else {
+        hash = m_seed + prime_5;
+    }
+    hash += m_total_size;
+
+    // The bytes that didn't make up a whole stripe are mixed in one by one, in pieces of 8, 4 and 1 bytes.
+    auto remaining = ReadonlyBytes { m_buffer.data(), m_buffer_size };
+    while (remaining.size() >= 8) {
+        hash ^= round(0, read_u64(remaining.data()));
+        hash = rotate_left(hash, 27) * prime_1 + prime_4;
+        remaining = remaining.slice(8);
+    }
+    if (remaining.size() >= 4) {
+        hash ^= read_u32(remaining.data()) * prime_1;
+        hash = rotate_left(hash, 23) * prime_2 + prime_3;
+        remaining = remaining.slice(4);
+    }
+    for (auto byte : remaining) {
+        hash ^= byte * prime_5;
+        hash = rotate_left(hash, 11) * prime_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime_2;
+    hash ^= hash >> 29;
+    hash *= prime_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+}
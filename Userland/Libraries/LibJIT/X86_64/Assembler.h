@@ -303,15 +303,21 @@ struct X86_64Assembler {
         emit8(rex.raw);
     }
 
-    void shift_right(Operand dst, Operand count)
+    void shift_right(Operand dst, Optional<Operand> count)
     {
         VERIFY(dst.type == Operand::Type::Reg);
-        VERIFY(count.type == Operand::Type::Imm);
-        VERIFY(count.fits_in_u8());
-        emit_rex_for_slash(dst, REX_W::Yes);
-        emit8(0xc1);
-        emit_modrm_slash(5, dst);
-        emit8(count.offset_or_immediate);
+        if (count.has_value()) {
+            VERIFY(count->type == Operand::Type::Imm);
+            VERIFY(count->fits_in_u8());
+            emit_rex_for_slash(dst, REX_W::Yes);
+            emit8(0xc1);
+            emit_modrm_slash(5, dst);
+            emit8(count->offset_or_immediate);
+        } else {
+            emit_rex_for_slash(dst, REX_W::Yes);
+            emit8(0xd3);
+            emit_modrm_slash(5, dst);
+        }
     }
 
     void mov(Operand dst, Operand src, Patchable patchable = Patchable::No)
@@ -385,6 +391,15 @@ struct X86_64Assembler {
 
     void mov8(Operand dst, Operand src, Extension extension = Extension::ZeroExtend)
     {
+        if (dst.type == Operand::Type::Mem64BaseAndOffset && src.type == Operand::Type::Reg) {
+            // mov r/m8, r8
+            // NOTE: Without a REX prefix, the encodings for SPL, BPL, SIL and DIL mean AH, CH, DH and BH instead.
+            VERIFY(to_underlying(src.reg) < 4 || to_underlying(src.reg) >= 8);
+            emit_rex_for_mr(dst, src, REX_W::No);
+            emit8(0x88);
+            emit_modrm_mr(dst, src);
+            return;
+        }
         VERIFY(dst.type == Operand::Type::Reg && src.type == Operand::Type::Mem64BaseAndOffset);
         // mov[sz]x r32, r/m8
         emit_rex_for_rm(dst, src, REX_W::No);
@@ -395,6 +410,14 @@ struct X86_64Assembler {
 
     void mov16(Operand dst, Operand src, Extension extension = Extension::ZeroExtend)
     {
+        if (dst.type == Operand::Type::Mem64BaseAndOffset && src.type == Operand::Type::Reg) {
+            // mov r/m16, r16
+            emit8(0x66);
+            emit_rex_for_mr(dst, src, REX_W::No);
+            emit8(0x89);
+            emit_modrm_mr(dst, src);
+            return;
+        }
         VERIFY(dst.type == Operand::Type::Reg && src.is_register_or_memory());
         // mov[sz]x r32, r/m16
         emit_rex_for_rm(dst, src, REX_W::No);
@@ -405,6 +428,13 @@ struct X86_64Assembler {
 
     void mov32(Operand dst, Operand src, Extension extension = Extension::ZeroExtend)
     {
+        if (dst.type == Operand::Type::Mem64BaseAndOffset && src.type == Operand::Type::Reg) {
+            // mov r/m32, r32
+            emit_rex_for_mr(dst, src, REX_W::No);
+            emit8(0x89);
+            emit_modrm_mr(dst, src);
+            return;
+        }
         VERIFY(dst.type == Operand::Type::Reg && src.is_register_or_memory());
         if (extension == Extension::ZeroExtend) {
             // mov r32, r/m32
@@ -506,6 +536,17 @@ struct X86_64Assembler {
         emit_modrm_slash(4, op);
     }
 
+    void load_label_address(Operand dst, Label& label)
+    {
+        VERIFY(dst.type == Operand::Type::Reg);
+        // lea dst, [rip + offset]
+        emit_rex_for_mr(Operand::Register(Reg::RAX), dst, REX_W::Yes);
+        emit8(0x8d);
+        emit8(0x05 | (encode_reg(dst.reg) << 3));
+        emit32(0xdeadbeef);
+        label.add_jump(*this, m_output.size());
+    }
+
     void verify_not_reached()
     {
         // ud2
@@ -640,6 +681,18 @@ struct X86_64Assembler {
         }
     }
 
+    void bitwise_xor(Operand dst, Operand src)
+    {
+        // xor dst,src
+        if (dst.is_register_or_memory() && src.type == Operand::Type::Reg) {
+            emit_rex_for_mr(dst, src, REX_W::Yes);
+            emit8(0x31);
+            emit_modrm_mr(dst, src);
+        } else {
+            VERIFY_NOT_REACHED();
+        }
+    }
+
     void bitwise_xor32(Operand dst, Operand src)
     {
         if (dst.is_register_or_memory() && src.type == Operand::Type::Reg) {
@@ -668,6 +721,12 @@ struct X86_64Assembler {
             emit8(0x0f);
             emit8(0x59);
             emit_modrm_rm(dest, src);
+        } else if (dest.type == Operand::Type::Reg && src.is_register_or_memory()) {
+            // imul dest, src (64-bit)
+            emit_rex_for_rm(dest, src, REX_W::Yes);
+            emit8(0x0f);
+            emit8(0xaf);
+            emit_modrm_rm(dest, src);
         } else {
             VERIFY_NOT_REACHED();
         }
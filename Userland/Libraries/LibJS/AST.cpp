@@ -15,6 +15,8 @@
 #include <AK/TemporaryChange.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
+#include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Heap/ConservativeVector.h>
 #include <LibJS/Heap/MarkedVector.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -1646,6 +1648,42 @@ void ScopeNode::block_declaration_instantiation(VM& vm, Environment* environment
     }));
 }
 
+FunctionBody::FunctionBody(SourceRange source_range)
+    : ScopeNode(move(source_range))
+{
+}
+
+FunctionBody::~FunctionBody() = default;
+
+void FunctionBody::set_fully_parsed_function(NonnullRefPtr<FunctionExpression const> function) const
+{
+    VERIFY(is_lazy());
+    m_fully_parsed_function = move(function);
+}
+
+Program::Program(SourceRange source_range, Type program_type)
+    : ScopeNode(move(source_range))
+    , m_type(program_type)
+{
+}
+
+Program::~Program() = default;
+
+void Program::set_bytecode_cache(Badge<Bytecode::BytecodeCache>, NonnullRefPtr<Bytecode::BytecodeCache> cache) const
+{
+    m_bytecode_cache = move(cache);
+}
+
+OwnPtr<Bytecode::UnlinkedExecutable> Program::take_unlinked_executable() const
+{
+    return move(m_unlinked_executable);
+}
+
+void Program::set_unlinked_executable(NonnullOwnPtr<Bytecode::UnlinkedExecutable> unlinked_executable)
+{
+    m_unlinked_executable = move(unlinked_executable);
+}
+
 // 16.1.7 GlobalDeclarationInstantiation ( script, env ), https://tc39.es/ecma262/#sec-globaldeclarationinstantiation
 ThrowCompletionOr<void> Program::global_declaration_instantiation(VM& vm, GlobalEnvironment& global_environment) const
 {
@@ -39,6 +39,7 @@ namespace JS {
 class Declaration;
 class ClassDeclaration;
 class FunctionDeclaration;
+class FunctionExpression;
 class Identifier;
 class MemberExpression;
 class VariableDeclaration;
@@ -86,6 +87,7 @@ public:
     virtual bool is_identifier() const { return false; }
     virtual bool is_private_identifier() const { return false; }
     virtual bool is_scope_node() const { return false; }
+    virtual bool is_function_body() const { return false; }
     virtual bool is_program() const { return false; }
     virtual bool is_class_declaration() const { return false; }
     virtual bool is_function_declaration() const { return false; }
@@ -520,11 +522,7 @@ public:
         Module
     };
 
-    explicit Program(SourceRange source_range, Type program_type)
-        : ScopeNode(move(source_range))
-        , m_type(program_type)
-    {
-    }
+    explicit Program(SourceRange source_range, Type program_type);
 
     bool is_strict_mode() const { return m_is_strict_mode; }
     void set_strict_mode() { m_is_strict_mode = true; }
@@ -554,6 +552,21 @@ public:
 
     ThrowCompletionOr<void> global_declaration_instantiation(VM&, GlobalEnvironment&) const;
 
+    // Every function, class and scope node in this program (including itself) in the order they were parsed,
+    // if the parser was asked to record them. The bytecode cache refers to these nodes by their position here.
+    Vector<NonnullRefPtr<ASTNode const>> const& nodes_referenced_by_bytecode() const { return m_nodes_referenced_by_bytecode; }
+    void set_nodes_referenced_by_bytecode(Badge<Parser>, Vector<NonnullRefPtr<ASTNode const>> nodes) { m_nodes_referenced_by_bytecode = move(nodes); }
+
+    Bytecode::BytecodeCache* bytecode_cache() const { return m_bytecode_cache.ptr(); }
+    void set_bytecode_cache(Badge<Bytecode::BytecodeCache>, NonnullRefPtr<Bytecode::BytecodeCache>) const;
+
+    // The bytecode for the top-level code, if it was generated along with parsing on another thread (see BackgroundParser).
+    // It's linked into an executable when the program first runs.
+    OwnPtr<Bytecode::UnlinkedExecutable> take_unlinked_executable() const;
+    void set_unlinked_executable(NonnullOwnPtr<Bytecode::UnlinkedExecutable>);
+
+    virtual ~Program() override;
+
 private:
     virtual bool is_program() const override { return true; }
 
@@ -563,6 +576,10 @@ private:
     Vector<NonnullRefPtr<ImportStatement const>> m_imports;
     Vector<NonnullRefPtr<ExportStatement const>> m_exports;
     bool m_has_top_level_await { false };
+
+    Vector<NonnullRefPtr<ASTNode const>> m_nodes_referenced_by_bytecode;
+    mutable RefPtr<Bytecode::BytecodeCache> m_bytecode_cache;
+    mutable OwnPtr<Bytecode::UnlinkedExecutable> m_unlinked_executable;
 };
 
 class BlockStatement final : public ScopeNode {
@@ -575,17 +592,37 @@ public:
 
 class FunctionBody final : public ScopeNode {
 public:
-    explicit FunctionBody(SourceRange source_range)
-        : ScopeNode(move(source_range))
-    {
-    }
+    explicit FunctionBody(SourceRange source_range);
+    virtual ~FunctionBody() override;
 
     void set_strict_mode() { m_in_strict_mode = true; }
 
     bool in_strict_mode() const { return m_in_strict_mode; }
 
+    virtual bool is_function_body() const override { return true; }
+
+    // When parsing function bodies lazily, the parser only checks the tokens of a function body and leaves it empty.
+    // This is what it takes to parse the whole function again once it is first called.
+    struct LazyParseState {
+        Position parameters_start;
+        size_t end_offset { 0 };
+        u16 parse_options { 0 };
+        bool in_strict_mode { false };
+        Program::Type program_type { Program::Type::Script };
+    };
+
+    bool is_lazy() const { return m_lazy_parse_state.has_value(); }
+    LazyParseState const& lazy_parse_state() const { return *m_lazy_parse_state; }
+    void set_lazy_parse_state(Badge<Parser>, LazyParseState state) { m_lazy_parse_state = move(state); }
+
+    // The function parsed again in full, shared by every function object created from a lazy body.
+    FunctionExpression const* fully_parsed_function() const { return m_fully_parsed_function.ptr(); }
+    void set_fully_parsed_function(NonnullRefPtr<FunctionExpression const>) const;
+
 private:
     bool m_in_strict_mode { false };
+    Optional<LazyParseState> m_lazy_parse_state;
+    mutable RefPtr<FunctionExpression const> m_fully_parsed_function;
 };
 
 class Expression : public ASTNode {
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/Event.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/EventReceiver.h>
+#include <LibJS/AST.h>
+#include <LibJS/BackgroundParser.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Script.h>
+#include <LibJS/SourceTextModule.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace JS {
+
+static Threading::ThreadPool<Function<void()>>& thread_pool()
+{
+    static Threading::ThreadPool<Function<void()>> thread_pool { [](Function<void()> work) { work(); } };
+    return thread_pool;
+}
+
+static void generate_bytecode(VM& vm, Program& program)
+{
+    // NOTE: Modules with top-level await are compiled as async functions instead, and the bytecode cache would rather
+    //       load the bytecode from disk.
+    if (program.has_top_level_await() || Bytecode::BytecodeCache::is_enabled())
+        return;
+
+    // NOTE: If the program can't be compiled, it's left to fail the same way once it runs.
+    if (auto unlinked_executable = Bytecode::Generator::generate_unlinked_from_ast_node(vm, program); !unlinked_executable.is_error())
+        program.set_unlinked_executable(unlinked_executable.release_value());
+}
+
+// NOTE: Reference counts aren't atomic, so nothing that is reference counted is ever used by both threads at the same time.
+//       The job is only referenced from the origin thread, which keeps it alive until the background thread posts it an
+//       event once it's done with everything. The program it parsed isn't referenced from there anymore by then.
+class BackgroundParseJob final : public Core::EventReceiver {
+    C_OBJECT(BackgroundParseJob);
+
+public:
+    void start(VM& vm, Program::Type program_type, StringView source_text, StringView filename, size_t line_number_offset)
+    {
+        m_keep_alive = this;
+        auto& origin_event_loop = Core::EventLoop::current();
+        thread_pool().submit([this, &vm, &origin_event_loop, program_type, source_text = ByteString { source_text }, filename = ByteString { filename }, line_number_offset] {
+            auto result = program_type == Program::Type::Script
+                ? Script::parse_program(source_text, filename, line_number_offset)
+                : SourceTextModule::parse_program(source_text, filename);
+            if (!result.is_error())
+                generate_bytecode(vm, *result.value());
+
+            m_result = move(result);
+            origin_event_loop.post_event(*this, make<Core::CustomEvent>(0));
+        });
+    }
+
+private:
+    explicit BackgroundParseJob(Function<void(BackgroundParser::ParseResult)> on_complete)
+        : m_on_complete(move(on_complete))
+    {
+    }
+
+    virtual void custom_event(Core::CustomEvent&) override
+    {
+        m_keep_alive = nullptr;
+        m_on_complete(m_result.release_value());
+    }
+
+    Function<void(BackgroundParser::ParseResult)> m_on_complete;
+    Optional<BackgroundParser::ParseResult> m_result;
+    RefPtr<BackgroundParseJob> m_keep_alive;
+};
+
+static void parse_in_background(VM& vm, Program::Type program_type, StringView source_text, StringView filename, size_t line_number_offset, Function<void(BackgroundParser::ParseResult)> on_complete)
+{
+    BackgroundParseJob::construct(move(on_complete))->start(vm, program_type, source_text, filename, line_number_offset);
+}
+
+void BackgroundParser::parse_script(VM& vm, StringView source_text, StringView filename, size_t line_number_offset, Function<void(ParseResult)> on_complete)
+{
+    parse_in_background(vm, Program::Type::Script, source_text, filename, line_number_offset, move(on_complete));
+}
+
+void BackgroundParser::parse_module(VM& vm, StringView source_text, StringView filename, Function<void(ParseResult)> on_complete)
+{
+    parse_in_background(vm, Program::Type::Module, source_text, filename, 1, move(on_complete));
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Result.h>
+#include <AK/StringView.h>
+#include <LibJS/Forward.h>
+#include <LibJS/ParserError.h>
+
+namespace JS {
+
+// Parses classic scripts and modules on a background thread, so that the thread running JavaScript stays responsive
+// while large scripts are being parsed. The bytecode for the program's top-level code is generated there as well.
+// The parsed program is handed back on the event loop of the thread that started parsing, which has to keep running
+// until then. There, it can be turned into a Script or SourceTextModule with their create() functions, and its bytecode
+// is linked into an executable when it first runs. Function bodies are compiled on first call, as usual.
+class BackgroundParser {
+public:
+    using ParseResult = Result<NonnullRefPtr<Program>, Vector<ParserError>>;
+
+    static void parse_script(VM&, StringView source_text, StringView filename, size_t line_number_offset, Function<void(ParseResult)> on_complete);
+    static void parse_module(VM&, StringView source_text, StringView filename, Function<void(ParseResult)> on_complete);
+};
+
+}
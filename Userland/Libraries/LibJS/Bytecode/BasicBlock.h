@@ -30,6 +30,7 @@ public:
     ~BasicBlock();
 
     u32 index() const { return m_index; }
+    void set_index(u32 index) { m_index = index; }
 
     ReadonlyBytes instruction_stream() const { return m_buffer.span(); }
     u8* data() { return m_buffer.data(); }
@@ -44,6 +45,9 @@ public:
 
     void grow(size_t additional_size);
 
+    // Replaces the instructions of this block, see BasicBlockRewriter.
+    void set_instruction_stream(Vector<u8> buffer, HashMap<size_t, SourceRecord> source_map, size_t last_instruction_start_offset, bool is_terminated);
+
     void terminate(Badge<Generator>) { m_terminated = true; }
     bool is_terminated() const { return m_terminated; }
 
@@ -0,0 +1,802 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <AK/HashTable.h>
+#include <AK/MemoryStream.h>
+#include <AK/StringBuilder.h>
+#include <AK/Utf8View.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
+#include <LibCrypto/BigInt/SignedBigInteger.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/RegexTable.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/BigInt.h>
+#include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Runtime/PrimitiveString.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibJS/SourceTextModule.h>
+#include <LibRegex/Regex.h>
+
+namespace JS::Bytecode {
+
+static constexpr u32 CACHE_FILE_MAGIC = 0x4342534a; // "JSBC"
+static constexpr u32 CACHE_FORMAT_VERSION = 1;
+
+static Optional<ByteString>& cache_directory()
+{
+    static Optional<ByteString> directory = []() -> Optional<ByteString> {
+        auto const* directory = getenv("LIBJS_BYTECODE_CACHE");
+        if (!directory || !*directory)
+            return {};
+        return ByteString { directory };
+    }();
+    return directory;
+}
+
+bool BytecodeCache::is_enabled()
+{
+    return cache_directory().has_value();
+}
+
+void BytecodeCache::set_directory(ByteString directory)
+{
+    if (directory.is_empty())
+        cache_directory() = {};
+    else
+        cache_directory() = move(directory);
+}
+
+// Instructions are stored exactly as they are laid out in memory, so files written by a build with different
+// instructions can't be used. This catches most such changes, the rest have to bump CACHE_FORMAT_VERSION.
+static u32 instruction_layout_fingerprint()
+{
+    u32 fingerprint = CACHE_FORMAT_VERSION;
+#define __BYTECODE_OP(op) \
+    fingerprint = pair_int_hash(fingerprint, sizeof(Op::op));
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    fingerprint = pair_int_hash(fingerprint, sizeof(Operand));
+    fingerprint = pair_int_hash(fingerprint, sizeof(Label));
+    fingerprint = pair_int_hash(fingerprint, sizeof(Optional<Operand>));
+    fingerprint = pair_int_hash(fingerprint, sizeof(Optional<IdentifierTableIndex>));
+    return fingerprint;
+}
+
+enum class ConstantTag : u8 {
+    Empty,
+    Undefined,
+    Null,
+    Boolean,
+    Number,
+    String,
+    BigInt,
+};
+
+static ErrorOr<void> write_bytes(Stream& stream, ReadonlyBytes bytes)
+{
+    TRY(stream.write_value<LittleEndian<u32>>(bytes.size()));
+    TRY(stream.write_until_depleted(bytes));
+    return {};
+}
+
+static ErrorOr<ReadonlyBytes> read_bytes(FixedMemoryStream& stream)
+{
+    auto size = TRY(stream.read_value<LittleEndian<u32>>());
+    if (size > stream.remaining())
+        return AK::Error::from_string_literal("Bytecode cache record is truncated");
+    auto bytes = TRY(stream.read_in_place<u8 const>(size));
+    return bytes;
+}
+
+static ErrorOr<void> write_size(Stream& stream, size_t value)
+{
+    TRY(stream.write_value<LittleEndian<u64>>(value));
+    return {};
+}
+
+static ErrorOr<size_t> read_size(FixedMemoryStream& stream)
+{
+    return TRY(stream.read_value<LittleEndian<u64>>());
+}
+
+namespace {
+
+// Everything the instructions of a decoded executable may refer to.
+struct ReferenceLimits {
+    size_t number_of_registers { 0 };
+    size_t number_of_constants { 0 };
+    size_t number_of_locals { 0 };
+    size_t number_of_arguments { 0 };
+    size_t number_of_strings { 0 };
+    size_t number_of_identifiers { 0 };
+    size_t number_of_regexes { 0 };
+    size_t number_of_property_lookup_caches { 0 };
+    size_t number_of_global_variable_caches { 0 };
+    HashTable<size_t> const& instruction_offsets;
+};
+
+}
+
+static bool is_valid_operand(Operand operand, ReferenceLimits const& limits)
+{
+    auto first_constant = limits.number_of_registers;
+    auto first_local = first_constant + limits.number_of_constants;
+    switch (operand.type()) {
+    case Operand::Type::Register:
+        return operand.index() < first_constant;
+    case Operand::Type::Constant:
+        return operand.index() >= first_constant && operand.index() < first_local;
+    case Operand::Type::Local:
+        return operand.index() >= first_local && operand.index() - first_local < limits.number_of_locals;
+    }
+    return false;
+}
+
+static bool is_valid_index(IdentifierTableIndex index, ReferenceLimits const& limits)
+{
+    return index.value < limits.number_of_identifiers;
+}
+
+static bool is_valid_index(StringTableIndex index, ReferenceLimits const& limits)
+{
+    return index.value() < limits.number_of_strings;
+}
+
+static bool is_valid_index(RegexTableIndex index, ReferenceLimits const& limits)
+{
+    return index.value() < limits.number_of_regexes;
+}
+
+// NOTE: Operands are checked separately, for all instructions at once.
+static bool is_valid_index(Operand, ReferenceLimits const&)
+{
+    return true;
+}
+
+template<typename T>
+static bool is_valid_index(Optional<T> const& index, ReferenceLimits const& limits)
+{
+    return !index.has_value() || is_valid_index(*index, limits);
+}
+
+// NOTE: Instructions that refer to anything other than operands and labels have to be handled here,
+//       otherwise cached bytecode could make them index past the end of a table.
+template<typename OpType>
+static bool has_valid_references(OpType const& op, ReferenceLimits const& limits)
+{
+#define __CHECK_INDEX(accessor)                     \
+    if constexpr (requires { op.accessor(); }) {    \
+        if (!is_valid_index(op.accessor(), limits)) \
+            return false;                           \
+    }
+    __CHECK_INDEX(identifier)
+    __CHECK_INDEX(property)
+    __CHECK_INDEX(base_identifier)
+    __CHECK_INDEX(name)
+    __CHECK_INDEX(lhs_name)
+    __CHECK_INDEX(expression_string)
+    __CHECK_INDEX(error_string)
+    __CHECK_INDEX(source_index)
+    __CHECK_INDEX(flags_index)
+    __CHECK_INDEX(regex_index)
+#undef __CHECK_INDEX
+
+    if constexpr (IsSame<OpType, Op::GetGlobal>) {
+        if (op.cache_index() >= limits.number_of_global_variable_caches)
+            return false;
+    } else if constexpr (requires { op.cache_index(); }) {
+        if (op.cache_index() >= limits.number_of_property_lookup_caches)
+            return false;
+    }
+
+    if constexpr (IsOneOf<OpType, Op::GetArgument, Op::SetArgument>) {
+        if (op.index() >= limits.number_of_arguments)
+            return false;
+    }
+
+    // Environment coordinates are only filled in while running, and records are written before that.
+    if constexpr (requires { op.cache(); }) {
+        if (op.cache().is_valid())
+            return false;
+    }
+
+    if constexpr (requires { op.builtin(); }) {
+        if (op.builtin().has_value() && to_underlying(*op.builtin()) >= to_underlying(Builtin::__Count))
+            return false;
+    }
+
+    // NOTE: A cell would be a pointer into the heap of whoever wrote the record.
+    if constexpr (requires { op.completion_value(); }) {
+        if (op.completion_value().has_value() && op.completion_value()->is_cell())
+            return false;
+    }
+
+    return true;
+}
+
+static bool has_valid_references(Instruction& instruction, ReferenceLimits const& limits)
+{
+    bool is_valid = true;
+    instruction.visit_operands([&](Operand& operand) {
+        is_valid = is_valid && is_valid_operand(operand, limits);
+    });
+    instruction.visit_labels([&](Label& label) {
+        is_valid = is_valid && limits.instruction_offsets.contains(label.address());
+    });
+    if (!is_valid)
+        return false;
+
+    switch (instruction.type()) {
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return has_valid_references(static_cast<Op::op const&>(instruction), limits);
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+static bool is_terminator(Instruction::Type type)
+{
+    switch (type) {
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return Op::op::IsTerminator;
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+BytecodeCache::BytecodeCache(Program const& program, ByteString path)
+    : m_program(program)
+    , m_path(move(path))
+{
+}
+
+BytecodeCache::~BytecodeCache()
+{
+    flush();
+}
+
+RefPtr<BytecodeCache> BytecodeCache::for_program(Program const& program)
+{
+    if (auto* cache = program.bytecode_cache())
+        return cache;
+
+    // NOTE: Programs that weren't parsed for the cache (e.g. eval code) have no way to refer to their nodes.
+    if (!is_enabled() || program.nodes_referenced_by_bytecode().is_empty())
+        return nullptr;
+
+    auto digest = Crypto::Hash::SHA256::hash(program.source_code().code().bytes_as_string_view());
+
+    StringBuilder path;
+    path.append(*cache_directory());
+    path.append('/');
+    for (auto byte : digest.bytes())
+        path.appendff("{:02x}", byte);
+    path.append(".jsbc"sv);
+
+    auto cache = adopt_ref(*new BytecodeCache(program, path.to_byte_string()));
+
+    AllocatingMemoryStream header;
+    MUST(header.write_value<LittleEndian<u32>>(CACHE_FILE_MAGIC));
+    MUST(header.write_value<LittleEndian<u32>>(instruction_layout_fingerprint()));
+    MUST(header.write_until_depleted(digest.bytes()));
+    MUST(header.write_value<LittleEndian<u32>>(program.nodes_referenced_by_bytecode().size()));
+    // NOTE: Pre-parsed function bodies have no nodes of their own, so programs parsed lazily refer to nodes differently.
+    MUST(header.write_value<u8>(g_parse_function_bodies_lazily));
+    cache->m_header = MUST(header.read_until_eof());
+
+    cache->read_file();
+
+    program.set_bytecode_cache({}, cache);
+    return cache;
+}
+
+void BytecodeCache::read_file()
+{
+    auto file = Core::File::open(m_path, Core::File::OpenMode::Read);
+    if (file.is_error())
+        return;
+    auto contents = file.value()->read_until_eof();
+    if (contents.is_error())
+        return;
+    m_file_contents = contents.release_value();
+
+    if (!m_file_contents.bytes().starts_with(m_header.bytes()))
+        return;
+    m_file_has_valid_header = true;
+
+    // NOTE: Records are only ever appended, so a later record for the same node replaces an earlier one,
+    //       and anything after a damaged record (e.g. from a crash while writing) is ignored, then cut off on the next write.
+    FixedMemoryStream stream { m_file_contents.bytes().slice(m_header.size()) };
+    m_valid_file_size = m_header.size();
+    while (!stream.is_eof()) {
+        auto node_index = stream.read_value<LittleEndian<u32>>();
+        auto checksum = stream.read_value<LittleEndian<u32>>();
+        auto payload = read_bytes(stream);
+        if (node_index.is_error() || checksum.is_error() || payload.is_error() || Crypto::Checksum::CRC32 { payload.value() }.digest() != checksum.value()) {
+            m_file_has_damaged_records = true;
+            break;
+        }
+        m_records.set(node_index.value(), payload.value());
+        m_valid_file_size = m_header.size() + MUST(stream.tell());
+    }
+}
+
+ErrorOr<void> BytecodeCache::append_record(u32 node_index, ReadonlyBytes payload)
+{
+    TRY(m_pending_records.write_value<LittleEndian<u32>>(node_index));
+    TRY(m_pending_records.write_value<LittleEndian<u32>>(Crypto::Checksum::CRC32 { payload }.digest()));
+    TRY(write_bytes(m_pending_records, payload));
+
+    // NOTE: Functions are compiled on first call, so write records in batches rather than touching the file for each one.
+    static constexpr size_t pending_records_flush_threshold = 64 * KiB;
+    if (m_pending_records.used_buffer_size() >= pending_records_flush_threshold)
+        TRY(write_pending_records());
+    return {};
+}
+
+ErrorOr<void> BytecodeCache::write_pending_records()
+{
+    if (m_pending_records.used_buffer_size() == 0)
+        return {};
+    auto records = TRY(m_pending_records.read_until_eof());
+
+    TRY(Core::Directory::create(*cache_directory(), Core::Directory::CreateDirectories::Yes));
+    bool can_append = m_file_has_valid_header && !m_file_has_damaged_records;
+    auto mode = can_append ? Core::File::OpenMode::Write | Core::File::OpenMode::Append : Core::File::OpenMode::Write | Core::File::OpenMode::Truncate;
+    auto file = TRY(Core::File::open(m_path, mode));
+    if (!m_file_has_valid_header)
+        TRY(file->write_until_depleted(m_header));
+    else if (m_file_has_damaged_records)
+        TRY(file->write_until_depleted(m_file_contents.bytes().trim(m_valid_file_size)));
+    TRY(file->write_until_depleted(records));
+    m_file_has_valid_header = true;
+    m_file_has_damaged_records = false;
+    return {};
+}
+
+void BytecodeCache::flush()
+{
+    if (auto result = write_pending_records(); result.is_error())
+        dbgln("Failed to write to bytecode cache {}: {}", m_path, result.error());
+}
+
+Optional<u32> BytecodeCache::index_of_node(void const* node)
+{
+    if (m_node_indices.is_empty()) {
+        auto const& nodes = m_program.nodes_referenced_by_bytecode();
+        for (u32 i = 0; i < nodes.size(); ++i) {
+            auto const& node = *nodes[i];
+            m_node_indices.set(&node, i);
+            if (node.is_function_expression())
+                m_node_indices.set(static_cast<FunctionNode const*>(&static_cast<FunctionExpression const&>(node)), i);
+            else if (node.is_function_declaration())
+                m_node_indices.set(static_cast<FunctionNode const*>(&static_cast<FunctionDeclaration const&>(node)), i);
+        }
+    }
+    return m_node_indices.get(node);
+}
+
+GCPtr<Executable> BytecodeCache::load(VM& vm, ASTNode const& root_node, Limits const& limits)
+{
+    auto node_index = index_of_node(&root_node);
+    if (!node_index.has_value())
+        return nullptr;
+    auto record = m_records.get(*node_index);
+    if (!record.has_value())
+        return nullptr;
+
+    auto executable = decode(vm, root_node, limits, *record);
+    if (executable.is_error()) {
+        m_records.remove(*node_index);
+        return nullptr;
+    }
+    return executable.release_value();
+}
+
+void BytecodeCache::store(Executable const& executable, ASTNode const& root_node)
+{
+    auto node_index = index_of_node(&root_node);
+    if (!node_index.has_value())
+        return;
+    auto payload = encode(executable);
+    if (payload.is_error())
+        return;
+    if (auto result = append_record(*node_index, payload.value()); result.is_error())
+        dbgln("Failed to write to bytecode cache {}: {}", m_path, result.error());
+}
+
+// NOTE: String literals are kept as a ByteString, which isn't valid UTF-8 if they contain a lone surrogate.
+static Optional<ByteString> string_constant_as_utf8(Value constant)
+{
+    if (!constant.is_string())
+        return {};
+    auto const& string = constant.as_string();
+    if (string.has_utf8_string())
+        return string.utf8_string().to_byte_string();
+    if (!string.has_byte_string())
+        return {};
+    auto byte_string = string.byte_string();
+    if (!Utf8View { byte_string.view() }.validate())
+        return {};
+    return byte_string;
+}
+
+ErrorOr<ByteBuffer> BytecodeCache::encode(Executable const& executable)
+{
+    AllocatingMemoryStream stream;
+
+    TRY(write_size(stream, executable.number_of_registers));
+    TRY(stream.write_value<u8>(executable.is_strict_mode));
+    TRY(write_size(stream, executable.property_lookup_caches.size()));
+    TRY(write_size(stream, executable.global_variable_caches.size()));
+
+    TRY(write_size(stream, executable.string_table->size()));
+    for (u32 i = 0; i < executable.string_table->size(); ++i)
+        TRY(write_bytes(stream, executable.get_string(StringTableIndex { i }).bytes()));
+
+    TRY(write_size(stream, executable.identifier_table->size()));
+    for (u32 i = 0; i < executable.identifier_table->size(); ++i)
+        TRY(write_bytes(stream, executable.get_identifier(IdentifierTableIndex { i }).view().bytes()));
+
+    // NOTE: Regexes are compiled again from their pattern when loaded.
+    TRY(write_size(stream, executable.regex_table->size()));
+    for (size_t i = 0; i < executable.regex_table->size(); ++i) {
+        auto const& regex = executable.regex_table->get(RegexTableIndex { i });
+        TRY(write_bytes(stream, regex.pattern.bytes()));
+        TRY(stream.write_value<LittleEndian<u32>>(to_underlying(regex.flags.value())));
+    }
+
+    TRY(write_size(stream, executable.constants.size()));
+    for (auto constant : executable.constants) {
+        if (constant.is_empty()) {
+            TRY(stream.write_value(ConstantTag::Empty));
+        } else if (constant.is_undefined()) {
+            TRY(stream.write_value(ConstantTag::Undefined));
+        } else if (constant.is_null()) {
+            TRY(stream.write_value(ConstantTag::Null));
+        } else if (constant.is_boolean()) {
+            TRY(stream.write_value(ConstantTag::Boolean));
+            TRY(stream.write_value<u8>(constant.as_bool()));
+        } else if (constant.is_number()) {
+            TRY(stream.write_value(ConstantTag::Number));
+            TRY(stream.write_value<LittleEndian<u64>>(bit_cast<u64>(constant.as_double())));
+        } else if (auto string = string_constant_as_utf8(constant); string.has_value()) {
+            TRY(stream.write_value(ConstantTag::String));
+            TRY(write_bytes(stream, string->bytes()));
+        } else if (constant.is_bigint()) {
+            TRY(stream.write_value(ConstantTag::BigInt));
+            auto digits = constant.as_bigint().big_integer().to_base_deprecated(10);
+            TRY(write_bytes(stream, digits.bytes()));
+        } else {
+            return AK::Error::from_string_literal("Can't store constant in bytecode cache");
+        }
+    }
+
+    TRY(write_size(stream, executable.exception_handlers.size()));
+    for (auto const& handlers : executable.exception_handlers) {
+        TRY(write_size(stream, handlers.start_offset));
+        TRY(write_size(stream, handlers.end_offset));
+        TRY(write_size(stream, handlers.handler_offset.value_or(NumericLimits<size_t>::max())));
+        TRY(write_size(stream, handlers.finalizer_offset.value_or(NumericLimits<size_t>::max())));
+    }
+
+    TRY(write_size(stream, executable.basic_block_start_offsets.size()));
+    for (auto offset : executable.basic_block_start_offsets)
+        TRY(write_size(stream, offset));
+
+    TRY(write_size(stream, executable.source_map.size()));
+    for (auto const& [offset, record] : executable.source_map) {
+        TRY(write_size(stream, offset));
+        TRY(stream.write_value<LittleEndian<u32>>(record.source_start_offset));
+        TRY(stream.write_value<LittleEndian<u32>>(record.source_end_offset));
+    }
+
+    // NOTE: AST node pointers are replaced by node indices, and cleared in the stored bytecode.
+    auto bytecode = TRY(ByteBuffer::copy(executable.bytecode));
+    Vector<u32> relocations;
+    for (InstructionStreamIterator it(bytecode.bytes()); !it.at_end(); ++it) {
+        auto& instruction = const_cast<Instruction&>(*it);
+        void const* node = nullptr;
+        switch (instruction.type()) {
+        case Instruction::Type::NewFunction:
+            node = &static_cast<Op::NewFunction&>(instruction).function_node();
+            static_cast<Op::NewFunction&>(instruction).set_function_node({}, nullptr);
+            break;
+        case Instruction::Type::NewClass:
+            node = static_cast<ASTNode const*>(&static_cast<Op::NewClass&>(instruction).class_expression());
+            static_cast<Op::NewClass&>(instruction).set_class_expression({}, nullptr);
+            break;
+        case Instruction::Type::BlockDeclarationInstantiation:
+            node = static_cast<ASTNode const*>(&static_cast<Op::BlockDeclarationInstantiation&>(instruction).scope_node());
+            static_cast<Op::BlockDeclarationInstantiation&>(instruction).set_scope_node({}, nullptr);
+            break;
+        case Instruction::Type::Dump:
+            return AK::Error::from_string_literal("Can't store Dump instruction in bytecode cache");
+        default:
+            continue;
+        }
+        auto node_index = index_of_node(node);
+        if (!node_index.has_value())
+            return AK::Error::from_string_literal("Bytecode refers to a node the bytecode cache doesn't know");
+        relocations.append(it.offset());
+        relocations.append(*node_index);
+    }
+
+    TRY(write_bytes(stream, bytecode));
+    TRY(write_size(stream, relocations.size() / 2));
+    for (auto value : relocations)
+        TRY(stream.write_value<LittleEndian<u32>>(value));
+
+    return stream.read_until_eof();
+}
+
+ErrorOr<NonnullGCPtr<Executable>> BytecodeCache::decode(VM& vm, ASTNode const& root_node, Limits const& limits, ReadonlyBytes payload) const
+{
+    FixedMemoryStream stream { payload };
+
+    auto number_of_registers = TRY(read_size(stream));
+    if (number_of_registers < Register::reserved_register_count)
+        return AK::Error::from_string_literal("Too few registers in bytecode cache");
+    auto is_strict_mode = TRY(stream.read_value<u8>()) != 0;
+    auto number_of_property_lookup_caches = TRY(read_size(stream));
+    auto number_of_global_variable_caches = TRY(read_size(stream));
+
+    auto string_table = make<StringTable>();
+    auto string_count = TRY(read_size(stream));
+    for (size_t i = 0; i < string_count; ++i)
+        string_table->insert(ByteString { TRY(read_bytes(stream)) });
+
+    auto identifier_table = make<IdentifierTable>();
+    auto identifier_count = TRY(read_size(stream));
+    for (size_t i = 0; i < identifier_count; ++i)
+        identifier_table->insert(DeprecatedFlyString { StringView { TRY(read_bytes(stream)) } });
+
+    auto regex_table = make<RegexTable>();
+    auto regex_count = TRY(read_size(stream));
+    for (size_t i = 0; i < regex_count; ++i) {
+        ByteString pattern { TRY(read_bytes(stream)) };
+        u32 raw_flags = TRY(stream.read_value<LittleEndian<u32>>());
+        regex::RegexOptions<ECMAScriptFlags> flags { static_cast<ECMAScriptFlags>(raw_flags) };
+        auto parsed_regex = Regex<ECMA262>::parse_pattern(pattern, flags);
+        if (parsed_regex.error != regex::Error::NoError)
+            return AK::Error::from_string_literal("Invalid regex in bytecode cache");
+        regex_table->insert({ .regex = move(parsed_regex), .pattern = move(pattern), .flags = flags });
+    }
+
+    Vector<Value> constants;
+    auto constant_count = TRY(read_size(stream));
+    for (size_t i = 0; i < constant_count; ++i) {
+        switch (TRY(stream.read_value<ConstantTag>())) {
+        case ConstantTag::Empty:
+            constants.append({});
+            break;
+        case ConstantTag::Undefined:
+            constants.append(js_undefined());
+            break;
+        case ConstantTag::Null:
+            constants.append(js_null());
+            break;
+        case ConstantTag::Boolean:
+            constants.append(Value(TRY(stream.read_value<u8>()) != 0));
+            break;
+        case ConstantTag::Number:
+            constants.append(Value(bit_cast<double>(static_cast<u64>(TRY(stream.read_value<LittleEndian<u64>>())))));
+            break;
+        case ConstantTag::String:
+            constants.append(PrimitiveString::create(vm, TRY(String::from_utf8(StringView { TRY(read_bytes(stream)) }))));
+            break;
+        case ConstantTag::BigInt:
+            constants.append(BigInt::create(vm, TRY(Crypto::SignedBigInteger::from_base(10, StringView { TRY(read_bytes(stream)) }))));
+            break;
+        default:
+            return AK::Error::from_string_literal("Invalid constant in bytecode cache");
+        }
+    }
+
+    Vector<Executable::ExceptionHandlers> exception_handlers;
+    auto exception_handler_count = TRY(read_size(stream));
+    for (size_t i = 0; i < exception_handler_count; ++i) {
+        auto start_offset = TRY(read_size(stream));
+        auto end_offset = TRY(read_size(stream));
+        auto handler_offset = TRY(read_size(stream));
+        auto finalizer_offset = TRY(read_size(stream));
+        exception_handlers.append({
+            start_offset,
+            end_offset,
+            handler_offset == NumericLimits<size_t>::max() ? Optional<size_t> {} : handler_offset,
+            finalizer_offset == NumericLimits<size_t>::max() ? Optional<size_t> {} : finalizer_offset,
+        });
+    }
+
+    Vector<size_t> basic_block_start_offsets;
+    auto basic_block_count = TRY(read_size(stream));
+    for (size_t i = 0; i < basic_block_count; ++i)
+        basic_block_start_offsets.append(TRY(read_size(stream)));
+
+    HashMap<size_t, SourceRecord> source_map;
+    auto source_map_size = TRY(read_size(stream));
+    for (size_t i = 0; i < source_map_size; ++i) {
+        auto offset = TRY(read_size(stream));
+        auto source_start_offset = TRY(stream.read_value<LittleEndian<u32>>());
+        auto source_end_offset = TRY(stream.read_value<LittleEndian<u32>>());
+        source_map.set(offset, { source_start_offset, source_end_offset });
+    }
+
+    Vector<u8> bytecode;
+    auto bytecode_bytes = TRY(read_bytes(stream));
+    bytecode.append(bytecode_bytes.data(), bytecode_bytes.size());
+
+    // NOTE: Make sure the bytecode is a sequence of whole instructions before anything looks at it.
+    HashTable<size_t> instruction_offsets;
+    HashTable<size_t> instructions_needing_relocation;
+    Optional<Instruction::Type> last_instruction_type;
+    for (size_t offset = 0; offset < bytecode.size();) {
+        if (bytecode.size() - offset < sizeof(Instruction))
+            return AK::Error::from_string_literal("Truncated instruction in bytecode cache");
+        auto type = reinterpret_cast<Instruction const*>(bytecode.data() + offset)->type();
+        switch (type) {
+#define __BYTECODE_OP(op) case Instruction::Type::op:
+            ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+            break;
+        default:
+            return AK::Error::from_string_literal("Invalid instruction in bytecode cache");
+        }
+        if (type == Instruction::Type::NewFunction || type == Instruction::Type::NewClass || type == Instruction::Type::BlockDeclarationInstantiation)
+            instructions_needing_relocation.set(offset);
+        auto length = reinterpret_cast<Instruction const*>(bytecode.data() + offset)->length();
+        if (length == 0 || length > bytecode.size() - offset)
+            return AK::Error::from_string_literal("Truncated instruction in bytecode cache");
+        instruction_offsets.set(offset);
+        last_instruction_type = type;
+        offset += length;
+    }
+
+    // NOTE: The interpreter would run off the end of the bytecode otherwise.
+    if (!last_instruction_type.has_value() || !is_terminator(*last_instruction_type))
+        return AK::Error::from_string_literal("Bytecode in bytecode cache doesn't end in a terminator");
+
+    for (auto const& handlers : exception_handlers) {
+        if (handlers.start_offset > handlers.end_offset || handlers.end_offset > bytecode.size())
+            return AK::Error::from_string_literal("Invalid exception handler range in bytecode cache");
+        if (handlers.handler_offset.has_value() && !instruction_offsets.contains(*handlers.handler_offset))
+            return AK::Error::from_string_literal("Invalid exception handler in bytecode cache");
+        if (handlers.finalizer_offset.has_value() && !instruction_offsets.contains(*handlers.finalizer_offset))
+            return AK::Error::from_string_literal("Invalid exception handler in bytecode cache");
+    }
+    for (auto offset : basic_block_start_offsets) {
+        if (!instruction_offsets.contains(offset))
+            return AK::Error::from_string_literal("Invalid basic block in bytecode cache");
+    }
+
+    ReferenceLimits reference_limits {
+        .number_of_registers = number_of_registers,
+        .number_of_constants = constants.size(),
+        .number_of_locals = limits.number_of_locals,
+        .number_of_arguments = limits.number_of_arguments,
+        .number_of_strings = string_table->size(),
+        .number_of_identifiers = identifier_table->size(),
+        .number_of_regexes = regex_table->size(),
+        .number_of_property_lookup_caches = number_of_property_lookup_caches,
+        .number_of_global_variable_caches = number_of_global_variable_caches,
+        .instruction_offsets = instruction_offsets,
+    };
+    for (auto offset : instruction_offsets) {
+        if (!has_valid_references(*reinterpret_cast<Instruction*>(bytecode.data() + offset), reference_limits))
+            return AK::Error::from_string_literal("Invalid instruction in bytecode cache");
+    }
+
+    auto const& nodes = m_program.nodes_referenced_by_bytecode();
+    auto relocation_count = TRY(read_size(stream));
+    if (relocation_count != instructions_needing_relocation.size())
+        return AK::Error::from_string_literal("Missing relocations in bytecode cache");
+    for (size_t i = 0; i < relocation_count; ++i) {
+        auto offset = TRY(stream.read_value<LittleEndian<u32>>());
+        auto node_index = TRY(stream.read_value<LittleEndian<u32>>());
+        // NOTE: Removing the offset also catches two relocations for the same instruction, which would leave another one without its node.
+        if (instructions_needing_relocation.remove(offset) == false || node_index >= nodes.size())
+            return AK::Error::from_string_literal("Invalid relocation in bytecode cache");
+
+        auto& instruction = *reinterpret_cast<Instruction*>(bytecode.data() + offset);
+        auto const& node = *nodes[node_index];
+        if (instruction.type() == Instruction::Type::NewFunction && node.is_function_expression())
+            static_cast<Op::NewFunction&>(instruction).set_function_node({}, &static_cast<FunctionExpression const&>(node));
+        else if (instruction.type() == Instruction::Type::NewFunction && node.is_function_declaration())
+            static_cast<Op::NewFunction&>(instruction).set_function_node({}, &static_cast<FunctionDeclaration const&>(node));
+        else if (instruction.type() == Instruction::Type::NewClass && node.is_class_expression())
+            static_cast<Op::NewClass&>(instruction).set_class_expression({}, &static_cast<ClassExpression const&>(node));
+        else if (instruction.type() == Instruction::Type::BlockDeclarationInstantiation && node.is_scope_node())
+            static_cast<Op::BlockDeclarationInstantiation&>(instruction).set_scope_node({}, &static_cast<ScopeNode const&>(node));
+        else
+            return AK::Error::from_string_literal("Invalid relocation in bytecode cache");
+    }
+
+    if (!stream.is_eof())
+        return AK::Error::from_string_literal("Trailing data in bytecode cache record");
+
+    auto executable = vm.heap().allocate_without_realm<Executable>(
+        move(bytecode),
+        move(identifier_table),
+        move(string_table),
+        move(regex_table),
+        move(constants),
+        root_node.source_code(),
+        number_of_property_lookup_caches,
+        number_of_global_variable_caches,
+        number_of_registers,
+        is_strict_mode);
+    executable->exception_handlers = move(exception_handlers);
+    executable->basic_block_start_offsets = move(basic_block_start_offsets);
+    executable->source_map = move(source_map);
+    return executable;
+}
+
+CodeGenerationErrorOr<NonnullGCPtr<Executable>> BytecodeCache::generate_from_program(VM& vm, Program const& program)
+{
+    // NOTE: Programs parsed in the background can come with their code already generated.
+    if (auto unlinked_executable = program.take_unlinked_executable())
+        return Generator::link(vm, move(*unlinked_executable));
+
+    auto cache = for_program(program);
+    if (!cache)
+        return Generator::generate_from_ast_node(vm, program, FunctionKind::Normal);
+
+    if (auto executable = cache->load(vm, program, { .number_of_locals = program.local_variables_names().size() }))
+        return *executable;
+
+    auto executable = TRY(Generator::generate_from_ast_node(vm, program, FunctionKind::Normal));
+    cache->store(*executable, program);
+    return executable;
+}
+
+static Program const* program_for_function(ECMAScriptFunctionObject const& function)
+{
+    return function.script_or_module().visit(
+        [](Empty) -> Program const* { return nullptr; },
+        [](NonnullGCPtr<Script> const& script) -> Program const* { return &script->parse_node(); },
+        [](NonnullGCPtr<Module> const& module) -> Program const* {
+            if (!is<SourceTextModule>(*module))
+                return nullptr;
+            return &static_cast<SourceTextModule const&>(*module).parse_node();
+        });
+}
+
+CodeGenerationErrorOr<NonnullGCPtr<Executable>> BytecodeCache::generate_from_function(VM& vm, ECMAScriptFunctionObject const& function)
+{
+    auto const* program = program_for_function(function);
+    auto cache = program ? for_program(*program) : nullptr;
+    if (!cache)
+        return Generator::generate_from_function(vm, function);
+
+    Limits limits {
+        .number_of_locals = function.local_variables_names().size(),
+        .number_of_arguments = function.formal_parameters().size(),
+    };
+    if (auto executable = cache->load(vm, function.ecmascript_code(), limits))
+        return *executable;
+
+    auto executable = TRY(Generator::generate_from_function(vm, function));
+    cache->store(*executable, function.ecmascript_code());
+    return executable;
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/MemoryStream.h>
+#include <AK/RefCounted.h>
+#include <LibJS/Bytecode/CodeGenerationError.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Heap/GCPtr.h>
+
+namespace JS::Bytecode {
+
+// Keeps the executables compiled from a program on disk, so that running the same source code again can skip code generation.
+// Each program gets a file named after a hash of its source code, with a record for its top-level executable and one for
+// each function body that has been compiled so far. Bytecode refers to AST nodes, so the program still has to be parsed,
+// and nodes are referred to by their position in Program::nodes_referenced_by_bytecode().
+class BytecodeCache : public RefCounted<BytecodeCache> {
+public:
+    // The cache is disabled unless a directory has been set, either here or through the LIBJS_BYTECODE_CACHE environment variable.
+    static bool is_enabled();
+    static void set_directory(ByteString);
+
+    // Like the equivalent Generator functions, but these load the executable from the cache instead if possible,
+    // and store newly generated executables in it.
+    static CodeGenerationErrorOr<NonnullGCPtr<Executable>> generate_from_program(VM&, Program const&);
+    static CodeGenerationErrorOr<NonnullGCPtr<Executable>> generate_from_function(VM&, ECMAScriptFunctionObject const&);
+
+    // Writes out the records stored since the last flush. This happens automatically once enough of them have piled up,
+    // after a script or module has run, and when the cache is destroyed along with its program.
+    void flush();
+
+    ~BytecodeCache();
+
+private:
+    // What the bytecode for a node may refer to outside of its own executable.
+    struct Limits {
+        size_t number_of_locals { 0 };
+        size_t number_of_arguments { 0 };
+    };
+
+    explicit BytecodeCache(Program const&, ByteString path);
+
+    static RefPtr<BytecodeCache> for_program(Program const&);
+
+    GCPtr<Executable> load(VM&, ASTNode const&, Limits const&);
+    void store(Executable const&, ASTNode const&);
+
+    Optional<u32> index_of_node(void const*);
+    ErrorOr<NonnullGCPtr<Executable>> decode(VM&, ASTNode const&, Limits const&, ReadonlyBytes) const;
+    ErrorOr<ByteBuffer> encode(Executable const&);
+    void read_file();
+    ErrorOr<void> append_record(u32 node_index, ReadonlyBytes);
+    ErrorOr<void> write_pending_records();
+
+    Program const& m_program;
+    ByteString m_path;
+    ByteBuffer m_header;
+    ByteBuffer m_file_contents;
+    bool m_file_has_valid_header { false };
+    bool m_file_has_damaged_records { false };
+    size_t m_valid_file_size { 0 };
+    HashMap<u32, ReadonlyBytes> m_records;
+    HashMap<void const*, u32> m_node_indices;
+    AllocatingMemoryStream m_pending_records;
+};
+
+}
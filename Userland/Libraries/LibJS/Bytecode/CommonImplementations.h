@@ -108,6 +108,22 @@ enum class GetByIdMode {
     Length,
 };
 
+ALWAYS_INLINE Optional<Value> get_from_property_lookup_cache_entry(PropertyLookupCacheEntry const& entry, Object const& base_obj, Shape const& shape)
+{
+    if (&shape != entry.shape)
+        return {};
+
+    if (entry.prototype) {
+        // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
+        if (!entry.prototype_chain_validity || !entry.prototype_chain_validity->is_valid())
+            return {};
+        return entry.prototype->get_direct(entry.property_offset.value());
+    }
+
+    // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
+    return base_obj.get_direct(entry.property_offset.value());
+}
+
 template<GetByIdMode mode = GetByIdMode::Normal>
 inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<DeprecatedFlyString const&> const& base_identifier, DeprecatedFlyString const& property, Value base_value, Value this_value, PropertyLookupCache& cache)
 {
@@ -128,37 +144,44 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<DeprecatedFlyString c
 
     auto& shape = base_obj->shape();
 
-    if (cache.prototype) {
-        // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
-        bool can_use_cache = [&]() -> bool {
-            if (&shape != cache.shape)
-                return false;
-            if (!cache.prototype_chain_validity)
-                return false;
-            if (!cache.prototype_chain_validity->is_valid())
-                return false;
-            return true;
-        }();
-        if (can_use_cache)
-            return cache.prototype->get_direct(cache.property_offset.value());
-    } else if (&shape == cache.shape) {
-        // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
-        return base_obj->get_direct(cache.property_offset.value());
+    for (size_t i = 0; i < cache.number_of_entries; ++i) {
+        if (auto value = get_from_property_lookup_cache_entry(cache.entries[i], *base_obj, shape); value.has_value()) {
+            cache.record_hit();
+            return *value;
+        }
+    }
+
+    auto& megamorphic_cache = vm.bytecode_interpreter().megamorphic_get_cache();
+    if (cache.is_megamorphic) {
+        if (auto* entry = megamorphic_cache.find(shape, property)) {
+            if (auto value = get_from_property_lookup_cache_entry(*entry, *base_obj, shape); value.has_value()) {
+                cache.record_hit();
+                return *value;
+            }
+        }
     }
 
+    cache.record_miss();
+
     CacheablePropertyMetadata cacheable_metadata;
     auto value = TRY(base_obj->internal_get(property, this_value, &cacheable_metadata));
 
-    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache = {};
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
-    } else if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
-        cache = {};
-        cache.shape = &base_obj->shape();
-        cache.property_offset = cacheable_metadata.property_offset.value();
-        cache.prototype = *cacheable_metadata.prototype;
-        cache.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::NotCacheable)
+        return value;
+
+    // NOTE: internal_get() may have run arbitrary code (e.g. a getter or proxy trap), so the shape may have changed.
+    auto& entry = [&]() -> PropertyLookupCacheEntry& {
+        if (auto* entry = cache.entry_for_insertion(base_obj->shape()))
+            return *entry;
+        return megamorphic_cache.entry_for_insertion(base_obj->shape(), property);
+    }();
+
+    entry = {};
+    entry.shape = base_obj->shape();
+    entry.property_offset = cacheable_metadata.property_offset.value();
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
+        entry.prototype = *cacheable_metadata.prototype;
+        entry.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
     }
 
     return value;
@@ -316,17 +339,38 @@ inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value thi
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache && cache->shape == &object->shape()) {
-            object->put_direct(*cache->property_offset, value);
-            return {};
+        if (cache) {
+            auto& shape = object->shape();
+            for (size_t i = 0; i < cache->number_of_entries; ++i) {
+                if (cache->entries[i].shape == &shape) {
+                    cache->record_hit();
+                    object->put_direct(*cache->entries[i].property_offset, value);
+                    return {};
+                }
+            }
+            if (cache->is_megamorphic && name.is_string()) {
+                if (auto* entry = vm.bytecode_interpreter().megamorphic_put_cache().find(shape, name.as_string())) {
+                    cache->record_hit();
+                    object->put_direct(*entry->property_offset, value);
+                    return {};
+                }
+            }
+            cache->record_miss();
         }
 
         CacheablePropertyMetadata cacheable_metadata;
         bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
 
         if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
+            auto& shape = object->shape();
+            auto* entry = cache->entry_for_insertion(shape);
+            if (!entry && name.is_string())
+                entry = &vm.bytecode_interpreter().megamorphic_put_cache().entry_for_insertion(shape, name.as_string());
+            if (entry) {
+                *entry = {};
+                entry->shape = shape;
+                entry->property_offset = cacheable_metadata.property_offset.value();
+            }
         }
 
         if (!succeeded && vm.in_strict_mode()) {
@@ -447,6 +491,7 @@ inline ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Optional<Depreca
                 auto existing_value = maybe_value->value;
                 if (!existing_value.is_accessor()) {
                     storage->put(index, value);
+                    object.write_barrier(value);
                     return {};
                 }
             }
@@ -765,11 +810,13 @@ inline ThrowCompletionOr<void> append(VM& vm, Value lhs, Value rhs, bool is_spre
         size_t i = lhs_size;
         TRY(get_iterator_values(vm, rhs, [&i, &lhs_array](Value iterator_value) -> Optional<Completion> {
             lhs_array.indexed_properties().put(i, iterator_value, default_attributes);
+            lhs_array.write_barrier(iterator_value);
             ++i;
             return {};
         }));
     } else {
         lhs_array.indexed_properties().put(lhs_size, rhs, default_attributes);
+        lhs_array.write_barrier(rhs);
     }
 
     return {};
@@ -7,11 +7,16 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Op.h>
 #include <LibJS/Bytecode/RegexTable.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/SourceCode.h>
 
 namespace JS::Bytecode {
 
+bool g_collect_property_lookup_cache_statistics = false;
+
 JS_DEFINE_ALLOCATOR(Executable);
 
 Executable::Executable(
@@ -83,6 +88,47 @@ void Executable::dump() const
     warnln("");
 }
 
+void Executable::dump_property_lookup_cache_statistics() const
+{
+    if (property_lookup_caches.is_empty())
+        return;
+
+    warnln("\033[37;1mProperty lookup caches\033[0m for \"{}\"", name);
+
+    for (InstructionStreamIterator it(bytecode, this); !it.at_end(); ++it) {
+        auto const& instruction = *it;
+        Optional<u32> cache_index;
+        switch (instruction.type()) {
+#define __BYTECODE_OP(op)                                                    \
+    case Instruction::Type::op:                                              \
+        cache_index = static_cast<Op::op const&>(instruction).cache_index(); \
+        break;
+            __BYTECODE_OP(GetById)
+            __BYTECODE_OP(GetByIdWithThis)
+            __BYTECODE_OP(GetLength)
+            __BYTECODE_OP(GetLengthWithThis)
+            __BYTECODE_OP(PutById)
+            __BYTECODE_OP(PutByIdWithThis)
+#undef __BYTECODE_OP
+        default:
+            break;
+        }
+        if (!cache_index.has_value())
+            continue;
+
+        auto const& cache = property_lookup_caches[*cache_index];
+        warnln("[{:4x}] hits: {:6}, misses: {:6}, shapes: {}{}  {}",
+            it.offset(),
+            cache.hit_count,
+            cache.miss_count,
+            cache.number_of_entries,
+            cache.is_megamorphic ? " (megamorphic)"sv : ""sv,
+            instruction.to_byte_string(*this));
+    }
+
+    warnln("");
+}
+
 void Executable::visit_edges(Visitor& visitor)
 {
     Base::visit_edges(visitor);
@@ -114,4 +160,17 @@ UnrealizedSourceRange Executable::source_range_at(size_t offset) const
     };
 }
 
+JIT::NativeExecutable const* Executable::get_or_create_native_executable()
+{
+    if (m_did_try_jitting)
+        return m_native_executable.ptr();
+
+    if (!JIT::Compiler::should_compile(*this, ++m_execution_count))
+        return nullptr;
+
+    m_did_try_jitting = true;
+    m_native_executable = JIT::Compiler::compile(*this);
+    return m_native_executable.ptr();
+}
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -22,17 +23,99 @@
 
 namespace JS::Bytecode {
 
-struct PropertyLookupCache {
+extern bool g_collect_property_lookup_cache_statistics;
+
+struct PropertyLookupCacheEntry {
     WeakPtr<Shape> shape;
     Optional<u32> property_offset;
     WeakPtr<Object> prototype;
     WeakPtr<PrototypeChainValidity> prototype_chain_validity;
 };
 
-struct GlobalVariableCache : public PropertyLookupCache {
+// A polymorphic inline cache for a single property access site.
+// Once more shapes than we can remember have been seen, the site goes megamorphic
+// and starts consulting the interpreter-wide MegamorphicPropertyLookupCache instead.
+struct PropertyLookupCache {
+    static constexpr size_t max_number_of_shapes_to_remember = 4;
+
+    AK::Array<PropertyLookupCacheEntry, max_number_of_shapes_to_remember> entries;
+    u8 number_of_entries { 0 };
+    bool is_megamorphic { false };
+
+    // Only counted while g_collect_property_lookup_cache_statistics is set, to keep the fast path lean.
+    u32 hit_count { 0 };
+    u32 miss_count { 0 };
+
+    ALWAYS_INLINE void record_hit()
+    {
+        if (g_collect_property_lookup_cache_statistics) [[unlikely]]
+            ++hit_count;
+    }
+
+    ALWAYS_INLINE void record_miss()
+    {
+        if (g_collect_property_lookup_cache_statistics) [[unlikely]]
+            ++miss_count;
+    }
+
+    // Returns the entry to fill in for the given shape, reusing one that already belongs to it
+    // (or to a shape that has since been garbage collected). Returns null once the site has gone megamorphic.
+    PropertyLookupCacheEntry* entry_for_insertion(Shape const& shape)
+    {
+        if (is_megamorphic)
+            return nullptr;
+        for (size_t i = 0; i < number_of_entries; ++i) {
+            if (!entries[i].shape || entries[i].shape == &shape)
+                return &entries[i];
+        }
+        if (number_of_entries < max_number_of_shapes_to_remember)
+            return &entries[number_of_entries++];
+        is_megamorphic = true;
+        return nullptr;
+    }
+};
+
+struct GlobalVariableCache {
+    WeakPtr<Shape> shape;
+    Optional<u32> property_offset;
     u64 environment_serial_number { 0 };
 };
 
+// A direct-mapped cache keyed by (shape, property name), shared by all megamorphic access sites.
+class MegamorphicPropertyLookupCache {
+public:
+    static constexpr size_t number_of_entries = 1024;
+
+    PropertyLookupCacheEntry* find(Shape const& shape, DeprecatedFlyString const& property)
+    {
+        auto& slot = slot_for(shape, property);
+        if (slot.entry.shape != &shape || slot.property != property)
+            return nullptr;
+        return &slot.entry;
+    }
+
+    PropertyLookupCacheEntry& entry_for_insertion(Shape const& shape, DeprecatedFlyString const& property)
+    {
+        auto& slot = slot_for(shape, property);
+        slot.property = property;
+        slot.entry = {};
+        return slot.entry;
+    }
+
+private:
+    struct Slot {
+        DeprecatedFlyString property;
+        PropertyLookupCacheEntry entry;
+    };
+
+    Slot& slot_for(Shape const& shape, DeprecatedFlyString const& property)
+    {
+        return m_slots[pair_int_hash(ptr_hash(&shape), property.hash()) % number_of_entries];
+    }
+
+    AK::Array<Slot, number_of_entries> m_slots;
+};
+
 struct SourceRecord {
     u32 source_start_offset {};
     u32 source_end_offset {};
@@ -96,10 +179,31 @@ public:
 
     [[nodiscard]] UnrealizedSourceRange source_range_at(size_t offset) const;
 
+    // Returns the JIT-compiled version of this executable, compiling it first if it has become hot.
+    // Returns null if the JIT is disabled or can't handle this executable.
+    JIT::NativeExecutable const* get_or_create_native_executable();
+    JIT::NativeExecutable const* native_executable() const { return m_native_executable.ptr(); }
+
     void dump() const;
+    void dump_property_lookup_cache_statistics() const;
+
+    template<typename Callback>
+    static void for_each_live_executable(Callback callback)
+    {
+        cell_allocator.allocator.get().for_each_block([&](HeapBlock& block) {
+            block.for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+                callback(static_cast<Executable&>(*cell));
+            });
+            return IterationDecision::Continue;
+        });
+    }
 
 private:
     virtual void visit_edges(Visitor&) override;
+
+    OwnPtr<JIT::NativeExecutable> m_native_executable;
+    u32 m_execution_count { 0 };
+    bool m_did_try_jitting { false };
 };
 
 }
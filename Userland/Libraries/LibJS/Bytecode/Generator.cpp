@@ -11,8 +11,11 @@
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
 #include <LibJS/Bytecode/Register.h>
+#include <LibJS/Runtime/BigInt.h>
 #include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Runtime/PrimitiveString.h>
 #include <LibJS/Runtime/VM.h>
 
 namespace JS::Bytecode {
@@ -22,7 +25,6 @@ Generator::Generator(VM& vm, MustPropagateCompletion must_propagate_completion)
     , m_string_table(make<StringTable>())
     , m_identifier_table(make<IdentifierTable>())
     , m_regex_table(make<RegexTable>())
-    , m_constants(vm.heap())
     , m_accumulator(*this, Operand(Register::accumulator()))
     , m_must_propagate_completion(must_propagate_completion == MustPropagateCompletion::Yes)
 {
@@ -197,7 +199,7 @@ CodeGenerationErrorOr<void> Generator::emit_function_declaration_instantiation(E
     return {};
 }
 
-CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::emit_function_body_bytecode(VM& vm, ASTNode const& node, FunctionKind enclosing_function_kind, GCPtr<ECMAScriptFunctionObject const> function, MustPropagateCompletion must_propagate_completion)
+CodeGenerationErrorOr<NonnullOwnPtr<UnlinkedExecutable>> Generator::emit_function_body_bytecode(VM& vm, ASTNode const& node, FunctionKind enclosing_function_kind, GCPtr<ECMAScriptFunctionObject const> function, MustPropagateCompletion must_propagate_completion)
 {
     Generator generator(vm, must_propagate_completion);
 
@@ -241,6 +243,8 @@ CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::emit_function_body_by
         }
     }
 
+    PassManager::the().perform(generator);
+
     bool is_strict_mode = false;
     if (is<Program>(node))
         is_strict_mode = static_cast<Program const&>(node).is_strict_mode();
@@ -394,18 +398,6 @@ CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::emit_function_body_by
         label.set_address(block_offsets.get(block).value());
     }
 
-    auto executable = vm.heap().allocate_without_realm<Executable>(
-        move(bytecode),
-        move(generator.m_identifier_table),
-        move(generator.m_string_table),
-        move(generator.m_regex_table),
-        move(generator.m_constants),
-        node.source_code(),
-        generator.m_next_property_lookup_cache,
-        generator.m_next_global_variable_cache,
-        generator.m_next_register,
-        is_strict_mode);
-
     Vector<Executable::ExceptionHandlers> linked_exception_handlers;
 
     for (auto& unlinked_handler : unlinked_exception_handlers) {
@@ -420,23 +412,70 @@ CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::emit_function_body_by
         return a.start_offset < b.start_offset;
     });
 
-    executable->exception_handlers = move(linked_exception_handlers);
-    executable->basic_block_start_offsets = move(basic_block_start_offsets);
-    executable->source_map = move(source_map);
-
     generator.m_finished = true;
 
+    return adopt_own(*new UnlinkedExecutable {
+        .bytecode = move(bytecode),
+        .identifier_table = move(generator.m_identifier_table),
+        .string_table = move(generator.m_string_table),
+        .regex_table = move(generator.m_regex_table),
+        .constants = move(generator.m_constants),
+        .source_code = node.source_code(),
+        .number_of_property_lookup_caches = generator.m_next_property_lookup_cache,
+        .number_of_global_variable_caches = generator.m_next_global_variable_cache,
+        .number_of_registers = generator.m_next_register,
+        .is_strict_mode = is_strict_mode,
+        .exception_handlers = move(linked_exception_handlers),
+        .basic_block_start_offsets = move(basic_block_start_offsets),
+        .source_map = move(source_map),
+    });
+}
+
+NonnullGCPtr<Executable> Generator::link(VM& vm, UnlinkedExecutable&& unlinked_executable)
+{
+    MarkedVector<Value> constants(vm.heap());
+    constants.ensure_capacity(unlinked_executable.constants.size());
+    for (auto& constant : unlinked_executable.constants) {
+        constants.unchecked_append(constant.visit(
+            [](Value value) { return value; },
+            [&](ByteString& string) -> Value { return PrimitiveString::create(vm, move(string)); },
+            [&](Crypto::SignedBigInteger& integer) -> Value { return BigInt::create(vm, move(integer)); }));
+    }
+
+    auto executable = vm.heap().allocate_without_realm<Executable>(
+        move(unlinked_executable.bytecode),
+        move(unlinked_executable.identifier_table),
+        move(unlinked_executable.string_table),
+        move(unlinked_executable.regex_table),
+        move(constants),
+        move(unlinked_executable.source_code),
+        unlinked_executable.number_of_property_lookup_caches,
+        unlinked_executable.number_of_global_variable_caches,
+        unlinked_executable.number_of_registers,
+        unlinked_executable.is_strict_mode);
+
+    executable->exception_handlers = move(unlinked_executable.exception_handlers);
+    executable->basic_block_start_offsets = move(unlinked_executable.basic_block_start_offsets);
+    executable->source_map = move(unlinked_executable.source_map);
+
     return executable;
 }
 
 CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::generate_from_ast_node(VM& vm, ASTNode const& node, FunctionKind enclosing_function_kind)
+{
+    auto unlinked_executable = TRY(generate_unlinked_from_ast_node(vm, node, enclosing_function_kind));
+    return link(vm, move(*unlinked_executable));
+}
+
+CodeGenerationErrorOr<NonnullOwnPtr<UnlinkedExecutable>> Generator::generate_unlinked_from_ast_node(VM& vm, ASTNode const& node, FunctionKind enclosing_function_kind)
 {
     return emit_function_body_bytecode(vm, node, enclosing_function_kind, {});
 }
 
 CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::generate_from_function(VM& vm, ECMAScriptFunctionObject const& function)
 {
-    return emit_function_body_bytecode(vm, function.ecmascript_code(), function.kind(), &function, MustPropagateCompletion::No);
+    auto unlinked_executable = TRY(emit_function_body_bytecode(vm, function.ecmascript_code(), function.kind(), &function, MustPropagateCompletion::No));
+    return link(vm, move(*unlinked_executable));
 }
 
 void Generator::grow(size_t additional_size)
@@ -1121,9 +1160,9 @@ bool Generator::fuse_compare_and_jump(ScopedOperand const& condition, Label true
 void Generator::emit_jump_if(ScopedOperand const& condition, Label true_target, Label false_target)
 {
     if (condition.operand().is_constant()) {
-        auto value = m_constants[condition.operand().index()];
-        if (value.is_boolean()) {
-            if (value.as_bool()) {
+        auto const* value = m_constants[condition.operand().index()].get_pointer<Value>();
+        if (value && value->is_boolean()) {
+            if (value->as_bool()) {
                 emit<Op::Jump>(true_target);
             } else {
                 emit<Op::Jump>(false_target);
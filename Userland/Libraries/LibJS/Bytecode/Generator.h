@@ -8,6 +8,8 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/SinglyLinkedList.h>
+#include <AK/Variant.h>
+#include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/CodeGenerationError.h>
@@ -23,8 +25,32 @@
 
 namespace JS::Bytecode {
 
+// Generating code doesn't allocate anything from the heap, so that it can happen on another thread than the one running
+// JavaScript (see BackgroundParser). String and BigInt constants are kept as they are until the executable is linked,
+// and only become cells then. Values are never cells.
+using Constant = Variant<Value, ByteString, Crypto::SignedBigInteger>;
+
+// Everything an Executable is made of, as it comes out of the generator.
+struct UnlinkedExecutable {
+    Vector<u8> bytecode;
+    NonnullOwnPtr<IdentifierTable> identifier_table;
+    NonnullOwnPtr<StringTable> string_table;
+    NonnullOwnPtr<RegexTable> regex_table;
+    Vector<Constant> constants;
+    NonnullRefPtr<SourceCode const> source_code;
+    size_t number_of_property_lookup_caches { 0 };
+    size_t number_of_global_variable_caches { 0 };
+    size_t number_of_registers { 0 };
+    bool is_strict_mode { false };
+    Vector<Executable::ExceptionHandlers> exception_handlers;
+    Vector<size_t> basic_block_start_offsets;
+    HashMap<size_t, SourceRecord> source_map;
+};
+
 class Generator {
 public:
+    // NOTE: Code generation may happen on another thread than the one the VM belongs to, so this must only be used for
+    //       operations on primitive values that don't touch the VM's state, like arithmetic on numbers.
     VM& vm() { return m_vm; }
 
     enum class SurroundingScopeKind {
@@ -41,6 +67,10 @@ public:
     static CodeGenerationErrorOr<NonnullGCPtr<Executable>> generate_from_ast_node(VM&, ASTNode const&, FunctionKind = FunctionKind::Normal);
     static CodeGenerationErrorOr<NonnullGCPtr<Executable>> generate_from_function(VM&, ECMAScriptFunctionObject const& function);
 
+    // Like generate_from_ast_node(), split in the part that can run on any thread and the part that allocates the executable.
+    static CodeGenerationErrorOr<NonnullOwnPtr<UnlinkedExecutable>> generate_unlinked_from_ast_node(VM&, ASTNode const&, FunctionKind = FunctionKind::Normal);
+    static NonnullGCPtr<Executable> link(VM&, UnlinkedExecutable&&);
+
     CodeGenerationErrorOr<void> emit_function_declaration_instantiation(ECMAScriptFunctionObject const& function);
 
     [[nodiscard]] ScopedOperand allocate_register();
@@ -325,9 +355,10 @@ public:
     };
     [[nodiscard]] ScopedOperand add_constant(Value value, DeduplicateConstant deduplicate_constant = DeduplicateConstant::Yes)
     {
+        VERIFY(!value.is_cell());
         if (deduplicate_constant == DeduplicateConstant::Yes) {
             for (size_t i = 0; i < m_constants.size(); ++i) {
-                if (m_constants[i] == value)
+                if (m_constants[i].has<Value>() && m_constants[i].get<Value>() == value)
                     return ScopedOperand(*this, Operand(Operand::Type::Constant, i));
             }
         }
@@ -335,16 +366,32 @@ public:
         return ScopedOperand(*this, Operand(Operand::Type::Constant, m_constants.size() - 1));
     }
 
+    [[nodiscard]] ScopedOperand add_string_constant(ByteString string)
+    {
+        m_constants.append(move(string));
+        return ScopedOperand(*this, Operand(Operand::Type::Constant, m_constants.size() - 1));
+    }
+
+    [[nodiscard]] ScopedOperand add_bigint_constant(Crypto::SignedBigInteger integer)
+    {
+        m_constants.append(move(integer));
+        return ScopedOperand(*this, Operand(Operand::Type::Constant, m_constants.size() - 1));
+    }
+
     UnwindContext const* current_unwind_context() const { return m_current_unwind_context; }
 
     [[nodiscard]] bool is_finished() const { return m_finished; }
 
     [[nodiscard]] bool must_propagate_completion() const { return m_must_propagate_completion; }
 
+    // Used by the optimization passes, which run on the basic blocks before they are linked into an executable.
+    Vector<NonnullOwnPtr<BasicBlock>>& root_basic_blocks() { return m_root_basic_blocks; }
+    [[nodiscard]] Constant const& constant(Operand operand) const { return m_constants[operand.index()]; }
+
 private:
     VM& m_vm;
 
-    static CodeGenerationErrorOr<NonnullGCPtr<Executable>> emit_function_body_bytecode(VM&, ASTNode const&, FunctionKind, GCPtr<ECMAScriptFunctionObject const>, MustPropagateCompletion = MustPropagateCompletion::Yes);
+    static CodeGenerationErrorOr<NonnullOwnPtr<UnlinkedExecutable>> emit_function_body_bytecode(VM&, ASTNode const&, FunctionKind, GCPtr<ECMAScriptFunctionObject const>, MustPropagateCompletion = MustPropagateCompletion::Yes);
 
     enum class JumpType {
         Continue,
@@ -374,7 +421,7 @@ private:
     NonnullOwnPtr<StringTable> m_string_table;
     NonnullOwnPtr<IdentifierTable> m_identifier_table;
     NonnullOwnPtr<RegexTable> m_regex_table;
-    MarkedVector<Value> m_constants;
+    Vector<Constant> m_constants;
 
     ScopedOperand m_accumulator;
     Vector<Register> m_free_registers;
@@ -9,12 +9,14 @@
 #include <AK/TemporaryChange.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
 #include <LibJS/Bytecode/CommonImplementations.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigInt.h>
@@ -151,16 +153,6 @@ Interpreter::~Interpreter()
 {
 }
 
-ALWAYS_INLINE Value Interpreter::get(Operand op) const
-{
-    return m_registers_and_constants_and_locals.data()[op.index()];
-}
-
-ALWAYS_INLINE void Interpreter::set(Operand op, Value value)
-{
-    m_registers_and_constants_and_locals.data()[op.index()] = value;
-}
-
 ALWAYS_INLINE Value Interpreter::do_yield(Value value, Optional<Label> continuation)
 {
     auto object = Object::create(realm(), nullptr);
@@ -226,7 +218,7 @@ ThrowCompletionOr<Value> Interpreter::run(Script& script_record, JS::GCPtr<Envir
 
     // 13. If result.[[Type]] is normal, then
     if (result.type() == Completion::Type::Normal) {
-        auto executable_result = JS::Bytecode::Generator::generate_from_ast_node(vm, script, {});
+        auto executable_result = JS::Bytecode::BytecodeCache::generate_from_program(vm, script);
 
         if (executable_result.is_error()) {
             if (auto error_string = executable_result.error().to_string(); error_string.is_error())
@@ -276,6 +268,10 @@ ThrowCompletionOr<Value> Interpreter::run(Script& script_record, JS::GCPtr<Envir
 
     vm.finish_execution_generation();
 
+    // Non-standard: Write out the bytecode the script added to the cache, now that it's done running.
+    if (auto* cache = script.bytecode_cache())
+        cache->flush();
+
     // 18. Return ? result.
     if (result.is_abrupt()) {
         VERIFY(result.type() == Completion::Type::Throw);
@@ -299,6 +295,9 @@ ThrowCompletionOr<Value> Interpreter::run(SourceTextModule& module)
 
     vm.run_queued_finalization_registry_cleanup_jobs();
 
+    if (auto* cache = module.parse_node().bytecode_cache())
+        cache->flush();
+
     return js_undefined();
 }
 
@@ -691,6 +690,19 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
     }
 }
 
+void Interpreter::run_native(JIT::NativeExecutable const& native_executable)
+{
+    if (vm().did_reach_stack_space_limit()) {
+        reg(Register::exception()) = vm().throw_completion<InternalError>(ErrorType::CallStackSizeExceeded).release_value().value();
+        return;
+    }
+
+    size_t program_counter = 0;
+    TemporaryChange change(m_program_counter, Optional<size_t&>(program_counter));
+
+    native_executable.run(*this, m_registers_and_constants_and_locals, m_arguments, program_counter);
+}
+
 Interpreter::ResultAndReturnRegister Interpreter::run_executable(Executable& executable, Optional<size_t> entry_point, Value initial_accumulator_value)
 {
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter will run unit {:p}", &executable);
@@ -721,7 +733,10 @@ Interpreter::ResultAndReturnRegister Interpreter::run_executable(Executable& exe
         running_execution_context.registers_and_constants_and_locals[executable.number_of_registers + i] = executable.constants[i];
     }
 
-    run_bytecode(entry_point.value_or(0));
+    if (auto const* native_executable = executable.get_or_create_native_executable(); native_executable && entry_point.value_or(0) == 0)
+        run_native(*native_executable);
+    else
+        run_bytecode(entry_point.value_or(0));
 
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter did run unit {:p}", &executable);
 
@@ -800,7 +815,9 @@ void Interpreter::enter_object_environment(Object& object)
 
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM& vm, ASTNode const& node, FunctionKind kind, DeprecatedFlyString const& name)
 {
-    auto executable_result = Bytecode::Generator::generate_from_ast_node(vm, node, kind);
+    auto executable_result = is<Program>(node) && kind == FunctionKind::Normal
+        ? Bytecode::BytecodeCache::generate_from_program(vm, static_cast<Program const&>(node))
+        : Bytecode::Generator::generate_from_ast_node(vm, node, kind);
     if (executable_result.is_error())
         return vm.throw_completion<InternalError>(ErrorType::NotImplemented, TRY_OR_THROW_OOM(vm, executable_result.error().to_string()));
 
@@ -817,7 +834,7 @@ ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM& vm, ECMAScript
 {
     auto const& name = function.name();
 
-    auto executable_result = Bytecode::Generator::generate_from_function(vm, function);
+    auto executable_result = Bytecode::BytecodeCache::generate_from_function(vm, function);
     if (executable_result.is_error())
         return vm.throw_completion<InternalError>(ErrorType::NotImplemented, TRY_OR_THROW_OOM(vm, executable_result.error().to_string()));
 
@@ -1671,7 +1688,7 @@ ThrowCompletionOr<void> SuperCallWithArgumentArray::execute_impl(Bytecode::Inter
 void NewFunction::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
-    interpreter.set(dst(), new_function(vm, m_function_node, m_lhs_name, m_home_object));
+    interpreter.set(dst(), new_function(vm, *m_function_node, m_lhs_name, m_home_object));
 }
 
 void Return::execute_impl(Bytecode::Interpreter& interpreter) const
@@ -1965,7 +1982,7 @@ ThrowCompletionOr<void> NewClass::execute_impl(Bytecode::Interpreter& interprete
             element_key = interpreter.get(m_element_keys[i].value());
         element_keys.append(element_key);
     }
-    interpreter.set(dst(), TRY(new_class(interpreter.vm(), super_class, m_class_expression, m_lhs_name, element_keys)));
+    interpreter.set(dst(), TRY(new_class(interpreter.vm(), super_class, *m_class_expression, m_lhs_name, element_keys)));
     return {};
 }
 
@@ -1984,7 +2001,7 @@ void BlockDeclarationInstantiation::execute_impl(Bytecode::Interpreter& interpre
     auto& running_execution_context = interpreter.running_execution_context();
     running_execution_context.saved_lexical_environments.append(old_environment);
     running_execution_context.lexical_environment = new_declarative_environment(*old_environment);
-    m_scope_node.block_declaration_instantiation(vm, running_execution_context.lexical_environment);
+    m_scope_node->block_declaration_instantiation(vm, running_execution_context.lexical_environment);
 }
 
 ByteString Mov::to_byte_string_impl(Bytecode::Executable const& executable) const
@@ -2410,8 +2427,8 @@ ByteString NewFunction::to_byte_string_impl(Bytecode::Executable const& executab
     StringBuilder builder;
     builder.appendff("NewFunction {}",
         format_operand("dst"sv, m_dst, executable));
-    if (m_function_node.has_name())
-        builder.appendff(" name:{}"sv, m_function_node.name());
+    if (m_function_node->has_name())
+        builder.appendff(" name:{}"sv, m_function_node->name());
     if (m_lhs_name.has_value())
         builder.appendff(" lhs_name:{}"sv, executable.get_identifier(m_lhs_name.value()));
     if (m_home_object.has_value())
@@ -2422,7 +2439,7 @@ ByteString NewFunction::to_byte_string_impl(Bytecode::Executable const& executab
 ByteString NewClass::to_byte_string_impl(Bytecode::Executable const& executable) const
 {
     StringBuilder builder;
-    auto name = m_class_expression.name();
+    auto name = m_class_expression->name();
     builder.appendff("NewClass {}",
         format_operand("dst"sv, m_dst, executable));
     if (m_super_class.has_value())
@@ -8,6 +8,7 @@
 
 #include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/Operand.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
@@ -56,8 +57,14 @@ public:
         return m_registers_and_constants_and_locals.data()[r.index()];
     }
 
-    [[nodiscard]] Value get(Operand) const;
-    void set(Operand, Value);
+    [[nodiscard]] ALWAYS_INLINE Value get(Operand op) const
+    {
+        return m_registers_and_constants_and_locals.data()[op.index()];
+    }
+    ALWAYS_INLINE void set(Operand op, Value value)
+    {
+        m_registers_and_constants_and_locals.data()[op.index()] = value;
+    }
 
     Value do_yield(Value value, Optional<Label> continuation);
     void do_return(Value value)
@@ -80,8 +87,12 @@ public:
 
     ExecutionContext& running_execution_context() { return *m_running_execution_context; }
 
+    MegamorphicPropertyLookupCache& megamorphic_get_cache() { return m_megamorphic_get_cache; }
+    MegamorphicPropertyLookupCache& megamorphic_put_cache() { return m_megamorphic_put_cache; }
+
 private:
     void run_bytecode(size_t entry_point);
+    void run_native(JIT::NativeExecutable const&);
 
     enum class HandleExceptionResponse {
         ExitFromExecutable,
@@ -99,6 +110,8 @@ private:
     Span<Value> m_arguments;
     Span<Value> m_registers_and_constants_and_locals;
     ExecutionContext* m_running_execution_context { nullptr };
+    MegamorphicPropertyLookupCache m_megamorphic_get_cache;
+    MegamorphicPropertyLookupCache m_megamorphic_put_cache;
 };
 
 extern bool g_dump_bytecode;
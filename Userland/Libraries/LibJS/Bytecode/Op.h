@@ -416,6 +416,8 @@ public:
     void execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    IdentifierTableIndex name() const { return m_name; }
+
 private:
     IdentifierTableIndex m_name;
 };
@@ -693,6 +695,7 @@ public:
 
     IdentifierTableIndex identifier() const { return m_identifier; }
     Operand src() const { return m_src; }
+    EnvironmentCoordinate const& cache() const { return m_cache; }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -718,6 +721,7 @@ public:
 
     IdentifierTableIndex identifier() const { return m_identifier; }
     Operand src() const { return m_src; }
+    EnvironmentCoordinate const& cache() const { return m_cache; }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -743,6 +747,7 @@ public:
 
     IdentifierTableIndex identifier() const { return m_identifier; }
     Operand src() const { return m_src; }
+    EnvironmentCoordinate const& cache() const { return m_cache; }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -768,6 +773,7 @@ public:
 
     IdentifierTableIndex identifier() const { return m_identifier; }
     Operand src() const { return m_src; }
+    EnvironmentCoordinate const& cache() const { return m_cache; }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -842,6 +848,7 @@ public:
     IdentifierTableIndex identifier() const { return m_identifier; }
     Operand callee() const { return m_callee; }
     Operand this_() const { return m_this_value; }
+    EnvironmentCoordinate const& cache() const { return m_cache; }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -870,6 +877,8 @@ public:
         visitor(m_dst);
     }
 
+    EnvironmentCoordinate const& cache() const { return m_cache; }
+
 private:
     Operand m_dst;
     IdentifierTableIndex m_identifier;
@@ -953,6 +962,7 @@ public:
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
     u32 cache_index() const { return m_cache_index; }
+    Optional<IdentifierTableIndex> const& base_identifier() const { return m_base_identifier; }
 
 private:
     Operand m_dst;
@@ -1019,6 +1029,7 @@ public:
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     u32 cache_index() const { return m_cache_index; }
+    Optional<IdentifierTableIndex> const& base_identifier() const { return m_base_identifier; }
 
 private:
     Operand m_dst;
@@ -1150,6 +1161,7 @@ public:
     Operand src() const { return m_src; }
     PropertyKind kind() const { return m_kind; }
     u32 cache_index() const { return m_cache_index; }
+    Optional<IdentifierTableIndex> const& base_identifier() const { return m_base_identifier; }
 
 private:
     Operand m_base;
@@ -1313,6 +1325,7 @@ public:
     Operand property() const { return m_property; }
 
     Optional<DeprecatedFlyString const&> base_identifier(Bytecode::Interpreter const&) const;
+    Optional<IdentifierTableIndex> const& base_identifier() const { return m_base_identifier; }
 
 private:
     Operand m_dst;
@@ -1379,6 +1392,7 @@ public:
     Operand property() const { return m_property; }
     Operand src() const { return m_src; }
     PropertyKind kind() const { return m_kind; }
+    Optional<IdentifierTableIndex> const& base_identifier() const { return m_base_identifier; }
 
 private:
     Operand m_base;
@@ -1733,9 +1747,12 @@ public:
         , m_this_value(this_value)
         , m_argument_count(arguments.size())
         , m_type(type)
-        , m_builtin(builtin)
         , m_expression_string(expression_string)
     {
+        // NOTE: Copying an empty Optional<Builtin> copies whatever garbage its storage held, which would make the bytecode
+        //       differ between compilations of the same code, and the bytecode cache with it.
+        if (builtin.has_value())
+            m_builtin = builtin.value();
         for (size_t i = 0; i < arguments.size(); ++i)
             m_arguments[i] = arguments[i];
     }
@@ -1852,7 +1869,7 @@ public:
         : Instruction(Type::NewClass)
         , m_dst(dst)
         , m_super_class(super_class)
-        , m_class_expression(class_expression)
+        , m_class_expression(&class_expression)
         , m_lhs_name(lhs_name)
         , m_element_keys_count(elements_keys.size())
     {
@@ -1882,13 +1899,14 @@ public:
 
     Operand dst() const { return m_dst; }
     Optional<Operand> const& super_class() const { return m_super_class; }
-    ClassExpression const& class_expression() const { return m_class_expression; }
+    ClassExpression const& class_expression() const { return *m_class_expression; }
+    void set_class_expression(Badge<BytecodeCache>, ClassExpression const* class_expression) { m_class_expression = class_expression; }
     Optional<IdentifierTableIndex> const& lhs_name() const { return m_lhs_name; }
 
 private:
     Operand m_dst;
     Optional<Operand> m_super_class;
-    ClassExpression const& m_class_expression;
+    ClassExpression const* m_class_expression { nullptr };
     Optional<IdentifierTableIndex> m_lhs_name;
     size_t m_element_keys_count { 0 };
     Optional<Operand> m_element_keys[];
@@ -1899,7 +1917,7 @@ public:
     explicit NewFunction(Operand dst, FunctionNode const& function_node, Optional<IdentifierTableIndex> lhs_name, Optional<Operand> home_object = {})
         : Instruction(Type::NewFunction)
         , m_dst(dst)
-        , m_function_node(function_node)
+        , m_function_node(&function_node)
         , m_lhs_name(lhs_name)
         , m_home_object(move(home_object))
     {
@@ -1915,13 +1933,14 @@ public:
     }
 
     Operand dst() const { return m_dst; }
-    FunctionNode const& function_node() const { return m_function_node; }
+    FunctionNode const& function_node() const { return *m_function_node; }
+    void set_function_node(Badge<BytecodeCache>, FunctionNode const* function_node) { m_function_node = function_node; }
     Optional<IdentifierTableIndex> const& lhs_name() const { return m_lhs_name; }
     Optional<Operand> const& home_object() const { return m_home_object; }
 
 private:
     Operand m_dst;
-    FunctionNode const& m_function_node;
+    FunctionNode const* m_function_node { nullptr };
     Optional<IdentifierTableIndex> m_lhs_name;
     Optional<Operand> m_home_object;
 };
@@ -1930,17 +1949,18 @@ class BlockDeclarationInstantiation final : public Instruction {
 public:
     explicit BlockDeclarationInstantiation(ScopeNode const& scope_node)
         : Instruction(Type::BlockDeclarationInstantiation)
-        , m_scope_node(scope_node)
+        , m_scope_node(&scope_node)
     {
     }
 
     void execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
-    ScopeNode const& scope_node() const { return m_scope_node; }
+    ScopeNode const& scope_node() const { return *m_scope_node; }
+    void set_scope_node(Badge<BytecodeCache>, ScopeNode const* scope_node) { m_scope_node = scope_node; }
 
 private:
-    ScopeNode const& m_scope_node;
+    ScopeNode const* m_scope_node { nullptr };
 };
 
 class Return final : public Instruction {
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <LibJS/Runtime/ValueInlines.h>
+
+namespace JS::Bytecode::Passes {
+
+// NOTE: Operations on these values can neither throw nor run user code, so they can be evaluated ahead of time.
+static bool is_foldable(Value value)
+{
+    return value.is_number() || value.is_boolean() || value.is_nullish();
+}
+
+static Optional<Value> foldable_constant(Generator& generator, Operand operand)
+{
+    if (!operand.is_constant())
+        return {};
+    auto const* value = generator.constant(operand).get_pointer<Value>();
+    if (!value || !is_foldable(*value))
+        return {};
+    return *value;
+}
+
+static ThrowCompletionOr<Value> loosely_equals(VM& vm, Value lhs, Value rhs)
+{
+    return Value(TRY(is_loosely_equal(vm, lhs, rhs)));
+}
+
+static ThrowCompletionOr<Value> loosely_inequals(VM& vm, Value lhs, Value rhs)
+{
+    return Value(!TRY(is_loosely_equal(vm, lhs, rhs)));
+}
+
+static ThrowCompletionOr<Value> strict_equals(VM&, Value lhs, Value rhs)
+{
+    return Value(is_strictly_equal(lhs, rhs));
+}
+
+static ThrowCompletionOr<Value> strict_inequals(VM&, Value lhs, Value rhs)
+{
+    return Value(!is_strictly_equal(lhs, rhs));
+}
+
+static ThrowCompletionOr<Value> not_(VM&, Value value)
+{
+    return Value(!value.to_boolean());
+}
+
+// Returns the value of the instruction's destination if it only depends on constants, or the label it always jumps to.
+static Variant<Empty, Value, Label> fold(Generator& generator, Instruction const& instruction)
+{
+    auto& vm = generator.vm();
+
+    switch (instruction.type()) {
+#define HANDLE_BINARY_OP(OpTitleCase, op_snake_case)                                            \
+    case Instruction::Type::OpTitleCase: {                                                      \
+        auto const& op = static_cast<Op::OpTitleCase const&>(instruction);                      \
+        auto lhs = foldable_constant(generator, op.lhs());                                      \
+        auto rhs = foldable_constant(generator, op.rhs());                                      \
+        if (!lhs.has_value() || !rhs.has_value())                                               \
+            return {};                                                                          \
+        return MUST(op_snake_case(vm, *lhs, *rhs));                                             \
+    }
+        JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(HANDLE_BINARY_OP)
+        HANDLE_BINARY_OP(Div, div)
+        HANDLE_BINARY_OP(Exp, exp)
+        HANDLE_BINARY_OP(Mod, mod)
+        HANDLE_BINARY_OP(LooselyEquals, loosely_equals)
+        HANDLE_BINARY_OP(LooselyInequals, loosely_inequals)
+        HANDLE_BINARY_OP(StrictlyEquals, strict_equals)
+        HANDLE_BINARY_OP(StrictlyInequals, strict_inequals)
+#undef HANDLE_BINARY_OP
+
+#define HANDLE_UNARY_OP(OpTitleCase, op_snake_case)                        \
+    case Instruction::Type::OpTitleCase: {                                 \
+        auto const& op = static_cast<Op::OpTitleCase const&>(instruction); \
+        auto src = foldable_constant(generator, op.src());                 \
+        if (!src.has_value())                                              \
+            return {};                                                     \
+        return MUST(op_snake_case(vm, *src));                              \
+    }
+        HANDLE_UNARY_OP(BitwiseNot, bitwise_not)
+        HANDLE_UNARY_OP(Not, not_)
+        HANDLE_UNARY_OP(UnaryPlus, unary_plus)
+        HANDLE_UNARY_OP(UnaryMinus, unary_minus)
+#undef HANDLE_UNARY_OP
+
+#define HANDLE_COMPARISON_JUMP(op_TitleCase, op_snake_case, numeric_operator)         \
+    case Instruction::Type::Jump##op_TitleCase: {                                     \
+        auto const& jump = static_cast<Op::Jump##op_TitleCase const&>(instruction);   \
+        auto lhs = foldable_constant(generator, jump.lhs());                          \
+        auto rhs = foldable_constant(generator, jump.rhs());                          \
+        if (!lhs.has_value() || !rhs.has_value())                                     \
+            return {};                                                                \
+        if (MUST(op_snake_case(vm, *lhs, *rhs)).as_bool())                            \
+            return jump.true_target();                                                \
+        return jump.false_target();                                                   \
+    }
+        JS_ENUMERATE_COMPARISON_OPS(HANDLE_COMPARISON_JUMP)
+#undef HANDLE_COMPARISON_JUMP
+
+    case Instruction::Type::JumpIf: {
+        auto const& jump = static_cast<Op::JumpIf const&>(instruction);
+        if (!jump.condition().is_constant())
+            return {};
+        auto condition = generator.constant(jump.condition()).visit(
+            [](Value value) -> Optional<bool> {
+                if (value.is_empty())
+                    return {};
+                return value.to_boolean();
+            },
+            [](ByteString const& string) -> Optional<bool> { return !string.is_empty(); },
+            [](Crypto::SignedBigInteger const& integer) -> Optional<bool> { return !integer.is_zero(); });
+        if (!condition.has_value())
+            return {};
+        return *condition ? jump.true_target() : jump.false_target();
+    }
+    case Instruction::Type::JumpNullish: {
+        auto const& jump = static_cast<Op::JumpNullish const&>(instruction);
+        auto condition = foldable_constant(generator, jump.condition());
+        if (!condition.has_value())
+            return {};
+        return condition->is_nullish() ? jump.true_target() : jump.false_target();
+    }
+    case Instruction::Type::JumpUndefined: {
+        auto const& jump = static_cast<Op::JumpUndefined const&>(instruction);
+        auto condition = foldable_constant(generator, jump.condition());
+        if (!condition.has_value())
+            return {};
+        return condition->is_undefined() ? jump.true_target() : jump.false_target();
+    }
+    default:
+        return {};
+    }
+}
+
+static Operand destination(Instruction const& instruction)
+{
+    switch (instruction.type()) {
+#define HANDLE_OP(OpTitleCase, ...)      \
+    case Instruction::Type::OpTitleCase: \
+        return static_cast<Op::OpTitleCase const&>(instruction).dst();
+        JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(HANDLE_OP)
+        JS_ENUMERATE_COMMON_BINARY_OPS_WITHOUT_FAST_PATH(HANDLE_OP)
+        JS_ENUMERATE_COMMON_UNARY_OPS(HANDLE_OP)
+#undef HANDLE_OP
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void ConstantFolding::perform(Generator& generator)
+{
+    for (auto& block : generator.root_basic_blocks()) {
+        BasicBlockRewriter rewriter(*block);
+        bool did_fold = false;
+
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            auto const& instruction = *it;
+            fold(generator, instruction).visit(
+                [&](Empty) {
+                    rewriter.append(instruction, block->source_map().get(it.offset()));
+                },
+                [&](Value value) {
+                    rewriter.emit<Op::Mov>(it.offset(), destination(instruction), generator.add_constant(value));
+                    did_fold = true;
+                },
+                [&](Label target) {
+                    rewriter.emit<Op::Jump>(it.offset(), target);
+                    did_fold = true;
+                });
+        }
+
+        if (did_fold)
+            rewriter.finish();
+    }
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashTable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// Returns the destination of instructions that have no effect other than writing it.
+static Optional<Operand> side_effect_free_destination(Instruction const& instruction)
+{
+    switch (instruction.type()) {
+    case Instruction::Type::Mov:
+        return static_cast<Op::Mov const&>(instruction).dst();
+    case Instruction::Type::Not:
+        return static_cast<Op::Not const&>(instruction).dst();
+    case Instruction::Type::Typeof:
+        return static_cast<Op::Typeof const&>(instruction).dst();
+    case Instruction::Type::StrictlyEquals:
+        return static_cast<Op::StrictlyEquals const&>(instruction).dst();
+    case Instruction::Type::StrictlyInequals:
+        return static_cast<Op::StrictlyInequals const&>(instruction).dst();
+    case Instruction::Type::GetArgument:
+        return static_cast<Op::GetArgument const&>(instruction).dst();
+    case Instruction::Type::NewObject:
+        return static_cast<Op::NewObject const&>(instruction).dst();
+    default:
+        return {};
+    }
+}
+
+void DeadStoreElimination::perform(Generator& generator)
+{
+    OperandUseCounts use_counts(generator);
+
+    struct Candidate {
+        BasicBlock* block;
+        size_t offset;
+        Operand destination;
+    };
+    Vector<Candidate> candidates;
+
+    HashTable<u8 const*> dead_instructions;
+    auto mark_dead = [&](BasicBlock& block, size_t offset) {
+        auto& instruction = const_cast<Instruction&>(*reinterpret_cast<Instruction const*>(block.data() + offset));
+        dead_instructions.set(block.data() + offset);
+        instruction.visit_operands([&](Operand& operand) {
+            use_counts.decrement(operand);
+        });
+    };
+
+    for (auto& block : generator.root_basic_blocks()) {
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            auto destination = side_effect_free_destination(*it);
+            if (!destination.has_value())
+                continue;
+
+            // A move of an operand into itself does nothing at all.
+            if ((*it).type() == Instruction::Type::Mov && static_cast<Op::Mov const&>(*it).src() == *destination) {
+                mark_dead(*block, it.offset());
+                continue;
+            }
+
+            if (OperandUseCounts::is_tracked(*destination))
+                candidates.append({ block.ptr(), it.offset(), *destination });
+        }
+    }
+
+    // The only mention of a dead store's destination is the store itself. Removing a store may leave the stores to
+    // the operands it read dead too, so keep going until nothing changes.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& candidate : candidates) {
+            if (dead_instructions.contains(candidate.block->data() + candidate.offset))
+                continue;
+            if (use_counts[candidate.destination] != 1)
+                continue;
+            mark_dead(*candidate.block, candidate.offset);
+            changed = true;
+        }
+    }
+
+    if (dead_instructions.is_empty())
+        return;
+
+    for (auto& block : generator.root_basic_blocks()) {
+        BasicBlockRewriter rewriter(*block);
+        bool did_remove = false;
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            if (dead_instructions.contains(block->data() + it.offset())) {
+                did_remove = true;
+                continue;
+            }
+            rewriter.append(*it, block->source_map().get(it.offset()));
+        }
+        if (did_remove)
+            rewriter.finish();
+    }
+}
+
+}
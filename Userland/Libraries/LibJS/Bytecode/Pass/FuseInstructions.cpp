@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// Returns true if the operand is a temporary that is only written by one instruction and read by one other.
+static bool is_single_use_temporary(OperandUseCounts const& use_counts, Operand operand)
+{
+    return operand.is_register() && OperandUseCounts::is_tracked(operand) && use_counts[operand] == 2;
+}
+
+static bool is_undefined_constant(Generator& generator, Operand operand)
+{
+    if (!operand.is_constant())
+        return false;
+    auto const* value = generator.constant(operand).get_pointer<Value>();
+    return value && value->is_undefined();
+}
+
+// Emits a compare-and-jump instruction, or JumpUndefined for strict (in)equality with undefined, which doesn't need
+// to compare anything.
+template<typename OpType>
+static void emit_comparison_jump(Generator& generator, BasicBlockRewriter& rewriter, size_t replaced_offset, Operand lhs, Operand rhs, Label true_target, Label false_target)
+{
+    if constexpr (IsOneOf<OpType, Op::JumpStrictlyEquals, Op::JumpStrictlyInequals>) {
+        if (is_undefined_constant(generator, lhs))
+            swap(lhs, rhs);
+        if (is_undefined_constant(generator, rhs)) {
+            if constexpr (IsSame<OpType, Op::JumpStrictlyInequals>)
+                swap(true_target, false_target);
+            rewriter.emit<Op::JumpUndefined>(replaced_offset, lhs, true_target, false_target);
+            return;
+        }
+    }
+    rewriter.emit<OpType>(replaced_offset, lhs, rhs, true_target, false_target);
+}
+
+// Emits the fused form of `first` followed by `second`, if there is one.
+static bool fuse(Generator& generator, OperandUseCounts const& use_counts, BasicBlockRewriter& rewriter, Instruction const& first, size_t first_offset, Instruction const& second)
+{
+    // Comparison + JumpIf -> JumpComparison
+    if (second.type() == Instruction::Type::JumpIf) {
+        auto const& jump = static_cast<Op::JumpIf const&>(second);
+        if (!is_single_use_temporary(use_counts, jump.condition()))
+            return false;
+
+#define HANDLE_COMPARISON_OP(op_TitleCase, op_snake_case, numeric_operator)               \
+    if (first.type() == Instruction::Type::op_TitleCase) {                                \
+        auto const& comparison = static_cast<Op::op_TitleCase const&>(first);             \
+        if (comparison.dst() != jump.condition())                                         \
+            return false;                                                                 \
+        emit_comparison_jump<Op::Jump##op_TitleCase>(generator, rewriter, first_offset,   \
+            comparison.lhs(), comparison.rhs(), jump.true_target(), jump.false_target()); \
+        return true;                                                                      \
+    }
+        JS_ENUMERATE_COMPARISON_OPS(HANDLE_COMPARISON_OP)
+#undef HANDLE_COMPARISON_OP
+
+        // Not + JumpIf -> JumpIf with the targets swapped
+        if (first.type() == Instruction::Type::Not) {
+            auto const& not_ = static_cast<Op::Not const&>(first);
+            if (not_.dst() != jump.condition())
+                return false;
+            rewriter.emit<Op::JumpIf>(first_offset, not_.src(), jump.false_target(), jump.true_target());
+            return true;
+        }
+        return false;
+    }
+
+    // Operation into a temporary + Mov out of the temporary -> Operation straight into the Mov's destination
+    // NOTE: These operations write their destination once all operands have been read and nothing can throw anymore,
+    //       so the destination may also be one of the operands.
+    if (second.type() == Instruction::Type::Mov) {
+        auto const& mov = static_cast<Op::Mov const&>(second);
+        if (!is_single_use_temporary(use_counts, mov.src()))
+            return false;
+
+        switch (first.type()) {
+#define HANDLE_BINARY_OP(OpTitleCase, ...)                                           \
+    case Instruction::Type::OpTitleCase: {                                           \
+        auto const& op = static_cast<Op::OpTitleCase const&>(first);                 \
+        if (op.dst() != mov.src())                                                   \
+            return false;                                                            \
+        rewriter.emit<Op::OpTitleCase>(first_offset, mov.dst(), op.lhs(), op.rhs()); \
+        return true;                                                                 \
+    }
+            JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(HANDLE_BINARY_OP)
+            JS_ENUMERATE_COMMON_BINARY_OPS_WITHOUT_FAST_PATH(HANDLE_BINARY_OP)
+#undef HANDLE_BINARY_OP
+#define HANDLE_UNARY_OP(OpTitleCase, ...)                                  \
+    case Instruction::Type::OpTitleCase: {                                 \
+        auto const& op = static_cast<Op::OpTitleCase const&>(first);       \
+        if (op.dst() != mov.src())                                         \
+            return false;                                                  \
+        rewriter.emit<Op::OpTitleCase>(first_offset, mov.dst(), op.src()); \
+        return true;                                                       \
+    }
+            JS_ENUMERATE_COMMON_UNARY_OPS(HANDLE_UNARY_OP)
+#undef HANDLE_UNARY_OP
+        default:
+            return false;
+        }
+    }
+
+    return false;
+}
+
+static bool specialize(Generator& generator, BasicBlockRewriter& rewriter, Instruction const& instruction, size_t offset)
+{
+    if (instruction.type() == Instruction::Type::JumpStrictlyEquals) {
+        auto const& jump = static_cast<Op::JumpStrictlyEquals const&>(instruction);
+        if (!is_undefined_constant(generator, jump.lhs()) && !is_undefined_constant(generator, jump.rhs()))
+            return false;
+        emit_comparison_jump<Op::JumpStrictlyEquals>(generator, rewriter, offset, jump.lhs(), jump.rhs(), jump.true_target(), jump.false_target());
+        return true;
+    }
+    if (instruction.type() == Instruction::Type::JumpStrictlyInequals) {
+        auto const& jump = static_cast<Op::JumpStrictlyInequals const&>(instruction);
+        if (!is_undefined_constant(generator, jump.lhs()) && !is_undefined_constant(generator, jump.rhs()))
+            return false;
+        emit_comparison_jump<Op::JumpStrictlyInequals>(generator, rewriter, offset, jump.lhs(), jump.rhs(), jump.true_target(), jump.false_target());
+        return true;
+    }
+    return false;
+}
+
+void FuseInstructions::perform(Generator& generator)
+{
+    OperandUseCounts use_counts(generator);
+
+    for (auto& block : generator.root_basic_blocks()) {
+        BasicBlockRewriter rewriter(*block);
+        bool did_fuse = false;
+
+        Instruction const* previous = nullptr;
+        size_t previous_offset = 0;
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            auto const& instruction = *it;
+
+            if (previous && fuse(generator, use_counts, rewriter, *previous, previous_offset, instruction)) {
+                previous = nullptr;
+                did_fuse = true;
+                continue;
+            }
+
+            if (previous)
+                rewriter.append(*previous, block->source_map().get(previous_offset));
+            previous = &instruction;
+            previous_offset = it.offset();
+        }
+
+        if (previous) {
+            if (specialize(generator, rewriter, *previous, previous_offset))
+                did_fuse = true;
+            else
+                rewriter.append(*previous, block->source_map().get(previous_offset));
+        }
+
+        if (did_fuse)
+            rewriter.finish();
+    }
+}
+
+}
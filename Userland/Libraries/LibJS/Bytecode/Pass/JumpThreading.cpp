@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashTable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// Returns the target of the block's jump if the block does nothing but jump.
+static Optional<size_t> forwarded_target(BasicBlock const& block)
+{
+    InstructionStreamIterator it(block.instruction_stream());
+    if (it.at_end() || (*it).type() != Instruction::Type::Jump)
+        return {};
+    return static_cast<Op::Jump const&>(*it).target().basic_block_index();
+}
+
+void JumpThreading::perform(Generator& generator)
+{
+    auto& blocks = generator.root_basic_blocks();
+
+    Vector<Optional<size_t>> final_targets;
+    final_targets.resize(blocks.size());
+    for (auto& block : blocks) {
+        auto target = forwarded_target(*block);
+        if (!target.has_value())
+            continue;
+
+        // Follow chains of forwarding blocks, but don't get stuck in an infinite loop like `for (;;) {}`.
+        HashTable<size_t> seen;
+        seen.set(block->index());
+        while (!seen.contains(*target)) {
+            seen.set(*target);
+            auto next_target = forwarded_target(*blocks[*target]);
+            if (!next_target.has_value())
+                break;
+            target = next_target;
+        }
+        if (*target != block->index())
+            final_targets[block->index()] = target;
+    }
+
+    for (auto& block : blocks) {
+        Optional<size_t> redundant_jump_if_offset;
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            instruction.visit_labels([&](Label& label) {
+                if (auto target = final_targets[label.basic_block_index()]; target.has_value())
+                    label = Label { static_cast<u32>(*target) };
+            });
+
+            // A conditional jump with two identical targets is an unconditional one, as testing a value for
+            // truthiness has no side effects.
+            if (instruction.type() == Instruction::Type::JumpIf) {
+                auto const& jump = static_cast<Op::JumpIf const&>(instruction);
+                if (jump.true_target().basic_block_index() == jump.false_target().basic_block_index())
+                    redundant_jump_if_offset = it.offset();
+            }
+        }
+
+        if (!redundant_jump_if_offset.has_value())
+            continue;
+
+        BasicBlockRewriter rewriter(*block);
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            if (it.offset() == *redundant_jump_if_offset)
+                rewriter.emit<Op::Jump>(it.offset(), static_cast<Op::JumpIf const&>(*it).true_target());
+            else
+                rewriter.append(*it, block->source_map().get(it.offset()));
+        }
+        rewriter.finish();
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static void for_each_label(BasicBlock& block, Function<void(Label&)> callback)
+{
+    for (InstructionStreamIterator it(block.instruction_stream()); !it.at_end(); ++it)
+        const_cast<Instruction&>(*it).visit_labels([&](Label& label) { callback(label); });
+}
+
+static Optional<size_t> last_instruction_offset(BasicBlock const& block)
+{
+    Optional<size_t> offset;
+    for (InstructionStreamIterator it(block.instruction_stream()); !it.at_end(); ++it)
+        offset = it.offset();
+    return offset;
+}
+
+void MergeBlocks::perform(Generator& generator)
+{
+    auto& blocks = generator.root_basic_blocks();
+
+    // Blocks are entered through labels, or by unwinding to a handler or finalizer.
+    Vector<bool> is_reachable;
+    is_reachable.resize(blocks.size());
+    Vector<size_t> work_list { 0 };
+    is_reachable[0] = true;
+    auto reach = [&](size_t index) {
+        if (is_reachable[index])
+            return;
+        is_reachable[index] = true;
+        work_list.append(index);
+    };
+    while (!work_list.is_empty()) {
+        auto& block = *blocks[work_list.take_last()];
+        for_each_label(block, [&](Label& label) { reach(label.basic_block_index()); });
+        if (block.handler())
+            reach(block.handler()->index());
+        if (block.finalizer())
+            reach(block.finalizer()->index());
+    }
+
+    Vector<size_t> reference_counts;
+    reference_counts.resize(blocks.size());
+    for (auto& block : blocks) {
+        if (!is_reachable[block->index()])
+            continue;
+        for_each_label(*block, [&](Label& label) { ++reference_counts[label.basic_block_index()]; });
+        // NOTE: Handlers and finalizers are never merged into other blocks, so that they keep their own block.
+        if (block->handler())
+            reference_counts[block->handler()->index()] = NumericLimits<size_t>::max();
+        if (block->finalizer())
+            reference_counts[block->finalizer()->index()] = NumericLimits<size_t>::max();
+    }
+
+    // A block that is only entered by a jump at the end of another block can be appended to that block, as long as
+    // exceptions are handled the same way in both.
+    Vector<bool> is_merged;
+    is_merged.resize(blocks.size());
+    for (auto& block : blocks) {
+        if (!is_reachable[block->index()] || is_merged[block->index()])
+            continue;
+
+        for (;;) {
+            auto jump_offset = last_instruction_offset(*block);
+            if (!jump_offset.has_value())
+                break;
+            auto const& jump = *reinterpret_cast<Instruction const*>(block->data() + *jump_offset);
+            if (jump.type() != Instruction::Type::Jump)
+                break;
+
+            auto& successor = *blocks[static_cast<Op::Jump const&>(jump).target().basic_block_index()];
+            if (&successor == block.ptr()
+                || successor.index() == 0
+                || reference_counts[successor.index()] != 1
+                || successor.handler() != block->handler()
+                || successor.finalizer() != block->finalizer()) {
+                break;
+            }
+
+            BasicBlockRewriter rewriter(*block);
+            for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+                if (it.offset() != *jump_offset)
+                    rewriter.append(*it, block->source_map().get(it.offset()));
+            }
+            for (InstructionStreamIterator it(successor.instruction_stream()); !it.at_end(); ++it)
+                rewriter.append_from_block(successor, it.offset());
+            rewriter.finish(successor.is_terminated());
+
+            is_merged[successor.index()] = true;
+        }
+    }
+
+    // Drop the blocks that are gone, and renumber the others.
+    Vector<u32> new_indices;
+    new_indices.resize(blocks.size());
+    Vector<NonnullOwnPtr<BasicBlock>> remaining_blocks;
+    for (auto& block : blocks) {
+        if (!is_reachable[block->index()] || is_merged[block->index()])
+            continue;
+        new_indices[block->index()] = remaining_blocks.size();
+        remaining_blocks.append(move(block));
+    }
+    if (remaining_blocks.size() == blocks.size()) {
+        blocks = move(remaining_blocks);
+        return;
+    }
+
+    for (auto& block : remaining_blocks) {
+        block->set_index(new_indices[block->index()]);
+        for_each_label(*block, [&](Label& label) { label = Label { new_indices[label.basic_block_index()] }; });
+    }
+    blocks = move(remaining_blocks);
+}
+
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Format.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <stdlib.h>
+
+namespace JS::Bytecode {
+
+PassManager& PassManager::the()
+{
+    static auto pass_manager = [] {
+        auto pass_manager = make<PassManager>();
+        pass_manager->add<Passes::ConstantFolding>();
+        pass_manager->add<Passes::FuseInstructions>();
+        pass_manager->add<Passes::DeadStoreElimination>();
+        pass_manager->add<Passes::JumpThreading>();
+        pass_manager->add<Passes::MergeBlocks>();
+
+        if (auto const* enabled_passes = getenv("LIBJS_BYTECODE_PASSES")) {
+            if (auto result = pass_manager->set_enabled_passes({ enabled_passes, strlen(enabled_passes) }); result.is_error())
+                warnln("LIBJS_BYTECODE_PASSES: {}", result.error());
+        }
+        return pass_manager;
+    }();
+    return *pass_manager;
+}
+
+void PassManager::perform(Generator& generator)
+{
+    if (!m_collects_statistics) {
+        for (auto& pass : m_passes) {
+            if (pass->is_enabled())
+                pass->perform(generator);
+        }
+        return;
+    }
+
+    auto instruction_count = count_instructions(generator);
+
+    for (auto& pass : m_passes) {
+        if (!pass->is_enabled())
+            continue;
+
+        auto start_time = MonotonicTime::now();
+        pass->perform(generator);
+        auto time = MonotonicTime::now() - start_time;
+        auto instructions_before = exchange(instruction_count, count_instructions(generator));
+
+        // NOTE: Code can be generated on more than one thread at a time, see BackgroundParser.
+        Threading::MutexLocker locker(m_statistics_mutex);
+        auto& statistics = pass->statistics();
+        statistics.time += time;
+        statistics.executables++;
+        statistics.instructions_before += instructions_before;
+        statistics.instructions_after += instruction_count;
+    }
+}
+
+ErrorOr<void> PassManager::set_enabled_passes(StringView names)
+{
+    Vector<StringView> enabled_passes;
+    if (names != "none"sv) {
+        enabled_passes = names.split_view(',');
+        for (auto name : enabled_passes) {
+            if (!m_passes.first_matching([&](auto& pass) { return pass->name() == name; }).has_value())
+                return AK::Error::from_string_literal("Unknown bytecode optimization pass");
+        }
+    }
+
+    for (auto& pass : m_passes)
+        pass->set_enabled(enabled_passes.contains_slow(pass->name()));
+    return {};
+}
+
+void PassManager::dump_statistics() const
+{
+    warnln("Bytecode optimization passes:");
+    for (auto const& pass : m_passes) {
+        if (!pass->is_enabled()) {
+            warnln("  {:24} disabled", pass->name());
+            continue;
+        }
+
+        auto const& statistics = pass->statistics();
+        auto removed = static_cast<i64>(statistics.instructions_before) - static_cast<i64>(statistics.instructions_after);
+        auto percentage = statistics.instructions_before ? 100.0 * removed / statistics.instructions_before : 0.0;
+        warnln("  {:24} {:8} of {:8} instructions removed ({:.2}%) in {} executables, {:.3} ms",
+            pass->name(), removed, statistics.instructions_before, percentage, statistics.executables, statistics.time.to_microseconds() / 1000.0);
+    }
+}
+
+void BasicBlockRewriter::append(Instruction const& instruction, Optional<SourceRecord> source_record)
+{
+    auto slot_offset = m_buffer.size();
+    m_buffer.append(reinterpret_cast<u8 const*>(&instruction), instruction.length());
+    did_append(slot_offset, source_record);
+}
+
+void BasicBlockRewriter::append_from_block(BasicBlock const& block, size_t offset)
+{
+    append(*reinterpret_cast<Instruction const*>(block.data() + offset), block.source_map().get(offset));
+}
+
+void BasicBlockRewriter::did_append(size_t offset, Optional<SourceRecord> source_record)
+{
+    m_last_instruction_start_offset = offset;
+    if (source_record.has_value())
+        m_source_map.set(offset, source_record.value());
+}
+
+void BasicBlockRewriter::finish(bool is_terminated)
+{
+    m_block.set_instruction_stream(move(m_buffer), move(m_source_map), m_last_instruction_start_offset, is_terminated);
+}
+
+size_t count_instructions(Generator& generator)
+{
+    size_t count = 0;
+    for (auto& block : generator.root_basic_blocks()) {
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it)
+            ++count;
+    }
+    return count;
+}
+
+OperandUseCounts::OperandUseCounts(Generator& generator)
+{
+    for (auto& block : generator.root_basic_blocks()) {
+        for (InstructionStreamIterator it(block->instruction_stream()); !it.at_end(); ++it) {
+            const_cast<Instruction&>(*it).visit_operands([&](Operand& operand) {
+                if (!operand.is_constant())
+                    m_counts.ensure(key(operand), [] { return 0; })++;
+            });
+        }
+    }
+}
+
+void OperandUseCounts::decrement(Operand operand)
+{
+    if (operand.is_constant())
+        return;
+    auto it = m_counts.find(key(operand));
+    VERIFY(it != m_counts.end() && it->value > 0);
+    --it->value;
+}
+
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibThreading/Mutex.h>
+
+namespace JS::Bytecode {
+
+// Optimization passes run on the basic blocks of a Generator once code generation is done, before the blocks are
+// linked into an executable. At that point, labels still refer to blocks by index, and operands have not been
+// relocated yet.
+class Pass {
+public:
+    struct Statistics {
+        size_t executables { 0 };
+        size_t instructions_before { 0 };
+        size_t instructions_after { 0 };
+        Duration time {};
+    };
+
+    virtual ~Pass() = default;
+
+    virtual StringView name() const = 0;
+    virtual void perform(Generator&) = 0;
+
+    bool is_enabled() const { return m_enabled; }
+    void set_enabled(bool enabled) { m_enabled = enabled; }
+
+    Statistics const& statistics() const { return m_statistics; }
+    Statistics& statistics() { return m_statistics; }
+
+private:
+    bool m_enabled { true };
+    Statistics m_statistics;
+};
+
+class PassManager {
+public:
+    // The pipeline every generated executable goes through. Passes can be disabled with the comma-separated
+    // LIBJS_BYTECODE_PASSES environment variable, which lists the passes to run ("none" disables all of them).
+    static PassManager& the();
+
+    template<typename PassType, typename... Args>
+    void add(Args&&... args)
+    {
+        m_passes.append(make<PassType>(forward<Args>(args)...));
+    }
+
+    void perform(Generator&);
+
+    // Enables the passes named in the comma-separated list, and disables all others.
+    ErrorOr<void> set_enabled_passes(StringView);
+
+    Vector<NonnullOwnPtr<Pass>> const& passes() const { return m_passes; }
+
+    // Counting instructions and timing passes isn't free, so statistics are only gathered when asked for.
+    bool collects_statistics() const { return m_collects_statistics; }
+    void set_collects_statistics(bool collects_statistics) { m_collects_statistics = collects_statistics; }
+    void dump_statistics() const;
+
+private:
+    Vector<NonnullOwnPtr<Pass>> m_passes;
+    bool m_collects_statistics { false };
+    Threading::Mutex m_statistics_mutex;
+};
+
+// Rebuilds the instruction stream of a basic block, for passes that remove instructions or replace them with
+// instructions of a different size. Kept and replacement instructions keep the source record of the original.
+class BasicBlockRewriter {
+public:
+    explicit BasicBlockRewriter(BasicBlock& block)
+        : m_block(block)
+    {
+    }
+
+    void append(Instruction const&, Optional<SourceRecord>);
+    void append_from_block(BasicBlock const&, size_t offset);
+
+    template<typename OpType, typename... Args>
+    void emit(size_t replaced_offset, Args&&... args)
+    {
+        auto slot_offset = m_buffer.size();
+        m_buffer.resize(slot_offset + sizeof(OpType));
+        new (m_buffer.data() + slot_offset) OpType(forward<Args>(args)...);
+        did_append(slot_offset, m_block.source_map().get(replaced_offset));
+    }
+
+    void finish(bool is_terminated);
+    void finish() { finish(m_block.is_terminated()); }
+
+private:
+    void did_append(size_t offset, Optional<SourceRecord>);
+
+    BasicBlock& m_block;
+    Vector<u8> m_buffer;
+    HashMap<size_t, SourceRecord> m_source_map;
+    size_t m_last_instruction_start_offset { 0 };
+};
+
+size_t count_instructions(Generator&);
+
+// Counts how often each register and local is mentioned by an instruction. Constants are not counted.
+class OperandUseCounts {
+public:
+    explicit OperandUseCounts(Generator&);
+
+    size_t operator[](Operand operand) const { return m_counts.get(key(operand)).value_or(0); }
+    void decrement(Operand operand);
+
+    // Registers that the interpreter reads or writes implicitly, such as the accumulator, can't be reasoned about
+    // by looking at instructions alone.
+    static bool is_tracked(Operand operand) { return operand.is_local() || (operand.is_register() && operand.index() >= Register::reserved_register_count); }
+
+private:
+    static u64 key(Operand operand) { return (static_cast<u64>(operand.type()) << 32) | operand.index(); }
+
+    HashMap<u64, size_t> m_counts;
+};
+
+namespace Passes {
+
+// Evaluates arithmetic, comparisons and conditional jumps whose operands are all numeric, boolean or nullish constants.
+class ConstantFolding final : public Pass {
+public:
+    virtual StringView name() const override { return "constant-folding"sv; }
+    virtual void perform(Generator&) override;
+};
+
+// Replaces pairs of instructions with a single one that does the work of both, e.g. a comparison whose result is
+// only used by the following conditional jump with a fused compare-and-jump instruction.
+class FuseInstructions final : public Pass {
+public:
+    virtual StringView name() const override { return "fuse-instructions"sv; }
+    virtual void perform(Generator&) override;
+};
+
+// Removes moves and other side-effect free instructions whose destination register or local is never read.
+class DeadStoreElimination final : public Pass {
+public:
+    virtual StringView name() const override { return "dead-store-elimination"sv; }
+    virtual void perform(Generator&) override;
+};
+
+// Makes jumps to blocks that consist of nothing but another jump go straight to the final destination.
+class JumpThreading final : public Pass {
+public:
+    virtual StringView name() const override { return "jump-threading"sv; }
+    virtual void perform(Generator&) override;
+};
+
+// Removes unreachable blocks, and appends blocks that are only ever entered by a jump at the end of another block
+// to that block.
+class MergeBlocks final : public Pass {
+public:
+    virtual StringView name() const override { return "merge-blocks"sv; }
+    virtual void perform(Generator&) override;
+};
+
+}
+
+}
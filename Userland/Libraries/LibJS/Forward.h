@@ -315,6 +315,7 @@ class MarkedVector;
 
 namespace Bytecode {
 class BasicBlock;
+class BytecodeCache;
 enum class Builtin : u8;
 class Executable;
 class Generator;
@@ -323,6 +324,11 @@ class Interpreter;
 class Operand;
 class RegexTable;
 class Register;
+struct UnlinkedExecutable;
+}
+
+namespace JIT {
+class NativeExecutable;
 }
 
 }
@@ -15,6 +15,22 @@ void JS::Cell::initialize(JS::Realm&)
 {
 }
 
+void JS::Cell::write_barrier_slow(JS::Cell* cell)
+{
+    if (!cell)
+        return;
+    if (m_is_old && !m_is_remembered && !cell->is_old())
+        heap().remember_cell({}, *this);
+    if (m_mark && !cell->is_marked())
+        heap().did_store_unmarked_cell_into_marked_cell({}, *cell);
+}
+
+void JS::Cell::write_barrier(JS::Value value)
+{
+    if (value.is_cell())
+        write_barrier(&value.as_cell());
+}
+
 void JS::Cell::Visitor::visit(JS::Value value)
 {
     if (value.is_cell())
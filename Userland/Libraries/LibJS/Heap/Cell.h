@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/Format.h>
 #include <AK/Forward.h>
@@ -28,6 +29,13 @@ public:                                            \
     }                                              \
     friend class JS::Heap;
 
+// Cells whose every edge-creating store after construction goes through write_barrier() can say so with this.
+// Old cells of any other class are conservatively rescanned by every young generation collection.
+// NOTE: This only applies to exactly the class it's declared in, not to subclasses.
+#define JS_DECLARE_PRECISE_WRITE_BARRIERS(class_) \
+public:                                            \
+    using ClassWithPreciseWriteBarriers = class_
+
 class Cell : public Weakable<Cell> {
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
@@ -39,6 +47,14 @@ public:
     bool is_marked() const { return m_mark; }
     void set_marked(bool b) { m_mark = b; }
 
+    // Marks the cell and returns whether it wasn't marked already. Safe to race with other marking threads.
+    bool try_set_marked_atomically()
+    {
+        if (AK::atomic_load(&m_mark, AK::memory_order_relaxed))
+            return false;
+        return !AK::atomic_exchange(&m_mark, true, AK::memory_order_relaxed);
+    }
+
     enum class State : bool {
         Live,
         Dead,
@@ -47,8 +63,37 @@ public:
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    // When sweeping is deferred, unreachable cells are dead but keep their mark until they are destroyed.
+    bool is_awaiting_lazy_sweep() const { return m_state == State::Dead && m_mark; }
+    void did_become_unreachable(Badge<Heap>)
+    {
+        revoke_weak_ptrs();
+        m_state = State::Dead;
+        m_mark = true;
+    }
+
     virtual StringView class_name() const = 0;
 
+    // Old cells have survived at least one garbage collection.
+    bool is_old() const { return m_is_old; }
+    void set_old(Badge<Heap>, bool b) { m_is_old = b; }
+
+    bool is_remembered() const { return m_is_remembered; }
+    void set_remembered(Badge<Heap>, bool b) { m_is_remembered = b; }
+
+    bool has_precise_write_barriers() const { return m_has_precise_write_barriers; }
+    void set_has_precise_write_barriers(Badge<Heap>, bool b) { m_has_precise_write_barriers = b; }
+
+    // Must be called when a pointer to another cell is stored in this cell after construction,
+    // so the heap can keep track of old cells that point into the young generation,
+    // and of marked cells that point to unmarked ones while marking is in progress.
+    ALWAYS_INLINE void write_barrier(Cell* cell)
+    {
+        if ((m_is_old && !m_is_remembered) || m_mark) [[unlikely]]
+            write_barrier_slow(cell);
+    }
+    void write_barrier(Value);
+
     class Visitor {
     public:
         void visit(Cell* cell)
@@ -148,6 +193,8 @@ public:
         virtual ~Visitor() = default;
     };
 
+    // NOTE: Large heaps are marked by several threads at once (see Heap::set_parallel_marking_thread_count()), so this must
+    //       not change anything, nor copy anything reference counted, as reference counts aren't atomic.
     virtual void visit_edges(Visitor&) { }
 
     // This will be called on unmarked objects by the garbage collector in a separate pass before destruction.
@@ -169,9 +216,15 @@ protected:
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
 private:
-    bool m_mark : 1 { false };
+    void write_barrier_slow(Cell*);
+
+    // NOTE: The mark bit has a byte of its own so that parallel marking threads can set it atomically.
+    bool m_mark { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
     State m_state : 1 { State::Live };
+    bool m_is_old : 1 { false };
+    bool m_is_remembered : 1 { false };
+    bool m_has_precise_write_barriers : 1 { false };
 };
 
 }
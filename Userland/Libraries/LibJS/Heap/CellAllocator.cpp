@@ -5,6 +5,7 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/Time.h>
 #include <LibJS/Heap/BlockAllocator.h>
 #include <LibJS/Heap/CellAllocator.h>
 #include <LibJS/Heap/Heap.h>
@@ -23,6 +24,14 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     if (!m_list_node.is_in_list())
         heap.register_cell_allocator({}, *this);
 
+    if (m_usable_blocks.is_empty() && !m_blocks_pending_sweep.is_empty()) {
+        auto start = MonotonicTime::now();
+        do {
+            sweep_next_pending_block();
+        } while (m_usable_blocks.is_empty() && !m_blocks_pending_sweep.is_empty());
+        heap.did_sweep_lazily({}, MonotonicTime::now() - start);
+    }
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, *this, m_cell_size, m_class_name);
         auto block_ptr = reinterpret_cast<FlatPtr>(block.ptr());
@@ -30,6 +39,7 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
             m_min_block_address = block_ptr;
         if (m_max_block_address < block_ptr)
             m_max_block_address = block_ptr;
+        heap.did_create_heap_block({}, *block);
         m_usable_blocks.append(*block.leak_ptr());
     }
 
@@ -43,10 +53,7 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
 
 void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
 {
-    block.m_list_node.remove();
-    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
-    block.~HeapBlock();
-    m_block_allocator.deallocate_block(&block);
+    destroy_block(block);
 }
 
 void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
@@ -55,4 +62,35 @@ void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
     m_usable_blocks.append(block);
 }
 
+void CellAllocator::block_needs_lazy_sweep(Badge<Heap>, HeapBlock& block)
+{
+    m_blocks_pending_sweep.append(block);
+}
+
+void CellAllocator::sweep_all_pending_blocks(Badge<Heap>)
+{
+    while (!m_blocks_pending_sweep.is_empty())
+        sweep_next_pending_block();
+}
+
+void CellAllocator::sweep_next_pending_block()
+{
+    auto& block = *m_blocks_pending_sweep.first();
+    if (!block.sweep_cells_awaiting_lazy_sweep())
+        destroy_block(block);
+    else if (block.is_full())
+        m_full_blocks.append(block);
+    else
+        m_usable_blocks.append(block);
+}
+
+void CellAllocator::destroy_block(HeapBlock& block)
+{
+    block.m_list_node.remove();
+    block.heap().did_destroy_heap_block({}, block);
+    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
+    block.~HeapBlock();
+    m_block_allocator.deallocate_block(&block);
+}
+
 }
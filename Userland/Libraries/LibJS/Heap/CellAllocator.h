@@ -41,12 +41,21 @@ public:
             if (callback(block) == IterationDecision::Break)
                 return IterationDecision::Break;
         }
+        for (auto& block : m_blocks_pending_sweep) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
         return IterationDecision::Continue;
     }
 
     void block_did_become_empty(Badge<Heap>, HeapBlock&);
     void block_did_become_usable(Badge<Heap>, HeapBlock&);
 
+    // Blocks with cells awaiting lazy sweep are swept once we run out of other blocks to allocate from.
+    void block_needs_lazy_sweep(Badge<Heap>, HeapBlock&);
+    void sweep_all_pending_blocks(Badge<Heap>);
+    bool has_blocks_pending_sweep() const { return !m_blocks_pending_sweep.is_empty(); }
+
     IntrusiveListNode<CellAllocator> m_list_node;
     using List = IntrusiveList<&CellAllocator::m_list_node>;
 
@@ -55,6 +64,9 @@ public:
     FlatPtr max_block_address() const { return m_max_block_address; }
 
 private:
+    void sweep_next_pending_block();
+    void destroy_block(HeapBlock&);
+
     char const* const m_class_name { nullptr };
     size_t const m_cell_size;
 
@@ -63,6 +75,7 @@ private:
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+    BlockList m_blocks_pending_sweep;
     FlatPtr m_min_block_address { explode_byte(0xff) };
     FlatPtr m_max_block_address { 0 };
 };
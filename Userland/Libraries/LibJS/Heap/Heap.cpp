@@ -14,6 +14,7 @@
 #include <AK/StackInfo.h>
 #include <AK/TemporaryChange.h>
 #include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Heap/CellAllocator.h>
 #include <LibJS/Heap/Handle.h>
@@ -22,7 +23,11 @@
 #include <LibJS/Runtime/Object.h>
 #include <LibJS/Runtime/WeakContainer.h>
 #include <LibJS/SafeFunction.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
+#include <sched.h>
 #include <setjmp.h>
+#include <stdlib.h>
 
 #ifdef AK_OS_SERENITY
 #    include <serenity.h>
@@ -38,6 +43,8 @@ namespace JS {
 static int gc_perf_string_id;
 #endif
 
+static constexpr unsigned MAX_PARALLEL_MARKING_THREADS = 8;
+
 // NOTE: We keep a per-thread list of custom ranges. This hinges on the assumption that there is one JS VM per thread.
 static __thread HashMap<FlatPtr*, size_t>* s_custom_ranges_for_conservative_scan = nullptr;
 static __thread HashMap<FlatPtr*, SourceLocation*>* s_safe_function_locations = nullptr;
@@ -58,26 +65,95 @@ Heap::Heap(VM& vm)
     m_size_based_cell_allocators.append(make<CellAllocator>(512));
     m_size_based_cell_allocators.append(make<CellAllocator>(1024));
     m_size_based_cell_allocators.append(make<CellAllocator>(3072));
-}
 
-Heap::~Heap()
-{
-    vm().string_cache().clear();
-    vm().byte_string_cache().clear();
-    collect_garbage(CollectionType::CollectEverything);
+    m_generational = getenv("LIBJS_GENERATIONAL_GC") != nullptr;
+    m_incremental = getenv("LIBJS_INCREMENTAL_GC") != nullptr;
+
+    m_parallel_marking_thread_count = clamp(Core::System::hardware_concurrency(), 1u, MAX_PARALLEL_MARKING_THREADS);
+    // NOTE: An explicit thread count also makes even the smallest heaps get marked in parallel, which is mostly useful for testing.
+    if (auto const* thread_count = getenv("LIBJS_PARALLEL_GC_THREADS")) {
+        if (auto count = StringView { thread_count, strlen(thread_count) }.to_number<size_t>(); count.has_value()) {
+            set_parallel_marking_thread_count(*count);
+            m_parallel_marking_ignores_heap_size = true;
+        }
+    }
 }
 
 void Heap::will_allocate(size_t size)
 {
     if (should_collect_on_every_allocation()) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        // NOTE: In incremental mode, we take a marking step on every allocation instead, to give the write barrier a workout.
+        if (!m_incremental)
+            collect_garbage(m_generational ? CollectionType::CollectYoungGeneration : CollectionType::CollectGarbage);
+        else if (is_incremental_marking_in_progress())
+            perform_incremental_marking_step();
+        else
+            start_incremental_marking();
+    } else if (is_incremental_marking_in_progress()) {
+        if (m_allocated_bytes_since_last_marking_step + size > INCREMENTAL_MARKING_STEP_BYTES) {
+            m_allocated_bytes_since_last_marking_step = 0;
+            perform_incremental_marking_step();
+        }
+        m_allocated_bytes_since_last_marking_step += size;
     } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        if (m_incremental)
+            start_incremental_marking();
+        else
+            collect_garbage();
+    } else if (m_generational && m_allocated_bytes_since_last_young_gc + size > GC_YOUNG_GENERATION_BYTES_THRESHOLD) {
+        collect_garbage(CollectionType::CollectYoungGeneration);
     }
 
     m_allocated_bytes_since_last_gc += size;
+    m_allocated_bytes_since_last_young_gc += size;
+}
+
+void Heap::set_generational(bool generational)
+{
+    if (m_generational == generational)
+        return;
+    m_generational = generational;
+
+    // NOTE: Cells allocated so far are in neither generation, so sort them out with a full collection right away.
+    collect_garbage();
+}
+
+void Heap::set_incremental(bool incremental)
+{
+    if (m_incremental == incremental)
+        return;
+    if (is_incremental_marking_in_progress())
+        collect_garbage();
+    m_incremental = incremental;
+}
+
+void GCPauseHistogram::record(Duration pause)
+{
+    auto microseconds = pause.to_microseconds();
+    size_t bucket = 0;
+    while (bucket < s_bucket_limits_in_microseconds.size() && microseconds >= s_bucket_limits_in_microseconds[bucket])
+        ++bucket;
+    ++m_bucket_counts[bucket];
+    ++m_pause_count;
+    m_total_pause_time += pause;
+    m_longest_pause = max(m_longest_pause, pause);
+}
+
+void GCPauseHistogram::dump() const
+{
+    dbgln("Pause times since startup");
+    dbgln("=============================================");
+    dbgln("         Pauses: {} ({} ms in total)", m_pause_count, m_total_pause_time.to_milliseconds());
+    dbgln("  Longest pause: {} us", m_longest_pause.to_microseconds());
+    for (size_t i = 0; i < m_bucket_counts.size(); ++i) {
+        if (i < s_bucket_limits_in_microseconds.size())
+            dbgln("{:>10} us: {}", ByteString::formatted("< {}", s_bucket_limits_in_microseconds[i]), m_bucket_counts[i]);
+        else
+            dbgln("{:>10} us: {}", ByteString::formatted(">= {}", s_bucket_limits_in_microseconds.last()), m_bucket_counts[i]);
+    }
+    dbgln("=============================================");
 }
 
 static void add_possible_value(HashMap<FlatPtr, HeapRoot>& possible_pointers, FlatPtr data, HeapRoot origin, FlatPtr min_block_address, FlatPtr max_block_address)
@@ -135,10 +211,6 @@ public:
         : m_heap(heap)
     {
         m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
-        m_heap.for_each_block([&](auto& block) {
-            m_all_live_heap_blocks.set(&block);
-            return IterationDecision::Continue;
-        });
 
         for (auto& [root, root_origin] : roots) {
             auto& graph_node = m_graph.ensure(bit_cast<FlatPtr>(root));
@@ -168,7 +240,7 @@ public:
         for (size_t i = 0; i < (bytes.size() / sizeof(FlatPtr)); ++i)
             add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_min_block_address, m_max_block_address);
 
-        for_each_cell_among_possible_pointers(m_all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
+        for_each_cell_among_possible_pointers(m_heap.m_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
             if (m_node_being_visited)
                 m_node_being_visited->edges.set(reinterpret_cast<FlatPtr>(&cell));
 
@@ -245,7 +317,6 @@ private:
     HashMap<FlatPtr, GraphNode> m_graph;
 
     Heap& m_heap;
-    HashTable<HeapBlock*> m_all_live_heap_blocks;
     FlatPtr m_min_block_address;
     FlatPtr m_max_block_address;
 };
@@ -273,17 +344,46 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     if (print_report)
         collection_measurement_timer.start();
 
-    if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
-        }
+    // NOTE: Young generation collections would trample the mark bits of an incremental marking in progress.
+    if (collection_type == CollectionType::CollectYoungGeneration && (!m_generational || is_incremental_marking_in_progress()))
+        collection_type = CollectionType::CollectGarbage;
+
+    if (collection_type != CollectionType::CollectEverything && m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    auto pause_start = MonotonicTime::now();
+
+    if (collection_type != CollectionType::CollectEverything) {
+        sweep_all_pending_blocks();
         HashMap<Cell*, HeapRoot> roots;
         gather_roots(roots);
-        mark_live_cells(roots);
+        if (is_incremental_marking_in_progress())
+            finish_incremental_marking(roots);
+        else
+            mark_live_cells(roots, collection_type);
+    } else {
+        cancel_incremental_marking();
+        sweep_all_pending_blocks();
+    }
+
+    m_allocated_bytes_since_last_young_gc = 0;
+
+    if (collection_type == CollectionType::CollectYoungGeneration) {
+        finalize_unmarked_young_cells();
+        sweep_dead_young_cells(print_report, collection_measurement_timer);
+    } else {
+        finalize_unmarked_cells();
+        if (m_incremental && collection_type == CollectionType::CollectGarbage)
+            leave_dead_cells_for_lazy_sweep(print_report, collection_measurement_timer);
+        else
+            sweep_dead_cells(print_report, collection_measurement_timer);
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+
+    m_pause_time_histogram.record(MonotonicTime::now() - pause_start);
+    if (print_report)
+        m_pause_time_histogram.dump();
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -371,13 +471,7 @@ NO_SANITIZE_ADDRESS void Heap::gather_conservative_roots(HashMap<Cell*, HeapRoot
         }
     }
 
-    HashTable<HeapBlock*> all_live_heap_blocks;
-    for_each_block([&](auto& block) {
-        all_live_heap_blocks.set(&block);
-        return IterationDecision::Continue;
-    });
-
-    for_each_cell_among_possible_pointers(all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr possible_pointer) {
+    for_each_cell_among_possible_pointers(m_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr possible_pointer) {
         if (cell->state() == Cell::State::Live) {
             dbgln_if(HEAP_DEBUG, "  ?-> {}", (void const*)cell);
             roots.set(cell, *possible_pointers.get(possible_pointer));
@@ -387,16 +481,184 @@ NO_SANITIZE_ADDRESS void Heap::gather_conservative_roots(HashMap<Cell*, HeapRoot
     });
 }
 
+// The threads that help the collecting thread with marking stay around between collections, as starting them anew
+// every time would eat into what marking in parallel saves.
+class ParallelMarkingThreadPool : public Threading::ThreadPool<Function<void()>> {
+public:
+    explicit ParallelMarkingThreadPool(size_t thread_count)
+        : ThreadPool([](Function<void()> work) { work(); }, thread_count)
+    {
+    }
+};
+
+// Shares the traversal of the heap between several threads. Every thread marks from a stack of its own,
+// and hands the older half of it over to a shared overflow list whenever it grows large, for idle threads to take.
+class ParallelMarker {
+    AK_MAKE_NONCOPYABLE(ParallelMarker);
+    AK_MAKE_NONMOVABLE(ParallelMarker);
+
+public:
+    static constexpr size_t LOCAL_STACK_LIMIT = 1024;
+
+    ParallelMarker(HashTable<HeapBlock*> const& live_heap_blocks, bool only_mark_young_cells, FlatPtr min_block_address, FlatPtr max_block_address, size_t thread_count)
+        : m_live_heap_blocks(live_heap_blocks)
+        , m_only_mark_young_cells(only_mark_young_cells)
+        , m_min_block_address(min_block_address)
+        , m_max_block_address(max_block_address)
+        , m_thread_count(thread_count)
+    {
+    }
+
+    void mark_all_live_cells(Vector<NonnullGCPtr<Cell>> initial_work, ParallelMarkingThreadPool&);
+
+    HashTable<HeapBlock*> const& live_heap_blocks() const { return m_live_heap_blocks; }
+    bool only_mark_young_cells() const { return m_only_mark_young_cells; }
+    FlatPtr min_block_address() const { return m_min_block_address; }
+    FlatPtr max_block_address() const { return m_max_block_address; }
+
+    void donate_work(Vector<Cell*>&& work)
+    {
+        Threading::MutexLocker locker(m_overflow_mutex);
+        m_overflow.append(move(work));
+        m_overflow_size.store(m_overflow.size(), AK::memory_order_release);
+    }
+
+    // Refills the given (empty) stack, and returns false once every thread has run out of work.
+    bool wait_for_work(Vector<Cell*>& stack)
+    {
+        if (take_work(stack))
+            return true;
+
+        ++m_idle_thread_count;
+        while (true) {
+            if (m_overflow_size.load(AK::memory_order_acquire) > 0) {
+                --m_idle_thread_count;
+                if (take_work(stack))
+                    return true;
+                ++m_idle_thread_count;
+                continue;
+            }
+            // NOTE: Only threads with work of their own can donate any, so once they're all idle, nobody ever will again.
+            if (m_idle_thread_count.load() == m_thread_count)
+                return false;
+            sched_yield();
+        }
+    }
+
+private:
+    bool take_work(Vector<Cell*>& stack)
+    {
+        Threading::MutexLocker locker(m_overflow_mutex);
+        if (m_overflow.is_empty())
+            return false;
+        stack = m_overflow.take_last();
+        m_overflow_size.store(m_overflow.size(), AK::memory_order_release);
+        return true;
+    }
+
+    HashTable<HeapBlock*> const& m_live_heap_blocks;
+    bool m_only_mark_young_cells { false };
+    FlatPtr m_min_block_address { 0 };
+    FlatPtr m_max_block_address { 0 };
+    size_t m_thread_count { 0 };
+
+    Threading::Mutex m_overflow_mutex;
+    Vector<Vector<Cell*>> m_overflow;
+    Atomic<size_t> m_overflow_size { 0 };
+    Atomic<size_t> m_idle_thread_count { 0 };
+};
+
+class ParallelMarkingVisitor final : public Cell::Visitor {
+public:
+    explicit ParallelMarkingVisitor(ParallelMarker& marker)
+        : m_marker(marker)
+    {
+    }
+
+    virtual void visit_impl(Cell& cell) override
+    {
+        if (m_marker.only_mark_young_cells() && cell.is_old())
+            return;
+        if (!cell.try_set_marked_atomically())
+            return;
+        push(cell);
+    }
+
+    virtual void visit_possible_values(ReadonlyBytes bytes) override
+    {
+        HashMap<FlatPtr, HeapRoot> possible_pointers;
+
+        auto* raw_pointer_sized_values = reinterpret_cast<FlatPtr const*>(bytes.data());
+        for (size_t i = 0; i < (bytes.size() / sizeof(FlatPtr)); ++i)
+            add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_marker.min_block_address(), m_marker.max_block_address());
+
+        for_each_cell_among_possible_pointers(m_marker.live_heap_blocks(), possible_pointers, [&](Cell* cell, FlatPtr) {
+            if (cell->state() != Cell::State::Live)
+                return;
+            visit_impl(*cell);
+        });
+    }
+
+    void mark_all_live_cells()
+    {
+        do {
+            while (!m_stack.is_empty())
+                m_stack.take_last()->visit_edges(*this);
+        } while (m_marker.wait_for_work(m_stack));
+    }
+
+private:
+    void push(Cell& cell)
+    {
+        m_stack.append(&cell);
+        if (m_stack.size() < ParallelMarker::LOCAL_STACK_LIMIT)
+            return;
+
+        Vector<Cell*> work;
+        auto count = m_stack.size() / 2;
+        work.append(m_stack.data(), count);
+        m_stack.remove(0, count);
+        m_marker.donate_work(move(work));
+    }
+
+    ParallelMarker& m_marker;
+    Vector<Cell*> m_stack;
+};
+
+void ParallelMarker::mark_all_live_cells(Vector<NonnullGCPtr<Cell>> initial_work, ParallelMarkingThreadPool& thread_pool)
+{
+    for (size_t i = 0; i < initial_work.size(); i += LOCAL_STACK_LIMIT / 2) {
+        Vector<Cell*> work;
+        for (size_t j = i; j < min(i + LOCAL_STACK_LIMIT / 2, initial_work.size()); ++j)
+            work.append(initial_work[j].ptr());
+        donate_work(move(work));
+    }
+
+    Vector<NonnullOwnPtr<ParallelMarkingVisitor>> visitors;
+    for (size_t i = 0; i < m_thread_count; ++i)
+        visitors.append(make<ParallelMarkingVisitor>(*this));
+
+    // NOTE: The collecting thread does its share of the work as well.
+    for (size_t i = 1; i < m_thread_count; ++i)
+        thread_pool.submit([&visitor = *visitors[i]] { visitor.mark_all_live_cells(); });
+
+    visitors[0]->mark_all_live_cells();
+
+    thread_pool.wait_for_all();
+}
+
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
+    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots, Heap::CollectionType collection_type)
         : m_heap(heap)
+        , m_only_mark_young_cells(collection_type == Heap::CollectionType::CollectYoungGeneration)
+    {
+        visit_roots(roots);
+    }
+
+    void visit_roots(HashMap<Cell*, HeapRoot> const& roots)
     {
         m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
-        m_heap.for_each_block([&](auto& block) {
-            m_all_live_heap_blocks.set(&block);
-            return IterationDecision::Continue;
-        });
 
         for (auto* root : roots.keys()) {
             visit(root);
@@ -407,6 +669,8 @@ public:
     {
         if (cell.is_marked())
             return;
+        if (m_only_mark_young_cells && cell.is_old())
+            return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
@@ -421,11 +685,13 @@ public:
         for (size_t i = 0; i < (bytes.size() / sizeof(FlatPtr)); ++i)
             add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_min_block_address, m_max_block_address);
 
-        for_each_cell_among_possible_pointers(m_all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
+        for_each_cell_among_possible_pointers(m_heap.m_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
             if (cell->is_marked())
                 return;
             if (cell->state() != Cell::State::Live)
                 return;
+            if (m_only_mark_young_cells && cell->is_old())
+                return;
             cell->set_marked(true);
             m_work_queue.append(*cell);
         });
@@ -438,28 +704,199 @@ public:
         }
     }
 
+    // Traverses at most the given number of cells, and returns whether there's nothing left to traverse.
+    bool mark_some_live_cells(size_t max_cells)
+    {
+        // NOTE: New blocks may have been allocated since the last step.
+        m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
+
+        for (size_t i = 0; i < max_cells && !m_work_queue.is_empty(); ++i) {
+            auto cell = m_work_queue.take_last();
+            if (m_record_cells_to_rescan && !cell->has_precise_write_barriers())
+                m_heap.m_cells_to_rescan_when_marking_finishes.append(cell);
+            cell->visit_edges(*this);
+        }
+        return m_work_queue.is_empty();
+    }
+
+    void mark_all_live_cells_in_parallel(ParallelMarkingThreadPool& thread_pool, size_t thread_count)
+    {
+        ParallelMarker marker(m_heap.m_live_heap_blocks, m_only_mark_young_cells, m_min_block_address, m_max_block_address, thread_count);
+        marker.mark_all_live_cells(move(m_work_queue), thread_pool);
+    }
+
+    void stop_recording_cells_to_rescan() { m_record_cells_to_rescan = false; }
+
 private:
     Heap& m_heap;
+    bool m_only_mark_young_cells { false };
+    bool m_record_cells_to_rescan { true };
     Vector<NonnullGCPtr<Cell>> m_work_queue;
-    HashTable<HeapBlock*> m_all_live_heap_blocks;
     FlatPtr m_min_block_address;
     FlatPtr m_max_block_address;
 };
 
-void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
+Heap::~Heap()
+{
+    vm().string_cache().clear();
+    vm().byte_string_cache().clear();
+    collect_garbage(CollectionType::CollectEverything);
+}
+
+void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots, CollectionType collection_type)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor(*this, roots);
+    MarkingVisitor visitor(*this, roots, collection_type);
+
+    if (collection_type == CollectionType::CollectYoungGeneration) {
+        // NOTE: Old cells are not marked or traversed in a young generation collection, so the only way
+        //       to find young cells they point to is through the ones that may have been written to since.
+        for (auto& cell : m_remembered_cells)
+            cell->visit_edges(visitor);
+        for (auto& cell : m_old_cells_without_precise_write_barriers)
+            cell->visit_edges(visitor);
+    }
+
+    mark_all_live_cells(visitor, collection_type);
 
-    visitor.mark_all_live_cells();
+    unmark_uprooted_cells();
+}
 
+void Heap::mark_all_live_cells(MarkingVisitor& visitor, CollectionType collection_type)
+{
+    // NOTE: Young generation collections only traverse a small part of the heap, so they're not worth spreading over several threads.
+    bool should_mark_in_parallel = m_parallel_marking_thread_count > 1
+        && (m_parallel_marking_ignores_heap_size
+            || (collection_type != CollectionType::CollectYoungGeneration && m_live_heap_blocks.size() * HeapBlock::block_size >= PARALLEL_MARKING_HEAP_BYTES_THRESHOLD));
+
+    if (!should_mark_in_parallel) {
+        visitor.mark_all_live_cells();
+        return;
+    }
+
+    if (!m_parallel_marking_thread_pool)
+        m_parallel_marking_thread_pool = make<ParallelMarkingThreadPool>(m_parallel_marking_thread_count - 1);
+    visitor.mark_all_live_cells_in_parallel(*m_parallel_marking_thread_pool, m_parallel_marking_thread_count);
+}
+
+void Heap::set_parallel_marking_thread_count(size_t count)
+{
+    count = max<size_t>(count, 1);
+    if (m_parallel_marking_thread_count == count)
+        return;
+    m_parallel_marking_thread_count = count;
+    m_parallel_marking_thread_pool = nullptr;
+}
+
+void Heap::unmark_uprooted_cells()
+{
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
 
     m_uprooted_cells.clear();
 }
 
+void Heap::start_incremental_marking()
+{
+    VERIFY(!m_collecting_garbage);
+    VERIFY(!is_incremental_marking_in_progress());
+    TemporaryChange change(m_collecting_garbage, true);
+
+    auto pause_start = MonotonicTime::now();
+
+    sweep_all_pending_blocks();
+
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    m_incremental_marking_visitor = make<MarkingVisitor>(*this, roots, CollectionType::CollectGarbage);
+    m_incremental_marking_steps = 0;
+    m_allocated_bytes_since_last_marking_step = 0;
+
+    m_pause_time_histogram.record(MonotonicTime::now() - pause_start);
+}
+
+void Heap::perform_incremental_marking_step()
+{
+    VERIFY(is_incremental_marking_in_progress());
+
+    bool marking_is_done = false;
+    {
+        VERIFY(!m_collecting_garbage);
+        TemporaryChange change(m_collecting_garbage, true);
+
+        auto pause_start = MonotonicTime::now();
+        marking_is_done = m_incremental_marking_visitor->mark_some_live_cells(INCREMENTAL_MARKING_STEP_CELLS);
+        ++m_incremental_marking_steps;
+        m_pause_time_histogram.record(MonotonicTime::now() - pause_start);
+    }
+
+    // NOTE: The final step has to find whatever the mutator has hidden from us in the meantime, and then we can sweep.
+    if (marking_is_done)
+        collect_garbage();
+}
+
+void Heap::finish_incremental_marking(HashMap<Cell*, HeapRoot> const& roots)
+{
+    dbgln_if(HEAP_DEBUG, "finish_incremental_marking:");
+
+    auto& visitor = *m_incremental_marking_visitor;
+    visitor.stop_recording_cells_to_rescan();
+
+    // NOTE: Roots may have changed since marking started, and only cells with precise write barriers
+    //       tell us about stores into them, so every other cell we've traversed has to be traversed again.
+    visitor.visit_roots(roots);
+    for (auto& cell : m_cells_to_rescan_when_marking_finishes)
+        cell->visit_edges(visitor);
+    m_cells_to_rescan_when_marking_finishes.clear();
+
+    mark_all_live_cells(visitor, CollectionType::CollectGarbage);
+    m_incremental_marking_visitor = nullptr;
+
+    unmark_uprooted_cells();
+}
+
+void Heap::cancel_incremental_marking()
+{
+    if (!is_incremental_marking_in_progress())
+        return;
+
+    m_incremental_marking_visitor = nullptr;
+    m_cells_to_rescan_when_marking_finishes.clear();
+
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            cell->set_marked(false);
+        });
+        return IterationDecision::Continue;
+    });
+}
+
+void Heap::did_allocate_cell_during_incremental_marking(Cell& cell)
+{
+    // NOTE: New cells are live for the rest of this cycle, but they still have to be traversed.
+    m_incremental_marking_visitor->visit(&cell);
+}
+
+void Heap::did_store_unmarked_cell_into_marked_cell(Badge<Cell>, Cell& cell)
+{
+    if (is_incremental_marking_in_progress())
+        m_incremental_marking_visitor->visit(&cell);
+}
+
+void Heap::did_sweep_lazily(Badge<CellAllocator>, Duration pause)
+{
+    m_pause_time_histogram.record(pause);
+}
+
+void Heap::sweep_all_pending_blocks()
+{
+    for (auto& allocator : m_all_cell_allocators) {
+        if (allocator.has_blocks_pending_sweep())
+            allocator.sweep_all_pending_blocks({});
+    }
+}
+
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 {
     if (!cell.overrides_must_survive_garbage_collection({}))
@@ -478,6 +915,38 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
+void Heap::finalize_unmarked_young_cells()
+{
+    for (auto& cell : m_young_cells) {
+        if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
+            cell->finalize();
+    }
+}
+
+void Heap::promote_cell(Cell& cell)
+{
+    cell.set_old({}, true);
+
+    // NOTE: Cells that don't tell us about their writes have to be treated as permanently remembered.
+    if (cell.has_precise_write_barriers()) {
+        cell.set_remembered({}, false);
+    } else {
+        cell.set_remembered({}, true);
+        m_old_cells_without_precise_write_barriers.append(cell);
+    }
+}
+
+void Heap::cell_did_survive_full_collection(Cell& cell)
+{
+    cell.set_marked(false);
+    if (m_generational) {
+        promote_cell(cell);
+    } else if (cell.is_old()) {
+        cell.set_old({}, false);
+        cell.set_remembered({}, false);
+    }
+}
+
 void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
@@ -489,6 +958,10 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
 
+    m_young_cells.clear();
+    m_remembered_cells.clear();
+    m_old_cells_without_precise_write_barriers.clear();
+
     for_each_block([&](auto& block) {
         bool block_has_live_cells = false;
         bool block_was_full = block.is_full();
@@ -499,7 +972,7 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
                 ++collected_cells;
                 collected_cell_bytes += block.cell_size();
             } else {
-                cell->set_marked(false);
+                cell_did_survive_full_collection(*cell);
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
@@ -553,6 +1026,136 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     }
 }
 
+void Heap::leave_dead_cells_for_lazy_sweep(bool print_report, Core::ElapsedTimer const& measurement_timer)
+{
+    dbgln_if(HEAP_DEBUG, "leave_dead_cells_for_lazy_sweep:");
+    Vector<HeapBlock*, 32> blocks_with_dead_cells;
+
+    size_t dead_cells = 0;
+    size_t live_cells = 0;
+    size_t dead_cell_bytes = 0;
+    size_t live_cell_bytes = 0;
+
+    m_young_cells.clear();
+    m_remembered_cells.clear();
+    m_old_cells_without_precise_write_barriers.clear();
+
+    // NOTE: Destroying dead cells is left to their CellAllocator, but they must look dead to everyone right away.
+    for_each_block([&](auto& block) {
+        bool block_has_dead_cells = false;
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
+                dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+                cell->did_become_unreachable({});
+                block_has_dead_cells = true;
+                ++dead_cells;
+                dead_cell_bytes += block.cell_size();
+            } else {
+                cell_did_survive_full_collection(*cell);
+                ++live_cells;
+                live_cell_bytes += block.cell_size();
+            }
+        });
+        if (block_has_dead_cells)
+            blocks_with_dead_cells.append(&block);
+        return IterationDecision::Continue;
+    });
+
+    for (auto& weak_container : m_weak_containers)
+        weak_container.remove_dead_cells({});
+
+    for (auto* block : blocks_with_dead_cells)
+        block->cell_allocator().block_needs_lazy_sweep({}, *block);
+
+    m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+
+    if (print_report) {
+        Duration const time_spent = measurement_timer.elapsed_time();
+
+        dbgln("Garbage collection report");
+        dbgln("=============================================");
+        dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
+        dbgln("  Marking steps: {}", m_incremental_marking_steps);
+        dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
+        dbgln("     Dead cells: {} ({} bytes)", dead_cells, dead_cell_bytes);
+        dbgln(" Blocks to sweep: {} ({} bytes)", blocks_with_dead_cells.size(), blocks_with_dead_cells.size() * HeapBlock::block_size);
+        dbgln("=============================================");
+    }
+
+    m_incremental_marking_steps = 0;
+}
+
+void Heap::sweep_dead_young_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+{
+    dbgln_if(HEAP_DEBUG, "sweep_dead_young_cells:");
+
+    // NOTE: The value is whether the block was full before we started freeing cells in it.
+    HashMap<HeapBlock*, bool> blocks_with_collected_cells;
+
+    size_t collected_cells = 0;
+    size_t promoted_cells = 0;
+    size_t collected_cell_bytes = 0;
+    size_t promoted_cell_bytes = 0;
+    size_t remembered_cells = m_remembered_cells.size() + m_old_cells_without_precise_write_barriers.size();
+
+    for (auto& cell : m_young_cells) {
+        auto& block = *HeapBlock::from_cell(cell.ptr());
+        if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell.ptr());
+            blocks_with_collected_cells.ensure(&block, [&] { return block.is_full(); });
+            block.deallocate(cell.ptr());
+            ++collected_cells;
+            collected_cell_bytes += block.cell_size();
+        } else {
+            cell->set_marked(false);
+            promote_cell(*cell);
+            ++promoted_cells;
+            promoted_cell_bytes += block.cell_size();
+        }
+    }
+
+    m_young_cells.clear();
+
+    for (auto& cell : m_remembered_cells)
+        cell->set_remembered({}, false);
+    m_remembered_cells.clear();
+
+    for (auto& weak_container : m_weak_containers)
+        weak_container.remove_dead_cells({});
+
+    size_t freed_blocks = 0;
+    for (auto& [block, block_was_full] : blocks_with_collected_cells) {
+        bool block_has_live_cells = false;
+        block->for_each_cell_in_state<Cell::State::Live>([&](Cell*) {
+            block_has_live_cells = true;
+        });
+        if (!block_has_live_cells) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
+            block->cell_allocator().block_did_become_empty({}, *block);
+            ++freed_blocks;
+        } else if (block_was_full) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
+            block->cell_allocator().block_did_become_usable({}, *block);
+        }
+    }
+
+    // NOTE: Only cells that made it into the old generation count towards the next full collection.
+    m_allocated_bytes_since_last_gc -= min(m_allocated_bytes_since_last_gc, collected_cell_bytes);
+
+    if (print_report) {
+        Duration const time_spent = measurement_timer.elapsed_time();
+
+        dbgln("Young generation collection report");
+        dbgln("=============================================");
+        dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
+        dbgln("Remembered cells: {}", remembered_cells);
+        dbgln(" Promoted cells: {} ({} bytes)", promoted_cells, promoted_cell_bytes);
+        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+        dbgln("   Freed blocks: {} ({} bytes)", freed_blocks, freed_blocks * HeapBlock::block_size);
+        dbgln("=============================================");
+    }
+}
+
 void Heap::defer_gc()
 {
     ++m_gc_deferrals;
@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -28,6 +31,24 @@
 
 namespace JS {
 
+class MarkingVisitor;
+class ParallelMarkingThreadPool;
+
+// Buckets the pauses that garbage collection work imposes on the mutator, for the collection report.
+class GCPauseHistogram {
+public:
+    void record(Duration);
+    void dump() const;
+
+private:
+    static constexpr AK::Array<i64, 8> s_bucket_limits_in_microseconds { 100, 250, 500, 1'000, 2'500, 5'000, 10'000, 50'000 };
+
+    AK::Array<size_t, s_bucket_limits_in_microseconds.size() + 1> m_bucket_counts {};
+    size_t m_pause_count { 0 };
+    Duration m_total_pause_time;
+    Duration m_longest_pause;
+};
+
 class Heap : public HeapBase {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -42,6 +63,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        did_allocate_cell<T>(*static_cast<T*>(memory));
         undefer_gc();
         return *static_cast<T*>(memory);
     }
@@ -52,14 +74,16 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
-        undefer_gc();
         auto* cell = static_cast<T*>(memory);
+        did_allocate_cell<T>(*cell);
+        undefer_gc();
         memory->initialize(realm);
         return *cell;
     }
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGeneration,
         CollectEverything,
     };
 
@@ -69,6 +93,27 @@ public:
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
+    // In generational mode, cells that survive a collection are promoted to the old generation,
+    // and most collections only have to mark and sweep the cells allocated since the previous one.
+    bool is_generational() const { return m_generational; }
+    void set_generational(bool);
+
+    void remember_cell(Badge<Cell>, Cell&);
+
+    // In incremental mode, full collections mark the heap in small steps interleaved with allocation,
+    // and unreachable cells are only destroyed once their HeapBlock is needed for allocation again.
+    bool is_incremental() const { return m_incremental; }
+    void set_incremental(bool);
+    bool is_incremental_marking_in_progress() const { return m_incremental_marking_visitor; }
+
+    // Once the heap has grown past PARALLEL_MARKING_HEAP_BYTES_THRESHOLD, the final marking of a full
+    // collection is shared between this many threads. A count of 1 disables parallel marking.
+    size_t parallel_marking_thread_count() const { return m_parallel_marking_thread_count; }
+    void set_parallel_marking_thread_count(size_t);
+
+    void did_store_unmarked_cell_into_marked_cell(Badge<Cell>, Cell&);
+    void did_sweep_lazily(Badge<CellAllocator>, Duration);
+
     void did_create_handle(Badge<HandleImpl>, HandleImpl&);
     void did_destroy_handle(Badge<HandleImpl>, HandleImpl&);
 
@@ -86,6 +131,9 @@ public:
 
     void register_cell_allocator(Badge<CellAllocator>, CellAllocator&);
 
+    void did_create_heap_block(Badge<CellAllocator>, HeapBlock&);
+    void did_destroy_heap_block(Badge<CellAllocator>, HeapBlock&);
+
     void uproot_cell(Cell* cell);
 
 private:
@@ -116,9 +164,36 @@ private:
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
-    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
+    void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells, CollectionType);
+    void mark_all_live_cells(MarkingVisitor&, CollectionType);
+    void unmark_uprooted_cells();
     void finalize_unmarked_cells();
+    void finalize_unmarked_young_cells();
     void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void sweep_dead_young_cells(bool print_report, Core::ElapsedTimer const&);
+    void promote_cell(Cell&);
+    void cell_did_survive_full_collection(Cell&);
+
+    void start_incremental_marking();
+    void perform_incremental_marking_step();
+    void finish_incremental_marking(HashMap<Cell*, HeapRoot> const& roots);
+    void cancel_incremental_marking();
+    void did_allocate_cell_during_incremental_marking(Cell&);
+    void leave_dead_cells_for_lazy_sweep(bool print_report, Core::ElapsedTimer const&);
+    void sweep_all_pending_blocks();
+
+    template<typename T>
+    void did_allocate_cell(T& cell)
+    {
+        if constexpr (requires { typename T::ClassWithPreciseWriteBarriers; }) {
+            if constexpr (IsSame<typename T::ClassWithPreciseWriteBarriers, T>)
+                cell.set_has_precise_write_barriers({}, true);
+        }
+        if (m_generational)
+            m_young_cells.append(cell);
+        if (is_incremental_marking_in_progress()) [[unlikely]]
+            did_allocate_cell_during_incremental_marking(cell);
+    }
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -144,10 +219,35 @@ private:
     size_t m_gc_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
     size_t m_allocated_bytes_since_last_gc { 0 };
 
+    static constexpr size_t GC_YOUNG_GENERATION_BYTES_THRESHOLD { 1 * 1024 * 1024 };
+    size_t m_allocated_bytes_since_last_young_gc { 0 };
+
+    bool m_generational { false };
+    Vector<NonnullGCPtr<Cell>> m_young_cells;
+    Vector<NonnullGCPtr<Cell>> m_remembered_cells;
+    Vector<NonnullGCPtr<Cell>> m_old_cells_without_precise_write_barriers;
+
+    static constexpr size_t INCREMENTAL_MARKING_STEP_BYTES { 64 * 1024 };
+    static constexpr size_t INCREMENTAL_MARKING_STEP_CELLS { 4096 };
+    size_t m_allocated_bytes_since_last_marking_step { 0 };
+    size_t m_incremental_marking_steps { 0 };
+
+    bool m_incremental { false };
+    OwnPtr<MarkingVisitor> m_incremental_marking_visitor;
+    Vector<NonnullGCPtr<Cell>> m_cells_to_rescan_when_marking_finishes;
+
+    static constexpr size_t PARALLEL_MARKING_HEAP_BYTES_THRESHOLD { 32 * 1024 * 1024 };
+    size_t m_parallel_marking_thread_count { 1 };
+    bool m_parallel_marking_ignores_heap_size { false };
+    OwnPtr<ParallelMarkingThreadPool> m_parallel_marking_thread_pool;
+
+    GCPauseHistogram m_pause_time_histogram;
+
     bool m_should_collect_on_every_allocation { false };
 
     Vector<NonnullOwnPtr<CellAllocator>> m_size_based_cell_allocators;
     CellAllocator::List m_all_cell_allocators;
+    HashTable<HeapBlock*> m_live_heap_blocks;
 
     HandleImpl::List m_handles;
     MarkedVectorBase::List m_marked_vectors;
@@ -210,6 +310,23 @@ inline void Heap::did_destroy_weak_container(Badge<WeakContainer>, WeakContainer
     m_weak_containers.remove(set);
 }
 
+inline void Heap::remember_cell(Badge<Cell>, Cell& cell)
+{
+    VERIFY(cell.is_old());
+    cell.set_remembered({}, true);
+    m_remembered_cells.append(cell);
+}
+
+inline void Heap::did_create_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.set(&block);
+}
+
+inline void Heap::did_destroy_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.remove(&block);
+}
+
 inline void Heap::register_cell_allocator(Badge<CellAllocator>, CellAllocator& allocator)
 {
     m_all_cell_allocators.append(allocator);
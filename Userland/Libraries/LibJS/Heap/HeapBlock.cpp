@@ -5,6 +5,7 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Debug.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Platform.h>
 #include <LibJS/Heap/Heap.h>
@@ -67,4 +68,20 @@ void HeapBlock::deallocate(Cell* cell)
 #endif
 }
 
+bool HeapBlock::sweep_cells_awaiting_lazy_sweep()
+{
+    bool has_live_cells = false;
+    for_each_cell([&](Cell* cell) {
+        if (cell->state() == Cell::State::Live) {
+            has_live_cells = true;
+        } else if (cell->is_awaiting_lazy_sweep()) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+            cell->set_state(Cell::State::Live);
+            cell->set_marked(false);
+            deallocate(cell);
+        }
+    });
+    return has_live_cells;
+}
+
 }
@@ -50,6 +50,9 @@ public:
 
     void deallocate(Cell*);
 
+    // Destroys the cells that a collection left for lazy sweeping, and returns whether any live cells remain.
+    bool sweep_cells_awaiting_lazy_sweep();
+
     template<typename Callback>
     void for_each_cell(Callback callback)
     {
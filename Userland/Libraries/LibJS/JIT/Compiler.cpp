@@ -0,0 +1,746 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJIT/GDB.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+bool g_jit_enabled = getenv("LIBJS_JIT") != nullptr;
+
+bool Compiler::should_compile(Bytecode::Executable const& executable, u32 execution_count)
+{
+    if (!g_jit_enabled)
+        return false;
+
+    if (execution_count >= hotness_threshold)
+        return true;
+
+    // NOTE: Loops are where we spend our time, so don't wait around for executables containing them to warm up.
+    if (execution_count == 1) {
+        for (Bytecode::InstructionStreamIterator it(executable.bytecode); !it.at_end(); ++it) {
+            bool has_backward_jump = false;
+            const_cast<Bytecode::Instruction&>(*it).visit_labels([&](Bytecode::Label& label) {
+                if (label.address() <= it.offset())
+                    has_backward_jump = true;
+            });
+            if (has_backward_jump)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef JIT_ARCH_SUPPORTED
+
+// These ops require the interpreter's unwind machinery (scheduled jumps, exception handler lookup)
+// or suspend the running executable, so executables containing them are left to the interpreter.
+#    define JS_ENUMERATE_OPS_UNSUPPORTED_BY_JIT(O) \
+        O(Await)                                   \
+        O(Catch)                                   \
+        O(ContinuePendingUnwind)                   \
+        O(EnterUnwindContext)                      \
+        O(LeaveFinally)                            \
+        O(LeaveUnwindContext)                      \
+        O(PrepareYield)                            \
+        O(RestoreScheduledJump)                    \
+        O(ScheduleJump)                            \
+        O(Yield)
+
+// These ops are always executed by calling back into their interpreter implementation.
+#    define JS_ENUMERATE_OPS_COMPILED_AS_CALLS(O) \
+        O(AddPrivateName)                         \
+        O(ArrayAppend)                            \
+        O(AsyncIteratorClose)                     \
+        O(BitwiseAnd)                             \
+        O(BitwiseNot)                             \
+        O(BitwiseOr)                              \
+        O(BitwiseXor)                             \
+        O(BlockDeclarationInstantiation)          \
+        O(Call)                                   \
+        O(CallWithArgumentArray)                  \
+        O(ConcatString)                           \
+        O(CopyObjectExcludingProperties)          \
+        O(CreateArguments)                        \
+        O(CreateLexicalEnvironment)               \
+        O(CreatePrivateEnvironment)               \
+        O(CreateRestParams)                       \
+        O(CreateVariable)                         \
+        O(CreateVariableEnvironment)              \
+        O(DeleteById)                             \
+        O(DeleteByIdWithThis)                     \
+        O(DeleteByValue)                          \
+        O(DeleteByValueWithThis)                  \
+        O(DeleteVariable)                         \
+        O(Div)                                    \
+        O(Dump)                                   \
+        O(EnterObjectEnvironment)                 \
+        O(Exp)                                    \
+        O(GetById)                                \
+        O(GetByIdWithThis)                        \
+        O(GetByValue)                             \
+        O(GetByValueWithThis)                     \
+        O(GetCalleeAndThisFromEnvironment)        \
+        O(GetGlobal)                              \
+        O(GetImportMeta)                          \
+        O(GetIterator)                            \
+        O(GetLength)                              \
+        O(GetLengthWithThis)                      \
+        O(GetMethod)                              \
+        O(GetNewTarget)                           \
+        O(GetNextMethodFromIteratorRecord)        \
+        O(GetObjectFromIteratorRecord)            \
+        O(GetObjectPropertyIterator)              \
+        O(GetPrivateById)                         \
+        O(GetBinding)                             \
+        O(HasPrivateId)                           \
+        O(ImportCall)                             \
+        O(In)                                     \
+        O(InitializeLexicalBinding)               \
+        O(InitializeVariableBinding)              \
+        O(InstanceOf)                             \
+        O(IteratorClose)                          \
+        O(IteratorNext)                           \
+        O(IteratorToArray)                        \
+        O(LeaveLexicalEnvironment)                \
+        O(LeavePrivateEnvironment)                \
+        O(LeftShift)                              \
+        O(LooselyEquals)                          \
+        O(LooselyInequals)                        \
+        O(Mod)                                    \
+        O(Mul)                                    \
+        O(NewArray)                               \
+        O(NewClass)                               \
+        O(NewFunction)                            \
+        O(NewObject)                              \
+        O(NewPrimitiveArray)                      \
+        O(NewRegExp)                              \
+        O(NewTypeError)                           \
+        O(Not)                                    \
+        O(PutById)                                \
+        O(PutByIdWithThis)                        \
+        O(PutByValue)                             \
+        O(PutByValueWithThis)                     \
+        O(PutPrivateById)                         \
+        O(ResolveSuperBase)                       \
+        O(ResolveThisBinding)                     \
+        O(RightShift)                             \
+        O(SetLexicalBinding)                      \
+        O(SetVariableBinding)                     \
+        O(StrictlyEquals)                         \
+        O(StrictlyInequals)                       \
+        O(SuperCallWithArgumentArray)             \
+        O(Throw)                                  \
+        O(ThrowIfNotObject)                       \
+        O(ThrowIfNullish)                         \
+        O(ThrowIfTDZ)                             \
+        O(Typeof)                                 \
+        O(TypeofVariable)                         \
+        O(UnaryMinus)                             \
+        O(UnaryPlus)                              \
+        O(UnsignedRightShift)
+
+// Slow cases return this to signal that an exception has been stored in the exception register.
+static constexpr u64 exception_sentinel = 2;
+
+template<typename OpType>
+static u64 cxx_execute(Bytecode::Interpreter& interpreter, Bytecode::Instruction const& instruction)
+{
+    auto const& op = static_cast<OpType const&>(instruction);
+    if constexpr (IsSame<decltype(op.execute_impl(interpreter)), void>) {
+        op.execute_impl(interpreter);
+        return 0;
+    } else {
+        auto result = op.execute_impl(interpreter);
+        if (result.is_error()) {
+            interpreter.reg(Bytecode::Register::exception()) = result.error_value();
+            return exception_sentinel;
+        }
+        return 0;
+    }
+}
+
+template<typename OpType>
+static ThrowCompletionOr<bool> evaluate_comparison(VM& vm, Value lhs, Value rhs)
+{
+    if constexpr (IsSame<OpType, Bytecode::Op::JumpLessThan>)
+        return TRY(less_than(vm, lhs, rhs)).as_bool();
+    else if constexpr (IsSame<OpType, Bytecode::Op::JumpLessThanEquals>)
+        return TRY(less_than_equals(vm, lhs, rhs)).as_bool();
+    else if constexpr (IsSame<OpType, Bytecode::Op::JumpGreaterThan>)
+        return TRY(greater_than(vm, lhs, rhs)).as_bool();
+    else if constexpr (IsSame<OpType, Bytecode::Op::JumpGreaterThanEquals>)
+        return TRY(greater_than_equals(vm, lhs, rhs)).as_bool();
+    else if constexpr (IsSame<OpType, Bytecode::Op::JumpLooselyEquals>)
+        return TRY(is_loosely_equal(vm, lhs, rhs));
+    else if constexpr (IsSame<OpType, Bytecode::Op::JumpLooselyInequals>)
+        return !TRY(is_loosely_equal(vm, lhs, rhs));
+    else if constexpr (IsSame<OpType, Bytecode::Op::JumpStrictlyEquals>)
+        return is_strictly_equal(lhs, rhs);
+    else if constexpr (IsSame<OpType, Bytecode::Op::JumpStrictlyInequals>)
+        return !is_strictly_equal(lhs, rhs);
+    else
+        static_assert(DependentFalse<OpType>);
+}
+
+template<typename OpType>
+static u64 cxx_comparison_jump(Bytecode::Interpreter& interpreter, Bytecode::Instruction const& instruction)
+{
+    auto const& op = static_cast<OpType const&>(instruction);
+    auto result = evaluate_comparison<OpType>(interpreter.vm(), interpreter.get(op.lhs()), interpreter.get(op.rhs()));
+    if (result.is_error()) {
+        interpreter.reg(Bytecode::Register::exception()) = result.error_value();
+        return exception_sentinel;
+    }
+    return result.value() ? 1 : 0;
+}
+
+static u64 cxx_to_boolean(u64 encoded_value)
+{
+    return bit_cast<Value>(encoded_value).to_boolean() ? 1 : 0;
+}
+
+void Compiler::load_operand(Assembler::Reg dst, Bytecode::Operand operand)
+{
+    m_assembler.mov(
+        Assembler::Operand::Register(dst),
+        Assembler::Operand::Mem64BaseAndOffset(REGISTERS_BASE, operand.index() * sizeof(Value)));
+}
+
+void Compiler::store_operand(Bytecode::Operand operand, Assembler::Reg src)
+{
+    m_assembler.mov(
+        Assembler::Operand::Mem64BaseAndOffset(REGISTERS_BASE, operand.index() * sizeof(Value)),
+        Assembler::Operand::Register(src));
+}
+
+void Compiler::branch_if_not_int32(Assembler::Reg reg, Assembler::Label& label)
+{
+    m_assembler.mov(Assembler::Operand::Register(TAG_SCRATCH), Assembler::Operand::Register(reg));
+    m_assembler.shift_right(Assembler::Operand::Register(TAG_SCRATCH), Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(TAG_SCRATCH),
+        Assembler::Condition::NotEqualTo,
+        Assembler::Operand::Imm(INT32_TAG),
+        label);
+}
+
+// NOTE: Both of these expect the upper 32 bits of `reg` to be zero.
+void Compiler::box_int32(Assembler::Reg reg)
+{
+    m_assembler.mov(Assembler::Operand::Register(TAG_SCRATCH), Assembler::Operand::Imm(SHIFTED_INT32_TAG));
+    m_assembler.bitwise_or(Assembler::Operand::Register(reg), Assembler::Operand::Register(TAG_SCRATCH));
+}
+
+void Compiler::box_boolean(Assembler::Reg reg)
+{
+    m_assembler.mov(Assembler::Operand::Register(TAG_SCRATCH), Assembler::Operand::Imm(SHIFTED_BOOLEAN_TAG));
+    m_assembler.bitwise_or(Assembler::Operand::Register(reg), Assembler::Operand::Register(TAG_SCRATCH));
+}
+
+Compiler::Assembler::Label& Compiler::label_for(Bytecode::Label label)
+{
+    auto it = m_block_labels.find(label.address());
+    VERIFY(it != m_block_labels.end());
+    return it->value;
+}
+
+void Compiler::call_slow_case(u64 (*slow_case)(Bytecode::Interpreter&, Bytecode::Instruction const&))
+{
+    // Keep the interpreter's program counter in sync so that stack traces and source ranges work as usual.
+    m_assembler.mov(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(m_current_offset));
+    m_assembler.mov(Assembler::Operand::Mem64BaseAndOffset(PROGRAM_COUNTER, 0), Assembler::Operand::Register(GPR0));
+
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(INTERPRETER_BASE));
+    m_assembler.mov(Assembler::Operand::Register(ARG1), Assembler::Operand::Imm(bit_cast<FlatPtr>(m_current_instruction)));
+    m_assembler.native_call(bit_cast<FlatPtr>(slow_case));
+}
+
+void Compiler::call_slow_case_and_exit_on_exception(u64 (*slow_case)(Bytecode::Interpreter&, Bytecode::Instruction const&))
+{
+    call_slow_case(slow_case);
+    m_assembler.jump_if(
+        Assembler::Operand::Register(RETURN_VALUE),
+        Assembler::Condition::EqualTo,
+        Assembler::Operand::Imm(exception_sentinel),
+        m_exit_label);
+}
+
+template<typename OpType>
+void Compiler::compile_generic()
+{
+    call_slow_case_and_exit_on_exception(cxx_execute<OpType>);
+}
+
+void Compiler::compile_get_argument(Bytecode::Op::GetArgument const& op)
+{
+    m_assembler.mov(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Operand::Mem64BaseAndOffset(ARGUMENTS_BASE, op.index() * sizeof(Value)));
+    store_operand(op.dst(), GPR0);
+}
+
+void Compiler::compile_set_argument(Bytecode::Op::SetArgument const& op)
+{
+    load_operand(GPR0, op.src());
+    m_assembler.mov(
+        Assembler::Operand::Mem64BaseAndOffset(ARGUMENTS_BASE, op.index() * sizeof(Value)),
+        Assembler::Operand::Register(GPR0));
+}
+
+void Compiler::compile_mov(Bytecode::Op::Mov const& op)
+{
+    if (op.dst() == op.src())
+        return;
+    load_operand(GPR0, op.src());
+    store_operand(op.dst(), GPR0);
+}
+
+void Compiler::compile_end(Bytecode::Op::End const& op)
+{
+    load_operand(GPR0, op.value());
+    store_operand(Bytecode::Operand(Bytecode::Register::accumulator()), GPR0);
+    m_assembler.jump(m_exit_label);
+}
+
+void Compiler::compile_jump(Bytecode::Op::Jump const& op)
+{
+    m_assembler.jump(label_for(op.target()));
+}
+
+void Compiler::compile_jump_if(Bytecode::Operand condition, Optional<Bytecode::Label> true_target, Optional<Bytecode::Label> false_target)
+{
+    load_operand(GPR0, condition);
+
+    Assembler::Label not_boolean;
+    Assembler::Label slow_case;
+    Assembler::Label have_result;
+
+    // GPR0 = tag == BOOLEAN_TAG ? value & 1 : ...
+    m_assembler.mov(Assembler::Operand::Register(TAG_SCRATCH), Assembler::Operand::Register(GPR0));
+    m_assembler.shift_right(Assembler::Operand::Register(TAG_SCRATCH), Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(TAG_SCRATCH),
+        Assembler::Condition::NotEqualTo,
+        Assembler::Operand::Imm(BOOLEAN_TAG),
+        not_boolean);
+    m_assembler.bitwise_and(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(1));
+    m_assembler.jump(have_result);
+
+    // ... tag == INT32_TAG ? value & 0xffffffff : ...
+    not_boolean.link(m_assembler);
+    m_assembler.jump_if(
+        Assembler::Operand::Register(TAG_SCRATCH),
+        Assembler::Condition::NotEqualTo,
+        Assembler::Operand::Imm(INT32_TAG),
+        slow_case);
+    m_assembler.mov32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR0));
+    m_assembler.jump(have_result);
+
+    // ... to_boolean(value)
+    slow_case.link(m_assembler);
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(GPR0));
+    m_assembler.native_call(bit_cast<FlatPtr>(&cxx_to_boolean));
+
+    have_result.link(m_assembler);
+    if (true_target.has_value()) {
+        m_assembler.jump_if(
+            Assembler::Operand::Register(GPR0),
+            Assembler::Condition::NotEqualTo,
+            Assembler::Operand::Imm(0),
+            label_for(*true_target));
+        if (false_target.has_value())
+            m_assembler.jump(label_for(*false_target));
+        return;
+    }
+
+    VERIFY(false_target.has_value());
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Condition::EqualTo,
+        Assembler::Operand::Imm(0),
+        label_for(*false_target));
+}
+
+void Compiler::compile_jump_nullish(Bytecode::Op::JumpNullish const& op)
+{
+    load_operand(GPR0, op.condition());
+    m_assembler.shift_right(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.bitwise_and(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(IS_NULLISH_EXTRACT_PATTERN));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Condition::EqualTo,
+        Assembler::Operand::Imm(IS_NULLISH_PATTERN),
+        label_for(op.true_target()));
+    m_assembler.jump(label_for(op.false_target()));
+}
+
+void Compiler::compile_jump_undefined(Bytecode::Op::JumpUndefined const& op)
+{
+    load_operand(GPR0, op.condition());
+    m_assembler.shift_right(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(TAG_SHIFT));
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Condition::EqualTo,
+        Assembler::Operand::Imm(UNDEFINED_TAG),
+        label_for(op.true_target()));
+    m_assembler.jump(label_for(op.false_target()));
+}
+
+void Compiler::compile_increment(Bytecode::Op::Increment const& op)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, op.dst());
+    branch_if_not_int32(GPR0, slow_case);
+    m_assembler.inc32(Assembler::Operand::Register(GPR0), slow_case);
+    box_int32(GPR0);
+    store_operand(op.dst(), GPR0);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_generic<Bytecode::Op::Increment>();
+    done.link(m_assembler);
+}
+
+void Compiler::compile_decrement(Bytecode::Op::Decrement const& op)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, op.dst());
+    branch_if_not_int32(GPR0, slow_case);
+    m_assembler.dec32(Assembler::Operand::Register(GPR0), slow_case);
+    box_int32(GPR0);
+    store_operand(op.dst(), GPR0);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_generic<Bytecode::Op::Decrement>();
+    done.link(m_assembler);
+}
+
+void Compiler::compile_postfix_increment(Bytecode::Op::PostfixIncrement const& op)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, op.src());
+    branch_if_not_int32(GPR0, slow_case);
+    m_assembler.mov(Assembler::Operand::Register(GPR1), Assembler::Operand::Register(GPR0));
+    m_assembler.inc32(Assembler::Operand::Register(GPR1), slow_case);
+    box_int32(GPR1);
+    store_operand(op.dst(), GPR0);
+    store_operand(op.src(), GPR1);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_generic<Bytecode::Op::PostfixIncrement>();
+    done.link(m_assembler);
+}
+
+void Compiler::compile_postfix_decrement(Bytecode::Op::PostfixDecrement const& op)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, op.src());
+    branch_if_not_int32(GPR0, slow_case);
+    m_assembler.mov(Assembler::Operand::Register(GPR1), Assembler::Operand::Register(GPR0));
+    m_assembler.dec32(Assembler::Operand::Register(GPR1), slow_case);
+    box_int32(GPR1);
+    store_operand(op.dst(), GPR0);
+    store_operand(op.src(), GPR1);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_generic<Bytecode::Op::PostfixDecrement>();
+    done.link(m_assembler);
+}
+
+void Compiler::compile_add(Bytecode::Op::Add const& op)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, op.lhs());
+    branch_if_not_int32(GPR0, slow_case);
+    load_operand(GPR1, op.rhs());
+    branch_if_not_int32(GPR1, slow_case);
+    m_assembler.add32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), slow_case);
+    box_int32(GPR0);
+    store_operand(op.dst(), GPR0);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_generic<Bytecode::Op::Add>();
+    done.link(m_assembler);
+}
+
+void Compiler::compile_sub(Bytecode::Op::Sub const& op)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, op.lhs());
+    branch_if_not_int32(GPR0, slow_case);
+    load_operand(GPR1, op.rhs());
+    branch_if_not_int32(GPR1, slow_case);
+    m_assembler.sub32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), slow_case);
+    box_int32(GPR0);
+    store_operand(op.dst(), GPR0);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_generic<Bytecode::Op::Sub>();
+    done.link(m_assembler);
+}
+
+template<typename OpType>
+void Compiler::compile_comparison(OpType const& op, Assembler::Condition condition)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_operand(GPR0, op.lhs());
+    branch_if_not_int32(GPR0, slow_case);
+    load_operand(GPR1, op.rhs());
+    branch_if_not_int32(GPR1, slow_case);
+
+    m_assembler.sign_extend_32_to_64_bits(GPR0);
+    m_assembler.sign_extend_32_to_64_bits(GPR1);
+    // NOTE: Clear the result register before comparing, as zeroing it afterwards would clobber the flags.
+    m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(0));
+    m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.set_if(condition, Assembler::Operand::Register(GPR2));
+    box_boolean(GPR2);
+    store_operand(op.dst(), GPR2);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_generic<OpType>();
+    done.link(m_assembler);
+}
+
+template<typename OpType>
+void Compiler::compile_comparison_jump(OpType const& op, Assembler::Condition condition, u64 (*slow_case_function)(Bytecode::Interpreter&, Bytecode::Instruction const&))
+{
+    Assembler::Label slow_case;
+
+    load_operand(GPR0, op.lhs());
+    branch_if_not_int32(GPR0, slow_case);
+    load_operand(GPR1, op.rhs());
+    branch_if_not_int32(GPR1, slow_case);
+
+    m_assembler.sign_extend_32_to_64_bits(GPR0);
+    m_assembler.sign_extend_32_to_64_bits(GPR1);
+    m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.jump_if(condition, label_for(op.true_target()));
+    m_assembler.jump(label_for(op.false_target()));
+
+    slow_case.link(m_assembler);
+    call_slow_case_and_exit_on_exception(slow_case_function);
+    m_assembler.jump_if(
+        Assembler::Operand::Register(RETURN_VALUE),
+        Assembler::Condition::NotEqualTo,
+        Assembler::Operand::Imm(0),
+        label_for(op.true_target()));
+    m_assembler.jump(label_for(op.false_target()));
+}
+
+bool Compiler::compile_instruction(Bytecode::Instruction const& instruction)
+{
+    using Bytecode::Instruction;
+    namespace Op = Bytecode::Op;
+    using Condition = Assembler::Condition;
+
+    switch (instruction.type()) {
+    case Instruction::Type::GetArgument:
+        compile_get_argument(static_cast<Op::GetArgument const&>(instruction));
+        break;
+    case Instruction::Type::SetArgument:
+        compile_set_argument(static_cast<Op::SetArgument const&>(instruction));
+        break;
+    case Instruction::Type::Mov:
+        compile_mov(static_cast<Op::Mov const&>(instruction));
+        break;
+    case Instruction::Type::End:
+        compile_end(static_cast<Op::End const&>(instruction));
+        break;
+    case Instruction::Type::Jump:
+        compile_jump(static_cast<Op::Jump const&>(instruction));
+        break;
+    case Instruction::Type::JumpIf: {
+        auto const& op = static_cast<Op::JumpIf const&>(instruction);
+        compile_jump_if(op.condition(), op.true_target(), op.false_target());
+        break;
+    }
+    case Instruction::Type::JumpTrue: {
+        auto const& op = static_cast<Op::JumpTrue const&>(instruction);
+        compile_jump_if(op.condition(), op.target(), {});
+        break;
+    }
+    case Instruction::Type::JumpFalse: {
+        auto const& op = static_cast<Op::JumpFalse const&>(instruction);
+        compile_jump_if(op.condition(), {}, op.target());
+        break;
+    }
+    case Instruction::Type::JumpNullish:
+        compile_jump_nullish(static_cast<Op::JumpNullish const&>(instruction));
+        break;
+    case Instruction::Type::JumpUndefined:
+        compile_jump_undefined(static_cast<Op::JumpUndefined const&>(instruction));
+        break;
+    case Instruction::Type::Increment:
+        compile_increment(static_cast<Op::Increment const&>(instruction));
+        break;
+    case Instruction::Type::Decrement:
+        compile_decrement(static_cast<Op::Decrement const&>(instruction));
+        break;
+    case Instruction::Type::PostfixIncrement:
+        compile_postfix_increment(static_cast<Op::PostfixIncrement const&>(instruction));
+        break;
+    case Instruction::Type::PostfixDecrement:
+        compile_postfix_decrement(static_cast<Op::PostfixDecrement const&>(instruction));
+        break;
+    case Instruction::Type::Add:
+        compile_add(static_cast<Op::Add const&>(instruction));
+        break;
+    case Instruction::Type::Sub:
+        compile_sub(static_cast<Op::Sub const&>(instruction));
+        break;
+    case Instruction::Type::LessThan:
+        compile_comparison(static_cast<Op::LessThan const&>(instruction), Condition::SignedLessThan);
+        break;
+    case Instruction::Type::LessThanEquals:
+        compile_comparison(static_cast<Op::LessThanEquals const&>(instruction), Condition::SignedLessThanOrEqualTo);
+        break;
+    case Instruction::Type::GreaterThan:
+        compile_comparison(static_cast<Op::GreaterThan const&>(instruction), Condition::SignedGreaterThan);
+        break;
+    case Instruction::Type::GreaterThanEquals:
+        compile_comparison(static_cast<Op::GreaterThanEquals const&>(instruction), Condition::SignedGreaterThanOrEqualTo);
+        break;
+    case Instruction::Type::Return:
+        compile_generic<Op::Return>();
+        m_assembler.jump(m_exit_label);
+        break;
+
+#    define DO_COMPILE_COMPARISON_JUMP(op_TitleCase, condition)                                                                          \
+    case Instruction::Type::Jump##op_TitleCase:                                                                                        \
+        compile_comparison_jump(static_cast<Op::Jump##op_TitleCase const&>(instruction), condition, cxx_comparison_jump<Op::Jump##op_TitleCase>); \
+        break;
+
+        DO_COMPILE_COMPARISON_JUMP(LessThan, Condition::SignedLessThan)
+        DO_COMPILE_COMPARISON_JUMP(LessThanEquals, Condition::SignedLessThanOrEqualTo)
+        DO_COMPILE_COMPARISON_JUMP(GreaterThan, Condition::SignedGreaterThan)
+        DO_COMPILE_COMPARISON_JUMP(GreaterThanEquals, Condition::SignedGreaterThanOrEqualTo)
+        DO_COMPILE_COMPARISON_JUMP(LooselyEquals, Condition::EqualTo)
+        DO_COMPILE_COMPARISON_JUMP(LooselyInequals, Condition::NotEqualTo)
+        DO_COMPILE_COMPARISON_JUMP(StrictlyEquals, Condition::EqualTo)
+        DO_COMPILE_COMPARISON_JUMP(StrictlyInequals, Condition::NotEqualTo)
+#    undef DO_COMPILE_COMPARISON_JUMP
+
+#    define DO_COMPILE_AS_CALL(OpTitleCase)      \
+    case Instruction::Type::OpTitleCase:        \
+        compile_generic<Op::OpTitleCase>();     \
+        break;
+
+        JS_ENUMERATE_OPS_COMPILED_AS_CALLS(DO_COMPILE_AS_CALL)
+#    undef DO_COMPILE_AS_CALL
+
+#    define DO_REJECT(OpTitleCase)        \
+    case Instruction::Type::OpTitleCase: \
+        return false;
+
+        JS_ENUMERATE_OPS_UNSUPPORTED_BY_JIT(DO_REJECT)
+#    undef DO_REJECT
+    }
+
+    return true;
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable& bytecode_executable)
+{
+    // NOTE: Exception handlers are entered by rewinding the interpreter's program counter,
+    //       which we have no way of doing in native code.
+    if (!bytecode_executable.exception_handlers.is_empty())
+        return nullptr;
+
+    Compiler compiler { bytecode_executable };
+
+    for (Bytecode::InstructionStreamIterator it(bytecode_executable.bytecode); !it.at_end(); ++it) {
+        const_cast<Bytecode::Instruction&>(*it).visit_labels([&](Bytecode::Label& label) {
+            if (!compiler.m_block_labels.contains(label.address()))
+                compiler.m_block_labels.set(label.address(), {});
+        });
+    }
+
+    auto& assembler = compiler.m_assembler;
+
+    // void native_code(Interpreter*, Value* registers_and_constants_and_locals, Value* arguments, size_t* program_counter)
+    assembler.enter();
+    assembler.mov(Assembler::Operand::Register(INTERPRETER_BASE), Assembler::Operand::Register(ARG0));
+    assembler.mov(Assembler::Operand::Register(REGISTERS_BASE), Assembler::Operand::Register(ARG1));
+    assembler.mov(Assembler::Operand::Register(ARGUMENTS_BASE), Assembler::Operand::Register(ARG2));
+    assembler.mov(Assembler::Operand::Register(PROGRAM_COUNTER), Assembler::Operand::Register(ARG3));
+
+    for (Bytecode::InstructionStreamIterator it(bytecode_executable.bytecode); !it.at_end(); ++it) {
+        compiler.m_current_instruction = &*it;
+        compiler.m_current_offset = it.offset();
+
+        if (auto label = compiler.m_block_labels.find(it.offset()); label != compiler.m_block_labels.end())
+            label->value.link(assembler);
+
+        if (!compiler.compile_instruction(*it)) {
+            dbgln_if(JS_JIT_DEBUG, "JIT: Giving up on {} at [{:4x}] {}", bytecode_executable.name, it.offset(), (*it).to_byte_string(bytecode_executable));
+            return nullptr;
+        }
+    }
+
+    compiler.m_exit_label.link(assembler);
+    assembler.exit();
+
+    auto& output = compiler.m_output;
+    auto* code = mmap(nullptr, output.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        perror("JIT: mmap");
+        return nullptr;
+    }
+    memcpy(code, output.data(), output.size());
+    if (mprotect(code, output.size(), PROT_READ | PROT_EXEC) < 0) {
+        perror("JIT: mprotect");
+        munmap(code, output.size());
+        return nullptr;
+    }
+
+    dbgln_if(JS_JIT_DEBUG, "JIT: Compiled {} ({} bytes of bytecode -> {} bytes of machine code)", bytecode_executable.name, bytecode_executable.bytecode.size(), output.size());
+
+    auto code_name = bytecode_executable.name.is_empty() ? "(anonymous)"sv : bytecode_executable.name.view();
+    auto gdb_object = ::JIT::GDB::build_gdb_image({ static_cast<u8 const*>(code), output.size() }, "LibJS JIT"sv, code_name);
+
+    return make<NativeExecutable>(code, output.size(), move(gdb_object));
+}
+
+#else
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable&)
+{
+    return nullptr;
+}
+
+#endif
+
+}
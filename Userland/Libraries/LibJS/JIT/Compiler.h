@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <LibJIT/Assembler.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+extern bool g_jit_enabled;
+
+class Compiler {
+public:
+    // Executables are compiled once they have been entered this many times,
+    // or on first entry if they contain a loop.
+    static constexpr u32 hotness_threshold = 10;
+
+    static bool should_compile(Bytecode::Executable const&, u32 execution_count);
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable&);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+
+    static constexpr auto GPR0 = Assembler::Reg::RAX;
+    static constexpr auto GPR1 = Assembler::Reg::RDX;
+    static constexpr auto GPR2 = Assembler::Reg::RCX;
+    static constexpr auto TAG_SCRATCH = Assembler::Reg::R11;
+    static constexpr auto ARG0 = Assembler::Reg::RDI;
+    static constexpr auto ARG1 = Assembler::Reg::RSI;
+    static constexpr auto ARG2 = Assembler::Reg::RDX;
+    static constexpr auto ARG3 = Assembler::Reg::RCX;
+    static constexpr auto RETURN_VALUE = Assembler::Reg::RAX;
+    static constexpr auto INTERPRETER_BASE = Assembler::Reg::R12;
+    static constexpr auto REGISTERS_BASE = Assembler::Reg::RBX;
+    static constexpr auto ARGUMENTS_BASE = Assembler::Reg::R14;
+    static constexpr auto PROGRAM_COUNTER = Assembler::Reg::R15;
+
+    explicit Compiler(Bytecode::Executable& executable)
+        : m_executable(executable)
+    {
+    }
+
+    bool compile_instruction(Bytecode::Instruction const&);
+
+    void compile_get_argument(Bytecode::Op::GetArgument const&);
+    void compile_set_argument(Bytecode::Op::SetArgument const&);
+    void compile_mov(Bytecode::Op::Mov const&);
+    void compile_end(Bytecode::Op::End const&);
+    void compile_jump(Bytecode::Op::Jump const&);
+    void compile_jump_if(Bytecode::Operand condition, Optional<Bytecode::Label> true_target, Optional<Bytecode::Label> false_target);
+    void compile_jump_nullish(Bytecode::Op::JumpNullish const&);
+    void compile_jump_undefined(Bytecode::Op::JumpUndefined const&);
+    void compile_increment(Bytecode::Op::Increment const&);
+    void compile_decrement(Bytecode::Op::Decrement const&);
+    void compile_postfix_increment(Bytecode::Op::PostfixIncrement const&);
+    void compile_postfix_decrement(Bytecode::Op::PostfixDecrement const&);
+    void compile_add(Bytecode::Op::Add const&);
+    void compile_sub(Bytecode::Op::Sub const&);
+
+    template<typename OpType>
+    void compile_comparison(OpType const&, Assembler::Condition);
+
+    template<typename OpType>
+    void compile_comparison_jump(OpType const&, Assembler::Condition, u64 (*slow_case)(Bytecode::Interpreter&, Bytecode::Instruction const&));
+
+    template<typename OpType>
+    void compile_generic();
+
+    void call_slow_case(u64 (*slow_case)(Bytecode::Interpreter&, Bytecode::Instruction const&));
+    void call_slow_case_and_exit_on_exception(u64 (*slow_case)(Bytecode::Interpreter&, Bytecode::Instruction const&));
+
+    void load_operand(Assembler::Reg, Bytecode::Operand);
+    void store_operand(Bytecode::Operand, Assembler::Reg);
+    void branch_if_not_int32(Assembler::Reg, Assembler::Label&);
+    void box_int32(Assembler::Reg);
+    void box_boolean(Assembler::Reg);
+
+    Assembler::Label& label_for(Bytecode::Label);
+
+    Bytecode::Executable& m_executable;
+    Bytecode::Instruction const* m_current_instruction { nullptr };
+    size_t m_current_offset { 0 };
+
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+    Assembler::Label m_exit_label;
+    HashMap<size_t, Assembler::Label> m_block_labels;
+#endif
+};
+
+}
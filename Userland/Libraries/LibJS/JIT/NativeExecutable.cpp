@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJIT/GDB.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Value.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+NativeExecutable::NativeExecutable(void* code, size_t size, Optional<FixedArray<u8>> gdb_object)
+    : m_code(code)
+    , m_size(size)
+    , m_gdb_object(move(gdb_object))
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::register_into_gdb(m_gdb_object.value().span());
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::unregister_from_gdb(m_gdb_object.value().span());
+    munmap(m_code, m_size);
+}
+
+void NativeExecutable::run(Bytecode::Interpreter& interpreter, Span<Value> registers_and_constants_and_locals, Span<Value> arguments, size_t& program_counter) const
+{
+    using JITCode = void (*)(Bytecode::Interpreter*, Value*, Value*, size_t*);
+    reinterpret_cast<JITCode>(m_code)(&interpreter, registers_and_constants_and_locals.data(), arguments.data(), &program_counter);
+}
+
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FixedArray.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    NativeExecutable(void* code, size_t size, Optional<FixedArray<u8>> gdb_object = {});
+    ~NativeExecutable();
+
+    // Runs the compiled code from the first instruction of the executable.
+    // Any thrown exception ends up in the interpreter's exception register,
+    // exactly as if the bytecode had been interpreted.
+    void run(Bytecode::Interpreter&, Span<Value> registers_and_constants_and_locals, Span<Value> arguments, size_t& program_counter) const;
+
+    ReadonlyBytes code_bytes() const { return { m_code, m_size }; }
+
+private:
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    Optional<FixedArray<u8>> m_gdb_object;
+};
+
+}
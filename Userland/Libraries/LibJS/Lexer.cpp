@@ -16,7 +16,55 @@
 
 namespace JS {
 
-HashMap<DeprecatedFlyString, TokenType> Lexer::s_keywords;
+static HashMap<DeprecatedFlyString, TokenType> const& keywords()
+{
+    // NOTE: This is initialized on first use in a thread-safe way, as lexers may be created on several threads at once.
+    static auto const keywords = [] {
+        HashMap<DeprecatedFlyString, TokenType> keywords;
+        keywords.set("async", TokenType::Async);
+        keywords.set("await", TokenType::Await);
+        keywords.set("break", TokenType::Break);
+        keywords.set("case", TokenType::Case);
+        keywords.set("catch", TokenType::Catch);
+        keywords.set("class", TokenType::Class);
+        keywords.set("const", TokenType::Const);
+        keywords.set("continue", TokenType::Continue);
+        keywords.set("debugger", TokenType::Debugger);
+        keywords.set("default", TokenType::Default);
+        keywords.set("delete", TokenType::Delete);
+        keywords.set("do", TokenType::Do);
+        keywords.set("else", TokenType::Else);
+        keywords.set("enum", TokenType::Enum);
+        keywords.set("export", TokenType::Export);
+        keywords.set("extends", TokenType::Extends);
+        keywords.set("false", TokenType::BoolLiteral);
+        keywords.set("finally", TokenType::Finally);
+        keywords.set("for", TokenType::For);
+        keywords.set("function", TokenType::Function);
+        keywords.set("if", TokenType::If);
+        keywords.set("import", TokenType::Import);
+        keywords.set("in", TokenType::In);
+        keywords.set("instanceof", TokenType::Instanceof);
+        keywords.set("let", TokenType::Let);
+        keywords.set("new", TokenType::New);
+        keywords.set("null", TokenType::NullLiteral);
+        keywords.set("return", TokenType::Return);
+        keywords.set("super", TokenType::Super);
+        keywords.set("switch", TokenType::Switch);
+        keywords.set("this", TokenType::This);
+        keywords.set("throw", TokenType::Throw);
+        keywords.set("true", TokenType::BoolLiteral);
+        keywords.set("try", TokenType::Try);
+        keywords.set("typeof", TokenType::Typeof);
+        keywords.set("var", TokenType::Var);
+        keywords.set("void", TokenType::Void);
+        keywords.set("while", TokenType::While);
+        keywords.set("with", TokenType::With);
+        keywords.set("yield", TokenType::Yield);
+        return keywords;
+    }();
+    return keywords;
+}
 
 static constexpr TokenType parse_two_char_token(StringView view)
 {
@@ -133,52 +181,18 @@ Lexer::Lexer(StringView source, StringView filename, size_t line_number, size_t
     , m_line_column(line_column)
     , m_parsed_identifiers(adopt_ref(*new ParsedIdentifiers))
 {
-    if (s_keywords.is_empty()) {
-        s_keywords.set("async", TokenType::Async);
-        s_keywords.set("await", TokenType::Await);
-        s_keywords.set("break", TokenType::Break);
-        s_keywords.set("case", TokenType::Case);
-        s_keywords.set("catch", TokenType::Catch);
-        s_keywords.set("class", TokenType::Class);
-        s_keywords.set("const", TokenType::Const);
-        s_keywords.set("continue", TokenType::Continue);
-        s_keywords.set("debugger", TokenType::Debugger);
-        s_keywords.set("default", TokenType::Default);
-        s_keywords.set("delete", TokenType::Delete);
-        s_keywords.set("do", TokenType::Do);
-        s_keywords.set("else", TokenType::Else);
-        s_keywords.set("enum", TokenType::Enum);
-        s_keywords.set("export", TokenType::Export);
-        s_keywords.set("extends", TokenType::Extends);
-        s_keywords.set("false", TokenType::BoolLiteral);
-        s_keywords.set("finally", TokenType::Finally);
-        s_keywords.set("for", TokenType::For);
-        s_keywords.set("function", TokenType::Function);
-        s_keywords.set("if", TokenType::If);
-        s_keywords.set("import", TokenType::Import);
-        s_keywords.set("in", TokenType::In);
-        s_keywords.set("instanceof", TokenType::Instanceof);
-        s_keywords.set("let", TokenType::Let);
-        s_keywords.set("new", TokenType::New);
-        s_keywords.set("null", TokenType::NullLiteral);
-        s_keywords.set("return", TokenType::Return);
-        s_keywords.set("super", TokenType::Super);
-        s_keywords.set("switch", TokenType::Switch);
-        s_keywords.set("this", TokenType::This);
-        s_keywords.set("throw", TokenType::Throw);
-        s_keywords.set("true", TokenType::BoolLiteral);
-        s_keywords.set("try", TokenType::Try);
-        s_keywords.set("typeof", TokenType::Typeof);
-        s_keywords.set("var", TokenType::Var);
-        s_keywords.set("void", TokenType::Void);
-        s_keywords.set("while", TokenType::While);
-        s_keywords.set("with", TokenType::With);
-        s_keywords.set("yield", TokenType::Yield);
-    }
-
     consume();
 }
 
+Lexer Lexer::for_part_of_source(StringView source, StringView filename, size_t start_offset, size_t end_offset, size_t line_number, size_t line_column)
+{
+    VERIFY(start_offset <= end_offset && end_offset <= source.length());
+    VERIFY(line_column > 0);
+    Lexer lexer { source.substring_view(start_offset, end_offset - start_offset), filename, line_number, line_column - 1 };
+    lexer.m_source_offset = start_offset;
+    return lexer;
+}
+
 void Lexer::consume()
 {
     auto did_reach_eof = [this] {
@@ -702,8 +716,8 @@ Token Lexer::next()
         identifier = builder.string_view();
         m_parsed_identifiers->identifiers.set(*identifier);
 
-        auto it = s_keywords.find(identifier->hash(), [&](auto& entry) { return entry.key == identifier; });
-        if (it == s_keywords.end())
+        auto it = keywords().find(identifier->hash(), [&](auto& entry) { return entry.key == identifier; });
+        if (it == keywords().end())
             token_type = TokenType::Identifier;
         else
             token_type = has_escaped_character ? TokenType::EscapedKeyword : it->value;
@@ -874,7 +888,7 @@ Token Lexer::next()
             m_filename,
             m_line_number,
             m_line_column - 1,
-            value_start + 1);
+            m_source_offset + value_start + 1);
         m_hit_invalid_unicode.clear();
         // Do not produce any further tokens.
         VERIFY(is_eof());
@@ -887,7 +901,7 @@ Token Lexer::next()
             m_filename,
             value_start_line_number,
             value_start_column_number,
-            value_start - 1);
+            m_source_offset + value_start - 1);
     }
 
     if (identifier.has_value())
@@ -931,7 +945,7 @@ Token Lexer::force_slash_as_regex()
         m_filename,
         m_current_token.line_number(),
         m_current_token.line_column(),
-        value_start - 1);
+        m_source_offset + value_start - 1);
 
     if constexpr (LEXER_DEBUG) {
         dbgln("------------------------------");
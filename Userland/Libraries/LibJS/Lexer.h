@@ -19,6 +19,10 @@ class Lexer {
 public:
     explicit Lexer(StringView source, StringView filename = "(unknown)"sv, size_t line_number = 1, size_t line_column = 0);
 
+    // Lexes only the part of a larger source text between the given offsets. Tokens get the same positions as they
+    // would have when lexing all of it, if the line number and column of the start offset are given as well.
+    static Lexer for_part_of_source(StringView source, StringView filename, size_t start_offset, size_t end_offset, size_t line_number, size_t line_column);
+
     Token next();
 
     ByteString const& source() const { return m_source; }
@@ -59,6 +63,7 @@ private:
     TokenType consume_regex_literal();
 
     ByteString m_source;
+    size_t m_source_offset { 0 };
     size_t m_position { 0 };
     Token m_current_token;
     char m_current_char { 0 };
@@ -80,8 +85,6 @@ private:
 
     Optional<size_t> m_hit_invalid_unicode;
 
-    static HashMap<DeprecatedFlyString, TokenType> s_keywords;
-
     struct ParsedIdentifiers : public RefCounted<ParsedIdentifiers> {
         // Resolved identifiers must be kept alive for the duration of the parsing stage, otherwise
         // the only references to these strings are deleted by the Token destructor.
@@ -639,6 +639,8 @@ private:
 
 constexpr OperatorPrecedenceTable g_operator_precedence;
 
+bool g_parse_function_bodies_lazily = getenv("LIBJS_LAZY_FUNCTIONS") != nullptr;
+
 Parser::ParserState::ParserState(Lexer l, Program::Type program_type)
     : lexer(move(l))
 {
@@ -661,6 +663,13 @@ Parser::Parser(Lexer lexer, Program::Type program_type, Optional<EvalInitialStat
     }
 }
 
+Parser::Parser(NonnullRefPtr<SourceCode const> source_code, Lexer lexer, Program::Type program_type)
+    : m_source_code(move(source_code))
+    , m_state(move(lexer), program_type)
+    , m_program_type(program_type)
+{
+}
+
 Associativity Parser::operator_associativity(TokenType type) const
 {
     switch (type) {
@@ -735,6 +744,8 @@ NonnullRefPtr<Program> Parser::parse_program(bool starts_in_strict_mode)
 {
     auto rule_start = push_start();
     auto program = adopt_ref(*new Program({ m_source_code, rule_start.position(), position() }, m_program_type));
+    if (m_records_nodes_referenced_by_bytecode)
+        m_nodes_referenced_by_bytecode.append(program);
     ScopePusher program_scope = ScopePusher::program_scope(*this, *program);
 
     if (m_program_type == Program::Type::Script)
@@ -743,6 +754,8 @@ NonnullRefPtr<Program> Parser::parse_program(bool starts_in_strict_mode)
         parse_module(program);
 
     program->set_end_offset({}, position().offset);
+    if (m_records_nodes_referenced_by_bytecode)
+        program->set_nodes_referenced_by_bytecode({}, move(m_nodes_referenced_by_bytecode));
     return program;
 }
 
@@ -1117,7 +1130,7 @@ RefPtr<FunctionExpression const> Parser::try_parse_arrow_function_expression(boo
 
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = ByteString { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = ByteString { m_source_code->code().bytes_as_string_view().substring_view(function_start_offset, function_end_offset - function_start_offset) };
     return create_ast_node<FunctionExpression>(
         { m_source_code, rule_start.position(), position() }, nullptr, move(source_text),
         move(body), move(parameters), function_length, function_kind, body->in_strict_mode(),
@@ -1640,7 +1653,7 @@ NonnullRefPtr<ClassExpression const> Parser::parse_class_expression(bool expect_
 
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = ByteString { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = ByteString { m_source_code->code().bytes_as_string_view().substring_view(function_start_offset, function_end_offset - function_start_offset) };
 
     return create_ast_node<ClassExpression>({ m_source_code, rule_start.position(), position() }, move(class_name), move(source_text), move(constructor), move(super_class), move(elements));
 }
@@ -2529,7 +2542,7 @@ RefPtr<BindingPattern const> Parser::synthesize_binding_pattern(Expression const
     // This means that `source` will contain the subsequent token's trivia, if any (which is fine).
     auto source_start_offset = expression.source_range().start.offset;
     auto source_end_offset = expression.source_range().end.offset;
-    auto source = m_state.lexer.source().substring_view(source_start_offset, source_end_offset - source_start_offset);
+    auto source = m_source_code->code().bytes_as_string_view().substring_view(source_start_offset, source_end_offset - source_start_offset);
     Lexer lexer { source, m_state.lexer.filename(), expression.source_range().start.line, expression.source_range().start.column };
     Parser parser { lexer };
 
@@ -2795,57 +2808,93 @@ NonnullRefPtr<FunctionBody const> Parser::parse_function_body(Vector<FunctionPar
         expected(Token::name(TokenType::CurlyClose));
 
     // If the function contains 'use strict' we need to check the parameters (again).
-    if (function_body->in_strict_mode() || function_kind != FunctionKind::Normal) {
-        Vector<StringView> parameter_names;
-        for (auto& parameter : parameters) {
-            parameter.binding.visit(
-                [&](Identifier const& identifier) {
-                    auto const& parameter_name = identifier.string();
+    check_function_parameters(parameters, function_kind, function_body->in_strict_mode());
 
-                    check_identifier_name_for_assignment_validity(parameter_name, function_body->in_strict_mode());
-                    if (function_kind == FunctionKind::Generator && parameter_name == "yield"sv)
-                        syntax_error("Parameter name 'yield' not allowed in this context");
+    m_state.strict_mode = previous_strict_mode;
+    VERIFY(m_state.current_scope_pusher->type() == ScopePusher::ScopeType::Function);
+    parsing_insights.contains_direct_call_to_eval = m_state.current_scope_pusher->contains_direct_call_to_eval();
+    parsing_insights.uses_this_from_environment = m_state.current_scope_pusher->uses_this_from_environment();
+    parsing_insights.uses_this = m_state.current_scope_pusher->uses_this();
+    return function_body;
+}
 
-                    if (function_kind == FunctionKind::Async && parameter_name == "await"sv)
-                        syntax_error("Parameter name 'await' not allowed in this context");
+// Parses a function body in full, so that its early errors are reported along with those of the rest of the program, but
+// only keeps an empty body that remembers where the function is in the source code. The function is parsed in full again
+// when it's first called, so that the AST of functions that never run doesn't have to be kept around.
+NonnullRefPtr<FunctionBody const> Parser::pre_parse_function_body(Position const& parameters_start, u16 parse_options, Vector<FunctionParameter> const& parameters, FunctionKind function_kind, FunctionParsingInsights& parsing_insights)
+{
+    auto rule_start = push_start();
+    auto nodes_referenced_by_bytecode = m_nodes_referenced_by_bytecode.size();
 
-                    for (auto& previous_name : parameter_names) {
-                        if (previous_name == parameter_name) {
-                            syntax_error(ByteString::formatted("Duplicate parameter '{}' not allowed in strict mode", parameter_name));
-                        }
+    // NOTE: Parsing the body also tells the enclosing scopes which of their variables it captures.
+    auto full_body = parse_function_body(parameters, function_kind, parsing_insights);
+    if (has_errors())
+        return full_body;
+
+    // NOTE: The nodes in the body belong to the function parsed on first call, which the bytecode refers to instead.
+    m_nodes_referenced_by_bytecode.shrink(nodes_referenced_by_bytecode);
+
+    auto function_body = create_ast_node<FunctionBody>({ m_source_code, rule_start.position(), position() });
+    if (full_body->in_strict_mode())
+        function_body->set_strict_mode();
+    function_body->set_lazy_parse_state({}, {
+        .parameters_start = parameters_start,
+        .end_offset = m_state.current_token.offset() + 1,
+        .parse_options = parse_options,
+        .in_strict_mode = m_state.strict_mode,
+        .program_type = m_program_type,
+    });
+    return function_body;
+}
+
+// The parameters of strict mode functions, generators and async functions are more restricted than those of other functions.
+void Parser::check_function_parameters(Vector<FunctionParameter> const& parameters, FunctionKind function_kind, bool in_strict_mode)
+{
+    if (!in_strict_mode && function_kind == FunctionKind::Normal)
+        return;
+
+    Vector<StringView> parameter_names;
+    for (auto& parameter : parameters) {
+        parameter.binding.visit(
+            [&](Identifier const& identifier) {
+                auto const& parameter_name = identifier.string();
+
+                check_identifier_name_for_assignment_validity(parameter_name, in_strict_mode);
+                if (function_kind == FunctionKind::Generator && parameter_name == "yield"sv)
+                    syntax_error("Parameter name 'yield' not allowed in this context");
+
+                if (function_kind == FunctionKind::Async && parameter_name == "await"sv)
+                    syntax_error("Parameter name 'await' not allowed in this context");
+
+                for (auto& previous_name : parameter_names) {
+                    if (previous_name == parameter_name) {
+                        syntax_error(ByteString::formatted("Duplicate parameter '{}' not allowed in strict mode", parameter_name));
                     }
+                }
 
-                    parameter_names.append(parameter_name);
-                },
-                [&](NonnullRefPtr<BindingPattern const> const& binding) {
-                    // NOTE: Nothing in the callback throws an exception.
-                    MUST(binding->for_each_bound_identifier([&](auto& bound_identifier) {
-                        auto const& bound_name = bound_identifier.string();
+                parameter_names.append(parameter_name);
+            },
+            [&](NonnullRefPtr<BindingPattern const> const& binding) {
+                // NOTE: Nothing in the callback throws an exception.
+                MUST(binding->for_each_bound_identifier([&](auto& bound_identifier) {
+                    auto const& bound_name = bound_identifier.string();
 
-                        if (function_kind == FunctionKind::Generator && bound_name == "yield"sv)
-                            syntax_error("Parameter name 'yield' not allowed in this context");
+                    if (function_kind == FunctionKind::Generator && bound_name == "yield"sv)
+                        syntax_error("Parameter name 'yield' not allowed in this context");
 
-                        if (function_kind == FunctionKind::Async && bound_name == "await"sv)
-                            syntax_error("Parameter name 'await' not allowed in this context");
+                    if (function_kind == FunctionKind::Async && bound_name == "await"sv)
+                        syntax_error("Parameter name 'await' not allowed in this context");
 
-                        for (auto& previous_name : parameter_names) {
-                            if (previous_name == bound_name) {
-                                syntax_error(ByteString::formatted("Duplicate parameter '{}' not allowed in strict mode", bound_name));
-                                break;
-                            }
+                    for (auto& previous_name : parameter_names) {
+                        if (previous_name == bound_name) {
+                            syntax_error(ByteString::formatted("Duplicate parameter '{}' not allowed in strict mode", bound_name));
+                            break;
                         }
-                        parameter_names.append(bound_name);
-                    }));
-                });
-        }
+                    }
+                    parameter_names.append(bound_name);
+                }));
+            });
     }
-
-    m_state.strict_mode = previous_strict_mode;
-    VERIFY(m_state.current_scope_pusher->type() == ScopePusher::ScopeType::Function);
-    parsing_insights.contains_direct_call_to_eval = m_state.current_scope_pusher->contains_direct_call_to_eval();
-    parsing_insights.uses_this_from_environment = m_state.current_scope_pusher->uses_this_from_environment();
-    parsing_insights.uses_this = m_state.current_scope_pusher->uses_this();
-    return function_body;
 }
 
 NonnullRefPtr<BlockStatement const> Parser::parse_block_statement()
@@ -2933,6 +2982,7 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
     auto body = [&] {
         ScopePusher function_scope = ScopePusher::function_scope(*this, name);
 
+        auto parameters_start = position();
         consume(TokenType::ParenOpen);
         parameters = parse_formal_parameters(function_length, parse_options);
         consume(TokenType::ParenClose);
@@ -2949,6 +2999,12 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
 
         consume(TokenType::CurlyOpen);
 
+        // NOTE: Private names can only be checked against the enclosing classes, so functions in classes are always
+        //       parsed in full. A function scope without a parent belongs to a function that is being parsed on its own,
+        //       which is what happens to pre-parsed functions once they are called.
+        if (m_parses_function_bodies_lazily && function_scope.parent_scope() && !m_state.referenced_private_names)
+            return pre_parse_function_body(parameters_start, parse_options, parameters, function_kind, parsing_insights);
+
         auto body = parse_function_body(parameters, function_kind, parsing_insights);
         return body;
     }();
@@ -2963,7 +3019,7 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
 
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = ByteString { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = ByteString { m_source_code->code().bytes_as_string_view().substring_view(function_start_offset, function_end_offset - function_start_offset) };
     parsing_insights.might_need_arguments_object = m_state.function_might_need_arguments_object;
     return create_ast_node<FunctionNodeType>(
         { m_source_code, rule_start.position(), position() },
@@ -5153,6 +5209,25 @@ NonnullRefPtr<Identifier const> Parser::create_identifier_and_register_in_curren
     return id;
 }
 
+Result<NonnullRefPtr<FunctionExpression const>, Vector<ParserError>> Parser::parse_lazy_function(FunctionBody const& body)
+{
+    auto const& state = body.lazy_parse_state();
+    NonnullRefPtr<SourceCode const> source_code = body.source_code();
+    auto lexer = Lexer::for_part_of_source(source_code->code().bytes_as_string_view(), source_code->filename(), state.parameters_start.offset, state.end_offset, state.parameters_start.line, state.parameters_start.column);
+
+    Parser parser { source_code, move(lexer), state.program_type };
+    parser.m_state.strict_mode = state.in_strict_mode;
+    // NOTE: Functions nested in this one are pre-parsed again, and will be parsed in full on their own first call.
+    parser.m_parses_function_bodies_lazily = true;
+
+    auto function = parser.parse_function_node<FunctionExpression>(state.parse_options & ~(FunctionNodeParseOptions::CheckForFunctionAndName | FunctionNodeParseOptions::HasDefaultExportName), state.parameters_start);
+    if (!parser.has_errors() && !parser.done())
+        parser.expected("end of function");
+    if (parser.has_errors())
+        return parser.errors();
+    return NonnullRefPtr<FunctionExpression const> { move(function) };
+}
+
 Parser Parser::parse_function_body_from_string(ByteString const& body_string, u16 parse_options, Vector<FunctionParameter> const& parameters, FunctionKind kind, FunctionParsingInsights& parsing_insights)
 {
     RefPtr<FunctionBody const> function_body;
@@ -11,6 +11,7 @@
 #include <AK/Assertions.h>
 #include <AK/HashTable.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Result.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/AST.h>
 #include <LibJS/Lexer.h>
@@ -44,6 +45,9 @@ struct FunctionNodeParseOptions {
 
 class ScopePusher;
 
+// Whether scripts and modules should only be pre-parsed up front, parsing function bodies in full on their first call.
+extern bool g_parse_function_bodies_lazily;
+
 class Parser {
 public:
     struct EvalInitialState {
@@ -57,6 +61,15 @@ public:
 
     NonnullRefPtr<Program> parse_program(bool starts_in_strict_mode = false);
 
+    // Makes the parsed Program remember every node that bytecode may refer to, so the bytecode cache can refer to them by position.
+    void record_nodes_referenced_by_bytecode() { m_records_nodes_referenced_by_bytecode = true; }
+
+    // Makes the parser only check the syntax of function bodies, leaving them empty until parse_lazy_function() is called.
+    void parse_function_bodies_lazily() { m_parses_function_bodies_lazily = true; }
+
+    // Parses the function that a lazy function body belongs to, starting from its parameter list.
+    static Result<NonnullRefPtr<FunctionExpression const>, Vector<ParserError>> parse_lazy_function(FunctionBody const&);
+
     template<typename FunctionNodeType>
     NonnullRefPtr<FunctionNodeType> parse_function_node(u16 parse_options = FunctionNodeParseOptions::CheckForFunctionAndName, Optional<Position> const& function_start = {});
     Vector<FunctionParameter> parse_formal_parameters(int& function_length, u16 parse_options = 0);
@@ -216,6 +229,21 @@ public:
 private:
     friend class ScopePusher;
 
+    Parser(NonnullRefPtr<SourceCode const>, Lexer, Program::Type);
+
+    // NOTE: This shadows JS::create_ast_node() for everything the parser creates.
+    template<typename T, typename... Args>
+    NonnullRefPtr<T> create_ast_node(SourceRange range, Args&&... args)
+    {
+        auto node = JS::create_ast_node<T>(move(range), forward<Args>(args)...);
+        using NodeType = RemoveCV<T>;
+        if constexpr (IsBaseOf<ScopeNode, NodeType> || IsBaseOf<FunctionNode, NodeType> || IsSame<ClassExpression, NodeType>) {
+            if (m_records_nodes_referenced_by_bytecode)
+                m_nodes_referenced_by_bytecode.append(node);
+        }
+        return node;
+    }
+
     void parse_script(Program& program, bool starts_in_strict_mode);
     void parse_module(Program& program);
 
@@ -259,6 +287,9 @@ private:
 
     RefPtr<BindingPattern const> synthesize_binding_pattern(Expression const& expression);
 
+    NonnullRefPtr<FunctionBody const> pre_parse_function_body(Position const& parameters_start, u16 parse_options, Vector<FunctionParameter> const& parameters, FunctionKind, FunctionParsingInsights&);
+    void check_function_parameters(Vector<FunctionParameter> const& parameters, FunctionKind, bool in_strict_mode);
+
     Token next_token(size_t steps = 1) const;
 
     void check_identifier_name_for_assignment_validity(DeprecatedFlyString const&, bool force_strict = false);
@@ -356,5 +387,9 @@ private:
     Vector<ParserState> m_saved_state;
     HashMap<Position, TokenMemoization, PositionKeyTraits> m_token_memoizations;
     Program::Type m_program_type;
+
+    bool m_records_nodes_referenced_by_bytecode { false };
+    bool m_parses_function_bodies_lazily { false };
+    Vector<NonnullRefPtr<ASTNode const>> m_nodes_referenced_by_bytecode;
 };
 }
@@ -31,6 +31,66 @@ JS_DEFINE_ALLOCATOR(ArrayPrototype);
 
 static HashTable<NonnullGCPtr<Object>> s_array_join_seen_objects;
 
+// OPTIMIZATION: Every index below the length of an array with packed number elements is an own data property holding a number,
+//               so searching it doesn't have to go through [[HasProperty]] and [[Get]] for every element.
+static SimpleIndexedPropertyStorage const* packed_number_storage_for_search(Object const& object, size_t length)
+{
+    if (object.may_interfere_with_indexed_property_access())
+        return nullptr;
+    auto const* storage = object.indexed_properties().storage();
+    if (!storage || !storage->is_simple_storage())
+        return nullptr;
+    auto const& simple_storage = static_cast<SimpleIndexedPropertyStorage const&>(*storage);
+    if (!simple_storage.has_packed_number_elements() || length > simple_storage.array_like_size())
+        return nullptr;
+    return &simple_storage;
+}
+
+enum class SearchDirection {
+    Forwards,
+    Backwards,
+};
+
+template<typename T, typename Predicate>
+static Optional<size_t> find_packed_element(ReadonlySpan<T> elements, size_t start, size_t end, SearchDirection direction, Predicate predicate)
+{
+    if (direction == SearchDirection::Forwards) {
+        for (size_t i = start; i < end; ++i) {
+            if (predicate(elements[i]))
+                return i;
+        }
+    } else {
+        for (size_t i = end; i > start; --i) {
+            if (predicate(elements[i - 1]))
+                return i - 1;
+        }
+    }
+    return {};
+}
+
+// Searches [start, end) with IsStrictlyEqual, or with SameValueZero if NaN should match NaN.
+// NOTE: -0 and +0 are equal in both, which is what comparing unboxed numbers does anyway.
+static Optional<size_t> find_packed_number(SimpleIndexedPropertyStorage const& storage, Value search_element, size_t start, size_t end, SearchDirection direction, bool nan_matches_nan)
+{
+    if (!search_element.is_number())
+        return {};
+    auto number = search_element.as_double();
+
+    if (storage.element_kind() == SimpleIndexedPropertyStorage::ElementKind::PackedInt32) {
+        if (trunc(number) != number || number < NumericLimits<i32>::min() || number > NumericLimits<i32>::max())
+            return {};
+        auto int32 = static_cast<i32>(number);
+        return find_packed_element(storage.int32_elements().span(), start, end, direction, [int32](i32 element) { return element == int32; });
+    }
+
+    if (isnan(number)) {
+        if (!nan_matches_nan)
+            return {};
+        return find_packed_element(storage.double_elements().span(), start, end, direction, [](double element) { return isnan(element); });
+    }
+    return find_packed_element(storage.double_elements().span(), start, end, direction, [number](double element) { return element == number; });
+}
+
 ArrayPrototype::ArrayPrototype(Realm& realm)
     : Array(realm.intrinsics().object_prototype())
 {
@@ -742,6 +802,8 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::includes)
             from_index = from_argument;
     }
     auto value_to_find = vm.argument(0);
+    if (auto const* storage = packed_number_storage_for_search(*this_object, length))
+        return Value(find_packed_number(*storage, value_to_find, from_index, length, SearchDirection::Forwards, true).has_value());
     for (u64 i = from_index; i < length; ++i) {
         auto element = TRY(this_object->get(i));
         if (same_value_zero(element, value_to_find))
@@ -795,6 +857,11 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    if (auto const* storage = packed_number_storage_for_search(*object, length)) {
+        auto index = find_packed_number(*storage, search_element, k, length, SearchDirection::Forwards, false);
+        return index.has_value() ? Value(*index) : Value(-1);
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -906,6 +973,11 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::last_index_of)
         k = (double)length + n;
     }
 
+    if (auto const* storage = packed_number_storage_for_search(*object, length); storage && k >= 0) {
+        auto index = find_packed_number(*storage, search_element, 0, k + 1, SearchDirection::Backwards, false);
+        return index.has_value() ? Value(*index) : Value(-1);
+    }
+
     // 8. Repeat, while k ≥ 0,
     for (; k >= 0; --k) {
         auto property_key = PropertyKey { k };
@@ -18,6 +18,7 @@ namespace JS {
 class BigInt final : public Cell {
     JS_CELL(BigInt, Cell);
     JS_DECLARE_ALLOCATOR(BigInt);
+    JS_DECLARE_PRECISE_WRITE_BARRIERS(BigInt);
 
 public:
     [[nodiscard]] static NonnullGCPtr<BigInt> create(VM&, Crypto::SignedBigInteger);
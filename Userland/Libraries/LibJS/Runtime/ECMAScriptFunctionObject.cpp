@@ -13,6 +13,7 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Parser.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/AsyncFunctionDriverWrapper.h>
@@ -91,6 +92,24 @@ ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, Byt
     // 15. Set F.[[ScriptOrModule]] to GetActiveScriptOrModule().
     m_script_or_module = vm().get_active_script_or_module();
 
+    // NOTE: Functions that were only pre-parsed get the rest of their setup once their body has been parsed.
+    m_has_lazy_body = m_ecmascript_code->is_function_body() && static_cast<FunctionBody const&>(*m_ecmascript_code).is_lazy();
+
+    prepare_function_declaration_instantiation(parsing_insights);
+}
+
+void ECMAScriptFunctionObject::prepare_function_declaration_instantiation(FunctionParsingInsights const& parsing_insights)
+{
+    m_has_parameter_expressions = false;
+    m_has_duplicates = false;
+    m_parameter_names.clear();
+    m_functions_to_initialize.clear();
+    m_var_names_to_initialize_binding.clear();
+    m_function_names_to_initialize_binding.clear();
+    m_function_environment_bindings_count = 0;
+    m_var_environment_bindings_count = 0;
+    m_lex_environment_bindings_count = 0;
+
     // 15.1.3 Static Semantics: IsSimpleParameterList, https://tc39.es/ecma262/#sec-static-semantics-issimpleparameterlist
     m_has_simple_parameter_list = all_of(m_formal_parameters, [&](auto& parameter) {
         if (parameter.is_rest)
@@ -335,6 +354,34 @@ ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, Byt
     m_uses_this = parsing_insights.uses_this;
 }
 
+// Pre-parsed functions are parsed in full when they are first called. The result is kept on the lazy body,
+// so that other function objects created from the same code don't have to parse it again.
+ThrowCompletionOr<void> ECMAScriptFunctionObject::ensure_body_is_parsed()
+{
+    if (!m_has_lazy_body)
+        return {};
+
+    auto const& lazy_body = static_cast<FunctionBody const&>(*m_ecmascript_code);
+    auto const* function = lazy_body.fully_parsed_function();
+    if (!function) {
+        auto result = Parser::parse_lazy_function(lazy_body);
+        if (result.is_error())
+            return vm().throw_completion<SyntaxError>(result.error().first().to_string());
+        lazy_body.set_fully_parsed_function(result.release_value());
+        function = lazy_body.fully_parsed_function();
+    }
+
+    m_formal_parameters = function->parameters();
+    m_ecmascript_code = function->body();
+    m_local_variables_names = function->local_variables_names();
+    m_might_need_arguments_object = function->might_need_arguments_object();
+    m_contains_direct_call_to_eval = function->contains_direct_call_to_eval();
+    m_has_lazy_body = false;
+
+    prepare_function_declaration_instantiation(function->parsing_insights());
+    return {};
+}
+
 void ECMAScriptFunctionObject::initialize(Realm& realm)
 {
     auto& vm = this->vm();
@@ -382,6 +429,8 @@ ThrowCompletionOr<Value> ECMAScriptFunctionObject::internal_call(Value this_argu
     // 1. Let callerContext be the running execution context.
     // NOTE: No-op, kept by the VM in its execution context stack.
 
+    TRY(ensure_body_is_parsed());
+
     auto callee_context = ExecutionContext::create(heap());
 
     // Non-standard
@@ -446,6 +495,8 @@ ThrowCompletionOr<NonnullGCPtr<Object>> ECMAScriptFunctionObject::internal_const
     // 1. Let callerContext be the running execution context.
     // NOTE: No-op, kept by the VM in its execution context stack.
 
+    TRY(ensure_body_is_parsed());
+
     // 2. Let kind be F.[[ConstructorKind]].
     auto kind = m_constructor_kind;
 
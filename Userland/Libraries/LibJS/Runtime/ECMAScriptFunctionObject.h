@@ -95,6 +95,7 @@ public:
 
     // This is used by LibWeb to disassociate event handler attribute callback functions from the nearest script on the call stack.
     // https://html.spec.whatwg.org/multipage/webappapis.html#getting-the-current-value-of-the-event-handler Step 3.11
+    ScriptOrModule const& script_or_module() const { return m_script_or_module; }
     void set_script_or_module(ScriptOrModule script_or_module) { m_script_or_module = move(script_or_module); }
 
     Variant<PropertyKey, PrivateName, Empty> const& class_field_initializer_name() const { return m_class_field_initializer_name; }
@@ -114,6 +115,8 @@ private:
     virtual bool is_ecmascript_function_object() const override { return true; }
     virtual void visit_edges(Visitor&) override;
 
+    ThrowCompletionOr<void> ensure_body_is_parsed();
+    void prepare_function_declaration_instantiation(FunctionParsingInsights const&);
     ThrowCompletionOr<void> prepare_for_ordinary_call(ExecutionContext& callee_context, Object* new_target);
     void ordinary_call_bind_this(ExecutionContext&, Value this_argument);
 
@@ -127,7 +130,7 @@ private:
     // Internal Slots of ECMAScript Function Objects, https://tc39.es/ecma262/#table-internal-slots-of-ecmascript-function-objects
     GCPtr<Environment> m_environment;                                        // [[Environment]]
     GCPtr<PrivateEnvironment> m_private_environment;                         // [[PrivateEnvironment]]
-    Vector<FunctionParameter> const m_formal_parameters;                     // [[FormalParameters]]
+    Vector<FunctionParameter> m_formal_parameters;                           // [[FormalParameters]]
     NonnullRefPtr<Statement const> m_ecmascript_code;                        // [[ECMAScriptCode]]
     GCPtr<Realm> m_realm;                                                    // [[Realm]]
     ScriptOrModule m_script_or_module;                                       // [[ScriptOrModule]]
@@ -145,6 +148,7 @@ private:
     bool m_contains_direct_call_to_eval : 1 { true };
     bool m_is_arrow_function : 1 { false };
     bool m_has_simple_parameter_list : 1 { false };
+    bool m_has_lazy_body : 1 { false };
     FunctionKind m_kind : 3 { FunctionKind::Normal };
 
     struct VariableNameToInitialize {
@@ -16,8 +16,27 @@ constexpr size_t const LENGTH_SETTER_GENERIC_STORAGE_THRESHOLD = 4 * MiB;
 SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initial_values)
     : IndexedPropertyStorage(IsSimpleStorage::Yes)
     , m_array_size(initial_values.size())
-    , m_packed_elements(move(initial_values))
 {
+    bool all_int32 = true;
+    bool all_numbers = true;
+    for (auto value : initial_values) {
+        all_int32 = all_int32 && value.is_int32();
+        all_numbers = all_numbers && value.is_number();
+    }
+
+    if (all_int32) {
+        m_int32_elements.ensure_capacity(initial_values.size());
+        for (auto value : initial_values)
+            m_int32_elements.unchecked_append(value.as_i32());
+    } else if (all_numbers) {
+        m_element_kind = ElementKind::PackedDouble;
+        m_double_elements.ensure_capacity(initial_values.size());
+        for (auto value : initial_values)
+            m_double_elements.unchecked_append(value.as_double());
+    } else {
+        m_element_kind = ElementKind::Any;
+        m_packed_elements = move(initial_values);
+    }
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -43,10 +62,59 @@ void SimpleIndexedPropertyStorage::grow_storage_if_needed()
     }
 }
 
+void SimpleIndexedPropertyStorage::transition_to_double_elements()
+{
+    VERIFY(m_element_kind == ElementKind::PackedInt32);
+    m_double_elements.ensure_capacity(m_int32_elements.capacity());
+    for (auto element : m_int32_elements)
+        m_double_elements.unchecked_append(element);
+    m_int32_elements.clear();
+    m_element_kind = ElementKind::PackedDouble;
+}
+
+void SimpleIndexedPropertyStorage::transition_to_any_elements()
+{
+    VERIFY(m_element_kind != ElementKind::Any);
+    m_packed_elements.ensure_capacity(m_array_size);
+    for_each_value([&](Value value) {
+        m_packed_elements.unchecked_append(value);
+    });
+    m_int32_elements.clear();
+    m_double_elements.clear();
+    m_element_kind = ElementKind::Any;
+}
+
+template<typename T>
+static void put_packed_element(Vector<T>& elements, size_t& array_size, u32 index, T element)
+{
+    if (index < array_size) {
+        elements.data()[index] = element;
+        return;
+    }
+    elements.append(element);
+    ++array_size;
+}
+
 void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttributes attributes)
 {
     VERIFY(attributes == default_attributes);
 
+    // NOTE: Packed elements can only be overwritten or appended to, as anything else would leave a hole.
+    if (m_element_kind != ElementKind::Any && index <= m_array_size && value.is_number()) {
+        if (m_element_kind == ElementKind::PackedInt32) {
+            if (value.is_int32()) {
+                put_packed_element(m_int32_elements, m_array_size, index, value.as_i32());
+                return;
+            }
+            transition_to_double_elements();
+        }
+        put_packed_element(m_double_elements, m_array_size, index, value.as_double());
+        return;
+    }
+
+    if (m_element_kind != ElementKind::Any)
+        transition_to_any_elements();
+
     if (index >= m_array_size) {
         m_array_size = index + 1;
         grow_storage_if_needed();
@@ -57,18 +125,36 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
+    if (m_element_kind != ElementKind::Any)
+        transition_to_any_elements();
     m_packed_elements[index] = {};
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        return { Value(m_int32_elements.take_first()), default_attributes };
+    case ElementKind::PackedDouble:
+        return { Value(m_double_elements.take_first()), default_attributes };
+    case ElementKind::Any:
+        break;
+    }
     return { m_packed_elements.take_first(), default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        return { Value(m_int32_elements.take_last()), default_attributes };
+    case ElementKind::PackedDouble:
+        return { Value(m_double_elements.take_last()), default_attributes };
+    case ElementKind::Any:
+        break;
+    }
     auto last_element = m_packed_elements[m_array_size];
     m_packed_elements[m_array_size] = {};
     return { last_element, default_attributes };
@@ -76,6 +162,17 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (m_element_kind != ElementKind::Any) {
+        // NOTE: Growing a packed array would leave holes at the end, but shrinking it is fine.
+        if (new_size <= m_array_size) {
+            m_array_size = new_size;
+            m_int32_elements.shrink(min(new_size, m_int32_elements.size()), true);
+            m_double_elements.shrink(min(new_size, m_double_elements.size()), true);
+            return true;
+        }
+        transition_to_any_elements();
+    }
+
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
@@ -85,10 +182,9 @@ GenericIndexedPropertyStorage::GenericIndexedPropertyStorage(SimpleIndexedProper
     : IndexedPropertyStorage(IsSimpleStorage::No)
 {
     m_array_size = storage.array_like_size();
-    for (size_t i = 0; i < storage.m_packed_elements.size(); ++i) {
-        auto value = storage.m_packed_elements[i];
-        if (!value.is_empty())
-            m_sparse_elements.set(i, { value, default_attributes });
+    for (size_t i = 0; i < storage.size(); ++i) {
+        if (auto element = storage.inline_get(i); element.has_value())
+            m_sparse_elements.set(i, element.release_value());
     }
 }
 
@@ -265,7 +361,10 @@ size_t IndexedProperties::real_size() const
     if (!m_storage)
         return 0;
     if (m_storage->is_simple_storage()) {
-        auto& packed_elements = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).elements();
+        auto const& storage = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage);
+        if (storage.has_packed_number_elements())
+            return storage.array_like_size();
+        auto& packed_elements = storage.elements();
         size_t size = 0;
         for (auto& element : packed_elements) {
             if (!element.is_empty())
@@ -282,9 +381,14 @@ Vector<u32> IndexedProperties::indices() const
         return {};
     if (m_storage->is_simple_storage()) {
         auto const& storage = static_cast<SimpleIndexedPropertyStorage const&>(*m_storage);
-        auto const& elements = storage.elements();
         Vector<u32> indices;
         indices.ensure_capacity(storage.array_like_size());
+        if (storage.has_packed_number_elements()) {
+            for (size_t i = 0; i < storage.array_like_size(); ++i)
+                indices.unchecked_append(i);
+            return indices;
+        }
+        auto const& elements = storage.elements();
         for (size_t i = 0; i < elements.size(); ++i) {
             if (!elements.at(i).is_empty())
                 indices.unchecked_append(i);
@@ -56,6 +56,13 @@ private:
 
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
 public:
+    // Arrays without holes that only ever held numbers keep them unboxed. Any other store moves the elements to the Any kind for good.
+    enum class ElementKind : u8 {
+        PackedInt32,
+        PackedDouble,
+        Any,
+    };
+
     SimpleIndexedPropertyStorage()
         : IndexedPropertyStorage(IsSimpleStorage::Yes) {};
     explicit SimpleIndexedPropertyStorage(Vector<Value>&& initial_values);
@@ -68,30 +75,85 @@ public:
     virtual ValueAndAttributes take_first() override;
     virtual ValueAndAttributes take_last() override;
 
-    virtual size_t size() const override { return m_packed_elements.size(); }
+    virtual size_t size() const override { return m_element_kind == ElementKind::Any ? m_packed_elements.size() : m_array_size; }
     virtual size_t array_like_size() const override { return m_array_size; }
     virtual bool set_array_like_size(size_t new_size) override;
 
-    Vector<Value> const& elements() const { return m_packed_elements; }
+    ElementKind element_kind() const { return m_element_kind; }
+    bool has_packed_number_elements() const { return m_element_kind != ElementKind::Any; }
+
+    // Only valid for the matching element kind.
+    Vector<Value> const& elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::Any);
+        return m_packed_elements;
+    }
+    Vector<i32> const& int32_elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::PackedInt32);
+        return m_int32_elements;
+    }
+    Vector<double> const& double_elements() const
+    {
+        VERIFY(m_element_kind == ElementKind::PackedDouble);
+        return m_double_elements;
+    }
 
     [[nodiscard]] bool inline_has_index(u32 index) const
     {
+        if (m_element_kind != ElementKind::Any)
+            return index < m_array_size;
         return index < m_array_size && !m_packed_elements.data()[index].is_empty();
     }
 
     [[nodiscard]] Optional<ValueAndAttributes> inline_get(u32 index) const
     {
-        if (!inline_has_index(index))
+        if (index >= m_array_size)
+            return {};
+        switch (m_element_kind) {
+        case ElementKind::PackedInt32:
+            return ValueAndAttributes { Value(m_int32_elements.data()[index]), default_attributes };
+        case ElementKind::PackedDouble:
+            return ValueAndAttributes { Value(m_double_elements.data()[index]), default_attributes };
+        case ElementKind::Any:
+            break;
+        }
+        auto value = m_packed_elements.data()[index];
+        if (value.is_empty())
             return {};
-        return ValueAndAttributes { m_packed_elements.data()[index], default_attributes };
+        return ValueAndAttributes { value, default_attributes };
+    }
+
+    template<typename Callback>
+    void for_each_value(Callback callback) const
+    {
+        switch (m_element_kind) {
+        case ElementKind::PackedInt32:
+            for (auto element : m_int32_elements)
+                callback(Value(element));
+            break;
+        case ElementKind::PackedDouble:
+            for (auto element : m_double_elements)
+                callback(Value(element));
+            break;
+        case ElementKind::Any:
+            for (auto value : m_packed_elements)
+                callback(value);
+            break;
+        }
     }
 
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
+    void transition_to_double_elements();
+    void transition_to_any_elements();
 
     size_t m_array_size { 0 };
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
+    Vector<i32> m_int32_elements;
+    Vector<double> m_double_elements;
     Vector<Value> m_packed_elements;
 };
 
@@ -170,14 +232,19 @@ public:
 
     Vector<u32> indices() const;
 
+    // Packed numbers are never cells, so the garbage collector doesn't have to look at them.
+    bool may_contain_cells() const
+    {
+        return m_storage && !(m_storage->is_simple_storage() && static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).has_packed_number_elements());
+    }
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
         if (!m_storage)
             return;
         if (m_storage->is_simple_storage()) {
-            for (auto& value : static_cast<SimpleIndexedPropertyStorage&>(*m_storage).elements())
-                callback(value);
+            static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).for_each_value(callback);
         } else {
             for (auto& element : static_cast<GenericIndexedPropertyStorage const&>(*m_storage).sparse_elements())
                 callback(element.value.value);
@@ -56,6 +56,7 @@ struct CacheablePropertyMetadata {
 class Object : public Cell {
     JS_CELL(Object, Cell);
     JS_DECLARE_ALLOCATOR(Object);
+    JS_DECLARE_PRECISE_WRITE_BARRIERS(Object);
 
 public:
     static NonnullGCPtr<Object> create_prototype(Realm&, Object* prototype);
@@ -209,11 +210,21 @@ public:
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
-    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void put_direct(size_t index, Value value)
+    {
+        m_storage[index] = value;
+        if (value.is_cell())
+            write_barrier(&value.as_cell());
+    }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        for (auto value : values)
+            write_barrier(value);
+        m_indexed_properties = IndexedProperties(move(values));
+    }
 
     Shape& shape() { return *m_shape; }
     Shape const& shape() const { return *m_shape; }
@@ -254,7 +265,11 @@ protected:
     bool m_is_typed_array { false };
 
 private:
-    void set_shape(Shape& shape) { m_shape = &shape; }
+    void set_shape(Shape& shape)
+    {
+        m_shape = &shape;
+        write_barrier(&shape);
+    }
 
     Object* prototype() { return shape().prototype(); }
 
@@ -43,8 +43,13 @@ PrimitiveString::PrimitiveString(Utf16String string)
 {
 }
 
-PrimitiveString::~PrimitiveString()
+PrimitiveString::~PrimitiveString() = default;
+
+void PrimitiveString::finalize()
 {
+    Base::finalize();
+
+    // NOTE: This can't wait for the destructor, as that may run long after the collection that found us dead.
     if (has_utf8_string())
         vm().string_cache().remove(*m_utf8_string);
     if (has_byte_string())
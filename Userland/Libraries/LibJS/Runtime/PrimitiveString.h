@@ -23,6 +23,7 @@ namespace JS {
 class PrimitiveString final : public Cell {
     JS_CELL(PrimitiveString, Cell);
     JS_DECLARE_ALLOCATOR(PrimitiveString);
+    JS_DECLARE_PRECISE_WRITE_BARRIERS(PrimitiveString);
 
 public:
     [[nodiscard]] static NonnullGCPtr<PrimitiveString> create(VM&, Utf16String);
@@ -60,6 +61,7 @@ private:
     explicit PrimitiveString(Utf16String);
 
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual void finalize() override;
 
     enum class EncodingPreference {
         UTF8,
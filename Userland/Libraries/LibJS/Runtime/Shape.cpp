@@ -100,6 +100,12 @@ GCPtr<Shape> Shape::get_or_prune_cached_prototype_transition(Object* prototype)
     return it->value.ptr();
 }
 
+void Shape::write_barrier_for_property_key(StringOrSymbol const& property_key)
+{
+    if (property_key.is_symbol())
+        write_barrier(const_cast<Symbol*>(property_key.as_symbol()));
+}
+
 NonnullGCPtr<Shape> Shape::create_put_transition(StringOrSymbol const& property_key, PropertyAttributes attributes)
 {
     TransitionKey key { property_key, attributes };
@@ -111,6 +117,7 @@ NonnullGCPtr<Shape> Shape::create_put_transition(StringOrSymbol const& property_
         if (!m_forward_transitions)
             m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
         m_forward_transitions->set(key, new_shape.ptr());
+        write_barrier_for_property_key(property_key);
     }
     return new_shape;
 }
@@ -126,6 +133,7 @@ NonnullGCPtr<Shape> Shape::create_configure_transition(StringOrSymbol const& pro
         if (!m_forward_transitions)
             m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
         m_forward_transitions->set(key, new_shape.ptr());
+        write_barrier_for_property_key(property_key);
     }
     return new_shape;
 }
@@ -279,6 +287,7 @@ NonnullGCPtr<Shape> Shape::create_delete_transition(StringOrSymbol const& proper
     if (!m_delete_transitions)
         m_delete_transitions = make<HashMap<StringOrSymbol, WeakPtr<Shape>>>();
     m_delete_transitions->set(property_key, new_shape.ptr());
+    write_barrier_for_property_key(property_key);
     return new_shape;
 }
 
@@ -352,6 +361,7 @@ void Shape::set_prototype_without_transition(Object* new_prototype)
     VERIFY(new_prototype);
     new_prototype->convert_to_prototype_if_needed();
     m_prototype = new_prototype;
+    write_barrier(new_prototype);
 }
 
 void Shape::set_prototype_shape()
@@ -360,6 +370,7 @@ void Shape::set_prototype_shape()
     s_all_prototype_shapes.set(this);
     m_is_prototype_shape = true;
     m_prototype_chain_validity = heap().allocate_without_realm<PrototypeChainValidity>();
+    write_barrier(m_prototype_chain_validity.ptr());
 }
 
 void Shape::invalidate_prototype_if_needed_for_new_prototype(NonnullGCPtr<Shape> new_prototype_shape)
@@ -376,7 +387,8 @@ void Shape::invalidate_all_prototype_chains_leading_to_this()
 {
     HashTable<Shape*> shapes_to_invalidate;
     for (auto& candidate : s_all_prototype_shapes) {
-        if (!candidate->m_prototype)
+        // NOTE: Dead shapes awaiting a lazy sweep are still in the set, but their prototype may already be gone.
+        if (candidate->state() != Cell::State::Live || !candidate->m_prototype)
             continue;
         for (auto* current_prototype_shape = &candidate->m_prototype->shape(); current_prototype_shape; current_prototype_shape = current_prototype_shape->prototype() ? &current_prototype_shape->prototype()->shape() : nullptr) {
             if (current_prototype_shape == this) {
@@ -391,6 +403,7 @@ void Shape::invalidate_all_prototype_chains_leading_to_this()
     for (auto* shape : shapes_to_invalidate) {
         shape->m_prototype_chain_validity->set_valid(false);
         shape->m_prototype_chain_validity = heap().allocate_without_realm<PrototypeChainValidity>();
+        shape->write_barrier(shape->m_prototype_chain_validity.ptr());
     }
 }
 
@@ -37,6 +37,7 @@ struct TransitionKey {
 class PrototypeChainValidity final : public Cell {
     JS_CELL(PrototypeChainValidity, Cell);
     JS_DECLARE_ALLOCATOR(PrototypeChainValidity);
+    JS_DECLARE_PRECISE_WRITE_BARRIERS(PrototypeChainValidity);
 
 public:
     [[nodiscard]] bool is_valid() const { return m_valid; }
@@ -50,6 +51,7 @@ private:
 class Shape final : public Cell {
     JS_CELL(Shape, Cell);
     JS_DECLARE_ALLOCATOR(Shape);
+    JS_DECLARE_PRECISE_WRITE_BARRIERS(Shape);
 
 public:
     virtual ~Shape() override;
@@ -114,6 +116,8 @@ private:
     void invalidate_prototype_if_needed_for_new_prototype(NonnullGCPtr<Shape> new_prototype_shape);
     void invalidate_all_prototype_chains_leading_to_this();
 
+    void write_barrier_for_property_key(StringOrSymbol const&);
+
     virtual void visit_edges(Visitor&) override;
 
     [[nodiscard]] GCPtr<Shape> get_or_prune_cached_forward_transition(TransitionKey const&);
@@ -5,6 +5,7 @@
  */
 
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
 #include <LibJS/Lexer.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Runtime/VM.h>
@@ -18,14 +19,28 @@ JS_DEFINE_ALLOCATOR(Script);
 Result<NonnullGCPtr<Script>, Vector<ParserError>> Script::parse(StringView source_text, Realm& realm, StringView filename, HostDefined* host_defined, size_t line_number_offset)
 {
     // 1. Let script be ParseText(sourceText, Script).
+    // 2. If script is a List of errors, return body.
+    auto script = TRY(parse_program(source_text, filename, line_number_offset));
+
+    // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
+    return create(realm, filename, move(script), host_defined);
+}
+
+Result<NonnullRefPtr<Program>, Vector<ParserError>> Script::parse_program(StringView source_text, StringView filename, size_t line_number_offset)
+{
     auto parser = Parser(Lexer(source_text, filename, line_number_offset));
+    if (Bytecode::BytecodeCache::is_enabled())
+        parser.record_nodes_referenced_by_bytecode();
+    if (g_parse_function_bodies_lazily)
+        parser.parse_function_bodies_lazily();
     auto script = parser.parse_program();
-
-    // 2. If script is a List of errors, return body.
     if (parser.has_errors())
         return parser.errors();
+    return script;
+}
 
-    // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
+NonnullGCPtr<Script> Script::create(Realm& realm, StringView filename, NonnullRefPtr<Program> script, HostDefined* host_defined)
+{
     return realm.heap().allocate_without_realm<Script>(realm, filename, move(script), host_defined);
 }
 
@@ -29,6 +29,11 @@ public:
     virtual ~Script() override;
     static Result<NonnullGCPtr<Script>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, HostDefined* = nullptr, size_t line_number_offset = 1);
 
+    // ParseScript split in two: parsing doesn't need a realm, and can therefore happen on another thread (see BackgroundParser),
+    // while creating the Script Record allocates from the realm's heap.
+    static Result<NonnullRefPtr<Program>, Vector<ParserError>> parse_program(StringView source_text, StringView filename = {}, size_t line_number_offset = 1);
+    static NonnullGCPtr<Script> create(Realm&, StringView filename, NonnullRefPtr<Program>, HostDefined* = nullptr);
+
     Realm& realm() { return *m_realm; }
     Program const& parse_node() const { return *m_parse_node; }
     Vector<ModuleWithSpecifier>& loaded_modules() { return m_loaded_modules; }
@@ -7,6 +7,7 @@
 
 #include <AK/Debug.h>
 #include <AK/QuickSort.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Runtime/AsyncFunctionDriverWrapper.h>
@@ -127,13 +128,27 @@ void SourceTextModule::visit_edges(Cell::Visitor& visitor)
 Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> SourceTextModule::parse(StringView source_text, Realm& realm, StringView filename, Script::HostDefined* host_defined)
 {
     // 1. Let body be ParseText(sourceText, Module).
+    // 2. If body is a List of errors, return body.
+    auto body = TRY(parse_program(source_text, filename));
+
+    return create(realm, filename, move(body), host_defined);
+}
+
+Result<NonnullRefPtr<Program>, Vector<ParserError>> SourceTextModule::parse_program(StringView source_text, StringView filename)
+{
     auto parser = Parser(Lexer(source_text, filename), Program::Type::Module);
+    if (Bytecode::BytecodeCache::is_enabled())
+        parser.record_nodes_referenced_by_bytecode();
+    if (g_parse_function_bodies_lazily)
+        parser.parse_function_bodies_lazily();
     auto body = parser.parse_program();
-
-    // 2. If body is a List of errors, return body.
     if (parser.has_errors())
         return parser.errors();
+    return body;
+}
 
+NonnullGCPtr<SourceTextModule> SourceTextModule::create(Realm& realm, StringView filename, NonnullRefPtr<Program> body, Script::HostDefined* host_defined)
+{
     // 3. Let requestedModules be the ModuleRequests of body.
     auto requested_modules = module_requests(*body);
 
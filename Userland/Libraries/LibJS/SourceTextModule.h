@@ -21,6 +21,10 @@ class SourceTextModule final : public CyclicModule {
 public:
     static Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, Script::HostDefined* host_defined = nullptr);
 
+    // ParseModule split in two, like Script::parse_program() and Script::create().
+    static Result<NonnullRefPtr<Program>, Vector<ParserError>> parse_program(StringView source_text, StringView filename = {});
+    static NonnullGCPtr<SourceTextModule> create(Realm&, StringView filename, NonnullRefPtr<Program> body, Script::HostDefined* host_defined = nullptr);
+
     Program const& parse_node() const { return *m_ecmascript_code; }
 
     virtual ThrowCompletionOr<Vector<DeprecatedFlyString>> get_exported_names(VM& vm, Vector<Module*> export_star_set) override;
@@ -0,0 +1,73 @@
+describe("normal behavior", () => {
+    test("int32 elements turn into doubles", () => {
+        var a = [1, 2, 3];
+        a.push(4.5);
+        a[0] = -0;
+        expect(a).toEqual([-0, 2, 3, 4.5]);
+        expect(Object.is(a[0], -0)).toBeTrue();
+    });
+
+    test("int32 values stored into double elements read back as the same numbers", () => {
+        var a = [0.5, 1.5];
+        a[1] = 4;
+        a.push(-7, 2147483647, -2147483648);
+        expect(a).toEqual([0.5, 4, -7, 2147483647, -2147483648]);
+        expect(a.indexOf(4)).toBe(1);
+        expect(a.includes(-7)).toBeTrue();
+        expect(Object.is(a[1] | 0, 4)).toBeTrue();
+    });
+
+    test("storing a non-number keeps every element", () => {
+        var a = [1, 2.5, NaN];
+        a[1] = "foo";
+        a.push(null);
+        expect(a).toEqual([1, "foo", NaN, null]);
+    });
+
+    test("holes are not filled in", () => {
+        var a = [1, 2, 3];
+        a[5] = 6;
+        expect(a).toHaveLength(6);
+        expect(3 in a).toBeFalse();
+        expect(a.indexOf(undefined)).toBe(-1);
+
+        var b = [1, 2, 3];
+        delete b[1];
+        expect(1 in b).toBeFalse();
+        expect(b.indexOf(2)).toBe(-1);
+
+        var c = [1.5, 2.5];
+        c.length = 4;
+        expect(2 in c).toBeFalse();
+        c.length = 1;
+        expect(c).toEqual([1.5]);
+    });
+
+    test("searching numbers", () => {
+        var a = [1, 2, 3, 2];
+        expect(a.indexOf(2)).toBe(1);
+        expect(a.lastIndexOf(2)).toBe(3);
+        expect(a.indexOf(2.5)).toBe(-1);
+        expect(a.indexOf("2")).toBe(-1);
+        expect(a.includes(-0)).toBeFalse();
+        expect(a.indexOf(2, -1)).toBe(3);
+
+        var b = [0.5, NaN, -0];
+        expect(b.indexOf(NaN)).toBe(-1);
+        expect(b.lastIndexOf(NaN)).toBe(-1);
+        expect(b.includes(NaN)).toBeTrue();
+        expect(b.indexOf(0)).toBe(2);
+    });
+
+    test("searching past the end falls back to the prototype chain", () => {
+        var a = [1, 2, 3];
+        a.length = 4;
+        Array.prototype[3] = 4;
+        try {
+            expect(a.indexOf(4)).toBe(3);
+            expect(a.includes(4)).toBeTrue();
+        } finally {
+            delete Array.prototype[3];
+        }
+    });
+});
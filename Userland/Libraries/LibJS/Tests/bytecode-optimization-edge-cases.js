@@ -0,0 +1,112 @@
+test("Constant expressions", () => {
+    expect(1 + 2 * 3).toBe(7);
+    expect(2 ** 10 - 1).toBe(1023);
+    expect(7 % 3).toBe(1);
+    expect(1 / 0).toBe(Infinity);
+    expect(-(0 * 1)).toBe(-0);
+    expect(~5).toBe(-6);
+    expect(!0).toBeTrue();
+    expect(+true).toBe(1);
+    expect(null == undefined).toBeTrue();
+    expect(null === undefined).toBeFalse();
+    expect(1 < 2 ? "yes" : "no").toBe("yes");
+    expect(null ?? 42).toBe(42);
+    expect(undefined?.foo).toBeUndefined();
+});
+
+test("Constant strings are not folded into numbers", () => {
+    expect(1 + "2").toBe("12");
+    expect("3" * "4").toBe(12);
+});
+
+test("Negated conditions", () => {
+    function f(x) {
+        if (!x) return "falsy";
+        return "truthy";
+    }
+    expect(f(0)).toBe("falsy");
+    expect(f("")).toBe("falsy");
+    expect(f(1)).toBe("truthy");
+    expect(f({})).toBe("truthy");
+});
+
+test("Strict comparisons with undefined", () => {
+    function f(x) {
+        if (x === undefined) return "undefined";
+        if (undefined !== x) return "defined";
+        return "unreachable";
+    }
+    expect(f()).toBe("undefined");
+    expect(f(undefined)).toBe("undefined");
+    expect(f(null)).toBe("defined");
+    expect(f(0)).toBe("defined");
+});
+
+test("Results of operations stored in variables", () => {
+    let a = 5;
+    let b = a * 2;
+    let c = b - a;
+    a = a + c;
+    expect(a).toBe(10);
+    expect(b).toBe(10);
+    expect(c).toBe(5);
+});
+
+test("Loops with break and continue inside try/finally", () => {
+    let log = [];
+    for (let i = 0; i < 5; ++i) {
+        try {
+            if (i === 1) continue;
+            if (i === 3) break;
+            log.push(i);
+        } finally {
+            log.push("f" + i);
+        }
+    }
+    expect(log).toEqual([0, "f0", "f1", 2, "f2", "f3"]);
+});
+
+test("Empty loops and unreachable code", () => {
+    let i = 0;
+    while (true) {
+        if (++i > 3) break;
+    }
+    expect(i).toBe(4);
+
+    function f() {
+        return 1;
+        // eslint-disable-next-line no-unreachable
+        return 2;
+    }
+    expect(f()).toBe(1);
+});
+
+test("Generators keep their values across yields", () => {
+    function* g() {
+        let a = 1;
+        let b = yield a;
+        let c = a + b;
+        yield c;
+        return !c;
+    }
+    const it = g();
+    expect(it.next().value).toBe(1);
+    expect(it.next(41).value).toBe(42);
+    expect(it.next()).toEqual({ value: false, done: true });
+});
+
+test("Exceptions thrown in the middle of a block", () => {
+    function f(o) {
+        let result = "start";
+        try {
+            result = "before";
+            o.missing.property;
+            result = "after";
+        } catch {
+            return result;
+        }
+        return result;
+    }
+    expect(f({})).toBe("before");
+    expect(f({ missing: {} })).toBe("after");
+});
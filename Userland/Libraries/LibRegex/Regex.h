@@ -7,5 +7,6 @@
 #pragma once
 
 #include <LibRegex/Forward.h>
+#include <LibRegex/RegexCache.h>
 #include <LibRegex/RegexDebug.h>
 #include <LibRegex/RegexMatcher.h>
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibRegex/RegexCache.h>
+
+namespace regex {
+
+template<class Parser>
+PatternCache<Parser>& PatternCache<Parser>::the()
+{
+    static PatternCache cache;
+    return cache;
+}
+
+template<class Parser>
+Optional<regex::Parser::Result> PatternCache<Parser>::get(StringView pattern, typename ParserTraits<Parser>::OptionsType options)
+{
+    Threading::MutexLocker locker(m_mutex);
+
+    auto it = m_entries.find(make_key(pattern, options));
+    if (it == m_entries.end())
+        return {};
+
+    auto& entry = *it->value;
+    m_recently_used.prepend(entry);
+    return entry.result;
+}
+
+template<class Parser>
+void PatternCache<Parser>::set(StringView pattern, typename ParserTraits<Parser>::OptionsType options, regex::Parser::Result const& result)
+{
+    if (result.error != Error::NoError)
+        return;
+
+    Threading::MutexLocker locker(m_mutex);
+
+    auto key = make_key(pattern, options);
+    if (m_entries.contains(key))
+        return;
+
+    if (m_entries.size() >= capacity) {
+        auto* least_recently_used = m_recently_used.take_last();
+        m_entries.remove(least_recently_used->key);
+    }
+
+    auto entry = adopt_own(*new Entry { key, result, {} });
+    m_recently_used.prepend(*entry);
+    m_entries.set(move(key), move(entry));
+}
+
+template<class Parser>
+bool PatternCache<Parser>::contains(StringView pattern, typename ParserTraits<Parser>::OptionsType options)
+{
+    Threading::MutexLocker locker(m_mutex);
+    return m_entries.contains(make_key(pattern, options));
+}
+
+template<class Parser>
+size_t PatternCache<Parser>::size()
+{
+    Threading::MutexLocker locker(m_mutex);
+    return m_entries.size();
+}
+
+template<class Parser>
+void PatternCache<Parser>::clear()
+{
+    Threading::MutexLocker locker(m_mutex);
+    m_recently_used.clear();
+    m_entries.clear();
+}
+
+template class PatternCache<PosixBasicParser>;
+template class PatternCache<PosixExtendedParser>;
+template class PatternCache<ECMA262Parser>;
+
+}
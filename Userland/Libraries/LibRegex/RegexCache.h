@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexParser.h"
+
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <LibThreading/Mutex.h>
+
+namespace regex {
+
+// A process-wide cache of parsed and optimized patterns, so that constructing the same Regex over and over again (e.g.
+// a RegExp literal in a loop) doesn't have to go through the parser and optimizer each time.
+//
+// Entries are keyed by pattern and options, and there is one cache per parser type. Only the compiled pattern is
+// shared, each Regex still gets its own copy along with its own matcher and match state.
+template<class Parser>
+class PatternCache {
+public:
+    static constexpr size_t capacity = 256;
+
+    static PatternCache& the();
+
+    Optional<regex::Parser::Result> get(StringView pattern, typename ParserTraits<Parser>::OptionsType);
+    // NOTE: Patterns that failed to parse are not cached, as their error token points into the pattern they came from.
+    void set(StringView pattern, typename ParserTraits<Parser>::OptionsType, regex::Parser::Result const&);
+
+    bool contains(StringView pattern, typename ParserTraits<Parser>::OptionsType);
+    size_t size();
+    void clear();
+
+private:
+    struct Key {
+        ByteString pattern;
+        FlagsUnderlyingType options { 0 };
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public DefaultTraits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(key.pattern.hash(), key.options); }
+    };
+
+    struct Entry {
+        Key key;
+        regex::Parser::Result result;
+        IntrusiveListNode<Entry> list_node;
+    };
+
+    PatternCache() = default;
+
+    static Key make_key(StringView pattern, typename ParserTraits<Parser>::OptionsType options)
+    {
+        return { pattern, static_cast<FlagsUnderlyingType>(options.value()) };
+    }
+
+    Threading::Mutex m_mutex;
+    HashMap<Key, NonnullOwnPtr<Entry>, KeyTraits> m_entries;
+    // Most recently used first.
+    IntrusiveList<&Entry::list_node> m_recently_used;
+};
+
+}
@@ -0,0 +1,476 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <LibRegex/RegexDFA.h>
+
+// U+2028 LINE SEPARATOR
+constexpr static u32 const LineSeparator { 0x2028 };
+// U+2029 PARAGRAPH SEPARATOR
+constexpr static u32 const ParagraphSeparator { 0x2029 };
+
+namespace regex {
+
+// The cache is flushed whenever it grows beyond this many states. Patterns that keep on flushing it are better off
+// with the VM.
+static constexpr size_t max_state_count = 1024;
+static constexpr size_t max_flush_count_per_run = 8;
+
+static bool is_compatible_compare(ByteCode const& bytecode, size_t instruction_position)
+{
+    auto argument_count = bytecode.at(instruction_position + 1);
+    size_t offset = instruction_position + 3;
+    for (size_t i = 0; i < argument_count; ++i) {
+        switch ((CharacterCompareType)bytecode.at(offset++)) {
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+        case CharacterCompareType::And:
+        case CharacterCompareType::Or:
+        case CharacterCompareType::EndAndOr:
+            break;
+        case CharacterCompareType::Char:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+        case CharacterCompareType::Property:
+        case CharacterCompareType::GeneralCategory:
+        case CharacterCompareType::Script:
+        case CharacterCompareType::ScriptExtension:
+            ++offset;
+            break;
+        case CharacterCompareType::LookupTable:
+            offset += 1 + bytecode.at(offset);
+            break;
+        case CharacterCompareType::String: {
+            // Strings are matched one character at a time, which only works as long as each of them is a single code
+            // unit that is compared in the same way as the VM does, see LazyDFA::compute_transition().
+            if (argument_count != 1)
+                return false;
+            auto length = bytecode.at(offset++);
+            if (length == 0)
+                return false;
+            for (size_t j = 0; j < length; ++j) {
+                if (bytecode.at(offset + j) >= 0x80)
+                    return false;
+            }
+            offset += length;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_string_compare(ByteCode const& bytecode, size_t instruction_position)
+{
+    return bytecode.at(instruction_position + 1) == 1
+        && (CharacterCompareType)bytecode.at(instruction_position + 3) == CharacterCompareType::String;
+}
+
+bool LazyDFA::is_compatible(ByteCode const& bytecode)
+{
+    MatchState state;
+    auto bytecode_size = bytecode.size();
+    while (state.instruction_position < bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (!is_compatible_compare(bytecode, state.instruction_position))
+                return false;
+            break;
+        // NOTE: The optimizer only turns a fork into a ForkReplace where backtracking into the loop can't lead to a
+        //       match, so the DFA treats them like regular forks.
+        case OpCodeId::Jump:
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceJump:
+        case OpCodeId::ForkReplaceStay:
+        case OpCodeId::Checkpoint:
+        case OpCodeId::JumpNonEmpty:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+            break;
+        default:
+            return false;
+        }
+        state.instruction_position += opcode.size();
+    }
+    return true;
+}
+
+LazyDFA::Result LazyDFA::run(ByteCode const& bytecode, MatchInput const& input, size_t position)
+{
+    Result result;
+    auto const& view = input.view;
+    if (m_has_given_up || view.unicode() || !(view.is_string_view() || view.is_u16_view()))
+        return result;
+
+    auto* state = start_state(bytecode, input, position);
+    if (!state)
+        return result;
+
+    auto found_match = [&](size_t end_position) {
+        result.outcome = Outcome::Match;
+        result.end_position = end_position;
+        // Any match will do when looking for one anywhere.
+        return m_mode == Mode::Unanchored;
+    };
+
+    result.outcome = Outcome::NoMatch;
+    if (state->has_match && found_match(position))
+        return result;
+
+    size_t flush_count = 0;
+    auto length = view.length();
+    // NOTE: Without any threads left, an anchored search is over. An unanchored one starts new threads at every position.
+    for (; position < length && (m_mode == Mode::Unanchored || !state->threads.is_empty()); ++position) {
+        auto code_unit = view.code_unit_at(position);
+        if (view.is_u16_view() && is_unicode_surrogate(code_unit))
+            return { Outcome::GaveUp, 0, result.steps };
+        ++result.steps;
+
+        if (m_states.size() >= max_state_count) {
+            if (++flush_count > max_flush_count_per_run)
+                return { Outcome::GaveUp, 0, result.steps };
+            StateBuilder builder;
+            builder.threads = state->threads;
+            builder.has_match = state->has_match;
+            auto at_line_start = state->at_line_start;
+            flush();
+            state = intern(move(builder), at_line_start);
+        }
+
+        auto transition = this->transition(bytecode, input, *state, position, code_unit);
+        if (!transition.has_value())
+            return { Outcome::GaveUp, 0, result.steps };
+        if (transition->matched_before_advancing && found_match(position))
+            return result;
+        state = transition->next;
+        if (state->has_match && found_match(position + 1))
+            return result;
+    }
+
+    if (position == length && !state->threads.is_empty()) {
+        if (!state->matches_at_end.has_value()) {
+            auto matches_at_end = compute_matches_at_end(bytecode, input, *state);
+            if (m_has_given_up)
+                return { Outcome::GaveUp, 0, result.steps };
+            state->matches_at_end = matches_at_end;
+        }
+        if (*state->matches_at_end)
+            found_match(length);
+    }
+
+    return result;
+}
+
+LazyDFA::State* LazyDFA::start_state(ByteCode const& bytecode, MatchInput const& input, size_t position)
+{
+    auto at_line_start = is_at_line_start(input, position);
+    auto& state = m_start_states[at_line_start];
+    if (!state) {
+        StateBuilder builder;
+        if (!add_closure(bytecode, input, builder, 0, position, CheckEndHandling::Wait))
+            return nullptr;
+        state = intern(move(builder), at_line_start);
+    }
+    return state;
+}
+
+Optional<LazyDFA::Transition> LazyDFA::transition(ByteCode const& bytecode, MatchInput const& input, State& state, size_t position, u32 code_unit)
+{
+    if (code_unit < state.byte_transitions.size()) {
+        if (state.byte_transitions[code_unit].next)
+            return state.byte_transitions[code_unit];
+    } else if (auto transition = state.other_transitions.get(code_unit); transition.has_value()) {
+        return *transition;
+    }
+
+    auto transition = compute_transition(bytecode, input, state, position, code_unit);
+    if (!transition.has_value())
+        return {};
+
+    if (code_unit < state.byte_transitions.size())
+        state.byte_transitions[code_unit] = *transition;
+    else
+        state.other_transitions.set(code_unit, *transition);
+    return transition;
+}
+
+// NOTE: Everything the VM looks at while stepping over a character only depends on the state and on that character,
+//       so the transition is computed by running the opcodes on the actual input once, and then reused elsewhere.
+Optional<LazyDFA::Transition> LazyDFA::compute_transition(ByteCode const& bytecode, MatchInput const& input, State const& state, size_t position, u32 code_unit)
+{
+    StateBuilder next;
+    // Threads that continue at the current position, after a pending CheckEnd succeeded.
+    StateBuilder resumed;
+    bool matched_before_advancing = false;
+
+    auto advance = [&](Thread const& thread) {
+        m_scratch_state.instruction_position = thread.instruction_position;
+        auto& opcode = bytecode.get_opcode(m_scratch_state);
+        VERIFY(opcode.opcode_id() == OpCodeId::Compare);
+        auto next_instruction_position = thread.instruction_position + opcode.size();
+
+        if (is_string_compare(bytecode, thread.instruction_position)) {
+            auto length = bytecode.at(thread.instruction_position + 4);
+            u32 expected = bytecode.at(thread.instruction_position + 5 + thread.string_offset);
+            bool equal = m_options.has_flag_set(AllFlags::Insensitive)
+                ? to_ascii_lowercase(code_unit) == to_ascii_lowercase(expected)
+                : code_unit == expected;
+            if (!equal)
+                return true;
+            if (thread.string_offset + 1 < length) {
+                Thread next_thread { thread.instruction_position, thread.string_offset + 1, {} };
+                if (next.thread_keys.set({ next_thread.instruction_position, next_thread.string_offset, 0 }) == HashSetResult::InsertedNewEntry)
+                    next.threads.append(move(next_thread));
+                return true;
+            }
+            return add_closure(bytecode, input, next, next_instruction_position, position + 1, CheckEndHandling::Wait);
+        }
+
+        m_scratch_state.string_position = position;
+        m_scratch_state.string_position_in_code_units = position;
+        if (opcode.execute(input, m_scratch_state) != ExecutionResult::Continue)
+            return true;
+        if (m_scratch_state.string_position != position + 1) {
+            m_has_given_up = true;
+            return false;
+        }
+        return add_closure(bytecode, input, next, next_instruction_position, position + 1, CheckEndHandling::Wait);
+    };
+
+    for (auto const& thread : state.threads) {
+        if (next.has_match)
+            break;
+
+        if ((OpCodeId)bytecode.at(thread.instruction_position) != OpCodeId::CheckEnd) {
+            if (!advance(thread))
+                return {};
+            continue;
+        }
+
+        if (!evaluate_assertion(bytecode, input, thread.instruction_position, position))
+            continue;
+        auto first_resumed_thread = resumed.threads.size();
+        if (!add_closure(bytecode, input, resumed, thread.instruction_position + 1, position, CheckEndHandling::Evaluate, thread.checkpoints))
+            return {};
+        for (size_t i = first_resumed_thread; i < resumed.threads.size() && !next.has_match; ++i) {
+            if (!advance(resumed.threads[i]))
+                return {};
+        }
+        if (resumed.has_match) {
+            matched_before_advancing = true;
+            break;
+        }
+    }
+
+    if (m_mode == Mode::Unanchored && !next.has_match) {
+        if (!add_closure(bytecode, input, next, 0, position + 1, CheckEndHandling::Wait))
+            return {};
+    }
+
+    auto at_line_start = m_options.has_flag_set(AllFlags::Multiline)
+        && m_options.has_flag_set(AllFlags::Internal_ConsiderNewline)
+        && is_line_terminator(code_unit);
+    return Transition { intern(move(next), at_line_start), matched_before_advancing };
+}
+
+bool LazyDFA::compute_matches_at_end(ByteCode const& bytecode, MatchInput const& input, State const& state)
+{
+    auto length = input.view.length();
+    StateBuilder resumed;
+    for (auto const& thread : state.threads) {
+        if ((OpCodeId)bytecode.at(thread.instruction_position) != OpCodeId::CheckEnd)
+            continue;
+        if (!evaluate_assertion(bytecode, input, thread.instruction_position, length))
+            continue;
+        if (!add_closure(bytecode, input, resumed, thread.instruction_position + 1, length, CheckEndHandling::Evaluate, thread.checkpoints))
+            return false;
+        if (resumed.has_match)
+            return true;
+    }
+    return false;
+}
+
+// Follows everything that doesn't consume any input from the given instruction, and adds the threads that end up
+// waiting for input to the builder in the order the VM would get to them. Returns false if the DFA had to give up.
+bool LazyDFA::add_closure(ByteCode const& bytecode, MatchInput const& input, StateBuilder& builder, size_t instruction_position, size_t position, CheckEndHandling check_end_handling, Vector<u64, 1> checkpoints)
+{
+    struct PendingInstruction {
+        size_t instruction_position;
+        // The checkpoints that have been passed at this position, which tell JumpNonEmpty that an iteration was empty.
+        Vector<u64, 1> checkpoints;
+    };
+    Vector<PendingInstruction> stack;
+    stack.append({ instruction_position, move(checkpoints) });
+
+    auto add_thread = [&](Thread thread) {
+        Vector<u64> key { thread.instruction_position, thread.string_offset, thread.checkpoints.size() };
+        key.extend(thread.checkpoints);
+        if (builder.thread_keys.set(move(key)) == HashSetResult::InsertedNewEntry)
+            builder.threads.append(move(thread));
+    };
+
+    auto bytecode_size = bytecode.size();
+    // NOTE: Once a match is found, the VM never gets to anything with a lower priority, so we can stop right there.
+    while (!stack.is_empty() && !builder.has_match) {
+        auto current = stack.take_last();
+
+        Vector<u64> visited_key { current.instruction_position };
+        visited_key.extend(current.checkpoints);
+        if (builder.visited.set(move(visited_key)) != HashSetResult::InsertedNewEntry)
+            continue;
+
+        if (current.instruction_position >= bytecode_size) {
+            builder.has_match = true;
+            break;
+        }
+
+        m_scratch_state.instruction_position = current.instruction_position;
+        auto& opcode = bytecode.get_opcode(m_scratch_state);
+        auto next_instruction_position = current.instruction_position + opcode.size();
+
+        // NOTE: The stack is LIFO, so the alternative that the VM tries first has to be pushed last.
+        auto fork = [&](size_t first, size_t second) {
+            stack.append({ second, current.checkpoints });
+            stack.append({ first, move(current.checkpoints) });
+        };
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            add_thread({ current.instruction_position, 0, {} });
+            break;
+        case OpCodeId::Jump:
+            stack.append({ next_instruction_position + static_cast<OpCode_Jump const&>(opcode).offset(), move(current.checkpoints) });
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            fork(next_instruction_position + static_cast<OpCode_ForkJump const&>(opcode).offset(), next_instruction_position);
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            fork(next_instruction_position, next_instruction_position + static_cast<OpCode_ForkStay const&>(opcode).offset());
+            break;
+        case OpCodeId::Checkpoint: {
+            auto id = static_cast<OpCode_Checkpoint const&>(opcode).id();
+            if (!current.checkpoints.contains_slow(id))
+                current.checkpoints.append(id);
+            stack.append({ next_instruction_position, move(current.checkpoints) });
+            break;
+        }
+        case OpCodeId::JumpNonEmpty: {
+            auto const& jump = static_cast<OpCode_JumpNonEmpty const&>(opcode);
+            auto target = next_instruction_position + jump.offset();
+            if (current.checkpoints.contains_slow(jump.checkpoint())) {
+                stack.append({ next_instruction_position, move(current.checkpoints) });
+                break;
+            }
+            switch (jump.form()) {
+            case OpCodeId::Jump:
+                stack.append({ target, move(current.checkpoints) });
+                break;
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkReplaceJump:
+                fork(target, next_instruction_position);
+                break;
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceStay:
+                fork(next_instruction_position, target);
+                break;
+            default:
+                stack.append({ next_instruction_position, move(current.checkpoints) });
+                break;
+            }
+            break;
+        }
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            stack.append({ next_instruction_position, move(current.checkpoints) });
+            break;
+        case OpCodeId::CheckBegin:
+            if (evaluate_assertion(bytecode, input, current.instruction_position, position))
+                stack.append({ next_instruction_position, move(current.checkpoints) });
+            break;
+        case OpCodeId::CheckEnd:
+            if (check_end_handling == CheckEndHandling::Wait) {
+                // Whether this succeeds depends on the next character, so the thread has to wait for it.
+                add_thread({ current.instruction_position, 0, move(current.checkpoints) });
+            } else if (evaluate_assertion(bytecode, input, current.instruction_position, position)) {
+                stack.append({ next_instruction_position, move(current.checkpoints) });
+            }
+            break;
+        default:
+            m_has_given_up = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LazyDFA::evaluate_assertion(ByteCode const& bytecode, MatchInput const& input, size_t instruction_position, size_t position)
+{
+    m_scratch_state.instruction_position = instruction_position;
+    m_scratch_state.string_position = position;
+    m_scratch_state.string_position_in_code_units = position;
+    auto& opcode = bytecode.get_opcode(m_scratch_state);
+    return opcode.execute(input, m_scratch_state) == ExecutionResult::Continue;
+}
+
+LazyDFA::State* LazyDFA::intern(StateBuilder&& builder, bool at_line_start)
+{
+    Vector<u64> key { (builder.has_match ? 1u : 0u) | (at_line_start ? 2u : 0u) };
+    for (auto const& thread : builder.threads) {
+        key.append(thread.instruction_position);
+        key.append(thread.string_offset);
+        key.append(thread.checkpoints.size());
+        key.extend(thread.checkpoints);
+    }
+
+    if (auto state = m_state_map.get(key); state.has_value())
+        return *state;
+
+    auto state = make<State>();
+    state->threads = move(builder.threads);
+    state->has_match = builder.has_match;
+    state->at_line_start = at_line_start;
+    auto* state_ptr = state.ptr();
+    m_states.append(move(state));
+    m_state_map.set(move(key), state_ptr);
+    return state_ptr;
+}
+
+// NOTE: This has to agree with OpCode_CheckBegin, as the start state depends on it.
+bool LazyDFA::is_at_line_start(MatchInput const& input, size_t position) const
+{
+    if (position == 0)
+        return true;
+    if (!m_options.has_flag_set(AllFlags::Multiline) || !m_options.has_flag_set(AllFlags::Internal_ConsiderNewline))
+        return false;
+    return is_line_terminator(input.view.substring_view(position - 1, 1)[0]);
+}
+
+bool LazyDFA::is_line_terminator(u32 code_unit) const
+{
+    return code_unit == '\r' || code_unit == '\n' || code_unit == LineSeparator || code_unit == ParagraphSeparator;
+}
+
+void LazyDFA::flush()
+{
+    m_state_map.clear();
+    m_states.clear();
+    m_start_states = {};
+}
+
+}
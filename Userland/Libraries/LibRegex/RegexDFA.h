@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+#include "RegexOptions.h"
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+struct DFAStateKeyTraits : public DefaultTraits<Vector<u64>> {
+    static unsigned hash(Vector<u64> const& key) { return Traits<ReadonlySpan<u64>>::hash(key.span()); }
+};
+
+// A DFA that is built from the bytecode while matching, one state at a time.
+//
+// Each DFA state is the list of VM threads that are still alive at some position, in the order the backtracking VM
+// would try them. Everything after a thread that has reached the end of the bytecode is dropped, as the VM would never
+// get to it. This makes the DFA find the same match end as the VM, in time linear to the length of the input.
+//
+// Only bytecode without backreferences, lookarounds, counted repetitions and word boundaries can be simulated, and
+// capture groups are not tracked at all, see is_compatible(). The DFA also gives up on inputs it can't handle (e.g.
+// Unicode mode, or UTF-16 surrogates), in which case the caller has to fall back to the VM.
+class LazyDFA {
+public:
+    enum class Mode {
+        // Find the match that starts at the given position.
+        Anchored,
+        // Only find out whether there is a match starting at or after the given position.
+        Unanchored,
+    };
+
+    enum class Outcome {
+        NoMatch,
+        Match,
+        GaveUp,
+    };
+
+    struct Result {
+        Outcome outcome { Outcome::GaveUp };
+        size_t end_position { 0 };
+        size_t steps { 0 };
+    };
+
+    LazyDFA(Mode mode, AllOptions options)
+        : m_mode(mode)
+        , m_options(options)
+    {
+    }
+
+    static bool is_compatible(ByteCode const&);
+
+    AllOptions options() const { return m_options; }
+    bool has_given_up() const { return m_has_given_up; }
+
+    Result run(ByteCode const&, MatchInput const&, size_t position);
+
+private:
+    struct Thread {
+        size_t instruction_position { 0 };
+        // How many characters of a String comparison have been matched so far.
+        size_t string_offset { 0 };
+        // The checkpoints a thread that waits at a CheckEnd has passed at the current position.
+        Vector<u64, 1> checkpoints;
+    };
+
+    struct State;
+
+    struct Transition {
+        State* next { nullptr };
+        // Whether a match ended right before the character, because a pending CheckEnd succeeded on it.
+        bool matched_before_advancing { false };
+    };
+
+    struct State {
+        Vector<Thread> threads;
+        bool has_match { false };
+        bool at_line_start { false };
+        Optional<bool> matches_at_end;
+        Array<Transition, 256> byte_transitions {};
+        HashMap<u32, Transition> other_transitions;
+    };
+
+    struct StateBuilder {
+        Vector<Thread> threads;
+        HashTable<Vector<u64>, DFAStateKeyTraits> thread_keys;
+        HashTable<Vector<u64>, DFAStateKeyTraits> visited;
+        bool has_match { false };
+    };
+
+    enum class CheckEndHandling {
+        Wait,
+        Evaluate,
+    };
+
+    State* start_state(ByteCode const&, MatchInput const&, size_t position);
+    Optional<Transition> transition(ByteCode const&, MatchInput const&, State&, size_t position, u32 code_unit);
+    Optional<Transition> compute_transition(ByteCode const&, MatchInput const&, State const&, size_t position, u32 code_unit);
+    bool compute_matches_at_end(ByteCode const&, MatchInput const&, State const&);
+    bool add_closure(ByteCode const&, MatchInput const&, StateBuilder&, size_t instruction_position, size_t position, CheckEndHandling, Vector<u64, 1> checkpoints = {});
+    bool evaluate_assertion(ByteCode const&, MatchInput const&, size_t instruction_position, size_t position);
+    State* intern(StateBuilder&&, bool at_line_start);
+    bool is_at_line_start(MatchInput const&, size_t position) const;
+    bool is_line_terminator(u32 code_unit) const;
+    void flush();
+
+    Mode m_mode;
+    AllOptions m_options;
+    bool m_has_given_up { false };
+
+    Vector<NonnullOwnPtr<State>> m_states;
+    HashMap<Vector<u64>, State*, DFAStateKeyTraits> m_state_map;
+    Array<State*, 2> m_start_states {};
+    MatchState m_scratch_state;
+};
+
+}
@@ -8,6 +8,7 @@
 #include <AK/ByteString.h>
 #include <AK/Debug.h>
 #include <AK/StringBuilder.h>
+#include <LibRegex/RegexCache.h>
 #include <LibRegex/RegexMatcher.h>
 #include <LibRegex/RegexParser.h>
 
@@ -34,12 +35,19 @@ template<class Parser>
 Regex<Parser>::Regex(ByteString pattern, typename ParserTraits<Parser>::OptionsType regex_options)
     : pattern_value(move(pattern))
 {
-    regex::Lexer lexer(pattern_value);
+    auto& cache = PatternCache<Parser>::the();
+    if (auto cached_result = cache.get(pattern_value, regex_options); cached_result.has_value()) {
+        parser_result = cached_result.release_value();
+    } else {
+        regex::Lexer lexer(pattern_value);
 
-    Parser parser(lexer, regex_options);
-    parser_result = parser.parse();
+        Parser parser(lexer, regex_options);
+        parser_result = parser.parse();
+
+        run_optimization_passes();
+        cache.set(pattern_value, regex_options, parser_result);
+    }
 
-    run_optimization_passes();
     if (parser_result.error == regex::Error::NoError)
         matcher = make<Matcher<Parser>>(this, static_cast<decltype(regex_options.value())>(parser_result.options.value()));
 }
@@ -49,7 +57,16 @@ Regex<Parser>::Regex(regex::Parser::Result parse_result, ByteString pattern, typ
     : pattern_value(move(pattern))
     , parser_result(move(parse_result))
 {
-    run_optimization_passes();
+    // NOTE: The given result is assumed to come from parsing the pattern with the same options, so that a cached one can
+    //       be used in its place.
+    auto& cache = PatternCache<Parser>::the();
+    if (auto cached_result = cache.get(pattern_value, regex_options); cached_result.has_value()) {
+        parser_result = cached_result.release_value();
+    } else {
+        run_optimization_passes();
+        cache.set(pattern_value, regex_options, parser_result);
+    }
+
     if (parser_result.error == regex::Error::NoError)
         matcher = make<Matcher<Parser>>(this, regex_options | static_cast<decltype(regex_options.value())>(parse_result.options.value()));
 }
@@ -185,6 +202,13 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
 
     auto single_match_only = input.regex_options.has_flag_set(AllFlags::SingleMatch);
 
+    // The scanner was built for the case sensitivity of the pattern, which can be overridden for a single match.
+    CandidateScanner const* candidate_scanner = nullptr;
+    if (auto const& scanner = m_pattern->parser_result.optimization_data.candidate_scanner; scanner.has_value()) {
+        if (scanner->is_insensitive() == input.regex_options.has_flag_set(AllFlags::Insensitive))
+            candidate_scanner = &scanner.value();
+    }
+
     for (auto const& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -231,10 +255,26 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             }
         }
 
+        bool must_look_for_any_match = continue_search;
         for (; view_index <= view_length; ++view_index) {
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
+            // Skip straight to the next position that a match can start at.
+            if (continue_search && candidate_scanner) {
+                auto candidate = candidate_scanner->find_candidate(view, view_index);
+                if (!candidate.has_value())
+                    break;
+                view_index = *candidate;
+            }
+
+            // Rather than trying every single position until one matches, first make sure that one of them will.
+            if (must_look_for_any_match) {
+                must_look_for_any_match = false;
+                if (!might_match_at_or_after(input, view_index, operations))
+                    break;
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -280,6 +320,7 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
                     view_index = state.string_position - (has_zero_length ? 0 : 1);
                     if (single_match_only)
                         break;
+                    must_look_for_any_match = true;
                     continue;
                 }
                 if (input.regex_options.has_flag_set(AllFlags::Internal_Stateful)) {
@@ -439,6 +480,20 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
         return true;
     }
 
+    if (auto* dfa = lazy_dfa(LazyDFA::Mode::Anchored, input.regex_options)) {
+        auto result = dfa->run(m_pattern->parser_result.bytecode, input, state.string_position);
+        operations += result.steps;
+        if (result.outcome == LazyDFA::Outcome::NoMatch)
+            return false;
+
+        // The DFA knows where the match ends, but not where the capture groups are, that's up to the VM.
+        if (result.outcome == LazyDFA::Outcome::Match && m_pattern->parser_result.capture_groups_count == 0) {
+            state.string_position = result.end_position;
+            state.string_position_in_code_units = result.end_position;
+            return true;
+        }
+    }
+
     BumpAllocatedLinkedList<MatchState> states_to_try_next;
 #if REGEX_DEBUG
     size_t recursion_level = 0;
@@ -539,6 +594,36 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
     VERIFY_NOT_REACHED();
 }
 
+template<class Parser>
+bool Matcher<Parser>::might_match_at_or_after(MatchInput const& input, size_t position, size_t& operations) const
+{
+    if (m_pattern->parser_result.optimization_data.pure_substring_search.has_value())
+        return true;
+
+    auto* dfa = lazy_dfa(LazyDFA::Mode::Unanchored, input.regex_options);
+    if (!dfa)
+        return true;
+
+    auto result = dfa->run(m_pattern->parser_result.bytecode, input, position);
+    operations += result.steps;
+    return result.outcome != LazyDFA::Outcome::NoMatch;
+}
+
+template<class Parser>
+LazyDFA* Matcher<Parser>::lazy_dfa(LazyDFA::Mode mode, AllOptions options) const
+{
+    if (!m_pattern->parser_result.optimization_data.can_use_lazy_dfa)
+        return nullptr;
+
+    // NOTE: The options can be overridden for each match, and the DFA depends on them.
+    auto& dfa = mode == LazyDFA::Mode::Anchored ? m_anchored_dfa : m_unanchored_dfa;
+    if (!dfa || dfa->options().value() != options.value())
+        dfa = make<LazyDFA>(mode, options);
+    if (dfa->has_given_up())
+        return nullptr;
+    return dfa.ptr();
+}
+
 template class Matcher<PosixBasicParser>;
 template class Regex<PosixBasicParser>;
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "RegexByteCode.h"
+#include "RegexDFA.h"
 #include "RegexMatch.h"
 #include "RegexOptions.h"
 #include "RegexParser.h"
@@ -74,9 +75,13 @@ public:
 
 private:
     bool execute(MatchInput const& input, MatchState& state, size_t& operations) const;
+    bool might_match_at_or_after(MatchInput const& input, size_t position, size_t& operations) const;
+    LazyDFA* lazy_dfa(LazyDFA::Mode, AllOptions) const;
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
+    mutable OwnPtr<LazyDFA> m_anchored_dfa;
+    mutable OwnPtr<LazyDFA> m_unanchored_dfa;
 };
 
 template<class Parser>
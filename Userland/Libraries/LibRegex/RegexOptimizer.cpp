@@ -28,6 +28,9 @@ void Regex<Parser>::run_optimization_passes()
 {
     parser_result.bytecode.flatten();
 
+    // NOTE: This only depends on what the pattern can start with, which the rewrites below don't change.
+    parser_result.optimization_data.candidate_scanner = CandidateScanner::create(parser_result.bytecode, parser_result.options.has_flag_set(AllFlags::Insensitive));
+
     auto blocks = split_basic_blocks(parser_result.bytecode);
     if (attempt_rewrite_entire_match_as_substring_search(blocks))
         return;
@@ -37,6 +40,8 @@ void Regex<Parser>::run_optimization_passes()
     attempt_rewrite_loops_as_atomic_groups(blocks);
 
     parser_result.bytecode.flatten();
+
+    parser_result.optimization_data.can_use_lazy_dfa = LazyDFA::is_compatible(parser_result.bytecode);
 }
 
 template<typename Parser>
@@ -10,6 +10,7 @@
 #include "RegexError.h"
 #include "RegexLexer.h"
 #include "RegexOptions.h"
+#include "RegexScanner.h"
 
 #include <AK/Forward.h>
 #include <AK/StringBuilder.h>
@@ -58,6 +59,8 @@ public:
 
         struct {
             Optional<ByteString> pure_substring_search;
+            bool can_use_lazy_dfa { false };
+            Optional<CandidateScanner> candidate_scanner;
         } optimization_data {};
     };
 
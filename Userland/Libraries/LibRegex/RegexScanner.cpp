@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/HashTable.h>
+#include <AK/NumericLimits.h>
+#include <AK/QuickSort.h>
+#include <AK/SIMD.h>
+#include <LibRegex/RegexScanner.h>
+
+// Functions returning vectors or accepting vector arguments have different calling conventions
+// depending on whether the target architecture supports SSE or not. GCC generates warning "psabi"
+// when compiling for non-SSE architectures. These are all local to this translation unit.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace regex {
+
+// With more ranges than this, checking each block of input against all of them is slower than a table lookup per code unit.
+static constexpr size_t max_range_count_for_simd = 4;
+
+template<typename CodeUnit>
+struct ScannerVector;
+
+template<>
+struct ScannerVector<u8> {
+    using Type = AK::SIMD::u8x16;
+};
+
+template<>
+struct ScannerVector<u16> {
+    using Type = AK::SIMD::u16x8;
+};
+
+template<typename CodeUnit>
+using VectorFor = typename ScannerVector<CodeUnit>::Type;
+
+template<typename CodeUnit>
+static constexpr size_t lane_count = sizeof(VectorFor<CodeUnit>) / sizeof(CodeUnit);
+
+template<typename CodeUnit>
+ALWAYS_INLINE static VectorFor<CodeUnit> load(CodeUnit const* data)
+{
+    VectorFor<CodeUnit> result;
+    __builtin_memcpy(&result, data, sizeof(result));
+    return result;
+}
+
+template<typename CodeUnit>
+ALWAYS_INLINE static VectorFor<CodeUnit> splat(CodeUnit value)
+{
+    return VectorFor<CodeUnit> {} + value;
+}
+
+template<typename Mask>
+ALWAYS_INLINE static bool any(Mask mask)
+{
+    auto bits = (AK::SIMD::u64x2)mask;
+    return (bits[0] | bits[1]) != 0;
+}
+
+static u32 clamp_to_code_unit(u32 value, u32 max)
+{
+    return value > max ? max : value;
+}
+
+Optional<CandidateScanner> CandidateScanner::create(ByteCode const& bytecode, bool insensitive)
+{
+    CandidateScanner scanner { insensitive };
+
+    // Follow everything that doesn't consume any input to find the compares a match can start with.
+    // NOTE: Assertions are simply stepped over, which can only make the set of code units larger than it has to be.
+    Vector<size_t> instructions_to_visit;
+    HashTable<size_t> visited_instructions;
+    instructions_to_visit.append(0);
+
+    MatchState state;
+    auto bytecode_size = bytecode.size();
+    while (!instructions_to_visit.is_empty()) {
+        auto instruction_position = instructions_to_visit.take_last();
+        if (visited_instructions.set(instruction_position) != HashSetResult::InsertedNewEntry)
+            continue;
+
+        // Reaching the end means that the empty string matches, which it does anywhere.
+        if (instruction_position >= bytecode_size)
+            return {};
+
+        state.instruction_position = instruction_position;
+        auto& opcode = bytecode.get_opcode(state);
+        auto next_instruction_position = instruction_position + opcode.size();
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (!scanner.add_compare(bytecode, instruction_position))
+                return {};
+            break;
+        case OpCodeId::Jump:
+            instructions_to_visit.append(next_instruction_position + static_cast<OpCode_Jump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            instructions_to_visit.append(next_instruction_position + static_cast<OpCode_ForkJump const&>(opcode).offset());
+            instructions_to_visit.append(next_instruction_position);
+            break;
+        case OpCodeId::JumpNonEmpty:
+            instructions_to_visit.append(next_instruction_position + static_cast<OpCode_JumpNonEmpty const&>(opcode).offset());
+            instructions_to_visit.append(next_instruction_position);
+            break;
+        case OpCodeId::Checkpoint:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+            instructions_to_visit.append(next_instruction_position);
+            break;
+        default:
+            return {};
+        }
+    }
+
+    scanner.finalize();
+    if (scanner.m_ranges.is_empty())
+        return {};
+    // Nothing to gain from a scanner that lets every code unit through.
+    if (scanner.m_ranges.size() == 1 && scanner.m_ranges.first().from == 0 && scanner.m_ranges.first().to >= NumericLimits<u16>::max())
+        return {};
+
+    if (!insensitive)
+        scanner.find_literal_prefix(bytecode);
+
+    return scanner;
+}
+
+// NOTE: This has to accept at least everything that OpCode_Compare::execute() accepts.
+bool CandidateScanner::add_compare(ByteCode const& bytecode, size_t instruction_position)
+{
+    auto argument_count = bytecode.at(instruction_position + 1);
+    size_t offset = instruction_position + 3;
+    for (size_t i = 0; i < argument_count; ++i) {
+        switch ((CharacterCompareType)bytecode.at(offset++)) {
+        case CharacterCompareType::Char: {
+            u32 ch = bytecode.at(offset++);
+            if (m_insensitive && is_ascii_alpha(ch)) {
+                add_code_unit(to_ascii_lowercase(ch));
+                add_code_unit(to_ascii_uppercase(ch));
+            } else {
+                add_code_unit(ch);
+            }
+            break;
+        }
+        case CharacterCompareType::String: {
+            auto length = bytecode.at(offset++);
+            if (length == 0)
+                return false;
+            u32 ch = bytecode.at(offset);
+            offset += length;
+            // Strings are converted to the type of the input view before being compared, and compared ignoring case in
+            // a way that depends on the view. Only ASCII is known to survive that unchanged.
+            if (ch >= 0x80 || (m_insensitive && length > 1))
+                add_range(0x80, NumericLimits<u32>::max());
+            if (ch >= 0x80)
+                break;
+            if (m_insensitive && is_ascii_alpha(ch)) {
+                add_code_unit(to_ascii_lowercase(ch));
+                add_code_unit(to_ascii_uppercase(ch));
+            } else {
+                add_code_unit(ch);
+            }
+            break;
+        }
+        case CharacterCompareType::CharClass: {
+            auto character_class = (CharClass)bytecode.at(offset++);
+            add_ascii_code_units_matching([&](u32 ch) { return OpCode_Compare::matches_character_class(character_class, ch, m_insensitive); });
+            // Only whitespace includes anything beyond ASCII.
+            if (character_class == CharClass::Space)
+                add_range(0x80, NumericLimits<u32>::max());
+            break;
+        }
+        case CharacterCompareType::CharRange: {
+            auto range = (CharRange)bytecode.at(offset++);
+            auto from = m_insensitive ? to_ascii_lowercase(range.from) : range.from;
+            auto to = m_insensitive ? to_ascii_lowercase(range.to) : range.to;
+            add_ascii_code_units_matching([&](u32 ch) {
+                if (m_insensitive)
+                    ch = to_ascii_lowercase(ch);
+                return ch >= from && ch <= to;
+            });
+            if (to >= 0x80)
+                add_range(max(from, 0x80u), to);
+            break;
+        }
+        case CharacterCompareType::LookupTable: {
+            auto count = bytecode.at(offset++);
+            for (size_t j = 0; j < count; ++j) {
+                auto range = (CharRange)bytecode.at(offset++);
+                add_ascii_code_units_matching([&](u32 ch) {
+                    if (ch >= range.from && ch <= range.to)
+                        return true;
+                    if (!m_insensitive)
+                        return false;
+                    auto lowercase = to_ascii_lowercase(ch);
+                    auto uppercase = to_ascii_uppercase(ch);
+                    return (lowercase >= range.from && lowercase <= range.to) || (uppercase >= range.from && uppercase <= range.to);
+                });
+                if (range.to >= 0x80)
+                    add_range(max(range.from, 0x80u), range.to);
+            }
+            break;
+        }
+        default:
+            // Inversions, properties, backreferences and the like can match (almost) anything.
+            return false;
+        }
+    }
+    return true;
+}
+
+void CandidateScanner::add_range(u32 from, u32 to)
+{
+    m_ranges.append({ from, to });
+}
+
+template<typename Predicate>
+void CandidateScanner::add_ascii_code_units_matching(Predicate predicate)
+{
+    for (u32 ch = 0; ch < 0x80; ++ch) {
+        if (predicate(ch))
+            add_code_unit(ch);
+    }
+}
+
+void CandidateScanner::find_literal_prefix(ByteCode const& bytecode)
+{
+    MatchState state;
+    auto bytecode_size = bytecode.size();
+    while (state.instruction_position < bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto instruction_position = state.instruction_position;
+            if (bytecode.at(instruction_position + 1) != 1)
+                return;
+            auto compare_type = (CharacterCompareType)bytecode.at(instruction_position + 3);
+            if (compare_type == CharacterCompareType::Char) {
+                u32 ch = bytecode.at(instruction_position + 4);
+                if (ch >= 0x80)
+                    return;
+                m_literal_prefix.append(ch);
+            } else if (compare_type == CharacterCompareType::String) {
+                auto length = bytecode.at(instruction_position + 4);
+                for (size_t i = 0; i < length; ++i) {
+                    u32 ch = bytecode.at(instruction_position + 5 + i);
+                    if (ch >= 0x80)
+                        return;
+                    m_literal_prefix.append(ch);
+                }
+            } else {
+                return;
+            }
+            break;
+        }
+        case OpCodeId::Checkpoint:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            break;
+        case OpCodeId::CheckBegin:
+            if (!m_literal_prefix.is_empty())
+                return;
+            break;
+        default:
+            return;
+        }
+        state.instruction_position += opcode.size();
+    }
+}
+
+void CandidateScanner::finalize()
+{
+    quick_sort(m_ranges, [](auto& a, auto& b) { return a.from < b.from; });
+
+    Vector<Range> merged_ranges;
+    for (auto const& range : m_ranges) {
+        if (!merged_ranges.is_empty() && (merged_ranges.last().to == NumericLimits<u32>::max() || range.from <= merged_ranges.last().to + 1)) {
+            merged_ranges.last().to = max(merged_ranges.last().to, range.to);
+            continue;
+        }
+        merged_ranges.append(range);
+    }
+    m_ranges = move(merged_ranges);
+
+    for (auto const& range : m_ranges) {
+        for (u32 ch = range.from; ch <= range.to && ch < 256; ++ch)
+            m_low_code_units[ch / 64] |= 1ull << (ch % 64);
+    }
+}
+
+bool CandidateScanner::can_start_with(u32 code_unit) const
+{
+    if (code_unit < 256)
+        return m_low_code_units[code_unit / 64] & (1ull << (code_unit % 64));
+
+    for (auto const& range : m_ranges) {
+        if (code_unit < range.from)
+            return false;
+        if (code_unit <= range.to)
+            return true;
+    }
+    return false;
+}
+
+Optional<size_t> CandidateScanner::find_candidate(RegexStringView const& view, size_t position) const
+{
+    // NOTE: In Unicode mode, positions are counted in code points.
+    if (view.unicode())
+        return position;
+
+    if (view.is_string_view())
+        return find_candidate_in(view.string_view().bytes(), position);
+    if (view.is_u16_view())
+        return find_candidate_in(ReadonlySpan<u16> { view.u16_view().data(), view.length() }, position);
+    return position;
+}
+
+template<typename CodeUnit>
+Optional<size_t> CandidateScanner::find_candidate_in(ReadonlySpan<CodeUnit> haystack, size_t position) const
+{
+    if (m_literal_prefix.size() > 1)
+        return find_literal_prefix_in(haystack, position);
+
+    constexpr u32 max_code_unit = NumericLimits<CodeUnit>::max();
+    constexpr size_t lanes = lane_count<CodeUnit>;
+    auto const* data = haystack.data();
+    auto length = haystack.size();
+
+    if (m_ranges.size() <= max_range_count_for_simd) {
+        Array<VectorFor<CodeUnit>, max_range_count_for_simd> range_starts;
+        Array<VectorFor<CodeUnit>, max_range_count_for_simd> range_ends;
+        size_t range_count = 0;
+        for (auto const& range : m_ranges) {
+            if (range.from > max_code_unit)
+                break;
+            range_starts[range_count] = splat<CodeUnit>(range.from);
+            range_ends[range_count] = splat<CodeUnit>(clamp_to_code_unit(range.to, max_code_unit));
+            ++range_count;
+        }
+        if (range_count == 0)
+            return {};
+
+        for (; position + lanes <= length; position += lanes) {
+            auto block = load(data + position);
+            auto mask = (block >= range_starts[0]) & (block <= range_ends[0]);
+            for (size_t i = 1; i < range_count; ++i)
+                mask |= (block >= range_starts[i]) & (block <= range_ends[i]);
+            if (!any(mask))
+                continue;
+            for (size_t i = 0; i < lanes; ++i) {
+                if (mask[i])
+                    return position + i;
+            }
+        }
+    }
+
+    for (; position < length; ++position) {
+        if (can_start_with(data[position]))
+            return position;
+    }
+    return {};
+}
+
+// Compares the first and last code unit of the literal at each position of a block at once, and only looks at the
+// rest of it where both are equal, see http://0x80.pl/articles/simd-strfind.html.
+template<typename CodeUnit>
+Optional<size_t> CandidateScanner::find_literal_prefix_in(ReadonlySpan<CodeUnit> haystack, size_t position) const
+{
+    constexpr size_t lanes = lane_count<CodeUnit>;
+    auto const* data = haystack.data();
+    auto length = haystack.size();
+    auto prefix_length = m_literal_prefix.size();
+    if (length < prefix_length)
+        return {};
+
+    auto matches_at = [&](size_t candidate) {
+        for (size_t i = 1; i < prefix_length - 1; ++i) {
+            if (data[candidate + i] != m_literal_prefix[i])
+                return false;
+        }
+        return true;
+    };
+
+    CodeUnit first = m_literal_prefix.first();
+    CodeUnit last = m_literal_prefix.last();
+    auto firsts = splat(first);
+    auto lasts = splat(last);
+    for (; position + prefix_length - 1 + lanes <= length; position += lanes) {
+        auto mask = (load(data + position) == firsts) & (load(data + position + prefix_length - 1) == lasts);
+        if (!any(mask))
+            continue;
+        for (size_t i = 0; i < lanes; ++i) {
+            if (mask[i] && matches_at(position + i))
+                return position + i;
+        }
+    }
+
+    for (; position + prefix_length <= length; ++position) {
+        if (data[position] == first && data[position + prefix_length - 1] == last && matches_at(position))
+            return position;
+    }
+    return {};
+}
+
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+
+#include <AK/Array.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// Finds the positions in the input that a match can start at, so that the matcher doesn't have to try every single one.
+//
+// The scanner knows which code units the bytecode can start consuming input with, and the literal every match starts
+// with (if there is one). Runs of the input that can't start a match are skipped 16 bytes (or 8 UTF-16 code units) at
+// a time with AK::SIMD.
+class CandidateScanner {
+public:
+    // Returns nothing if a match could start anywhere, e.g. because the bytecode can match the empty string.
+    static Optional<CandidateScanner> create(ByteCode const&, bool insensitive);
+
+    bool is_insensitive() const { return m_insensitive; }
+    Vector<u32> const& literal_prefix() const { return m_literal_prefix; }
+
+    // Returns the first position at or after the given one where a match can start, or nothing if there is none.
+    // NOTE: Views that can't be scanned (e.g. in Unicode mode) get the given position back.
+    Optional<size_t> find_candidate(RegexStringView const&, size_t position) const;
+
+private:
+    struct Range {
+        u32 from { 0 };
+        u32 to { 0 };
+    };
+
+    explicit CandidateScanner(bool insensitive)
+        : m_insensitive(insensitive)
+    {
+    }
+
+    bool add_compare(ByteCode const&, size_t instruction_position);
+    void add_range(u32 from, u32 to);
+    void add_code_unit(u32 code_unit) { add_range(code_unit, code_unit); }
+    template<typename Predicate>
+    void add_ascii_code_units_matching(Predicate);
+    void find_literal_prefix(ByteCode const&);
+    void finalize();
+
+    bool can_start_with(u32 code_unit) const;
+
+    template<typename CodeUnit>
+    Optional<size_t> find_candidate_in(ReadonlySpan<CodeUnit>, size_t position) const;
+    template<typename CodeUnit>
+    Optional<size_t> find_literal_prefix_in(ReadonlySpan<CodeUnit>, size_t position) const;
+
+    bool m_insensitive { false };
+    // Sorted and non-overlapping.
+    Vector<Range> m_ranges;
+    // Which of the code units below 256 a match can start with, for scanning sets with too many ranges for SIMD.
+    Array<u64, 4> m_low_code_units {};
+    Vector<u32> m_literal_prefix;
+};
+
+}
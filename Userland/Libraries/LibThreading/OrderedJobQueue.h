@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace Threading {
+
+// Runs jobs on a ThreadPool, and hands them back to the thread that submitted them in the order they were submitted in.
+// This is what the parallel compressors use: their chunks are compressed independently, but have to be written out in order.
+// Only a couple of jobs per thread are kept in flight, so that none of the threads has to wait for the finished jobs to be
+// handled, while still putting a bound on how much memory is used.
+template<typename Job>
+class OrderedJobQueue {
+    AK_MAKE_NONCOPYABLE(OrderedJobQueue);
+    AK_MAKE_NONMOVABLE(OrderedJobQueue);
+
+public:
+    // `run_job` is called on one of the worker threads, `finish_job` on the submitting thread (from submit() and finish_all()).
+    // With a thread count of zero, jobs are run on the submitting thread as soon as they are submitted.
+    OrderedJobQueue(size_t thread_count, Function<ErrorOr<void>(Job&)> run_job, Function<ErrorOr<void>(Job&)> finish_job)
+        : m_run_job(move(run_job))
+        , m_finish_job(move(finish_job))
+        , m_max_jobs_in_flight(max<size_t>(thread_count * 2, 1))
+    {
+        if (thread_count > 0)
+            m_thread_pool = make<ThreadPool<Entry*>>([this](Entry* entry) { run(*entry); }, thread_count);
+    }
+
+    ~OrderedJobQueue()
+    {
+        // Anything that's still queued up at this point won't ever be finished, so don't bother running it.
+        m_is_cancelled = true;
+        m_thread_pool = nullptr;
+    }
+
+    // Finishes the oldest jobs first if there are too many in flight, and then any that are already done after queueing this one.
+    ErrorOr<void> submit(NonnullOwnPtr<Job> job)
+    {
+        TRY(finish_jobs(m_max_jobs_in_flight - 1));
+
+        TRY(m_jobs_in_flight.try_append(TRY(try_make<Entry>(move(job)))));
+        auto& entry = *m_jobs_in_flight.last();
+        if (m_thread_pool)
+            m_thread_pool->submit(&entry);
+        else
+            run(entry);
+
+        return finish_jobs(m_max_jobs_in_flight);
+    }
+
+    // Waits for all submitted jobs, and finishes them.
+    ErrorOr<void> finish_all() { return finish_jobs(0); }
+
+private:
+    struct Entry {
+        explicit Entry(NonnullOwnPtr<Job> job)
+            : job(move(job))
+        {
+        }
+
+        NonnullOwnPtr<Job> job;
+        bool is_done { false };
+        Optional<Error> error;
+    };
+
+    void run(Entry& entry)
+    {
+        auto result = m_is_cancelled ? ErrorOr<void> {} : m_run_job(*entry.job);
+
+        MutexLocker locker(m_mutex);
+        if (result.is_error())
+            entry.error = result.release_error();
+        entry.is_done = true;
+        m_job_done.broadcast();
+    }
+
+    ErrorOr<void> finish_jobs(size_t max_jobs_in_flight)
+    {
+        while (!m_jobs_in_flight.is_empty()) {
+            auto& entry = *m_jobs_in_flight.first();
+            {
+                MutexLocker locker(m_mutex);
+                if (m_jobs_in_flight.size() > max_jobs_in_flight) {
+                    while (!entry.is_done)
+                        m_job_done.wait();
+                } else if (!entry.is_done) {
+                    break;
+                }
+            }
+
+            auto finished_entry = m_jobs_in_flight.take_first();
+            if (finished_entry->error.has_value())
+                return finished_entry->error.release_value();
+            TRY(m_finish_job(*finished_entry->job));
+        }
+        return {};
+    }
+
+    Function<ErrorOr<void>(Job&)> m_run_job;
+    Function<ErrorOr<void>(Job&)> m_finish_job;
+    size_t m_max_jobs_in_flight { 0 };
+
+    // Jobs that haven't been finished yet, in order. There are only ever a few of them.
+    Vector<NonnullOwnPtr<Entry>> m_jobs_in_flight;
+
+    Mutex m_mutex;
+    ConditionVariable m_job_done { m_mutex };
+    Atomic<bool> m_is_cancelled { false };
+    OwnPtr<ThreadPool<Entry*>> m_thread_pool;
+};
+
+}
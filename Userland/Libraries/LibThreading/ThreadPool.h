@@ -22,9 +22,12 @@ struct ThreadPoolLooper {
     {
         Optional<typename Pool::Work> entry;
         while (true) {
+            // A job counts as busy from the moment it leaves the queue, so that wait_for_all() can't see an empty queue
+            // and no busy workers in between.
             entry = pool.m_work_queue.with_locked([&](auto& queue) -> Optional<typename Pool::Work> {
                 if (queue.is_empty())
                     return {};
+                pool.m_busy_count++;
                 return queue.dequeue();
             });
             if (entry.has_value())
@@ -35,13 +38,17 @@ struct ThreadPoolLooper {
             if (!wait)
                 return IterationDecision::Continue;
 
-            pool.m_mutex.lock();
-            pool.m_work_available.wait();
-            pool.m_mutex.unlock();
+            // submit() and ~ThreadPool() broadcast while holding the mutex, so checking again under it means we can't miss their wakeup.
+            MutexLocker locker(pool.m_mutex);
+            if (!pool.m_should_exit && pool.m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); }))
+                pool.m_work_available.wait();
         }
 
-        pool.m_busy_count++;
         pool.m_handler(entry.release_value());
+
+        MutexLocker locker(pool.m_mutex);
+        pool.m_busy_count--;
+        pool.m_work_done.broadcast();
         return IterationDecision::Continue;
     }
 };
@@ -75,10 +82,12 @@ public:
     ~ThreadPool()
     {
         m_should_exit.store(true, AK::MemoryOrder::memory_order_release);
-        for (auto& worker : m_workers) {
+        {
+            MutexLocker locker(m_mutex);
             m_work_available.broadcast();
-            (void)worker->join();
         }
+        for (auto& worker : m_workers)
+            (void)worker->join();
     }
 
     void submit(Work work)
@@ -86,24 +95,16 @@ public:
         m_work_queue.with_locked([&](auto& queue) {
             queue.enqueue({ move(work) });
         });
+        MutexLocker locker(m_mutex);
         m_work_available.broadcast();
     }
 
     void wait_for_all()
     {
-        while (true) {
-            if (m_work_queue.with_locked([](auto& queue) { return queue.is_empty(); }))
-                break;
-            m_mutex.lock();
-            m_work_done.wait();
-            m_mutex.unlock();
-        }
-
-        while (m_busy_count.load(AK::MemoryOrder::memory_order_acquire) > 0) {
-            m_mutex.lock();
-            m_work_done.wait();
-            m_mutex.unlock();
-        }
+        MutexLocker locker(m_mutex);
+        m_work_done.wait_while([&] {
+            return m_work_queue.with_locked([&](auto& queue) { return !queue.is_empty() || m_busy_count > 0; });
+        });
     }
 
 private:
@@ -112,13 +113,8 @@ private:
         for (size_t i = 0; i < concurrency; ++i) {
             m_workers.append(Thread::construct([this]() -> intptr_t {
                 Looper<ThreadPool> thread_looper;
-                for (; !m_should_exit;) {
-                    auto result = thread_looper.next(*this, true);
-                    m_busy_count--;
-                    m_work_done.signal();
-                    if (result == IterationDecision::Break)
-                        break;
-                }
+                while (thread_looper.next(*this, true) == IterationDecision::Continue)
+                    ;
 
                 return 0;
             },
@@ -8,11 +8,36 @@
 #include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/AbstractMachine/RegisterFunction.h>
 #include <LibWasm/AbstractMachine/Validator.h>
 #include <LibWasm/Types.h>
 
 namespace Wasm {
 
+WasmFunction::WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code)
+    : m_type(type)
+    , m_module(module)
+    , m_code(code)
+{
+}
+
+WasmFunction::WasmFunction(WasmFunction&&) = default;
+WasmFunction::~WasmFunction() = default;
+
+RegisterFunction const* WasmFunction::register_function(Store& store)
+{
+    if (!m_register_function.has_value()) {
+        auto function_or_error = RegisterFunction::create(*this, store);
+        if (function_or_error.is_error()) {
+            dbgln_if(WASM_TRACE_DEBUG, "Not translating function: {}", function_or_error.error());
+            m_register_function = OwnPtr<RegisterFunction> {};
+        } else {
+            m_register_function = function_or_error.release_value();
+        }
+    }
+    return m_register_function->ptr();
+}
+
 Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function)
 {
     FunctionAddress address { m_functions.size() };
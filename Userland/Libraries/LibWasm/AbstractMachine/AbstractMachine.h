@@ -21,6 +21,8 @@
 namespace Wasm {
 
 class Configuration;
+class RegisterFunction;
+class Store;
 struct Interpreter;
 
 struct InstantiationError {
@@ -333,21 +335,22 @@ private:
 
 class WasmFunction {
 public:
-    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, Module::Function const& code)
-        : m_type(type)
-        , m_module(module)
-        , m_code(code)
-    {
-    }
+    explicit WasmFunction(FunctionType const&, ModuleInstance const&, Module::Function const&);
+    WasmFunction(WasmFunction&&);
+    ~WasmFunction();
 
     auto& type() const { return m_type; }
     auto& module() const { return m_module; }
     auto& code() const { return m_code; }
 
+    // Translated on first use, null if the function can't be translated.
+    RegisterFunction const* register_function(Store&);
+
 private:
     FunctionType m_type;
     ModuleInstance const& m_module;
     Module::Function const& m_code;
+    Optional<OwnPtr<RegisterFunction>> m_register_function;
 };
 
 class HostFunction {
@@ -564,11 +567,12 @@ private:
 
 class Frame {
 public:
-    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity)
+    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity, RegisterFunction const* register_function = nullptr)
         : m_module(module)
         , m_locals(move(locals))
         , m_expression(expression)
         , m_arity(arity)
+        , m_register_function(register_function)
     {
     }
 
@@ -577,12 +581,14 @@ public:
     auto& locals() { return m_locals; }
     auto& expression() const { return m_expression; }
     auto arity() const { return m_arity; }
+    auto register_function() const { return m_register_function; }
 
 private:
     ModuleInstance const& m_module;
     Vector<Value> m_locals;
     Expression const& m_expression;
     size_t m_arity { 0 };
+    RegisterFunction const* m_register_function { nullptr };
 };
 
 class Stack {
@@ -14,6 +14,7 @@
 #include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Operators.h>
+#include <LibWasm/AbstractMachine/RegisterFunction.h>
 #include <LibWasm/Opcode.h>
 #include <LibWasm/Printer/Printer.h>
 
@@ -39,6 +40,15 @@ namespace Wasm {
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
     m_trap = Empty {};
+
+    if (auto const* register_function = configuration.frame().register_function(); register_function && can_run_register_functions()) {
+        // FIXME: Count executed instructions in register functions too.
+        if (!configuration.should_limit_instruction_count()) {
+            m_trap = register_function->execute(*this, configuration, m_stack_info);
+            return;
+        }
+    }
+
     auto& instructions = configuration.frame().expression().instructions();
     auto max_ip_value = InstructionPointer { instructions.size() };
     auto& current_ip_value = configuration.ip();
@@ -787,7 +797,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         };
 
         for (auto i = 0; i < count; ++i) {
-            store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset);
+            store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
         }
         return;
     }
@@ -30,6 +30,9 @@ struct BytecodeInterpreter : public Interpreter {
     }
     virtual void clear_trap() override { m_trap = Empty {}; }
 
+    // Whether functions may run as a RegisterFunction, which doesn't go through interpret() for every instruction.
+    virtual bool can_run_register_functions() const { return true; }
+
     struct CallFrameHandle {
         explicit CallFrameHandle(BytecodeInterpreter& interpreter, Configuration& configuration)
             : m_configuration_handle(configuration)
@@ -99,6 +102,8 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
     }
     virtual ~DebuggerBytecodeInterpreter() override = default;
 
+    virtual bool can_run_register_functions() const override { return !pre_interpret_hook && !post_interpret_hook; }
+
     Function<bool(Configuration&, InstructionPointer&, Instruction const&)> pre_interpret_hook;
     Function<bool(Configuration&, InstructionPointer&, Instruction const&, Interpreter const&)> post_interpret_hook;
 
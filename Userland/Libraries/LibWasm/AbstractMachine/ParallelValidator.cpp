@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibWasm/AbstractMachine/ParallelValidator.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Wasm {
+
+static constexpr size_t MAX_VALIDATION_THREADS = 16;
+
+size_t ParallelFunctionValidator::default_thread_count()
+{
+    static size_t const thread_count = [] {
+        if (auto const* count_string = getenv("LIBWASM_VALIDATION_THREADS")) {
+            if (auto count = StringView { count_string, strlen(count_string) }.to_number<size_t>(); count.has_value())
+                return clamp<size_t>(*count, 1, MAX_VALIDATION_THREADS);
+        }
+        return clamp<size_t>(Core::System::hardware_concurrency(), 1, MAX_VALIDATION_THREADS);
+    }();
+    return thread_count;
+}
+
+ParallelFunctionValidator::ParallelFunctionValidator(Validator const& validator, size_t thread_count)
+    : m_thread_pool([this](Batch batch) { run_batch(move(batch)); }, thread_count)
+{
+    VERIFY(thread_count > 0);
+
+    // The copies have to be made here, as the validator's own storage must not be touched from the workers.
+    for (size_t i = 0; i < thread_count; ++i) {
+        m_validators.append(validator.isolated_fork());
+        m_idle_validators.append(m_validators.last().ptr());
+    }
+}
+
+ParallelFunctionValidator::~ParallelFunctionValidator()
+{
+    if (!m_is_finished)
+        (void)finish();
+}
+
+void ParallelFunctionValidator::enqueue(size_t function_index, CodeSection::Code const& code)
+{
+    VERIFY(!m_is_finished);
+
+    m_pending_batch.append({ function_index, &code });
+    if (m_pending_batch.size() == jobs_per_batch)
+        submit_pending_batch();
+}
+
+void ParallelFunctionValidator::submit_pending_batch()
+{
+    if (m_pending_batch.is_empty())
+        return;
+
+    {
+        // There's no point in validating anything past a function that's already known to be invalid.
+        Threading::MutexLocker locker(m_mutex);
+        if (m_first_invalid_function_index.has_value() && *m_first_invalid_function_index < m_pending_batch.first().function_index) {
+            m_pending_batch.clear_with_capacity();
+            return;
+        }
+    }
+
+    m_thread_pool.submit(move(m_pending_batch));
+}
+
+ErrorOr<void, ValidationError> ParallelFunctionValidator::finish()
+{
+    VERIFY(!m_is_finished);
+
+    submit_pending_batch();
+    m_thread_pool.wait_for_all();
+    m_is_finished = true;
+
+    if (m_first_error.has_value())
+        return m_first_error.release_value();
+    return {};
+}
+
+void ParallelFunctionValidator::run_batch(Batch batch)
+{
+    // There are as many validators as there are workers, so there's always an idle one for us.
+    Validator* validator;
+    {
+        Threading::MutexLocker locker(m_mutex);
+        if (m_first_invalid_function_index.has_value() && *m_first_invalid_function_index < batch.first().function_index)
+            return;
+        validator = m_idle_validators.take_last();
+    }
+
+    Optional<size_t> invalid_function_index;
+    Optional<ValidationError> error;
+    for (auto& job : batch) {
+        auto result = validator->validate_function(job.function_index, *job.code);
+        if (result.is_error()) {
+            invalid_function_index = job.function_index;
+            error = result.release_error();
+            break;
+        }
+    }
+
+    Threading::MutexLocker locker(m_mutex);
+    m_idle_validators.append(validator);
+    if (invalid_function_index.has_value() && (!m_first_invalid_function_index.has_value() || *invalid_function_index < *m_first_invalid_function_index)) {
+        m_first_invalid_function_index = invalid_function_index;
+        m_first_error = error.release_value();
+    }
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
+#include <LibWasm/AbstractMachine/Validator.h>
+
+namespace Wasm {
+
+// Validates function bodies on a thread pool, while the caller keeps handing out more of them
+// (for instance while the rest of the module is still being parsed). Every batch of functions is
+// validated against one of thread_count copies of the module context, which are never shared between
+// two batches at a time.
+class ParallelFunctionValidator {
+    AK_MAKE_NONCOPYABLE(ParallelFunctionValidator);
+    AK_MAKE_NONMOVABLE(ParallelFunctionValidator);
+
+public:
+    // Code sections smaller than this are validated on the calling thread, as that's faster than starting any threads.
+    static constexpr size_t minimum_parallel_code_size = 256 * KiB;
+
+    // One thread per core, unless overridden with LIBWASM_VALIDATION_THREADS=N.
+    static size_t default_thread_count();
+
+    // The validator's context must already contain everything the function bodies refer to.
+    ParallelFunctionValidator(Validator const&, size_t thread_count);
+    ~ParallelFunctionValidator();
+
+    // The code entry must stay alive (and in place) until finish() has returned.
+    void enqueue(size_t function_index, CodeSection::Code const&);
+
+    // Waits for all enqueued functions, and returns the error of the lowest-indexed invalid one, if any.
+    ErrorOr<void, ValidationError> finish();
+
+private:
+    struct Job {
+        size_t function_index { 0 };
+        CodeSection::Code const* code { nullptr };
+    };
+
+    // Functions are mostly small, so they are handed to the pool in batches to keep its lock out of the way.
+    static constexpr size_t jobs_per_batch = 32;
+    using Batch = Vector<Job, jobs_per_batch>;
+
+    void run_batch(Batch);
+    void submit_pending_batch();
+
+    Vector<NonnullOwnPtr<Validator>> m_validators;
+    Batch m_pending_batch;
+    bool m_is_finished { false };
+
+    Threading::Mutex m_mutex;
+    Vector<Validator*> m_idle_validators;
+    Optional<size_t> m_first_invalid_function_index;
+    Optional<ValidationError> m_first_error;
+
+    // Declared last, so that the workers are gone before anything they use is destroyed.
+    Threading::ThreadPool<Batch> m_thread_pool;
+};
+
+}
@@ -0,0 +1,2514 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AllOf.h>
+#include <AK/AnyOf.h>
+#include <AK/ByteReader.h>
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/HashMap.h>
+#include <AK/SIMDExtras.h>
+#include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/AbstractMachine/Configuration.h>
+#include <LibWasm/AbstractMachine/Operators.h>
+#include <LibWasm/AbstractMachine/RegisterFunction.h>
+#include <LibWasm/AbstractMachine/VectorOperators.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/JIT/NativeFunction.h>
+#include <LibWasm/Opcode.h>
+
+namespace Wasm {
+
+using namespace AK::SIMD;
+
+struct RegisterContext {
+    BytecodeInterpreter& interpreter;
+    Configuration& configuration;
+    StackInfo const& stack_info;
+    // The register files of all frames of this call, each callee's right on top of its caller's arguments.
+    Vector<u64, 512> slots;
+    RegisterFunction::TrapState trap;
+};
+
+template<typename T>
+ALWAYS_INLINE static T from_slot(u64 slot)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<float>(static_cast<u32>(slot));
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<double>(slot);
+    else
+        return static_cast<T>(slot);
+}
+
+template<typename T>
+ALWAYS_INLINE static u64 to_slot(T value)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<u32>(value);
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<u64>(value);
+    else
+        return static_cast<MakeUnsigned<T>>(value);
+}
+
+// Vectors span two slots, everything else fits into one.
+template<typename T>
+ALWAYS_INLINE static T read_slot(u64 const* slot)
+{
+    if constexpr (VectorOperators::NativeVector<T>) {
+        T vector;
+        __builtin_memcpy(&vector, slot, sizeof(T));
+        return vector;
+    } else {
+        return from_slot<T>(*slot);
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static void write_slot(u64* slot, T value)
+{
+    if constexpr (VectorOperators::NativeVector<T>)
+        __builtin_memcpy(slot, &value, sizeof(T));
+    else
+        *slot = to_slot(value);
+}
+
+static void to_slots(Value const& value, u64* slots)
+{
+    value.value().visit(
+        [&](i32 number) { write_slot(slots, number); },
+        [&](i64 number) { write_slot(slots, number); },
+        [&](float number) { write_slot(slots, number); },
+        [&](double number) { write_slot(slots, number); },
+        [&](u128 vector) { write_slot(slots, bit_cast<u64x2>(vector)); },
+        [](Reference const&) { VERIFY_NOT_REACHED(); });
+}
+
+static Value to_value(ValueType type, u64 const* slots)
+{
+    switch (type.kind()) {
+    case ValueType::I32:
+        return Value(read_slot<i32>(slots));
+    case ValueType::I64:
+        return Value(read_slot<i64>(slots));
+    case ValueType::F32:
+        return Value(read_slot<float>(slots));
+    case ValueType::F64:
+        return Value(read_slot<double>(slots));
+    case ValueType::V128:
+        return Value(bit_cast<u128>(read_slot<u64x2>(slots)));
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static T read_value(u8 const* data)
+{
+    if constexpr (VectorOperators::NativeVector<T>) {
+        // NOTE: Vectors are stored with their first lane first, which matches the host's layout on all supported (little-endian) targets.
+        T value;
+        ByteReader::load(data, value);
+        return value;
+    } else if constexpr (IsFloatingPoint<T>) {
+        return bit_cast<T>(read_value<Conditional<sizeof(T) == sizeof(u32), u32, u64>>(data));
+    } else {
+        T value;
+        ByteReader::load(data, value);
+        return AK::convert_between_host_and_little_endian(value);
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static void write_value(u8* data, T value)
+{
+    if constexpr (VectorOperators::NativeVector<T>)
+        ByteReader::store(data, value);
+    else if constexpr (IsFloatingPoint<T>)
+        write_value(data, bit_cast<Conditional<sizeof(T) == sizeof(u32), u32, u64>>(value));
+    else
+        ByteReader::store(data, AK::convert_between_host_and_little_endian(value));
+}
+
+static RegisterInstruction const* trap(RegisterFrame& frame, StringView reason)
+{
+    dbgln_if(WASM_TRACE_DEBUG, "Trapped: {}", reason);
+    frame.context->trap = Trap { reason };
+    return nullptr;
+}
+
+static bool run(RegisterContext&, RegisterFunction const&, size_t base);
+
+static RegisterInstruction const* trap_unreachable(RegisterFrame& frame, RegisterInstruction const*)
+{
+    return trap(frame, "Unreachable"sv);
+}
+
+static RegisterInstruction const* return_from_function(RegisterFrame&, RegisterInstruction const*)
+{
+    return nullptr;
+}
+
+static RegisterInstruction const* copy_slot(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    frame.slots[ip->destination] = frame.slots[ip->lhs];
+    return ip + 1;
+}
+
+static RegisterInstruction const* select_value(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto condition = from_slot<u32>(frame.slots[ip->argument]);
+    frame.slots[ip->destination] = frame.slots[condition != 0 ? ip->lhs : ip->rhs];
+    return ip + 1;
+}
+
+static RegisterInstruction const* copy_wide_slot(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    write_slot(frame.slots + ip->destination, read_slot<u64x2>(frame.slots + ip->lhs));
+    return ip + 1;
+}
+
+static RegisterInstruction const* select_wide_value(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto condition = from_slot<u32>(frame.slots[ip->argument]);
+    write_slot(frame.slots + ip->destination, read_slot<u64x2>(frame.slots + (condition != 0 ? ip->lhs : ip->rhs)));
+    return ip + 1;
+}
+
+static RegisterInstruction const* jump(RegisterFrame&, RegisterInstruction const* ip)
+{
+    return ip->target;
+}
+
+template<typename T, bool branch_if_zero>
+static RegisterInstruction const* test_and_branch(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    if ((from_slot<T>(frame.slots[ip->lhs]) == 0) == branch_if_zero)
+        return ip->target;
+    return ip + 1;
+}
+
+template<typename PopT, typename Operator, bool branch_if>
+static RegisterInstruction const* compare_and_branch(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto lhs = from_slot<PopT>(frame.slots[ip->lhs]);
+    auto rhs = from_slot<PopT>(frame.slots[ip->rhs]);
+    if (static_cast<bool>(Operator {}(lhs, rhs)) == branch_if)
+        return ip->target;
+    return ip + 1;
+}
+
+static RegisterInstruction const* branch_table(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    // The last entry is the default target.
+    auto index = min(from_slot<u32>(frame.slots[ip->lhs]), ip->rhs - 1);
+    return frame.function->jump_table()[ip->argument + index];
+}
+
+template<typename PopT, typename PushT, typename Operator>
+static RegisterInstruction const* binary_operation(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto lhs = from_slot<PopT>(frame.slots[ip->lhs]);
+    auto rhs = from_slot<PopT>(frame.slots[ip->rhs]);
+    auto call_result = Operator {}(lhs, rhs);
+    PushT result;
+    if constexpr (IsSpecializationOf<decltype(call_result), AK::ErrorOr>) {
+        if (call_result.is_error()) [[unlikely]]
+            return trap(frame, call_result.error());
+        result = call_result.release_value();
+    } else {
+        result = call_result;
+    }
+    frame.slots[ip->destination] = to_slot(result);
+    return ip + 1;
+}
+
+template<typename PopT, typename PushT, typename Operator>
+static RegisterInstruction const* unary_operation(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto call_result = Operator {}(from_slot<PopT>(frame.slots[ip->lhs]));
+    PushT result;
+    if constexpr (IsSpecializationOf<decltype(call_result), AK::ErrorOr>) {
+        if (call_result.is_error()) [[unlikely]]
+            return trap(frame, call_result.error());
+        result = call_result.release_value();
+    } else {
+        result = call_result;
+    }
+    frame.slots[ip->destination] = to_slot(result);
+    return ip + 1;
+}
+
+static RegisterInstruction const* global_get(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto* global = frame.context->configuration.store().get(GlobalAddress { ip->immediate });
+    to_slots(global->value(), frame.slots + ip->destination);
+    return ip + 1;
+}
+
+static RegisterInstruction const* global_set(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto* global = frame.context->configuration.store().get(GlobalAddress { ip->immediate });
+    global->set_value(to_value(global->type().type(), frame.slots + ip->lhs));
+    return ip + 1;
+}
+
+static void refresh_memory(RegisterFrame& frame)
+{
+    if (auto memory = frame.function->memory(); memory.has_value()) {
+        frame.memory = frame.context->configuration.store().get(*memory);
+        frame.memory_data = frame.memory->data().data();
+        frame.memory_size = frame.memory->size();
+    }
+}
+
+ALWAYS_INLINE static bool is_in_bounds(RegisterFrame const& frame, u64 address, u64 size)
+{
+    // Neither the address nor the size exceeds 2^33, so there's no need to worry about overflow here.
+    if (address + size <= frame.memory_size)
+        return true;
+    dbgln("LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", address + size, frame.memory_size);
+    return false;
+}
+
+template<typename ReadT, typename PushT>
+static RegisterInstruction const* load_from_memory(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto address = static_cast<u64>(from_slot<u32>(frame.slots[ip->lhs])) + ip->immediate;
+    if (!is_in_bounds(frame, address, sizeof(ReadT))) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    frame.slots[ip->destination] = to_slot(static_cast<PushT>(read_value<ReadT>(frame.memory_data + address)));
+    return ip + 1;
+}
+
+template<typename PopT, typename StoreT>
+static RegisterInstruction const* store_to_memory(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto address = static_cast<u64>(from_slot<u32>(frame.slots[ip->lhs])) + ip->immediate;
+    if (!is_in_bounds(frame, address, sizeof(StoreT))) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    write_value(frame.memory_data + address, static_cast<StoreT>(from_slot<PopT>(frame.slots[ip->rhs])));
+    return ip + 1;
+}
+
+static RegisterInstruction const* memory_size(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    frame.slots[ip->destination] = to_slot(static_cast<i32>(frame.memory_size / Constants::page_size));
+    return ip + 1;
+}
+
+static RegisterInstruction const* memory_grow(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto& memory = *frame.memory;
+    auto old_pages = static_cast<i32>(memory.size() / Constants::page_size);
+    auto new_pages = from_slot<u32>(frame.slots[ip->lhs]);
+    dbgln_if(WASM_TRACE_DEBUG, "memory.grow({}), previously {} pages...", new_pages, old_pages);
+    if (memory.grow(static_cast<u64>(new_pages) * Constants::page_size))
+        frame.slots[ip->destination] = to_slot(old_pages);
+    else
+        frame.slots[ip->destination] = to_slot(-1);
+    refresh_memory(frame);
+    return ip + 1;
+}
+
+// https://webassembly.github.io/spec/core/bikeshed/#exec-memory-fill
+static RegisterInstruction const* memory_fill(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto destination = static_cast<u64>(from_slot<u32>(frame.slots[ip->destination]));
+    auto value = from_slot<u8>(frame.slots[ip->lhs]);
+    auto count = static_cast<u64>(from_slot<u32>(frame.slots[ip->rhs]));
+    if (!is_in_bounds(frame, destination, count)) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    __builtin_memset(frame.memory_data + destination, value, count);
+    return ip + 1;
+}
+
+// https://webassembly.github.io/spec/core/bikeshed/#exec-memory-copy
+static RegisterInstruction const* memory_copy(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto destination = static_cast<u64>(from_slot<u32>(frame.slots[ip->destination]));
+    auto source = static_cast<u64>(from_slot<u32>(frame.slots[ip->lhs]));
+    auto count = static_cast<u64>(from_slot<u32>(frame.slots[ip->rhs]));
+    if (!is_in_bounds(frame, source, count) || !is_in_bounds(frame, destination, count)) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    __builtin_memmove(frame.memory_data + destination, frame.memory_data + source, count);
+    return ip + 1;
+}
+
+template<typename PopT, typename Operator, typename RhsT = PopT>
+static RegisterInstruction const* vector_binary_operation(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto lhs = read_slot<PopT>(frame.slots + ip->lhs);
+    auto rhs = read_slot<RhsT>(frame.slots + ip->rhs);
+    write_slot(frame.slots + ip->destination, Operator {}(lhs, rhs));
+    return ip + 1;
+}
+
+template<typename PopT, typename Operator>
+static RegisterInstruction const* vector_unary_operation(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    write_slot(frame.slots + ip->destination, Operator {}(read_slot<PopT>(frame.slots + ip->lhs)));
+    return ip + 1;
+}
+
+// https://webassembly.github.io/spec/core/bikeshed/#-mathsfv128mathsfbitselect
+static RegisterInstruction const* vector_bitselect(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto if_set = read_slot<u64x2>(frame.slots + ip->lhs);
+    auto if_clear = read_slot<u64x2>(frame.slots + ip->rhs);
+    auto mask = read_slot<u64x2>(frame.slots + ip->argument);
+    write_slot(frame.slots + ip->destination, (if_set & mask) | (if_clear & ~mask));
+    return ip + 1;
+}
+
+// The lane masks of shuffles are kept as vector constants, whose slot is the argument.
+static RegisterInstruction const* vector_shuffle(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto lhs = read_slot<u8x16>(frame.slots + ip->lhs);
+    auto rhs = read_slot<u8x16>(frame.slots + ip->rhs);
+    auto lanes = read_slot<u8x16>(frame.slots + ip->argument);
+    u8x16 result;
+    for (size_t i = 0; i < 16; ++i)
+        result[i] = lanes[i] < 16 ? lhs[lanes[i]] : rhs[lanes[i] - 16];
+    write_slot(frame.slots + ip->destination, result);
+    return ip + 1;
+}
+
+template<typename VectorT, typename PushT>
+static RegisterInstruction const* extract_lane(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto vector = read_slot<VectorT>(frame.slots + ip->lhs);
+    write_slot(frame.slots + ip->destination, static_cast<PushT>(vector[ip->argument]));
+    return ip + 1;
+}
+
+template<typename VectorT, typename PopT>
+static RegisterInstruction const* replace_lane(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto vector = read_slot<VectorT>(frame.slots + ip->lhs);
+    vector[ip->argument] = static_cast<VectorOperators::ElementOf<VectorT>>(read_slot<PopT>(frame.slots + ip->rhs));
+    write_slot(frame.slots + ip->destination, vector);
+    return ip + 1;
+}
+
+// Loads a ReadT, and turns it into a vector with the operator if there is one.
+template<typename ReadT, typename Operator>
+static RegisterInstruction const* load_vector_from_memory(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto address = static_cast<u64>(from_slot<u32>(frame.slots[ip->lhs])) + ip->immediate;
+    if (!is_in_bounds(frame, address, sizeof(ReadT))) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    auto value = read_value<ReadT>(frame.memory_data + address);
+    if constexpr (IsVoid<Operator>)
+        write_slot(frame.slots + ip->destination, value);
+    else
+        write_slot(frame.slots + ip->destination, Operator {}(value));
+    return ip + 1;
+}
+
+static RegisterInstruction const* store_vector_to_memory(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto address = static_cast<u64>(from_slot<u32>(frame.slots[ip->lhs])) + ip->immediate;
+    if (!is_in_bounds(frame, address, sizeof(u128))) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    write_value(frame.memory_data + address, read_slot<u8x16>(frame.slots + ip->rhs));
+    return ip + 1;
+}
+
+template<typename VectorT>
+static RegisterInstruction const* load_lane_from_memory(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    using Element = VectorOperators::ElementOf<VectorT>;
+    auto address = static_cast<u64>(from_slot<u32>(frame.slots[ip->lhs])) + ip->immediate;
+    if (!is_in_bounds(frame, address, sizeof(Element))) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    auto vector = read_slot<VectorT>(frame.slots + ip->rhs);
+    vector[ip->argument] = read_value<Element>(frame.memory_data + address);
+    write_slot(frame.slots + ip->destination, vector);
+    return ip + 1;
+}
+
+template<typename VectorT>
+static RegisterInstruction const* store_lane_to_memory(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    using Element = VectorOperators::ElementOf<VectorT>;
+    auto address = static_cast<u64>(from_slot<u32>(frame.slots[ip->lhs])) + ip->immediate;
+    if (!is_in_bounds(frame, address, sizeof(Element))) [[unlikely]]
+        return trap(frame, "Memory access out of bounds"sv);
+    write_value(frame.memory_data + address, read_slot<VectorT>(frame.slots + ip->rhs)[ip->argument]);
+    return ip + 1;
+}
+
+static RegisterInstruction const* call_through_configuration(RegisterFrame& frame, RegisterInstruction const* ip, FunctionAddress address)
+{
+    auto& configuration = frame.context->configuration;
+    auto& interpreter = frame.context->interpreter;
+    auto width = frame.function->slot_width();
+
+    Vector<Value> arguments;
+    size_t result_count = 0;
+    configuration.store().get(address)->visit([&](auto const& function) {
+        auto& parameters = function.type().parameters();
+        arguments.ensure_capacity(parameters.size());
+        for (size_t i = 0; i < parameters.size(); ++i)
+            arguments.unchecked_append(to_value(parameters[i], frame.slots + ip->lhs + i * width));
+        result_count = function.type().results().size();
+    });
+
+    Result result { Trap { ""sv } };
+    {
+        BytecodeInterpreter::CallFrameHandle handle { interpreter, configuration };
+        result = configuration.call(interpreter, address, move(arguments));
+    }
+
+    if (result.is_trap()) {
+        frame.context->trap = move(result.trap());
+        return nullptr;
+    }
+    if (result.is_completion()) {
+        frame.context->trap = move(result.completion());
+        return nullptr;
+    }
+
+    // The callee may have grown the memory, or allocated a new one, which can move the existing ones around in the store.
+    refresh_memory(frame);
+
+    // NOTE: The results come in reverse order, the same way the BytecodeInterpreter pops them off the stack.
+    auto& values = result.values();
+    if (values.size() != result_count)
+        return trap(frame, "Function returned the wrong number of values"sv);
+    for (size_t i = 0; i < result_count; ++i)
+        to_slots(values[result_count - i - 1], frame.slots + ip->lhs + i * width);
+    return ip + 1;
+}
+
+static RegisterInstruction const* call_address(RegisterFrame& frame, RegisterInstruction const* ip, FunctionAddress address)
+{
+    auto& context = *frame.context;
+    if (context.stack_info.size_free() < Constants::minimum_stack_space_to_keep_free) [[unlikely]]
+        return trap(frame, "Call stack exhausted"sv);
+
+    auto* function = context.configuration.store().get(address);
+    auto* wasm_function = function->get_pointer<WasmFunction>();
+    if (!wasm_function)
+        return call_through_configuration(frame, ip, address);
+
+    // The callee can only take over the arguments in place if it lays out its locals the same way.
+    auto const* callee = wasm_function->register_function(context.configuration.store());
+    if (!callee || callee->slot_width() != frame.function->slot_width())
+        return call_through_configuration(frame, ip, address);
+
+    // The arguments are already where the callee expects its first locals to be.
+    if (!run(context, *callee, frame.base + ip->lhs))
+        return nullptr;
+    frame.slots = context.slots.data() + frame.base;
+    refresh_memory(frame);
+    return ip + 1;
+}
+
+static RegisterInstruction const* call_function(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    return call_address(frame, ip, FunctionAddress { ip->immediate });
+}
+
+static RegisterInstruction const* call_indirect(RegisterFrame& frame, RegisterInstruction const* ip)
+{
+    auto& store = frame.context->configuration.store();
+    auto* table = store.get(TableAddress { ip->immediate });
+    auto index = from_slot<u32>(frame.slots[ip->rhs]);
+    if (index >= table->elements().size())
+        return trap(frame, "Undefined element"sv);
+    auto& element = table->elements()[index];
+    if (!element.has_value() || !element->ref().has<Reference::Func>())
+        return trap(frame, "Uninitialized element"sv);
+
+    auto address = element->ref().get<Reference::Func>().address;
+    auto& expected_type = frame.function->module().types()[ip->argument];
+    bool type_matches = false;
+    store.get(address)->visit([&](auto const& function) {
+        type_matches = function.type().parameters() == expected_type.parameters() && function.type().results() == expected_type.results();
+    });
+    if (!type_matches)
+        return trap(frame, "Indirect call type mismatch"sv);
+
+    return call_address(frame, ip, address);
+}
+
+static bool run(RegisterContext& context, RegisterFunction const& function, size_t base)
+{
+    if (auto frame_end = base + function.frame_size(); context.slots.size() < frame_end)
+        context.slots.resize(frame_end);
+
+    RegisterFrame frame { &context, &function, base, context.slots.data() + base, nullptr, nullptr, 0 };
+    refresh_memory(frame);
+
+    // The parameters are already in place, the remaining locals start out zeroed, followed by the constants.
+    auto width = function.slot_width();
+    auto parameter_count = function.parameter_count();
+    __builtin_memset(frame.slots + parameter_count * width, 0, (function.local_count() - parameter_count) * width * sizeof(u64));
+    if (!function.constants().is_empty())
+        __builtin_memcpy(frame.slots + function.local_count() * width, function.constants().data(), function.constants().size() * sizeof(u64));
+
+    if (auto const* native_function = function.get_or_create_native_function()) {
+        native_function->run(frame);
+    } else {
+        auto const* ip = function.instructions().data();
+        while (ip)
+            ip = ip->handler(frame, ip);
+    }
+
+    if (!context.trap.has<Empty>())
+        return false;
+
+    // Hand the results back in the first slots of the frame, which is where the caller put the arguments.
+    if (auto result_count = function.type().results().size(); result_count != 0 && function.stack_base() != 0)
+        __builtin_memmove(frame.slots, frame.slots + function.stack_base(), result_count * width * sizeof(u64));
+    return true;
+}
+
+RegisterFunction::RegisterFunction(FunctionType const& type, ModuleInstance const& module)
+    : m_type(type)
+    , m_module(module)
+{
+}
+
+RegisterFunction::~RegisterFunction() = default;
+
+JIT::NativeFunction const* RegisterFunction::get_or_create_native_function() const
+{
+    if (m_did_try_jitting)
+        return m_native_function.ptr();
+
+    if (!JIT::Compiler::should_compile(*this, ++m_execution_count))
+        return nullptr;
+
+    m_did_try_jitting = true;
+    m_native_function = JIT::Compiler::compile(*this);
+    return m_native_function.ptr();
+}
+
+RegisterFunction::TrapState RegisterFunction::execute(BytecodeInterpreter& interpreter, Configuration& configuration, StackInfo const& stack_info) const
+{
+    RegisterContext context { interpreter, configuration, stack_info, {}, Empty {} };
+    context.slots.resize(m_frame_size);
+
+    auto& locals = configuration.frame().locals();
+    for (size_t i = 0; i < parameter_count(); ++i)
+        to_slots(locals[i], context.slots.data() + i * m_slot_width);
+
+    if (!run(context, *this, 0))
+        return move(context.trap);
+
+    for (size_t i = 0; i < m_type.results().size(); ++i)
+        configuration.stack().push(to_value(m_type.results()[i], context.slots.data() + i * m_slot_width));
+    return Empty {};
+}
+
+class RegisterFunction::Translator {
+public:
+    Translator(RegisterFunction& function, WasmFunction const& wasm_function, Store& store)
+        : m_function(function)
+        , m_code(wasm_function.code())
+        , m_module(wasm_function.module())
+        , m_store(store)
+    {
+    }
+
+    ErrorOr<void> translate();
+
+private:
+    // Slots of the constants and the operand stack are only known once the whole function is translated, so until then
+    // they're tagged with what they refer to.
+    static constexpr u32 constant_tag = 1u << 30;
+    static constexpr u32 stack_tag = 1u << 31;
+
+    struct ControlFrame {
+        enum class Kind {
+            Function,
+            Block,
+            Loop,
+            If,
+        };
+
+        Kind kind;
+        size_t height { 0 };
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+        size_t label { 0 };
+        Optional<size_t> else_label;
+        bool unreachable { false };
+
+        size_t branch_arity() const { return kind == Kind::Loop ? parameter_count : result_count; }
+    };
+
+    struct Fixup {
+        size_t instruction;
+        size_t label;
+    };
+
+    struct Fusion {
+        RegisterHandler branch_if_true;
+        RegisterHandler branch_if_false;
+    };
+
+    ErrorOr<void> translate(Instruction const&);
+    ErrorOr<void> begin_block(ControlFrame::Kind, Instruction const&);
+    void else_();
+    void end();
+    void finalize();
+
+    static bool is_supported(ValueType type) { return type.is_numeric() || type.is_vector(); }
+    static bool is_supported(Vector<ValueType> const& types)
+    {
+        return all_of(types, [](auto& type) { return is_supported(type); });
+    }
+
+    bool uses_vectors() const;
+
+    u32 local_slot(size_t index) const { return index * m_function.m_slot_width; }
+    u32 stack_slot(size_t height) const { return stack_tag | (height * m_function.m_slot_width); }
+
+    u32 push()
+    {
+        auto slot = stack_slot(m_stack.size());
+        m_stack.append(slot);
+        m_max_stack_height = max(m_max_stack_height, m_stack.size());
+        return slot;
+    }
+
+    u32 pop()
+    {
+        VERIFY(m_stack.size() > m_control.last().height);
+        return m_stack.take_last();
+    }
+
+    u32 constant(u64 value)
+    {
+        auto offset = m_constants.ensure(value, [&] {
+            auto offset = static_cast<u32>(m_function.m_constants.size());
+            m_function.m_constants.append(value);
+            if (m_function.m_slot_width == 2)
+                m_function.m_constants.append(0);
+            return offset;
+        });
+        return constant_tag | offset;
+    }
+
+    u32 vector_constant(u128 value)
+    {
+        VERIFY(m_function.m_slot_width == 2);
+        auto offset = static_cast<u32>(m_function.m_constants.size());
+        auto words = bit_cast<u64x2>(value);
+        m_function.m_constants.append(words[0]);
+        m_function.m_constants.append(words[1]);
+        return constant_tag | offset;
+    }
+
+    void push_constant(u32 slot)
+    {
+        m_stack.append(slot);
+        m_max_stack_height = max(m_max_stack_height, m_stack.size());
+    }
+
+    size_t emit(RegisterHandler handler, u32 destination = 0, u32 lhs = 0, u32 rhs = 0, u32 argument = 0, u64 immediate = 0)
+    {
+        m_last_result = {};
+        m_function.m_instructions.append({ handler, m_opcode, destination, lhs, rhs, argument, immediate, nullptr });
+        return m_function.m_instructions.size() - 1;
+    }
+
+    size_t emit_tagged(OpCode opcode, RegisterHandler handler, u32 destination = 0, u32 lhs = 0, u32 rhs = 0, u32 argument = 0)
+    {
+        auto index = emit(handler, destination, lhs, rhs, argument);
+        m_function.m_instructions[index].opcode = opcode;
+        return index;
+    }
+
+    void emit_result(RegisterHandler handler, u32 lhs = 0, u32 rhs = 0, u32 argument = 0, u64 immediate = 0)
+    {
+        auto index = emit(handler, push(), lhs, rhs, argument, immediate);
+        m_last_result = index;
+        m_fusion = {};
+    }
+
+    void emit_jump(OpCode opcode, RegisterHandler handler, size_t label, u32 lhs = 0, u32 argument = 0)
+    {
+        m_fixups.append({ emit_tagged(opcode, handler, 0, lhs, 0, argument), label });
+    }
+
+    void emit_move(u32 destination, u32 source)
+    {
+        if (destination != source)
+            emit_tagged(Instructions::local_set, m_function.m_slot_width == 2 ? copy_wide_slot : copy_slot, destination, source);
+    }
+
+    template<typename PopT, typename PushT, typename Operator>
+    void emit_binary()
+    {
+        auto rhs = pop();
+        auto lhs = pop();
+        emit_result(binary_operation<PopT, PushT, Operator>, lhs, rhs);
+    }
+
+    template<typename PopT, typename PushT, typename Operator>
+    void emit_unary()
+    {
+        emit_result(unary_operation<PopT, PushT, Operator>, pop());
+    }
+
+    template<typename PopT, typename Operator>
+    void emit_comparison()
+    {
+        emit_binary<PopT, i32, Operator>();
+        m_fusion = Fusion { compare_and_branch<PopT, Operator, true>, compare_and_branch<PopT, Operator, false> };
+    }
+
+    template<typename PopT>
+    void emit_equals_zero()
+    {
+        emit_unary<PopT, i32, Operators::EqualsZero>();
+        m_fusion = Fusion { test_and_branch<PopT, true>, test_and_branch<PopT, false> };
+    }
+
+    // Branches to the label if the condition is (or isn't) zero, folding the comparison that produced it into the branch where possible.
+    void emit_branch_if(u32 condition, bool branch_if, size_t label)
+    {
+        if ((condition & stack_tag) && m_last_result.has_value() && m_fusion.has_value()) {
+            auto& instruction = m_function.m_instructions[*m_last_result];
+            if (instruction.destination == condition) {
+                instruction.handler = branch_if ? m_fusion->branch_if_true : m_fusion->branch_if_false;
+                instruction.destination = 0;
+                instruction.argument = branch_if;
+                m_fixups.append({ *m_last_result, label });
+                m_last_result = {};
+                return;
+            }
+        }
+        emit_jump(Instructions::br_if, branch_if ? test_and_branch<u32, false> : test_and_branch<u32, true>, label, condition, branch_if);
+    }
+
+    template<typename ReadT, typename PushT>
+    ErrorOr<void> emit_load(Instruction const& instruction)
+    {
+        auto& argument = instruction.arguments().get<Instruction::MemoryArgument>();
+        if (argument.memory_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        emit_result(load_from_memory<ReadT, PushT>, pop(), 0, 0, argument.offset);
+        return {};
+    }
+
+    template<typename PopT, typename StoreT>
+    ErrorOr<void> emit_store(Instruction const& instruction)
+    {
+        auto& argument = instruction.arguments().get<Instruction::MemoryArgument>();
+        if (argument.memory_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        auto value = pop();
+        auto base = pop();
+        emit(store_to_memory<PopT, StoreT>, 0, base, value, 0, argument.offset);
+        return {};
+    }
+
+    template<typename PopT, typename Operator, typename RhsT = PopT>
+    void emit_vector_binary()
+    {
+        auto rhs = pop();
+        auto lhs = pop();
+        emit_result(vector_binary_operation<PopT, Operator, RhsT>, lhs, rhs);
+    }
+
+    template<typename PopT, typename Operator>
+    void emit_vector_unary()
+    {
+        emit_result(vector_unary_operation<PopT, Operator>, pop());
+    }
+
+    template<typename ReadT, typename Operator = void>
+    ErrorOr<void> emit_vector_load(Instruction const& instruction)
+    {
+        auto& argument = instruction.arguments().get<Instruction::MemoryArgument>();
+        if (argument.memory_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        emit_result(load_vector_from_memory<ReadT, Operator>, pop(), 0, 0, argument.offset);
+        return {};
+    }
+
+    ErrorOr<void> emit_vector_store(Instruction const& instruction)
+    {
+        auto& argument = instruction.arguments().get<Instruction::MemoryArgument>();
+        if (argument.memory_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        auto value = pop();
+        auto base = pop();
+        emit(store_vector_to_memory, 0, base, value, 0, argument.offset);
+        return {};
+    }
+
+    template<typename VectorT>
+    ErrorOr<void> emit_load_lane(Instruction const& instruction)
+    {
+        auto& argument = instruction.arguments().get<Instruction::MemoryAndLaneArgument>();
+        if (argument.memory.memory_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        auto vector = pop();
+        auto base = pop();
+        emit_result(load_lane_from_memory<VectorT>, base, vector, argument.lane, argument.memory.offset);
+        return {};
+    }
+
+    template<typename VectorT>
+    ErrorOr<void> emit_store_lane(Instruction const& instruction)
+    {
+        auto& argument = instruction.arguments().get<Instruction::MemoryAndLaneArgument>();
+        if (argument.memory.memory_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        auto vector = pop();
+        auto base = pop();
+        emit(store_lane_to_memory<VectorT>, 0, base, vector, argument.lane, argument.memory.offset);
+        return {};
+    }
+
+    template<typename VectorT, typename PushT>
+    void emit_extract_lane(Instruction const& instruction)
+    {
+        emit_result(extract_lane<VectorT, PushT>, pop(), 0, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    }
+
+    template<typename VectorT, typename PopT>
+    void emit_replace_lane(Instruction const& instruction)
+    {
+        auto value = pop();
+        auto vector = pop();
+        emit_result(replace_lane<VectorT, PopT>, vector, value, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    }
+
+    size_t new_label()
+    {
+        m_labels.append({});
+        return m_labels.size() - 1;
+    }
+
+    void bind_label(size_t label)
+    {
+        m_labels[label] = m_function.m_instructions.size();
+        // Anything emitted from here on may be reached from elsewhere, so it can't be merged with what came before.
+        m_last_result = {};
+    }
+
+    void materialize(size_t height)
+    {
+        if (m_stack[height] != stack_slot(height)) {
+            emit_move(stack_slot(height), m_stack[height]);
+            m_stack[height] = stack_slot(height);
+        }
+    }
+
+    void materialize_all()
+    {
+        for (size_t height = 0; height < m_stack.size(); ++height)
+            materialize(height);
+    }
+
+    // Copies the values on the stack that still refer to the local before it gets overwritten.
+    void materialize_local(u32 local)
+    {
+        for (size_t height = 0; height < m_stack.size(); ++height) {
+            if (m_stack[height] == local)
+                materialize(height);
+        }
+    }
+
+    bool branch_needs_moves(ControlFrame const& frame) const
+    {
+        auto arity = frame.branch_arity();
+        for (size_t i = 0; i < arity; ++i) {
+            if (m_stack[m_stack.size() - arity + i] != stack_slot(frame.height + i))
+                return true;
+        }
+        return false;
+    }
+
+    void emit_branch_moves(ControlFrame const& frame)
+    {
+        // NOTE: The values only ever move down the stack, so going from the bottom up never clobbers one that's still needed.
+        auto arity = frame.branch_arity();
+        for (size_t i = 0; i < arity; ++i)
+            emit_move(stack_slot(frame.height + i), m_stack[m_stack.size() - arity + i]);
+    }
+
+    void emit_branch(ControlFrame const& frame)
+    {
+        emit_branch_moves(frame);
+        emit_jump(Instructions::br, jump, frame.label);
+    }
+
+    void set_unreachable()
+    {
+        m_control.last().unreachable = true;
+        m_stack.resize(m_control.last().height);
+    }
+
+    // Writes the value of the local from the top of the stack, preferably by having the instruction that produced it write there directly.
+    void set_local(u32 local, u32 source)
+    {
+        materialize_local(local);
+        if ((source & stack_tag) && m_last_result.has_value()) {
+            auto& instruction = m_function.m_instructions[*m_last_result];
+            if (instruction.destination == source) {
+                instruction.destination = local;
+                m_last_result = {};
+                return;
+            }
+        }
+        emit_move(local, source);
+    }
+
+    RegisterFunction& m_function;
+    Module::Function const& m_code;
+    ModuleInstance const& m_module;
+    Store& m_store;
+
+    Vector<u32> m_stack;
+    size_t m_max_stack_height { 0 };
+    Vector<ControlFrame> m_control;
+    Vector<Optional<size_t>> m_labels;
+    Vector<Fixup> m_fixups;
+    Vector<size_t> m_jump_table_labels;
+    HashMap<u64, u32> m_constants;
+
+    // The instruction being translated.
+    OpCode m_opcode;
+
+    // The last instruction, if it only wrote a new value to the top of the stack and nothing has been emitted since.
+    Optional<size_t> m_last_result;
+    Optional<Fusion> m_fusion;
+};
+
+ErrorOr<void> RegisterFunction::Translator::translate()
+{
+    auto& type = m_function.m_type;
+    if (!is_supported(type.parameters()) || !is_supported(type.results()) || !is_supported(m_code.locals()))
+        return Error::from_string_literal("Only numeric and vector locals and results are supported");
+
+    m_function.m_local_count = type.parameters().size() + m_code.locals().size();
+    if (uses_vectors())
+        m_function.m_slot_width = 2;
+    if (m_function.m_local_count * m_function.m_slot_width >= constant_tag)
+        return Error::from_string_literal("Too many locals");
+    if (!m_module.memories().is_empty())
+        m_function.m_memory = m_module.memories().first();
+
+    m_control.append({ ControlFrame::Kind::Function, 0, 0, type.results().size(), new_label(), {}, false });
+
+    // Code after an unconditional branch is never executed, so skip ahead to the end of its block.
+    size_t unreachable_depth = 0;
+    for (auto& instruction : m_code.body().instructions()) {
+        if (m_control.last().unreachable) {
+            auto opcode = instruction.opcode();
+            if (opcode == Instructions::block || opcode == Instructions::loop || opcode == Instructions::if_) {
+                ++unreachable_depth;
+                continue;
+            }
+            if (opcode != Instructions::structured_end && opcode != Instructions::structured_else)
+                continue;
+            if (unreachable_depth != 0) {
+                if (opcode == Instructions::structured_end)
+                    --unreachable_depth;
+                continue;
+            }
+        }
+        TRY(translate(instruction));
+    }
+
+    // The function body doesn't end with an explicit end, so close the function's frame by hand.
+    VERIFY(m_control.size() == 1);
+    end();
+    finalize();
+    return {};
+}
+
+ErrorOr<void> RegisterFunction::Translator::begin_block(ControlFrame::Kind kind, Instruction const& instruction)
+{
+    auto& block_type = instruction.arguments().get<Instruction::StructuredInstructionArgs>().block_type;
+    size_t parameter_count = 0;
+    size_t result_count = 0;
+    switch (block_type.kind()) {
+    case BlockType::Empty:
+        break;
+    case BlockType::Type:
+        result_count = 1;
+        break;
+    case BlockType::Index: {
+        auto& type = m_module.types()[block_type.type_index().value()];
+        parameter_count = type.parameters().size();
+        result_count = type.results().size();
+        break;
+    }
+    }
+
+    Optional<u32> condition;
+    if (kind == ControlFrame::Kind::If)
+        condition = pop();
+
+    // Branches may leave the block from different points, so they have to agree on where every value on the stack lives.
+    materialize_all();
+
+    ControlFrame frame { kind, m_stack.size() - parameter_count, parameter_count, result_count, new_label(), {}, false };
+    if (kind == ControlFrame::Kind::Loop)
+        bind_label(frame.label);
+    if (kind == ControlFrame::Kind::If) {
+        frame.else_label = new_label();
+        emit_branch_if(*condition, false, *frame.else_label);
+    }
+    m_control.append(frame);
+    return {};
+}
+
+void RegisterFunction::Translator::else_()
+{
+    auto& frame = m_control.last();
+    VERIFY(frame.kind == ControlFrame::Kind::If && frame.else_label.has_value());
+    if (!frame.unreachable)
+        emit_branch(frame);
+
+    // The parameters are still where the if left them.
+    bind_label(*frame.else_label);
+    frame.else_label = {};
+    frame.unreachable = false;
+    m_stack.resize(frame.height);
+    for (size_t i = 0; i < frame.parameter_count; ++i)
+        push();
+}
+
+void RegisterFunction::Translator::end()
+{
+    auto frame = m_control.take_last();
+    if (!frame.unreachable) {
+        for (size_t i = 0; i < frame.result_count; ++i)
+            materialize(frame.height + i);
+    }
+
+    // An if without an else passes its parameters on as its results.
+    if (frame.else_label.has_value())
+        bind_label(*frame.else_label);
+    if (frame.kind != ControlFrame::Kind::Loop)
+        bind_label(frame.label);
+
+    m_stack.resize(frame.height);
+    for (size_t i = 0; i < frame.result_count; ++i)
+        push();
+
+    if (frame.kind == ControlFrame::Kind::Function)
+        emit_tagged(Instructions::return_, return_from_function);
+}
+
+bool RegisterFunction::Translator::uses_vectors() const
+{
+    auto has_vector = [](Vector<ValueType> const& types) { return any_of(types, [](auto& type) { return type.is_vector(); }); };
+    auto& type = m_function.m_type;
+    if (has_vector(type.parameters()) || has_vector(type.results()) || has_vector(m_code.locals()))
+        return true;
+
+    for (auto& instruction : m_code.body().instructions()) {
+        auto opcode = instruction.opcode();
+        if ((opcode.value() >> 56) == 0xfd)
+            return true;
+
+        // Vectors can also come in from outside, and have to be passed out the same way.
+        FunctionType const* callee_type = nullptr;
+        if (opcode == Instructions::call) {
+            auto address = m_module.functions()[instruction.arguments().get<FunctionIndex>().value()];
+            m_store.get(address)->visit([&](auto const& function) { callee_type = &function.type(); });
+        } else if (opcode == Instructions::call_indirect) {
+            callee_type = &m_module.types()[instruction.arguments().get<Instruction::IndirectCallArgs>().type.value()];
+        } else if (opcode == Instructions::global_get || opcode == Instructions::global_set) {
+            auto address = m_module.globals()[instruction.arguments().get<GlobalIndex>().value()];
+            if (m_store.get(address)->type().type().is_vector())
+                return true;
+        }
+        if (callee_type && (has_vector(callee_type->parameters()) || has_vector(callee_type->results())))
+            return true;
+    }
+    return false;
+}
+
+void RegisterFunction::Translator::finalize()
+{
+    auto width = m_function.m_slot_width;
+    auto stack_base = m_function.m_local_count * width + m_function.m_constants.size();
+    m_function.m_frame_size = stack_base + m_max_stack_height * width;
+
+    auto resolve = [&](u32& slot) {
+        if (slot & stack_tag)
+            slot = stack_base + (slot & ~stack_tag);
+        else if (slot & constant_tag)
+            slot = m_function.m_local_count * width + (slot & ~constant_tag);
+    };
+
+    auto& instructions = m_function.m_instructions;
+    for (auto& instruction : instructions) {
+        resolve(instruction.destination);
+        resolve(instruction.lhs);
+        resolve(instruction.rhs);
+        resolve(instruction.argument);
+    }
+
+    for (auto& fixup : m_fixups)
+        instructions[fixup.instruction].target = &instructions[m_labels[fixup.label].value()];
+
+    m_function.m_jump_table.ensure_capacity(m_jump_table_labels.size());
+    for (auto label : m_jump_table_labels)
+        m_function.m_jump_table.unchecked_append(&instructions[m_labels[label].value()]);
+}
+
+ErrorOr<void> RegisterFunction::Translator::translate(Instruction const& instruction)
+{
+    m_opcode = instruction.opcode();
+    switch (instruction.opcode().value()) {
+    case Instructions::unreachable.value():
+        emit(trap_unreachable);
+        set_unreachable();
+        return {};
+    case Instructions::nop.value():
+        return {};
+    case Instructions::block.value():
+        return begin_block(ControlFrame::Kind::Block, instruction);
+    case Instructions::loop.value():
+        return begin_block(ControlFrame::Kind::Loop, instruction);
+    case Instructions::if_.value():
+        return begin_block(ControlFrame::Kind::If, instruction);
+    case Instructions::structured_else.value():
+        else_();
+        return {};
+    case Instructions::structured_end.value():
+        end();
+        return {};
+    case Instructions::br.value(): {
+        auto& frame = m_control[m_control.size() - 1 - instruction.arguments().get<LabelIndex>().value()];
+        emit_branch(frame);
+        set_unreachable();
+        return {};
+    }
+    case Instructions::br_if.value(): {
+        auto condition = pop();
+        auto& frame = m_control[m_control.size() - 1 - instruction.arguments().get<LabelIndex>().value()];
+        if (!branch_needs_moves(frame)) {
+            emit_branch_if(condition, true, frame.label);
+            return {};
+        }
+        auto skip_label = new_label();
+        emit_branch_if(condition, false, skip_label);
+        emit_branch(frame);
+        bind_label(skip_label);
+        return {};
+    }
+    case Instructions::br_table.value(): {
+        auto& arguments = instruction.arguments().get<Instruction::TableBranchArgs>();
+        auto index = pop();
+
+        // Targets that need values moved around first get a stub that does so, shared between all entries with the same target.
+        HashMap<size_t, size_t> stub_labels;
+        auto offset = m_jump_table_labels.size();
+        auto add_target = [&](LabelIndex label_index) {
+            auto depth = label_index.value();
+            auto& frame = m_control[m_control.size() - 1 - depth];
+            if (!branch_needs_moves(frame)) {
+                m_jump_table_labels.append(frame.label);
+                return;
+            }
+            m_jump_table_labels.append(stub_labels.ensure(depth, [&] { return new_label(); }));
+        };
+        for (auto label : arguments.labels)
+            add_target(label);
+        add_target(arguments.default_);
+
+        emit(branch_table, 0, index, m_jump_table_labels.size() - offset, offset);
+        for (auto& [depth, label] : stub_labels) {
+            bind_label(label);
+            emit_branch(m_control[m_control.size() - 1 - depth]);
+        }
+        set_unreachable();
+        return {};
+    }
+    case Instructions::return_.value():
+        emit_branch(m_control.first());
+        set_unreachable();
+        return {};
+    case Instructions::call.value():
+    case Instructions::call_indirect.value(): {
+        // The address of the function, or that of the table for indirect calls.
+        u64 immediate = 0;
+        u32 type_index = 0;
+        FunctionType const* type = nullptr;
+        Optional<u32> index;
+        if (instruction.opcode() == Instructions::call) {
+            auto address = m_module.functions()[instruction.arguments().get<FunctionIndex>().value()];
+            m_store.get(address)->visit([&](auto const& function) { type = &function.type(); });
+            immediate = address.value();
+        } else {
+            auto& arguments = instruction.arguments().get<Instruction::IndirectCallArgs>();
+            immediate = m_module.tables()[arguments.table.value()].value();
+            type_index = arguments.type.value();
+            type = &m_module.types()[type_index];
+            index = pop();
+        }
+        if (!is_supported(type->parameters()) || !is_supported(type->results()))
+            return Error::from_string_literal("Only calls with numeric and vector arguments and results are supported");
+
+        // The arguments have to sit right next to each other, as they become the callee's first locals.
+        auto base = m_stack.size() - type->parameters().size();
+        for (size_t height = base; height < m_stack.size(); ++height)
+            materialize(height);
+        m_stack.resize(base);
+
+        if (index.has_value())
+            emit(call_indirect, 0, stack_slot(base), *index, type_index, immediate);
+        else
+            emit(call_function, 0, stack_slot(base), 0, 0, immediate);
+        for (size_t i = 0; i < type->results().size(); ++i)
+            push();
+        return {};
+    }
+    case Instructions::drop.value():
+        pop();
+        return {};
+    case Instructions::select.value():
+    case Instructions::select_typed.value(): {
+        auto condition = pop();
+        auto rhs = pop();
+        auto lhs = pop();
+        emit_result(m_function.m_slot_width == 2 ? select_wide_value : select_value, lhs, rhs, condition);
+        return {};
+    }
+    case Instructions::local_get.value():
+        m_stack.append(local_slot(instruction.arguments().get<LocalIndex>().value()));
+        m_max_stack_height = max(m_max_stack_height, m_stack.size());
+        return {};
+    case Instructions::local_set.value(): {
+        auto source = pop();
+        set_local(local_slot(instruction.arguments().get<LocalIndex>().value()), source);
+        return {};
+    }
+    case Instructions::local_tee.value(): {
+        auto local = local_slot(instruction.arguments().get<LocalIndex>().value());
+        set_local(local, pop());
+        m_stack.append(local);
+        return {};
+    }
+    case Instructions::global_get.value():
+    case Instructions::global_set.value(): {
+        auto address = m_module.globals()[instruction.arguments().get<GlobalIndex>().value()];
+        if (!is_supported(m_store.get(address)->type().type()))
+            return Error::from_string_literal("Only numeric and vector globals are supported");
+        if (instruction.opcode() == Instructions::global_get)
+            emit_result(global_get, 0, 0, 0, address.value());
+        else
+            emit(global_set, 0, pop(), 0, 0, address.value());
+        return {};
+    }
+    case Instructions::i32_const.value():
+        push_constant(constant(to_slot(instruction.arguments().get<i32>())));
+        return {};
+    case Instructions::i64_const.value():
+        push_constant(constant(to_slot(instruction.arguments().get<i64>())));
+        return {};
+    case Instructions::f32_const.value():
+        push_constant(constant(to_slot(instruction.arguments().get<float>())));
+        return {};
+    case Instructions::f64_const.value():
+        push_constant(constant(to_slot(instruction.arguments().get<double>())));
+        return {};
+    case Instructions::i32_load.value():
+        return emit_load<i32, i32>(instruction);
+    case Instructions::i64_load.value():
+        return emit_load<i64, i64>(instruction);
+    case Instructions::f32_load.value():
+        return emit_load<float, float>(instruction);
+    case Instructions::f64_load.value():
+        return emit_load<double, double>(instruction);
+    case Instructions::i32_load8_s.value():
+        return emit_load<i8, i32>(instruction);
+    case Instructions::i32_load8_u.value():
+        return emit_load<u8, i32>(instruction);
+    case Instructions::i32_load16_s.value():
+        return emit_load<i16, i32>(instruction);
+    case Instructions::i32_load16_u.value():
+        return emit_load<u16, i32>(instruction);
+    case Instructions::i64_load8_s.value():
+        return emit_load<i8, i64>(instruction);
+    case Instructions::i64_load8_u.value():
+        return emit_load<u8, i64>(instruction);
+    case Instructions::i64_load16_s.value():
+        return emit_load<i16, i64>(instruction);
+    case Instructions::i64_load16_u.value():
+        return emit_load<u16, i64>(instruction);
+    case Instructions::i64_load32_s.value():
+        return emit_load<i32, i64>(instruction);
+    case Instructions::i64_load32_u.value():
+        return emit_load<u32, i64>(instruction);
+    case Instructions::i32_store.value():
+        return emit_store<i32, i32>(instruction);
+    case Instructions::i64_store.value():
+        return emit_store<i64, i64>(instruction);
+    case Instructions::f32_store.value():
+        return emit_store<float, float>(instruction);
+    case Instructions::f64_store.value():
+        return emit_store<double, double>(instruction);
+    case Instructions::i32_store8.value():
+        return emit_store<i32, i8>(instruction);
+    case Instructions::i32_store16.value():
+        return emit_store<i32, i16>(instruction);
+    case Instructions::i64_store8.value():
+        return emit_store<i64, i8>(instruction);
+    case Instructions::i64_store16.value():
+        return emit_store<i64, i16>(instruction);
+    case Instructions::i64_store32.value():
+        return emit_store<i64, i32>(instruction);
+    case Instructions::memory_size.value():
+    case Instructions::memory_grow.value():
+    case Instructions::memory_fill.value(): {
+        if (instruction.arguments().get<Instruction::MemoryIndexArgument>().memory_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        if (instruction.opcode() == Instructions::memory_size) {
+            emit_result(memory_size);
+        } else if (instruction.opcode() == Instructions::memory_grow) {
+            emit_result(memory_grow, pop());
+        } else {
+            auto count = pop();
+            auto value = pop();
+            auto destination = pop();
+            emit(memory_fill, destination, value, count);
+        }
+        return {};
+    }
+    case Instructions::memory_copy.value(): {
+        auto& arguments = instruction.arguments().get<Instruction::MemoryCopyArgs>();
+        if (arguments.src_index.value() != 0 || arguments.dst_index.value() != 0)
+            return Error::from_string_literal("Multiple memories are not supported");
+        auto count = pop();
+        auto source = pop();
+        auto destination = pop();
+        emit(memory_copy, destination, source, count);
+        return {};
+    }
+    case Instructions::i32_eqz.value():
+        emit_equals_zero<u32>();
+        return {};
+    case Instructions::i32_eq.value():
+        emit_comparison<i32, Operators::Equals>();
+        return {};
+    case Instructions::i32_ne.value():
+        emit_comparison<i32, Operators::NotEquals>();
+        return {};
+    case Instructions::i32_lts.value():
+        emit_comparison<i32, Operators::LessThan>();
+        return {};
+    case Instructions::i32_ltu.value():
+        emit_comparison<u32, Operators::LessThan>();
+        return {};
+    case Instructions::i32_gts.value():
+        emit_comparison<i32, Operators::GreaterThan>();
+        return {};
+    case Instructions::i32_gtu.value():
+        emit_comparison<u32, Operators::GreaterThan>();
+        return {};
+    case Instructions::i32_les.value():
+        emit_comparison<i32, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i32_leu.value():
+        emit_comparison<u32, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i32_ges.value():
+        emit_comparison<i32, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i32_geu.value():
+        emit_comparison<u32, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i64_eqz.value():
+        emit_equals_zero<u64>();
+        return {};
+    case Instructions::i64_eq.value():
+        emit_comparison<i64, Operators::Equals>();
+        return {};
+    case Instructions::i64_ne.value():
+        emit_comparison<i64, Operators::NotEquals>();
+        return {};
+    case Instructions::i64_lts.value():
+        emit_comparison<i64, Operators::LessThan>();
+        return {};
+    case Instructions::i64_ltu.value():
+        emit_comparison<u64, Operators::LessThan>();
+        return {};
+    case Instructions::i64_gts.value():
+        emit_comparison<i64, Operators::GreaterThan>();
+        return {};
+    case Instructions::i64_gtu.value():
+        emit_comparison<u64, Operators::GreaterThan>();
+        return {};
+    case Instructions::i64_les.value():
+        emit_comparison<i64, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i64_leu.value():
+        emit_comparison<u64, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i64_ges.value():
+        emit_comparison<i64, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i64_geu.value():
+        emit_comparison<u64, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::f32_eq.value():
+        emit_comparison<float, Operators::Equals>();
+        return {};
+    case Instructions::f32_ne.value():
+        emit_comparison<float, Operators::NotEquals>();
+        return {};
+    case Instructions::f32_lt.value():
+        emit_comparison<float, Operators::LessThan>();
+        return {};
+    case Instructions::f32_gt.value():
+        emit_comparison<float, Operators::GreaterThan>();
+        return {};
+    case Instructions::f32_le.value():
+        emit_comparison<float, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::f32_ge.value():
+        emit_comparison<float, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::f64_eq.value():
+        emit_comparison<double, Operators::Equals>();
+        return {};
+    case Instructions::f64_ne.value():
+        emit_comparison<double, Operators::NotEquals>();
+        return {};
+    case Instructions::f64_lt.value():
+        emit_comparison<double, Operators::LessThan>();
+        return {};
+    case Instructions::f64_gt.value():
+        emit_comparison<double, Operators::GreaterThan>();
+        return {};
+    case Instructions::f64_le.value():
+        emit_comparison<double, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::f64_ge.value():
+        emit_comparison<double, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i32_clz.value():
+        emit_unary<i32, i32, Operators::CountLeadingZeros>();
+        return {};
+    case Instructions::i32_ctz.value():
+        emit_unary<i32, i32, Operators::CountTrailingZeros>();
+        return {};
+    case Instructions::i32_popcnt.value():
+        emit_unary<i32, i32, Operators::PopCount>();
+        return {};
+    case Instructions::i32_add.value():
+        emit_binary<u32, i32, Operators::Add>();
+        return {};
+    case Instructions::i32_sub.value():
+        emit_binary<u32, i32, Operators::Subtract>();
+        return {};
+    case Instructions::i32_mul.value():
+        emit_binary<u32, i32, Operators::Multiply>();
+        return {};
+    case Instructions::i32_divs.value():
+        emit_binary<i32, i32, Operators::Divide>();
+        return {};
+    case Instructions::i32_divu.value():
+        emit_binary<u32, i32, Operators::Divide>();
+        return {};
+    case Instructions::i32_rems.value():
+        emit_binary<i32, i32, Operators::Modulo>();
+        return {};
+    case Instructions::i32_remu.value():
+        emit_binary<u32, i32, Operators::Modulo>();
+        return {};
+    case Instructions::i32_and.value():
+        emit_binary<i32, i32, Operators::BitAnd>();
+        return {};
+    case Instructions::i32_or.value():
+        emit_binary<i32, i32, Operators::BitOr>();
+        return {};
+    case Instructions::i32_xor.value():
+        emit_binary<i32, i32, Operators::BitXor>();
+        return {};
+    case Instructions::i32_shl.value():
+        emit_binary<u32, i32, Operators::BitShiftLeft>();
+        return {};
+    case Instructions::i32_shrs.value():
+        emit_binary<i32, i32, Operators::BitShiftRight>();
+        return {};
+    case Instructions::i32_shru.value():
+        emit_binary<u32, i32, Operators::BitShiftRight>();
+        return {};
+    case Instructions::i32_rotl.value():
+        emit_binary<u32, i32, Operators::BitRotateLeft>();
+        return {};
+    case Instructions::i32_rotr.value():
+        emit_binary<u32, i32, Operators::BitRotateRight>();
+        return {};
+    case Instructions::i64_clz.value():
+        emit_unary<i64, i64, Operators::CountLeadingZeros>();
+        return {};
+    case Instructions::i64_ctz.value():
+        emit_unary<i64, i64, Operators::CountTrailingZeros>();
+        return {};
+    case Instructions::i64_popcnt.value():
+        emit_unary<i64, i64, Operators::PopCount>();
+        return {};
+    case Instructions::i64_add.value():
+        emit_binary<u64, i64, Operators::Add>();
+        return {};
+    case Instructions::i64_sub.value():
+        emit_binary<u64, i64, Operators::Subtract>();
+        return {};
+    case Instructions::i64_mul.value():
+        emit_binary<u64, i64, Operators::Multiply>();
+        return {};
+    case Instructions::i64_divs.value():
+        emit_binary<i64, i64, Operators::Divide>();
+        return {};
+    case Instructions::i64_divu.value():
+        emit_binary<u64, i64, Operators::Divide>();
+        return {};
+    case Instructions::i64_rems.value():
+        emit_binary<i64, i64, Operators::Modulo>();
+        return {};
+    case Instructions::i64_remu.value():
+        emit_binary<u64, i64, Operators::Modulo>();
+        return {};
+    case Instructions::i64_and.value():
+        emit_binary<i64, i64, Operators::BitAnd>();
+        return {};
+    case Instructions::i64_or.value():
+        emit_binary<i64, i64, Operators::BitOr>();
+        return {};
+    case Instructions::i64_xor.value():
+        emit_binary<i64, i64, Operators::BitXor>();
+        return {};
+    case Instructions::i64_shl.value():
+        emit_binary<u64, i64, Operators::BitShiftLeft>();
+        return {};
+    case Instructions::i64_shrs.value():
+        emit_binary<i64, i64, Operators::BitShiftRight>();
+        return {};
+    case Instructions::i64_shru.value():
+        emit_binary<u64, i64, Operators::BitShiftRight>();
+        return {};
+    case Instructions::i64_rotl.value():
+        emit_binary<u64, i64, Operators::BitRotateLeft>();
+        return {};
+    case Instructions::i64_rotr.value():
+        emit_binary<u64, i64, Operators::BitRotateRight>();
+        return {};
+    case Instructions::f32_abs.value():
+        emit_unary<float, float, Operators::Absolute>();
+        return {};
+    case Instructions::f32_neg.value():
+        emit_unary<float, float, Operators::Negate>();
+        return {};
+    case Instructions::f32_ceil.value():
+        emit_unary<float, float, Operators::Ceil>();
+        return {};
+    case Instructions::f32_floor.value():
+        emit_unary<float, float, Operators::Floor>();
+        return {};
+    case Instructions::f32_trunc.value():
+        emit_unary<float, float, Operators::Truncate>();
+        return {};
+    case Instructions::f32_nearest.value():
+        emit_unary<float, float, Operators::NearbyIntegral>();
+        return {};
+    case Instructions::f32_sqrt.value():
+        emit_unary<float, float, Operators::SquareRoot>();
+        return {};
+    case Instructions::f32_add.value():
+        emit_binary<float, float, Operators::Add>();
+        return {};
+    case Instructions::f32_sub.value():
+        emit_binary<float, float, Operators::Subtract>();
+        return {};
+    case Instructions::f32_mul.value():
+        emit_binary<float, float, Operators::Multiply>();
+        return {};
+    case Instructions::f32_div.value():
+        emit_binary<float, float, Operators::Divide>();
+        return {};
+    case Instructions::f32_min.value():
+        emit_binary<float, float, Operators::Minimum>();
+        return {};
+    case Instructions::f32_max.value():
+        emit_binary<float, float, Operators::Maximum>();
+        return {};
+    case Instructions::f32_copysign.value():
+        emit_binary<float, float, Operators::CopySign>();
+        return {};
+    case Instructions::f64_abs.value():
+        emit_unary<double, double, Operators::Absolute>();
+        return {};
+    case Instructions::f64_neg.value():
+        emit_unary<double, double, Operators::Negate>();
+        return {};
+    case Instructions::f64_ceil.value():
+        emit_unary<double, double, Operators::Ceil>();
+        return {};
+    case Instructions::f64_floor.value():
+        emit_unary<double, double, Operators::Floor>();
+        return {};
+    case Instructions::f64_trunc.value():
+        emit_unary<double, double, Operators::Truncate>();
+        return {};
+    case Instructions::f64_nearest.value():
+        emit_unary<double, double, Operators::NearbyIntegral>();
+        return {};
+    case Instructions::f64_sqrt.value():
+        emit_unary<double, double, Operators::SquareRoot>();
+        return {};
+    case Instructions::f64_add.value():
+        emit_binary<double, double, Operators::Add>();
+        return {};
+    case Instructions::f64_sub.value():
+        emit_binary<double, double, Operators::Subtract>();
+        return {};
+    case Instructions::f64_mul.value():
+        emit_binary<double, double, Operators::Multiply>();
+        return {};
+    case Instructions::f64_div.value():
+        emit_binary<double, double, Operators::Divide>();
+        return {};
+    case Instructions::f64_min.value():
+        emit_binary<double, double, Operators::Minimum>();
+        return {};
+    case Instructions::f64_max.value():
+        emit_binary<double, double, Operators::Maximum>();
+        return {};
+    case Instructions::f64_copysign.value():
+        emit_binary<double, double, Operators::CopySign>();
+        return {};
+    case Instructions::i32_wrap_i64.value():
+        emit_unary<i64, i32, Operators::Wrap<i32>>();
+        return {};
+    case Instructions::i32_trunc_sf32.value():
+        emit_unary<float, i32, Operators::CheckedTruncate<i32>>();
+        return {};
+    case Instructions::i32_trunc_uf32.value():
+        emit_unary<float, i32, Operators::CheckedTruncate<u32>>();
+        return {};
+    case Instructions::i32_trunc_sf64.value():
+        emit_unary<double, i32, Operators::CheckedTruncate<i32>>();
+        return {};
+    case Instructions::i32_trunc_uf64.value():
+        emit_unary<double, i32, Operators::CheckedTruncate<u32>>();
+        return {};
+    case Instructions::i64_trunc_sf32.value():
+        emit_unary<float, i64, Operators::CheckedTruncate<i64>>();
+        return {};
+    case Instructions::i64_trunc_uf32.value():
+        emit_unary<float, i64, Operators::CheckedTruncate<u64>>();
+        return {};
+    case Instructions::i64_trunc_sf64.value():
+        emit_unary<double, i64, Operators::CheckedTruncate<i64>>();
+        return {};
+    case Instructions::i64_trunc_uf64.value():
+        emit_unary<double, i64, Operators::CheckedTruncate<u64>>();
+        return {};
+    case Instructions::i64_extend_si32.value():
+        emit_unary<i32, i64, Operators::Extend<i64>>();
+        return {};
+    case Instructions::i64_extend_ui32.value():
+        emit_unary<u32, i64, Operators::Extend<i64>>();
+        return {};
+    case Instructions::f32_convert_si32.value():
+        emit_unary<i32, float, Operators::Convert<float>>();
+        return {};
+    case Instructions::f32_convert_ui32.value():
+        emit_unary<u32, float, Operators::Convert<float>>();
+        return {};
+    case Instructions::f32_convert_si64.value():
+        emit_unary<i64, float, Operators::Convert<float>>();
+        return {};
+    case Instructions::f32_convert_ui64.value():
+        emit_unary<u64, float, Operators::Convert<float>>();
+        return {};
+    case Instructions::f32_demote_f64.value():
+        emit_unary<double, float, Operators::Demote>();
+        return {};
+    case Instructions::f64_convert_si32.value():
+        emit_unary<i32, double, Operators::Convert<double>>();
+        return {};
+    case Instructions::f64_convert_ui32.value():
+        emit_unary<u32, double, Operators::Convert<double>>();
+        return {};
+    case Instructions::f64_convert_si64.value():
+        emit_unary<i64, double, Operators::Convert<double>>();
+        return {};
+    case Instructions::f64_convert_ui64.value():
+        emit_unary<u64, double, Operators::Convert<double>>();
+        return {};
+    case Instructions::f64_promote_f32.value():
+        emit_unary<float, double, Operators::Promote>();
+        return {};
+    case Instructions::i32_reinterpret_f32.value():
+        emit_unary<float, i32, Operators::Reinterpret<i32>>();
+        return {};
+    case Instructions::i64_reinterpret_f64.value():
+        emit_unary<double, i64, Operators::Reinterpret<i64>>();
+        return {};
+    case Instructions::f32_reinterpret_i32.value():
+        emit_unary<i32, float, Operators::Reinterpret<float>>();
+        return {};
+    case Instructions::f64_reinterpret_i64.value():
+        emit_unary<i64, double, Operators::Reinterpret<double>>();
+        return {};
+    case Instructions::i32_extend8_s.value():
+        emit_unary<i32, i32, Operators::SignExtend<i8>>();
+        return {};
+    case Instructions::i32_extend16_s.value():
+        emit_unary<i32, i32, Operators::SignExtend<i16>>();
+        return {};
+    case Instructions::i64_extend8_s.value():
+        emit_unary<i64, i64, Operators::SignExtend<i8>>();
+        return {};
+    case Instructions::i64_extend16_s.value():
+        emit_unary<i64, i64, Operators::SignExtend<i16>>();
+        return {};
+    case Instructions::i64_extend32_s.value():
+        emit_unary<i64, i64, Operators::SignExtend<i32>>();
+        return {};
+    case Instructions::i32_trunc_sat_f32_s.value():
+        emit_unary<float, i32, Operators::SaturatingTruncate<i32>>();
+        return {};
+    case Instructions::i32_trunc_sat_f32_u.value():
+        emit_unary<float, i32, Operators::SaturatingTruncate<u32>>();
+        return {};
+    case Instructions::i32_trunc_sat_f64_s.value():
+        emit_unary<double, i32, Operators::SaturatingTruncate<i32>>();
+        return {};
+    case Instructions::i32_trunc_sat_f64_u.value():
+        emit_unary<double, i32, Operators::SaturatingTruncate<u32>>();
+        return {};
+    case Instructions::i64_trunc_sat_f32_s.value():
+        emit_unary<float, i64, Operators::SaturatingTruncate<i64>>();
+        return {};
+    case Instructions::i64_trunc_sat_f32_u.value():
+        emit_unary<float, i64, Operators::SaturatingTruncate<u64>>();
+        return {};
+    case Instructions::i64_trunc_sat_f64_s.value():
+        emit_unary<double, i64, Operators::SaturatingTruncate<i64>>();
+        return {};
+    case Instructions::i64_trunc_sat_f64_u.value():
+        emit_unary<double, i64, Operators::SaturatingTruncate<u64>>();
+        return {};
+    case Instructions::v128_load.value():
+        return emit_vector_load<u8x16>(instruction);
+    case Instructions::v128_load8x8_s.value():
+        return emit_vector_load<i8x8, VectorOperators::Convert<i16x8>>(instruction);
+    case Instructions::v128_load8x8_u.value():
+        return emit_vector_load<u8x8, VectorOperators::Convert<u16x8>>(instruction);
+    case Instructions::v128_load16x4_s.value():
+        return emit_vector_load<i16x4, VectorOperators::Convert<i32x4>>(instruction);
+    case Instructions::v128_load16x4_u.value():
+        return emit_vector_load<u16x4, VectorOperators::Convert<u32x4>>(instruction);
+    case Instructions::v128_load32x2_s.value():
+        return emit_vector_load<i32x2, VectorOperators::Convert<i64x2>>(instruction);
+    case Instructions::v128_load32x2_u.value():
+        return emit_vector_load<u32x2, VectorOperators::Convert<u64x2>>(instruction);
+    case Instructions::v128_load8_splat.value():
+        return emit_vector_load<u8, VectorOperators::Splat<u8x16>>(instruction);
+    case Instructions::v128_load16_splat.value():
+        return emit_vector_load<u16, VectorOperators::Splat<u16x8>>(instruction);
+    case Instructions::v128_load32_splat.value():
+        return emit_vector_load<u32, VectorOperators::Splat<u32x4>>(instruction);
+    case Instructions::v128_load64_splat.value():
+        return emit_vector_load<u64, VectorOperators::Splat<u64x2>>(instruction);
+    case Instructions::v128_store.value():
+        return emit_vector_store(instruction);
+    case Instructions::v128_const.value():
+        push_constant(vector_constant(instruction.arguments().get<u128>()));
+        return {};
+    case Instructions::i8x16_shuffle.value(): {
+        u8x16 lanes;
+        __builtin_memcpy(&lanes, instruction.arguments().get<Instruction::ShuffleArgument>().lanes, sizeof(lanes));
+        auto rhs = pop();
+        auto lhs = pop();
+        emit_result(vector_shuffle, lhs, rhs, vector_constant(bit_cast<u128>(lanes)));
+        return {};
+    }
+    case Instructions::i8x16_swizzle.value():
+        emit_vector_binary<u8x16, VectorOperators::Swizzle>();
+        return {};
+    case Instructions::i8x16_splat.value():
+        emit_vector_unary<i32, VectorOperators::Splat<u8x16>>();
+        return {};
+    case Instructions::i16x8_splat.value():
+        emit_vector_unary<i32, VectorOperators::Splat<u16x8>>();
+        return {};
+    case Instructions::i32x4_splat.value():
+        emit_vector_unary<i32, VectorOperators::Splat<u32x4>>();
+        return {};
+    case Instructions::i64x2_splat.value():
+        emit_vector_unary<i64, VectorOperators::Splat<u64x2>>();
+        return {};
+    case Instructions::f32x4_splat.value():
+        emit_vector_unary<float, VectorOperators::Splat<f32x4>>();
+        return {};
+    case Instructions::f64x2_splat.value():
+        emit_vector_unary<double, VectorOperators::Splat<f64x2>>();
+        return {};
+    case Instructions::i8x16_extract_lane_s.value():
+        emit_extract_lane<i8x16, i32>(instruction);
+        return {};
+    case Instructions::i8x16_extract_lane_u.value():
+        emit_extract_lane<u8x16, i32>(instruction);
+        return {};
+    case Instructions::i8x16_replace_lane.value():
+        emit_replace_lane<u8x16, i32>(instruction);
+        return {};
+    case Instructions::i16x8_extract_lane_s.value():
+        emit_extract_lane<i16x8, i32>(instruction);
+        return {};
+    case Instructions::i16x8_extract_lane_u.value():
+        emit_extract_lane<u16x8, i32>(instruction);
+        return {};
+    case Instructions::i16x8_replace_lane.value():
+        emit_replace_lane<u16x8, i32>(instruction);
+        return {};
+    case Instructions::i32x4_extract_lane.value():
+        emit_extract_lane<i32x4, i32>(instruction);
+        return {};
+    case Instructions::i32x4_replace_lane.value():
+        emit_replace_lane<i32x4, i32>(instruction);
+        return {};
+    case Instructions::i64x2_extract_lane.value():
+        emit_extract_lane<i64x2, i64>(instruction);
+        return {};
+    case Instructions::i64x2_replace_lane.value():
+        emit_replace_lane<i64x2, i64>(instruction);
+        return {};
+    case Instructions::f32x4_extract_lane.value():
+        emit_extract_lane<f32x4, float>(instruction);
+        return {};
+    case Instructions::f32x4_replace_lane.value():
+        emit_replace_lane<f32x4, float>(instruction);
+        return {};
+    case Instructions::f64x2_extract_lane.value():
+        emit_extract_lane<f64x2, double>(instruction);
+        return {};
+    case Instructions::f64x2_replace_lane.value():
+        emit_replace_lane<f64x2, double>(instruction);
+        return {};
+    case Instructions::i8x16_eq.value():
+        emit_vector_binary<i8x16, Operators::Equals>();
+        return {};
+    case Instructions::i8x16_ne.value():
+        emit_vector_binary<i8x16, Operators::NotEquals>();
+        return {};
+    case Instructions::i8x16_lt_s.value():
+        emit_vector_binary<i8x16, Operators::LessThan>();
+        return {};
+    case Instructions::i8x16_lt_u.value():
+        emit_vector_binary<u8x16, Operators::LessThan>();
+        return {};
+    case Instructions::i8x16_gt_s.value():
+        emit_vector_binary<i8x16, Operators::GreaterThan>();
+        return {};
+    case Instructions::i8x16_gt_u.value():
+        emit_vector_binary<u8x16, Operators::GreaterThan>();
+        return {};
+    case Instructions::i8x16_le_s.value():
+        emit_vector_binary<i8x16, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i8x16_le_u.value():
+        emit_vector_binary<u8x16, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i8x16_ge_s.value():
+        emit_vector_binary<i8x16, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i8x16_ge_u.value():
+        emit_vector_binary<u8x16, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i16x8_eq.value():
+        emit_vector_binary<i16x8, Operators::Equals>();
+        return {};
+    case Instructions::i16x8_ne.value():
+        emit_vector_binary<i16x8, Operators::NotEquals>();
+        return {};
+    case Instructions::i16x8_lt_s.value():
+        emit_vector_binary<i16x8, Operators::LessThan>();
+        return {};
+    case Instructions::i16x8_lt_u.value():
+        emit_vector_binary<u16x8, Operators::LessThan>();
+        return {};
+    case Instructions::i16x8_gt_s.value():
+        emit_vector_binary<i16x8, Operators::GreaterThan>();
+        return {};
+    case Instructions::i16x8_gt_u.value():
+        emit_vector_binary<u16x8, Operators::GreaterThan>();
+        return {};
+    case Instructions::i16x8_le_s.value():
+        emit_vector_binary<i16x8, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i16x8_le_u.value():
+        emit_vector_binary<u16x8, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i16x8_ge_s.value():
+        emit_vector_binary<i16x8, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i16x8_ge_u.value():
+        emit_vector_binary<u16x8, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i32x4_eq.value():
+        emit_vector_binary<i32x4, Operators::Equals>();
+        return {};
+    case Instructions::i32x4_ne.value():
+        emit_vector_binary<i32x4, Operators::NotEquals>();
+        return {};
+    case Instructions::i32x4_lt_s.value():
+        emit_vector_binary<i32x4, Operators::LessThan>();
+        return {};
+    case Instructions::i32x4_lt_u.value():
+        emit_vector_binary<u32x4, Operators::LessThan>();
+        return {};
+    case Instructions::i32x4_gt_s.value():
+        emit_vector_binary<i32x4, Operators::GreaterThan>();
+        return {};
+    case Instructions::i32x4_gt_u.value():
+        emit_vector_binary<u32x4, Operators::GreaterThan>();
+        return {};
+    case Instructions::i32x4_le_s.value():
+        emit_vector_binary<i32x4, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i32x4_le_u.value():
+        emit_vector_binary<u32x4, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i32x4_ge_s.value():
+        emit_vector_binary<i32x4, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i32x4_ge_u.value():
+        emit_vector_binary<u32x4, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::f32x4_eq.value():
+        emit_vector_binary<f32x4, Operators::Equals>();
+        return {};
+    case Instructions::f32x4_ne.value():
+        emit_vector_binary<f32x4, Operators::NotEquals>();
+        return {};
+    case Instructions::f32x4_lt.value():
+        emit_vector_binary<f32x4, Operators::LessThan>();
+        return {};
+    case Instructions::f32x4_gt.value():
+        emit_vector_binary<f32x4, Operators::GreaterThan>();
+        return {};
+    case Instructions::f32x4_le.value():
+        emit_vector_binary<f32x4, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::f32x4_ge.value():
+        emit_vector_binary<f32x4, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::f64x2_eq.value():
+        emit_vector_binary<f64x2, Operators::Equals>();
+        return {};
+    case Instructions::f64x2_ne.value():
+        emit_vector_binary<f64x2, Operators::NotEquals>();
+        return {};
+    case Instructions::f64x2_lt.value():
+        emit_vector_binary<f64x2, Operators::LessThan>();
+        return {};
+    case Instructions::f64x2_gt.value():
+        emit_vector_binary<f64x2, Operators::GreaterThan>();
+        return {};
+    case Instructions::f64x2_le.value():
+        emit_vector_binary<f64x2, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::f64x2_ge.value():
+        emit_vector_binary<f64x2, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::v128_not.value():
+        emit_vector_unary<u64x2, VectorOperators::Not>();
+        return {};
+    case Instructions::v128_and.value():
+        emit_vector_binary<u64x2, Operators::BitAnd>();
+        return {};
+    case Instructions::v128_andnot.value():
+        emit_vector_binary<u64x2, VectorOperators::AndNot>();
+        return {};
+    case Instructions::v128_or.value():
+        emit_vector_binary<u64x2, Operators::BitOr>();
+        return {};
+    case Instructions::v128_xor.value():
+        emit_vector_binary<u64x2, Operators::BitXor>();
+        return {};
+    case Instructions::v128_bitselect.value(): {
+        auto mask = pop();
+        auto if_clear = pop();
+        auto if_set = pop();
+        emit_result(vector_bitselect, if_set, if_clear, mask);
+        return {};
+    }
+    case Instructions::v128_any_true.value():
+        emit_vector_unary<u64x2, VectorOperators::AnyTrue>();
+        return {};
+    case Instructions::v128_load8_lane.value():
+        return emit_load_lane<u8x16>(instruction);
+    case Instructions::v128_load16_lane.value():
+        return emit_load_lane<u16x8>(instruction);
+    case Instructions::v128_load32_lane.value():
+        return emit_load_lane<u32x4>(instruction);
+    case Instructions::v128_load64_lane.value():
+        return emit_load_lane<u64x2>(instruction);
+    case Instructions::v128_store8_lane.value():
+        return emit_store_lane<u8x16>(instruction);
+    case Instructions::v128_store16_lane.value():
+        return emit_store_lane<u16x8>(instruction);
+    case Instructions::v128_store32_lane.value():
+        return emit_store_lane<u32x4>(instruction);
+    case Instructions::v128_store64_lane.value():
+        return emit_store_lane<u64x2>(instruction);
+    case Instructions::v128_load32_zero.value():
+        return emit_vector_load<u32, VectorOperators::ZeroExtend<u32x4>>(instruction);
+    case Instructions::v128_load64_zero.value():
+        return emit_vector_load<u64, VectorOperators::ZeroExtend<u64x2>>(instruction);
+    case Instructions::f32x4_demote_f64x2_zero.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::Demote, f32x4>>();
+        return {};
+    case Instructions::f64x2_promote_low_f32x4.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::Promote, f64x2>>();
+        return {};
+    case Instructions::i8x16_abs.value():
+        emit_vector_unary<i8x16, VectorOperators::Absolute>();
+        return {};
+    case Instructions::i8x16_neg.value():
+        emit_vector_unary<i8x16, VectorOperators::Negate>();
+        return {};
+    case Instructions::i8x16_popcnt.value():
+        emit_vector_unary<u8x16, VectorOperators::PopCount>();
+        return {};
+    case Instructions::i8x16_all_true.value():
+        emit_vector_unary<i8x16, VectorOperators::AllTrue>();
+        return {};
+    case Instructions::i8x16_bitmask.value():
+        emit_vector_unary<i8x16, VectorOperators::Bitmask>();
+        return {};
+    case Instructions::i8x16_narrow_i16x8_s.value():
+        emit_vector_binary<i16x8, VectorOperators::Narrow<i8x16>>();
+        return {};
+    case Instructions::i8x16_narrow_i16x8_u.value():
+        emit_vector_binary<i16x8, VectorOperators::Narrow<u8x16>>();
+        return {};
+    case Instructions::f32x4_ceil.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::Ceil>>();
+        return {};
+    case Instructions::f32x4_floor.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::Floor>>();
+        return {};
+    case Instructions::f32x4_trunc.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::Truncate>>();
+        return {};
+    case Instructions::f32x4_nearest.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::NearbyIntegral>>();
+        return {};
+    case Instructions::i8x16_shl.value():
+        emit_vector_binary<u8x16, VectorOperators::ShiftLeft, i32>();
+        return {};
+    case Instructions::i8x16_shr_s.value():
+        emit_vector_binary<i8x16, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i8x16_shr_u.value():
+        emit_vector_binary<u8x16, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i8x16_add.value():
+        emit_vector_binary<u8x16, Operators::Add>();
+        return {};
+    case Instructions::i8x16_add_sat_s.value():
+        emit_vector_binary<i8x16, VectorOperators::SaturatingAdd>();
+        return {};
+    case Instructions::i8x16_add_sat_u.value():
+        emit_vector_binary<u8x16, VectorOperators::SaturatingAdd>();
+        return {};
+    case Instructions::i8x16_sub.value():
+        emit_vector_binary<u8x16, Operators::Subtract>();
+        return {};
+    case Instructions::i8x16_sub_sat_s.value():
+        emit_vector_binary<i8x16, VectorOperators::SaturatingSubtract>();
+        return {};
+    case Instructions::i8x16_sub_sat_u.value():
+        emit_vector_binary<u8x16, VectorOperators::SaturatingSubtract>();
+        return {};
+    case Instructions::f64x2_ceil.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::Ceil>>();
+        return {};
+    case Instructions::f64x2_floor.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::Floor>>();
+        return {};
+    case Instructions::i8x16_min_s.value():
+        emit_vector_binary<i8x16, VectorOperators::Minimum>();
+        return {};
+    case Instructions::i8x16_min_u.value():
+        emit_vector_binary<u8x16, VectorOperators::Minimum>();
+        return {};
+    case Instructions::i8x16_max_s.value():
+        emit_vector_binary<i8x16, VectorOperators::Maximum>();
+        return {};
+    case Instructions::i8x16_max_u.value():
+        emit_vector_binary<u8x16, VectorOperators::Maximum>();
+        return {};
+    case Instructions::f64x2_trunc.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::Truncate>>();
+        return {};
+    case Instructions::i8x16_avgr_u.value():
+        emit_vector_binary<u8x16, VectorOperators::AverageRounded>();
+        return {};
+    case Instructions::i16x8_extadd_pairwise_i8x16_s.value():
+        emit_vector_unary<i8x16, VectorOperators::ExtendAddPairwise<i16x8>>();
+        return {};
+    case Instructions::i16x8_extadd_pairwise_i8x16_u.value():
+        emit_vector_unary<u8x16, VectorOperators::ExtendAddPairwise<u16x8>>();
+        return {};
+    case Instructions::i32x4_extadd_pairwise_i16x8_s.value():
+        emit_vector_unary<i16x8, VectorOperators::ExtendAddPairwise<i32x4>>();
+        return {};
+    case Instructions::i32x4_extadd_pairwise_i16x8_u.value():
+        emit_vector_unary<u16x8, VectorOperators::ExtendAddPairwise<u32x4>>();
+        return {};
+    case Instructions::i16x8_abs.value():
+        emit_vector_unary<i16x8, VectorOperators::Absolute>();
+        return {};
+    case Instructions::i16x8_neg.value():
+        emit_vector_unary<i16x8, VectorOperators::Negate>();
+        return {};
+    case Instructions::i16x8_q15mulr_sat_s.value():
+        emit_vector_binary<i16x8, VectorOperators::Q15MultiplyRoundSaturate>();
+        return {};
+    case Instructions::i16x8_all_true.value():
+        emit_vector_unary<i16x8, VectorOperators::AllTrue>();
+        return {};
+    case Instructions::i16x8_bitmask.value():
+        emit_vector_unary<i16x8, VectorOperators::Bitmask>();
+        return {};
+    case Instructions::i16x8_narrow_i32x4_s.value():
+        emit_vector_binary<i32x4, VectorOperators::Narrow<i16x8>>();
+        return {};
+    case Instructions::i16x8_narrow_i32x4_u.value():
+        emit_vector_binary<i32x4, VectorOperators::Narrow<u16x8>>();
+        return {};
+    case Instructions::i16x8_extend_low_i8x16_s.value():
+        emit_vector_unary<i8x16, VectorOperators::Extend<i16x8, false>>();
+        return {};
+    case Instructions::i16x8_extend_high_i8x16_s.value():
+        emit_vector_unary<i8x16, VectorOperators::Extend<i16x8, true>>();
+        return {};
+    case Instructions::i16x8_extend_low_i8x16_u.value():
+        emit_vector_unary<u8x16, VectorOperators::Extend<u16x8, false>>();
+        return {};
+    case Instructions::i16x8_extend_high_i8x16_u.value():
+        emit_vector_unary<u8x16, VectorOperators::Extend<u16x8, true>>();
+        return {};
+    case Instructions::i16x8_shl.value():
+        emit_vector_binary<u16x8, VectorOperators::ShiftLeft, i32>();
+        return {};
+    case Instructions::i16x8_shr_s.value():
+        emit_vector_binary<i16x8, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i16x8_shr_u.value():
+        emit_vector_binary<u16x8, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i16x8_add.value():
+        emit_vector_binary<u16x8, Operators::Add>();
+        return {};
+    case Instructions::i16x8_add_sat_s.value():
+        emit_vector_binary<i16x8, VectorOperators::SaturatingAdd>();
+        return {};
+    case Instructions::i16x8_add_sat_u.value():
+        emit_vector_binary<u16x8, VectorOperators::SaturatingAdd>();
+        return {};
+    case Instructions::i16x8_sub.value():
+        emit_vector_binary<u16x8, Operators::Subtract>();
+        return {};
+    case Instructions::i16x8_sub_sat_s.value():
+        emit_vector_binary<i16x8, VectorOperators::SaturatingSubtract>();
+        return {};
+    case Instructions::i16x8_sub_sat_u.value():
+        emit_vector_binary<u16x8, VectorOperators::SaturatingSubtract>();
+        return {};
+    case Instructions::f64x2_nearest.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::NearbyIntegral>>();
+        return {};
+    case Instructions::i16x8_mul.value():
+        emit_vector_binary<u16x8, Operators::Multiply>();
+        return {};
+    case Instructions::i16x8_min_s.value():
+        emit_vector_binary<i16x8, VectorOperators::Minimum>();
+        return {};
+    case Instructions::i16x8_min_u.value():
+        emit_vector_binary<u16x8, VectorOperators::Minimum>();
+        return {};
+    case Instructions::i16x8_max_s.value():
+        emit_vector_binary<i16x8, VectorOperators::Maximum>();
+        return {};
+    case Instructions::i16x8_max_u.value():
+        emit_vector_binary<u16x8, VectorOperators::Maximum>();
+        return {};
+    case Instructions::i16x8_avgr_u.value():
+        emit_vector_binary<u16x8, VectorOperators::AverageRounded>();
+        return {};
+    case Instructions::i16x8_extmul_low_i8x16_s.value():
+        emit_vector_binary<i8x16, VectorOperators::ExtendMultiply<i16x8, false>>();
+        return {};
+    case Instructions::i16x8_extmul_high_i8x16_s.value():
+        emit_vector_binary<i8x16, VectorOperators::ExtendMultiply<i16x8, true>>();
+        return {};
+    case Instructions::i16x8_extmul_low_i8x16_u.value():
+        emit_vector_binary<u8x16, VectorOperators::ExtendMultiply<u16x8, false>>();
+        return {};
+    case Instructions::i16x8_extmul_high_i8x16_u.value():
+        emit_vector_binary<u8x16, VectorOperators::ExtendMultiply<u16x8, true>>();
+        return {};
+    case Instructions::i32x4_abs.value():
+        emit_vector_unary<i32x4, VectorOperators::Absolute>();
+        return {};
+    case Instructions::i32x4_neg.value():
+        emit_vector_unary<i32x4, VectorOperators::Negate>();
+        return {};
+    case Instructions::i32x4_all_true.value():
+        emit_vector_unary<i32x4, VectorOperators::AllTrue>();
+        return {};
+    case Instructions::i32x4_bitmask.value():
+        emit_vector_unary<i32x4, VectorOperators::Bitmask>();
+        return {};
+    case Instructions::i32x4_extend_low_i16x8_s.value():
+        emit_vector_unary<i16x8, VectorOperators::Extend<i32x4, false>>();
+        return {};
+    case Instructions::i32x4_extend_high_i16x8_s.value():
+        emit_vector_unary<i16x8, VectorOperators::Extend<i32x4, true>>();
+        return {};
+    case Instructions::i32x4_extend_low_i16x8_u.value():
+        emit_vector_unary<u16x8, VectorOperators::Extend<u32x4, false>>();
+        return {};
+    case Instructions::i32x4_extend_high_i16x8_u.value():
+        emit_vector_unary<u16x8, VectorOperators::Extend<u32x4, true>>();
+        return {};
+    case Instructions::i32x4_shl.value():
+        emit_vector_binary<u32x4, VectorOperators::ShiftLeft, i32>();
+        return {};
+    case Instructions::i32x4_shr_s.value():
+        emit_vector_binary<i32x4, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i32x4_shr_u.value():
+        emit_vector_binary<u32x4, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i32x4_add.value():
+        emit_vector_binary<u32x4, Operators::Add>();
+        return {};
+    case Instructions::i32x4_sub.value():
+        emit_vector_binary<u32x4, Operators::Subtract>();
+        return {};
+    case Instructions::i32x4_mul.value():
+        emit_vector_binary<u32x4, Operators::Multiply>();
+        return {};
+    case Instructions::i32x4_min_s.value():
+        emit_vector_binary<i32x4, VectorOperators::Minimum>();
+        return {};
+    case Instructions::i32x4_min_u.value():
+        emit_vector_binary<u32x4, VectorOperators::Minimum>();
+        return {};
+    case Instructions::i32x4_max_s.value():
+        emit_vector_binary<i32x4, VectorOperators::Maximum>();
+        return {};
+    case Instructions::i32x4_max_u.value():
+        emit_vector_binary<u32x4, VectorOperators::Maximum>();
+        return {};
+    case Instructions::i32x4_dot_i16x8_s.value():
+        emit_vector_binary<i16x8, VectorOperators::Dot>();
+        return {};
+    case Instructions::i32x4_extmul_low_i16x8_s.value():
+        emit_vector_binary<i16x8, VectorOperators::ExtendMultiply<i32x4, false>>();
+        return {};
+    case Instructions::i32x4_extmul_high_i16x8_s.value():
+        emit_vector_binary<i16x8, VectorOperators::ExtendMultiply<i32x4, true>>();
+        return {};
+    case Instructions::i32x4_extmul_low_i16x8_u.value():
+        emit_vector_binary<u16x8, VectorOperators::ExtendMultiply<u32x4, false>>();
+        return {};
+    case Instructions::i32x4_extmul_high_i16x8_u.value():
+        emit_vector_binary<u16x8, VectorOperators::ExtendMultiply<u32x4, true>>();
+        return {};
+    case Instructions::i64x2_abs.value():
+        emit_vector_unary<i64x2, VectorOperators::Absolute>();
+        return {};
+    case Instructions::i64x2_neg.value():
+        emit_vector_unary<i64x2, VectorOperators::Negate>();
+        return {};
+    case Instructions::i64x2_all_true.value():
+        emit_vector_unary<i64x2, VectorOperators::AllTrue>();
+        return {};
+    case Instructions::i64x2_bitmask.value():
+        emit_vector_unary<i64x2, VectorOperators::Bitmask>();
+        return {};
+    case Instructions::i64x2_extend_low_i32x4_s.value():
+        emit_vector_unary<i32x4, VectorOperators::Extend<i64x2, false>>();
+        return {};
+    case Instructions::i64x2_extend_high_i32x4_s.value():
+        emit_vector_unary<i32x4, VectorOperators::Extend<i64x2, true>>();
+        return {};
+    case Instructions::i64x2_extend_low_i32x4_u.value():
+        emit_vector_unary<u32x4, VectorOperators::Extend<u64x2, false>>();
+        return {};
+    case Instructions::i64x2_extend_high_i32x4_u.value():
+        emit_vector_unary<u32x4, VectorOperators::Extend<u64x2, true>>();
+        return {};
+    case Instructions::i64x2_shl.value():
+        emit_vector_binary<u64x2, VectorOperators::ShiftLeft, i32>();
+        return {};
+    case Instructions::i64x2_shr_s.value():
+        emit_vector_binary<i64x2, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i64x2_shr_u.value():
+        emit_vector_binary<u64x2, VectorOperators::ShiftRight, i32>();
+        return {};
+    case Instructions::i64x2_add.value():
+        emit_vector_binary<u64x2, Operators::Add>();
+        return {};
+    case Instructions::i64x2_sub.value():
+        emit_vector_binary<u64x2, Operators::Subtract>();
+        return {};
+    case Instructions::i64x2_mul.value():
+        emit_vector_binary<u64x2, Operators::Multiply>();
+        return {};
+    case Instructions::i64x2_eq.value():
+        emit_vector_binary<i64x2, Operators::Equals>();
+        return {};
+    case Instructions::i64x2_ne.value():
+        emit_vector_binary<i64x2, Operators::NotEquals>();
+        return {};
+    case Instructions::i64x2_lt_s.value():
+        emit_vector_binary<i64x2, Operators::LessThan>();
+        return {};
+    case Instructions::i64x2_gt_s.value():
+        emit_vector_binary<i64x2, Operators::GreaterThan>();
+        return {};
+    case Instructions::i64x2_le_s.value():
+        emit_vector_binary<i64x2, Operators::LessThanOrEquals>();
+        return {};
+    case Instructions::i64x2_ge_s.value():
+        emit_vector_binary<i64x2, Operators::GreaterThanOrEquals>();
+        return {};
+    case Instructions::i64x2_extmul_low_i32x4_s.value():
+        emit_vector_binary<i32x4, VectorOperators::ExtendMultiply<i64x2, false>>();
+        return {};
+    case Instructions::i64x2_extmul_high_i32x4_s.value():
+        emit_vector_binary<i32x4, VectorOperators::ExtendMultiply<i64x2, true>>();
+        return {};
+    case Instructions::i64x2_extmul_low_i32x4_u.value():
+        emit_vector_binary<u32x4, VectorOperators::ExtendMultiply<u64x2, false>>();
+        return {};
+    case Instructions::i64x2_extmul_high_i32x4_u.value():
+        emit_vector_binary<u32x4, VectorOperators::ExtendMultiply<u64x2, true>>();
+        return {};
+    case Instructions::f32x4_abs.value():
+        emit_vector_unary<f32x4, VectorOperators::Absolute>();
+        return {};
+    case Instructions::f32x4_neg.value():
+        emit_vector_unary<f32x4, VectorOperators::Negate>();
+        return {};
+    case Instructions::f32x4_sqrt.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::SquareRoot>>();
+        return {};
+    case Instructions::f32x4_add.value():
+        emit_vector_binary<f32x4, Operators::Add>();
+        return {};
+    case Instructions::f32x4_sub.value():
+        emit_vector_binary<f32x4, Operators::Subtract>();
+        return {};
+    case Instructions::f32x4_mul.value():
+        emit_vector_binary<f32x4, Operators::Multiply>();
+        return {};
+    case Instructions::f32x4_div.value():
+        emit_vector_binary<f32x4, VectorOperators::Divide>();
+        return {};
+    case Instructions::f32x4_min.value():
+        emit_vector_binary<f32x4, VectorOperators::Lanewise<Operators::Minimum>>();
+        return {};
+    case Instructions::f32x4_max.value():
+        emit_vector_binary<f32x4, VectorOperators::Lanewise<Operators::Maximum>>();
+        return {};
+    case Instructions::f32x4_pmin.value():
+        emit_vector_binary<f32x4, VectorOperators::PseudoMinimum>();
+        return {};
+    case Instructions::f32x4_pmax.value():
+        emit_vector_binary<f32x4, VectorOperators::PseudoMaximum>();
+        return {};
+    case Instructions::f64x2_abs.value():
+        emit_vector_unary<f64x2, VectorOperators::Absolute>();
+        return {};
+    case Instructions::f64x2_neg.value():
+        emit_vector_unary<f64x2, VectorOperators::Negate>();
+        return {};
+    case Instructions::f64x2_sqrt.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::SquareRoot>>();
+        return {};
+    case Instructions::f64x2_add.value():
+        emit_vector_binary<f64x2, Operators::Add>();
+        return {};
+    case Instructions::f64x2_sub.value():
+        emit_vector_binary<f64x2, Operators::Subtract>();
+        return {};
+    case Instructions::f64x2_mul.value():
+        emit_vector_binary<f64x2, Operators::Multiply>();
+        return {};
+    case Instructions::f64x2_div.value():
+        emit_vector_binary<f64x2, VectorOperators::Divide>();
+        return {};
+    case Instructions::f64x2_min.value():
+        emit_vector_binary<f64x2, VectorOperators::Lanewise<Operators::Minimum>>();
+        return {};
+    case Instructions::f64x2_max.value():
+        emit_vector_binary<f64x2, VectorOperators::Lanewise<Operators::Maximum>>();
+        return {};
+    case Instructions::f64x2_pmin.value():
+        emit_vector_binary<f64x2, VectorOperators::PseudoMinimum>();
+        return {};
+    case Instructions::f64x2_pmax.value():
+        emit_vector_binary<f64x2, VectorOperators::PseudoMaximum>();
+        return {};
+    case Instructions::i32x4_trunc_sat_f32x4_s.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::SaturatingTruncate<i32>, i32x4>>();
+        return {};
+    case Instructions::i32x4_trunc_sat_f32x4_u.value():
+        emit_vector_unary<f32x4, VectorOperators::Lanewise<Operators::SaturatingTruncate<u32>, u32x4>>();
+        return {};
+    case Instructions::f32x4_convert_i32x4_s.value():
+        emit_vector_unary<i32x4, VectorOperators::Convert<f32x4>>();
+        return {};
+    case Instructions::f32x4_convert_i32x4_u.value():
+        emit_vector_unary<u32x4, VectorOperators::Convert<f32x4>>();
+        return {};
+    case Instructions::i32x4_trunc_sat_f64x2_s_zero.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::SaturatingTruncate<i32>, i32x4>>();
+        return {};
+    case Instructions::i32x4_trunc_sat_f64x2_u_zero.value():
+        emit_vector_unary<f64x2, VectorOperators::Lanewise<Operators::SaturatingTruncate<u32>, u32x4>>();
+        return {};
+    case Instructions::f64x2_convert_low_i32x4_s.value():
+        emit_vector_unary<i32x4, VectorOperators::Extend<f64x2, false>>();
+        return {};
+    case Instructions::f64x2_convert_low_i32x4_u.value():
+        emit_vector_unary<u32x4, VectorOperators::Extend<f64x2, false>>();
+        return {};
+    default:
+        return Error::from_string_literal("Unsupported instruction");
+    }
+}
+
+ErrorOr<NonnullOwnPtr<RegisterFunction>> RegisterFunction::create(WasmFunction const& wasm_function, Store& store)
+{
+    auto function = adopt_own(*new RegisterFunction(wasm_function.type(), wasm_function.module()));
+    Translator translator { *function, wasm_function, store };
+    TRY(translator.translate());
+    return function;
+}
+
+}
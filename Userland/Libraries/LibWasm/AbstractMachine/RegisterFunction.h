@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/StackInfo.h>
+#include <AK/Vector.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+
+namespace Wasm {
+
+namespace JIT {
+class NativeFunction;
+}
+
+struct BytecodeInterpreter;
+struct RegisterContext;
+struct RegisterInstruction;
+class RegisterFunction;
+
+struct RegisterFrame {
+    RegisterContext* context { nullptr };
+    RegisterFunction const* function { nullptr };
+    size_t base { 0 };
+    u64* slots { nullptr };
+    MemoryInstance* memory { nullptr };
+    // Cached from the memory, and refreshed whenever something that might resize it has run.
+    u8* memory_data { nullptr };
+    u64 memory_size { 0 };
+};
+
+using RegisterHandler = RegisterInstruction const* (*)(RegisterFrame&, RegisterInstruction const*);
+
+// All operands are slot indices into the frame's register file, and a handler returns the next instruction to run
+// (or null once the function returns or traps).
+struct RegisterInstruction {
+    RegisterHandler handler { nullptr };
+    // The wasm instruction this implements, so the JIT can recognize it. Moves are tagged as local.set, jumps as br,
+    // and returns as return. Conditional branches are tagged as br_if (or the comparison folded into them), with the
+    // argument saying whether to branch if the condition holds or if it doesn't.
+    OpCode opcode { 0 };
+    u32 destination { 0 };
+    u32 lhs { 0 };
+    u32 rhs { 0 };
+    u32 argument { 0 };
+    u64 immediate { 0 };
+    RegisterInstruction const* target { nullptr };
+};
+
+// A function body translated from the stack machine into instructions operating on a register file of untyped 64-bit
+// slots, so that executing it does not have to push and pop Values or search the stack for labels.
+//
+// The register file of a frame is laid out as [ locals | constants | operand stack ]: every operand stack height that
+// the validator allows maps to a fixed slot, and branches move their values straight into the slots the target expects.
+// Calls between translated functions place the callee's frame right on top of the arguments, so no copies are needed to
+// pass them in.
+//
+// Functions that touch v128 values use two slots for every local and stack entry, so vectors live in the register file as
+// native 16-byte values and scalars just leave the upper half unused.
+//
+// Only functions that stick to numeric and vector values are translated, anything using references or table instructions
+// keeps running on the regular BytecodeInterpreter.
+class RegisterFunction {
+public:
+    static ErrorOr<NonnullOwnPtr<RegisterFunction>> create(WasmFunction const&, Store&);
+    ~RegisterFunction();
+
+    using TrapState = Variant<Trap, JS::Completion, Empty>;
+
+    // Runs the function in the configuration's current frame, leaving its results on the stack as the BytecodeInterpreter would.
+    TrapState execute(BytecodeInterpreter&, Configuration&, StackInfo const&) const;
+
+    auto& type() const { return m_type; }
+    auto& module() const { return m_module; }
+    auto& instructions() const { return m_instructions; }
+    auto& constants() const { return m_constants; }
+    auto& jump_table() const { return m_jump_table; }
+    Optional<MemoryAddress> memory() const { return m_memory; }
+
+    // Compiles the function once it has been run often enough, null until then or if it can't be compiled.
+    JIT::NativeFunction const* get_or_create_native_function() const;
+    JIT::NativeFunction const* native_function() const { return m_native_function.ptr(); }
+
+    size_t parameter_count() const { return m_type.parameters().size(); }
+    size_t local_count() const { return m_local_count; }
+    // The number of slots every local and stack entry takes up, 2 in functions that use vectors and 1 otherwise.
+    size_t slot_width() const { return m_slot_width; }
+    size_t stack_base() const { return m_local_count * m_slot_width + m_constants.size(); }
+    size_t frame_size() const { return m_frame_size; }
+
+private:
+    class Translator;
+
+    RegisterFunction(FunctionType const&, ModuleInstance const&);
+
+    FunctionType m_type;
+    ModuleInstance const& m_module;
+    Optional<MemoryAddress> m_memory;
+    Vector<RegisterInstruction> m_instructions;
+    Vector<u64> m_constants;
+    Vector<RegisterInstruction const*> m_jump_table;
+    size_t m_local_count { 0 };
+    size_t m_slot_width { 1 };
+    size_t m_frame_size { 0 };
+
+    mutable u32 m_execution_count { 0 };
+    mutable bool m_did_try_jitting { false };
+    mutable OwnPtr<JIT::NativeFunction> m_native_function;
+};
+
+}
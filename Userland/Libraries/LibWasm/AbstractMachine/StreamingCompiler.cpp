@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/LEB128.h>
+#include <AK/MemoryStream.h>
+#include <LibWasm/AbstractMachine/ParallelValidator.h>
+#include <LibWasm/AbstractMachine/StreamingCompiler.h>
+
+namespace Wasm {
+
+ByteString compile_error_to_byte_string(CompileError const& error)
+{
+    return error.visit(
+        [](ParseError error) { return parse_error_to_byte_string(error); },
+        [](ValidationError const& error) { return error.error_string; });
+}
+
+struct EncodedSize {
+    u32 value { 0 };
+    size_t length { 0 };
+};
+
+// Returns an empty Optional if the size might still be completed by bytes that haven't arrived yet.
+static ErrorOr<Optional<EncodedSize>, CompileError> read_size(ReadonlyBytes bytes, bool more_bytes_may_follow, ParseError error)
+{
+    static constexpr size_t max_encoded_length = 5;
+
+    for (size_t i = 0; i < min(bytes.size(), max_encoded_length); ++i) {
+        if (bytes[i] & 0x80)
+            continue;
+
+        FixedMemoryStream stream { bytes.trim(i + 1) };
+        auto value_or_error = stream.read_value<LEB128<u32>>();
+        if (value_or_error.is_error())
+            return CompileError { error };
+        return EncodedSize { value_or_error.release_value(), i + 1 };
+    }
+
+    if (bytes.size() >= max_encoded_length || !more_bytes_may_follow)
+        return CompileError { error };
+    return OptionalNone {};
+}
+
+StreamingCompiler::StreamingCompiler() = default;
+
+StreamingCompiler::~StreamingCompiler() = default;
+
+ErrorOr<void, CompileError> StreamingCompiler::append(ReadonlyBytes bytes)
+{
+    if (m_error.has_value())
+        return copy_of_error();
+
+    // Drop whatever has been parsed already, so the buffer only ever holds (roughly) one section.
+    if (m_offset > 0 && m_offset >= m_buffer.size() / 2) {
+        auto remaining = m_buffer.size() - m_offset;
+        memmove(m_buffer.data(), m_buffer.data() + m_offset, remaining);
+        m_buffer.resize(remaining);
+        m_offset = 0;
+    }
+
+    if (m_buffer.try_append(bytes).is_error()) {
+        m_error = ParseError::OutOfMemory;
+        return copy_of_error();
+    }
+
+    auto result = process();
+    if (result.is_error())
+        m_error = result.release_error();
+
+    if (m_error.has_value())
+        return copy_of_error();
+    return {};
+}
+
+CompileError StreamingCompiler::copy_of_error() const
+{
+    // ValidationError can't be copied, but its message is all there is to it.
+    return m_error->visit(
+        [](ParseError error) -> CompileError { return error; },
+        [](ValidationError const& error) -> CompileError { return ValidationError { error.error_string }; });
+}
+
+void StreamingCompiler::consume(size_t size)
+{
+    VERIFY(m_offset + size <= m_buffer.size());
+    m_offset += size;
+}
+
+ErrorOr<void, CompileError> StreamingCompiler::process()
+{
+    for (;;) {
+        auto bytes = available_bytes();
+
+        switch (m_state) {
+        case State::Header:
+            if (bytes.size() < 8)
+                return {};
+            if (bytes.slice(0, 4) != Module::wasm_magic.span())
+                return CompileError { ParseError::InvalidModuleMagic };
+            if (bytes.slice(4, 4) != Module::wasm_version.span())
+                return CompileError { ParseError::InvalidModuleVersion };
+            consume(8);
+            m_state = State::SectionHeader;
+            break;
+
+        case State::SectionHeader: {
+            if (bytes.is_empty())
+                return {};
+            auto size = TRY(read_size(bytes.slice(1), true, ParseError::ExpectedSize));
+            if (!size.has_value())
+                return {};
+
+            m_section_id = bytes[0];
+            m_section_remaining = size->value;
+            consume(1 + size->length);
+
+            if (m_section_id == CodeSection::section_id) {
+                TRY(begin_code_section());
+                m_state = State::CodeEntryCount;
+            } else {
+                m_state = State::Section;
+            }
+            break;
+        }
+
+        case State::Section: {
+            if (bytes.size() < m_section_remaining)
+                return {};
+
+            FixedMemoryStream stream { bytes.trim(m_section_remaining) };
+            auto section = Module::parse_section(m_section_id, stream);
+            if (section.is_error())
+                return CompileError { section.release_error() };
+
+            m_sections.append(section.release_value());
+            consume(m_section_remaining);
+            m_state = State::SectionHeader;
+            break;
+        }
+
+        case State::CodeEntryCount: {
+            auto section_bytes = bytes.trim(m_section_remaining);
+            auto count = TRY(read_size(section_bytes, section_bytes.size() < m_section_remaining, ParseError::ExpectedSize));
+            if (!count.has_value())
+                return {};
+
+            consume(count->length);
+            m_section_remaining -= count->length;
+
+            // Every entry takes up at least one byte, so this also bounds the allocation below by the section size.
+            if (count->value > m_section_remaining)
+                return CompileError { ParseError::InvalidSize };
+
+            // Reserve space for all entries up front: they must not move once they've been handed to the validator.
+            m_code_entry_count = count->value;
+            if (m_code_entries.try_ensure_capacity(m_code_entry_count).is_error())
+                return CompileError { ParseError::OutOfMemory };
+
+            m_state = State::CodeEntry;
+            break;
+        }
+
+        case State::CodeEntry: {
+            if (m_code_entries.size() == m_code_entry_count) {
+                if (m_section_remaining != 0)
+                    return CompileError { ParseError::InvalidSize };
+                m_state = State::SectionHeader;
+                break;
+            }
+
+            auto section_bytes = bytes.trim(m_section_remaining);
+            auto size = TRY(read_size(section_bytes, section_bytes.size() < m_section_remaining, ParseError::InvalidSize));
+            if (!size.has_value())
+                return {};
+
+            auto entry_size = size->length + size->value;
+            if (entry_size > m_section_remaining)
+                return CompileError { ParseError::InvalidSize };
+            if (bytes.size() < entry_size)
+                return {};
+
+            FixedMemoryStream stream { bytes.trim(entry_size) };
+            auto code = CodeSection::Code::parse(stream);
+            if (code.is_error())
+                return CompileError { code.release_error() };
+
+            consume(entry_size);
+            m_section_remaining -= entry_size;
+            TRY(add_code_entry(code.release_value()));
+            break;
+        }
+        }
+    }
+}
+
+ErrorOr<void, CompileError> StreamingCompiler::begin_code_section()
+{
+    if (m_code_section_index.has_value())
+        return CompileError { ParseError::InvalidIndex };
+    m_code_section_index = m_sections.size();
+
+    // All the sections that function bodies can refer to come before the code section,
+    // so the validator's context is complete at this point.
+    Module module_so_far { m_sections };
+    if (module_so_far.validation_status() == Module::ValidationStatus::Invalid)
+        return CompileError { ValidationError { module_so_far.validation_error() } };
+    if (auto result = m_validator.populate_context(module_so_far); result.is_error())
+        return CompileError { result.release_error() };
+
+    auto thread_count = ParallelFunctionValidator::default_thread_count();
+    if (thread_count > 1 && m_section_remaining >= ParallelFunctionValidator::minimum_parallel_code_size)
+        m_parallel_validator = make<ParallelFunctionValidator>(m_validator, thread_count);
+
+    return {};
+}
+
+ErrorOr<void, CompileError> StreamingCompiler::add_code_entry(CodeSection::Code code)
+{
+    VERIFY(m_code_entries.size() < m_code_entries.capacity());
+    auto function_index = m_validator.context().imported_function_count + m_code_entries.size();
+    m_code_entries.unchecked_append(move(code));
+
+    if (m_parallel_validator) {
+        m_parallel_validator->enqueue(function_index, m_code_entries.last());
+        return {};
+    }
+
+    if (auto result = m_validator.validate_function(function_index, m_code_entries.last()); result.is_error())
+        return CompileError { result.release_error() };
+    return {};
+}
+
+ErrorOr<Module, CompileError> StreamingCompiler::finish()
+{
+    if (m_error.has_value())
+        return copy_of_error();
+
+    if (m_state != State::SectionHeader || !available_bytes().is_empty()) {
+        m_error = ParseError::UnexpectedEof;
+        return copy_of_error();
+    }
+
+    if (m_parallel_validator) {
+        auto result = m_parallel_validator->finish();
+        m_parallel_validator = nullptr;
+        if (result.is_error()) {
+            m_error = result.release_error();
+            return copy_of_error();
+        }
+    }
+
+    if (m_code_section_index.has_value())
+        m_sections.insert(*m_code_section_index, CodeSection { move(m_code_entries) });
+
+    Module module { move(m_sections) };
+    if (module.validation_status() == Module::ValidationStatus::Invalid) {
+        m_error = ValidationError { module.validation_error() };
+        return copy_of_error();
+    }
+
+    Validator validator;
+    validator.set_function_bodies_are_prevalidated(true);
+    if (auto result = validator.validate(module); result.is_error()) {
+        module.set_validation_error(result.error().error_string);
+        m_error = result.release_error();
+        return copy_of_error();
+    }
+
+    return module;
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/OwnPtr.h>
+#include <AK/Variant.h>
+#include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/Types.h>
+
+namespace Wasm {
+
+class ParallelFunctionValidator;
+
+using CompileError = Variant<ParseError, ValidationError>;
+
+ByteString compile_error_to_byte_string(CompileError const&);
+
+// Parses and validates a module while its bytes are still arriving.
+// Function bodies are validated one by one as soon as they're complete (on worker threads if the code section
+// is large), so that once the last chunk has been appended, there is little work left to do.
+class StreamingCompiler {
+    AK_MAKE_NONCOPYABLE(StreamingCompiler);
+    AK_MAKE_NONMOVABLE(StreamingCompiler);
+
+public:
+    StreamingCompiler();
+    ~StreamingCompiler();
+
+    // Once a chunk has failed to compile, all further calls fail with the same error.
+    ErrorOr<void, CompileError> append(ReadonlyBytes);
+
+    // Returns the validated module, once all of its bytes have been appended.
+    ErrorOr<Module, CompileError> finish();
+
+private:
+    enum class State {
+        Header,
+        SectionHeader,
+        Section,
+        CodeEntryCount,
+        CodeEntry,
+    };
+
+    ErrorOr<void, CompileError> process();
+    ErrorOr<void, CompileError> begin_code_section();
+    ErrorOr<void, CompileError> add_code_entry(CodeSection::Code);
+
+    ReadonlyBytes available_bytes() const { return m_buffer.bytes().slice(m_offset); }
+    void consume(size_t);
+    CompileError copy_of_error() const;
+
+    ByteBuffer m_buffer;
+    size_t m_offset { 0 };
+    State m_state { State::Header };
+    Optional<CompileError> m_error;
+
+    u8 m_section_id { 0 };
+    size_t m_section_remaining { 0 };
+    Vector<Module::AnySection> m_sections;
+
+    // The code section's entries are kept out of m_sections until the end, as the function validator refers to them
+    // while later sections are being parsed.
+    Optional<size_t> m_code_section_index;
+    size_t m_code_entry_count { 0 };
+    Vector<CodeSection::Code> m_code_entries;
+    Validator m_validator;
+    OwnPtr<ParallelFunctionValidator> m_parallel_validator;
+};
+
+}
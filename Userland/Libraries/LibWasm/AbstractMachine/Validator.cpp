@@ -9,6 +9,7 @@
 #include <AK/SourceLocation.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Try.h>
+#include <LibWasm/AbstractMachine/ParallelValidator.h>
 #include <LibWasm/AbstractMachine/Validator.h>
 #include <LibWasm/Printer/Printer.h>
 
@@ -35,7 +36,32 @@ ErrorOr<void, ValidationError> Validator::validate(Module& module)
         return result;
     }
 
+    result = populate_context(module);
+    if (result.is_error()) {
+        module.set_validation_status(Module::ValidationStatus::Invalid, {});
+        return result;
+    }
+
+    for (auto& section : module.sections()) {
+        section.visit([this, &result](auto& section) {
+            result = validate(section);
+        });
+        if (result.is_error()) {
+            module.set_validation_status(Module::ValidationStatus::Invalid, {});
+            return result;
+        }
+    }
+
+    module.set_validation_status(Module::ValidationStatus::Valid, {});
+    return {};
+}
+
+ErrorOr<void, ValidationError> Validator::populate_context(Module const& module)
+{
+    ErrorOr<void, ValidationError> result {};
+
     m_context = {};
+    m_globals_without_internal_globals = {};
 
     module.for_each_section_of_type<TypeSection>([this](TypeSection const& section) {
         m_context.types.extend(section.types());
@@ -64,10 +90,8 @@ ErrorOr<void, ValidationError> Validator::validate(Module& module)
         }
     });
 
-    if (result.is_error()) {
-        module.set_validation_status(Module::ValidationStatus::Invalid, {});
+    if (result.is_error())
         return result;
-    }
 
     module.for_each_section_of_type<FunctionSection>([this, &result](FunctionSection const& section) {
         if (result.is_error())
@@ -82,10 +106,8 @@ ErrorOr<void, ValidationError> Validator::validate(Module& module)
             }
         }
     });
-    if (result.is_error()) {
-        module.set_validation_status(Module::ValidationStatus::Invalid, {});
+    if (result.is_error())
         return result;
-    }
 
     module.for_each_section_of_type<TableSection>([this](TableSection const& section) {
         m_context.tables.ensure_capacity(m_context.tables.size() + section.tables().size());
@@ -108,6 +130,12 @@ ErrorOr<void, ValidationError> Validator::validate(Module& module)
         for (auto& segment : section.segments())
             m_context.elements.append(segment.type);
     });
+    // Function bodies may refer to data segments before the data section has been seen (e.g. while streaming),
+    // in which case the data count section tells us how many of them there are going to be.
+    module.for_each_section_of_type<DataCountSection>([this](DataCountSection const& section) {
+        if (section.count().has_value())
+            m_context.datas.resize(*section.count());
+    });
     module.for_each_section_of_type<DataSection>([this](DataSection const& section) {
         m_context.datas.resize(section.data().size());
     });
@@ -138,17 +166,6 @@ ErrorOr<void, ValidationError> Validator::validate(Module& module)
             scan_expression_for_function_indices(segment.expression());
     });
 
-    for (auto& section : module.sections()) {
-        section.visit([this, &result](auto& section) {
-            result = validate(section);
-        });
-        if (result.is_error()) {
-            module.set_validation_status(Module::ValidationStatus::Invalid, {});
-            return result;
-        }
-    }
-
-    module.set_validation_status(Module::ValidationStatus::Valid, {});
     return {};
 }
 
@@ -256,30 +273,80 @@ ErrorOr<void, ValidationError> Validator::validate(TableSection const& section)
 
 ErrorOr<void, ValidationError> Validator::validate(CodeSection const& section)
 {
+    if (m_function_bodies_are_prevalidated)
+        return {};
+
+    auto& functions = section.functions();
+
+    size_t code_size = 0;
+    for (auto& entry : functions)
+        code_size += entry.size();
+
+    auto thread_count = ParallelFunctionValidator::default_thread_count();
+    if (thread_count > 1 && functions.size() > 1 && code_size >= ParallelFunctionValidator::minimum_parallel_code_size) {
+        ParallelFunctionValidator parallel_validator { *this, min(thread_count, functions.size()) };
+        for (size_t i = 0; i < functions.size(); ++i)
+            parallel_validator.enqueue(m_context.imported_function_count + i, functions[i]);
+        return parallel_validator.finish();
+    }
+
     size_t index = m_context.imported_function_count;
-    for (auto& entry : section.functions()) {
-        auto function_index = index++;
-        TRY(validate(FunctionIndex { function_index }));
-        auto& function_type = m_context.functions[function_index];
-        auto& function = entry.func();
-
-        auto function_validator = fork();
-        function_validator.m_context.locals = {};
-        function_validator.m_context.locals.extend(function_type.parameters());
-        for (auto& local : function.locals()) {
-            for (size_t i = 0; i < local.n(); ++i)
-                function_validator.m_context.locals.append(local.type());
-        }
+    for (auto& entry : functions)
+        TRY(validate_function(index++, entry));
 
-        function_validator.m_context.labels = { ResultType { function_type.results() } };
-        function_validator.m_context.return_ = ResultType { function_type.results() };
+    return {};
+}
+
+ErrorOr<void, ValidationError> Validator::validate_function(size_t function_index, CodeSection::Code const& entry)
+{
+    TRY(validate(FunctionIndex { function_index }));
+    auto& function_type = m_context.functions[function_index];
+    auto& function = entry.func();
 
-        TRY(function_validator.validate(function.body(), function_type.results()));
+    auto function_validator = fork();
+    function_validator.m_context.locals = {};
+    function_validator.m_context.locals.extend(function_type.parameters());
+    for (auto& local : function.locals()) {
+        for (size_t i = 0; i < local.n(); ++i)
+            function_validator.m_context.locals.append(local.type());
     }
 
+    function_validator.m_context.labels = { ResultType { function_type.results() } };
+    function_validator.m_context.return_ = ResultType { function_type.results() };
+
+    TRY(function_validator.validate(function.body(), function_type.results()));
     return {};
 }
 
+NonnullOwnPtr<Validator> Validator::isolated_fork() const
+{
+    // The copy-on-write vectors share their storage through non-atomic reference counts,
+    // so a validator that's used on another thread needs storage of its own.
+    auto copy = []<typename T>(COWVector<T> const& vector) {
+        COWVector<T> result;
+        result.extend(vector);
+        return result;
+    };
+
+    Context context;
+    context.types = copy(m_context.types);
+    context.functions = copy(m_context.functions);
+    context.tables = copy(m_context.tables);
+    context.memories = copy(m_context.memories);
+    context.globals = copy(m_context.globals);
+    context.elements = copy(m_context.elements);
+    context.datas = copy(m_context.datas);
+    context.locals = copy(m_context.locals);
+    context.labels = copy(m_context.labels);
+    context.return_ = m_context.return_;
+    context.references = m_context.references;
+    context.imported_function_count = m_context.imported_function_count;
+
+    auto validator = adopt_own(*new Validator { move(context) });
+    validator->m_globals_without_internal_globals = copy(m_globals_without_internal_globals);
+    return validator;
+}
+
 ErrorOr<void, ValidationError> Validator::validate(TableType const& type)
 {
     return validate(type.limits(), 32);
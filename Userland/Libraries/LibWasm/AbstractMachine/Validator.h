@@ -9,6 +9,7 @@
 #include <AK/COWVector.h>
 #include <AK/Debug.h>
 #include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/SourceLocation.h>
 #include <AK/Tuple.h>
 #include <AK/Vector.h>
@@ -54,6 +55,17 @@ public:
         return Validator { m_context };
     }
 
+    // Like fork(), but shares no storage with this validator, so that it can be used on another thread.
+    [[nodiscard]] NonnullOwnPtr<Validator> isolated_fork() const;
+
+    Context const& context() const { return m_context; }
+
+    // Builds the context from the module's sections, without validating any of them.
+    ErrorOr<void, ValidationError> populate_context(Module const&);
+
+    // For modules whose function bodies were validated while they were being parsed.
+    void set_function_bodies_are_prevalidated(bool value) { m_function_bodies_are_prevalidated = value; }
+
     // Module
     ErrorOr<void, ValidationError> validate(Module&);
     ErrorOr<void, ValidationError> validate(ImportSection const&);
@@ -65,6 +77,7 @@ public:
     ErrorOr<void, ValidationError> validate(MemorySection const&);
     ErrorOr<void, ValidationError> validate(TableSection const&);
     ErrorOr<void, ValidationError> validate(CodeSection const&);
+    ErrorOr<void, ValidationError> validate_function(size_t function_index, CodeSection::Code const&);
     ErrorOr<void, ValidationError> validate(FunctionSection const&) { return {}; }
     ErrorOr<void, ValidationError> validate(DataCountSection const&) { return {}; }
     ErrorOr<void, ValidationError> validate(TypeSection const&) { return {}; }
@@ -347,6 +360,7 @@ private:
     Vector<BlockDetails> m_block_details;
     Vector<FunctionType> m_entered_blocks;
     COWVector<GlobalType> m_globals_without_internal_globals;
+    bool m_function_bodies_are_prevalidated { false };
 };
 
 }
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BitCast.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <LibWasm/Types.h>
+
+// Functions returning vectors or accepting vector arguments have different calling conventions
+// depending on whether the target architecture supports SSE or not. GCC generates warning "psabi"
+// when compiling for non-SSE architectures. We disable this warning because these functions
+// are static and should never be visible from outside the translation unit that includes this header.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// Operators of the SIMD proposal, working on the compiler's native vector types (see AK/SIMD.h) rather than on u128.
+// Lane-wise arithmetic and comparisons don't need anything special, the plain Operators work on native vectors as-is.
+namespace Wasm::VectorOperators {
+
+using namespace AK::SIMD;
+
+template<typename T>
+concept NativeVector = !IsClass<T> && !IsPointer<T> && requires(T vector) { vector[0]; };
+
+template<NativeVector T>
+using ElementOf = RemoveCVReference<decltype(declval<T>()[0])>;
+
+template<NativeVector T>
+constexpr size_t lane_count = sizeof(T) / sizeof(ElementOf<T>);
+
+namespace Detail {
+
+// NOTE: This can't be an alias template like NativeVectorType, as GCC drops the vector_size attribute from those when the size is dependent.
+template<typename Element, size_t lanes>
+struct VectorOf {
+    typedef Element Type __attribute__((vector_size(lanes * sizeof(Element))));
+};
+
+}
+
+// A vector with as many lanes as T, each holding an Element.
+template<NativeVector T, typename Element>
+using WithElement = typename Detail::VectorOf<Element, lane_count<T>>::Type;
+
+// Picks the lanes of if_true where the mask (as produced by a comparison) is set, and those of if_false elsewhere.
+template<NativeVector T, NativeVector Mask>
+ALWAYS_INLINE static T select_lanes(Mask mask, T if_true, T if_false)
+{
+    using Bits = typename Detail::VectorOf<u64, sizeof(T) / sizeof(u64)>::Type;
+    auto bits = bit_cast<Bits>(mask);
+    return bit_cast<T>((bit_cast<Bits>(if_true) & bits) | (bit_cast<Bits>(if_false) & ~bits));
+}
+
+// Clamps every lane to the range of Result's lanes, then narrows it.
+template<NativeVector Result, NativeVector T>
+ALWAYS_INLINE static Result saturate(T value)
+{
+    using Element = ElementOf<T>;
+    constexpr auto min = static_cast<Element>(NumericLimits<ElementOf<Result>>::min());
+    constexpr auto max = static_cast<Element>(NumericLimits<ElementOf<Result>>::max());
+    value = select_lanes(value < min, T {} + min, value);
+    value = select_lanes(value > max, T {} + max, value);
+    return __builtin_convertvector(value, Result);
+}
+
+// Only floating point vectors are divided, so unlike Operators::Divide, there is nothing to check.
+struct Divide {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const { return lhs / rhs; }
+
+    static StringView name() { return "/"sv; }
+};
+
+struct Minimum {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const { return select_lanes(lhs < rhs, lhs, rhs); }
+
+    static StringView name() { return "min"sv; }
+};
+
+struct Maximum {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const { return select_lanes(lhs > rhs, lhs, rhs); }
+
+    static StringView name() { return "max"sv; }
+};
+
+// https://webassembly.github.io/spec/core/exec/numerics.html#op-fpmin
+struct PseudoMinimum {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const { return select_lanes(rhs < lhs, rhs, lhs); }
+
+    static StringView name() { return "pmin"sv; }
+};
+
+// https://webassembly.github.io/spec/core/exec/numerics.html#op-fpmax
+struct PseudoMaximum {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const { return select_lanes(lhs < rhs, rhs, lhs); }
+
+    static StringView name() { return "pmax"sv; }
+};
+
+struct AndNot {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const { return lhs & ~rhs; }
+
+    static StringView name() { return "andnot"sv; }
+};
+
+struct Not {
+    template<NativeVector T>
+    T operator()(T value) const { return ~value; }
+
+    static StringView name() { return "not"sv; }
+};
+
+struct Negate {
+    template<NativeVector T>
+    T operator()(T value) const
+    {
+        if constexpr (IsFloatingPoint<ElementOf<T>>) {
+            using Bits = WithElement<T, NativeIntegralType<sizeof(ElementOf<T>) * 8>>;
+            constexpr auto sign_bit = static_cast<ElementOf<Bits>>(1) << (sizeof(ElementOf<T>) * 8 - 1);
+            return bit_cast<T>(bit_cast<Bits>(value) ^ sign_bit);
+        } else {
+            using Unsigned = WithElement<T, MakeUnsigned<ElementOf<T>>>;
+            return bit_cast<T>(Unsigned {} - bit_cast<Unsigned>(value));
+        }
+    }
+
+    static StringView name() { return "neg"sv; }
+};
+
+struct Absolute {
+    template<NativeVector T>
+    T operator()(T value) const
+    {
+        if constexpr (IsFloatingPoint<ElementOf<T>>) {
+            using Bits = WithElement<T, NativeIntegralType<sizeof(ElementOf<T>) * 8>>;
+            constexpr auto sign_bit = static_cast<ElementOf<Bits>>(1) << (sizeof(ElementOf<T>) * 8 - 1);
+            return bit_cast<T>(bit_cast<Bits>(value) & ~sign_bit);
+        } else {
+            return select_lanes(value < 0, Negate {}(value), value);
+        }
+    }
+
+    static StringView name() { return "abs"sv; }
+};
+
+struct AverageRounded {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const
+    {
+        // (lhs + rhs + 1) / 2, without overflowing the lanes.
+        return (lhs | rhs) - ((lhs ^ rhs) >> 1);
+    }
+
+    static StringView name() { return "avgr"sv; }
+};
+
+struct SaturatingAdd {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const
+    {
+        using Widened = WithElement<T, MakeSigned<NativeIntegralType<sizeof(ElementOf<T>) * 16>>>;
+        return saturate<T>(__builtin_convertvector(lhs, Widened) + __builtin_convertvector(rhs, Widened));
+    }
+
+    static StringView name() { return "add_sat"sv; }
+};
+
+struct SaturatingSubtract {
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const
+    {
+        using Widened = WithElement<T, MakeSigned<NativeIntegralType<sizeof(ElementOf<T>) * 16>>>;
+        return saturate<T>(__builtin_convertvector(lhs, Widened) - __builtin_convertvector(rhs, Widened));
+    }
+
+    static StringView name() { return "sub_sat"sv; }
+};
+
+struct Q15MultiplyRoundSaturate {
+    i16x8 operator()(i16x8 lhs, i16x8 rhs) const
+    {
+        auto product = __builtin_convertvector(lhs, i32x8) * __builtin_convertvector(rhs, i32x8);
+        return saturate<i16x8>((product + 0x4000) >> 15);
+    }
+
+    static StringView name() { return "q15mulr_sat"sv; }
+};
+
+struct ShiftLeft {
+    template<NativeVector T>
+    T operator()(T lhs, i32 rhs) const { return lhs << static_cast<ElementOf<T>>(static_cast<u32>(rhs) % (sizeof(ElementOf<T>) * 8)); }
+
+    static StringView name() { return "shl"sv; }
+};
+
+struct ShiftRight {
+    template<NativeVector T>
+    T operator()(T lhs, i32 rhs) const { return lhs >> static_cast<ElementOf<T>>(static_cast<u32>(rhs) % (sizeof(ElementOf<T>) * 8)); }
+
+    static StringView name() { return "shr"sv; }
+};
+
+struct AnyTrue {
+    template<NativeVector T>
+    i32 operator()(T value) const
+    {
+        auto words = bit_cast<u64x2>(value);
+        return (words[0] | words[1]) != 0;
+    }
+
+    static StringView name() { return "any_true"sv; }
+};
+
+struct AllTrue {
+    template<NativeVector T>
+    i32 operator()(T value) const
+    {
+        for (size_t i = 0; i < lane_count<T>; ++i) {
+            if (value[i] == 0)
+                return 0;
+        }
+        return 1;
+    }
+
+    static StringView name() { return "all_true"sv; }
+};
+
+struct Bitmask {
+    template<NativeVector T>
+    i32 operator()(T value) const
+    {
+#if defined(__SSE2__)
+        if constexpr (sizeof(ElementOf<T>) == 1)
+            return __builtin_ia32_pmovmskb128(bit_cast<c8x16>(value));
+#endif
+        i32 result = 0;
+        for (size_t i = 0; i < lane_count<T>; ++i)
+            result |= static_cast<i32>(value[i] < 0) << i;
+        return result;
+    }
+
+    static StringView name() { return "bitmask"sv; }
+};
+
+struct PopCount {
+    u8x16 operator()(u8x16 value) const
+    {
+        u8x16 result;
+        for (size_t i = 0; i < 16; ++i)
+            result[i] = popcount(value[i]);
+        return result;
+    }
+
+    static StringView name() { return "popcnt"sv; }
+};
+
+// Selects bytes of the first vector by the indices in the second one, where out-of-range indices select zero.
+struct Swizzle {
+    u8x16 operator()(u8x16 vector, u8x16 indices) const
+    {
+        u8x16 result;
+        for (size_t i = 0; i < 16; ++i)
+            result[i] = indices[i] < 16 ? vector[indices[i]] : 0;
+        return result;
+    }
+
+    static StringView name() { return "swizzle"sv; }
+};
+
+template<NativeVector Result>
+struct Splat {
+    template<typename T>
+    Result operator()(T value) const { return Result {} + static_cast<ElementOf<Result>>(value); }
+
+    static StringView name() { return "splat"sv; }
+};
+
+// Puts the value in the first lane, and zeroes the others.
+template<NativeVector Result>
+struct ZeroExtend {
+    template<typename T>
+    Result operator()(T value) const
+    {
+        Result result {};
+        result[0] = static_cast<ElementOf<Result>>(value);
+        return result;
+    }
+
+    static StringView name() { return "zero"sv; }
+};
+
+template<NativeVector Result>
+struct Convert {
+    template<NativeVector T>
+    Result operator()(T value) const { return __builtin_convertvector(value, Result); }
+
+    static StringView name() { return "convert"sv; }
+};
+
+// Widens the lanes of the low or high half of the vector.
+template<NativeVector Result, bool high>
+struct Extend {
+    template<NativeVector T>
+    Result operator()(T value) const
+    {
+        using Half = WithElement<Result, ElementOf<T>>;
+        Half half;
+        __builtin_memcpy(&half, reinterpret_cast<u8 const*>(&value) + (high ? sizeof(Half) : 0), sizeof(Half));
+        return __builtin_convertvector(half, Result);
+    }
+
+    static StringView name() { return high ? "extend_high"sv : "extend_low"sv; }
+};
+
+template<NativeVector Result, bool high>
+struct ExtendMultiply {
+    template<NativeVector T>
+    Result operator()(T lhs, T rhs) const { return Extend<Result, high> {}(lhs) * Extend<Result, high> {}(rhs); }
+
+    static StringView name() { return high ? "extmul_high"sv : "extmul_low"sv; }
+};
+
+template<NativeVector Result>
+struct ExtendAddPairwise {
+    template<NativeVector T>
+    Result operator()(T value) const
+    {
+        Result result;
+        for (size_t i = 0; i < lane_count<Result>; ++i)
+            result[i] = static_cast<ElementOf<Result>>(value[2 * i]) + static_cast<ElementOf<Result>>(value[2 * i + 1]);
+        return result;
+    }
+
+    static StringView name() { return "extadd_pairwise"sv; }
+};
+
+struct Dot {
+    i32x4 operator()(i16x8 lhs, i16x8 rhs) const
+    {
+        auto products = __builtin_convertvector(lhs, i32x8) * __builtin_convertvector(rhs, i32x8);
+        i32x4 result;
+        // NOTE: Adding two products of -32768 * -32768 overflows, and has to wrap around.
+        for (size_t i = 0; i < 4; ++i)
+            result[i] = static_cast<i32>(static_cast<u32>(products[2 * i]) + static_cast<u32>(products[2 * i + 1]));
+        return result;
+    }
+
+    static StringView name() { return "dot"sv; }
+};
+
+// Saturates the lanes of both vectors into the narrower lanes of Result, the first vector's going into the low half.
+template<NativeVector Result>
+struct Narrow {
+    template<NativeVector T>
+    Result operator()(T lhs, T rhs) const
+    {
+        using Both = WithElement<Result, ElementOf<T>>;
+        Both both;
+        __builtin_memcpy(&both, &lhs, sizeof(T));
+        __builtin_memcpy(reinterpret_cast<u8*>(&both) + sizeof(T), &rhs, sizeof(T));
+        return saturate<Result>(both);
+    }
+
+    static StringView name() { return "narrow"sv; }
+};
+
+// Applies a scalar operator to every lane. If the result has fewer lanes than the operand, only the low lanes are used,
+// and if it has more, the remaining ones are zeroed.
+template<typename Operator, typename Result = void>
+struct Lanewise {
+    template<NativeVector T>
+    auto operator()(T value) const
+    {
+        using ResultVector = Conditional<IsVoid<Result>, T, Result>;
+        ResultVector result {};
+        for (size_t i = 0; i < min(lane_count<T>, lane_count<ResultVector>); ++i) {
+            auto lane = Operator {}(value[i]);
+            if constexpr (IsSpecializationOf<decltype(lane), AK::ErrorOr>)
+                result[i] = lane.release_value();
+            else
+                result[i] = lane;
+        }
+        return result;
+    }
+
+    template<NativeVector T>
+    T operator()(T lhs, T rhs) const
+    {
+        T result;
+        for (size_t i = 0; i < lane_count<T>; ++i)
+            result[i] = Operator {}(lhs[i], rhs[i]);
+        return result;
+    }
+
+    static StringView name() { return Operator::name(); }
+};
+
+}
+
+#pragma GCC diagnostic pop
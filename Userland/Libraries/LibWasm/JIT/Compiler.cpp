@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJIT/GDB.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/Opcode.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace Wasm::JIT {
+
+bool g_jit_enabled = getenv("LIBWASM_JIT") != nullptr;
+
+bool Compiler::should_compile(RegisterFunction const& function, u32 execution_count)
+{
+    if (!g_jit_enabled)
+        return false;
+
+    if (execution_count >= hotness_threshold)
+        return true;
+
+    // NOTE: Loops are where we spend our time, so don't wait around for functions containing them to warm up.
+    if (execution_count == 1) {
+        auto const* instructions = function.instructions().data();
+        for (size_t i = 0; i < function.instructions().size(); ++i) {
+            if (auto const* target = instructions[i].target; target && target <= &instructions[i])
+                return true;
+        }
+        for (auto const* target : function.jump_table()) {
+            // Jump tables are shared by the whole function, so any entry going backwards is close enough.
+            if (target == instructions)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef JIT_ARCH_SUPPORTED
+
+static ::JIT::Assembler::Condition invert(::JIT::Assembler::Condition condition)
+{
+    // Conditions come in pairs that only differ in their lowest bit.
+    return static_cast<::JIT::Assembler::Condition>(to_underlying(condition) ^ 1);
+}
+
+void Compiler::load_slot(Assembler::Reg dst, u32 slot, Width width)
+{
+    auto source = Assembler::Operand::Mem64BaseAndOffset(SLOTS_BASE, slot * sizeof(u64));
+    switch (width) {
+    case Width::I32ZeroExtended:
+        m_assembler.mov32(Assembler::Operand::Register(dst), source);
+        break;
+    case Width::I32SignExtended:
+        m_assembler.mov32(Assembler::Operand::Register(dst), source, Assembler::Extension::SignExtend);
+        break;
+    case Width::I64:
+        m_assembler.mov(Assembler::Operand::Register(dst), source);
+        break;
+    }
+}
+
+void Compiler::store_slot(u32 slot, Assembler::Reg src)
+{
+    m_assembler.mov(
+        Assembler::Operand::Mem64BaseAndOffset(SLOTS_BASE, slot * sizeof(u64)),
+        Assembler::Operand::Register(src));
+}
+
+void Compiler::reload_frame_state()
+{
+    // Anything that calls out may have reallocated the register file or resized the memory.
+    m_assembler.mov(
+        Assembler::Operand::Register(SLOTS_BASE),
+        Assembler::Operand::Mem64BaseAndOffset(FRAME_BASE, offsetof(RegisterFrame, slots)));
+    m_assembler.mov(
+        Assembler::Operand::Register(MEMORY_BASE),
+        Assembler::Operand::Mem64BaseAndOffset(FRAME_BASE, offsetof(RegisterFrame, memory_data)));
+    m_assembler.mov(
+        Assembler::Operand::Register(MEMORY_SIZE),
+        Assembler::Operand::Mem64BaseAndOffset(FRAME_BASE, offsetof(RegisterFrame, memory_size)));
+}
+
+size_t Compiler::index_of(RegisterInstruction const& instruction) const
+{
+    return &instruction - m_function.instructions().data();
+}
+
+Compiler::Assembler::Label& Compiler::label_for(RegisterInstruction const* instruction)
+{
+    return m_instruction_labels[index_of(*instruction)];
+}
+
+void Compiler::compile_call_to_handler(RegisterInstruction const& instruction)
+{
+    m_assembler.mov(Assembler::Operand::Register(ARG0), Assembler::Operand::Register(FRAME_BASE));
+    m_assembler.mov(Assembler::Operand::Register(ARG1), Assembler::Operand::Imm(bit_cast<FlatPtr>(&instruction)));
+    m_assembler.native_call(bit_cast<FlatPtr>(instruction.handler));
+    reload_frame_state();
+
+    // The handler returns null if it trapped, and otherwise either the next instruction or its branch target.
+    m_assembler.jump_if(
+        Assembler::Operand::Register(RETURN_VALUE),
+        Assembler::Condition::EqualTo,
+        Assembler::Operand::Imm(0),
+        m_exit_label);
+    if (instruction.target) {
+        m_assembler.mov(Assembler::Operand::Register(GPR1), Assembler::Operand::Imm(bit_cast<FlatPtr>(&instruction + 1)));
+        m_assembler.jump_if(
+            Assembler::Operand::Register(RETURN_VALUE),
+            Assembler::Condition::NotEqualTo,
+            Assembler::Operand::Register(GPR1),
+            label_for(instruction.target));
+    }
+}
+
+void Compiler::compile_move(RegisterInstruction const& instruction)
+{
+    if (instruction.destination == instruction.lhs)
+        return;
+    load_slot(GPR0, instruction.lhs);
+    store_slot(instruction.destination, GPR0);
+    // Vectors take up two slots, so moves in functions using them carry both halves along.
+    if (m_function.slot_width() == 2) {
+        load_slot(GPR0, instruction.lhs + 1);
+        store_slot(instruction.destination + 1, GPR0);
+    }
+}
+
+void Compiler::compile_select(RegisterInstruction const& instruction)
+{
+    if (m_function.slot_width() == 2) {
+        compile_call_to_handler(instruction);
+        return;
+    }
+    load_slot(GPR0, instruction.lhs);
+    load_slot(GPR1, instruction.rhs);
+    load_slot(GPR2, instruction.argument, Width::I32ZeroExtended);
+    m_assembler.cmp(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(0));
+    m_assembler.mov_if(Assembler::Condition::EqualTo, Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    store_slot(instruction.destination, GPR0);
+}
+
+void Compiler::compile_branch_if(RegisterInstruction const& instruction)
+{
+    load_slot(GPR0, instruction.lhs, Width::I32ZeroExtended);
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR0),
+        instruction.argument ? Assembler::Condition::NotEqualTo : Assembler::Condition::EqualTo,
+        Assembler::Operand::Imm(0),
+        label_for(instruction.target));
+}
+
+void Compiler::compile_branch_table(RegisterInstruction const& instruction)
+{
+    // The last target is the default one, taken for any index past the others.
+    auto targets = m_function.jump_table().span().slice(instruction.argument, instruction.rhs);
+    auto default_target = targets.last();
+    targets = targets.trim(targets.size() - 1);
+    load_slot(GPR0, instruction.lhs, Width::I32ZeroExtended);
+
+    // A few compares are quicker than an indirect jump, as long as the table is small.
+    static constexpr size_t max_compared_targets = 4;
+    if (targets.size() <= max_compared_targets) {
+        for (size_t i = 0; i < targets.size(); ++i) {
+            m_assembler.jump_if(
+                Assembler::Operand::Register(GPR0),
+                Assembler::Condition::EqualTo,
+                Assembler::Operand::Imm(i),
+                label_for(targets[i]));
+        }
+        m_assembler.jump(label_for(default_target));
+        return;
+    }
+
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR0),
+        Assembler::Condition::UnsignedGreaterThanOrEqualTo,
+        Assembler::Operand::Imm(targets.size()),
+        label_for(default_target));
+
+    // Every entry of the table is a jump to its target, padded to 8 bytes so that the index only needs to be shifted.
+    static constexpr size_t table_entry_size = 8;
+    static constexpr size_t jump_size = 5;
+    Assembler::Label table;
+    m_assembler.load_label_address(Assembler::Operand::Register(GPR1), table);
+    static_assert(table_entry_size == 1 << 3);
+    m_assembler.shift_left(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(3));
+    m_assembler.add(Assembler::Operand::Register(GPR1), Assembler::Operand::Register(GPR0));
+    m_assembler.jump(Assembler::Operand::Register(GPR1));
+
+    table.link(m_assembler);
+    for (auto const* target : targets) {
+        m_assembler.jump(label_for(target));
+        // int3
+        for (size_t i = jump_size; i < table_entry_size; ++i)
+            m_assembler.emit8(0xcc);
+    }
+}
+
+void Compiler::compile_equals_zero(RegisterInstruction const& instruction, Width width)
+{
+    load_slot(GPR0, instruction.lhs, width);
+    if (instruction.target) {
+        m_assembler.jump_if(
+            Assembler::Operand::Register(GPR0),
+            instruction.argument ? Assembler::Condition::EqualTo : Assembler::Condition::NotEqualTo,
+            Assembler::Operand::Imm(0),
+            label_for(instruction.target));
+        return;
+    }
+    m_assembler.mov(Assembler::Operand::Register(GPR1), Assembler::Operand::Imm(0));
+    m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(0));
+    m_assembler.set_if(Assembler::Condition::EqualTo, Assembler::Operand::Register(GPR1));
+    store_slot(instruction.destination, GPR1);
+}
+
+void Compiler::compile_comparison(RegisterInstruction const& instruction, Width width, Assembler::Condition condition)
+{
+    load_slot(GPR0, instruction.lhs, width);
+    load_slot(GPR1, instruction.rhs, width);
+    if (instruction.target) {
+        m_assembler.jump_if(
+            Assembler::Operand::Register(GPR0),
+            instruction.argument ? condition : invert(condition),
+            Assembler::Operand::Register(GPR1),
+            label_for(instruction.target));
+        return;
+    }
+    // NOTE: This has to be cleared before the comparison, as clearing it clobbers the flags.
+    m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(0));
+    m_assembler.cmp(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1));
+    m_assembler.set_if(condition, Assembler::Operand::Register(GPR2));
+    store_slot(instruction.destination, GPR2);
+}
+
+void Compiler::compile_binary_operation(RegisterInstruction const& instruction, Width width, void (Compiler::*emit_operation)())
+{
+    load_slot(GPR0, instruction.lhs, width);
+    load_slot(GPR1, instruction.rhs, width);
+    (this->*emit_operation)();
+    store_slot(instruction.destination, GPR0);
+}
+
+void Compiler::compile_extension(RegisterInstruction const& instruction, Width width)
+{
+    load_slot(GPR0, instruction.lhs, width);
+    store_slot(instruction.destination, GPR0);
+}
+
+void Compiler::compile_address(RegisterInstruction const& instruction, size_t size)
+{
+    // GPR0 = memory_data + address, or off to the handler (which traps) if the access is out of bounds.
+    load_slot(GPR0, instruction.lhs, Width::I32ZeroExtended);
+    if (instruction.immediate != 0) {
+        if (Assembler::Operand::Imm(instruction.immediate).fits_in_i32()) {
+            m_assembler.add(Assembler::Operand::Register(GPR0), Assembler::Operand::Imm(instruction.immediate));
+        } else {
+            m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(instruction.immediate));
+            m_assembler.add(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR2));
+        }
+    }
+    m_assembler.mov(Assembler::Operand::Register(GPR2), Assembler::Operand::Register(GPR0));
+    m_assembler.add(Assembler::Operand::Register(GPR2), Assembler::Operand::Imm(size));
+
+    m_slow_cases.append({ {}, &instruction });
+    m_assembler.jump_if(
+        Assembler::Operand::Register(GPR2),
+        Assembler::Condition::UnsignedGreaterThan,
+        Assembler::Operand::Register(MEMORY_SIZE),
+        m_slow_cases.last().label);
+
+    m_assembler.add(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(MEMORY_BASE));
+}
+
+void Compiler::compile_load(RegisterInstruction const& instruction, size_t size, Assembler::Extension extension, bool extend_to_64_bits)
+{
+    compile_address(instruction, size);
+    auto source = Assembler::Operand::Mem64BaseAndOffset(GPR0, 0);
+    switch (size) {
+    case 1:
+        m_assembler.mov8(Assembler::Operand::Register(GPR0), source, extension);
+        break;
+    case 2:
+        m_assembler.mov16(Assembler::Operand::Register(GPR0), source, extension);
+        break;
+    case 4:
+        // NOTE: A sign-extending 32-bit load already extends all the way to 64 bits.
+        m_assembler.mov32(Assembler::Operand::Register(GPR0), source, extension);
+        extend_to_64_bits = false;
+        break;
+    case 8:
+        m_assembler.mov(Assembler::Operand::Register(GPR0), source);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    if (extend_to_64_bits && extension == Assembler::Extension::SignExtend)
+        m_assembler.sign_extend_32_to_64_bits(GPR0);
+    store_slot(instruction.destination, GPR0);
+}
+
+void Compiler::compile_store(RegisterInstruction const& instruction, size_t size)
+{
+    compile_address(instruction, size);
+    load_slot(GPR1, instruction.rhs);
+    auto destination = Assembler::Operand::Mem64BaseAndOffset(GPR0, 0);
+    switch (size) {
+    case 1:
+        m_assembler.mov8(destination, Assembler::Operand::Register(GPR1));
+        break;
+    case 2:
+        m_assembler.mov16(destination, Assembler::Operand::Register(GPR1));
+        break;
+    case 4:
+        m_assembler.mov32(destination, Assembler::Operand::Register(GPR1));
+        break;
+    case 8:
+        m_assembler.mov(destination, Assembler::Operand::Register(GPR1));
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void Compiler::compile_instruction(RegisterInstruction const& instruction)
+{
+    using Condition = Assembler::Condition;
+    using Extension = Assembler::Extension;
+
+    switch (instruction.opcode.value()) {
+    case Instructions::local_set.value():
+    case Instructions::i32_reinterpret_f32.value():
+    case Instructions::i64_reinterpret_f64.value():
+    case Instructions::f32_reinterpret_i32.value():
+    case Instructions::f64_reinterpret_i64.value():
+        compile_move(instruction);
+        return;
+    case Instructions::select.value():
+    case Instructions::select_typed.value():
+        compile_select(instruction);
+        return;
+    case Instructions::br.value():
+        m_assembler.jump(label_for(instruction.target));
+        return;
+    case Instructions::br_if.value():
+        compile_branch_if(instruction);
+        return;
+    case Instructions::br_table.value():
+        compile_branch_table(instruction);
+        return;
+    case Instructions::return_.value():
+        m_assembler.jump(m_exit_label);
+        return;
+
+    case Instructions::i32_eqz.value():
+        compile_equals_zero(instruction, Width::I32ZeroExtended);
+        return;
+    case Instructions::i64_eqz.value():
+        compile_equals_zero(instruction, Width::I64);
+        return;
+
+#    define JIT_ENUMERATE_COMPARISONS(O)                          \
+        O(i32_eq, I32ZeroExtended, EqualTo)                       \
+        O(i32_ne, I32ZeroExtended, NotEqualTo)                    \
+        O(i32_lts, I32SignExtended, SignedLessThan)               \
+        O(i32_ltu, I32ZeroExtended, UnsignedLessThan)             \
+        O(i32_gts, I32SignExtended, SignedGreaterThan)            \
+        O(i32_gtu, I32ZeroExtended, UnsignedGreaterThan)          \
+        O(i32_les, I32SignExtended, SignedLessThanOrEqualTo)      \
+        O(i32_leu, I32ZeroExtended, UnsignedLessThanOrEqualTo)    \
+        O(i32_ges, I32SignExtended, SignedGreaterThanOrEqualTo)   \
+        O(i32_geu, I32ZeroExtended, UnsignedGreaterThanOrEqualTo) \
+        O(i64_eq, I64, EqualTo)                                   \
+        O(i64_ne, I64, NotEqualTo)                                \
+        O(i64_lts, I64, SignedLessThan)                           \
+        O(i64_ltu, I64, UnsignedLessThan)                         \
+        O(i64_gts, I64, SignedGreaterThan)                        \
+        O(i64_gtu, I64, UnsignedGreaterThan)                      \
+        O(i64_les, I64, SignedLessThanOrEqualTo)                  \
+        O(i64_leu, I64, UnsignedLessThanOrEqualTo)                \
+        O(i64_ges, I64, SignedGreaterThanOrEqualTo)               \
+        O(i64_geu, I64, UnsignedGreaterThanOrEqualTo)
+
+#    define CASE_COMPARISON(name, width, condition)                          \
+    case Instructions::name.value():                                         \
+        compile_comparison(instruction, Width::width, Condition::condition); \
+        return;
+        JIT_ENUMERATE_COMPARISONS(CASE_COMPARISON)
+#    undef CASE_COMPARISON
+#    undef JIT_ENUMERATE_COMPARISONS
+
+    // NOTE: The 32-bit operations leave the upper half of the result zeroed, and so do the 64-bit bitwise operations
+    //       when given two zero-extended operands.
+#    define JIT_ENUMERATE_BINARY_OPERATIONS(O)                      \
+        O(i32_add, I32ZeroExtended, emit_add32)                     \
+        O(i32_sub, I32ZeroExtended, emit_sub32)                     \
+        O(i32_mul, I32ZeroExtended, emit_mul32)                     \
+        O(i32_and, I32ZeroExtended, emit_and)                       \
+        O(i32_or, I32ZeroExtended, emit_or)                         \
+        O(i32_xor, I32ZeroExtended, emit_xor)                       \
+        O(i32_shl, I32ZeroExtended, emit_shift_left32)              \
+        O(i32_shru, I32ZeroExtended, emit_shift_right32)            \
+        O(i32_shrs, I32ZeroExtended, emit_arithmetic_right_shift32) \
+        O(i64_add, I64, emit_add)                                   \
+        O(i64_sub, I64, emit_sub)                                   \
+        O(i64_mul, I64, emit_mul)                                   \
+        O(i64_and, I64, emit_and)                                   \
+        O(i64_or, I64, emit_or)                                     \
+        O(i64_xor, I64, emit_xor)                                   \
+        O(i64_shl, I64, emit_shift_left)                            \
+        O(i64_shru, I64, emit_shift_right)                          \
+        O(i64_shrs, I64, emit_arithmetic_right_shift)
+
+#    define CASE_BINARY_OPERATION(name, width, emitter)                          \
+    case Instructions::name.value():                                             \
+        compile_binary_operation(instruction, Width::width, &Compiler::emitter); \
+        return;
+        JIT_ENUMERATE_BINARY_OPERATIONS(CASE_BINARY_OPERATION)
+#    undef CASE_BINARY_OPERATION
+#    undef JIT_ENUMERATE_BINARY_OPERATIONS
+
+    case Instructions::i32_wrap_i64.value():
+    case Instructions::i64_extend_ui32.value():
+        compile_extension(instruction, Width::I32ZeroExtended);
+        return;
+    case Instructions::i64_extend_si32.value():
+        compile_extension(instruction, Width::I32SignExtended);
+        return;
+
+    case Instructions::i32_load.value():
+    case Instructions::f32_load.value():
+    case Instructions::i64_load32_u.value():
+        compile_load(instruction, 4, Extension::ZeroExtend);
+        return;
+    case Instructions::i64_load.value():
+    case Instructions::f64_load.value():
+        compile_load(instruction, 8, Extension::ZeroExtend);
+        return;
+    case Instructions::i32_load8_s.value():
+        compile_load(instruction, 1, Extension::SignExtend);
+        return;
+    case Instructions::i32_load8_u.value():
+    case Instructions::i64_load8_u.value():
+        compile_load(instruction, 1, Extension::ZeroExtend);
+        return;
+    case Instructions::i32_load16_s.value():
+        compile_load(instruction, 2, Extension::SignExtend);
+        return;
+    case Instructions::i32_load16_u.value():
+    case Instructions::i64_load16_u.value():
+        compile_load(instruction, 2, Extension::ZeroExtend);
+        return;
+    case Instructions::i64_load8_s.value():
+        compile_load(instruction, 1, Extension::SignExtend, true);
+        return;
+    case Instructions::i64_load16_s.value():
+        compile_load(instruction, 2, Extension::SignExtend, true);
+        return;
+    case Instructions::i64_load32_s.value():
+        compile_load(instruction, 4, Extension::SignExtend, true);
+        return;
+    case Instructions::i32_store8.value():
+    case Instructions::i64_store8.value():
+        compile_store(instruction, 1);
+        return;
+    case Instructions::i32_store16.value():
+    case Instructions::i64_store16.value():
+        compile_store(instruction, 2);
+        return;
+    case Instructions::i32_store.value():
+    case Instructions::f32_store.value():
+    case Instructions::i64_store32.value():
+        compile_store(instruction, 4);
+        return;
+    case Instructions::i64_store.value():
+    case Instructions::f64_store.value():
+        compile_store(instruction, 8);
+        return;
+
+    default:
+        compile_call_to_handler(instruction);
+        return;
+    }
+}
+
+OwnPtr<NativeFunction> Compiler::compile(RegisterFunction const& function)
+{
+    if (!should_compile(function, hotness_threshold))
+        return nullptr;
+
+    Compiler compiler { function };
+    auto& assembler = compiler.m_assembler;
+    auto& instructions = function.instructions();
+    compiler.m_instruction_labels.resize(instructions.size());
+
+    // void native_code(RegisterFrame*)
+    assembler.enter();
+    assembler.mov(Assembler::Operand::Register(FRAME_BASE), Assembler::Operand::Register(ARG0));
+    compiler.reload_frame_state();
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        compiler.m_instruction_labels[i].link(assembler);
+        compiler.compile_instruction(instructions[i]);
+    }
+
+    // Out-of-bounds memory accesses go through the handler, which reports the trap just like the interpreter does.
+    for (auto& slow_case : compiler.m_slow_cases) {
+        slow_case.label.link(assembler);
+        compiler.compile_call_to_handler(*slow_case.instruction);
+        assembler.jump(compiler.label_for(slow_case.instruction + 1));
+    }
+
+    compiler.m_exit_label.link(assembler);
+    assembler.exit();
+
+    auto& output = compiler.m_output;
+    auto* code = mmap(nullptr, output.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        perror("JIT: mmap");
+        return nullptr;
+    }
+    memcpy(code, output.data(), output.size());
+    if (mprotect(code, output.size(), PROT_READ | PROT_EXEC) < 0) {
+        perror("JIT: mprotect");
+        munmap(code, output.size());
+        return nullptr;
+    }
+
+    dbgln_if(WASM_JIT_DEBUG, "JIT: Compiled function ({} instructions -> {} bytes of machine code)", instructions.size(), output.size());
+
+    auto gdb_object = ::JIT::GDB::build_gdb_image({ static_cast<u8 const*>(code), output.size() }, "LibWasm JIT"sv, "wasm function"sv);
+
+    return make<NativeFunction>(code, output.size(), move(gdb_object));
+}
+
+#else
+
+OwnPtr<NativeFunction> Compiler::compile(RegisterFunction const&)
+{
+    return nullptr;
+}
+
+#endif
+
+}
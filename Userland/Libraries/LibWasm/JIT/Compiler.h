@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJIT/Assembler.h>
+#include <LibWasm/AbstractMachine/RegisterFunction.h>
+#include <LibWasm/JIT/NativeFunction.h>
+
+namespace Wasm::JIT {
+
+extern bool g_jit_enabled;
+
+// A single-pass baseline compiler from register functions to native code. Instructions it doesn't know how to compile
+// are run by calling their register function handler, so every register function can be compiled.
+class Compiler {
+public:
+    // Functions are compiled once they have been called this many times,
+    // or on first call if they contain a loop.
+    static constexpr u32 hotness_threshold = 10;
+
+    static bool should_compile(RegisterFunction const&, u32 execution_count);
+    static OwnPtr<NativeFunction> compile(RegisterFunction const&);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+
+    static constexpr auto GPR0 = Assembler::Reg::RAX;
+    static constexpr auto GPR1 = Assembler::Reg::RCX;
+    static constexpr auto GPR2 = Assembler::Reg::RDX;
+    static constexpr auto ARG0 = Assembler::Reg::RDI;
+    static constexpr auto ARG1 = Assembler::Reg::RSI;
+    static constexpr auto RETURN_VALUE = Assembler::Reg::RAX;
+    static constexpr auto FRAME_BASE = Assembler::Reg::R14;
+    static constexpr auto SLOTS_BASE = Assembler::Reg::RBX;
+    static constexpr auto MEMORY_BASE = Assembler::Reg::R15;
+    // NOTE: This one is never used to address memory, as the assembler can't encode R12 as a base register.
+    static constexpr auto MEMORY_SIZE = Assembler::Reg::R12;
+
+    // How an i32 or i64 operand gets loaded into a 64-bit register.
+    enum class Width {
+        I32ZeroExtended,
+        I32SignExtended,
+        I64,
+    };
+
+    explicit Compiler(RegisterFunction const& function)
+        : m_function(function)
+    {
+    }
+
+    void compile_instruction(RegisterInstruction const&);
+
+    void compile_move(RegisterInstruction const&);
+    void compile_select(RegisterInstruction const&);
+    void compile_branch_if(RegisterInstruction const&);
+    void compile_branch_table(RegisterInstruction const&);
+    void compile_equals_zero(RegisterInstruction const&, Width);
+    void compile_comparison(RegisterInstruction const&, Width, Assembler::Condition);
+    void compile_binary_operation(RegisterInstruction const&, Width, void (Compiler::*)());
+    void compile_extension(RegisterInstruction const&, Width);
+    void compile_load(RegisterInstruction const&, size_t size, Assembler::Extension, bool extend_to_64_bits = false);
+    void compile_store(RegisterInstruction const&, size_t size);
+    void compile_address(RegisterInstruction const&, size_t size);
+    void compile_call_to_handler(RegisterInstruction const&);
+
+    void emit_add32() { m_assembler.add32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), {}); }
+    void emit_sub32() { m_assembler.sub32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), {}); }
+    void emit_mul32() { m_assembler.mul32(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1), {}); }
+    void emit_shift_left32() { m_assembler.shift_left32(Assembler::Operand::Register(GPR0), {}); }
+    void emit_shift_right32() { m_assembler.shift_right32(Assembler::Operand::Register(GPR0), {}); }
+    void emit_arithmetic_right_shift32() { m_assembler.arithmetic_right_shift32(Assembler::Operand::Register(GPR0), {}); }
+    void emit_add() { m_assembler.add(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1)); }
+    void emit_sub() { m_assembler.sub(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1)); }
+    void emit_mul() { m_assembler.mul(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1)); }
+    void emit_and() { m_assembler.bitwise_and(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1)); }
+    void emit_or() { m_assembler.bitwise_or(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1)); }
+    void emit_xor() { m_assembler.bitwise_xor(Assembler::Operand::Register(GPR0), Assembler::Operand::Register(GPR1)); }
+    void emit_shift_left() { m_assembler.shift_left(Assembler::Operand::Register(GPR0), {}); }
+    void emit_shift_right() { m_assembler.shift_right(Assembler::Operand::Register(GPR0), {}); }
+    void emit_arithmetic_right_shift() { m_assembler.arithmetic_right_shift(Assembler::Operand::Register(GPR0), {}); }
+
+    void load_slot(Assembler::Reg, u32 slot, Width = Width::I64);
+    void store_slot(u32 slot, Assembler::Reg);
+    void reload_frame_state();
+
+    Assembler::Label& label_for(RegisterInstruction const*);
+    size_t index_of(RegisterInstruction const&) const;
+
+    RegisterFunction const& m_function;
+
+    struct SlowCase {
+        Assembler::Label label;
+        RegisterInstruction const* instruction { nullptr };
+    };
+
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+    Assembler::Label m_exit_label;
+    Vector<Assembler::Label> m_instruction_labels;
+    Vector<SlowCase> m_slow_cases;
+#endif
+};
+
+}
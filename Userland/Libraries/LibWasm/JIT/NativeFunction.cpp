@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJIT/GDB.h>
+#include <LibWasm/AbstractMachine/RegisterFunction.h>
+#include <LibWasm/JIT/NativeFunction.h>
+#include <sys/mman.h>
+
+namespace Wasm::JIT {
+
+NativeFunction::NativeFunction(void* code, size_t size, Optional<FixedArray<u8>> gdb_object)
+    : m_code(code)
+    , m_size(size)
+    , m_gdb_object(move(gdb_object))
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::register_into_gdb(m_gdb_object.value().span());
+}
+
+NativeFunction::~NativeFunction()
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::unregister_from_gdb(m_gdb_object.value().span());
+    munmap(m_code, m_size);
+}
+
+void NativeFunction::run(RegisterFrame& frame) const
+{
+    using JITCode = void (*)(RegisterFrame*);
+    reinterpret_cast<JITCode>(m_code)(&frame);
+}
+
+}
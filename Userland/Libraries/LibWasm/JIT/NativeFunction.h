@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FixedArray.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+
+namespace Wasm {
+
+struct RegisterFrame;
+
+namespace JIT {
+
+class NativeFunction {
+    AK_MAKE_NONCOPYABLE(NativeFunction);
+    AK_MAKE_NONMOVABLE(NativeFunction);
+
+public:
+    NativeFunction(void* code, size_t size, Optional<FixedArray<u8>> gdb_object = {});
+    ~NativeFunction();
+
+    // Runs the compiled code from the first instruction of the function. Traps end up in the frame's context,
+    // exactly as if the register function had been interpreted.
+    void run(RegisterFrame&) const;
+
+    ReadonlyBytes code_bytes() const { return { m_code, m_size }; }
+
+private:
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    Optional<FixedArray<u8>> m_gdb_object;
+};
+
+}
+
+}
@@ -799,6 +799,8 @@ ParseResult<Vector<Instruction>> Instruction::parse(Stream& stream, InstructionP
             case Instructions::v128_load16_splat.value():
             case Instructions::v128_load32_splat.value():
             case Instructions::v128_load64_splat.value():
+            case Instructions::v128_load32_zero.value():
+            case Instructions::v128_load64_zero.value():
             case Instructions::v128_store.value(): {
                 // op (align [multi-memory memindex] offset)
                 auto align_or_error = stream.read_value<LEB128<u32>>();
@@ -959,8 +961,6 @@ ParseResult<Vector<Instruction>> Instruction::parse(Stream& stream, InstructionP
             case Instructions::v128_xor.value():
             case Instructions::v128_bitselect.value():
             case Instructions::v128_any_true.value():
-            case Instructions::v128_load32_zero.value():
-            case Instructions::v128_load64_zero.value():
             case Instructions::f32x4_demote_f64x2_zero.value():
             case Instructions::f64x2_promote_low_f32x4.value():
             case Instructions::i8x16_abs.value():
@@ -1647,55 +1647,46 @@ ParseResult<Module> Module::parse(Stream& stream)
         size_t section_size = section_size_or_error.release_value();
 
         auto section_stream = ConstrainedStream { MaybeOwned<Stream>(stream), section_size };
-
-        switch (section_id) {
-        case CustomSection::section_id:
-            sections.append(TRY(CustomSection::parse(section_stream)));
-            continue;
-        case TypeSection::section_id:
-            sections.append(TRY(TypeSection::parse(section_stream)));
-            continue;
-        case ImportSection::section_id:
-            sections.append(TRY(ImportSection::parse(section_stream)));
-            continue;
-        case FunctionSection::section_id:
-            sections.append(TRY(FunctionSection::parse(section_stream)));
-            continue;
-        case TableSection::section_id:
-            sections.append(TRY(TableSection::parse(section_stream)));
-            continue;
-        case MemorySection::section_id:
-            sections.append(TRY(MemorySection::parse(section_stream)));
-            continue;
-        case GlobalSection::section_id:
-            sections.append(TRY(GlobalSection::parse(section_stream)));
-            continue;
-        case ExportSection::section_id:
-            sections.append(TRY(ExportSection::parse(section_stream)));
-            continue;
-        case StartSection::section_id:
-            sections.append(TRY(StartSection::parse(section_stream)));
-            continue;
-        case ElementSection::section_id:
-            sections.append(TRY(ElementSection::parse(section_stream)));
-            continue;
-        case CodeSection::section_id:
-            sections.append(TRY(CodeSection::parse(section_stream)));
-            continue;
-        case DataSection::section_id:
-            sections.append(TRY(DataSection::parse(section_stream)));
-            continue;
-        case DataCountSection::section_id:
-            sections.append(TRY(DataCountSection::parse(section_stream)));
-            continue;
-        default:
-            return with_eof_check(stream, ParseError::InvalidIndex);
-        }
+        sections.append(TRY(parse_section(section_id, section_stream)));
     }
 
     return Module { move(sections) };
 }
 
+ParseResult<Module::AnySection> Module::parse_section(u8 section_id, Stream& stream)
+{
+    switch (section_id) {
+    case CustomSection::section_id:
+        return TRY(CustomSection::parse(stream));
+    case TypeSection::section_id:
+        return TRY(TypeSection::parse(stream));
+    case ImportSection::section_id:
+        return TRY(ImportSection::parse(stream));
+    case FunctionSection::section_id:
+        return TRY(FunctionSection::parse(stream));
+    case TableSection::section_id:
+        return TRY(TableSection::parse(stream));
+    case MemorySection::section_id:
+        return TRY(MemorySection::parse(stream));
+    case GlobalSection::section_id:
+        return TRY(GlobalSection::parse(stream));
+    case ExportSection::section_id:
+        return TRY(ExportSection::parse(stream));
+    case StartSection::section_id:
+        return TRY(StartSection::parse(stream));
+    case ElementSection::section_id:
+        return TRY(ElementSection::parse(stream));
+    case CodeSection::section_id:
+        return TRY(CodeSection::parse(stream));
+    case DataSection::section_id:
+        return TRY(DataSection::parse(stream));
+    case DataCountSection::section_id:
+        return TRY(DataCountSection::parse(stream));
+    default:
+        return with_eof_check(stream, ParseError::InvalidIndex);
+    }
+}
+
 bool Module::populate_sections()
 {
     auto is_ok = true;
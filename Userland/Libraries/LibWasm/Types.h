@@ -1081,6 +1081,7 @@ public:
     void set_validation_error(ByteString error) { m_validation_error = move(error); }
 
     static ParseResult<Module> parse(Stream& stream);
+    static ParseResult<AnySection> parse_section(u8 section_id, Stream& stream);
 
 private:
     bool populate_sections();
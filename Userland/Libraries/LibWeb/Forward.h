@@ -685,6 +685,7 @@ class PerformanceMeasure;
 }
 
 namespace Web::WebAssembly {
+class CompileError;
 class Instance;
 class Memory;
 class Module;
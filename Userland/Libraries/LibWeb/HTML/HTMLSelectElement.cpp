@@ -55,7 +55,7 @@ void HTMLSelectElement::visit_edges(Cell::Visitor& visitor)
             visitor.visit(item.get<SelectItemOption>().option_element);
 
         if (item.has<SelectItemOptionGroup>()) {
-            auto item_option_group = item.get<SelectItemOptionGroup>();
+            auto const& item_option_group = item.get<SelectItemOptionGroup>();
             for (auto const& item : item_option_group.items)
                 visitor.visit(item.option_element);
         }
@@ -6,7 +6,9 @@
 
 #include <AK/Debug.h>
 #include <LibCore/ElapsedTimer.h>
+#include <LibJS/BackgroundParser.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Heap/Handle.h>
 #include <LibWeb/Bindings/ExceptionOrUtils.h>
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
 #include <LibWeb/HTML/Scripting/Environments.h>
@@ -20,18 +22,60 @@ JS_DEFINE_ALLOCATOR(ClassicScript);
 // https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-classic-script
 JS::NonnullGCPtr<ClassicScript> ClassicScript::create(ByteString filename, StringView source, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, size_t source_line_number, MutedErrors muted_errors)
 {
-    auto& vm = environment_settings_object.realm().vm();
-
     // 1. If muted errors was not provided, let it be false. (NOTE: This is taken care of by the default argument.)
 
-    // 2. If muted errors is true, then set baseURL to about:blank.
-    if (muted_errors == MutedErrors::Yes)
-        base_url = "about:blank"sv;
+    // 3. If scripting is disabled for settings, then set source to the empty string.
+    if (environment_settings_object.is_scripting_disabled())
+        source = ""sv;
+
+    // 2., 4. - 9.
+    auto script = allocate(move(filename), environment_settings_object, move(base_url), muted_errors);
+
+    // 10. Let result be ParseScript(source, settings's Realm, script).
+    auto parse_timer = Core::ElapsedTimer::start_new();
+    auto result = JS::Script::parse_program(source, script->filename(), source_line_number);
+    dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
+
+    // 11. - 12.
+    script->set_parse_result(move(result));
+
+    // 13. Return script.
+    return script;
+}
+
+void ClassicScript::create_in_background(ByteString filename, StringView source, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, MutedErrors muted_errors, Function<void(JS::NonnullGCPtr<ClassicScript>)> on_complete)
+{
+    auto& vm = environment_settings_object.realm().vm();
 
     // 3. If scripting is disabled for settings, then set source to the empty string.
     if (environment_settings_object.is_scripting_disabled())
         source = ""sv;
 
+    // 10. Let result be ParseScript(source, settings's Realm, script).
+    // NOTE: The source is parsed before the script is allocated, since allocating has to happen on this thread.
+    auto parse_timer = Core::ElapsedTimer::start_new();
+    JS::BackgroundParser::parse_script(vm, source, filename, 1, [filename, environment_settings_object = JS::make_handle(environment_settings_object), base_url = move(base_url), muted_errors, parse_timer, on_complete = move(on_complete)](auto result) mutable {
+        dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in the background in {}ms", filename, parse_timer.elapsed());
+
+        // 2., 4. - 9.
+        auto script = allocate(move(filename), *environment_settings_object, move(base_url), muted_errors);
+
+        // 11. - 12.
+        script->set_parse_result(move(result));
+
+        // 13. Return script.
+        on_complete(script);
+    });
+}
+
+JS::NonnullGCPtr<ClassicScript> ClassicScript::allocate(ByteString filename, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, MutedErrors muted_errors)
+{
+    auto& vm = environment_settings_object.realm().vm();
+
+    // 2. If muted errors is true, then set baseURL to about:blank.
+    if (muted_errors == MutedErrors::Yes)
+        base_url = "about:blank"sv;
+
     // 4. Let script be a new classic script that this algorithm will subsequently initialize.
     auto script = vm.heap().allocate_without_realm<ClassicScript>(move(base_url), move(filename), environment_settings_object);
 
@@ -48,29 +92,29 @@ JS::NonnullGCPtr<ClassicScript> ClassicScript::create(ByteString filename, Strin
     script->set_parse_error(JS::js_null());
     script->set_error_to_rethrow(JS::js_null());
 
-    // 10. Let result be ParseScript(source, settings's Realm, script).
-    auto parse_timer = Core::ElapsedTimer::start_new();
-    auto result = JS::Script::parse(source, environment_settings_object.realm(), script->filename(), script, source_line_number);
-    dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
+    return script;
+}
+
+void ClassicScript::set_parse_result(Result<NonnullRefPtr<JS::Program>, Vector<JS::ParserError>> result)
+{
+    auto& realm = settings_object().realm();
 
     // 11. If result is a list of errors, then:
     if (result.is_error()) {
-        auto& parse_error = result.error().first();
-        dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Failed to parse: {}", parse_error.to_string());
+        auto& error = result.error().first();
+        dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Failed to parse: {}", error.to_string());
 
         // 1. Set script's parse error and its error to rethrow to result[0].
-        script->set_parse_error(JS::SyntaxError::create(environment_settings_object.realm(), parse_error.to_string()));
-        script->set_error_to_rethrow(script->parse_error());
+        set_parse_error(JS::SyntaxError::create(realm, error.to_string()));
+        set_error_to_rethrow(parse_error());
 
         // 2. Return script.
-        return script;
+        return;
     }
 
     // 12. Set script's record to result.
-    script->m_script_record = *result.release_value();
-
-    // 13. Return script.
-    return script;
+    // NOTE: ParseScript creates the Script Record once the source has been parsed.
+    m_script_record = JS::Script::create(realm, filename(), result.release_value(), this);
 }
 
 // https://html.spec.whatwg.org/multipage/webappapis.html#run-a-classic-script
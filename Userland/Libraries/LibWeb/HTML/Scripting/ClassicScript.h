@@ -26,6 +26,10 @@ public:
     };
     static JS::NonnullGCPtr<ClassicScript> create(ByteString filename, StringView source, EnvironmentSettingsObject&, URL::URL base_url, size_t source_line_number = 1, MutedErrors = MutedErrors::No);
 
+    // Like create(), but the source is parsed on another thread, and on_complete is invoked with the script from the
+    // event loop once it's done.
+    static void create_in_background(ByteString filename, StringView source, EnvironmentSettingsObject&, URL::URL base_url, MutedErrors, Function<void(JS::NonnullGCPtr<ClassicScript>)> on_complete);
+
     JS::Script* script_record() { return m_script_record; }
     JS::Script const* script_record() const { return m_script_record; }
 
@@ -40,6 +44,9 @@ public:
 private:
     ClassicScript(URL::URL base_url, ByteString filename, EnvironmentSettingsObject& environment_settings_object);
 
+    static JS::NonnullGCPtr<ClassicScript> allocate(ByteString filename, EnvironmentSettingsObject&, URL::URL base_url, MutedErrors);
+    void set_parse_result(Result<NonnullRefPtr<JS::Program>, Vector<JS::ParserError>>);
+
     virtual void visit_edges(Cell::Visitor&) override;
 
     JS::GCPtr<JS::Script> m_script_record;
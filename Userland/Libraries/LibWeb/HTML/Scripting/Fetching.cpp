@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibJS/Heap/Handle.h>
 #include <LibJS/Heap/HeapFunction.h>
 #include <LibJS/Runtime/ModuleRequest.h>
 #include <LibTextCodec/Decoder.h>
@@ -278,6 +279,9 @@ static void set_up_module_script_request(Fetch::Infrastructure::Request& request
     request.set_priority(options.fetch_priority);
 }
 
+// Parsing smaller scripts on another thread isn't worth the round trip through the event loop.
+static constexpr size_t minimum_size_of_script_to_parse_in_background = 64 * KiB;
+
 // https://html.spec.whatwg.org/multipage/webappapis.html#fetch-a-classic-script
 WebIDL::ExceptionOr<void> fetch_classic_script(JS::NonnullGCPtr<HTMLScriptElement> element, URL::URL const& url, EnvironmentSettingsObject& settings_object, ScriptFetchOptions options, CORSSettingAttribute cors_setting, String character_encoding, OnFetchScriptComplete on_complete)
 {
@@ -333,6 +337,16 @@ WebIDL::ExceptionOr<void> fetch_classic_script(JS::NonnullGCPtr<HTMLScriptElemen
         //    options, and muted errors.
         // FIXME: Pass options.
         auto response_url = response->url().value_or({});
+
+        // NOTE: Large scripts are parsed on another thread, so that the page stays responsive in the meantime.
+        if (source_text.bytes().size() >= minimum_size_of_script_to_parse_in_background) {
+            ClassicScript::create_in_background(response_url.to_byte_string(), source_text, settings_object, response_url, muted_errors, [on_complete = JS::make_handle(on_complete)](auto script) {
+                // 8. Run onComplete given script.
+                on_complete->function()(script);
+            });
+            return;
+        }
+
         auto script = ClassicScript::create(response_url.to_byte_string(), source_text, settings_object, response_url, 1, muted_errors);
 
         // 8. Run onComplete given script.
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Runtime/AbstractOperations.h>
+#include <LibJS/Runtime/ErrorConstructor.h>
+#include <LibJS/Runtime/PrimitiveString.h>
+#include <LibJS/Runtime/Realm.h>
+#include <LibWeb/Bindings/Intrinsics.h>
+#include <LibWeb/WebAssembly/CompileError.h>
+
+namespace Web::Bindings {
+
+template<>
+void Intrinsics::create_web_prototype_and_constructor<WebAssembly::CompileErrorPrototype>(JS::Realm& realm)
+{
+    auto& vm = realm.vm();
+
+    auto prototype = heap().allocate<WebAssembly::CompileErrorPrototype>(realm, realm);
+    m_prototypes.set("WebAssembly.CompileError"_fly_string, prototype);
+
+    auto constructor = heap().allocate<WebAssembly::CompileErrorConstructor>(realm, realm);
+    m_constructors.set("WebAssembly.CompileError"_fly_string, constructor);
+
+    prototype->define_direct_property(vm.names.constructor, constructor.ptr(), JS::Attribute::Writable | JS::Attribute::Configurable);
+}
+
+}
+
+namespace Web::WebAssembly {
+
+JS_DEFINE_ALLOCATOR(CompileError);
+JS_DEFINE_ALLOCATOR(CompileErrorPrototype);
+JS_DEFINE_ALLOCATOR(CompileErrorConstructor);
+
+JS::NonnullGCPtr<CompileError> CompileError::create(JS::Realm& realm, StringView message)
+{
+    auto& vm = realm.vm();
+    auto& prototype = Bindings::ensure_web_prototype<CompileErrorPrototype>(realm, "WebAssembly.CompileError"_fly_string);
+    auto error = realm.heap().allocate<CompileError>(realm, prototype);
+    error->define_direct_property(vm.names.message, JS::PrimitiveString::create(vm, MUST(String::from_utf8(message))), JS::Attribute::Writable | JS::Attribute::Configurable);
+    return error;
+}
+
+CompileError::CompileError(JS::Object& prototype)
+    : JS::Error(prototype)
+{
+}
+
+CompileErrorPrototype::CompileErrorPrototype(JS::Realm& realm)
+    : JS::Object(ConstructWithPrototypeTag::Tag, realm.intrinsics().error_prototype())
+{
+}
+
+void CompileErrorPrototype::initialize(JS::Realm& realm)
+{
+    auto& vm = this->vm();
+    Base::initialize(realm);
+
+    u8 attr = JS::Attribute::Writable | JS::Attribute::Configurable;
+    define_direct_property(vm.names.name, JS::PrimitiveString::create(vm, "CompileError"_string), attr);
+    define_direct_property(vm.names.message, JS::PrimitiveString::create(vm, String {}), attr);
+}
+
+CompileErrorConstructor::CompileErrorConstructor(JS::Realm& realm)
+    : NativeFunction("CompileError", realm.intrinsics().error_constructor())
+{
+}
+
+void CompileErrorConstructor::initialize(JS::Realm& realm)
+{
+    auto& vm = this->vm();
+    Base::initialize(realm);
+
+    define_direct_property(vm.names.prototype, &Bindings::ensure_web_prototype<CompileErrorPrototype>(realm, "WebAssembly.CompileError"_fly_string), 0);
+    define_direct_property(vm.names.length, JS::Value(1), JS::Attribute::Configurable);
+}
+
+JS::ThrowCompletionOr<JS::Value> CompileErrorConstructor::call()
+{
+    // 1. If NewTarget is undefined, let newTarget be the active function object; else let newTarget be NewTarget.
+    return TRY(construct(*this));
+}
+
+// https://tc39.es/ecma262/#sec-nativeerror
+JS::ThrowCompletionOr<JS::NonnullGCPtr<JS::Object>> CompileErrorConstructor::construct(JS::FunctionObject& new_target)
+{
+    auto& vm = this->vm();
+
+    auto message = vm.argument(0);
+    auto options = vm.argument(1);
+
+    // 2. Let O be ? OrdinaryCreateFromConstructor(newTarget, "%NativeError.prototype%", « [[ErrorData]] »).
+    auto prototype = TRY(new_target.get(vm.names.prototype));
+    if (!prototype.is_object()) {
+        auto* function_realm = TRY(JS::get_function_realm(vm, new_target));
+        prototype = &Bindings::ensure_web_prototype<CompileErrorPrototype>(*function_realm, "WebAssembly.CompileError"_fly_string);
+    }
+    auto error = vm.heap().allocate<CompileError>(*vm.current_realm(), prototype.as_object());
+
+    // 3. If message is not undefined, then
+    if (!message.is_undefined()) {
+        // a. Let msg be ? ToString(message).
+        auto msg = TRY(message.to_string(vm));
+
+        // b. Perform CreateNonEnumerableDataPropertyOrThrow(O, "message", msg).
+        error->create_non_enumerable_data_property_or_throw(vm.names.message, JS::PrimitiveString::create(vm, move(msg)));
+    }
+
+    // 4. Perform ? InstallErrorCause(O, options).
+    TRY(error->install_error_cause(options));
+
+    // 5. Return O.
+    return error;
+}
+
+}
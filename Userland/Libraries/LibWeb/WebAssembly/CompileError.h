@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibJS/Runtime/Error.h>
+#include <LibJS/Runtime/NativeFunction.h>
+
+namespace Web::WebAssembly {
+
+// https://webassembly.github.io/spec/js-api/#exceptiondef-compileerror
+// NOTE: This isn't a WebIDL interface, but a NativeError like the ones in LibJS, so its prototype and constructor are
+//       written by hand. They are still kept with the realm's other web intrinsics.
+class CompileError final : public JS::Error {
+    JS_OBJECT(CompileError, JS::Error);
+    JS_DECLARE_ALLOCATOR(CompileError);
+
+public:
+    static JS::NonnullGCPtr<CompileError> create(JS::Realm&, StringView message);
+    virtual ~CompileError() override = default;
+
+private:
+    explicit CompileError(JS::Object& prototype);
+};
+
+class CompileErrorPrototype final : public JS::Object {
+    JS_OBJECT(CompileErrorPrototype, JS::Object);
+    JS_DECLARE_ALLOCATOR(CompileErrorPrototype);
+
+public:
+    virtual void initialize(JS::Realm&) override;
+    virtual ~CompileErrorPrototype() override = default;
+
+private:
+    explicit CompileErrorPrototype(JS::Realm&);
+};
+
+class CompileErrorConstructor final : public JS::NativeFunction {
+    JS_OBJECT(CompileErrorConstructor, JS::NativeFunction);
+    JS_DECLARE_ALLOCATOR(CompileErrorConstructor);
+
+public:
+    virtual void initialize(JS::Realm&) override;
+    virtual ~CompileErrorConstructor() override = default;
+
+    virtual JS::ThrowCompletionOr<JS::Value> call() override;
+    virtual JS::ThrowCompletionOr<JS::NonnullGCPtr<JS::Object>> construct(JS::FunctionObject& new_target) override;
+
+private:
+    explicit CompileErrorConstructor(JS::Realm&);
+
+    virtual bool has_constructor() const override { return true; }
+};
+
+}
@@ -18,13 +18,24 @@
 #include <LibJS/Runtime/Promise.h>
 #include <LibJS/Runtime/TypedArray.h>
 #include <LibJS/Runtime/VM.h>
+#include <LibWasm/AbstractMachine/StreamingCompiler.h>
 #include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWeb/Bindings/Intrinsics.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Bodies.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Headers.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Responses.h>
+#include <LibWeb/Fetch/Infrastructure/HTTP/Statuses.h>
+#include <LibWeb/Fetch/Response.h>
+#include <LibWeb/HTML/Scripting/Environments.h>
+#include <LibWeb/WebAssembly/CompileError.h>
 #include <LibWeb/WebAssembly/Instance.h>
 #include <LibWeb/WebAssembly/Memory.h>
 #include <LibWeb/WebAssembly/Module.h>
 #include <LibWeb/WebAssembly/Table.h>
 #include <LibWeb/WebAssembly/WebAssembly.h>
 #include <LibWeb/WebIDL/Buffers.h>
+#include <LibWeb/WebIDL/Promise.h>
 
 namespace Web::WebAssembly {
 
@@ -39,6 +50,13 @@ WebAssemblyCache& get_cache(JS::Realm& realm)
 
 }
 
+void initialize(JS::Object& object, JS::Realm&)
+{
+    // https://webassembly.github.io/spec/js-api/#error-objects
+    static constexpr u8 attr = JS::Attribute::Writable | JS::Attribute::Configurable;
+    object.define_intrinsic_accessor("CompileError", attr, [](auto& realm) -> JS::Value { return &Bindings::ensure_web_constructor<CompileErrorPrototype>(realm, "WebAssembly.CompileError"_fly_string); });
+}
+
 void visit_edges(JS::Object& object, JS::Cell::Visitor& visitor)
 {
     auto& global_object = HTML::relevant_global_object(object);
@@ -96,6 +114,110 @@ WebIDL::ExceptionOr<JS::Value> compile(JS::VM& vm, JS::Handle<WebIDL::BufferSour
     return promise;
 }
 
+// https://webassembly.github.io/spec/web-api/#dom-webassembly-compilestreaming
+WebIDL::ExceptionOr<JS::Value> compile_streaming(JS::VM& vm, JS::Handle<JS::Promise>& source)
+{
+    auto& realm = *vm.current_realm();
+
+    // 1. Let builderPromise be a new promise.
+    auto promise = JS::Promise::create(realm);
+
+    // NOTE: Instead of consuming the whole body and compiling it afterwards, the module is compiled chunk by chunk
+    //       as the body is read, so that most of the work is done by the time the last byte arrives.
+    struct Compilation : public RefCounted<Compilation> {
+        Wasm::StreamingCompiler compiler;
+        bool is_done { false };
+    };
+
+    auto reject_with_type_error = [&realm, promise](StringView message) {
+        promise->reject(JS::TypeError::create(realm, message));
+        return JS::js_undefined();
+    };
+
+    // https://webassembly.github.io/spec/web-api/#compile-a-potential-webassembly-response
+    auto on_fulfilled = JS::create_heap_function(vm.heap(), [&realm, promise, reject_with_type_error](JS::Value value) -> WebIDL::ExceptionOr<JS::Value> {
+        // 1. Let unwrappedSource be the result of converting the value to a Response.
+        if (!value.is_object() || !is<Fetch::Response>(value.as_object()))
+            return reject_with_type_error("compileStreaming() expects a Response"sv);
+        auto& response_object = static_cast<Fetch::Response&>(value.as_object());
+        auto response = response_object.response();
+
+        // 2. Let mimeType be the result of getting `Content-Type` from response’s header list.
+        auto mime_type = response->header_list()->get("Content-Type"sv.bytes());
+
+        // 3. If mimeType is null, reject returnValue with a TypeError and abort these substeps.
+        // 4. Remove all HTTP tab or space byte from the start and end of mimeType.
+        // 5. If mimeType is not a byte-case-insensitive match for `application/wasm`, reject returnValue with a TypeError and abort these substeps.
+        if (!mime_type.has_value() || !StringView { mime_type->bytes() }.trim(Fetch::Infrastructure::HTTP_TAB_OR_SPACE).equals_ignoring_ascii_case("application/wasm"sv))
+            return reject_with_type_error("Response is not of type application/wasm"sv);
+
+        // 6. If response is not CORS-same-origin, reject returnValue with a TypeError and abort these substeps.
+        if (response->type() != Fetch::Infrastructure::Response::Type::Basic && response->type() != Fetch::Infrastructure::Response::Type::CORS && response->type() != Fetch::Infrastructure::Response::Type::Default)
+            return reject_with_type_error("Response is not CORS-same-origin"sv);
+
+        // 7. If response’s status is not an ok status, reject returnValue with a TypeError and abort these substeps.
+        if (!Fetch::Infrastructure::is_ok_status(response->status()))
+            return reject_with_type_error("Response does not have an ok status"sv);
+
+        if (response_object.is_unusable())
+            return reject_with_type_error("Response body is unusable"sv);
+
+        auto compilation = make_ref_counted<Compilation>();
+
+        auto finish = [&realm, promise, compilation]() {
+            if (compilation->is_done)
+                return;
+            compilation->is_done = true;
+
+            auto module_or_error = compilation->compiler.finish();
+            if (module_or_error.is_error()) {
+                promise->reject(CompileError::create(realm, Wasm::compile_error_to_byte_string(module_or_error.error())));
+                return;
+            }
+
+            auto compiled_module = make_ref_counted<Detail::CompiledWebAssemblyModule>(module_or_error.release_value());
+            Detail::get_cache(realm).add_compiled_module(compiled_module);
+            promise->fulfill(realm.heap().allocate<Module>(realm, realm, move(compiled_module)));
+        };
+
+        if (!response->body()) {
+            finish();
+            return JS::js_undefined();
+        }
+
+        auto process_body_chunk = JS::create_heap_function(realm.heap(), [&realm, promise, compilation](ByteBuffer bytes) {
+            if (compilation->is_done)
+                return;
+            if (auto result = compilation->compiler.append(bytes); result.is_error()) {
+                compilation->is_done = true;
+                promise->reject(CompileError::create(realm, Wasm::compile_error_to_byte_string(result.error())));
+            }
+        });
+        auto process_end_of_body = JS::create_heap_function(realm.heap(), move(finish));
+        auto process_body_error = JS::create_heap_function(realm.heap(), [promise, compilation](JS::Value error) {
+            if (compilation->is_done)
+                return;
+            compilation->is_done = true;
+            promise->reject(error);
+        });
+
+        auto global_object = JS::NonnullGCPtr<JS::Object> { HTML::relevant_global_object(response_object) };
+        response->body()->incrementally_read(process_body_chunk, process_end_of_body, process_body_error, global_object);
+        return JS::js_undefined();
+    });
+
+    // 2. Upon rejection of source with reason, reject returnValue with reason.
+    auto on_rejected = JS::create_heap_function(vm.heap(), [promise](JS::Value reason) -> WebIDL::ExceptionOr<JS::Value> {
+        promise->reject(reason);
+        return JS::js_undefined();
+    });
+
+    auto source_promise = WebIDL::create_resolved_promise(realm, source.cell());
+    WebIDL::react_to_promise(*source_promise, on_fulfilled, on_rejected);
+
+    return promise;
+}
+
 // https://webassembly.github.io/spec/js-api/#dom-webassembly-instantiate
 WebIDL::ExceptionOr<JS::Value> instantiate(JS::VM& vm, JS::Handle<WebIDL::BufferSource>& bytes, Optional<JS::Handle<JS::Object>>& import_object)
 {
@@ -327,16 +449,12 @@ JS::ThrowCompletionOr<NonnullRefPtr<CompiledWebAssemblyModule>> parse_module(JS:
     }
     FixedMemoryStream stream { data };
     auto module_result = Wasm::Module::parse(stream);
-    if (module_result.is_error()) {
-        // FIXME: Throw CompileError instead.
-        return vm.throw_completion<JS::TypeError>(Wasm::parse_error_to_byte_string(module_result.error()));
-    }
+    if (module_result.is_error())
+        return JS::throw_completion(CompileError::create(*vm.current_realm(), Wasm::parse_error_to_byte_string(module_result.error())));
 
     auto& cache = get_cache(*vm.current_realm());
-    if (auto validation_result = cache.abstract_machine().validate(module_result.value()); validation_result.is_error()) {
-        // FIXME: Throw CompileError instead.
-        return vm.throw_completion<JS::TypeError>(validation_result.error().error_string);
-    }
+    if (auto validation_result = cache.abstract_machine().validate(module_result.value()); validation_result.is_error())
+        return JS::throw_completion(CompileError::create(*vm.current_realm(), validation_result.error().error_string));
     auto compiled_module = make_ref_counted<CompiledWebAssemblyModule>(module_result.release_value());
     cache.add_compiled_module(compiled_module);
     return compiled_module;
@@ -20,11 +20,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool keep_input_files { false };
     bool write_to_stdout { false };
     bool decompress { false };
+    size_t thread_count { 1 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
     args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(thread_count, "Compress on this many threads (default: 1)", "processes", 'p', "threads");
     args_parser.add_positional_argument(filenames, "Files", "FILES", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -46,6 +48,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     if (write_to_stdout)
         keep_input_files = true;
 
+    if (thread_count == 0) {
+        warnln("Thread count must be at least 1");
+        return 1;
+    }
+
     for (auto const& input_filename : filenames) {
         OwnPtr<Stream> output_stream;
 
@@ -71,8 +78,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         // Buffer reads, which yields a significant performance improvement.
         NonnullOwnPtr<Stream> input_stream = TRY(Core::InputBufferedFile::create(move(input_file), 1 * MiB));
 
+        Compress::GzipCompressor* parallel_compressor = nullptr;
         if (decompress) {
             input_stream = TRY(try_make<Compress::GzipDecompressor>(move(input_stream)));
+        } else if (thread_count > 1) {
+            auto compressor = TRY(Compress::GzipCompressor::create_parallel(output_stream.release_nonnull(), thread_count));
+            parallel_compressor = compressor.ptr();
+            output_stream = move(compressor);
         } else {
             output_stream = TRY(try_make<Compress::GzipCompressor>(output_stream.release_nonnull()));
         }
@@ -84,6 +96,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             TRY(output_stream->write_until_depleted(span));
         }
 
+        if (parallel_compressor)
+            TRY(parallel_compressor->finish());
+
         if (!keep_input_files)
             TRY(Core::System::unlink(input_filename));
     }
@@ -7,16 +7,20 @@
  */
 
 #include <AK/JsonValue.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/StandardPaths.h>
 #include <LibCore/System.h>
 #include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/BytecodeCache.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/PassManager.h>
 #include <LibJS/Console.h>
 #include <LibJS/Contrib/Test262/GlobalObject.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Print.h>
 #include <LibJS/Runtime/ConsoleObject.h>
@@ -528,9 +532,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed"));
 
     bool gc_on_every_allocation = false;
+    bool generational_gc = false;
+    bool incremental_gc = false;
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
+    StringView bytecode_cache_directory;
+    StringView bytecode_passes;
+    bool dump_bytecode_pass_statistics = false;
     StringView evaluate_script;
     Vector<StringView> script_paths;
 
@@ -538,11 +547,19 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(JS::Bytecode::g_collect_property_lookup_cache_statistics, "Dump property lookup cache statistics on exit", "dump-property-caches", {});
+    args_parser.add_option(JS::JIT::g_jit_enabled, "Compile hot bytecode to native code", "jit", {});
+    args_parser.add_option(JS::g_parse_function_bodies_lazily, "Only pre-parse function bodies until they are first called", "lazy-functions", {});
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
     args_parser.add_option(s_disable_source_location_hints, "Disable source location hints", "disable-source-location-hints", 'h');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
+    args_parser.add_option(generational_gc, "Only collect recently allocated cells in most garbage collections", "generational-gc", {});
+    args_parser.add_option(incremental_gc, "Mark incrementally and sweep lazily in garbage collections", "incremental-gc", {});
+    args_parser.add_option(bytecode_cache_directory, "Keep compiled bytecode in the given directory and reuse it on later runs", "bytecode-cache", {}, "path");
+    args_parser.add_option(bytecode_passes, "Only run the given comma-separated bytecode optimization passes (or none)", "bytecode-passes", {}, "passes");
+    args_parser.add_option(dump_bytecode_pass_statistics, "Dump how many instructions each bytecode optimization pass removed on exit", "dump-bytecode-pass-statistics", {});
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
     args_parser.add_option(disable_debug_printing, "Disable debug output", "disable-debug-output", {});
     args_parser.add_option(evaluate_script, "Evaluate argument as a script", "evaluate", 'c', "script");
@@ -550,6 +567,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    if (!bytecode_cache_directory.is_empty())
+        JS::Bytecode::BytecodeCache::set_directory(bytecode_cache_directory);
+    if (!bytecode_passes.is_empty())
+        TRY(JS::Bytecode::PassManager::the().set_enabled_passes(bytecode_passes));
+    JS::Bytecode::PassManager::the().set_collects_statistics(dump_bytecode_pass_statistics);
+    ScopeGuard dump_bytecode_pass_statistics_on_exit = [&] {
+        if (dump_bytecode_pass_statistics)
+            JS::Bytecode::PassManager::the().dump_statistics();
+    };
+
     bool syntax_highlight = !disable_syntax_highlight;
 
     AK::set_debug_enabled(!disable_debug_printing);
@@ -589,6 +616,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         ReplConsoleClient console_client(console_object.console());
         console_object.console().set_client(console_client);
         g_vm->heap().set_should_collect_on_every_allocation(gc_on_every_allocation);
+        if (generational_gc)
+            g_vm->heap().set_generational(true);
+        if (incremental_gc)
+            g_vm->heap().set_incremental(true);
 
         auto& global_environment = realm.global_environment();
 
@@ -806,6 +837,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         ReplConsoleClient console_client(console_object.console());
         console_object.console().set_client(console_client);
         g_vm->heap().set_should_collect_on_every_allocation(gc_on_every_allocation);
+        if (generational_gc)
+            g_vm->heap().set_generational(true);
+        if (incremental_gc)
+            g_vm->heap().set_incremental(true);
 
         StringBuilder builder;
         StringView source_name;
@@ -838,7 +873,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         // We resolve modules as if it is the first file
 
-        if (!TRY(parse_and_run(realm, builder.string_view(), source_name)))
+        auto success = TRY(parse_and_run(realm, builder.string_view(), source_name));
+
+        if (JS::Bytecode::g_collect_property_lookup_cache_statistics) {
+            JS::Bytecode::Executable::for_each_live_executable([](auto& executable) {
+                executable.dump_property_lookup_cache_statistics();
+            });
+        }
+
+        if (!success)
             return 1;
     }
 
@@ -14,6 +14,7 @@
 #include <LibCompress/Gzip.h>
 #include <LibCompress/Lzma.h>
 #include <LibCompress/Xz.h>
+#include <LibCompress/Zstd.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/Directory.h>
@@ -36,6 +37,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool gzip = false;
     bool lzma = false;
     bool xz = false;
+    bool zstd = false;
     bool no_auto_compress = false;
     StringView archive_file;
     bool dereference = false;
@@ -50,6 +52,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(gzip, "Compress or decompress file using gzip", "gzip", 'z');
     args_parser.add_option(lzma, "Compress or decompress file using lzma", "lzma");
     args_parser.add_option(xz, "Compress or decompress file using xz", "xz", 'J');
+    args_parser.add_option(zstd, "Compress or decompress file using zstd", "zstd");
     args_parser.add_option(no_auto_compress, "Do not use the archive suffix to select the compression algorithm", "no-auto-compress");
     args_parser.add_option(directory, "Directory to extract to/create from", "directory", 'C', "DIRECTORY");
     args_parser.add_option(archive_file, "Archive file", "file", 'f', "FILE");
@@ -69,6 +72,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             lzma = true;
         if (archive_file.ends_with(".xz"sv))
             xz = true;
+        if (archive_file.ends_with(".zst"sv) || archive_file.ends_with(".tzst"sv))
+            zstd = true;
     }
 
     if (list || extract) {
@@ -86,6 +91,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (xz)
             input_stream = TRY(Compress::XzDecompressor::create(move(input_stream)));
 
+        if (zstd)
+            input_stream = TRY(Compress::ZstdDecompressor::create(move(input_stream)));
+
         auto tar_stream = TRY(Archive::TarInputStream::construct(move(input_stream)));
 
         HashMap<ByteString, ByteString> global_overrides;
@@ -240,6 +248,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (xz)
             TODO();
 
+        // The compressor has to be told when the archive is complete, so that it can finish the frame.
+        Compress::ZstdCompressor* zstd_compressor = nullptr;
+        if (zstd) {
+            auto compressor = TRY(Compress::ZstdCompressor::create(move(output_stream)));
+            zstd_compressor = compressor.ptr();
+            output_stream = move(compressor);
+        }
+
         Archive::TarOutputStream tar_stream(move(output_stream));
 
         auto add_file = [&](ByteString path) -> ErrorOr<void> {
@@ -304,6 +320,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         }
 
         TRY(tar_stream.finish());
+        if (zstd_compressor)
+            TRY(zstd_compressor->flush());
 
         return 0;
     }
@@ -5,19 +5,19 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/DOSPackedTime.h>
 #include <AK/NumberFormat.h>
 #include <AK/StringUtils.h>
 #include <LibArchive/Zip.h>
-#include <LibCompress/Deflate.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DateTime.h>
 #include <LibCore/Directory.h>
 #include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
-#include <LibCrypto/Checksum/CRC32.h>
 #include <LibFileSystem/FileSystem.h>
+#include <LibThreading/ThreadPool.h>
 #include <sys/stat.h>
 
 static ErrorOr<void> adjust_modification_time(Archive::ZipMember const& zip_member)
@@ -32,8 +32,9 @@ static ErrorOr<void> adjust_modification_time(Archive::ZipMember const& zip_memb
     return Core::System::utime(zip_member.name, buf);
 }
 
-static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
+static bool unpack_zip_member(Archive::ZipMemberReader const& reader, bool quiet)
 {
+    auto const& zip_member = reader.member();
     if (zip_member.is_directory) {
         if (auto maybe_error = Core::System::mkdir(zip_member.name, 0755); maybe_error.is_error()) {
             warnln("Failed to create directory '{}': {}", zip_member.name, maybe_error.error());
@@ -54,35 +55,11 @@ static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
     if (!quiet)
         outln(" extracting: {}", zip_member.name);
 
-    Crypto::Checksum::CRC32 checksum;
-    switch (zip_member.compression_method) {
-    case Archive::ZipCompressionMethod::Store: {
-        if (auto maybe_error = new_file->write_until_depleted(zip_member.compressed_data); maybe_error.is_error()) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, maybe_error.release_error());
-            return false;
-        }
-        checksum.update({ zip_member.compressed_data.data(), zip_member.compressed_data.size() });
-        break;
-    }
-    case Archive::ZipCompressionMethod::Deflate: {
-        auto decompressed_data = Compress::DeflateDecompressor::decompress_all(zip_member.compressed_data);
-        if (decompressed_data.is_error()) {
-            warnln("Failed decompressing file {}: {}", zip_member.name, decompressed_data.error());
-            return false;
-        }
-        if (decompressed_data.value().size() != zip_member.uncompressed_size) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (auto maybe_error = new_file->write_until_depleted(decompressed_data.value()); maybe_error.is_error()) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, maybe_error.release_error());
-            return false;
-        }
-        checksum.update(decompressed_data.value());
-        break;
-    }
-    default:
-        VERIFY_NOT_REACHED();
+    if (auto maybe_error = reader.decompress_into(*new_file); maybe_error.is_error()) {
+        warnln("Failed decompressing file {}: {}", zip_member.name, maybe_error.error());
+        new_file->close();
+        MUST(FileSystem::remove(zip_member.name, FileSystem::RecursionMode::Disallowed));
+        return false;
     }
 
     if (adjust_modification_time(zip_member).is_error()) {
@@ -91,14 +68,25 @@ static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
     }
 
     new_file->close();
+    return true;
+}
 
-    if (checksum.digest() != zip_member.crc32) {
-        warnln("Failed decompressing file {}: CRC32 mismatch", zip_member.name);
-        MUST(FileSystem::remove(zip_member.name, FileSystem::RecursionMode::Disallowed));
-        return false;
-    }
+// Once one of the members has failed, the ones that haven't been started yet are skipped.
+static bool unpack_zip_members_in_parallel(Vector<Archive::ZipMemberReader const*> const& readers, size_t thread_count, bool quiet)
+{
+    Atomic<bool> has_failed { false };
 
-    return true;
+    Threading::ThreadPool<Archive::ZipMemberReader const*> thread_pool([&](Archive::ZipMemberReader const* reader) {
+        if (!has_failed.load() && !unpack_zip_member(*reader, quiet))
+            has_failed.store(true);
+    },
+        min(thread_count, readers.size()));
+
+    for (auto const* reader : readers)
+        thread_pool.submit(reader);
+    thread_pool.wait_for_all();
+
+    return !has_failed.load();
 }
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
@@ -106,6 +94,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     StringView zip_file_path;
     bool quiet { false };
     bool list_files { false };
+    size_t thread_count { 1 };
     StringView output_directory_path;
     Vector<StringView> file_filters;
 
@@ -113,26 +102,27 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(list_files, "Only list files in the archive", "list", 'l');
     args_parser.add_option(output_directory_path, "Directory to receive the archive content", "output-directory", 'd', "path");
     args_parser.add_option(quiet, "Be less verbose", "quiet", 'q');
+    args_parser.add_option(thread_count, "Extract on this many threads (default: 1)", "jobs", 'j', "threads");
     args_parser.add_positional_argument(zip_file_path, "File to unzip", "path", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(file_filters, "Files or filters in the archive to extract", "files", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
-    struct stat st = TRY(Core::System::stat(zip_file_path));
-
-    // FIXME: Map file chunk-by-chunk once we have mmap() with offset.
-    //        This will require mapping some parts then unmapping them repeatedly,
-    //        but it would be significantly faster and less syscall heavy than seek()/read() at every read.
-    OwnPtr<Core::MappedFile> mapped_file;
-    ReadonlyBytes input_bytes;
-    if (st.st_size > 0) {
-        mapped_file = TRY(Core::MappedFile::map(zip_file_path));
-        input_bytes = mapped_file->bytes();
+    if (thread_count == 0) {
+        warnln("Thread count must be at least 1");
+        return 1;
     }
 
+    struct stat st = TRY(Core::System::stat(zip_file_path));
+
     if (!quiet)
         warnln("Archive: {}", zip_file_path);
 
-    auto zip_file = Archive::Zip::try_create(input_bytes);
+    // FIXME: Map file chunk-by-chunk once we have mmap() with offset.
+    //        This will require mapping some parts then unmapping them repeatedly,
+    //        but it would be significantly faster and less syscall heavy than seek()/read() at every read.
+    Optional<Archive::Zip> zip_file;
+    if (st.st_size > 0)
+        zip_file = Archive::Zip::try_create(TRY(Core::MappedFile::map(zip_file_path)));
     if (!zip_file.has_value()) {
         warnln("Invalid zip file {}", zip_file_path);
         return 1;
@@ -160,9 +150,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 0;
     }
 
-    Vector<Archive::ZipMember> zip_directories;
+    auto zip_members = TRY(zip_file->member_readers());
+    Vector<Archive::ZipMemberReader const*> zip_directories;
+    Vector<Archive::ZipMemberReader const*> zip_files;
 
-    auto success = TRY(zip_file->for_each_member([&](auto zip_member) {
+    for (auto const& reader : zip_members) {
+        auto const& zip_member = reader.member();
         bool keep_file = false;
 
         if (!file_filters.is_empty()) {
@@ -178,26 +171,29 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             keep_file = true;
         }
 
-        if (keep_file) {
-            if (!unpack_zip_member(zip_member, quiet))
-                return IterationDecision::Break;
-            if (zip_member.is_directory)
-                zip_directories.append(zip_member);
-        }
+        if (!keep_file)
+            continue;
 
-        return IterationDecision::Continue;
-    }));
+        // Directories are always created up front and in order, so only files are left for the worker threads.
+        if (zip_member.is_directory || thread_count == 1) {
+            if (!unpack_zip_member(reader, quiet))
+                return 1;
+        }
+        if (zip_member.is_directory)
+            TRY(zip_directories.try_append(&reader));
+        else if (thread_count > 1)
+            TRY(zip_files.try_append(&reader));
+    }
 
-    if (!success) {
+    if (!unpack_zip_members_in_parallel(zip_files, thread_count, quiet))
         return 1;
-    }
 
-    for (auto& directory : zip_directories) {
-        if (adjust_modification_time(directory).is_error()) {
-            warnln("Failed setting modification time for directory {}", directory.name);
+    for (auto const* directory : zip_directories) {
+        if (adjust_modification_time(directory->member()).is_error()) {
+            warnln("Failed setting modification time for directory {}", directory->member().name);
             return 1;
         }
     }
 
-    return success ? 0 : 1;
+    return 0;
 }
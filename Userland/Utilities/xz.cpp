@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <LibCompress/Xz.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> filenames;
+    bool keep_input_files { false };
+    bool write_to_stdout { false };
+    bool decompress { false };
+    Compress::XzCompressorOptions options;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Compress or decompress XZ files");
+    args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
+    args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(options.thread_count, "Compress on this many threads (default: 1)", "threads", 'T', "threads");
+    args_parser.add_option(options.dictionary_size, "Dictionary size in bytes (default: 2 MiB)", "dictionary-size", 0, "size");
+    args_parser.add_option(options.block_size, "Size of the independently compressed blocks in bytes (default: 6 MiB)", "block-size", 0, "size");
+    args_parser.add_positional_argument(filenames, "Files", "FILES", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    if (filenames.is_empty()) {
+        filenames.append("-"sv);
+        write_to_stdout = true;
+    }
+
+    if (write_to_stdout)
+        keep_input_files = true;
+
+    if (options.thread_count == 0) {
+        warnln("Thread count must be at least 1");
+        return 1;
+    }
+
+    if (options.block_size == 0) {
+        warnln("Block size must be at least 1");
+        return 1;
+    }
+
+    for (auto const& input_filename : filenames) {
+        OwnPtr<Stream> output_stream;
+
+        if (write_to_stdout) {
+            output_stream = TRY(Core::File::standard_output());
+        } else if (decompress) {
+            if (!input_filename.ends_with(".xz"sv)) {
+                warnln("unknown suffix for: {}, skipping", input_filename);
+                continue;
+            }
+
+            auto output_filename = input_filename.substring_view(0, input_filename.length() - ".xz"sv.length());
+            output_stream = TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+        } else {
+            auto output_filename = ByteString::formatted("{}.xz", input_filename);
+            output_stream = TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+        }
+
+        VERIFY(output_stream);
+
+        NonnullOwnPtr<Core::File> input_file = TRY(Core::File::open_file_or_standard_stream(input_filename, Core::File::OpenMode::Read));
+
+        // Buffer reads, which yields a significant performance improvement.
+        NonnullOwnPtr<Stream> input_stream = TRY(Core::InputBufferedFile::create(move(input_file), 1 * MiB));
+
+        Compress::XzCompressor* compressor = nullptr;
+        if (decompress) {
+            input_stream = TRY(Compress::XzDecompressor::create(move(input_stream)));
+        } else {
+            auto xz_compressor = TRY(Compress::XzCompressor::create(output_stream.release_nonnull(), options));
+            compressor = xz_compressor.ptr();
+            output_stream = move(xz_compressor);
+        }
+
+        auto buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
+
+        while (!input_stream->is_eof()) {
+            auto span = TRY(input_stream->read_some(buffer));
+            TRY(output_stream->write_until_depleted(span));
+        }
+
+        if (compressor)
+            TRY(compressor->flush());
+
+        if (!keep_input_files)
+            TRY(Core::System::unlink(input_filename));
+    }
+
+    return 0;
+}
@@ -19,15 +19,22 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<StringView> source_paths;
     bool recurse = false;
     bool force = false;
+    size_t thread_count = 1;
 
     Core::ArgsParser args_parser;
     args_parser.add_positional_argument(zip_path, "Zip file path", "zipfile", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(source_paths, "Input files to be archived", "files", Core::ArgsParser::Required::Yes);
     args_parser.add_option(recurse, "Travel the directory structure recursively", "recurse-paths", 'r');
     args_parser.add_option(force, "Overwrite existing zip file", "force", 'f');
+    args_parser.add_option(thread_count, "Compress on this many threads (default: 1)", "jobs", 'j', "threads");
     args_parser.parse(arguments);
 
-    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+    if (thread_count == 0) {
+        warnln("Thread count must be at least 1");
+        return 1;
+    }
+
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"));
 
     auto cwd = TRY(Core::System::getcwd());
     TRY(Core::System::unveil(LexicalPath::absolute_path(cwd, zip_path), "wc"sv));
@@ -47,7 +54,18 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     outln("Archive: {}", zip_path);
     auto file_stream = TRY(Core::File::open(zip_path, Core::File::OpenMode::Write));
-    Archive::ZipOutputStream zip_stream(move(file_stream));
+    auto zip_stream = thread_count > 1
+        ? TRY(Archive::ZipOutputStream::create_parallel(move(file_stream), thread_count))
+        : TRY(try_make<Archive::ZipOutputStream>(move(file_stream)));
+
+    // Members are only written (and reported) once they have been compressed, which might be a few files later.
+    zip_stream->on_member_written = [](StringView name, Archive::ZipOutputStream::MemberInformation const& information) {
+        if (information.compression_ratio < 1.f) {
+            outln("  adding: {} (deflated {}%)", name, (int)(information.compression_ratio * 100));
+        } else {
+            outln("  adding: {} (stored)", name);
+        }
+    };
 
     auto add_file = [&](StringView path) -> ErrorOr<void> {
         auto canonicalized_path = TRY(String::from_byte_string(LexicalPath::canonicalized_path(path)));
@@ -56,14 +74,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         auto stat = TRY(Core::System::fstat(file->fd()));
         auto date = Core::DateTime::from_timestamp(stat.st_mtim.tv_sec);
 
-        auto information = TRY(zip_stream.add_member_from_stream(canonicalized_path, *file, date));
-        if (information.compression_ratio < 1.f) {
-            outln("  adding: {} (deflated {}%)", canonicalized_path, (int)(information.compression_ratio * 100));
-        } else {
-            outln("  adding: {} (stored)", canonicalized_path);
-        }
-
-        return {};
+        return zip_stream->queue_member_from_stream(canonicalized_path, *file, date);
     };
 
     auto add_directory = [&](StringView path, auto handle_directory) -> ErrorOr<void> {
@@ -71,7 +82,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         auto stat = TRY(Core::System::stat(path));
         auto date = Core::DateTime::from_timestamp(stat.st_mtim.tv_sec);
-        TRY(zip_stream.add_directory(canonicalized_path, date));
+        TRY(zip_stream->add_directory(canonicalized_path, date));
 
         if (!recurse)
             return {};
@@ -106,7 +117,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         }
     }
 
-    TRY(zip_stream.finish());
+    TRY(zip_stream->finish());
 
     return 0;
 }
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <LibCompress/Zstd.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> filenames;
+    bool keep_input_files { false };
+    bool write_to_stdout { false };
+    bool decompress { false };
+    bool no_checksum { false };
+    StringView dictionary_path;
+    Compress::ZstdCompressorOptions options;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Compress or decompress Zstandard files");
+    args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
+    args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(dictionary_path, "Use this dictionary for compression or decompression", "dictionary", 'D', "file");
+    args_parser.add_option(options.window_log, "Base 2 logarithm of the window size (default: 21)", "window-log", 0, "log");
+    args_parser.add_option(no_checksum, "Don't store a checksum of the uncompressed data", "no-check");
+    args_parser.add_positional_argument(filenames, "Files", "FILES", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    if (filenames.is_empty()) {
+        filenames.append("-"sv);
+        write_to_stdout = true;
+    }
+
+    if (write_to_stdout)
+        keep_input_files = true;
+
+    if (options.window_log < Compress::ZstdCompressor::min_window_log || options.window_log > Compress::ZstdCompressor::max_window_log) {
+        warnln("Window log must be between {} and {}", Compress::ZstdCompressor::min_window_log, Compress::ZstdCompressor::max_window_log);
+        return 1;
+    }
+
+    options.include_checksum = !no_checksum;
+    if (!dictionary_path.is_empty()) {
+        auto dictionary_file = TRY(Core::File::open(dictionary_path, Core::File::OpenMode::Read));
+        options.dictionary = TRY(Compress::ZstdDictionary::create(TRY(dictionary_file->read_until_eof())));
+    }
+
+    for (auto const& input_filename : filenames) {
+        OwnPtr<Stream> output_stream;
+
+        if (write_to_stdout) {
+            output_stream = TRY(Core::File::standard_output());
+        } else if (decompress) {
+            if (!input_filename.ends_with(".zst"sv)) {
+                warnln("unknown suffix for: {}, skipping", input_filename);
+                continue;
+            }
+
+            auto output_filename = input_filename.substring_view(0, input_filename.length() - ".zst"sv.length());
+            output_stream = TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+        } else {
+            auto output_filename = ByteString::formatted("{}.zst", input_filename);
+            output_stream = TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+        }
+
+        VERIFY(output_stream);
+
+        NonnullOwnPtr<Core::File> input_file = TRY(Core::File::open_file_or_standard_stream(input_filename, Core::File::OpenMode::Read));
+
+        // Buffer reads, which yields a significant performance improvement.
+        NonnullOwnPtr<Stream> input_stream = TRY(Core::InputBufferedFile::create(move(input_file), 1 * MiB));
+
+        Compress::ZstdCompressor* compressor = nullptr;
+        if (decompress) {
+            input_stream = TRY(Compress::ZstdDecompressor::create(move(input_stream), options.dictionary));
+        } else {
+            auto zstd_compressor = TRY(Compress::ZstdCompressor::create(output_stream.release_nonnull(), options));
+            compressor = zstd_compressor.ptr();
+            output_stream = move(zstd_compressor);
+        }
+
+        auto buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
+
+        while (!input_stream->is_eof()) {
+            auto span = TRY(input_stream->read_some(buffer));
+            TRY(output_stream->write_until_depleted(span));
+        }
+
+        if (compressor)
+            TRY(compressor->flush());
+
+        if (!keep_input_files)
+            TRY(Core::System::unlink(input_filename));
+    }
+
+    return 0;
+}